@@ -30,6 +30,7 @@ static inline void PyDTrace_FUNCTION_ENTRY(const char *arg0, const char *arg1, i
 static inline void PyDTrace_FUNCTION_RETURN(const char *arg0, const char *arg1, int arg2) {}
 static inline void PyDTrace_GC_START(int arg0) {}
 static inline void PyDTrace_GC_DONE(Py_ssize_t arg0) {}
+static inline void PyDTrace_GC_PHASE(int arg0, const char *arg1, long arg2) {}
 static inline void PyDTrace_INSTANCE_NEW_START(int arg0) {}
 static inline void PyDTrace_INSTANCE_NEW_DONE(int arg0) {}
 static inline void PyDTrace_INSTANCE_DELETE_START(int arg0) {}
@@ -42,6 +43,7 @@ static inline int PyDTrace_FUNCTION_ENTRY_ENABLED(void) { return 0; }
 static inline int PyDTrace_FUNCTION_RETURN_ENABLED(void) { return 0; }
 static inline int PyDTrace_GC_START_ENABLED(void) { return 0; }
 static inline int PyDTrace_GC_DONE_ENABLED(void) { return 0; }
+static inline int PyDTrace_GC_PHASE_ENABLED(void) { return 0; }
 static inline int PyDTrace_INSTANCE_NEW_START_ENABLED(void) { return 0; }
 static inline int PyDTrace_INSTANCE_NEW_DONE_ENABLED(void) { return 0; }
 static inline int PyDTrace_INSTANCE_DELETE_START_ENABLED(void) { return 0; }
@@ -131,6 +131,13 @@ PyAPI_FUNC(int) Py_Main(int argc, wchar_t **argv);
 #ifdef Py_BUILD_CORE
 PyAPI_FUNC(int) _Py_UnixMain(int argc, char **argv);
 #endif
+#ifndef Py_LIMITED_API
+/* The $PYTHONSTARTUPTRACE startup trace (also in Modules/main.c) */
+PyAPI_FUNC(int) _PyStartupTrace_Enabled(void);
+PyAPI_FUNC(void) _PyStartupTrace_Event(const char *category,
+                                       const char *name,
+                                       _PyTime_t start);
+#endif
 
 /* In getpath.c */
 PyAPI_FUNC(wchar_t *) Py_GetProgramFullPath(void);
@@ -0,0 +1,79 @@
+"""
+Tests for epoll wrapper.
+"""
+import errno
+import select
+import socket
+import unittest
+
+if not hasattr(select, "epoll"):
+    raise unittest.SkipTest("test works only on Linux 2.6")
+
+
+class TestEPollMany(unittest.TestCase):
+
+    def setUp(self):
+        self.ep = select.epoll()
+        self.sockets = []
+
+    def tearDown(self):
+        self.ep.close()
+        for sock in self.sockets:
+            sock.close()
+
+    def _socketpair(self):
+        a, b = socket.socketpair()
+        self.sockets.extend((a, b))
+        return a, b
+
+    def test_register_many(self):
+        a, b = self._socketpair()
+        self.ep.register_many([(a, select.EPOLLOUT), (b.fileno(), select.EPOLLIN)])
+        events = dict(self.ep.poll(1))
+        self.assertEqual(events, {a.fileno(): select.EPOLLOUT})
+
+        self.ep.modify_many([(a, select.EPOLLIN), (b, select.EPOLLOUT)])
+        events = dict(self.ep.poll(1))
+        self.assertEqual(events, {b.fileno(): select.EPOLLOUT})
+
+    def test_register_many_bad_argument(self):
+        a, b = self._socketpair()
+        self.assertRaises(TypeError, self.ep.register_many, 1)
+        self.assertRaises(TypeError, self.ep.register_many,
+                          [(a, select.EPOLLIN), b])
+        # nothing was registered
+        self.ep.register(a, select.EPOLLIN)
+        self.ep.register(b, select.EPOLLIN)
+
+    def test_register_many_mutating_fileno(self):
+        # fileno() may change the list while the pairs are converted
+        pairs = []
+
+        class Mutating:
+            def __init__(self, sock):
+                self.sock = sock
+            def fileno(self):
+                del pairs[:]
+                return self.sock.fileno()
+
+        a, b = self._socketpair()
+        pairs.extend([(Mutating(a), select.EPOLLIN),
+                      (Mutating(b), select.EPOLLIN)])
+        self.ep.register_many(pairs)
+        self.assertEqual(pairs, [])
+        for sock in a, b:
+            with self.assertRaises(OSError) as cm:
+                self.ep.register(sock, select.EPOLLIN)
+            self.assertEqual(cm.exception.errno, errno.EEXIST)
+
+    def test_poll_into(self):
+        import array
+        a, b = self._socketpair()
+        self.ep.register(a, select.EPOLLOUT)
+        buf = array.array('i', [0] * 8)
+        self.assertEqual(self.ep.poll_into(buf, 1), 1)
+        self.assertEqual(buf[:2].tolist(), [a.fileno(), select.EPOLLOUT])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -18,6 +18,27 @@ _Py_IDENTIFIER(current_task);
 _Py_IDENTIFIER(get_event_loop);
 _Py_IDENTIFIER(send);
 _Py_IDENTIFIER(throw);
+_Py_IDENTIFIER(_args);
+_Py_IDENTIFIER(_callback);
+_Py_IDENTIFIER(_cancelled);
+_Py_IDENTIFIER(_clock_resolution);
+_Py_IDENTIFIER(_context);
+_Py_IDENTIFIER(_loop);
+_Py_IDENTIFIER(_process_events);
+_Py_IDENTIFIER(_ready);
+_Py_IDENTIFIER(_run);
+_Py_IDENTIFIER(_scheduled);
+_Py_IDENTIFIER(_selector);
+_Py_IDENTIFIER(_source_traceback);
+_Py_IDENTIFIER(_stopping);
+_Py_IDENTIFIER(_timer_cancelled_count);
+_Py_IDENTIFIER(_when);
+_Py_IDENTIFIER(append);
+_Py_IDENTIFIER(call_exception_handler);
+_Py_IDENTIFIER(popleft);
+_Py_IDENTIFIER(run);
+_Py_IDENTIFIER(select);
+_Py_IDENTIFIER(time);
 
 
 /* State of the _asyncio module */
@@ -32,6 +53,9 @@ static PyObject *asyncio_task_print_stack_func;
 static PyObject *asyncio_task_repr_info_func;
 static PyObject *asyncio_InvalidStateError;
 static PyObject *asyncio_CancelledError;
+static PyObject *asyncio_Handle_type;
+static PyObject *asyncio_TimerHandle_type;
+static PyObject *asyncio_format_callback_source_func;
 static PyObject *context_kwname;
 
 static PyObject *cached_running_holder;
@@ -3146,6 +3170,643 @@ _asyncio__leave_task_impl(PyObject *module, PyObject *loop, PyObject *task)
 }
 
 
+/*********************** Event loop core ********************/
+
+/* Same values as in asyncio/base_events.py */
+#define MIN_SCHEDULED_TIMER_HANDLES 100
+#define MIN_CANCELLED_TIMER_HANDLES_FRACTION 0.5
+#define MAXIMUM_SELECT_TIMEOUT (24.0 * 3600.0)
+
+
+/* The timer heap of the loop is a list of TimerHandle objects managed with
+   the heapq algorithms.  TimerHandle.__lt__() only compares the _when
+   attributes, so compare them directly instead of calling it. */
+
+static int
+timer_when(PyObject *handle, double *when)
+{
+    PyObject *o = _PyObject_GetAttrId(handle, &PyId__when);
+    if (o == NULL) {
+        return -1;
+    }
+    *when = PyFloat_AsDouble(o);
+    Py_DECREF(o);
+    if (*when == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    return 0;
+}
+
+static int
+timer_lt(PyListObject *heap, Py_ssize_t size, PyObject *a, PyObject *b)
+{
+    double when_a, when_b;
+    int res;
+
+    Py_INCREF(a);
+    Py_INCREF(b);
+    res = 0;
+    if (timer_when(a, &when_a) < 0 || timer_when(b, &when_b) < 0) {
+        res = -1;
+    }
+    Py_DECREF(a);
+    Py_DECREF(b);
+    if (res < 0) {
+        return -1;
+    }
+    if (size != PyList_GET_SIZE(heap)) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "list changed size during iteration");
+        return -1;
+    }
+    return when_a < when_b;
+}
+
+static int
+timer_siftdown(PyListObject *heap, Py_ssize_t startpos, Py_ssize_t pos)
+{
+    PyObject **arr, *parent;
+    Py_ssize_t parentpos, size;
+    int cmp;
+
+    size = PyList_GET_SIZE(heap);
+    while (pos > startpos) {
+        parentpos = (pos - 1) >> 1;
+        arr = _PyList_ITEMS(heap);
+        cmp = timer_lt(heap, size, arr[pos], arr[parentpos]);
+        if (cmp < 0) {
+            return -1;
+        }
+        if (cmp == 0) {
+            break;
+        }
+        arr = _PyList_ITEMS(heap);
+        parent = arr[parentpos];
+        arr[parentpos] = arr[pos];
+        arr[pos] = parent;
+        pos = parentpos;
+    }
+    return 0;
+}
+
+static int
+timer_siftup(PyListObject *heap, Py_ssize_t pos)
+{
+    PyObject **arr, *tmp;
+    Py_ssize_t startpos, endpos, childpos, limit;
+    int cmp;
+
+    endpos = PyList_GET_SIZE(heap);
+    startpos = pos;
+    limit = endpos >> 1;
+    while (pos < limit) {
+        childpos = 2*pos + 1;
+        if (childpos + 1 < endpos) {
+            arr = _PyList_ITEMS(heap);
+            cmp = timer_lt(heap, endpos, arr[childpos], arr[childpos + 1]);
+            if (cmp < 0) {
+                return -1;
+            }
+            childpos += ((unsigned)cmp ^ 1);
+        }
+        arr = _PyList_ITEMS(heap);
+        tmp = arr[childpos];
+        arr[childpos] = arr[pos];
+        arr[pos] = tmp;
+        pos = childpos;
+    }
+    return timer_siftdown(heap, startpos, pos);
+}
+
+static PyObject *
+timer_heappop(PyListObject *heap)
+{
+    PyObject *lastelt, *returnitem;
+    Py_ssize_t n;
+
+    n = PyList_GET_SIZE(heap);
+    assert(n > 0);
+    lastelt = PyList_GET_ITEM(heap, n - 1);
+    Py_INCREF(lastelt);
+    if (PyList_SetSlice((PyObject *)heap, n - 1, n, NULL) < 0) {
+        Py_DECREF(lastelt);
+        return NULL;
+    }
+    n--;
+    if (!n) {
+        return lastelt;
+    }
+    returnitem = PyList_GET_ITEM(heap, 0);
+    PyList_SET_ITEM(heap, 0, lastelt);
+    if (timer_siftup(heap, 0) < 0) {
+        Py_DECREF(returnitem);
+        return NULL;
+    }
+    return returnitem;
+}
+
+/* Return 1 if the handle is cancelled, 0 if not, -1 on error */
+static int
+handle_is_cancelled(PyObject *handle)
+{
+    PyObject *o = _PyObject_GetAttrId(handle, &PyId__cancelled);
+    int res;
+
+    if (o == NULL) {
+        return -1;
+    }
+    res = PyObject_IsTrue(o);
+    Py_DECREF(o);
+    return res;
+}
+
+static int
+loop_get_cancelled_count(PyObject *loop, Py_ssize_t *count)
+{
+    PyObject *o = _PyObject_GetAttrId(loop, &PyId__timer_cancelled_count);
+    if (o == NULL) {
+        return -1;
+    }
+    *count = PyLong_AsSsize_t(o);
+    Py_DECREF(o);
+    if (*count == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    return 0;
+}
+
+static int
+loop_set_cancelled_count(PyObject *loop, Py_ssize_t count)
+{
+    PyObject *o;
+    int res;
+
+    o = PyLong_FromSsize_t(count);
+    if (o == NULL) {
+        return -1;
+    }
+    res = _PyObject_SetAttrId(loop, &PyId__timer_cancelled_count, o);
+    Py_DECREF(o);
+    return res;
+}
+
+/* Drop the cancelled handles from the timer heap of the loop: rebuild it
+   when most handles are cancelled, otherwise only pop the cancelled
+   handles from its top. */
+static int
+loop_compact_scheduled(PyObject *loop, PyListObject *scheduled)
+{
+    Py_ssize_t sched_count, cancelled_count, i;
+    PyObject *handle;
+    int cancelled;
+
+    sched_count = PyList_GET_SIZE(scheduled);
+    if (loop_get_cancelled_count(loop, &cancelled_count) < 0) {
+        return -1;
+    }
+
+    if (sched_count > MIN_SCHEDULED_TIMER_HANDLES &&
+        (double)cancelled_count / sched_count >
+            MIN_CANCELLED_TIMER_HANDLES_FRACTION) {
+        PyListObject *new_scheduled;
+
+        new_scheduled = (PyListObject *)PyList_New(0);
+        if (new_scheduled == NULL) {
+            return -1;
+        }
+        for (i = 0; i < PyList_GET_SIZE(scheduled); i++) {
+            handle = PyList_GET_ITEM(scheduled, i);
+            Py_INCREF(handle);
+            cancelled = handle_is_cancelled(handle);
+            if (cancelled > 0) {
+                if (_PyObject_SetAttrId(handle, &PyId__scheduled,
+                                        Py_False) < 0) {
+                    cancelled = -1;
+                }
+            }
+            else if (cancelled == 0) {
+                if (PyList_Append((PyObject *)new_scheduled, handle) < 0) {
+                    cancelled = -1;
+                }
+            }
+            Py_DECREF(handle);
+            if (cancelled < 0) {
+                Py_DECREF(new_scheduled);
+                return -1;
+            }
+        }
+        for (i = PyList_GET_SIZE(new_scheduled) / 2 - 1; i >= 0; i--) {
+            if (timer_siftup(new_scheduled, i) < 0) {
+                Py_DECREF(new_scheduled);
+                return -1;
+            }
+        }
+        if (_PyObject_SetAttrId(loop, &PyId__scheduled,
+                                (PyObject *)new_scheduled) < 0) {
+            Py_DECREF(new_scheduled);
+            return -1;
+        }
+        Py_DECREF(new_scheduled);
+        return loop_set_cancelled_count(loop, 0);
+    }
+
+    while (PyList_GET_SIZE(scheduled) > 0) {
+        cancelled = handle_is_cancelled(PyList_GET_ITEM(scheduled, 0));
+        if (cancelled < 0) {
+            return -1;
+        }
+        if (!cancelled) {
+            break;
+        }
+        if (loop_set_cancelled_count(loop, --cancelled_count) < 0) {
+            return -1;
+        }
+        handle = timer_heappop(scheduled);
+        if (handle == NULL) {
+            return -1;
+        }
+        if (_PyObject_SetAttrId(handle, &PyId__scheduled, Py_False) < 0) {
+            Py_DECREF(handle);
+            return -1;
+        }
+        Py_DECREF(handle);
+    }
+    return 0;
+}
+
+static PyListObject *
+loop_get_scheduled(PyObject *loop)
+{
+    PyObject *scheduled = _PyObject_GetAttrId(loop, &PyId__scheduled);
+    if (scheduled != NULL && !PyList_Check(scheduled)) {
+        PyErr_SetString(PyExc_TypeError, "loop._scheduled must be a list");
+        Py_CLEAR(scheduled);
+    }
+    return (PyListObject *)scheduled;
+}
+
+static int
+loop_time(PyObject *loop, double *now)
+{
+    PyObject *o = _PyObject_CallMethodId(loop, &PyId_time, NULL);
+    if (o == NULL) {
+        return -1;
+    }
+    *now = PyFloat_AsDouble(o);
+    Py_DECREF(o);
+    if (*now == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Compute the timeout of the selector: 0 if callbacks are ready or the
+   loop is stopping, the delay until the first timer if any, else None.
+   Return a new reference. */
+static PyObject *
+loop_select_timeout(PyObject *loop, PyObject *ready, PyListObject *scheduled)
+{
+    PyObject *o;
+    double when, now, timeout;
+    int stopping;
+
+    if (PyObject_Size(ready) > 0) {
+        return PyLong_FromLong(0);
+    }
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+    o = _PyObject_GetAttrId(loop, &PyId__stopping);
+    if (o == NULL) {
+        return NULL;
+    }
+    stopping = PyObject_IsTrue(o);
+    Py_DECREF(o);
+    if (stopping < 0) {
+        return NULL;
+    }
+    if (stopping) {
+        return PyLong_FromLong(0);
+    }
+    if (PyList_GET_SIZE(scheduled) == 0) {
+        Py_RETURN_NONE;
+    }
+    if (timer_when(PyList_GET_ITEM(scheduled, 0), &when) < 0 ||
+        loop_time(loop, &now) < 0) {
+        return NULL;
+    }
+    timeout = Py_MAX(0.0, when - now);
+    return PyFloat_FromDouble(Py_MIN(timeout, MAXIMUM_SELECT_TIMEOUT));
+}
+
+/* Move the timers which are due to the ready queue */
+static int
+loop_schedule_due(PyObject *loop, PyObject *ready)
+{
+    PyListObject *scheduled;
+    PyObject *o, *handle;
+    double end_time, resolution, when;
+
+    o = _PyObject_GetAttrId(loop, &PyId__clock_resolution);
+    if (o == NULL) {
+        return -1;
+    }
+    resolution = PyFloat_AsDouble(o);
+    Py_DECREF(o);
+    if (resolution == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (loop_time(loop, &end_time) < 0) {
+        return -1;
+    }
+    end_time += resolution;
+
+    /* _process_events() may have replaced the heap */
+    scheduled = loop_get_scheduled(loop);
+    if (scheduled == NULL) {
+        return -1;
+    }
+    while (PyList_GET_SIZE(scheduled) > 0) {
+        if (timer_when(PyList_GET_ITEM(scheduled, 0), &when) < 0) {
+            goto error;
+        }
+        if (when >= end_time) {
+            break;
+        }
+        handle = timer_heappop(scheduled);
+        if (handle == NULL) {
+            goto error;
+        }
+        if (_PyObject_SetAttrId(handle, &PyId__scheduled, Py_False) < 0) {
+            Py_DECREF(handle);
+            goto error;
+        }
+        o = _PyObject_CallMethodIdObjArgs(ready, &PyId_append, handle, NULL);
+        Py_DECREF(handle);
+        if (o == NULL) {
+            goto error;
+        }
+        Py_DECREF(o);
+    }
+    Py_DECREF(scheduled);
+    return 0;
+
+error:
+    Py_DECREF(scheduled);
+    return -1;
+}
+
+/* Pass the exception raised by the callback of a handle to the exception
+   handler of its loop, as Handle._run() does */
+static int
+handle_report_exception(PyObject *handle, PyObject *callback, PyObject *args)
+{
+    PyObject *et, *ev, *tb;
+    PyObject *source = NULL, *msg = NULL, *context = NULL;
+    PyObject *source_tb = NULL, *loop = NULL, *res;
+    int ret = -1;
+
+    PyErr_Fetch(&et, &ev, &tb);
+    PyErr_NormalizeException(&et, &ev, &tb);
+    if (tb != NULL) {
+        PyException_SetTraceback(ev, tb);
+    }
+
+    source = PyObject_CallFunctionObjArgs(asyncio_format_callback_source_func,
+                                          callback, args, NULL);
+    if (source == NULL) {
+        goto finally;
+    }
+    msg = PyUnicode_FromFormat("Exception in callback %S", source);
+    if (msg == NULL) {
+        goto finally;
+    }
+    context = Py_BuildValue("{sOsOsO}", "message", msg, "exception", ev,
+                            "handle", handle);
+    if (context == NULL) {
+        goto finally;
+    }
+    source_tb = _PyObject_GetAttrId(handle, &PyId__source_traceback);
+    if (source_tb == NULL) {
+        goto finally;
+    }
+    ret = PyObject_IsTrue(source_tb);
+    if (ret < 0 || (ret &&
+        PyDict_SetItemString(context, "source_traceback", source_tb) < 0)) {
+        ret = -1;
+        goto finally;
+    }
+    ret = -1;
+    loop = _PyObject_GetAttrId(handle, &PyId__loop);
+    if (loop == NULL) {
+        goto finally;
+    }
+    res = _PyObject_CallMethodIdObjArgs(loop, &PyId_call_exception_handler,
+                                        context, NULL);
+    if (res == NULL) {
+        goto finally;
+    }
+    Py_DECREF(res);
+    ret = 0;
+
+finally:
+    Py_XDECREF(et);
+    Py_XDECREF(ev);
+    Py_XDECREF(tb);
+    Py_XDECREF(source);
+    Py_XDECREF(msg);
+    Py_XDECREF(context);
+    Py_XDECREF(source_tb);
+    Py_XDECREF(loop);
+    return ret;
+}
+
+/* Run the callback of a handle.  Handle and TimerHandle are run without
+   calling their Python _run() method. */
+static int
+handle_run(PyObject *handle)
+{
+    PyObject *small_stack[_PY_FASTCALL_SMALL_STACK], **stack;
+    PyObject *context = NULL, *callback = NULL, *args = NULL;
+    PyObject *run = NULL, *res;
+    Py_ssize_t nargs, i;
+    int ret = -1;
+
+    if ((PyObject *)Py_TYPE(handle) != asyncio_Handle_type &&
+        (PyObject *)Py_TYPE(handle) != asyncio_TimerHandle_type) {
+        res = _PyObject_CallMethodId(handle, &PyId__run, NULL);
+        if (res == NULL) {
+            return -1;
+        }
+        Py_DECREF(res);
+        return 0;
+    }
+
+    context = _PyObject_GetAttrId(handle, &PyId__context);
+    if (context == NULL) {
+        goto finally;
+    }
+    callback = _PyObject_GetAttrId(handle, &PyId__callback);
+    if (callback == NULL) {
+        goto finally;
+    }
+    args = _PyObject_GetAttrId(handle, &PyId__args);
+    if (args == NULL) {
+        goto finally;
+    }
+    if (!PyTuple_Check(args)) {
+        PyErr_SetString(PyExc_TypeError, "handle._args must be a tuple");
+        goto finally;
+    }
+    run = _PyObject_GetAttrId(context, &PyId_run);
+    if (run == NULL) {
+        goto finally;
+    }
+
+    /* context.run(callback, *args) */
+    nargs = PyTuple_GET_SIZE(args) + 1;
+    if (nargs <= (Py_ssize_t)Py_ARRAY_LENGTH(small_stack)) {
+        stack = small_stack;
+    }
+    else {
+        stack = PyMem_New(PyObject *, nargs);
+        if (stack == NULL) {
+            PyErr_NoMemory();
+            goto finally;
+        }
+    }
+    stack[0] = callback;
+    for (i = 1; i < nargs; i++) {
+        stack[i] = PyTuple_GET_ITEM(args, i - 1);
+    }
+    res = _PyObject_FastCall(run, stack, nargs);
+    if (stack != small_stack) {
+        PyMem_Free(stack);
+    }
+
+    if (res != NULL) {
+        Py_DECREF(res);
+        ret = 0;
+    }
+    else if (PyErr_ExceptionMatches(PyExc_Exception)) {
+        ret = handle_report_exception(handle, callback, args);
+    }
+
+finally:
+    Py_XDECREF(context);
+    Py_XDECREF(callback);
+    Py_XDECREF(args);
+    Py_XDECREF(run);
+    return ret;
+}
+
+/* Run the callbacks which are ready now; callbacks scheduled by them wait
+   for the next iteration. */
+static int
+loop_run_ready(PyObject *ready)
+{
+    PyObject *handle;
+    Py_ssize_t ntodo, i;
+    int cancelled;
+
+    ntodo = PyObject_Size(ready);
+    if (ntodo < 0) {
+        return -1;
+    }
+    for (i = 0; i < ntodo; i++) {
+        handle = _PyObject_CallMethodId(ready, &PyId_popleft, NULL);
+        if (handle == NULL) {
+            return -1;
+        }
+        cancelled = handle_is_cancelled(handle);
+        if (cancelled == 0) {
+            cancelled = handle_run(handle);
+        }
+        Py_DECREF(handle);
+        if (cancelled < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(_asyncio__run_once__doc__,
+"_run_once($module, loop, /)\n"
+"--\n"
+"\n"
+"Run one full iteration of the event loop.\n"
+"\n"
+"C implementation of BaseEventLoop._run_once(): drop the cancelled\n"
+"timers, poll the selector, move the due timers to the ready queue then\n"
+"run the ready callbacks. Handle and TimerHandle callbacks are run\n"
+"without calling their _run() method. It doesn't log slow callbacks, so\n"
+"the Python implementation must be used in debug mode.");
+
+static PyObject *
+_asyncio__run_once(PyObject *module, PyObject *loop)
+{
+    PyListObject *scheduled;
+    PyObject *ready, *selector = NULL, *timeout = NULL;
+    PyObject *event_list = NULL, *o;
+
+    ready = _PyObject_GetAttrId(loop, &PyId__ready);
+    if (ready == NULL) {
+        return NULL;
+    }
+    scheduled = loop_get_scheduled(loop);
+    if (scheduled == NULL) {
+        goto error;
+    }
+    if (loop_compact_scheduled(loop, scheduled) < 0) {
+        Py_DECREF(scheduled);
+        goto error;
+    }
+    Py_DECREF(scheduled);
+    scheduled = loop_get_scheduled(loop);
+    if (scheduled == NULL) {
+        goto error;
+    }
+    timeout = loop_select_timeout(loop, ready, scheduled);
+    Py_DECREF(scheduled);
+    if (timeout == NULL) {
+        goto error;
+    }
+
+    selector = _PyObject_GetAttrId(loop, &PyId__selector);
+    if (selector == NULL) {
+        goto error;
+    }
+    event_list = _PyObject_CallMethodIdObjArgs(selector, &PyId_select,
+                                               timeout, NULL);
+    if (event_list == NULL) {
+        goto error;
+    }
+    o = _PyObject_CallMethodIdObjArgs(loop, &PyId__process_events,
+                                      event_list, NULL);
+    if (o == NULL) {
+        goto error;
+    }
+    Py_DECREF(o);
+
+    if (loop_schedule_due(loop, ready) < 0 || loop_run_ready(ready) < 0) {
+        goto error;
+    }
+
+    Py_DECREF(event_list);
+    Py_DECREF(selector);
+    Py_DECREF(timeout);
+    Py_DECREF(ready);
+    Py_RETURN_NONE;
+
+error:
+    Py_XDECREF(event_list);
+    Py_XDECREF(selector);
+    Py_XDECREF(timeout);
+    Py_DECREF(ready);
+    return NULL;
+}
+
+
 /*********************** PyRunningLoopHolder ********************/
 
 
@@ -3224,6 +3885,9 @@ module_free(void *m)
     Py_CLEAR(asyncio_task_repr_info_func);
     Py_CLEAR(asyncio_InvalidStateError);
     Py_CLEAR(asyncio_CancelledError);
+    Py_CLEAR(asyncio_Handle_type);
+    Py_CLEAR(asyncio_TimerHandle_type);
+    Py_CLEAR(asyncio_format_callback_source_func);
 
     Py_CLEAR(all_tasks);
     Py_CLEAR(current_tasks);
@@ -3280,6 +3944,12 @@ module_init(void)
 
     WITH_MOD("asyncio.events")
     GET_MOD_ATTR(asyncio_get_event_loop_policy, "get_event_loop_policy")
+    GET_MOD_ATTR(asyncio_Handle_type, "Handle")
+    GET_MOD_ATTR(asyncio_TimerHandle_type, "TimerHandle")
+
+    WITH_MOD("asyncio.format_helpers")
+    GET_MOD_ATTR(asyncio_format_callback_source_func,
+                 "_format_callback_source")
 
     WITH_MOD("asyncio.base_futures")
     GET_MOD_ATTR(asyncio_future_repr_info_func, "_future_repr_info")
@@ -3332,6 +4002,8 @@ static PyMethodDef asyncio_methods[] = {
     _ASYNCIO__UNREGISTER_TASK_METHODDEF
     _ASYNCIO__ENTER_TASK_METHODDEF
     _ASYNCIO__LEAVE_TASK_METHODDEF
+    {"_run_once", (PyCFunction)_asyncio__run_once, METH_O,
+     _asyncio__run_once__doc__},
     {NULL, NULL}
 };
 
@@ -110,19 +110,25 @@ static PyTypeObject deque_type;
 
 /* A simple freelisting scheme is used to minimize calls to the memory
    allocator.  It accommodates common use cases where new blocks are being
-   added at about the same rate as old blocks are being freed.
+   added at about the same rate as old blocks are being freed.  Bursty
+   producers and consumers can make the freelist larger with
+   _collections._deque_block_cache().  Free blocks are chained through
+   their rightlink.
  */
 
 #define MAXFREEBLOCKS 16
+static Py_ssize_t maxfreeblocks = MAXFREEBLOCKS;
 static Py_ssize_t numfreeblocks = 0;
-static block *freeblocks[MAXFREEBLOCKS];
+static block *freeblocks = NULL;
 
 static block *
 newblock(void) {
     block *b;
     if (numfreeblocks) {
         numfreeblocks--;
-        return freeblocks[numfreeblocks];
+        b = freeblocks;
+        freeblocks = b->rightlink;
+        return b;
     }
     b = PyMem_Malloc(sizeof(block));
     if (b != NULL) {
@@ -135,14 +141,44 @@ newblock(void) {
 static void
 freeblock(block *b)
 {
-    if (numfreeblocks < MAXFREEBLOCKS) {
-        freeblocks[numfreeblocks] = b;
+    if (numfreeblocks < maxfreeblocks) {
+        b->rightlink = freeblocks;
+        freeblocks = b;
         numfreeblocks++;
     } else {
         PyMem_Free(b);
     }
 }
 
+PyDoc_STRVAR(_deque_block_cache_doc,
+"_deque_block_cache([size]) -> int\n\
+\n\
+Return the number of free deque blocks kept for reuse.  If size is given,\n\
+set it and return the previous value; extra free blocks are released.");
+
+static PyObject *
+_deque_block_cache(PyObject *self, PyObject *args)
+{
+    Py_ssize_t size = -1, previous = maxfreeblocks;
+
+    if (!PyArg_ParseTuple(args, "|n:_deque_block_cache", &size))
+        return NULL;
+    if (PyTuple_GET_SIZE(args) != 0) {
+        if (size < 0) {
+            PyErr_SetString(PyExc_ValueError, "size must be non-negative");
+            return NULL;
+        }
+        maxfreeblocks = size;
+        while (numfreeblocks > maxfreeblocks) {
+            block *b = freeblocks;
+            freeblocks = b->rightlink;
+            numfreeblocks--;
+            PyMem_Free(b);
+        }
+    }
+    return PyLong_FromSsize_t(previous);
+}
+
 static PyObject *
 deque_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
@@ -338,6 +374,101 @@ deque_appendleft(dequeobject *deque, PyObject *item)
 
 PyDoc_STRVAR(appendleft_doc, "Add an element to the left side of the deque.");
 
+/* Fast paths of extend() and extendleft() for exact lists and tuples: the
+   items are copied a block at a time, and only the ones which survive the
+   trimming to maxlen are copied at all.  The items must not be reachable
+   from the deque, as trimming may run arbitrary code.
+ */
+
+static int
+deque_extend_items(dequeobject *deque, PyObject **items, Py_ssize_t n,
+                   Py_ssize_t maxlen)
+{
+    Py_ssize_t i, chunk;
+    PyObject **dest;
+    int err = 0;
+
+    if (maxlen >= 0 && n > maxlen) {
+        items += n - maxlen;
+        n = maxlen;
+    }
+    while (n > 0) {
+        if (deque->rightindex == BLOCKLEN - 1) {
+            block *b = newblock();
+            if (b == NULL) {
+                err = -1;
+                break;
+            }
+            b->leftlink = deque->rightblock;
+            CHECK_END(deque->rightblock->rightlink);
+            deque->rightblock->rightlink = b;
+            deque->rightblock = b;
+            MARK_END(b->rightlink);
+            deque->rightindex = -1;
+        }
+        chunk = Py_MIN(n, BLOCKLEN - 1 - deque->rightindex);
+        dest = &deque->rightblock->data[deque->rightindex + 1];
+        memcpy(dest, items, chunk * sizeof(PyObject *));
+        for (i = 0; i < chunk; i++)
+            Py_INCREF(dest[i]);
+        Py_SIZE(deque) += chunk;
+        deque->rightindex += chunk;
+        items += chunk;
+        n -= chunk;
+    }
+    deque->state++;
+    while (NEEDS_TRIM(deque, maxlen)) {
+        PyObject *olditem = deque_popleft(deque, NULL);
+        Py_DECREF(olditem);
+    }
+    return err;
+}
+
+static int
+deque_extendleft_items(dequeobject *deque, PyObject **items, Py_ssize_t n,
+                       Py_ssize_t maxlen)
+{
+    Py_ssize_t i, chunk;
+    PyObject **dest;
+    int err = 0;
+
+    if (maxlen >= 0 && n > maxlen) {
+        items += n - maxlen;
+        n = maxlen;
+    }
+    while (n > 0) {
+        if (deque->leftindex == 0) {
+            block *b = newblock();
+            if (b == NULL) {
+                err = -1;
+                break;
+            }
+            b->rightlink = deque->leftblock;
+            CHECK_END(deque->leftblock->leftlink);
+            deque->leftblock->leftlink = b;
+            deque->leftblock = b;
+            MARK_END(b->leftlink);
+            deque->leftindex = BLOCKLEN;
+        }
+        chunk = Py_MIN(n, deque->leftindex);
+        dest = &deque->leftblock->data[deque->leftindex - 1];
+        for (i = 0; i < chunk; i++) {
+            Py_INCREF(items[i]);
+            dest[-i] = items[i];
+        }
+        Py_SIZE(deque) += chunk;
+        deque->leftindex -= chunk;
+        items += chunk;
+        n -= chunk;
+    }
+    deque->state++;
+    while (NEEDS_TRIM(deque, maxlen)) {
+        PyObject *olditem = deque_pop(deque, NULL);
+        Py_DECREF(olditem);
+    }
+    return err;
+}
+
 static PyObject*
 finalize_iterator(PyObject *it)
 {
@@ -386,6 +517,21 @@ deque_extend(dequeobject *deque, PyObject *iterable)
         return result;
     }
 
+    if (PyList_CheckExact(iterable) || PyTuple_CheckExact(iterable)) {
+        if (PySequence_Fast_GET_SIZE(iterable) == 0 || maxlen == 0)
+            Py_RETURN_NONE;
+        /* Space saving heuristic.  Start filling from the left */
+        if (Py_SIZE(deque) == 0) {
+            deque->leftindex = 1;
+            deque->rightindex = 0;
+        }
+        if (deque_extend_items(deque, PySequence_Fast_ITEMS(iterable),
+                               PySequence_Fast_GET_SIZE(iterable),
+                               maxlen) < 0)
+            return NULL;
+        Py_RETURN_NONE;
+    }
+
     it = PyObject_GetIter(iterable);
     if (it == NULL)
         return NULL;
@@ -451,6 +597,21 @@ deque_extendleft(dequeobject *deque, PyObject *iterable)
         return result;
     }
 
+    if (PyList_CheckExact(iterable) || PyTuple_CheckExact(iterable)) {
+        if (PySequence_Fast_GET_SIZE(iterable) == 0 || maxlen == 0)
+            Py_RETURN_NONE;
+        /* Space saving heuristic.  Start filling from the right */
+        if (Py_SIZE(deque) == 0) {
+            deque->leftindex = BLOCKLEN - 1;
+            deque->rightindex = BLOCKLEN - 2;
+        }
+        if (deque_extendleft_items(deque, PySequence_Fast_ITEMS(iterable),
+                                   PySequence_Fast_GET_SIZE(iterable),
+                                   maxlen) < 0)
+            return NULL;
+        Py_RETURN_NONE;
+    }
+
     it = PyObject_GetIter(iterable);
     if (it == NULL)
         return NULL;
@@ -2372,6 +2533,7 @@ PyDoc_STRVAR(module_doc,
 
 static struct PyMethodDef module_functions[] = {
     {"_count_elements", _count_elements,    METH_VARARGS,   _count_elements_doc},
+    {"_deque_block_cache", _deque_block_cache, METH_VARARGS, _deque_block_cache_doc},
     {NULL,       NULL}          /* sentinel */
 };
 
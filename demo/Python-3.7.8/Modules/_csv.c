@@ -524,15 +524,9 @@ _call_dialect(PyObject *dialect_inst, PyObject *kwargs)
  * READER
  */
 static int
-parse_save_field(ReaderObj *self)
+parse_save_field_object(ReaderObj *self, PyObject *field)
 {
-    PyObject *field;
-
-    field = PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND,
-                                      (void *) self->field, self->field_len);
-    if (field == NULL)
-        return -1;
-    self->field_len = 0;
+    /* Steals the reference to field */
     if (self->numeric_field) {
         PyObject *tmp;
 
@@ -551,6 +545,19 @@ parse_save_field(ReaderObj *self)
     return 0;
 }
 
+static int
+parse_save_field(ReaderObj *self)
+{
+    PyObject *field;
+
+    field = PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND,
+                                      (void *) self->field, self->field_len);
+    if (field == NULL)
+        return -1;
+    self->field_len = 0;
+    return parse_save_field_object(self, field);
+}
+
 static int
 parse_grow_buff(ReaderObj *self)
 {
@@ -582,6 +589,147 @@ parse_add_char(ReaderObj *self, Py_UCS4 c)
     return 0;
 }
 
+static int
+parse_add_chars(ReaderObj *self, unsigned int kind, void *data,
+                Py_ssize_t start, Py_ssize_t end)
+{
+    Py_ssize_t i, n = end - start;
+
+    if (n > _csvstate_global->field_limit - self->field_len) {
+        PyErr_Format(_csvstate_global->error_obj, "field larger than field limit (%ld)",
+                     _csvstate_global->field_limit);
+        return -1;
+    }
+    while (self->field_size - self->field_len < n) {
+        if (!parse_grow_buff(self))
+            return -1;
+    }
+    if (kind == PyUnicode_4BYTE_KIND)
+        memcpy(self->field + self->field_len, (Py_UCS4 *)data + start,
+               n * sizeof(Py_UCS4));
+    else {
+        for (i = start; i < end; i++)
+            self->field[self->field_len++] = PyUnicode_READ(kind, data, i);
+        return 0;
+    }
+    self->field_len += n;
+    return 0;
+}
+
+/* Return the position of the first character at or after pos which the
+   state machine has to look at: in an unquoted field a delimiter, the
+   escape character or a line end, in a quoted field the quote or the
+   escape character. A NUL always stops the scan. */
+static Py_ssize_t
+parse_scan_field(ReaderObj *self, unsigned int kind, void *data,
+                 Py_ssize_t pos, Py_ssize_t len, int quoted)
+{
+    DialectObj *dialect = self->dialect;
+    Py_UCS4 stops[4], c;
+    int i, nstops = 0;
+
+    if (quoted) {
+        if (dialect->quoting != QUOTE_NONE)
+            stops[nstops++] = dialect->quotechar;
+    }
+    else {
+        stops[nstops++] = '\n';
+        stops[nstops++] = '\r';
+        stops[nstops++] = dialect->delimiter;
+    }
+    stops[nstops++] = dialect->escapechar;
+
+    if (kind == PyUnicode_1BYTE_KIND) {
+        /* The data of a ready string is always NUL terminated, so let
+           strcspn() do the scan. */
+        char reject[5];
+        int n = 0;
+
+        for (i = 0; i < nstops; i++) {
+            if (stops[i] != 0 && stops[i] < 256)
+                reject[n++] = (char)stops[i];
+        }
+        reject[n] = '\0';
+        return pos + (Py_ssize_t)strcspn((const char *)data + pos, reject);
+    }
+    for (; pos < len; pos++) {
+        c = PyUnicode_READ(kind, data, pos);
+        if (c == '\0')
+            break;
+        for (i = 0; i < nstops; i++) {
+            if (c == stops[i])
+                return pos;
+        }
+    }
+    return pos;
+}
+
+/* Handle the run of ordinary characters starting at pos in the line in one
+   step. An unquoted field lying entirely within the line is sliced out of
+   it without going through the field buffer. Return the position of the
+   next character for parse_process_char(), or -1 on error. */
+static Py_ssize_t
+parse_process_run(ReaderObj *self, PyObject *lineobj, Py_ssize_t pos)
+{
+    DialectObj *dialect = self->dialect;
+    unsigned int kind = PyUnicode_KIND(lineobj);
+    void *data = PyUnicode_DATA(lineobj);
+    Py_ssize_t end, len = PyUnicode_GET_LENGTH(lineobj);
+    PyObject *field;
+    Py_UCS4 c;
+
+    switch (self->state) {
+    case START_RECORD:
+    case START_FIELD:
+        c = PyUnicode_READ(kind, data, pos);
+        if (c == '\n' || c == '\r' || c == '\0' ||
+            c == dialect->delimiter || c == dialect->escapechar ||
+            (c == ' ' && dialect->skipinitialspace) ||
+            (c == dialect->quotechar && dialect->quoting != QUOTE_NONE))
+            return pos;
+        /* begin new unquoted field */
+        if (dialect->quoting == QUOTE_NONNUMERIC)
+            self->numeric_field = 1;
+        self->state = IN_FIELD;
+        /* fallthru */
+    case IN_FIELD:
+        end = parse_scan_field(self, kind, data, pos, len, 0);
+        if (end == pos)
+            return pos;
+        c = (end < len) ? PyUnicode_READ(kind, data, end) : 0;
+        if (self->field_len != 0 ||
+            (end < len && (c == '\0' || c == dialect->escapechar))) {
+            if (parse_add_chars(self, kind, data, pos, end) < 0)
+                return -1;
+            return end;
+        }
+        /* the whole field is in the line */
+        if (end - pos > _csvstate_global->field_limit) {
+            PyErr_Format(_csvstate_global->error_obj, "field larger than field limit (%ld)",
+                         _csvstate_global->field_limit);
+            return -1;
+        }
+        field = PyUnicode_Substring(lineobj, pos, end);
+        if (field == NULL || parse_save_field_object(self, field) < 0)
+            return -1;
+        if (end == len) {
+            self->state = START_RECORD;
+            return end;
+        }
+        self->state = (c == dialect->delimiter) ? START_FIELD : EAT_CRNL;
+        return end + 1;
+
+    case IN_QUOTED_FIELD:
+        end = parse_scan_field(self, kind, data, pos, len, 1);
+        if (end > pos && parse_add_chars(self, kind, data, pos, end) < 0)
+            return -1;
+        return end;
+
+    default:
+        return pos;
+    }
+}
+
 static int
 parse_process_char(ReaderObj *self, Py_UCS4 c)
 {
@@ -820,7 +968,14 @@ Reader_iternext(ReaderObj *self)
         data = PyUnicode_DATA(lineobj);
         pos = 0;
         linelen = PyUnicode_GET_LENGTH(lineobj);
-        while (linelen--) {
+        while (pos < linelen) {
+            pos = parse_process_run(self, lineobj, pos);
+            if (pos < 0) {
+                Py_DECREF(lineobj);
+                goto err;
+            }
+            if (pos == linelen)
+                break;
             c = PyUnicode_READ(kind, data, pos);
             if (c == '\0') {
                 Py_DECREF(lineobj);
@@ -770,6 +770,60 @@ parse_hh_mm_ss_ff(const char *tstr, const char *tstr_end, int *hour,
     return *p != '\0';
 }
 
+static int
+parse_isoformat_canonical(const char *dtstr, Py_ssize_t len, int *year,
+                          int *month, int *day, int *hour, int *minute,
+                          int *second, int *microsecond, int *tzoffset)
+{
+    // Parse the common YYYY-MM-DD?HH:MM:SS[.ffffff][+HH:MM] shapes at fixed
+    // positions, without scanning for the time zone first
+    //
+    // Return codes:
+    //      0:  Success (no tzoffset)
+    //      1:  Success (with tzoffset)
+    //     -1:  Not one of these shapes, use the general parser
+    const char *p = dtstr;
+    size_t base_len;
+
+    switch (len) {
+        case 19: case 25:
+            base_len = 19;
+            break;
+        case 26: case 32:
+            base_len = 26;
+            break;
+        default:
+            return -1;
+    }
+
+    if (parse_isoformat_date(p, year, month, day) < 0 ||
+        (p[10] & 0x80) != 0 || p[13] != ':' || p[16] != ':') {
+        return -1;
+    }
+    if (parse_digits(p + 11, hour, 2) == NULL ||
+        parse_digits(p + 14, minute, 2) == NULL ||
+        parse_digits(p + 17, second, 2) == NULL) {
+        return -1;
+    }
+    if (base_len == 26 &&
+        (p[19] != '.' || parse_digits(p + 20, microsecond, 6) == NULL)) {
+        return -1;
+    }
+    if ((size_t)len == base_len) {
+        return 0;
+    }
+
+    p += base_len;
+    int tzhour = 0, tzminute = 0;
+    if ((p[0] != '+' && p[0] != '-') || p[3] != ':' ||
+        parse_digits(p + 1, &tzhour, 2) == NULL ||
+        parse_digits(p + 4, &tzminute, 2) == NULL) {
+        return -1;
+    }
+    *tzoffset = (p[0] == '-' ? -1 : 1) * (tzhour * 3600 + tzminute * 60);
+    return 1;
+}
+
 static int
 parse_isoformat_time(const char *dtstr, size_t dtlen, int *hour, int *minute,
                      int *second, int *microsecond, int *tzoffset,
@@ -1193,6 +1247,15 @@ call_tzinfo_method(PyObject *tzinfo, const char *name, PyObject *tzinfoarg)
 static PyObject *
 call_utcoffset(PyObject *tzinfo, PyObject *tzinfoarg)
 {
+    /* A timezone can't be subclassed and its offset is known to be in
+     * range, so skip the method lookup and call.
+     */
+    if (Py_TYPE(tzinfo) == &PyDateTime_TimeZoneType &&
+        (tzinfoarg == Py_None || PyDateTime_Check(tzinfoarg))) {
+        PyObject *offset = ((PyDateTime_TimeZone *)tzinfo)->offset;
+        Py_INCREF(offset);
+        return offset;
+    }
     return call_tzinfo_method(tzinfo, "utcoffset", tzinfoarg);
 }
 
@@ -1207,6 +1270,9 @@ call_utcoffset(PyObject *tzinfo, PyObject *tzinfoarg)
 static PyObject *
 call_dst(PyObject *tzinfo, PyObject *tzinfoarg)
 {
+    if (Py_TYPE(tzinfo) == &PyDateTime_TimeZoneType &&
+        (tzinfoarg == Py_None || PyDateTime_Check(tzinfoarg)))
+        Py_RETURN_NONE;
     return call_tzinfo_method(tzinfo, "dst", tzinfoarg);
 }
 
@@ -1295,6 +1361,19 @@ append_keyword_fold(PyObject *repr, int fold)
     return repr;
 }
 
+/* Parsed strings usually carry one of a few offsets, so the timezones
+ * made for the most recent ones are kept and handed out again. The cache
+ * is only touched with the GIL held.
+ */
+#define TZINFO_CACHE_SIZE 8
+
+static struct {
+    int tzoffset;
+    int tz_useconds;
+    PyObject *tzinfo;
+} tzinfo_cache[TZINFO_CACHE_SIZE];
+static int tzinfo_cache_next = 0;
+
 static inline PyObject *
 tzinfo_from_isoformat_results(int rv, int tzoffset, int tz_useconds)
 {
@@ -1306,12 +1385,31 @@ tzinfo_from_isoformat_results(int rv, int tzoffset, int tz_useconds)
             return PyDateTime_TimeZone_UTC;
         }
 
+        for (int i = 0; i < TZINFO_CACHE_SIZE; i++) {
+            if (tzinfo_cache[i].tzinfo != NULL &&
+                tzinfo_cache[i].tzoffset == tzoffset &&
+                tzinfo_cache[i].tz_useconds == tz_useconds) {
+                Py_INCREF(tzinfo_cache[i].tzinfo);
+                return tzinfo_cache[i].tzinfo;
+            }
+        }
+
         PyObject *delta = new_delta(0, tzoffset, tz_useconds, 1);
         if (delta == NULL) {
             return NULL;
         }
         tzinfo = new_timezone(delta, NULL);
         Py_DECREF(delta);
+        if (tzinfo == NULL) {
+            return NULL;
+        }
+
+        int slot = tzinfo_cache_next;
+        tzinfo_cache_next = (slot + 1) % TZINFO_CACHE_SIZE;
+        Py_INCREF(tzinfo);
+        Py_XSETREF(tzinfo_cache[slot].tzinfo, tzinfo);
+        tzinfo_cache[slot].tzoffset = tzoffset;
+        tzinfo_cache[slot].tz_useconds = tz_useconds;
     }
     else {
         tzinfo = Py_None;
@@ -5016,6 +5114,35 @@ datetime_fromisoformat(PyObject *cls, PyObject *dtstr)
         return NULL;
     }
 
+    int year = 0, month = 0, day = 0;
+    int hour = 0, minute = 0, second = 0, microsecond = 0;
+    int tzoffset = 0, tzusec = 0;
+    int rv;
+
+    // ASCII strings can't hold surrogates and are their own UTF-8, so the
+    // common shapes are parsed straight from the string data
+    if (PyUnicode_IS_READY(dtstr) && PyUnicode_IS_ASCII(dtstr)) {
+        rv = parse_isoformat_canonical(PyUnicode_DATA(dtstr),
+                                       PyUnicode_GET_LENGTH(dtstr),
+                                       &year, &month, &day, &hour, &minute,
+                                       &second, &microsecond, &tzoffset);
+        if (rv >= 0) {
+            PyObject *tzinfo = tzinfo_from_isoformat_results(rv, tzoffset,
+                                                             tzusec);
+            if (tzinfo == NULL) {
+                return NULL;
+            }
+            PyObject *dt = new_datetime_subclass_ex(year, month, day, hour,
+                                                    minute, second,
+                                                    microsecond, tzinfo, cls);
+            Py_DECREF(tzinfo);
+            return dt;
+        }
+        year = month = day = 0;
+        hour = minute = second = microsecond = 0;
+        tzoffset = 0;
+    }
+
     PyObject *dtstr_clean = _sanitize_isoformat_str(dtstr);
     if (dtstr_clean == NULL) {
         goto error;
@@ -5036,12 +5163,8 @@ datetime_fromisoformat(PyObject *cls, PyObject *dtstr)
 
     const char *p = dt_ptr;
 
-    int year = 0, month = 0, day = 0;
-    int hour = 0, minute = 0, second = 0, microsecond = 0;
-    int tzoffset = 0, tzusec = 0;
-
     // date has a fixed length of 10
-    int rv = parse_isoformat_date(p, &year, &month, &day);
+    rv = parse_isoformat_date(p, &year, &month, &day);
 
     if (!rv && len > 10) {
         // In UTF-8, the length of multi-byte characters is encoded in the MSB
@@ -5357,6 +5480,39 @@ datetime_isoformat(PyDateTime_DateTime *self, PyObject *args, PyObject *kw)
         PyErr_Format(PyExc_ValueError, "Unknown timespec value");
         return NULL;
     }
+    else if (sep < 128) {
+        /* Build the whole ASCII string, UTC offset included, in the buffer
+         * and create the result from it in one go. */
+        char *p = buffer;
+        int i, j, value, width;
+        const int fields[] = {
+            GET_YEAR(self), GET_MONTH(self), GET_DAY(self),
+            DATE_GET_HOUR(self), DATE_GET_MINUTE(self), DATE_GET_SECOND(self),
+            us
+        };
+        static const char widths[] = {4, 2, 2, 2, 2, 2, 6};
+        static const char separators[] = "--?::.";
+        const int nfields = Py_MIN(4 + (int)given_spec, 7);
+
+        for (i = 0; i < nfields; i++) {
+            if (i > 0)
+                *p++ = (i == 3) ? (char)sep : separators[i - 1];
+            width = (i == 6 && given_spec == 3) ? 3 : widths[i];
+            value = fields[i];
+            p += width;
+            for (j = 1; j <= width; j++) {
+                p[-j] = '0' + value % 10;
+                value /= 10;
+            }
+        }
+        if (HASTZINFO(self)) {
+            if (format_utcoffset(p, sizeof(buffer) - (p - buffer), ":",
+                                 self->tzinfo, (PyObject *)self) < 0)
+                return NULL;
+            p += strlen(p);
+        }
+        return PyUnicode_FromStringAndSize(buffer, p - buffer);
+    }
     else {
         result = PyUnicode_FromFormat(specs[given_spec][1],
                                       GET_YEAR(self), GET_MONTH(self),
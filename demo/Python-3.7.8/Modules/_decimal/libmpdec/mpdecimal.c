@@ -4447,6 +4447,54 @@ mpd_qfma(mpd_t *result, const mpd_t *a, const mpd_t *b, const mpd_t *c,
     *status |= workstatus;
 }
 
+/*
+ * Sum of the n operands in a, added from left to right to a zero with
+ * exponent 0. Each addition is rounded, so the result and the status are
+ * those of the equivalent loop of mpd_qadd(), but result itself is the
+ * accumulator. result must not be one of the operands.
+ */
+void
+mpd_qsum(mpd_t *result, const mpd_t * const *a, mpd_ssize_t n,
+         const mpd_context_t *ctx, uint32_t *status)
+{
+    mpd_ssize_t i;
+
+    _settriple(result, MPD_POS, 0, 0);
+    for (i = 0; i < n; i++) {
+        mpd_qadd(result, result, a[i], ctx, status);
+    }
+}
+
+/*
+ * Dot product of the n operands in a and b: the products a[i] * b[i] are
+ * added from left to right to a zero with exponent 0, each step with a
+ * single rounding as in mpd_qfma(). All exact products share one scratch
+ * number. result must not be one of the operands.
+ */
+void
+mpd_qdot(mpd_t *result, const mpd_t * const *a, const mpd_t * const *b,
+         mpd_ssize_t n, const mpd_context_t *ctx, uint32_t *status)
+{
+    MPD_NEW_STATIC(prod,0,0,0,0);
+    uint32_t workstatus;
+    mpd_ssize_t i;
+
+    _settriple(result, MPD_POS, 0, 0);
+    for (i = 0; i < n; i++) {
+        workstatus = 0;
+        _mpd_qmul(&prod, a[i], b[i], ctx, &workstatus);
+        if (workstatus&MPD_Invalid_operation) {
+            mpd_qcopy(result, &prod, &workstatus);
+        }
+        else {
+            mpd_qadd(result, result, &prod, ctx, &workstatus);
+        }
+        *status |= workstatus;
+    }
+
+    mpd_del(&prod);
+}
+
 /*
  * Schedule the optimal precision increase for the Newton iteration.
  *   v := input operand
@@ -6867,6 +6915,23 @@ mpd_qquantize(mpd_t *result, const mpd_t *a, const mpd_t *b,
     mpd_qfinalize(result, ctx, status);
 }
 
+/*
+ * Quantize the n operands in a to the exponent of b, storing each result
+ * in the corresponding entry of result. The status is the union of the
+ * status of all the operations.
+ */
+void
+mpd_qquantize_many(mpd_t * const *result, const mpd_t * const *a,
+                   mpd_ssize_t n, const mpd_t *b, const mpd_context_t *ctx,
+                   uint32_t *status)
+{
+    mpd_ssize_t i;
+
+    for (i = 0; i < n; i++) {
+        mpd_qquantize(result[i], a[i], b, ctx, status);
+    }
+}
+
 void
 mpd_qreduce(mpd_t *result, const mpd_t *a, const mpd_context_t *ctx,
             uint32_t *status)
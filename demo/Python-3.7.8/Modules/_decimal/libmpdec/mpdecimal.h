@@ -513,6 +513,7 @@ void mpd_qnext_minus(mpd_t *result, const mpd_t *a, const mpd_context_t *ctx, ui
 void mpd_qnext_plus(mpd_t *result, const mpd_t *a, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qnext_toward(mpd_t *result, const mpd_t *a, const mpd_t *b, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qquantize(mpd_t *result, const mpd_t *a, const mpd_t *b, const mpd_context_t *ctx, uint32_t *status);
+void mpd_qquantize_many(mpd_t * const *result, const mpd_t * const *a, mpd_ssize_t n, const mpd_t *b, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qrescale(mpd_t *result, const mpd_t *a, mpd_ssize_t exp, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qrescale_fmt(mpd_t *result, const mpd_t *a, mpd_ssize_t exp, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qreduce(mpd_t *result, const mpd_t *a, const mpd_context_t *ctx, uint32_t *status);
@@ -532,6 +533,8 @@ void mpd_qmul_i32(mpd_t *result, const mpd_t *a, int32_t b, const mpd_context_t
 void mpd_qmul_uint(mpd_t *result, const mpd_t *a, mpd_uint_t b, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qmul_u32(mpd_t *result, const mpd_t *a, uint32_t b, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qfma(mpd_t *result, const mpd_t *a, const mpd_t *b, const mpd_t *c, const mpd_context_t *ctx, uint32_t *status);
+void mpd_qsum(mpd_t *result, const mpd_t * const *a, mpd_ssize_t n, const mpd_context_t *ctx, uint32_t *status);
+void mpd_qdot(mpd_t *result, const mpd_t * const *a, const mpd_t * const *b, mpd_ssize_t n, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qdiv(mpd_t *q, const mpd_t *a, const mpd_t *b, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qdiv_ssize(mpd_t *result, const mpd_t *a, mpd_ssize_t b, const mpd_context_t *ctx, uint32_t *status);
 void mpd_qdiv_i32(mpd_t *result, const mpd_t *a, int32_t b, const mpd_context_t *ctx, uint32_t *status);
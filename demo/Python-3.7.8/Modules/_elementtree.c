@@ -127,10 +127,13 @@ elementtree_traverse(PyObject *m, visitproc visit, void *arg)
     return 0;
 }
 
+static void elementtree_clear_freelist(void);
+
 static void
 elementtree_free(void *m)
 {
     elementtree_clear((PyObject *)m);
+    elementtree_clear_freelist();
 }
 
 /* helpers */
@@ -267,6 +270,26 @@ clear_extra(ElementObject* self)
     dealloc_extra(myextra);
 }
 
+/* Deallocated Element objects (not instances of subclasses) are kept in
+ * a free list and reused by create_new_element(), so that a parser whose
+ * consumer drops the elements it has processed recycles them instead of
+ * allocating new ones.
+*/
+#ifndef ELEMENT_MAXFREELIST
+#define ELEMENT_MAXFREELIST 256
+#endif
+static ElementObject *element_free_list[ELEMENT_MAXFREELIST];
+static int element_numfree = 0;
+
+static void
+elementtree_clear_freelist(void)
+{
+    while (element_numfree) {
+        ElementObject *op = element_free_list[--element_numfree];
+        PyObject_GC_Del(op);
+    }
+}
+
 /* Convenience internal function to create new Element objects with the given
  * tag and attributes.
 */
@@ -275,9 +298,15 @@ create_new_element(PyObject* tag, PyObject* attrib)
 {
     ElementObject* self;
 
-    self = PyObject_GC_New(ElementObject, &Element_Type);
-    if (self == NULL)
-        return NULL;
+    if (element_numfree) {
+        self = element_free_list[--element_numfree];
+        _Py_NewReference((PyObject *)self);
+    }
+    else {
+        self = PyObject_GC_New(ElementObject, &Element_Type);
+        if (self == NULL)
+            return NULL;
+    }
     self->extra = NULL;
 
     Py_INCREF(tag);
@@ -659,7 +688,10 @@ element_dealloc(ElementObject* self)
     element_gc_clear(self);
 
     RELEASE(sizeof(ElementObject), "destroy element");
-    Py_TYPE(self)->tp_free((PyObject *)self);
+    if (element_numfree < ELEMENT_MAXFREELIST && Element_CheckExact(self))
+        element_free_list[element_numfree++] = self;
+    else
+        Py_TYPE(self)->tp_free((PyObject *)self);
     Py_TRASHCAN_SAFE_END(self)
 }
 
@@ -2784,6 +2816,10 @@ static struct PyExpat_CAPI *expat_capi;
 static XML_Memory_Handling_Suite ExpatMemoryHandler = {
     PyObject_Malloc, PyObject_Realloc, PyObject_Free};
 
+/* Number of entries in the cache of the names last converted by
+   makeuniversal(). Must be a power of 2. */
+#define NAME_CACHE_SIZE 64
+
 typedef struct {
     PyObject_HEAD
 
@@ -2794,6 +2830,14 @@ typedef struct {
 
     PyObject *names;
 
+    /* Direct-mapped cache in front of the names dictionary, so that a
+       known tag or attribute name is found without creating a bytes
+       object for the lookup. */
+    struct {
+        PyObject *raw;
+        PyObject *name;
+    } name_cache[NAME_CACHE_SIZE];
+
     PyObject *handle_start;
     PyObject *handle_data;
     PyObject *handle_end;
@@ -2820,9 +2864,24 @@ makeuniversal(XMLParserObject* self, const char* string)
     /* convert a UTF-8 tag/attribute name from the expat parser
        to a universal name string */
 
-    Py_ssize_t size = (Py_ssize_t) strlen(string);
+    Py_ssize_t size;
+    size_t hash = 0;
     PyObject* key;
     PyObject* value;
+    PyObject* raw;
+
+    for (size = 0; string[size]; size++)
+        hash = hash * 31 + (unsigned char) string[size];
+    hash &= NAME_CACHE_SIZE - 1;
+
+    /* names are usually repeated, so try the cache first */
+    raw = self->name_cache[hash].raw;
+    if (raw && PyBytes_GET_SIZE(raw) == size &&
+        memcmp(PyBytes_AS_STRING(raw), string, size) == 0) {
+        value = self->name_cache[hash].name;
+        Py_INCREF(value);
+        return value;
+    }
 
     /* look the 'raw' name up in the names dictionary */
     key = PyBytes_FromStringAndSize(string, size);
@@ -2879,7 +2938,9 @@ makeuniversal(XMLParserObject* self, const char* string)
         }
     }
 
-    Py_DECREF(key);
+    Py_XSETREF(self->name_cache[hash].raw, key);
+    Py_INCREF(value);
+    Py_XSETREF(self->name_cache[hash].name, value);
     return value;
 }
 
@@ -3445,6 +3506,8 @@ xmlparser_gc_traverse(XMLParserObject *self, visitproc visit, void *arg)
 static int
 xmlparser_gc_clear(XMLParserObject *self)
 {
+    int i;
+
     if (self->parser != NULL) {
         XML_Parser parser = self->parser;
         self->parser = NULL;
@@ -3463,6 +3526,11 @@ xmlparser_gc_clear(XMLParserObject *self)
     Py_CLEAR(self->entity);
     Py_CLEAR(self->names);
 
+    for (i = 0; i < NAME_CACHE_SIZE; i++) {
+        Py_CLEAR(self->name_cache[i].raw);
+        Py_CLEAR(self->name_cache[i].name);
+    }
+
     return 0;
 }
 
@@ -3509,6 +3577,24 @@ expat_parse(XMLParserObject* self, const char* data, int data_len, int final)
     Py_RETURN_NONE;
 }
 
+/* Feed data of any size to expat, in pieces which fit in an int. This lets
+   a whole mmap'ed file be parsed in place. */
+LOCAL(PyObject*)
+expat_parse_all(XMLParserObject* self, const char* data, Py_ssize_t data_len)
+{
+    PyObject* res;
+
+    while (data_len > INT_MAX) {
+        res = expat_parse(self, data, INT_MAX, 0);
+        if (!res)
+            return NULL;
+        Py_DECREF(res);
+        data += INT_MAX;
+        data_len -= INT_MAX;
+    }
+    return expat_parse(self, data, (int)data_len, 0);
+}
+
 /*[clinic input]
 _elementtree.XMLParser.close
 
@@ -3564,25 +3650,16 @@ _elementtree_XMLParser_feed(XMLParserObject *self, PyObject *data)
         const char *data_ptr = PyUnicode_AsUTF8AndSize(data, &data_len);
         if (data_ptr == NULL)
             return NULL;
-        if (data_len > INT_MAX) {
-            PyErr_SetString(PyExc_OverflowError, "size does not fit in an int");
-            return NULL;
-        }
         /* Explicitly set UTF-8 encoding. Return code ignored. */
         (void)EXPAT(SetEncoding)(self->parser, "utf-8");
-        return expat_parse(self, data_ptr, (int)data_len, 0);
+        return expat_parse_all(self, data_ptr, data_len);
     }
     else {
         Py_buffer view;
         PyObject *res;
         if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0)
             return NULL;
-        if (view.len > INT_MAX) {
-            PyBuffer_Release(&view);
-            PyErr_SetString(PyExc_OverflowError, "size does not fit in an int");
-            return NULL;
-        }
-        res = expat_parse(self, view.buf, (int)view.len, 0);
+        res = expat_parse_all(self, view.buf, view.len);
         PyBuffer_Release(&view);
         return res;
     }
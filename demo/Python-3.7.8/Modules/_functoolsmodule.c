@@ -692,6 +692,7 @@ typedef struct lru_list_elem {
     struct lru_list_elem *prev, *next;  /* borrowed links */
     Py_hash_t hash;
     PyObject *key, *result;
+    Py_ssize_t weight;
 } lru_list_elem;
 
 static void
@@ -740,6 +741,10 @@ typedef struct lru_cache_object {
     Py_ssize_t misses;
     PyObject *cache_info_type;
     PyObject *dict;
+    Py_ssize_t evictions;
+    PyObject *weigher;
+    Py_ssize_t maxbytes;
+    Py_ssize_t currbytes;
 } lru_cache_object;
 
 static PyTypeObject lru_cache_type;
@@ -995,6 +1000,7 @@ bounded_lru_cache_wrapper(lru_cache_object *self, PyObject *args, PyObject *kwds
         link->hash = hash;
         link->key = key;
         link->result = result;
+        link->weight = 0;
         /* What is really needed here is a SetItem variant with a "no clobber"
            option.  If the __eq__ call triggers a reentrant call that adds
            this same key, then this setitem call will update the cache dict
@@ -1081,6 +1087,7 @@ bounded_lru_cache_wrapper(lru_cache_object *self, PyObject *args, PyObject *kwds
         return NULL;
     }
     lru_cache_append_link(self, link);
+    self->evictions++;
     Py_INCREF(result); /* for return */
     Py_DECREF(popresult);
     Py_DECREF(oldkey);
@@ -1088,20 +1095,152 @@ bounded_lru_cache_wrapper(lru_cache_object *self, PyObject *args, PyObject *kwds
     return result;
 }
 
+static void lru_cache_clear_list(lru_list_elem *link);
+
+/* The weighted variant bounds the total weight of the cached results, as
+   given by the weigher callable, by maxbytes, and optionally their number
+   by maxsize.  A new result is always linked in first; then the oldest
+   links are evicted until both bounds hold again.  Evicted links are
+   chained through their next fields and only released once the cache is
+   consistent, for the same reentrancy reasons as above.  A result which
+   alone weighs more than maxbytes is returned without being cached.
+ */
+
+static PyObject *
+weighted_lru_cache_wrapper(lru_cache_object *self, PyObject *args, PyObject *kwds)
+{
+    lru_list_elem *link, *oldest, *evicted = NULL;
+    PyObject *key, *result, *testresult, *weight_O, *popresult;
+    Py_ssize_t weight;
+    Py_hash_t hash;
+
+    key = lru_cache_make_key(args, kwds, self->typed);
+    if (!key)
+        return NULL;
+    hash = PyObject_Hash(key);
+    if (hash == -1) {
+        Py_DECREF(key);
+        return NULL;
+    }
+    link  = (lru_list_elem *)_PyDict_GetItem_KnownHash(self->cache, key, hash);
+    if (link != NULL) {
+        lru_cache_extract_link(link);
+        lru_cache_append_link(self, link);
+        result = link->result;
+        self->hits++;
+        Py_INCREF(result);
+        Py_DECREF(key);
+        return result;
+    }
+    if (PyErr_Occurred()) {
+        Py_DECREF(key);
+        return NULL;
+    }
+    self->misses++;
+    result = PyObject_Call(self->func, args, kwds);
+    if (!result) {
+        Py_DECREF(key);
+        return NULL;
+    }
+    weight_O = PyObject_CallFunctionObjArgs(self->weigher, result, NULL);
+    if (weight_O == NULL) {
+        Py_DECREF(key);
+        Py_DECREF(result);
+        return NULL;
+    }
+    weight = PyNumber_AsSsize_t(weight_O, PyExc_OverflowError);
+    Py_DECREF(weight_O);
+    if (weight == -1 && PyErr_Occurred()) {
+        Py_DECREF(key);
+        Py_DECREF(result);
+        return NULL;
+    }
+    if (weight < 0) {
+        PyErr_SetString(PyExc_ValueError, "weigher returned a negative weight");
+        Py_DECREF(key);
+        Py_DECREF(result);
+        return NULL;
+    }
+    if (weight > self->maxbytes) {
+        Py_DECREF(key);
+        return result;
+    }
+    testresult = _PyDict_GetItem_KnownHash(self->cache, key, hash);
+    if (testresult != NULL) {
+        /* The same key was added to the cache during the calls */
+        Py_DECREF(key);
+        return result;
+    }
+    if (PyErr_Occurred()) {
+        Py_DECREF(key);
+        Py_DECREF(result);
+        return NULL;
+    }
+
+    link = (lru_list_elem *)PyObject_New(lru_list_elem,
+                                         &lru_list_elem_type);
+    if (link == NULL) {
+        Py_DECREF(key);
+        Py_DECREF(result);
+        return NULL;
+    }
+    link->hash = hash;
+    link->key = key;
+    link->result = result;
+    link->weight = weight;
+    if (_PyDict_SetItem_KnownHash(self->cache, key, (PyObject *)link,
+                                  hash) < 0) {
+        Py_DECREF(link);
+        return NULL;
+    }
+    lru_cache_append_link(self, link);
+    self->currbytes += weight;
+    Py_INCREF(result); /* for return */
+
+    while ((self->currbytes > self->maxbytes ||
+            (self->maxsize >= 0 &&
+             PyDict_GET_SIZE(self->cache) > self->maxsize)) &&
+           self->root.next != link)
+    {
+        oldest = self->root.next;
+        lru_cache_extract_link(oldest);
+        popresult = _PyDict_Pop_KnownHash(self->cache, oldest->key,
+                                          oldest->hash, Py_None);
+        if (popresult == NULL) {
+            /* Restore the oldest link and let the error propagate */
+            lru_cache_prepend_link(self, oldest);
+            Py_CLEAR(result);
+            break;
+        }
+        /* An orphan (popresult is None) is dropped all the same */
+        if (popresult != Py_None)
+            self->evictions++;
+        Py_DECREF(popresult);
+        self->currbytes -= oldest->weight;
+        oldest->next = evicted;
+        evicted = oldest;
+    }
+    lru_cache_clear_list(evicted);
+    return result;
+}
+
 static PyObject *
 lru_cache_new(PyTypeObject *type, PyObject *args, PyObject *kw)
 {
     PyObject *func, *maxsize_O, *cache_info_type, *cachedict;
+    PyObject *maxbytes_O = Py_None, *weigher = Py_None;
     int typed;
     lru_cache_object *obj;
-    Py_ssize_t maxsize;
+    Py_ssize_t maxsize, maxbytes = -1;
     PyObject *(*wrapper)(lru_cache_object *, PyObject *, PyObject *);
     static char *keywords[] = {"user_function", "maxsize", "typed",
-                               "cache_info_type", NULL};
+                               "cache_info_type", "maxbytes", "weigher",
+                               NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kw, "OOpO:lru_cache", keywords,
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "OOpO|$OO:lru_cache", keywords,
                                      &func, &maxsize_O, &typed,
-                                     &cache_info_type)) {
+                                     &cache_info_type, &maxbytes_O,
+                                     &weigher)) {
         return NULL;
     }
 
@@ -1132,6 +1271,35 @@ lru_cache_new(PyTypeObject *type, PyObject *args, PyObject *kw)
         return NULL;
     }
 
+    /* a size bound switches to the weighted variant, with sys.getsizeof()
+       as the default weigher */
+    if (maxbytes_O != Py_None) {
+        maxbytes = PyNumber_AsSsize_t(maxbytes_O, PyExc_OverflowError);
+        if (maxbytes == -1 && PyErr_Occurred())
+            return NULL;
+        if (maxbytes < 0) {
+            PyErr_SetString(PyExc_ValueError, "maxbytes must not be negative");
+            return NULL;
+        }
+        if (weigher == Py_None) {
+            weigher = PySys_GetObject("getsizeof");
+            if (weigher == NULL) {
+                PyErr_SetString(PyExc_RuntimeError, "lost sys.getsizeof");
+                return NULL;
+            }
+        }
+        if (!PyCallable_Check(weigher)) {
+            PyErr_SetString(PyExc_TypeError, "weigher must be callable");
+            return NULL;
+        }
+        if (maxsize != 0)
+            wrapper = weighted_lru_cache_wrapper;
+    }
+    else if (weigher != Py_None) {
+        PyErr_SetString(PyExc_TypeError, "weigher requires maxbytes");
+        return NULL;
+    }
+
     if (!(cachedict = PyDict_New()))
         return NULL;
 
@@ -1152,6 +1320,13 @@ lru_cache_new(PyTypeObject *type, PyObject *args, PyObject *kw)
     obj->maxsize = maxsize;
     Py_INCREF(cache_info_type);
     obj->cache_info_type = cache_info_type;
+    obj->evictions = 0;
+    obj->maxbytes = maxbytes;
+    obj->currbytes = 0;
+    if (maxbytes_O != Py_None) {
+        Py_INCREF(weigher);
+        obj->weigher = weigher;
+    }
     return (PyObject *)obj;
 }
 
@@ -1189,6 +1364,7 @@ lru_cache_dealloc(lru_cache_object *obj)
     Py_XDECREF(obj->func);
     Py_XDECREF(obj->cache_info_type);
     Py_XDECREF(obj->dict);
+    Py_XDECREF(obj->weigher);
     lru_cache_clear_list(list);
     Py_TYPE(obj)->tp_free(obj);
 }
@@ -1226,12 +1402,43 @@ static PyObject *
 lru_cache_cache_clear(lru_cache_object *self, PyObject *unused)
 {
     lru_list_elem *list = lru_cache_unlink_list(self);
-    self->hits = self->misses = 0;
+    self->hits = self->misses = self->evictions = 0;
+    self->currbytes = 0;
     PyDict_Clear(self->cache);
     lru_cache_clear_list(list);
     Py_RETURN_NONE;
 }
 
+static PyObject *
+lru_cache_cache_stats(lru_cache_object *self, PyObject *unused)
+{
+    PyObject *maxsize, *currbytes, *maxbytes;
+
+    if (self->maxsize == -1) {
+        Py_INCREF(Py_None);
+        maxsize = Py_None;
+    }
+    else
+        maxsize = PyLong_FromSsize_t(self->maxsize);
+    if (self->weigher == NULL) {
+        Py_INCREF(Py_None);
+        Py_INCREF(Py_None);
+        currbytes = maxbytes = Py_None;
+    }
+    else {
+        currbytes = PyLong_FromSsize_t(self->currbytes);
+        maxbytes = PyLong_FromSsize_t(self->maxbytes);
+    }
+    return Py_BuildValue("{snsnsnsnsNsNsN}",
+                         "hits", self->hits,
+                         "misses", self->misses,
+                         "evictions", self->evictions,
+                         "currsize", PyDict_GET_SIZE(self->cache),
+                         "maxsize", maxsize,
+                         "currbytes", currbytes,
+                         "maxbytes", maxbytes);
+}
+
 static PyObject *
 lru_cache_reduce(PyObject *self, PyObject *unused)
 {
@@ -1266,6 +1473,7 @@ lru_cache_tp_traverse(lru_cache_object *self, visitproc visit, void *arg)
     Py_VISIT(self->cache);
     Py_VISIT(self->cache_info_type);
     Py_VISIT(self->dict);
+    Py_VISIT(self->weigher);
     return 0;
 }
 
@@ -1277,6 +1485,7 @@ lru_cache_tp_clear(lru_cache_object *self)
     Py_CLEAR(self->cache);
     Py_CLEAR(self->cache_info_type);
     Py_CLEAR(self->dict);
+    Py_CLEAR(self->weigher);
     lru_cache_clear_list(list);
     return 0;
 }
@@ -1295,12 +1504,22 @@ typed:    False     cache f(3) and f(3.0) as identical calls\n\
           True      cache f(3) and f(3.0) as distinct calls\n\
 \n\
 cache_info_type:    namedtuple class with the fields:\n\
-                        hits misses currsize maxsize\n"
+                        hits misses currsize maxsize\n\
+\n\
+maxbytes: None      for no bound on the size of the results\n\
+          n         evict the least recently used results while the sum\n\
+                    of their weights is above n\n\
+\n\
+weigher:            the weight of a result, sys.getsizeof by default\n\
+\n\
+cache_stats() returns the hits, misses and evictions with the current\n\
+and maximum size and weight.\n"
 );
 
 static PyMethodDef lru_cache_methods[] = {
     {"cache_info", (PyCFunction)lru_cache_cache_info, METH_NOARGS},
     {"cache_clear", (PyCFunction)lru_cache_cache_clear, METH_NOARGS},
+    {"cache_stats", (PyCFunction)lru_cache_cache_stats, METH_NOARGS},
     {"__reduce__", (PyCFunction)lru_cache_reduce, METH_NOARGS},
     {"__copy__", (PyCFunction)lru_cache_copy, METH_VARARGS},
     {"__deepcopy__", (PyCFunction)lru_cache_deepcopy, METH_VARARGS},
@@ -535,6 +535,223 @@ EVP_new(PyObject *self, PyObject *args, PyObject *kwdict)
     return ret_obj;
 }
 
+/* The module-level function: digest_many() */
+
+#define DIGEST_MANY_MAX_THREADS 64
+
+/* Work of one thread of digest_many(): hash the buffers start,
+   start + step, ... and store each digest in a slot of EVP_MAX_MD_SIZE
+   bytes. Runs without the GIL. */
+typedef struct {
+    const EVP_MD *digest;
+    Py_buffer *views;
+    unsigned char *digests;
+    Py_ssize_t count;
+    Py_ssize_t start;
+    Py_ssize_t step;
+    int error;
+    PyThread_type_lock done;
+} digest_many_job;
+
+static void
+digest_many_run(digest_many_job *job)
+{
+    EVP_MD_CTX *initial_ctx, *ctx;
+    Py_ssize_t i, len;
+    const unsigned char *cp;
+    unsigned int process;
+
+    /* Copying an initialized context is cheaper than initializing one
+       for each buffer */
+    initial_ctx = EVP_MD_CTX_new();
+    ctx = EVP_MD_CTX_new();
+    if (initial_ctx == NULL || ctx == NULL ||
+        !EVP_DigestInit_ex(initial_ctx, job->digest, NULL)) {
+        job->error = 1;
+        goto done;
+    }
+    for (i = job->start; i < job->count; i += job->step) {
+        if (!EVP_MD_CTX_copy_ex(ctx, initial_ctx)) {
+            job->error = 1;
+            break;
+        }
+        cp = (const unsigned char *)job->views[i].buf;
+        len = job->views[i].len;
+        while (0 < len) {
+            if (len > (Py_ssize_t)MUNCH_SIZE)
+                process = MUNCH_SIZE;
+            else
+                process = Py_SAFE_DOWNCAST(len, Py_ssize_t, unsigned int);
+            if (!EVP_DigestUpdate(ctx, (const void*)cp, process)) {
+                job->error = 1;
+                break;
+            }
+            len -= process;
+            cp += process;
+        }
+        if (job->error ||
+            !EVP_DigestFinal_ex(ctx, job->digests + i * EVP_MAX_MD_SIZE,
+                                NULL)) {
+            job->error = 1;
+            break;
+        }
+    }
+
+done:
+    EVP_MD_CTX_free(ctx);
+    EVP_MD_CTX_free(initial_ctx);
+}
+
+static void
+digest_many_thread(void *arg)
+{
+    digest_many_job *job = (digest_many_job *)arg;
+
+    digest_many_run(job);
+    PyThread_release_lock(job->done);
+}
+
+/* Hash all the buffers using nthreads threads, the calling thread being
+   one of them. Return -1 if OpenSSL failed. */
+static int
+digest_many_hash(const EVP_MD *digest, Py_buffer *views,
+                 unsigned char *digests, Py_ssize_t count, int nthreads)
+{
+    digest_many_job jobs[DIGEST_MANY_MAX_THREADS];
+    int i, started, error = 0;
+
+    for (i = 0; i < nthreads; i++) {
+        jobs[i].digest = digest;
+        jobs[i].views = views;
+        jobs[i].digests = digests;
+        jobs[i].count = count;
+        jobs[i].start = i;
+        jobs[i].step = nthreads;
+        jobs[i].error = 0;
+        jobs[i].done = NULL;
+    }
+
+    /* Start the helper threads. The shares of the threads which cannot
+       be started are hashed by the calling thread. */
+    for (started = 1; started < nthreads; started++) {
+        jobs[started].done = PyThread_allocate_lock();
+        if (jobs[started].done == NULL)
+            break;
+        PyThread_acquire_lock(jobs[started].done, WAIT_LOCK);
+        if (PyThread_start_new_thread(digest_many_thread, &jobs[started])
+            == PYTHREAD_INVALID_THREAD_ID) {
+            PyThread_release_lock(jobs[started].done);
+            PyThread_free_lock(jobs[started].done);
+            jobs[started].done = NULL;
+            break;
+        }
+    }
+    for (i = started; i < nthreads; i++)
+        digest_many_run(&jobs[i]);
+    digest_many_run(&jobs[0]);
+
+    /* Wait for the helper threads */
+    for (i = 1; i < started; i++) {
+        PyThread_acquire_lock(jobs[i].done, WAIT_LOCK);
+        PyThread_release_lock(jobs[i].done);
+        PyThread_free_lock(jobs[i].done);
+    }
+    for (i = 0; i < nthreads; i++)
+        error |= jobs[i].error;
+    return error ? -1 : 0;
+}
+
+PyDoc_STRVAR(digest_many__doc__,
+"digest_many(name, buffers, threads=1) -> list of digests\n\
+\n\
+Return the digests of a sequence of bytes-like objects with the named\n\
+algorithm. All the buffers are hashed in one pass with the GIL\n\
+released, split across 'threads' threads.");
+
+static PyObject *
+digest_many(PyObject *self, PyObject *args, PyObject *kwdict)
+{
+    static char *kwlist[] = {"name", "buffers", "threads", NULL};
+    char *name;
+    PyObject *buffers_obj, *seq, *result = NULL, *item;
+    Py_buffer *views = NULL;
+    unsigned char *digests = NULL;
+    const EVP_MD *digest;
+    Py_ssize_t i, count, nviews = 0, total = 0;
+    int threads = 1, digest_size, err;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwdict, "sO|i:digest_many",
+                                     kwlist, &name, &buffers_obj, &threads)) {
+        return NULL;
+    }
+
+    digest = EVP_get_digestbyname(name);
+    if (digest == NULL) {
+        PyErr_SetString(PyExc_ValueError, "unsupported hash type");
+        return NULL;
+    }
+    if (threads < 1 || threads > DIGEST_MANY_MAX_THREADS) {
+        PyErr_Format(PyExc_ValueError,
+                     "threads must be in range 1 to %d",
+                     DIGEST_MANY_MAX_THREADS);
+        return NULL;
+    }
+
+    /* a tuple cannot be resized by the buffer exports below */
+    seq = PySequence_Tuple(buffers_obj);
+    if (seq == NULL)
+        return NULL;
+    count = PyTuple_GET_SIZE(seq);
+    views = PyMem_New(Py_buffer, count);
+    digests = PyMem_Malloc(Py_MAX(count, 1) * EVP_MAX_MD_SIZE);
+    if (views == NULL || digests == NULL) {
+        PyErr_NoMemory();
+        goto end;
+    }
+    for (nviews = 0; nviews < count; nviews++) {
+        item = PyTuple_GET_ITEM(seq, nviews);
+        GET_BUFFER_VIEW_OR_ERROR(item, &views[nviews], goto end);
+        total += views[nviews].len;
+    }
+    if (threads > count)
+        threads = (int)Py_MAX(count, 1);
+
+    if (total >= HASHLIB_GIL_MINSIZE) {
+        Py_BEGIN_ALLOW_THREADS
+        err = digest_many_hash(digest, views, digests, count, threads);
+        Py_END_ALLOW_THREADS
+    }
+    else {
+        err = digest_many_hash(digest, views, digests, count, 1);
+    }
+    if (err < 0) {
+        _setException(PyExc_ValueError);
+        goto end;
+    }
+
+    digest_size = EVP_MD_size(digest);
+    result = PyList_New(count);
+    if (result == NULL)
+        goto end;
+    for (i = 0; i < count; i++) {
+        item = PyBytes_FromStringAndSize(
+            (const char *)digests + i * EVP_MAX_MD_SIZE, digest_size);
+        if (item == NULL) {
+            Py_CLEAR(result);
+            goto end;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+
+end:
+    for (i = 0; i < nviews; i++)
+        PyBuffer_Release(&views[i]);
+    PyMem_Free(views);
+    PyMem_Free(digests);
+    Py_DECREF(seq);
+    return result;
+}
+
 #if (OPENSSL_VERSION_NUMBER >= 0x10000000 && !defined(OPENSSL_NO_HMAC) \
      && !defined(OPENSSL_NO_SHA))
 
@@ -1041,6 +1258,8 @@ GEN_CONSTRUCTOR(sha512)
 
 static struct PyMethodDef EVP_functions[] = {
     {"new", (PyCFunction)EVP_new, METH_VARARGS|METH_KEYWORDS, EVP_new__doc__},
+    {"digest_many", (PyCFunction)digest_many, METH_VARARGS|METH_KEYWORDS,
+     digest_many__doc__},
 #ifdef PY_PBKDF2_HMAC
     {"pbkdf2_hmac", (PyCFunction)pbkdf2_hmac, METH_VARARGS|METH_KEYWORDS,
      pbkdf2_hmac__doc__},
@@ -491,6 +491,662 @@ heapify_max(PyObject *self, PyObject *heap)
 
 PyDoc_STRVAR(heapify_max_doc, "Maxheap variant of heapify.");
 
+/* d-ary and keyed heaps.
+
+   The sifting below is shared by the 4-ary heap, whose node k has the
+   children 4*k+1 .. 4*k+4, and the keyed heap, a binary heap of
+   (key, item) tuples ordered by their key only, so that the key is
+   computed once per item and the items themselves are never compared.
+   The arity is 1 << shift. */
+
+static int
+heap_lt(PyObject *a, PyObject *b, int keyed)
+{
+    int cmp;
+
+    if (keyed) {
+        if (!PyTuple_CheckExact(a) || PyTuple_GET_SIZE(a) != 2 ||
+            !PyTuple_CheckExact(b) || PyTuple_GET_SIZE(b) != 2) {
+            PyErr_SetString(PyExc_TypeError,
+                            "keyed heap entries must be (key, item) tuples");
+            return -1;
+        }
+        a = PyTuple_GET_ITEM(a, 0);
+        b = PyTuple_GET_ITEM(b, 0);
+    }
+    Py_INCREF(a);
+    Py_INCREF(b);
+    cmp = PyObject_RichCompareBool(a, b, Py_LT);
+    Py_DECREF(a);
+    Py_DECREF(b);
+    return cmp;
+}
+
+static int
+siftdown_d(PyListObject *heap, Py_ssize_t startpos, Py_ssize_t pos,
+           int shift, int keyed)
+{
+    PyObject *newitem, *parent, **arr;
+    Py_ssize_t parentpos, size;
+    int cmp;
+
+    assert(PyList_Check(heap));
+    size = PyList_GET_SIZE(heap);
+    if (pos >= size) {
+        PyErr_SetString(PyExc_IndexError, "index out of range");
+        return -1;
+    }
+
+    /* Follow the path to the root, moving parents down until finding
+       a place newitem fits. */
+    arr = _PyList_ITEMS(heap);
+    while (pos > startpos) {
+        parentpos = (pos - 1) >> shift;
+        cmp = heap_lt(arr[pos], arr[parentpos], keyed);
+        if (cmp < 0)
+            return -1;
+        if (size != PyList_GET_SIZE(heap)) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "list changed size during iteration");
+            return -1;
+        }
+        if (cmp == 0)
+            break;
+        arr = _PyList_ITEMS(heap);
+        parent = arr[parentpos];
+        newitem = arr[pos];
+        arr[parentpos] = newitem;
+        arr[pos] = parent;
+        pos = parentpos;
+    }
+    return 0;
+}
+
+static int
+siftup_d(PyListObject *heap, Py_ssize_t pos, int shift, int keyed)
+{
+    Py_ssize_t startpos, endpos, childpos, lastpos, i;
+    PyObject *tmp1, *tmp2, **arr;
+    int cmp;
+
+    assert(PyList_Check(heap));
+    endpos = PyList_GET_SIZE(heap);
+    startpos = pos;
+    if (pos >= endpos) {
+        PyErr_SetString(PyExc_IndexError, "index out of range");
+        return -1;
+    }
+
+    /* Bubble up the smallest child until hitting a leaf. */
+    arr = _PyList_ITEMS(heap);
+    while ((childpos = (pos << shift) + 1) < endpos) {
+        lastpos = Py_MIN(childpos + ((Py_ssize_t)1 << shift), endpos);
+        for (i = childpos + 1; i < lastpos; i++) {
+            cmp = heap_lt(arr[i], arr[childpos], keyed);
+            if (cmp < 0)
+                return -1;
+            arr = _PyList_ITEMS(heap);         /* arr may have changed */
+            if (endpos != PyList_GET_SIZE(heap)) {
+                PyErr_SetString(PyExc_RuntimeError,
+                                "list changed size during iteration");
+                return -1;
+            }
+            if (cmp)
+                childpos = i;
+        }
+        /* Move the smallest child up. */
+        tmp1 = arr[childpos];
+        tmp2 = arr[pos];
+        arr[childpos] = tmp2;
+        arr[pos] = tmp1;
+        pos = childpos;
+    }
+    /* Bubble it up to its final resting place (by sifting its parents down). */
+    return siftdown_d(heap, startpos, pos, shift, keyed);
+}
+
+static int
+siftup4(PyListObject *heap, Py_ssize_t pos)
+{
+    return siftup_d(heap, pos, 2, 0);
+}
+
+static int
+siftup_key(PyListObject *heap, Py_ssize_t pos)
+{
+    return siftup_d(heap, pos, 1, 1);
+}
+
+static PyObject *
+heappush4(PyObject *self, PyObject *args)
+{
+    PyObject *heap, *item;
+
+    if (!PyArg_UnpackTuple(args, "_heappush4", 2, 2, &heap, &item))
+        return NULL;
+
+    if (!PyList_Check(heap)) {
+        PyErr_SetString(PyExc_TypeError, "heap argument must be a list");
+        return NULL;
+    }
+
+    if (PyList_Append(heap, item))
+        return NULL;
+
+    if (siftdown_d((PyListObject *)heap, 0, PyList_GET_SIZE(heap)-1, 2, 0))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(heappush4_doc, "4-ary heap variant of heappush.");
+
+static PyObject *
+heappop4(PyObject *self, PyObject *heap)
+{
+    return heappop_internal(heap, siftup4);
+}
+
+PyDoc_STRVAR(heappop4_doc, "4-ary heap variant of heappop.");
+
+static PyObject *
+heapreplace4(PyObject *self, PyObject *args)
+{
+    return heapreplace_internal(args, siftup4);
+}
+
+PyDoc_STRVAR(heapreplace4_doc, "4-ary heap variant of heapreplace.");
+
+static PyObject *
+heapify4(PyObject *self, PyObject *heap)
+{
+    Py_ssize_t i;
+
+    if (!PyList_Check(heap)) {
+        PyErr_SetString(PyExc_TypeError, "heap argument must be a list");
+        return NULL;
+    }
+
+    /* The last node with a child is the parent of the last node */
+    for (i = (PyList_GET_SIZE(heap) - 2) >> 2; i >= 0; i--)
+        if (siftup4((PyListObject *)heap, i))
+            return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(heapify4_doc, "4-ary heap variant of heapify.");
+
+static PyObject *
+heappush_key(PyObject *self, PyObject *args)
+{
+    PyObject *heap, *item, *keyfunc, *key, *entry;
+    int err;
+
+    if (!PyArg_UnpackTuple(args, "_heappush_key", 3, 3, &heap, &item, &keyfunc))
+        return NULL;
+
+    if (!PyList_Check(heap)) {
+        PyErr_SetString(PyExc_TypeError, "heap argument must be a list");
+        return NULL;
+    }
+
+    key = PyObject_CallFunctionObjArgs(keyfunc, item, NULL);
+    if (key == NULL)
+        return NULL;
+    entry = PyTuple_Pack(2, key, item);
+    Py_DECREF(key);
+    if (entry == NULL)
+        return NULL;
+    err = PyList_Append(heap, entry);
+    Py_DECREF(entry);
+    if (err)
+        return NULL;
+
+    if (siftdown_d((PyListObject *)heap, 0, PyList_GET_SIZE(heap)-1, 1, 1))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(heappush_key_doc,
+"_heappush_key(heap, item, key) -> None. Push item onto a keyed heap.\n\
+\n\
+The heap holds (key(item), item) tuples, ordered by key only: items with\n\
+equal keys are never compared.");
+
+static PyObject *
+heappop_key(PyObject *self, PyObject *heap)
+{
+    PyObject *entry, *item;
+
+    entry = heappop_internal(heap, siftup_key);
+    if (entry == NULL)
+        return NULL;
+    if (!PyTuple_CheckExact(entry) || PyTuple_GET_SIZE(entry) != 2) {
+        Py_DECREF(entry);
+        PyErr_SetString(PyExc_TypeError,
+                        "keyed heap entries must be (key, item) tuples");
+        return NULL;
+    }
+    item = PyTuple_GET_ITEM(entry, 1);
+    Py_INCREF(item);
+    Py_DECREF(entry);
+    return item;
+}
+
+PyDoc_STRVAR(heappop_key_doc,
+"Pop the item with the smallest key off a keyed heap.");
+
+static PyObject *
+heapify_key(PyObject *self, PyObject *args)
+{
+    PyObject *heap, *keyfunc, *item, *key, *entry;
+    Py_ssize_t i;
+
+    if (!PyArg_UnpackTuple(args, "_heapify_key", 2, 2, &heap, &keyfunc))
+        return NULL;
+
+    if (!PyList_Check(heap)) {
+        PyErr_SetString(PyExc_TypeError, "heap argument must be a list");
+        return NULL;
+    }
+
+    /* Decorate the items in place; the key function may change the list */
+    for (i = 0; i < PyList_GET_SIZE(heap); i++) {
+        item = PyList_GET_ITEM(heap, i);
+        Py_INCREF(item);
+        key = PyObject_CallFunctionObjArgs(keyfunc, item, NULL);
+        if (key == NULL) {
+            Py_DECREF(item);
+            return NULL;
+        }
+        entry = PyTuple_Pack(2, key, item);
+        Py_DECREF(key);
+        Py_DECREF(item);
+        if (entry == NULL)
+            return NULL;
+        if (i >= PyList_GET_SIZE(heap)) {
+            Py_DECREF(entry);
+            PyErr_SetString(PyExc_RuntimeError,
+                            "list changed size during iteration");
+            return NULL;
+        }
+        if (PyList_SetItem(heap, i, entry) < 0)
+            return NULL;
+    }
+    return heapify_internal(heap, siftup_key);
+}
+
+PyDoc_STRVAR(heapify_key_doc,
+"_heapify_key(heap, key) -> None. Transform a list of items into a keyed heap.\n\
+\n\
+Each item is replaced by a (key(item), item) tuple.");
+
+/* Native k-way merge of sorted iterables, as heapq.merge().
+
+   The merge object keeps one entry per unexhausted input in a binary heap
+   ordered by (key, input order), which makes the merge stable.  Keys are
+   compared like the [key, order] lists of the pure Python version: equal
+   keys, tested with ==, fall back to the input order.
+
+   Like the generator of the pure Python version, the input of a value is
+   only advanced by the call following the one which returned the value, so
+   an error of the input is raised after the value was returned, and ends
+   the merge. */
+
+typedef struct {
+    PyObject *key;              /* key(value), or value without key */
+    PyObject *value;
+    PyObject *it;
+    Py_ssize_t order;
+} mergeentry;
+
+typedef struct {
+    PyObject_HEAD
+    mergeentry *entries;
+    Py_ssize_t allocated;       /* number of entries, and of inputs */
+    Py_ssize_t size;            /* number of entries in the heap */
+    PyObject *keyfunc;
+    int reverse;
+    int started;
+    int running;
+    int advance;                /* the value of the top entry was returned */
+} mergeobject;
+
+static PyTypeObject merge_type;
+
+/* Return 1 if entry a goes before entry b */
+static int
+merge_before(mergeobject *mo, mergeentry *a, mergeentry *b)
+{
+    PyObject *ka = a->key, *kb = b->key;
+    int cmp;
+
+    Py_INCREF(ka);
+    Py_INCREF(kb);
+    cmp = PyObject_RichCompareBool(ka, kb, Py_EQ);
+    if (cmp == 0) {
+        if (mo->reverse)
+            cmp = PyObject_RichCompareBool(kb, ka, Py_LT);
+        else
+            cmp = PyObject_RichCompareBool(ka, kb, Py_LT);
+    }
+    else if (cmp > 0) {
+        cmp = a->order < b->order;
+    }
+    Py_DECREF(ka);
+    Py_DECREF(kb);
+    return cmp;
+}
+
+static int
+merge_siftdown(mergeobject *mo, Py_ssize_t startpos, Py_ssize_t pos)
+{
+    mergeentry *e = mo->entries, tmp;
+    Py_ssize_t parentpos;
+    int cmp;
+
+    while (pos > startpos) {
+        parentpos = (pos - 1) >> 1;
+        cmp = merge_before(mo, &e[pos], &e[parentpos]);
+        if (cmp < 0)
+            return -1;
+        if (cmp == 0)
+            break;
+        tmp = e[parentpos];
+        e[parentpos] = e[pos];
+        e[pos] = tmp;
+        pos = parentpos;
+    }
+    return 0;
+}
+
+static int
+merge_siftup(mergeobject *mo, Py_ssize_t pos)
+{
+    mergeentry *e = mo->entries, tmp;
+    Py_ssize_t startpos = pos, childpos, limit = mo->size >> 1;
+    int cmp;
+
+    /* Bubble up the first child until hitting a leaf. */
+    while (pos < limit) {
+        childpos = 2*pos + 1;
+        if (childpos + 1 < mo->size) {
+            cmp = merge_before(mo, &e[childpos], &e[childpos + 1]);
+            if (cmp < 0)
+                return -1;
+            childpos += ((unsigned)cmp ^ 1);
+        }
+        tmp = e[childpos];
+        e[childpos] = e[pos];
+        e[pos] = tmp;
+        pos = childpos;
+    }
+    return merge_siftdown(mo, startpos, pos);
+}
+
+/* Fetch the next value of the input of entry.  Return 1 on success,
+   0 if the input is exhausted and -1 on error. */
+static int
+merge_fetch(mergeobject *mo, mergeentry *entry)
+{
+    PyObject *value, *key;
+
+    value = PyIter_Next(entry->it);
+    if (value == NULL)
+        return PyErr_Occurred() ? -1 : 0;
+    if (mo->keyfunc != NULL) {
+        key = PyObject_CallFunctionObjArgs(mo->keyfunc, value, NULL);
+        if (key == NULL) {
+            Py_DECREF(value);
+            return -1;
+        }
+    }
+    else {
+        key = value;
+        Py_INCREF(key);
+    }
+    Py_XSETREF(entry->value, value);
+    Py_XSETREF(entry->key, key);
+    return 1;
+}
+
+static void
+merge_clear_entry(mergeentry *entry)
+{
+    Py_CLEAR(entry->key);
+    Py_CLEAR(entry->value);
+    Py_CLEAR(entry->it);
+}
+
+/* Drop the entry at pos, moving the last entry of the heap in its place */
+static void
+merge_remove(mergeobject *mo, Py_ssize_t pos)
+{
+    mergeentry tmp;
+
+    mo->size--;
+    tmp = mo->entries[pos];
+    mo->entries[pos] = mo->entries[mo->size];
+    mo->entries[mo->size] = tmp;
+    merge_clear_entry(&mo->entries[mo->size]);
+}
+
+/* End the merge after an error, as a generator */
+static void
+merge_finish(mergeobject *mo)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < mo->size; i++)
+        merge_clear_entry(&mo->entries[i]);
+    mo->size = 0;
+    mo->advance = 0;
+}
+
+static int
+merge_start(mergeobject *mo)
+{
+    Py_ssize_t i;
+    int r;
+
+    /* The entries are packed at the front of the array as the inputs are
+       primed, then heapified. */
+    mo->size = mo->allocated;
+    for (i = 0; i < mo->size; ) {
+        r = merge_fetch(mo, &mo->entries[i]);
+        if (r < 0)
+            return -1;
+        if (r == 0)
+            merge_remove(mo, i);
+        else
+            i++;
+    }
+    for (i = (mo->size >> 1) - 1; i >= 0; i--)
+        if (merge_siftup(mo, i) < 0)
+            return -1;
+    return 0;
+}
+
+static PyObject *
+merge_next(mergeobject *mo)
+{
+    PyObject *result = NULL;
+    int r;
+
+    if (mo->running) {
+        PyErr_SetString(PyExc_ValueError, "merge already executing");
+        return NULL;
+    }
+    mo->running = 1;
+    if (!mo->started) {
+        mo->started = 1;
+        if (merge_start(mo) < 0) {
+            merge_finish(mo);
+            goto done;
+        }
+    }
+    else if (mo->advance) {
+        mo->advance = 0;
+        r = merge_fetch(mo, &mo->entries[0]);
+        if (r == 0)
+            merge_remove(mo, 0);
+        if (r < 0 || (mo->size > 0 && merge_siftup(mo, 0) < 0)) {
+            merge_finish(mo);
+            goto done;
+        }
+    }
+    if (mo->size == 0)
+        goto done;
+
+    result = mo->entries[0].value;
+    Py_INCREF(result);
+    mo->advance = 1;
+
+done:
+    mo->running = 0;
+    return result;
+}
+
+static PyObject *
+merge_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"key", "reverse", NULL};
+    PyObject *keyfunc = Py_None, *empty, *it;
+    int reverse = 0;
+    Py_ssize_t i, n;
+    mergeobject *mo;
+
+    empty = PyTuple_New(0);
+    if (empty == NULL)
+        return NULL;
+    if (!PyArg_ParseTupleAndKeywords(empty, kwds, "|Op:merge", kwlist,
+                                     &keyfunc, &reverse)) {
+        Py_DECREF(empty);
+        return NULL;
+    }
+    Py_DECREF(empty);
+
+    mo = (mergeobject *)type->tp_alloc(type, 0);
+    if (mo == NULL)
+        return NULL;
+    n = PyTuple_GET_SIZE(args);
+    mo->entries = PyMem_New(mergeentry, Py_MAX(n, 1));
+    if (mo->entries == NULL) {
+        Py_DECREF(mo);
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < n; i++) {
+        mo->entries[i].key = NULL;
+        mo->entries[i].value = NULL;
+        mo->entries[i].it = NULL;
+        mo->entries[i].order = i;
+    }
+    mo->allocated = n;
+    mo->size = n;
+    if (keyfunc != Py_None) {
+        Py_INCREF(keyfunc);
+        mo->keyfunc = keyfunc;
+    }
+    mo->reverse = reverse;
+    for (i = 0; i < n; i++) {
+        it = PyObject_GetIter(PyTuple_GET_ITEM(args, i));
+        if (it == NULL) {
+            Py_DECREF(mo);
+            return NULL;
+        }
+        mo->entries[i].it = it;
+    }
+    return (PyObject *)mo;
+}
+
+static void
+merge_dealloc(mergeobject *mo)
+{
+    Py_ssize_t i;
+
+    PyObject_GC_UnTrack(mo);
+    if (mo->entries != NULL) {
+        for (i = 0; i < mo->allocated; i++)
+            merge_clear_entry(&mo->entries[i]);
+        PyMem_Free(mo->entries);
+    }
+    Py_XDECREF(mo->keyfunc);
+    Py_TYPE(mo)->tp_free(mo);
+}
+
+static int
+merge_traverse(mergeobject *mo, visitproc visit, void *arg)
+{
+    Py_ssize_t i;
+
+    if (mo->entries != NULL) {
+        for (i = 0; i < mo->allocated; i++) {
+            Py_VISIT(mo->entries[i].key);
+            Py_VISIT(mo->entries[i].value);
+            Py_VISIT(mo->entries[i].it);
+        }
+    }
+    Py_VISIT(mo->keyfunc);
+    return 0;
+}
+
+PyDoc_STRVAR(merge_doc,
+"merge(*iterables, key=None, reverse=False) --> merge object\n\
+\n\
+Merge multiple sorted inputs into a single sorted output.\n\
+\n\
+Similar to sorted(itertools.chain(*iterables)) but returns an iterator,\n\
+does not pull the data into memory all at once, and assumes that each of\n\
+the input streams is already sorted (smallest to largest).  Items with\n\
+equal keys come out in the order of their inputs.\n\
+\n\
+If *key* is not None, it specifies a function of one argument that is\n\
+used to extract a comparison key from each input element.  If *reverse*\n\
+is true, the inputs must be sorted from largest to smallest.");
+
+static PyTypeObject merge_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_heapq.merge",                     /* tp_name */
+    sizeof(mergeobject),                /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    /* methods */
+    (destructor)merge_dealloc,          /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    0,                                  /* tp_repr */
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash */
+    0,                                  /* tp_call */
+    0,                                  /* tp_str */
+    PyObject_GenericGetAttr,            /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+        Py_TPFLAGS_BASETYPE,            /* tp_flags */
+    merge_doc,                          /* tp_doc */
+    (traverseproc)merge_traverse,       /* tp_traverse */
+    0,                                  /* tp_clear */
+    0,                                  /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    PyObject_SelfIter,                  /* tp_iter */
+    (iternextfunc)merge_next,           /* tp_iternext */
+    0,                                  /* tp_methods */
+    0,                                  /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    merge_new,                          /* tp_new */
+    PyObject_GC_Del,                    /* tp_free */
+};
+
 static PyMethodDef heapq_methods[] = {
     {"heappush",        (PyCFunction)heappush,
         METH_VARARGS,           heappush_doc},
@@ -508,6 +1164,20 @@ static PyMethodDef heapq_methods[] = {
         METH_VARARGS,           heapreplace_max_doc},
     {"_heapify_max",    (PyCFunction)heapify_max,
         METH_O,                 heapify_max_doc},
+    {"_heappush4",      (PyCFunction)heappush4,
+        METH_VARARGS,           heappush4_doc},
+    {"_heappop4",       (PyCFunction)heappop4,
+        METH_O,                 heappop4_doc},
+    {"_heapreplace4",   (PyCFunction)heapreplace4,
+        METH_VARARGS,           heapreplace4_doc},
+    {"_heapify4",       (PyCFunction)heapify4,
+        METH_O,                 heapify4_doc},
+    {"_heappush_key",   (PyCFunction)heappush_key,
+        METH_VARARGS,           heappush_key_doc},
+    {"_heappop_key",    (PyCFunction)heappop_key,
+        METH_O,                 heappop_key_doc},
+    {"_heapify_key",    (PyCFunction)heapify_key,
+        METH_VARARGS,           heapify_key_doc},
     {NULL,              NULL}           /* sentinel */
 };
 
@@ -528,6 +1198,7 @@ item = heap[0]       # smallest item on the heap without popping it\n\
 heapify(x)           # transforms list into a heap, in-place, in linear time\n\
 item = heapreplace(heap, item) # pops and returns smallest item, and adds\n\
                                # new item; the heap size is unchanged\n\
+merge(*iterables)    # iterates over the merged sorted inputs\n\
 \n\
 Our API differs from textbook heap algorithms as follows:\n\
 \n\
@@ -654,9 +1325,13 @@ PyInit__heapq(void)
 {
     PyObject *m, *about;
 
+    if (PyType_Ready(&merge_type) < 0)
+        return NULL;
     m = PyModule_Create(&_heapqmodule);
     if (m == NULL)
         return NULL;
+    Py_INCREF(&merge_type);
+    PyModule_AddObject(m, "merge", (PyObject *)&merge_type);
     about = PyUnicode_DecodeUTF8(__about__, strlen(__about__), NULL);
     PyModule_AddObject(m, "__about__", about);
     return m;
@@ -15,6 +15,16 @@
 #define UNUSED
 #endif
 
+/* The vector instructions used to scan UCS1 strings.  SSE2 is always
+   available on x86-64 and NEON on AArch64, so no runtime check is needed. */
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define JSON_SCAN_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define JSON_SCAN_NEON
+#endif
+
 #define PyScanner_Check(op) PyObject_TypeCheck(op, &PyScannerType)
 #define PyScanner_CheckExact(op) (Py_TYPE(op) == &PyScannerType)
 #define PyEncoder_Check(op) PyObject_TypeCheck(op, &PyEncoderType)
@@ -100,6 +110,8 @@ static void
 scanner_dealloc(PyObject *self);
 static int
 scanner_clear(PyObject *self);
+static int
+incdecoder_clear(PyObject *self);
 static PyObject *
 encoder_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
 static void
@@ -397,6 +409,70 @@ _build_rval_index_tuple(PyObject *rval, Py_ssize_t idx) {
         Py_CLEAR(chunk); \
     }
 
+/* Return the index of the first quote, backslash or (if strict is true)
+   control character in the UCS1 buffer buf between start and len, or len if
+   there is none.  Blocks of characters are tested at a time and the final
+   position is found by the scalar loop. */
+static Py_ssize_t
+find_string_special_ucs1(const Py_UCS1 *buf, Py_ssize_t start, Py_ssize_t len,
+                         int strict)
+{
+    Py_ssize_t i = start;
+#if defined(JSON_SCAN_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1f);
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                 _mm_cmpeq_epi8(v, backslash));
+        if (strict) {
+            /* min(v, 0x1f) == v is an unsigned v <= 0x1f */
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        }
+        if (_mm_movemask_epi8(m) != 0)
+            break;
+    }
+#elif defined(JSON_SCAN_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control = vdupq_n_u8(0x1f);
+
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(buf + i);
+        uint8x16_t m = vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash));
+        if (strict)
+            m = vorrq_u8(m, vcleq_u8(v, control));
+        if (vmaxvq_u8(m) != 0)
+            break;
+    }
+#else
+    /* Test a machine word at a time.  The expressions are only exact in
+       saying whether some byte matches, not which one. */
+#define ONES ((size_t)-1 / 0xFF)
+#define HAS_ZERO(w) (((w) - ONES) & ~(w) & (ONES * 0x80))
+#define HAS_LESS(w, n) (((w) - ONES * (n)) & ~(w) & (ONES * 0x80))
+    for (; i + SIZEOF_SIZE_T <= len; i += SIZEOF_SIZE_T) {
+        size_t w;
+
+        memcpy(&w, buf + i, sizeof(w));
+        if (HAS_ZERO(w ^ (ONES * '"')) || HAS_ZERO(w ^ (ONES * '\\')) ||
+                (strict && HAS_LESS(w, 0x20)))
+            break;
+    }
+#undef ONES
+#undef HAS_ZERO
+#undef HAS_LESS
+#endif
+    for (; i < len; i++) {
+        Py_UCS1 c = buf[i];
+        if (c == '"' || c == '\\' || (strict && c <= 0x1f))
+            break;
+    }
+    return i;
+}
+
 static PyObject *
 scanstring_unicode(PyObject *pystr, Py_ssize_t end, int strict, Py_ssize_t *next_end_ptr)
 {
@@ -431,27 +507,39 @@ scanstring_unicode(PyObject *pystr, Py_ssize_t end, int strict, Py_ssize_t *next
     while (1) {
         /* Find the end of the string or the next escape */
         Py_UCS4 c = 0;
-        for (next = end; next < len; next++) {
-            c = PyUnicode_READ(kind, buf, next);
-            if (c == '"' || c == '\\') {
-                break;
+        if (kind == PyUnicode_1BYTE_KIND) {
+            next = find_string_special_ucs1((const Py_UCS1 *)buf, end, len,
+                                            strict);
+            if (next < len) {
+                c = ((const Py_UCS1 *)buf)[next];
+                if (c <= 0x1f) {
+                    raise_errmsg("Invalid control character at", pystr, next);
+                    goto bail;
+                }
             }
-            else if (strict && c <= 0x1f) {
-                raise_errmsg("Invalid control character at", pystr, next);
-                goto bail;
+        }
+        else {
+            for (next = end; next < len; next++) {
+                c = PyUnicode_READ(kind, buf, next);
+                if (c == '"' || c == '\\') {
+                    break;
+                }
+                else if (strict && c <= 0x1f) {
+                    raise_errmsg("Invalid control character at", pystr, next);
+                    goto bail;
+                }
             }
         }
         if (!(c == '"' || c == '\\')) {
             raise_errmsg("Unterminated string starting at", pystr, begin);
             goto bail;
         }
-        /* Pick up this chunk if it's not zero length */
+        /* Pick up this chunk if it's not zero length.  A substring of an
+           ASCII string is copied without scanning for its maximum
+           character. */
         if (next != end) {
             APPEND_OLD_CHUNK
-                chunk = PyUnicode_FromKindAndData(
-                    kind,
-                    (char*)buf + kind * end,
-                    next - end);
+                chunk = PyUnicode_Substring(pystr, end, next);
             if (chunk == NULL) {
                 goto bail;
             }
@@ -1287,6 +1375,440 @@ PyTypeObject PyScannerType = {
     0,/* PyObject_GC_Del, */              /* tp_free */
 };
 
+/* An incremental decoder is fed chunks of a stream of JSON values (e.g.
+   NDJSON records) and returns each top-level value as soon as it is
+   complete.  The structure of the stream is tracked character by character
+   so that the text of a value is only decoded, by the scanner, once. */
+typedef struct _PyIncrementalDecoderObject {
+    PyObject_HEAD
+    PyObject *scanner;
+    PyObject *chunks;       /* list of the text of the incomplete value */
+    PyObject *pending;      /* bytes of an incomplete UTF-8 sequence or NULL */
+    Py_ssize_t depth;       /* nesting depth of the incomplete value */
+    char in_value;
+    char in_string;
+    char in_escape;
+    char in_scalar;
+} PyIncrementalDecoderObject;
+
+static void
+incdecoder_reset(PyIncrementalDecoderObject *d)
+{
+    Py_CLEAR(d->pending);
+    if (d->chunks != NULL && PyList_GET_SIZE(d->chunks) != 0) {
+        /* Deleting a slice of a list of strings can't fail. */
+        (void)PyList_SetSlice(d->chunks, 0, PyList_GET_SIZE(d->chunks), NULL);
+    }
+    d->depth = 0;
+    d->in_value = 0;
+    d->in_string = 0;
+    d->in_escape = 0;
+    d->in_scalar = 0;
+}
+
+static int
+incdecoder_emit(PyIncrementalDecoderObject *d, PyObject *text,
+                Py_ssize_t start, Py_ssize_t end, PyObject *values)
+{
+    /* Decode the value made up of any incomplete text followed by
+    text[start:end] (if text isn't NULL) and append it to values. */
+    PyScannerObject *s = (PyScannerObject *)d->scanner;
+    PyObject *pystr = NULL;
+    PyObject *rval;
+    Py_ssize_t next_idx = -1;
+    int err;
+
+    if (text != NULL) {
+        pystr = PyUnicode_Substring(text, start, end);
+        if (pystr == NULL)
+            return -1;
+    }
+    if (PyList_GET_SIZE(d->chunks) != 0) {
+        if (pystr != NULL) {
+            err = PyList_Append(d->chunks, pystr);
+            Py_DECREF(pystr);
+            if (err < 0)
+                return -1;
+        }
+        pystr = join_list_unicode(d->chunks);
+        if (pystr == NULL)
+            return -1;
+        (void)PyList_SetSlice(d->chunks, 0, PyList_GET_SIZE(d->chunks), NULL);
+    }
+    if (pystr == NULL)
+        return 0;
+
+    rval = scan_once_unicode(s, pystr, 0, &next_idx);
+    PyDict_Clear(s->memo);
+    if (rval == NULL) {
+        if (PyErr_ExceptionMatches(PyExc_StopIteration)) {
+            PyErr_Clear();
+            raise_errmsg("Expecting value", pystr, 0);
+        }
+        Py_DECREF(pystr);
+        return -1;
+    }
+    if (next_idx != PyUnicode_GET_LENGTH(pystr)) {
+        raise_errmsg("Extra data", pystr, next_idx);
+        Py_DECREF(rval);
+        Py_DECREF(pystr);
+        return -1;
+    }
+    Py_DECREF(pystr);
+    err = PyList_Append(values, rval);
+    Py_DECREF(rval);
+    return err;
+}
+
+static int
+incdecoder_scan(PyIncrementalDecoderObject *d, PyObject *text,
+                PyObject *values)
+{
+    /* Track the structure of text, appending each value that it completes
+    to values and saving the text of any value it leaves incomplete. */
+    Py_ssize_t len = PyUnicode_GET_LENGTH(text);
+    int kind = PyUnicode_KIND(text);
+    const void *buf = PyUnicode_DATA(text);
+    Py_ssize_t start = 0;
+    Py_ssize_t i;
+
+    for (i = 0; i < len; i++) {
+        Py_UCS4 c;
+        Py_ssize_t end = -1;
+
+        if (d->in_string && !d->in_escape && kind == PyUnicode_1BYTE_KIND) {
+            i = find_string_special_ucs1((const Py_UCS1 *)buf, i, len, 0);
+            if (i == len)
+                break;
+        }
+        c = PyUnicode_READ(kind, buf, i);
+
+        if (!d->in_value) {
+            if (IS_WHITESPACE(c))
+                continue;
+            d->in_value = 1;
+            start = i;
+            if (c == '{' || c == '[')
+                d->depth = 1;
+            else if (c == '"')
+                d->in_string = 1;
+            else
+                d->in_scalar = 1;
+            continue;
+        }
+        if (d->in_string) {
+            if (d->in_escape) {
+                d->in_escape = 0;
+            }
+            else if (c == '\\') {
+                d->in_escape = 1;
+            }
+            else if (c == '"') {
+                d->in_string = 0;
+                if (d->depth == 0)
+                    end = i + 1;
+            }
+        }
+        else if (d->in_scalar) {
+            /* A number or constant ends at anything that can't be part of
+            it, which is then scanned again. */
+            if (IS_WHITESPACE(c) || c == '{' || c == '[' || c == '"')
+                end = i--;
+        }
+        else {
+            switch (c) {
+                case '"':
+                    d->in_string = 1;
+                    break;
+                case '{':
+                case '[':
+                    d->depth++;
+                    break;
+                case '}':
+                case ']':
+                    if (--d->depth == 0)
+                        end = i + 1;
+                    break;
+            }
+        }
+
+        if (end >= 0) {
+            if (incdecoder_emit(d, text, start, end, values) < 0)
+                return -1;
+            d->in_value = 0;
+            d->in_scalar = 0;
+        }
+    }
+
+    if (d->in_value && start < len) {
+        PyObject *chunk = PyUnicode_Substring(text, start, len);
+        int err;
+
+        if (chunk == NULL)
+            return -1;
+        err = PyList_Append(d->chunks, chunk);
+        Py_DECREF(chunk);
+        return err;
+    }
+    return 0;
+}
+
+static PyObject *
+incdecoder_decode(PyIncrementalDecoderObject *d, PyObject *chunk)
+{
+    /* Return a chunk as a str, decoding it as UTF-8 if it is bytes-like and
+    saving any incomplete sequence at the end for the next chunk. */
+    Py_buffer view;
+    PyObject *joined = NULL;
+    PyObject *text;
+    const char *data;
+    Py_ssize_t size, consumed;
+
+    if (PyUnicode_Check(chunk)) {
+        if (d->pending != NULL) {
+            PyErr_SetString(PyExc_ValueError,
+                            "str fed after an incomplete UTF-8 sequence");
+            return NULL;
+        }
+        if (PyUnicode_READY(chunk) == -1)
+            return NULL;
+        Py_INCREF(chunk);
+        return chunk;
+    }
+
+    if (PyObject_GetBuffer(chunk, &view, PyBUF_SIMPLE) < 0)
+        return NULL;
+    data = view.buf;
+    size = view.len;
+    if (d->pending != NULL) {
+        Py_ssize_t pending_size = PyBytes_GET_SIZE(d->pending);
+
+        joined = PyBytes_FromStringAndSize(NULL, pending_size + size);
+        if (joined == NULL) {
+            PyBuffer_Release(&view);
+            return NULL;
+        }
+        memcpy(PyBytes_AS_STRING(joined), PyBytes_AS_STRING(d->pending),
+               pending_size);
+        memcpy(PyBytes_AS_STRING(joined) + pending_size, data, size);
+        data = PyBytes_AS_STRING(joined);
+        size += pending_size;
+        Py_CLEAR(d->pending);
+    }
+
+    text = PyUnicode_DecodeUTF8Stateful(data, size, "strict", &consumed);
+    if (text != NULL && consumed < size) {
+        d->pending = PyBytes_FromStringAndSize(data + consumed,
+                                               size - consumed);
+        if (d->pending == NULL)
+            Py_CLEAR(text);
+    }
+    Py_XDECREF(joined);
+    PyBuffer_Release(&view);
+    return text;
+}
+
+PyDoc_STRVAR(incdecoder_feed_doc,
+    "feed(chunk) -> list\n"
+    "\n"
+    "Feed a str or UTF-8 encoded bytes-like chunk of a stream of JSON values\n"
+    "and return a list of the top-level values it completes.  Values may be\n"
+    "separated by whitespace, as in newline delimited JSON.  If the chunk\n"
+    "contains invalid JSON then the decoder is reset and JSONDecodeError is\n"
+    "raised with positions relative to the start of the invalid value."
+);
+
+static PyObject *
+incdecoder_feed(PyObject *self, PyObject *chunk)
+{
+    PyIncrementalDecoderObject *d = (PyIncrementalDecoderObject *)self;
+    PyObject *text;
+    PyObject *values;
+    int err;
+
+    text = incdecoder_decode(d, chunk);
+    if (text == NULL) {
+        incdecoder_reset(d);
+        return NULL;
+    }
+    values = PyList_New(0);
+    if (values == NULL) {
+        Py_DECREF(text);
+        return NULL;
+    }
+    err = incdecoder_scan(d, text, values);
+    Py_DECREF(text);
+    if (err < 0) {
+        incdecoder_reset(d);
+        Py_DECREF(values);
+        return NULL;
+    }
+    return values;
+}
+
+PyDoc_STRVAR(incdecoder_close_doc,
+    "close() -> list\n"
+    "\n"
+    "Signal the end of the stream and return a list of any top-level value\n"
+    "that it completes.  JSONDecodeError is raised if the stream ends with an\n"
+    "incomplete value.  The decoder is reset and may be fed a new stream."
+);
+
+static PyObject *
+incdecoder_close(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyIncrementalDecoderObject *d = (PyIncrementalDecoderObject *)self;
+    PyObject *values;
+
+    values = PyList_New(0);
+    if (values == NULL)
+        return NULL;
+    if (d->pending != NULL) {
+        /* This always raises UnicodeDecodeError. */
+        PyObject *text = PyUnicode_DecodeUTF8(PyBytes_AS_STRING(d->pending),
+                                              PyBytes_GET_SIZE(d->pending),
+                                              "strict");
+        Py_XDECREF(text);
+        goto bail;
+    }
+    if (d->in_value && incdecoder_emit(d, NULL, 0, 0, values) < 0)
+        goto bail;
+    incdecoder_reset(d);
+    return values;
+
+bail:
+    incdecoder_reset(d);
+    Py_DECREF(values);
+    return NULL;
+}
+
+PyDoc_STRVAR(incdecoder_reset_doc,
+    "reset()\n"
+    "\n"
+    "Discard any incomplete value."
+);
+
+static PyObject *
+incdecoder_reset_method(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    incdecoder_reset((PyIncrementalDecoderObject *)self);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef incdecoder_methods[] = {
+    {"feed", (PyCFunction)incdecoder_feed, METH_O, incdecoder_feed_doc},
+    {"close", (PyCFunction)incdecoder_close, METH_NOARGS,
+        incdecoder_close_doc},
+    {"reset", (PyCFunction)incdecoder_reset_method, METH_NOARGS,
+        incdecoder_reset_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyMemberDef incdecoder_members[] = {
+    {"scanner", T_OBJECT, offsetof(PyIncrementalDecoderObject, scanner), READONLY, "scanner"},
+    {NULL}
+};
+
+static void
+incdecoder_dealloc(PyObject *self)
+{
+    PyObject_GC_UnTrack(self);
+    incdecoder_clear(self);
+    Py_TYPE(self)->tp_free(self);
+}
+
+static int
+incdecoder_traverse(PyObject *self, visitproc visit, void *arg)
+{
+    PyIncrementalDecoderObject *d = (PyIncrementalDecoderObject *)self;
+    Py_VISIT(d->scanner);
+    return 0;
+}
+
+static int
+incdecoder_clear(PyObject *self)
+{
+    PyIncrementalDecoderObject *d = (PyIncrementalDecoderObject *)self;
+    Py_CLEAR(d->scanner);
+    Py_CLEAR(d->chunks);
+    Py_CLEAR(d->pending);
+    return 0;
+}
+
+static PyObject *
+incdecoder_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyIncrementalDecoderObject *d;
+    PyObject *ctx;
+    static char *kwlist[] = {"context", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O:make_incremental_decoder", kwlist, &ctx))
+        return NULL;
+
+    d = (PyIncrementalDecoderObject *)type->tp_alloc(type, 0);
+    if (d == NULL)
+        return NULL;
+
+    d->scanner = PyObject_CallFunctionObjArgs((PyObject *)&PyScannerType,
+                                              ctx, NULL);
+    if (d->scanner == NULL)
+        goto bail;
+    d->chunks = PyList_New(0);
+    if (d->chunks == NULL)
+        goto bail;
+
+    return (PyObject *)d;
+
+bail:
+    Py_DECREF(d);
+    return NULL;
+}
+
+PyDoc_STRVAR(incdecoder_doc, "JSON incremental decoder object");
+
+static
+PyTypeObject PyIncrementalDecoderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_json.IncrementalDecoder", /* tp_name */
+    sizeof(PyIncrementalDecoderObject), /* tp_basicsize */
+    0,                    /* tp_itemsize */
+    incdecoder_dealloc,   /* tp_dealloc */
+    0,                    /* tp_print */
+    0,                    /* tp_getattr */
+    0,                    /* tp_setattr */
+    0,                    /* tp_compare */
+    0,                    /* tp_repr */
+    0,                    /* tp_as_number */
+    0,                    /* tp_as_sequence */
+    0,                    /* tp_as_mapping */
+    0,                    /* tp_hash */
+    0,                    /* tp_call */
+    0,                    /* tp_str */
+    0,                    /* tp_getattro */
+    0,                    /* tp_setattro */
+    0,                    /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,   /* tp_flags */
+    incdecoder_doc,       /* tp_doc */
+    incdecoder_traverse,  /* tp_traverse */
+    incdecoder_clear,     /* tp_clear */
+    0,                    /* tp_richcompare */
+    0,                    /* tp_weaklistoffset */
+    0,                    /* tp_iter */
+    0,                    /* tp_iternext */
+    incdecoder_methods,   /* tp_methods */
+    incdecoder_members,   /* tp_members */
+    0,                    /* tp_getset */
+    0,                    /* tp_base */
+    0,                    /* tp_dict */
+    0,                    /* tp_descr_get */
+    0,                    /* tp_descr_set */
+    0,                    /* tp_dictoffset */
+    0,                    /* tp_init */
+    0,                    /* tp_alloc */
+    incdecoder_new,       /* tp_new */
+    0,                    /* tp_free */
+};
+
 static PyObject *
 encoder_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
@@ -1794,6 +2316,515 @@ bail:
     return -1;
 }
 
+/* The output of Encoder.encode(), which is written as UTF-8 (or ASCII if
+   ensure_ascii is set) directly to a single growing buffer rather than
+   being accumulated as a list of str fragments. */
+typedef struct {
+    char *p;                /* the end of the output written so far */
+    int ensure_ascii;
+    _PyBytesWriter writer;
+} _JSONOutput;
+
+static int
+output_write(_JSONOutput *out, const char *data, Py_ssize_t size)
+{
+    char *p = _PyBytesWriter_WriteBytes(&out->writer, out->p, data, size);
+    if (p == NULL)
+        return -1;
+    out->p = p;
+    return 0;
+}
+
+static int
+output_write_unicode(_JSONOutput *out, PyObject *pystr)
+{
+    /* Write a str that is already JSON, e.g. a separator */
+    PyObject *encoded;
+    int rv;
+
+    if (PyUnicode_READY(pystr) == -1)
+        return -1;
+    if (PyUnicode_IS_ASCII(pystr))
+        return output_write(out, (const char *)PyUnicode_1BYTE_DATA(pystr),
+                            PyUnicode_GET_LENGTH(pystr));
+    encoded = PyUnicode_AsEncodedString(pystr, "utf-8", "surrogatepass");
+    if (encoded == NULL)
+        return -1;
+    rv = output_write(out, PyBytes_AS_STRING(encoded),
+                      PyBytes_GET_SIZE(encoded));
+    Py_DECREF(encoded);
+    return rv;
+}
+
+static int
+output_write_string(_JSONOutput *out, PyObject *pystr)
+{
+    /* Write the JSON representation of a str.  This gives the same result
+    as ascii_escape_unicode() or escape_unicode(), UTF-8 encoded.  Lone
+    surrogates are encoded as if by the "surrogatepass" error handler. */
+    Py_ssize_t i;
+    Py_ssize_t input_chars;
+    Py_ssize_t output_size;
+    const void *input;
+    int kind;
+    char *p;
+
+    if (PyUnicode_READY(pystr) == -1)
+        return -1;
+
+    input_chars = PyUnicode_GET_LENGTH(pystr);
+    input = PyUnicode_DATA(pystr);
+    kind = PyUnicode_KIND(pystr);
+
+    /* Compute the output size */
+    for (i = 0, output_size = 2; i < input_chars; i++) {
+        Py_UCS4 c = PyUnicode_READ(kind, input, i);
+        Py_ssize_t d;
+        if (S_CHAR(c)) {
+            d = 1;
+        }
+        else if (c >= 0x7f && !out->ensure_ascii) {
+            d = c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        }
+        else {
+            switch(c) {
+            case '\\': case '"': case '\b': case '\f':
+            case '\n': case '\r': case '\t':
+                d = 2; break;
+            default:
+                d = c >= 0x10000 ? 12 : 6;
+            }
+        }
+        if (output_size > PY_SSIZE_T_MAX - d) {
+            PyErr_SetString(PyExc_OverflowError, "string is too long to escape");
+            return -1;
+        }
+        output_size += d;
+    }
+
+    p = _PyBytesWriter_Prepare(&out->writer, out->p, output_size);
+    if (p == NULL)
+        return -1;
+    *p++ = '"';
+    for (i = 0; i < input_chars; i++) {
+        Py_UCS4 c = PyUnicode_READ(kind, input, i);
+        if (S_CHAR(c)) {
+            *p++ = (char)c;
+        }
+        else if (c >= 0x7f && !out->ensure_ascii) {
+            if (c < 0x80) {
+                *p++ = (char)c;
+            }
+            else if (c < 0x800) {
+                *p++ = (char)(0xc0 | (c >> 6));
+                *p++ = (char)(0x80 | (c & 0x3f));
+            }
+            else if (c < 0x10000) {
+                *p++ = (char)(0xe0 | (c >> 12));
+                *p++ = (char)(0x80 | ((c >> 6) & 0x3f));
+                *p++ = (char)(0x80 | (c & 0x3f));
+            }
+            else {
+                *p++ = (char)(0xf0 | (c >> 18));
+                *p++ = (char)(0x80 | ((c >> 12) & 0x3f));
+                *p++ = (char)(0x80 | ((c >> 6) & 0x3f));
+                *p++ = (char)(0x80 | (c & 0x3f));
+            }
+        }
+        else {
+            p += ascii_escape_unichar(c, (unsigned char *)p, 0);
+        }
+    }
+    *p++ = '"';
+    out->p = p;
+    return 0;
+}
+
+static int
+encoder_write_obj(PyEncoderObject *s, _JSONOutput *out, PyObject *obj);
+
+static int
+encoder_mark(PyEncoderObject *s, PyObject *obj, PyObject **ident_ptr)
+{
+    /* Record that obj is being encoded if circular references are checked */
+    PyObject *ident;
+    int has_key;
+
+    *ident_ptr = NULL;
+    if (s->markers == Py_None)
+        return 0;
+    ident = PyLong_FromVoidPtr(obj);
+    if (ident == NULL)
+        return -1;
+    has_key = PyDict_Contains(s->markers, ident);
+    if (has_key) {
+        if (has_key != -1)
+            PyErr_SetString(PyExc_ValueError, "Circular reference detected");
+        Py_DECREF(ident);
+        return -1;
+    }
+    if (PyDict_SetItem(s->markers, ident, obj)) {
+        Py_DECREF(ident);
+        return -1;
+    }
+    *ident_ptr = ident;
+    return 0;
+}
+
+static int
+encoder_unmark(PyEncoderObject *s, PyObject *ident)
+{
+    int rv = 0;
+
+    if (ident != NULL) {
+        rv = PyDict_DelItem(s->markers, ident);
+        Py_DECREF(ident);
+    }
+    return rv;
+}
+
+static int
+encoder_write_string(PyEncoderObject *s, _JSONOutput *out, PyObject *obj)
+{
+    PyObject *encoded;
+    int rv;
+
+    if (s->fast_encode)
+        return output_write_string(out, obj);
+    encoded = encoder_encode_string(s, obj);
+    if (encoded == NULL)
+        return -1;
+    rv = output_write_unicode(out, encoded);
+    Py_DECREF(encoded);
+    return rv;
+}
+
+static int
+encoder_write_float(PyEncoderObject *s, _JSONOutput *out, PyObject *obj)
+{
+    /* Write the same representation of a PyFloat as encoder_encode_float() */
+    double d = PyFloat_AS_DOUBLE(obj);
+    char *buf;
+    int rv;
+
+    if (!Py_IS_FINITE(d)) {
+        if (!s->allow_nan) {
+            PyErr_SetString(
+                    PyExc_ValueError,
+                    "Out of range float values are not JSON compliant"
+                    );
+            return -1;
+        }
+        if (d > 0)
+            return output_write(out, "Infinity", 8);
+        else if (d < 0)
+            return output_write(out, "-Infinity", 9);
+        else
+            return output_write(out, "NaN", 3);
+    }
+    buf = PyOS_double_to_string(d, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+    if (buf == NULL)
+        return -1;
+    rv = output_write(out, buf, strlen(buf));
+    PyMem_Free(buf);
+    return rv;
+}
+
+static int
+encoder_write_long(_JSONOutput *out, PyObject *obj)
+{
+    /* Write the same representation of a PyLong as PyLong_Type.tp_str */
+    long long value;
+    int overflow;
+    PyObject *encoded;
+    int rv;
+
+    value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+    if (value == -1 && PyErr_Occurred())
+        return -1;
+    if (!overflow) {
+        char buf[24];
+        PyOS_snprintf(buf, sizeof(buf), "%lld", value);
+        return output_write(out, buf, strlen(buf));
+    }
+    encoded = PyLong_Type.tp_str(obj);
+    if (encoded == NULL)
+        return -1;
+    rv = output_write_unicode(out, encoded);
+    Py_DECREF(encoded);
+    return rv;
+}
+
+static int
+encoder_write_key(PyEncoderObject *s, _JSONOutput *out, PyObject *key)
+{
+    /* Write a dict key, which must be of a valid type, as a JSON string */
+    PyObject *kstr;
+    int rv;
+
+    if (PyUnicode_Check(key))
+        return encoder_write_string(s, out, key);
+    if (PyFloat_Check(key)) {
+        kstr = encoder_encode_float(s, key);
+    }
+    else if (key == Py_True || key == Py_False || key == Py_None) {
+        /* This must come before the PyLong_Check because
+           True and False are also 1 and 0.*/
+        kstr = _encoded_const(key);
+    }
+    else {
+        assert(PyLong_Check(key));
+        kstr = PyLong_Type.tp_str(key);
+    }
+    if (kstr == NULL)
+        return -1;
+    rv = encoder_write_string(s, out, kstr);
+    Py_DECREF(kstr);
+    return rv;
+}
+
+static int
+encoder_write_item(PyEncoderObject *s, _JSONOutput *out, PyObject *key,
+                   PyObject *value, Py_ssize_t *idx)
+{
+    /* Write a dict item, preceded by a separator unless it is the first */
+    if (!PyUnicode_Check(key) && !PyFloat_Check(key) && !PyLong_Check(key) &&
+            key != Py_None) {
+        if (s->skipkeys)
+            return 0;
+        PyErr_Format(PyExc_TypeError,
+                     "keys must be str, int, float, bool or None, "
+                     "not %.100s", key->ob_type->tp_name);
+        return -1;
+    }
+    if (*idx && output_write_unicode(out, s->item_separator))
+        return -1;
+    if (encoder_write_key(s, out, key))
+        return -1;
+    if (output_write_unicode(out, s->key_separator))
+        return -1;
+    if (encoder_write_obj(s, out, value))
+        return -1;
+    *idx += 1;
+    return 0;
+}
+
+static int
+encoder_write_dict(PyEncoderObject *s, _JSONOutput *out, PyObject *dct)
+{
+    /* Write Python dict dct as a JSON term */
+    PyObject *ident = NULL;
+    PyObject *items = NULL;
+    Py_ssize_t idx = 0;
+
+    if (PyDict_GET_SIZE(dct) == 0)  /* Fast path */
+        return output_write(out, "{}", 2);
+
+    if (encoder_mark(s, dct, &ident))
+        return -1;
+    if (output_write(out, "{", 1))
+        goto bail;
+
+    if (PyDict_CheckExact(dct) && !s->sort_keys) {
+        /* Iterate the dict directly rather than a list of its items. */
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+
+        while (PyDict_Next(dct, &pos, &key, &value)) {
+            int rv;
+
+            Py_INCREF(key);
+            Py_INCREF(value);
+            rv = encoder_write_item(s, out, key, value, &idx);
+            Py_DECREF(key);
+            Py_DECREF(value);
+            if (rv)
+                goto bail;
+        }
+    }
+    else {
+        Py_ssize_t i;
+
+        items = PyMapping_Items(dct);
+        if (items == NULL)
+            goto bail;
+        if (s->sort_keys && PyList_Sort(items) < 0)
+            goto bail;
+        for (i = 0; i < PyList_GET_SIZE(items); i++) {
+            PyObject *item = PyList_GET_ITEM(items, i);
+            if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 2) {
+                PyErr_SetString(PyExc_ValueError, "items must return 2-tuples");
+                goto bail;
+            }
+            if (encoder_write_item(s, out, PyTuple_GET_ITEM(item, 0),
+                                   PyTuple_GET_ITEM(item, 1), &idx))
+                goto bail;
+        }
+        Py_CLEAR(items);
+    }
+
+    if (output_write(out, "}", 1))
+        goto bail;
+    return encoder_unmark(s, ident);
+
+bail:
+    Py_XDECREF(items);
+    Py_XDECREF(ident);
+    return -1;
+}
+
+static int
+encoder_write_list(PyEncoderObject *s, _JSONOutput *out, PyObject *seq)
+{
+    /* Write Python list or tuple seq as a JSON term */
+    PyObject *ident = NULL;
+    PyObject *s_fast;
+    Py_ssize_t i;
+
+    s_fast = PySequence_Fast(seq, "_iterencode_list needs a sequence");
+    if (s_fast == NULL)
+        return -1;
+    if (PySequence_Fast_GET_SIZE(s_fast) == 0) {
+        Py_DECREF(s_fast);
+        return output_write(out, "[]", 2);
+    }
+
+    if (encoder_mark(s, seq, &ident))
+        goto bail;
+    if (output_write(out, "[", 1))
+        goto bail;
+    for (i = 0; i < PySequence_Fast_GET_SIZE(s_fast); i++) {
+        PyObject *obj = PySequence_Fast_GET_ITEM(s_fast, i);
+        if (i) {
+            if (output_write_unicode(out, s->item_separator))
+                goto bail;
+        }
+        if (encoder_write_obj(s, out, obj))
+            goto bail;
+    }
+    if (output_write(out, "]", 1))
+        goto bail;
+    Py_DECREF(s_fast);
+    return encoder_unmark(s, ident);
+
+bail:
+    Py_XDECREF(ident);
+    Py_DECREF(s_fast);
+    return -1;
+}
+
+static int
+encoder_write_obj(PyEncoderObject *s, _JSONOutput *out, PyObject *obj)
+{
+    /* Write Python object obj as a JSON term.  This follows
+    encoder_listencode_obj() but the exact types are tested first. */
+    PyObject *newobj;
+    PyObject *ident;
+    int rv;
+
+    if (PyUnicode_CheckExact(obj))
+        return encoder_write_string(s, out, obj);
+    else if (PyLong_CheckExact(obj))
+        return encoder_write_long(out, obj);
+    else if (PyFloat_CheckExact(obj))
+        return encoder_write_float(s, out, obj);
+    else if (obj == Py_None)
+        return output_write(out, "null", 4);
+    else if (obj == Py_True)
+        return output_write(out, "true", 4);
+    else if (obj == Py_False)
+        return output_write(out, "false", 5);
+    else if (PyUnicode_Check(obj))
+        return encoder_write_string(s, out, obj);
+    else if (PyLong_Check(obj))
+        return encoder_write_long(out, obj);
+    else if (PyFloat_Check(obj))
+        return encoder_write_float(s, out, obj);
+    else if (PyList_Check(obj) || PyTuple_Check(obj)) {
+        if (Py_EnterRecursiveCall(" while encoding a JSON object"))
+            return -1;
+        rv = encoder_write_list(s, out, obj);
+        Py_LeaveRecursiveCall();
+        return rv;
+    }
+    else if (PyDict_Check(obj)) {
+        if (Py_EnterRecursiveCall(" while encoding a JSON object"))
+            return -1;
+        rv = encoder_write_dict(s, out, obj);
+        Py_LeaveRecursiveCall();
+        return rv;
+    }
+
+    if (encoder_mark(s, obj, &ident))
+        return -1;
+    newobj = PyObject_CallFunctionObjArgs(s->defaultfn, obj, NULL);
+    if (newobj == NULL) {
+        Py_XDECREF(ident);
+        return -1;
+    }
+    if (Py_EnterRecursiveCall(" while encoding a JSON object")) {
+        Py_DECREF(newobj);
+        Py_XDECREF(ident);
+        return -1;
+    }
+    rv = encoder_write_obj(s, out, newobj);
+    Py_LeaveRecursiveCall();
+    Py_DECREF(newobj);
+    if (rv) {
+        Py_XDECREF(ident);
+        return -1;
+    }
+    return encoder_unmark(s, ident);
+}
+
+PyDoc_STRVAR(encoder_encode_doc,
+    "encode(obj, as_bytes=False) -> str or bytes\n"
+    "\n"
+    "Return the JSON representation of obj, written directly to a single\n"
+    "buffer rather than returned as a list of fragments.  If as_bytes is\n"
+    "true then the UTF-8 encoded bytes are returned."
+);
+
+static PyObject *
+encoder_encode(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"obj", "as_bytes", NULL};
+    PyEncoderObject *s = (PyEncoderObject *)self;
+    PyObject *obj;
+    PyObject *result;
+    int as_bytes = 0;
+    _JSONOutput out;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p:encode", kwlist,
+        &obj, &as_bytes))
+        return NULL;
+
+    _PyBytesWriter_Init(&out.writer);
+    out.writer.overallocate = 1;
+    out.ensure_ascii = (s->fast_encode ==
+                        (PyCFunction)py_encode_basestring_ascii);
+    out.p = _PyBytesWriter_Alloc(&out.writer, 0);
+    if (out.p == NULL)
+        return NULL;
+    if (encoder_write_obj(s, &out, obj)) {
+        _PyBytesWriter_Dealloc(&out.writer);
+        return NULL;
+    }
+    result = _PyBytesWriter_Finish(&out.writer, out.p);
+    if (result == NULL || as_bytes)
+        return result;
+    Py_SETREF(result, PyUnicode_DecodeUTF8(PyBytes_AS_STRING(result),
+                                           PyBytes_GET_SIZE(result),
+                                           "surrogatepass"));
+    return result;
+}
+
+static PyMethodDef encoder_methods[] = {
+    {"encode", (PyCFunction)encoder_encode, METH_VARARGS | METH_KEYWORDS,
+        encoder_encode_doc},
+    {NULL, NULL, 0, NULL}
+};
+
 static void
 encoder_dealloc(PyObject *self)
 {
@@ -1865,7 +2896,7 @@ PyTypeObject PyEncoderType = {
     0,                    /* tp_weaklistoffset */
     0,                    /* tp_iter */
     0,                    /* tp_iternext */
-    0,                    /* tp_methods */
+    encoder_methods,      /* tp_methods */
     encoder_members,      /* tp_members */
     0,                    /* tp_getset */
     0,                    /* tp_base */
@@ -1920,6 +2951,8 @@ PyInit__json(void)
         goto fail;
     if (PyType_Ready(&PyEncoderType) < 0)
         goto fail;
+    if (PyType_Ready(&PyIncrementalDecoderType) < 0)
+        goto fail;
     Py_INCREF((PyObject*)&PyScannerType);
     if (PyModule_AddObject(m, "make_scanner", (PyObject*)&PyScannerType) < 0) {
         Py_DECREF((PyObject*)&PyScannerType);
@@ -1930,6 +2963,12 @@ PyInit__json(void)
         Py_DECREF((PyObject*)&PyEncoderType);
         goto fail;
     }
+    Py_INCREF((PyObject*)&PyIncrementalDecoderType);
+    if (PyModule_AddObject(m, "make_incremental_decoder",
+                           (PyObject*)&PyIncrementalDecoderType) < 0) {
+        Py_DECREF((PyObject*)&PyIncrementalDecoderType);
+        goto fail;
+    }
     return m;
   fail:
     Py_DECREF(m);
@@ -599,6 +599,47 @@ Compressor_getstate(Compressor *self, PyObject *noargs)
     return NULL;
 }
 
+/* The multithreaded encoder is part of the stable API since liblzma 5.2.0. */
+#if LZMA_VERSION >= 50020002
+#define HAVE_LZMA_STREAM_ENCODER_MT
+#endif
+
+#ifdef HAVE_LZMA_STREAM_ENCODER_MT
+static int
+Compressor_init_xz_mt(lzma_stream *lzs, int check, uint32_t preset,
+                      PyObject *filterspecs, int threads,
+                      uint64_t block_size)
+{
+    lzma_ret lzret;
+    lzma_mt mt;
+    lzma_filter filters[LZMA_FILTERS_MAX + 1];
+
+    memset(&mt, 0, sizeof(mt));
+    mt.flags = 0;
+    mt.threads = threads ? (uint32_t)threads : lzma_cputhreads();
+    if (mt.threads == 0)
+        mt.threads = 1;
+    mt.block_size = block_size;
+    mt.timeout = 0;
+    mt.check = check;
+    if (filterspecs == Py_None) {
+        mt.preset = preset;
+        mt.filters = NULL;
+    } else {
+        if (parse_filter_chain_spec(filters, filterspecs) == -1)
+            return -1;
+        mt.filters = filters;
+    }
+    lzret = lzma_stream_encoder_mt(lzs, &mt);
+    if (filterspecs != Py_None)
+        free_filter_chain(filters);
+    if (catch_lzma_error(lzret))
+        return -1;
+    else
+        return 0;
+}
+#endif
+
 static int
 Compressor_init_xz(lzma_stream *lzs, int check, uint32_t preset,
                    PyObject *filterspecs)
@@ -698,6 +739,16 @@ _lzma.LZMACompressor.__init__
         have an entry for "id" indicating the ID of the filter, plus
         additional entries for options to the filter.
 
+    *
+
+    threads: int = 1
+        The number of threads to compress with, for FORMAT_XZ.  Zero
+        means one per CPU.
+
+    block_size: unsigned_long_long = 0
+        The size of the uncompressed data of each block, for
+        FORMAT_XZ.  Zero lets liblzma choose from the other settings.
+
 Create a compressor object for compressing data incrementally.
 
 The settings used by the compressor can be specified either as a
@@ -712,18 +763,42 @@ For one-shot compression, use the compress() function instead.
 static int
 Compressor_init(Compressor *self, PyObject *args, PyObject *kwargs)
 {
-    static char *arg_names[] = {"format", "check", "preset", "filters", NULL};
+    static char *arg_names[] = {"format", "check", "preset", "filters",
+                                "threads", "block_size", NULL};
     int format = FORMAT_XZ;
     int check = -1;
     uint32_t preset = LZMA_PRESET_DEFAULT;
     PyObject *preset_obj = Py_None;
     PyObject *filterspecs = Py_None;
+    int threads = 1;
+    unsigned long long block_size = 0;
+    int err;
 
     if (!PyArg_ParseTupleAndKeywords(args, kwargs,
-                                     "|iiOO:LZMACompressor", arg_names,
+                                     "|iiOO$iK:LZMACompressor", arg_names,
                                      &format, &check, &preset_obj,
-                                     &filterspecs))
+                                     &filterspecs, &threads, &block_size))
+        return -1;
+
+    if (threads < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "threads must be non-negative");
+        return -1;
+    }
+    if (format != FORMAT_XZ && (threads != 1 || block_size != 0)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Multithreaded compression is only supported by "
+                        "FORMAT_XZ");
+        return -1;
+    }
+#ifndef HAVE_LZMA_STREAM_ENCODER_MT
+    if (threads != 1 || block_size != 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Multithreaded compression is not supported by "
+                        "this version of liblzma");
         return -1;
+    }
+#endif
 
     if (format != FORMAT_XZ && check != -1 && check != LZMA_CHECK_NONE) {
         PyErr_SetString(PyExc_ValueError,
@@ -757,7 +832,16 @@ Compressor_init(Compressor *self, PyObject *args, PyObject *kwargs)
         case FORMAT_XZ:
             if (check == -1)
                 check = LZMA_CHECK_CRC64;
-            if (Compressor_init_xz(&self->lzs, check, preset, filterspecs) != 0)
+#ifdef HAVE_LZMA_STREAM_ENCODER_MT
+            if (threads != 1 || block_size != 0)
+                err = Compressor_init_xz_mt(&self->lzs, check, preset,
+                                            filterspecs, threads,
+                                            block_size);
+            else
+#endif
+                err = Compressor_init_xz(&self->lzs, check, preset,
+                                         filterspecs);
+            if (err != 0)
                 break;
             return 0;
 
@@ -799,7 +883,8 @@ static PyMethodDef Compressor_methods[] = {
 };
 
 PyDoc_STRVAR(Compressor_doc,
-"LZMACompressor(format=FORMAT_XZ, check=-1, preset=None, filters=None)\n"
+"LZMACompressor(format=FORMAT_XZ, check=-1, preset=None, filters=None,\n"
+"               *, threads=1, block_size=0)\n"
 "\n"
 "Create a compressor object for compressing data incrementally.\n"
 "\n"
@@ -824,6 +909,12 @@ PyDoc_STRVAR(Compressor_doc,
 "have an entry for \"id\" indicating the ID of the filter, plus\n"
 "additional entries for options to the filter.\n"
 "\n"
+"threads specifies the number of threads to compress with, for FORMAT_XZ.\n"
+"Zero means one per CPU. block_size specifies the size of the uncompressed\n"
+"data of each block of the output; zero lets liblzma choose it from the\n"
+"other settings. Either one selects the multithreaded encoder, whose\n"
+"output is split into blocks which can also be decompressed in parallel.\n"
+"\n"
 "For one-shot compression, use the compress() function instead.\n");
 
 static PyTypeObject Compressor_type = {
@@ -116,6 +116,10 @@ enum {
     /* Initial size of the write buffer of Pickler. */
     WRITE_BUF_SIZE = 4096,
 
+    /* Committed frames are batched in the write buffer of Pickler until
+       there is at least this much before being flushed to the file. */
+    WRITE_FLUSH_SIZE = 1024 * 1024,
+
     /* Prefetch size when unpickling (disabled on unpeekable streams) */
     PREFETCH = 8192 * 16,
 
@@ -699,10 +703,31 @@ static PyTypeObject Unpickler_Type;
  A custom hashtable mapping void* to Python ints. This is used by the pickler
  for memoization. Using a custom hashtable rather than PyDict allows us to skip
  a bunch of unnecessary object creation. This makes a huge performance
- difference. */
+ difference.
+
+ The table uses linear probing with robin hood insertion: an entry being
+ inserted takes the place of any entry that is closer to its home slot.  This
+ keeps probe sequences short and in adjacent cache lines, and lets a failed
+ lookup (the common case when pickling an object for the first time) stop as
+ soon as it reaches an entry closer to its home slot than the key would be. */
 
 #define MT_MINSIZE 8
-#define PERTURB_SHIFT 5
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MT_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define MT_PREFETCH(addr) ((void)0)
+#endif
+
+/* Objects are allocated at aligned and often consecutive addresses so these
+   are mixed with a multiplicative hash before being masked. */
+static size_t
+_PyMemoTable_Hash(PyObject *key)
+{
+    size_t hash = (size_t)key * (size_t)0x9E3779B97F4A7C15ULL;
+
+    return hash ^ (hash >> (sizeof(size_t) * 4));
+}
 
 
 static PyMemoTable *
@@ -787,37 +812,78 @@ PyMemoTable_Del(PyMemoTable *self)
 }
 
 /* Since entries cannot be deleted from this hashtable, _PyMemoTable_Lookup()
-   can be considerably simpler than dictobject.c's lookdict(). */
+   can be considerably simpler than dictobject.c's lookdict().  Returns NULL if
+   the key isn't in the table. */
 static PyMemoEntry *
 _PyMemoTable_Lookup(PyMemoTable *self, PyObject *key)
 {
-    size_t i;
-    size_t perturb;
     size_t mask = self->mt_mask;
     PyMemoEntry *table = self->mt_table;
-    PyMemoEntry *entry;
-    Py_hash_t hash = (Py_hash_t)key >> 3;
+    size_t i = _PyMemoTable_Hash(key) & mask;
+    size_t dist;
 
-    i = hash & mask;
-    entry = &table[i];
-    if (entry->me_key == NULL || entry->me_key == key)
-        return entry;
+    for (dist = 0; ; dist++) {
+        PyMemoEntry *entry = &table[i];
 
-    for (perturb = hash; ; perturb >>= PERTURB_SHIFT) {
-        i = (i << 2) + i + perturb + 1;
-        entry = &table[i & mask];
-        if (entry->me_key == NULL || entry->me_key == key)
+        if (entry->me_key == key)
             return entry;
+        if (entry->me_key == NULL)
+            return NULL;
+        /* The key would have displaced this entry when it was inserted. */
+        if (((i - _PyMemoTable_Hash(entry->me_key)) & mask) < dist)
+            return NULL;
+        i = (i + 1) & mask;
     }
     Py_UNREACHABLE();
 }
 
+/* Insert a key that isn't in the table, which must have a free entry. */
+static void
+_PyMemoTable_Insert(PyMemoTable *self, PyObject *key, Py_ssize_t value)
+{
+    size_t mask = self->mt_mask;
+    PyMemoEntry *table = self->mt_table;
+    size_t i = _PyMemoTable_Hash(key) & mask;
+    size_t dist;
+
+    for (dist = 0; ; dist++) {
+        PyMemoEntry *entry = &table[i];
+        size_t entry_dist;
+
+        if (entry->me_key == NULL) {
+            entry->me_key = key;
+            entry->me_value = value;
+            return;
+        }
+        entry_dist = (i - _PyMemoTable_Hash(entry->me_key)) & mask;
+        if (entry_dist < dist) {
+            /* Take the place of the entry and insert that instead. */
+            PyObject *entry_key = entry->me_key;
+            Py_ssize_t entry_value = entry->me_value;
+
+            entry->me_key = key;
+            entry->me_value = value;
+            key = entry_key;
+            value = entry_value;
+            dist = entry_dist;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+/* Start loading the home slot of a key that is about to be looked up. */
+static void
+PyMemoTable_Prefetch(PyMemoTable *self, PyObject *key)
+{
+    MT_PREFETCH(&self->mt_table[_PyMemoTable_Hash(key) & self->mt_mask]);
+}
+
 /* Returns -1 on failure, 0 on success. */
 static int
 _PyMemoTable_ResizeTable(PyMemoTable *self, size_t min_size)
 {
     PyMemoEntry *oldtable = NULL;
-    PyMemoEntry *oldentry, *newentry;
+    PyMemoEntry *oldentry;
     size_t new_size = MT_MINSIZE;
     size_t to_process;
 
@@ -852,12 +918,7 @@ _PyMemoTable_ResizeTable(PyMemoTable *self, size_t min_size)
     for (oldentry = oldtable; to_process > 0; oldentry++) {
         if (oldentry->me_key != NULL) {
             to_process--;
-            /* newentry is a pointer to a chunk of the new
-               mt_table, so we're setting the key:value pair
-               in-place. */
-            newentry = _PyMemoTable_Lookup(self, oldentry->me_key);
-            newentry->me_key = oldentry->me_key;
-            newentry->me_value = oldentry->me_value;
+            _PyMemoTable_Insert(self, oldentry->me_key, oldentry->me_value);
         }
     }
 
@@ -871,7 +932,7 @@ static Py_ssize_t *
 PyMemoTable_Get(PyMemoTable *self, PyObject *key)
 {
     PyMemoEntry *entry = _PyMemoTable_Lookup(self, key);
-    if (entry->me_key == NULL)
+    if (entry == NULL)
         return NULL;
     return &entry->me_value;
 }
@@ -885,13 +946,12 @@ PyMemoTable_Set(PyMemoTable *self, PyObject *key, Py_ssize_t value)
     assert(key != NULL);
 
     entry = _PyMemoTable_Lookup(self, key);
-    if (entry->me_key != NULL) {
+    if (entry != NULL) {
         entry->me_value = value;
         return 0;
     }
     Py_INCREF(key);
-    entry->me_key = key;
-    entry->me_value = value;
+    _PyMemoTable_Insert(self, key, value);
     self->mt_used++;
 
     /* If we added a key, we can safely resize. Otherwise just return!
@@ -913,7 +973,6 @@ PyMemoTable_Set(PyMemoTable *self, PyObject *key, Py_ssize_t value)
 }
 
 #undef MT_MINSIZE
-#undef PERTURB_SHIFT
 
 /*************************************************************************/
 
@@ -1014,14 +1073,15 @@ _Pickler_OpcodeBoundary(PicklerObject *self)
         if(_Pickler_CommitFrame(self)) {
             return -1;
         }
-        /* Flush the content of the committed frame to the underlying
-         * file and reuse the pickler buffer for the next frame so as
+        /* Flush the content of the committed frames to the underlying
+         * file and reuse the pickler buffer for the next frames so as
          * to limit memory usage when dumping large complex objects to
-         * a file.
+         * a file.  Frames are batched so that the file is written in
+         * large chunks rather than once per frame.
          *
          * self->write is NULL when called via dumps.
          */
-        if (self->write != NULL) {
+        if (self->write != NULL && self->output_len >= WRITE_FLUSH_SIZE) {
             if (_Pickler_FlushToFile(self) < 0) {
                 return -1;
             }
@@ -2740,6 +2800,10 @@ batch_list_exact(PicklerObject *self, PyObject *obj)
             return -1;
         while (total < PyList_GET_SIZE(obj)) {
             item = PyList_GET_ITEM(obj, total);
+            if (total + 1 < PyList_GET_SIZE(obj)) {
+                PyMemoTable_Prefetch(self->memo,
+                                     PyList_GET_ITEM(obj, total + 1));
+            }
             if (save(self, item, 0) < 0)
                 return -1;
             total++;
@@ -2993,6 +3057,7 @@ batch_dict_exact(PicklerObject *self, PyObject *obj)
         if (_Pickler_Write(self, &mark_op, 1) < 0)
             return -1;
         while (PyDict_Next(obj, &ppos, &key, &value)) {
+            PyMemoTable_Prefetch(self->memo, value);
             if (save(self, key, 0) < 0)
                 return -1;
             if (save(self, value, 0) < 0)
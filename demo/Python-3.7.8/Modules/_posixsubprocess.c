@@ -47,6 +47,15 @@
 # define FD_DIR "/proc/self/fd"
 #endif
 
+/* vfork() is used when the child can set itself up without allocating
+ * memory: that needs the getdents64-based _close_open_fds_safe() below and a
+ * working pthread_sigmask() to keep signal handlers out of the child. */
+#if defined(__linux__) && defined(HAVE_SYS_SYSCALL_H) && \
+    defined(HAVE_PTHREAD_SIGMASK) && !defined(HAVE_BROKEN_PTHREAD_SIGMASK)
+# include <signal.h>
+# define VFORK_USABLE 1
+#endif
+
 #define POSIX_CALL(call)   do { if ((call) == -1) goto error; } while (0)
 
 
@@ -383,6 +392,42 @@ _close_open_fds_maybe_unsafe(long start_fd, PyObject* py_fds_to_keep)
 #endif  /* else NOT (defined(__linux__) && defined(HAVE_SYS_SYSCALL_H)) */
 
 
+#ifdef VFORK_USABLE
+/* Reset the handlers of the signals which child_sigmask does not block to
+ * SIG_DFL, so that a signal arriving before exec() cannot run a handler of
+ * the parent in the memory shared with it by vfork().
+ *
+ * This function is async signal safe for use between vfork() and exec().
+ */
+static void
+reset_signal_handlers(const sigset_t *child_sigmask)
+{
+    struct sigaction sa, sa_dfl;
+    void *handler;
+    int sig;
+
+    memset(&sa_dfl, 0, sizeof(sa_dfl));
+    sa_dfl.sa_handler = SIG_DFL;
+    for (sig = 1; sig < _NSIG; sig++) {
+        /* Dispositions for SIGKILL and SIGSTOP can't be changed. */
+        if (sig == SIGKILL || sig == SIGSTOP)
+            continue;
+        /* exec() resets the handlers of the signals which stay blocked. */
+        if (sigismember(child_sigmask, sig) == 1)
+            continue;
+        /* The C library may refuse signals it uses internally. */
+        if (sigaction(sig, NULL, &sa) == -1)
+            continue;
+        handler = (sa.sa_flags & SA_SIGINFO) ? (void *)sa.sa_sigaction
+                                              : (void *)sa.sa_handler;
+        if (handler == (void *)SIG_IGN || handler == (void *)SIG_DFL)
+            continue;
+        (void)sigaction(sig, &sa_dfl, NULL);
+    }
+}
+#endif  /* VFORK_USABLE */
+
+
 /*
  * This function is code executed in the child process immediately after fork
  * to set things up and call exec().
@@ -393,6 +438,11 @@ _close_open_fds_maybe_unsafe(long start_fd, PyObject* py_fds_to_keep)
  *
  * This restriction is documented at
  * http://www.opengroup.org/onlinepubs/009695399/functions/fork.html.
+ *
+ * If child_sigmask is not NULL, the child was created by vfork() and shares
+ * the memory of the parent until exec(): it must not write to any memory but
+ * its own stack, so it can neither allocate memory nor call into Python.
+ * All signals are blocked on entry; child_sigmask is the mask to restore.
  */
 static void
 child_exec(char *const exec_array[],
@@ -407,7 +457,8 @@ child_exec(char *const exec_array[],
            int call_setsid,
            PyObject *py_fds_to_keep,
            PyObject *preexec_fn,
-           PyObject *preexec_fn_args_tuple)
+           PyObject *preexec_fn_args_tuple,
+           const void *child_sigmask)
 {
     int i, saved_errno, reached_preexec = 0;
     PyObject *result;
@@ -482,6 +533,14 @@ child_exec(char *const exec_array[],
         POSIX_CALL(setsid());
 #endif
 
+#ifdef VFORK_USABLE
+    if (child_sigmask) {
+        reset_signal_handlers(child_sigmask);
+        if ((errno = pthread_sigmask(SIG_SETMASK, child_sigmask, NULL)))
+            goto error;
+    }
+#endif
+
     reached_preexec = 1;
     if (preexec_fn != Py_None && preexec_fn_args_tuple) {
         /* This is where the user has asked us to deadlock their program. */
@@ -553,6 +612,71 @@ error:
 }
 
 
+/* The fork() itself, kept out of line so that a vfork() child only ever
+ * writes to stack frames below the one of subprocess_fork_exec().  Returns
+ * the pid of the child in the parent. */
+static _Py_NO_INLINE pid_t
+do_fork_exec(char *const exec_array[],
+             char *const argv[],
+             char *const envp[],
+             const char *cwd,
+             int p2cread, int p2cwrite,
+             int c2pread, int c2pwrite,
+             int errread, int errwrite,
+             int errpipe_read, int errpipe_write,
+             int close_fds, int restore_signals,
+             int call_setsid,
+             PyObject *py_fds_to_keep,
+             PyObject *preexec_fn,
+             PyObject *preexec_fn_args_tuple,
+             const void *child_sigmask)
+{
+    pid_t pid;
+
+#ifdef VFORK_USABLE
+    if (child_sigmask) {
+        assert(preexec_fn == Py_None);
+        pid = vfork();
+        if (pid == -1) {
+            /* vfork() can be refused, e.g. with EINVAL in some sandboxes */
+            pid = fork();
+        }
+    }
+    else
+#endif
+    {
+        pid = fork();
+    }
+
+    if (pid != 0)
+        return pid;
+
+    /* Child process */
+    /*
+     * Code from here to _exit() must only use async-signal-safe functions,
+     * listed at `man 7 signal` or
+     * http://www.opengroup.org/onlinepubs/009695399/functions/xsh_chap02_04.html.
+     */
+
+    if (preexec_fn != Py_None) {
+        /* We'll be calling back into Python later so we need to do this.
+         * This call may not be async-signal-safe but neither is calling
+         * back into Python.  The user asked us to use hope as a strategy
+         * to avoid deadlock... */
+        PyOS_AfterFork_Child();
+    }
+
+    child_exec(exec_array, argv, envp, cwd,
+               p2cread, p2cwrite, c2pread, c2pwrite,
+               errread, errwrite, errpipe_read, errpipe_write,
+               close_fds, restore_signals, call_setsid,
+               py_fds_to_keep, preexec_fn, preexec_fn_args_tuple,
+               child_sigmask);
+    _exit(255);
+    return 0;  /* Dead code to avoid a potential compiler warning. */
+}
+
+
 static PyObject *
 subprocess_fork_exec(PyObject* self, PyObject *args)
 {
@@ -572,6 +696,10 @@ subprocess_fork_exec(PyObject* self, PyObject *args)
     Py_ssize_t arg_num;
     int need_after_fork = 0;
     int saved_errno = 0;
+    const void *old_sigmask = NULL;
+#ifdef VFORK_USABLE
+    sigset_t old_sigs;
+#endif
 
     if (!PyArg_ParseTuple(
             args, "OOpO!OOiiiiiiiiiiO:fork_exec",
@@ -683,37 +811,46 @@ subprocess_fork_exec(PyObject* self, PyObject *args)
         need_after_fork = 1;
     }
 
-    pid = fork();
-    if (pid == 0) {
-        /* Child process */
-        /*
-         * Code from here to _exit() must only use async-signal-safe functions,
-         * listed at `man 7 signal` or
-         * http://www.opengroup.org/onlinepubs/009695399/functions/xsh_chap02_04.html.
-         */
-
-        if (preexec_fn != Py_None) {
-            /* We'll be calling back into Python later so we need to do this.
-             * This call may not be async-signal-safe but neither is calling
-             * back into Python.  The user asked us to use hope as a strategy
-             * to avoid deadlock... */
-            PyOS_AfterFork_Child();
+#ifdef VFORK_USABLE
+    /* Without a preexec_fn the child never runs Python code and can share
+     * our memory, see child_exec(). */
+    if (preexec_fn == Py_None) {
+        /* Block all signals so that no handler runs in the child while it
+         * shares memory with us.  The child restores old_sigs before exec. */
+        sigset_t all_sigs;
+
+        sigfillset(&all_sigs);
+        if ((saved_errno = pthread_sigmask(SIG_BLOCK, &all_sigs, &old_sigs))) {
+            errno = saved_errno;
+            PyErr_SetFromErrno(PyExc_OSError);
+            Py_XDECREF(cwd_obj2);
+            goto cleanup;
         }
-
-        child_exec(exec_array, argv, envp, cwd,
-                   p2cread, p2cwrite, c2pread, c2pwrite,
-                   errread, errwrite, errpipe_read, errpipe_write,
-                   close_fds, restore_signals, call_setsid,
-                   py_fds_to_keep, preexec_fn, preexec_fn_args_tuple);
-        _exit(255);
-        return NULL;  /* Dead code to avoid a potential compiler warning. */
+        old_sigmask = &old_sigs;
     }
+#endif
+
+    pid = do_fork_exec(exec_array, argv, envp, cwd,
+                       p2cread, p2cwrite, c2pread, c2pwrite,
+                       errread, errwrite, errpipe_read, errpipe_write,
+                       close_fds, restore_signals, call_setsid,
+                       py_fds_to_keep, preexec_fn, preexec_fn_args_tuple,
+                       old_sigmask);
+
     /* Parent (original) process */
     if (pid == -1) {
         /* Capture errno for the exception. */
         saved_errno = errno;
     }
 
+#ifdef VFORK_USABLE
+    if (old_sigmask) {
+        /* vfork() suspends us until the child called exec() or _exit(), so
+         * the signals can be unblocked now. */
+        (void)pthread_sigmask(SIG_SETMASK, old_sigmask, NULL);
+    }
+#endif
+
     Py_XDECREF(cwd_obj2);
 
     if (need_after_fork)
@@ -767,6 +904,10 @@ Forks a child process, closes parent file descriptors as appropriate in the\n\
 child and dups the few that are needed before calling exec() in the child\n\
 process.\n\
 \n\
+On Linux, vfork() is used instead of fork() when there is no preexec_fn,\n\
+so that the cost of starting the child does not grow with the memory size\n\
+of the parent.\n\
+\n\
 The preexec_fn, if supplied, will be called immediately before exec.\n\
 WARNING: preexec_fn is NOT SAFE if your application uses threads.\n\
          It may trigger infrequent, difficult to debug deadlocks.\n\
@@ -13,16 +13,61 @@ static PyTypeObject PySimpleQueueType;  /* forward decl */
 static PyObject *EmptyError;
 
 
+/* Items are stored in a linked list of fixed-size segments, used as a
+   ring: put() fills the tail segment, get() drains the head segment.
+   Both are O(1) and never move items, unlike a list which has to be
+   compacted as items are consumed. 63 items make a 512-byte segment on
+   64-bit platforms. */
+#define SEGMENT_SIZE 63
+
+typedef struct segment {
+    struct segment *next;
+    PyObject *items[SEGMENT_SIZE];
+} segment;
+
 typedef struct {
     PyObject_HEAD
     PyThread_type_lock lock;
     int locked;
-    PyObject *lst;
-    Py_ssize_t lst_pos;
+    segment *head;              /* first item is head->items[head_index] */
+    segment *tail;              /* next item goes to tail->items[tail_index] */
+    int head_index;
+    int tail_index;
+    Py_ssize_t count;
+    segment *spare;             /* a free segment kept for reuse, or NULL */
     PyObject *weakreflist;
 } simplequeueobject;
 
 
+static segment *
+simplequeue_new_segment(simplequeueobject *self)
+{
+    segment *seg = self->spare;
+
+    if (seg != NULL) {
+        self->spare = NULL;
+    }
+    else {
+        seg = PyMem_Malloc(sizeof(segment));
+        if (seg == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+    }
+    seg->next = NULL;
+    return seg;
+}
+
+static void
+simplequeue_free_segment(simplequeueobject *self, segment *seg)
+{
+    if (self->spare == NULL)
+        self->spare = seg;
+    else
+        PyMem_Free(seg);
+}
+
+
 static void
 simplequeue_dealloc(simplequeueobject *self)
 {
@@ -33,7 +78,18 @@ simplequeue_dealloc(simplequeueobject *self)
             PyThread_release_lock(self->lock);
         PyThread_free_lock(self->lock);
     }
-    Py_XDECREF(self->lst);
+    while (self->head != NULL) {
+        segment *seg = self->head;
+        int i, n;
+
+        n = (seg == self->tail) ? self->tail_index : SEGMENT_SIZE;
+        for (i = self->head_index; i < n; i++)
+            Py_DECREF(seg->items[i]);
+        self->head = seg->next;
+        self->head_index = 0;
+        PyMem_Free(seg);
+    }
+    PyMem_Free(self->spare);
     if (self->weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject *) self);
     Py_TYPE(self)->tp_free(self);
@@ -42,7 +98,16 @@ simplequeue_dealloc(simplequeueobject *self)
 static int
 simplequeue_traverse(simplequeueobject *self, visitproc visit, void *arg)
 {
-    Py_VISIT(self->lst);
+    segment *seg;
+    int i, n;
+
+    i = self->head_index;
+    for (seg = self->head; seg != NULL; seg = seg->next) {
+        n = (seg == self->tail) ? self->tail_index : SEGMENT_SIZE;
+        for (; i < n; i++)
+            Py_VISIT(seg->items[i]);
+        i = 0;
+    }
     return 0;
 }
 
@@ -62,15 +127,16 @@ simplequeue_new_impl(PyTypeObject *type)
     self = (simplequeueobject *) type->tp_alloc(type, 0);
     if (self != NULL) {
         self->weakreflist = NULL;
-        self->lst = PyList_New(0);
+        self->head = self->tail = simplequeue_new_segment(self);
+        self->head_index = self->tail_index = 0;
+        self->count = 0;
         self->lock = PyThread_allocate_lock();
-        self->lst_pos = 0;
         if (self->lock == NULL) {
             Py_DECREF(self);
             PyErr_SetString(PyExc_MemoryError, "can't allocate lock");
             return NULL;
         }
-        if (self->lst == NULL) {
+        if (self->head == NULL) {
             Py_DECREF(self);
             return NULL;
         }
@@ -98,8 +164,17 @@ _queue_SimpleQueue_put_impl(simplequeueobject *self, PyObject *item,
 /*[clinic end generated code: output=4333136e88f90d8b input=6e601fa707a782d5]*/
 {
     /* BEGIN GIL-protected critical section */
-    if (PyList_Append(self->lst, item) < 0)
-        return NULL;
+    if (self->tail_index == SEGMENT_SIZE) {
+        segment *seg = simplequeue_new_segment(self);
+        if (seg == NULL)
+            return NULL;
+        self->tail->next = seg;
+        self->tail = seg;
+        self->tail_index = 0;
+    }
+    Py_INCREF(item);
+    self->tail->items[self->tail_index++] = item;
+    self->count++;
     if (self->locked) {
         /* A get() may be waiting, wake it up */
         self->locked = 0;
@@ -130,26 +205,21 @@ _queue_SimpleQueue_put_nowait_impl(simplequeueobject *self, PyObject *item)
 static PyObject *
 simplequeue_pop_item(simplequeueobject *self)
 {
-    Py_ssize_t count, n;
     PyObject *item;
 
-    n = PyList_GET_SIZE(self->lst);
-    assert(self->lst_pos < n);
-
-    item = PyList_GET_ITEM(self->lst, self->lst_pos);
-    Py_INCREF(Py_None);
-    PyList_SET_ITEM(self->lst, self->lst_pos, Py_None);
-    self->lst_pos += 1;
-    count = n - self->lst_pos;
-    if (self->lst_pos > count) {
-        /* The list is more than 50% empty, reclaim space at the beginning */
-        if (PyList_SetSlice(self->lst, 0, self->lst_pos, NULL)) {
-            /* Undo pop */
-            self->lst_pos -= 1;
-            PyList_SET_ITEM(self->lst, self->lst_pos, item);
-            return NULL;
-        }
-        self->lst_pos = 0;
+    assert(self->count > 0);
+    item = self->head->items[self->head_index++];
+    self->count--;
+    if (self->count == 0) {
+        /* Empty: restart from the beginning of the (single) segment */
+        assert(self->head == self->tail);
+        self->head_index = self->tail_index = 0;
+    }
+    else if (self->head_index == SEGMENT_SIZE) {
+        segment *seg = self->head;
+        self->head = seg->next;
+        self->head_index = 0;
+        simplequeue_free_segment(self, seg);
     }
     return item;
 }
@@ -214,7 +284,7 @@ _queue_SimpleQueue_get_impl(simplequeueobject *self, int block,
      * So we simply try to acquire the lock in a loop, until the condition
      * (queue non-empty) becomes true.
      */
-    while (self->lst_pos == PyList_GET_SIZE(self->lst)) {
+    while (self->count == 0) {
         /* First a simple non-blocking try without releasing the GIL */
         r = PyThread_acquire_lock_timed(self->lock, 0, 0);
         if (r == PY_LOCK_FAILURE && microseconds != 0) {
@@ -238,7 +308,6 @@ _queue_SimpleQueue_get_impl(simplequeueobject *self, int block,
         }
     }
     /* BEGIN GIL-protected critical section */
-    assert(self->lst_pos < PyList_GET_SIZE(self->lst));
     item = simplequeue_pop_item(self);
     if (self->locked) {
         PyThread_release_lock(self->lock);
@@ -275,7 +344,7 @@ static int
 _queue_SimpleQueue_empty_impl(simplequeueobject *self)
 /*[clinic end generated code: output=1a02a1b87c0ef838 input=1a98431c45fd66f9]*/
 {
-    return self->lst_pos == PyList_GET_SIZE(self->lst);
+    return self->count == 0;
 }
 
 /*[clinic input]
@@ -288,7 +357,7 @@ static Py_ssize_t
 _queue_SimpleQueue_qsize_impl(simplequeueobject *self)
 /*[clinic end generated code: output=f9dcd9d0a90e121e input=7a74852b407868a1]*/
 {
-    return PyList_GET_SIZE(self->lst) - self->lst_pos;
+    return self->count;
 }
 
 
@@ -431,6 +431,121 @@ random_getrandbits(RandomObject *self, PyObject *args)
     return result;
 }
 
+/* Get a writable C-contiguous buffer of obj and return the format
+   character of its items, skipping a native byte order prefix. Return 0
+   if the format is anything else and -1 on error. */
+static int
+get_item_buffer(PyObject *obj, Py_buffer *view)
+{
+    const char *format;
+
+    if (PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE |
+                                      PyBUF_FORMAT) < 0)
+        return -1;
+    format = view->format;
+    if (format == NULL)
+        return 'B';
+    if (*format == '@')
+        format++;
+    if (format[0] == '\0' || format[1] != '\0')
+        return 0;
+    return (unsigned char)format[0];
+}
+
+static PyObject *
+random_random_into(RandomObject *self, PyObject *args)
+{
+    PyObject *obj;
+    Py_buffer view;
+    double *p;
+    Py_ssize_t i, n;
+    uint32_t a, b;
+    int code;
+
+    if (!PyArg_ParseTuple(args, "O:random_into", &obj))
+        return NULL;
+    code = get_item_buffer(obj, &view);
+    if (code < 0)
+        return NULL;
+    if (code != 'd' || view.itemsize != sizeof(double)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "random_into() requires a buffer of doubles "
+                        "(format 'd')");
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    /* The same numbers as len(buffer) calls of random() */
+    p = (double *)view.buf;
+    n = view.len / sizeof(double);
+    for (i = 0; i < n; i++) {
+        a = genrand_int32(self) >> 5;
+        b = genrand_int32(self) >> 6;
+        p[i] = (a*67108864.0+b)*(1.0/9007199254740992.0);
+    }
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+random_getrandbits_into(RandomObject *self, PyObject *args)
+{
+    PyObject *obj;
+    Py_buffer view;
+    Py_ssize_t i, n;
+    uint64_t r;
+    int k, code;
+
+    if (!PyArg_ParseTuple(args, "Oi:getrandbits_into", &obj, &k))
+        return NULL;
+    code = get_item_buffer(obj, &view);
+    if (code < 0)
+        return NULL;
+    if (code == 0 || strchr("BHILQN", code) == NULL ||
+        (view.itemsize != 1 && view.itemsize != 2 &&
+         view.itemsize != 4 && view.itemsize != 8)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "getrandbits_into() requires a buffer of unsigned "
+                        "integers");
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    if (k <= 0 || k > view.itemsize * 8) {
+        PyErr_Format(PyExc_ValueError,
+                     "number of bits must be in range 1 to %d",
+                     (int)view.itemsize * 8);
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    /* The same numbers as len(buffer) calls of getrandbits(k) */
+    n = view.len / view.itemsize;
+    for (i = 0; i < n; i++) {
+        if (k <= 32)
+            r = genrand_int32(self) >> (32 - k);
+        else {
+            r = genrand_int32(self);
+            r |= (uint64_t)(genrand_int32(self) >> (64 - k)) << 32;
+        }
+        switch (view.itemsize) {
+        case 1:
+            ((uint8_t *)view.buf)[i] = (uint8_t)r;
+            break;
+        case 2:
+            ((uint16_t *)view.buf)[i] = (uint16_t)r;
+            break;
+        case 4:
+            ((uint32_t *)view.buf)[i] = (uint32_t)r;
+            break;
+        default:
+            ((uint64_t *)view.buf)[i] = r;
+            break;
+        }
+    }
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 random_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
@@ -464,6 +579,12 @@ static PyMethodDef random_methods[] = {
     {"getrandbits",     (PyCFunction)random_getrandbits,  METH_VARARGS,
         PyDoc_STR("getrandbits(k) -> x.  Generates an int with "
                   "k random bits.")},
+    {"random_into",     (PyCFunction)random_random_into,  METH_VARARGS,
+        PyDoc_STR("random_into(buffer) -> None.  Fills a writable buffer "
+                  "of doubles with random().")},
+    {"getrandbits_into", (PyCFunction)random_getrandbits_into,  METH_VARARGS,
+        PyDoc_STR("getrandbits_into(buffer, k) -> None.  Fills a writable "
+                  "buffer of unsigned ints with getrandbits(k).")},
     {NULL,              NULL}           /* sentinel */
 };
 
@@ -0,0 +1,961 @@
+/* Statistical (sampling) profiler.
+
+   A helper thread wakes up at a fixed frequency, takes the GIL and walks
+   the frame stack of every Python thread.  Each stack is recorded in a
+   trie keyed by code object, so a sample only costs one hash table lookup
+   per frame and the profiled code runs undisturbed between two samples.
+   The trie can be exported as collapsed stacks (as used by flamegraph.pl)
+   or as an uncompressed pprof protocol buffer. */
+
+#include "Python.h"
+#include "frameobject.h"
+#include "pythread.h"
+#include "hashtable.h"
+
+#ifdef HAVE_SIGNAL_H
+#  include <signal.h>
+#endif
+
+/* Deeper stacks keep their innermost frames only */
+#define SAMPLER_MAX_DEPTH 256
+
+/* Default sampling frequency in Hz */
+#define SAMPLER_DEFAULT_HZ 100.0
+
+/* A node of the stack trie.  Node 0 is the root and has no code object;
+   the parent of a node always has a smaller index. */
+typedef struct {
+    Py_ssize_t parent;
+    PyObject *code;         /* strong reference */
+    Py_ssize_t count;       /* samples whose innermost frame is this node */
+} sampler_node_t;
+
+/* Key of the children hash table: (parent node, code object) */
+typedef struct {
+    Py_ssize_t parent;
+    PyObject *code;
+} sampler_key_t;
+
+typedef struct {
+    PyObject_HEAD
+    int enabled;
+    int all_threads;
+    _PyTime_t interval;             /* nanoseconds */
+    unsigned long thread_id;        /* thread sampled if !all_threads */
+    PyInterpreterState *interp;
+    PyThreadState *tstate;          /* thread state of the helper thread */
+    PyThread_type_lock cancel_event;
+    PyThread_type_lock running;
+
+    sampler_node_t *nodes;
+    Py_ssize_t nnodes;
+    Py_ssize_t allocated;
+    _Py_hashtable_t *children;      /* sampler_key_t => Py_ssize_t */
+
+    Py_ssize_t samples;
+    Py_ssize_t truncated;           /* stacks deeper than SAMPLER_MAX_DEPTH */
+    Py_ssize_t dropped;             /* samples lost to memory errors */
+    _PyTime_t start_time;           /* system clock at the first enable() */
+    _PyTime_t duration;             /* time spent enabled */
+    _PyTime_t enable_time;          /* monotonic clock at the last enable() */
+} SamplerObject;
+
+static PyTypeObject PySampler_Type;
+
+
+/*** Stack trie ***/
+
+static Py_uhash_t
+hashtable_hash_key(_Py_hashtable_t *ht, const void *pkey)
+{
+    sampler_key_t key;
+    Py_uhash_t hash;
+
+    _Py_HASHTABLE_READ_KEY(ht, pkey, key);
+
+    hash = (Py_uhash_t)_Py_HashPointer(key.code);
+    hash ^= (Py_uhash_t)key.parent * 1000003UL;
+    return hash;
+}
+
+
+static int
+hashtable_compare_key(_Py_hashtable_t *ht, const void *pkey,
+                      const _Py_hashtable_entry_t *entry)
+{
+    sampler_key_t key1, key2;
+
+    _Py_HASHTABLE_READ_KEY(ht, pkey, key1);
+    _Py_HASHTABLE_ENTRY_READ_KEY(ht, entry, key2);
+
+    return (key1.code == key2.code && key1.parent == key2.parent);
+}
+
+
+static int
+sampler_reset(SamplerObject *self)
+{
+    sampler_node_t *nodes;
+
+    nodes = PyMem_New(sampler_node_t, 64);
+    if (nodes == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    nodes[0].parent = -1;
+    nodes[0].code = NULL;
+    nodes[0].count = 0;
+    self->nodes = nodes;
+    self->nnodes = 1;
+    self->allocated = 64;
+    return 0;
+}
+
+
+static void
+sampler_clear_entries(SamplerObject *self)
+{
+    sampler_node_t *nodes = self->nodes;
+    Py_ssize_t i, nnodes = self->nnodes;
+
+    /* detach the trie before releasing the code objects */
+    self->nodes = NULL;
+    self->nnodes = 0;
+    self->allocated = 0;
+    if (self->children != NULL)
+        _Py_hashtable_clear(self->children);
+    self->samples = 0;
+    self->truncated = 0;
+    self->dropped = 0;
+    self->duration = 0;
+    self->start_time = 0;
+
+    if (nodes == NULL)
+        return;
+    for (i = 1; i < nnodes; i++)
+        Py_DECREF(nodes[i].code);
+    PyMem_Free(nodes);
+}
+
+
+/* Return the index of the child of parent for code, creating it if needed.
+   Return -1 on memory error, without setting an exception: this is called
+   from the helper thread. */
+static Py_ssize_t
+sampler_child(SamplerObject *self, Py_ssize_t parent, PyObject *code)
+{
+    sampler_key_t key;
+    Py_ssize_t child;
+
+    key.parent = parent;
+    key.code = code;
+    if (_Py_HASHTABLE_GET(self->children, key, child))
+        return child;
+
+    if (self->nnodes == self->allocated) {
+        sampler_node_t *nodes;
+        Py_ssize_t allocated = self->allocated * 2;
+
+        nodes = PyMem_Resize(self->nodes, sampler_node_t, allocated);
+        if (nodes == NULL)
+            return -1;
+        self->nodes = nodes;
+        self->allocated = allocated;
+    }
+
+    child = self->nnodes;
+    if (_Py_HASHTABLE_SET(self->children, key, child) < 0)
+        return -1;
+    Py_INCREF(code);
+    self->nodes[child].parent = parent;
+    self->nodes[child].code = code;
+    self->nodes[child].count = 0;
+    self->nnodes++;
+    return child;
+}
+
+
+/* Record the stacks of the sampled threads.  Called with the GIL held,
+   so that the frames cannot change under our feet. */
+static void
+sampler_take_sample(SamplerObject *self)
+{
+    PyObject *stack[SAMPLER_MAX_DEPTH];
+    PyThreadState *tstate;
+    PyFrameObject *frame;
+    Py_ssize_t node;
+    int depth;
+
+    if (self->nodes == NULL)
+        return;
+
+    tstate = PyInterpreterState_ThreadHead(self->interp);
+    for (; tstate != NULL; tstate = PyThreadState_Next(tstate)) {
+        if (tstate == self->tstate)
+            continue;
+        if (!self->all_threads && tstate->thread_id != self->thread_id)
+            continue;
+        frame = tstate->frame;
+        if (frame == NULL)
+            continue;
+
+        depth = 0;
+        for (; frame != NULL; frame = frame->f_back) {
+            if (depth == SAMPLER_MAX_DEPTH) {
+                self->truncated++;
+                break;
+            }
+            stack[depth++] = (PyObject *)frame->f_code;
+        }
+
+        node = 0;
+        while (depth > 0) {
+            node = sampler_child(self, node, stack[--depth]);
+            if (node < 0)
+                break;
+        }
+        if (node < 0) {
+            self->dropped++;
+            continue;
+        }
+        self->nodes[node].count++;
+        self->samples++;
+    }
+}
+
+
+/*** Helper thread ***/
+
+static void
+sampler_thread(void *arg)
+{
+    SamplerObject *self = (SamplerObject *)arg;
+    PyThreadState *tstate = self->tstate;
+    PY_TIMEOUT_T timeout_us;
+    PyLockStatus st;
+#if defined(HAVE_PTHREAD_SIGMASK) && !defined(HAVE_BROKEN_PTHREAD_SIGMASK)
+    sigset_t set;
+
+    /* signals must be handled by the profiled threads */
+    sigfillset(&set);
+    pthread_sigmask(SIG_SETMASK, &set, NULL);
+#endif
+
+    tstate->thread_id = PyThread_get_thread_ident();
+    _PyThreadState_Init(tstate);
+
+    timeout_us = _PyTime_AsMicroseconds(self->interval, _PyTime_ROUND_CEILING);
+    do {
+        st = PyThread_acquire_lock_timed(self->cancel_event, timeout_us, 0);
+        if (st == PY_LOCK_ACQUIRED) {
+            PyThread_release_lock(self->cancel_event);
+            break;
+        }
+        /* Timeout => take a sample */
+        assert(st == PY_LOCK_FAILURE);
+
+        /* Unlike PyEval_RestoreThread(), PyEval_AcquireThread() doesn't
+           exit the thread if the interpreter is finalizing: the thread
+           states walked by a sample may already have been freed */
+        PyEval_AcquireThread(tstate);
+        if (_Py_IsFinalizing()) {
+            PyEval_ReleaseThread(tstate);
+            break;
+        }
+        if (self->enabled)
+            sampler_take_sample(self);
+        PyEval_ReleaseThread(tstate);
+    } while (1);
+
+    /* Cancelled, or the interpreter is finalizing */
+    PyThread_release_lock(self->running);
+}
+
+
+static int
+sampler_start(SamplerObject *self)
+{
+    PyThreadState *tstate = PyThreadState_GET();
+
+    if (self->interval <= 0)
+        self->interval = (_PyTime_t)(1e9 / SAMPLER_DEFAULT_HZ);
+    if (self->children == NULL) {
+        self->children = _Py_hashtable_new(sizeof(sampler_key_t),
+                                           sizeof(Py_ssize_t),
+                                           hashtable_hash_key,
+                                           hashtable_compare_key);
+        if (self->children == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+    if (self->nodes == NULL && sampler_reset(self) < 0)
+        return -1;
+
+    if (self->cancel_event == NULL) {
+        self->cancel_event = PyThread_allocate_lock();
+        self->running = PyThread_allocate_lock();
+        if (self->cancel_event == NULL || self->running == NULL) {
+            PyErr_SetString(PyExc_RuntimeError, "could not allocate locks");
+            return -1;
+        }
+        /* The profiled thread always holds the cancel_event lock */
+        PyThread_acquire_lock(self->cancel_event, 1);
+    }
+
+    self->interp = tstate->interp;
+    self->thread_id = tstate->thread_id;
+    self->tstate = _PyThreadState_Prealloc(self->interp);
+    if (self->tstate == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    if (self->start_time == 0)
+        self->start_time = _PyTime_GetSystemClock();
+    self->enable_time = _PyTime_GetMonotonicClock();
+    self->enabled = 1;
+
+    PyThread_acquire_lock(self->running, 1);
+    if (PyThread_start_new_thread(sampler_thread, self)
+        == PYTHREAD_INVALID_THREAD_ID) {
+        PyThread_release_lock(self->running);
+        self->enabled = 0;
+        PyThreadState_Clear(self->tstate);
+        PyThreadState_Delete(self->tstate);
+        self->tstate = NULL;
+        PyErr_SetString(PyExc_RuntimeError, "unable to start sampler thread");
+        return -1;
+    }
+    return 0;
+}
+
+
+static void
+sampler_stop(SamplerObject *self)
+{
+    if (!self->enabled)
+        return;
+    self->enabled = 0;
+    self->duration += _PyTime_GetMonotonicClock() - self->enable_time;
+
+    /* Notify cancellation.  While the interpreter is finalizing, the helper
+       thread may also stop by itself, as soon as it gets the GIL. */
+    PyThread_release_lock(self->cancel_event);
+
+    /* Wait for thread to join: it may be waiting for the GIL */
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->running, 1);
+    Py_END_ALLOW_THREADS
+    PyThread_release_lock(self->running);
+
+    /* The profiled thread should always hold the cancel_event lock */
+    PyThread_acquire_lock(self->cancel_event, 1);
+
+    PyThreadState_Clear(self->tstate);
+    PyThreadState_Delete(self->tstate);
+    self->tstate = NULL;
+}
+
+
+/*** Output ***/
+
+/* Return "name (filename:firstlineno)" for a code object, cached in
+   labels. Return a borrowed reference. */
+static PyObject *
+code_label(PyObject *labels, PyObject *code)
+{
+    PyCodeObject *co = (PyCodeObject *)code;
+    PyObject *label;
+
+    label = PyDict_GetItem(labels, code);
+    if (label != NULL)
+        return label;
+    label = PyUnicode_FromFormat("%U (%U:%i)", co->co_name,
+                                 co->co_filename, co->co_firstlineno);
+    if (label == NULL)
+        return NULL;
+    if (PyDict_SetItem(labels, code, label) < 0) {
+        Py_DECREF(label);
+        return NULL;
+    }
+    Py_DECREF(label);
+    return label;
+}
+
+
+PyDoc_STRVAR(collapsed_doc, "\
+collapsed() -> str\n\
+\n\
+Return the collected stacks in the collapsed format read by\n\
+flamegraph.pl: one line per distinct stack, with the frames\n\
+from the outermost to the innermost joined by ';', followed\n\
+by a space and the number of samples.\n\
+");
+
+static PyObject *
+sampler_collapsed(SamplerObject *self, PyObject *noarg)
+{
+    PyObject *labels = NULL, *lines = NULL, *frames = NULL;
+    PyObject *sep = NULL, *empty = NULL, *result = NULL;
+    PyObject *stack, *line;
+    Py_ssize_t i, node, depth;
+    int err;
+
+    labels = PyDict_New();
+    lines = PyList_New(0);
+    sep = PyUnicode_FromString(";");
+    empty = PyUnicode_FromString("");
+    if (labels == NULL || lines == NULL || sep == NULL || empty == NULL)
+        goto done;
+
+    for (i = 1; i < self->nnodes; i++) {
+        Py_ssize_t count = self->nodes[i].count;
+        if (count == 0)
+            continue;
+
+        depth = 0;
+        for (node = i; node > 0; node = self->nodes[node].parent)
+            depth++;
+        frames = PyList_New(depth);
+        if (frames == NULL)
+            goto done;
+        for (node = i; node > 0; node = self->nodes[node].parent) {
+            PyObject *label = code_label(labels, self->nodes[node].code);
+            if (label == NULL)
+                goto done;
+            Py_INCREF(label);
+            PyList_SET_ITEM(frames, --depth, label);
+        }
+
+        stack = PyUnicode_Join(sep, frames);
+        Py_CLEAR(frames);
+        if (stack == NULL)
+            goto done;
+        line = PyUnicode_FromFormat("%U %zd\n", stack, count);
+        Py_DECREF(stack);
+        if (line == NULL)
+            goto done;
+        err = PyList_Append(lines, line);
+        Py_DECREF(line);
+        if (err < 0)
+            goto done;
+    }
+    result = PyUnicode_Join(empty, lines);
+
+done:
+    Py_XDECREF(frames);
+    Py_XDECREF(labels);
+    Py_XDECREF(lines);
+    Py_XDECREF(sep);
+    Py_XDECREF(empty);
+    return result;
+}
+
+
+/* Minimal protocol buffer writer for the pprof output */
+
+typedef struct {
+    char *buf;
+    Py_ssize_t len;
+    Py_ssize_t allocated;
+} pb_writer_t;
+
+#define PB_VARINT 0
+#define PB_BYTES 2
+
+static int
+pb_reserve(pb_writer_t *w, Py_ssize_t size)
+{
+    if (w->allocated - w->len < size) {
+        Py_ssize_t allocated = Py_MAX(w->allocated * 2, w->len + size);
+        char *buf = PyMem_Realloc(w->buf, allocated);
+        if (buf == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        w->buf = buf;
+        w->allocated = allocated;
+    }
+    return 0;
+}
+
+static int
+pb_varint(pb_writer_t *w, unsigned long long value)
+{
+    if (pb_reserve(w, 10) < 0)
+        return -1;
+    while (value >= 0x80) {
+        w->buf[w->len++] = (char)(value | 0x80);
+        value >>= 7;
+    }
+    w->buf[w->len++] = (char)value;
+    return 0;
+}
+
+static int
+pb_int(pb_writer_t *w, int field, unsigned long long value)
+{
+    if (value == 0)
+        return 0;
+    if (pb_varint(w, (field << 3) | PB_VARINT) < 0)
+        return -1;
+    return pb_varint(w, value);
+}
+
+static int
+pb_bytes(pb_writer_t *w, int field, const char *data, Py_ssize_t size)
+{
+    if (pb_varint(w, (field << 3) | PB_BYTES) < 0
+        || pb_varint(w, size) < 0
+        || pb_reserve(w, size) < 0)
+        return -1;
+    memcpy(w->buf + w->len, data, size);
+    w->len += size;
+    return 0;
+}
+
+/* Write the message built in sub as the field of w, and empty sub */
+static int
+pb_message(pb_writer_t *w, int field, pb_writer_t *sub)
+{
+    int err = pb_bytes(w, field, sub->buf, sub->len);
+    sub->len = 0;
+    return err;
+}
+
+/* Return the index of str in the string table, adding it if needed */
+static Py_ssize_t
+pb_string(PyObject *strings, PyObject *str)
+{
+    PyObject *index;
+    Py_ssize_t n;
+
+    index = PyDict_GetItem(strings, str);
+    if (index != NULL)
+        return PyLong_AsSsize_t(index);
+    n = PyDict_Size(strings);
+    index = PyLong_FromSsize_t(n);
+    if (index == NULL)
+        return -1;
+    if (PyDict_SetItem(strings, str, index) < 0)
+        n = -1;
+    Py_DECREF(index);
+    return n;
+}
+
+static Py_ssize_t
+pb_cstring(PyObject *strings, const char *s)
+{
+    PyObject *str;
+    Py_ssize_t index;
+
+    str = PyUnicode_FromString(s);
+    if (str == NULL)
+        return -1;
+    index = pb_string(strings, str);
+    Py_DECREF(str);
+    return index;
+}
+
+/* Write a ValueType message */
+static int
+pb_value_type(pb_writer_t *w, int field, pb_writer_t *sub, PyObject *strings,
+              const char *type, const char *unit)
+{
+    Py_ssize_t type_index = pb_cstring(strings, type);
+    Py_ssize_t unit_index = pb_cstring(strings, unit);
+
+    if (type_index < 0 || unit_index < 0)
+        return -1;
+    if (pb_int(sub, 1, type_index) < 0 || pb_int(sub, 2, unit_index) < 0)
+        return -1;
+    return pb_message(w, field, sub);
+}
+
+/* Write the Function and Location messages of a code object (they share
+   the same id) and return its id */
+static Py_ssize_t
+pb_function(pb_writer_t *w, pb_writer_t *sub, pb_writer_t *line,
+            PyObject *strings, PyObject *functions, PyObject *code)
+{
+    PyCodeObject *co = (PyCodeObject *)code;
+    PyObject *value;
+    Py_ssize_t id, name, filename;
+
+    value = PyDict_GetItem(functions, code);
+    if (value != NULL)
+        return PyLong_AsSsize_t(value);
+
+    id = PyDict_Size(functions) + 1;
+    value = PyLong_FromSsize_t(id);
+    if (value == NULL)
+        return -1;
+    if (PyDict_SetItem(functions, code, value) < 0) {
+        Py_DECREF(value);
+        return -1;
+    }
+    Py_DECREF(value);
+
+    name = pb_string(strings, co->co_name);
+    filename = pb_string(strings, co->co_filename);
+    if (name < 0 || filename < 0)
+        return -1;
+
+    /* Function: id, name, system_name, filename, start_line */
+    if (pb_int(sub, 1, id) < 0
+        || pb_int(sub, 2, name) < 0
+        || pb_int(sub, 3, name) < 0
+        || pb_int(sub, 4, filename) < 0
+        || pb_int(sub, 5, co->co_firstlineno) < 0
+        || pb_message(w, 5, sub) < 0)
+        return -1;
+
+    /* Location: id, line { function_id, line } */
+    if (pb_int(line, 1, id) < 0
+        || pb_int(line, 2, co->co_firstlineno) < 0
+        || pb_int(sub, 1, id) < 0
+        || pb_message(sub, 4, line) < 0
+        || pb_message(w, 4, sub) < 0)
+        return -1;
+    return id;
+}
+
+static int
+pb_string_table(pb_writer_t *w, PyObject *strings)
+{
+    PyObject *table, *key, *value;
+    Py_ssize_t pos = 0, i, n = PyDict_Size(strings);
+    int err = -1;
+
+    table = PyList_New(n);
+    if (table == NULL)
+        return -1;
+    while (PyDict_Next(strings, &pos, &key, &value)) {
+        i = PyLong_AsSsize_t(value);
+        Py_INCREF(key);
+        PyList_SET_ITEM(table, i, key);
+    }
+    for (i = 0; i < n; i++) {
+        const char *s;
+        Py_ssize_t size;
+
+        s = PyUnicode_AsUTF8AndSize(PyList_GET_ITEM(table, i), &size);
+        if (s == NULL)
+            goto done;
+        if (pb_bytes(w, 6, s, size) < 0)
+            goto done;
+    }
+    err = 0;
+
+done:
+    Py_DECREF(table);
+    return err;
+}
+
+
+PyDoc_STRVAR(pprof_doc, "\
+pprof() -> bytes\n\
+\n\
+Return the collected stacks as an uncompressed profile.proto\n\
+message, as read by the pprof tool. Each sample has two values:\n\
+the number of samples and the estimated wall time in nanoseconds.\n\
+");
+
+static PyObject *
+sampler_pprof(SamplerObject *self, PyObject *noarg)
+{
+    pb_writer_t w = {NULL, 0, 0}, sub = {NULL, 0, 0};
+    pb_writer_t line = {NULL, 0, 0}, ids = {NULL, 0, 0};
+    PyObject *strings = NULL, *functions = NULL, *result = NULL;
+    Py_ssize_t i, node, id;
+    _PyTime_t duration;
+
+    strings = PyDict_New();
+    functions = PyDict_New();
+    if (strings == NULL || functions == NULL)
+        goto done;
+    /* string_table[0] must be the empty string */
+    if (pb_cstring(strings, "") < 0)
+        goto done;
+
+    if (pb_value_type(&w, 1, &sub, strings, "samples", "count") < 0
+        || pb_value_type(&w, 1, &sub, strings, "wall", "nanoseconds") < 0
+        || pb_value_type(&w, 11, &sub, strings, "wall", "nanoseconds") < 0
+        || pb_int(&w, 12, self->interval) < 0)
+        goto done;
+
+    duration = self->duration;
+    if (self->enabled)
+        duration += _PyTime_GetMonotonicClock() - self->enable_time;
+    if (pb_int(&w, 9, self->start_time) < 0
+        || pb_int(&w, 10, duration) < 0)
+        goto done;
+
+    for (i = 1; i < self->nnodes; i++) {
+        Py_ssize_t count = self->nodes[i].count;
+        if (count == 0)
+            continue;
+
+        /* location ids are listed from the innermost frame */
+        for (node = i; node > 0; node = self->nodes[node].parent) {
+            id = pb_function(&w, &sub, &line, strings, functions,
+                             self->nodes[node].code);
+            if (id < 0 || pb_varint(&ids, id) < 0)
+                goto done;
+        }
+        /* Sample: packed location_id, packed value */
+        if (pb_message(&sub, 1, &ids) < 0
+            || pb_varint(&ids, count) < 0
+            || pb_varint(&ids, count * self->interval) < 0
+            || pb_message(&sub, 2, &ids) < 0
+            || pb_message(&w, 2, &sub) < 0)
+            goto done;
+    }
+
+    if (pb_string_table(&w, strings) < 0)
+        goto done;
+    result = PyBytes_FromStringAndSize(w.buf, w.len);
+
+done:
+    PyMem_Free(w.buf);
+    PyMem_Free(sub.buf);
+    PyMem_Free(line.buf);
+    PyMem_Free(ids.buf);
+    Py_XDECREF(strings);
+    Py_XDECREF(functions);
+    return result;
+}
+
+
+/*** Profiler type ***/
+
+PyDoc_STRVAR(enable_doc, "\
+enable()\n\
+\n\
+Start sampling the stacks of the profiled threads.\n\
+");
+
+static PyObject*
+sampler_enable(SamplerObject *self, PyObject *noarg)
+{
+    if (self->enabled) {
+        PyErr_SetString(PyExc_RuntimeError, "the profiler is already enabled");
+        return NULL;
+    }
+    if (sampler_start(self) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(disable_doc, "\
+disable()\n\
+\n\
+Stop sampling. Wait until the helper thread exits.\n\
+");
+
+static PyObject*
+sampler_disable(SamplerObject *self, PyObject *noarg)
+{
+    sampler_stop(self);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(clear_doc, "\
+clear()\n\
+\n\
+Clear all samples collected so far.\n\
+");
+
+static PyObject*
+sampler_clear(SamplerObject *self, PyObject *noarg)
+{
+    sampler_clear_entries(self);
+    if (sampler_reset(self) < 0)
+        return NULL;
+    if (self->enabled) {
+        self->start_time = _PyTime_GetSystemClock();
+        self->enable_time = _PyTime_GetMonotonicClock();
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+sampler_get_samples(SamplerObject *self, void *closure)
+{
+    return PyLong_FromSsize_t(self->samples);
+}
+
+static PyObject *
+sampler_get_truncated(SamplerObject *self, void *closure)
+{
+    return PyLong_FromSsize_t(self->truncated);
+}
+
+static PyObject *
+sampler_get_dropped(SamplerObject *self, void *closure)
+{
+    return PyLong_FromSsize_t(self->dropped);
+}
+
+static PyObject *
+sampler_get_interval(SamplerObject *self, void *closure)
+{
+    return PyFloat_FromDouble(_PyTime_AsSecondsDouble(self->interval));
+}
+
+static void
+sampler_dealloc(SamplerObject *self)
+{
+    sampler_stop(self);
+    if (self->enabled || self->tstate != NULL) {
+        /* the helper thread may still use the object: leak it */
+        return;
+    }
+    sampler_clear_entries(self);
+    if (self->children != NULL)
+        _Py_hashtable_destroy(self->children);
+    if (self->cancel_event != NULL) {
+        PyThread_release_lock(self->cancel_event);
+        PyThread_free_lock(self->cancel_event);
+    }
+    if (self->running != NULL)
+        PyThread_free_lock(self->running);
+    Py_TYPE(self)->tp_free(self);
+}
+
+static int
+sampler_init(SamplerObject *self, PyObject *args, PyObject *kw)
+{
+    double hz = SAMPLER_DEFAULT_HZ;
+    int all_threads = 1;
+    static char *kwlist[] = {"hz", "all_threads", 0};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "|dp:Profiler", kwlist,
+                                     &hz, &all_threads))
+        return -1;
+    if (self->enabled) {
+        PyErr_SetString(PyExc_RuntimeError, "the profiler is enabled");
+        return -1;
+    }
+    if (!(hz > 0.0 && hz <= 1e6)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "hz must be in the range (0, 1000000]");
+        return -1;
+    }
+    self->interval = (_PyTime_t)(1e9 / hz);
+    self->all_threads = all_threads;
+    return 0;
+}
+
+static PyMethodDef sampler_methods[] = {
+    {"collapsed",   (PyCFunction)sampler_collapsed,
+                    METH_NOARGS,                        collapsed_doc},
+    {"pprof",       (PyCFunction)sampler_pprof,
+                    METH_NOARGS,                        pprof_doc},
+    {"enable",      (PyCFunction)sampler_enable,
+                    METH_NOARGS,                        enable_doc},
+    {"disable",     (PyCFunction)sampler_disable,
+                    METH_NOARGS,                        disable_doc},
+    {"clear",       (PyCFunction)sampler_clear,
+                    METH_NOARGS,                        clear_doc},
+    {NULL, NULL}
+};
+
+static PyGetSetDef sampler_getset[] = {
+    {"samples", (getter)sampler_get_samples, NULL,
+     "number of stacks recorded"},
+    {"truncated", (getter)sampler_get_truncated, NULL,
+     "number of stacks cut to their innermost frames"},
+    {"dropped", (getter)sampler_get_dropped, NULL,
+     "number of stacks lost to memory errors"},
+    {"interval", (getter)sampler_get_interval, NULL,
+     "sampling interval in seconds"},
+    {NULL}
+};
+
+PyDoc_STRVAR(sampler_doc, "\
+Profiler(hz=100, all_threads=True)\n\
+\n\
+    Builds a statistical profiler which records the stack of the\n\
+    running threads 'hz' times per second of wall time, from a\n\
+    helper thread. If 'all_threads' is false, only the thread which\n\
+    calls enable() is sampled. The helper thread has to wait for\n\
+    the GIL, so the effective frequency is bounded by\n\
+    sys.getswitchinterval().\n\
+");
+
+static PyTypeObject PySampler_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_sampleprof.Profiler",                 /* tp_name */
+    sizeof(SamplerObject),                  /* tp_basicsize */
+    0,                                      /* tp_itemsize */
+    (destructor)sampler_dealloc,            /* tp_dealloc */
+    0,                                      /* tp_print */
+    0,                                      /* tp_getattr */
+    0,                                      /* tp_setattr */
+    0,                                      /* tp_reserved */
+    0,                                      /* tp_repr */
+    0,                                      /* tp_as_number */
+    0,                                      /* tp_as_sequence */
+    0,                                      /* tp_as_mapping */
+    0,                                      /* tp_hash */
+    0,                                      /* tp_call */
+    0,                                      /* tp_str */
+    0,                                      /* tp_getattro */
+    0,                                      /* tp_setattro */
+    0,                                      /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /* tp_flags */
+    sampler_doc,                            /* tp_doc */
+    0,                                      /* tp_traverse */
+    0,                                      /* tp_clear */
+    0,                                      /* tp_richcompare */
+    0,                                      /* tp_weaklistoffset */
+    0,                                      /* tp_iter */
+    0,                                      /* tp_iternext */
+    sampler_methods,                        /* tp_methods */
+    0,                                      /* tp_members */
+    sampler_getset,                         /* tp_getset */
+    0,                                      /* tp_base */
+    0,                                      /* tp_dict */
+    0,                                      /* tp_descr_get */
+    0,                                      /* tp_descr_set */
+    0,                                      /* tp_dictoffset */
+    (initproc)sampler_init,                 /* tp_init */
+    PyType_GenericAlloc,                    /* tp_alloc */
+    PyType_GenericNew,                      /* tp_new */
+    PyObject_Del,                           /* tp_free */
+};
+
+static PyMethodDef moduleMethods[] = {
+    {NULL, NULL}
+};
+
+
+static struct PyModuleDef _sampleprofmodule = {
+    PyModuleDef_HEAD_INIT,
+    "_sampleprof",
+    "Statistical profiler",
+    -1,
+    moduleMethods,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+PyMODINIT_FUNC
+PyInit__sampleprof(void)
+{
+    PyObject *module;
+
+    module = PyModule_Create(&_sampleprofmodule);
+    if (module == NULL)
+        return NULL;
+    if (PyType_Ready(&PySampler_Type) < 0)
+        return NULL;
+    Py_INCREF(&PySampler_Type);
+    PyModule_AddObject(module, "Profiler", (PyObject *)&PySampler_Type);
+    PyModule_AddIntConstant(module, "MAX_DEPTH", SAMPLER_MAX_DEPTH);
+    return module;
+}
@@ -70,6 +70,40 @@ static const char copyright[] =
 #define LOCAL(type) static inline type
 #endif
 
+/* use computed gotos for opcode dispatch in SRE(match) where the
+   compiler supports them; same rules as the interpreter loop */
+#ifdef HAVE_COMPUTED_GOTOS
+#ifndef USE_COMPUTED_GOTOS
+#define USE_COMPUTED_GOTOS 1
+#endif
+#else
+#if defined(USE_COMPUTED_GOTOS) && USE_COMPUTED_GOTOS
+#error "Computed gotos are not supported on this compiler."
+#endif
+#undef USE_COMPUTED_GOTOS
+#define USE_COMPUTED_GOTOS 0
+#endif
+
+/* search prefilter tuning.  below MEMCHR_CUT_OFF characters a plain
+   loop beats memchr; literal prefixes of at least FASTSEARCH_MIN_PREFIX
+   characters are located with a boyer-moore-horspool scan instead of
+   the overlap table; the per-state charset membership table is only
+   built when at least CHARSET_TABLE_MIN characters remain. */
+#define SRE_MEMCHR_CUT_OFF 15
+#define SRE_FASTSEARCH_MIN_PREFIX 8
+#define SRE_CHARSET_TABLE_MIN 256
+
+#if LONG_BIT >= 64
+#define SRE_BLOOM_WIDTH 64
+#else
+#define SRE_BLOOM_WIDTH 32
+#endif
+
+#define SRE_BLOOM_ADD(mask, ch) \
+    ((mask |= (1UL << ((ch) & (SRE_BLOOM_WIDTH - 1)))))
+#define SRE_BLOOM(mask, ch) \
+    ((mask & (1UL << ((ch) & (SRE_BLOOM_WIDTH - 1)))))
+
 /* error codes */
 #define SRE_ERROR_ILLEGAL -1 /* illegal opcode */
 #define SRE_ERROR_STATE -2 /* illegal state */
@@ -182,6 +182,18 @@ static void _PySSLFixErrno(void) {
 # define HAVE_ALPN 0
 #endif
 
+/* Kernel TLS: OpenSSL 3.0 can hand the record layer of the connection over
+ * to the kernel once the handshake has completed, if SSL_OP_ENABLE_KTLS was
+ * set on the context.  SSL_sendfile() then sends a file straight from the
+ * page cache without copying it through user space.
+ */
+#if defined(SSL_OP_ENABLE_KTLS) && (OPENSSL_VERSION_NUMBER >= 0x30000000L) \
+    && !defined(OPENSSL_NO_KTLS)
+# define HAVE_KTLS 1
+#else
+# define HAVE_KTLS 0
+#endif
+
 /* We cannot rely on OPENSSL_NO_NEXTPROTONEG because LibreSSL 2.6.1 dropped
  * NPN support but did not set OPENSSL_NO_NEXTPROTONEG for compatibility
  * reasons. The check for TLSEXT_TYPE_next_proto_neg works with
@@ -264,6 +276,12 @@ static int BIO_up_ref(BIO *b)
     return 1;
 }
 
+static int SSL_SESSION_up_ref(SSL_SESSION *s)
+{
+    CRYPTO_add(&s->references, 1, CRYPTO_LOCK_SSL_SESSION);
+    return 1;
+}
+
 static STACK_OF(X509_OBJECT) *X509_STORE_get0_objects(X509_STORE *store) {
     return store->objs;
 }
@@ -439,6 +457,9 @@ typedef struct {
 #ifdef TLS1_3_VERSION
     int post_handshake_auth;
 #endif
+    int shared_session_cache;
+    /* identifies the context's sessions in the shared cache, never reused */
+    unsigned long long session_cache_id;
 } PySSLContext;
 
 typedef struct {
@@ -459,6 +480,7 @@ typedef struct {
     PyObject *owner; /* Python level "owner" passed to servername callback */
     PyObject *server_hostname;
     _PySSLError err; /* last seen error from various sources */
+    char *session_cache_key; /* key in the shared client session cache */
 } PySSLSocket;
 
 typedef struct {
@@ -896,6 +918,255 @@ _ssl_configure_hostname(PySSLSocket *self, const char* server_hostname)
     return retval;
 }
 
+/* Shared client session cache
+ *
+ * A process-wide, bounded cache of client sessions.  Contexts opt in with
+ * shared_session_cache.  A session is only resumed by a socket of the
+ * context that created it, connecting to the same server name and port
+ * with the same verification settings and CA store: the key is made of the
+ * context's session_cache_id, the server name, the port, the verify mode
+ * and flags, check_hostname and the number of objects of the store.
+ * Sockets whose port is unknown, such as those using a memory BIO, don't
+ * use the cache.
+ *
+ * New sessions are stored from OpenSSL's new-session callback, which may
+ * run without the GIL held, so the cache is protected by its own lock and
+ * allocates with the raw allocator.  Sessions are looked up before the
+ * handshake of client sockets, and those of a context are dropped when it
+ * is deallocated.
+ */
+
+#define PY_SSL_SESSION_CACHE_SIZE 256
+
+typedef struct {
+    char *key;
+    unsigned long long context;  /* session_cache_id of the context */
+    SSL_SESSION *session;
+    unsigned long long last_used;
+} _PySSLSessionCacheEntry;
+
+/* The last session_cache_id given to a context, protected by the GIL */
+static unsigned long long _ssl_session_cache_last_id = 0;
+
+static struct {
+    PyThread_type_lock lock;
+    _PySSLSessionCacheEntry *entries;
+    Py_ssize_t size;
+    Py_ssize_t maxsize;
+    unsigned long long clock;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long stores;
+    unsigned long long evictions;
+} _ssl_session_cache = {NULL, NULL, 0, PY_SSL_SESSION_CACHE_SIZE};
+
+/* The following helpers must be called with the cache lock held. */
+
+static Py_ssize_t
+_session_cache_find(const char *key)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < _ssl_session_cache.size; i++) {
+        if (strcmp(_ssl_session_cache.entries[i].key, key) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void
+_session_cache_remove(Py_ssize_t i)
+{
+    _PySSLSessionCacheEntry *entries = _ssl_session_cache.entries;
+
+    PyMem_RawFree(entries[i].key);
+    SSL_SESSION_free(entries[i].session);
+    entries[i] = entries[--_ssl_session_cache.size];
+}
+
+static void
+_session_cache_evict(void)
+{
+    _PySSLSessionCacheEntry *entries = _ssl_session_cache.entries;
+    Py_ssize_t i, oldest = 0;
+
+    for (i = 1; i < _ssl_session_cache.size; i++) {
+        if (entries[i].last_used < entries[oldest].last_used)
+            oldest = i;
+    }
+    _session_cache_remove(oldest);
+    _ssl_session_cache.evictions++;
+}
+
+/* Drop the sessions of a context; takes the cache lock. */
+static void
+_session_cache_clear_context(unsigned long long context)
+{
+    Py_ssize_t i;
+
+    PyThread_acquire_lock(_ssl_session_cache.lock, WAIT_LOCK);
+    /* backwards, as removing moves the last entry into the hole */
+    for (i = _ssl_session_cache.size - 1; i >= 0; i--) {
+        if (_ssl_session_cache.entries[i].context == context)
+            _session_cache_remove(i);
+    }
+    PyThread_release_lock(_ssl_session_cache.lock);
+}
+
+static int
+_session_cache_usable(SSL_SESSION *session)
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(LIBRESSL_VERSION_NUMBER)
+    if (!SSL_SESSION_is_resumable(session))
+        return 0;
+#endif
+    return (SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session)
+            > (long)time(NULL));
+}
+
+/* OpenSSL's new-session callback.  Returns 1 when the cache keeps the
+ * reference to the session. */
+static int
+_session_cache_new_cb(SSL *s, SSL_SESSION *session)
+{
+    PySSLSocket *ssl = SSL_get_app_data(s);
+    _PySSLSessionCacheEntry *entry;
+    Py_ssize_t i;
+    char *key;
+
+    if (ssl == NULL || ssl->session_cache_key == NULL ||
+            !_session_cache_usable(session))
+        return 0;
+
+    PyThread_acquire_lock(_ssl_session_cache.lock, WAIT_LOCK);
+    if (_ssl_session_cache.maxsize == 0)
+        goto fail;
+    i = _session_cache_find(ssl->session_cache_key);
+    if (i >= 0) {
+        entry = &_ssl_session_cache.entries[i];
+        SSL_SESSION_free(entry->session);
+    }
+    else {
+        if (_ssl_session_cache.entries == NULL) {
+            _ssl_session_cache.entries = PyMem_RawMalloc(
+                _ssl_session_cache.maxsize * sizeof(_PySSLSessionCacheEntry));
+            if (_ssl_session_cache.entries == NULL)
+                goto fail;
+        }
+        key = PyMem_RawMalloc(strlen(ssl->session_cache_key) + 1);
+        if (key == NULL)
+            goto fail;
+        strcpy(key, ssl->session_cache_key);
+        if (_ssl_session_cache.size >= _ssl_session_cache.maxsize)
+            _session_cache_evict();
+        entry = &_ssl_session_cache.entries[_ssl_session_cache.size++];
+        entry->key = key;
+        entry->context = ssl->ctx->session_cache_id;
+    }
+    entry->session = session;
+    entry->last_used = ++_ssl_session_cache.clock;
+    _ssl_session_cache.stores++;
+    PyThread_release_lock(_ssl_session_cache.lock);
+    return 1;
+
+fail:
+    PyThread_release_lock(_ssl_session_cache.lock);
+    return 0;
+}
+
+/* Look up a cached session for a client socket of a context with
+ * shared_session_cache set, before its handshake.  The lookup key is
+ * remembered for the new-session callback.  Returns -1 on error. */
+static int
+_session_cache_resume(PySSLSocket *self)
+{
+    PySocketSockObject *sock = GET_SOCKET(self);
+    SSL_SESSION *session = NULL;
+    const char *hostname;
+    char *key;
+    size_t keylen;
+    long port = -1;
+    Py_ssize_t i;
+    PySSLContext *ctx = self->ctx;
+    X509_STORE *store = SSL_CTX_get_cert_store(ctx->ctx);
+    X509_VERIFY_PARAM *param = SSL_get0_param(self->ssl);
+
+    if (self->session_cache_key != NULL ||
+            self->socket_type != PY_SSL_CLIENT ||
+            !self->ctx->shared_session_cache ||
+            self->server_hostname == NULL ||
+            SSL_get_session(self->ssl) != NULL)
+        return 0;
+
+    if (sock != NULL) {
+        struct sockaddr_storage addr;
+        socklen_t addrlen = sizeof(addr);
+
+        if ((PyObject *)sock == Py_None ||
+                getpeername(sock->sock_fd, (struct sockaddr *)&addr,
+                            &addrlen) != 0) {
+            /* not connected yet */
+            return 0;
+        }
+        if (addr.ss_family == AF_INET)
+            port = ntohs(((struct sockaddr_in *)&addr)->sin_port);
+#ifdef AF_INET6
+        else if (addr.ss_family == AF_INET6)
+            port = ntohs(((struct sockaddr_in6 *)&addr)->sin6_port);
+#endif
+    }
+    if (port < 0) {
+        /* memory BIO or unknown address family: all the servers of a host
+           would share one entry */
+        return 0;
+    }
+
+    hostname = PyUnicode_AsUTF8(self->server_hostname);
+    if (hostname == NULL)
+        return -1;
+    /* "id/hostname:port/verify_mode/verify_flags/check_hostname/objects" */
+    keylen = strlen(hostname) + 128;
+    key = PyMem_RawMalloc(keylen);
+    if (key == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    PyOS_snprintf(key, keylen, "%llu/%s:%ld/%d/%lu/%d/%d",
+                  ctx->session_cache_id, hostname, port,
+                  SSL_get_verify_mode(self->ssl),
+                  (unsigned long)X509_VERIFY_PARAM_get_flags(param),
+                  ctx->check_hostname,
+                  sk_X509_OBJECT_num(X509_STORE_get0_objects(store)));
+
+    PyThread_acquire_lock(_ssl_session_cache.lock, WAIT_LOCK);
+    i = _session_cache_find(key);
+    if (i >= 0 && !_session_cache_usable(_ssl_session_cache.entries[i].session)) {
+        _session_cache_remove(i);
+        i = -1;
+    }
+    if (i >= 0) {
+        session = _ssl_session_cache.entries[i].session;
+        SSL_SESSION_up_ref(session);
+        _ssl_session_cache.entries[i].last_used = ++_ssl_session_cache.clock;
+        _ssl_session_cache.hits++;
+    }
+    else {
+        _ssl_session_cache.misses++;
+    }
+    PyThread_release_lock(_ssl_session_cache.lock);
+
+    self->session_cache_key = key;
+    if (session != NULL) {
+        int result = SSL_set_session(self->ssl, session);
+        SSL_SESSION_free(session);
+        if (result == 0) {
+            _setSSLError(NULL, 0, __FILE__, __LINE__);
+            return -1;
+        }
+    }
+    return 0;
+}
+
 static PySSLSocket *
 newPySSLSocket(PySSLContext *sslctx, PySocketSockObject *sock,
                enum py_ssl_server_or_client socket_type,
@@ -919,6 +1190,7 @@ newPySSLSocket(PySSLContext *sslctx, PySocketSockObject *sock,
     self->owner = NULL;
     self->server_hostname = NULL;
     self->err = err;
+    self->session_cache_key = NULL;
 
     /* Make sure the SSL error state is initialized */
     (void) ERR_get_state();
@@ -1007,6 +1279,10 @@ newPySSLSocket(PySSLContext *sslctx, PySocketSockObject *sock,
             return NULL;
         }
     }
+    if (_session_cache_resume(self) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
     return self;
 }
 
@@ -1041,6 +1317,10 @@ _ssl__SSLSocket_do_handshake_impl(PySSLSocket *self)
         BIO_set_nbio(SSL_get_wbio(self->ssl), nonblocking);
     }
 
+    /* The socket may not have been connected when it was wrapped */
+    if (_session_cache_resume(self) < 0)
+        goto error;
+
     timeout = GET_SOCKET_TIMEOUT(sock);
     has_timeout = (timeout > 0);
     if (has_timeout)
@@ -2244,6 +2524,7 @@ static void PySSL_dealloc(PySSLSocket *self)
     Py_XDECREF(self->ctx);
     Py_XDECREF(self->server_hostname);
     Py_XDECREF(self->owner);
+    PyMem_RawFree(self->session_cache_key);
     PyObject_Del(self);
 }
 
@@ -2427,6 +2708,153 @@ error:
     return NULL;
 }
 
+
+#if HAVE_KTLS
+PyDoc_STRVAR(PySSL_uses_ktls_for_send_doc,
+"uses_ktls_for_send($self, /)\n\
+--\n\
+\n\
+Return True if the kernel is used to encrypt the data sent.");
+
+static PyObject *
+PySSL_uses_ktls_for_send(PySSLSocket *self, PyObject *Py_UNUSED(ignored))
+{
+    return PyBool_FromLong(BIO_get_ktls_send(SSL_get_wbio(self->ssl)));
+}
+
+PyDoc_STRVAR(PySSL_uses_ktls_for_recv_doc,
+"uses_ktls_for_recv($self, /)\n\
+--\n\
+\n\
+Return True if the kernel is used to decrypt the data received.");
+
+static PyObject *
+PySSL_uses_ktls_for_recv(PySSLSocket *self, PyObject *Py_UNUSED(ignored))
+{
+    return PyBool_FromLong(BIO_get_ktls_recv(SSL_get_rbio(self->ssl)));
+}
+
+PyDoc_STRVAR(PySSL_sendfile_doc,
+"sendfile($self, fd, offset, size, flags=0, /)\n\
+--\n\
+\n\
+Send size bytes of the file descriptor fd, read from offset.\n\
+\n\
+Requires kernel TLS for sending, see uses_ktls_for_send().\n\
+Returns the number of bytes sent.");
+
+static PyObject *
+PySSL_sendfile(PySSLSocket *self, PyObject *args)
+{
+    int fd, flags = 0;
+    long long offset;
+    Py_ssize_t size;
+    ossl_ssize_t len;
+    int sockstate;
+    _PySSLError err;
+    int nonblocking;
+    PySocketSockObject *sock = GET_SOCKET(self);
+    _PyTime_t timeout, deadline = 0;
+    int has_timeout;
+
+    if (!PyArg_ParseTuple(args, "iLn|i:sendfile",
+                          &fd, &offset, &size, &flags))
+        return NULL;
+    if (offset < 0 || size < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "offset and size must be non-negative");
+        return NULL;
+    }
+
+    if (sock != NULL) {
+        if (((PyObject*)sock) == Py_None) {
+            _setSSLError("Underlying socket connection gone",
+                         PY_SSL_ERROR_NO_SOCKET, __FILE__, __LINE__);
+            return NULL;
+        }
+        Py_INCREF(sock);
+    }
+
+    if (!BIO_get_ktls_send(SSL_get_wbio(self->ssl))) {
+        PyErr_SetString(PySSLErrorObject,
+                        "Kernel TLS is not in use for sending.");
+        goto error;
+    }
+
+    if (sock != NULL) {
+        /* just in case the blocking state of the socket has been changed */
+        nonblocking = (sock->sock_timeout >= 0);
+        BIO_set_nbio(SSL_get_rbio(self->ssl), nonblocking);
+        BIO_set_nbio(SSL_get_wbio(self->ssl), nonblocking);
+    }
+
+    timeout = GET_SOCKET_TIMEOUT(sock);
+    has_timeout = (timeout > 0);
+    if (has_timeout)
+        deadline = _PyTime_GetMonotonicClock() + timeout;
+
+    sockstate = PySSL_select(sock, 1, timeout);
+    if (sockstate == SOCKET_HAS_TIMED_OUT) {
+        PyErr_SetString(PySocketModule.timeout_error,
+                        "The write operation timed out");
+        goto error;
+    } else if (sockstate == SOCKET_HAS_BEEN_CLOSED) {
+        PyErr_SetString(PySSLErrorObject,
+                        "Underlying socket has been closed.");
+        goto error;
+    } else if (sockstate == SOCKET_TOO_LARGE_FOR_SELECT) {
+        PyErr_SetString(PySSLErrorObject,
+                        "Underlying socket too large for select().");
+        goto error;
+    }
+
+    do {
+        PySSL_BEGIN_ALLOW_THREADS
+        len = SSL_sendfile(self->ssl, fd, (off_t)offset, (size_t)size, flags);
+        err = _PySSL_errno(len <= 0, self->ssl, (int)len);
+        PySSL_END_ALLOW_THREADS
+        self->err = err;
+
+        if (PyErr_CheckSignals())
+            goto error;
+
+        if (has_timeout)
+            timeout = deadline - _PyTime_GetMonotonicClock();
+
+        if (err.ssl == SSL_ERROR_WANT_READ) {
+            sockstate = PySSL_select(sock, 0, timeout);
+        } else if (err.ssl == SSL_ERROR_WANT_WRITE) {
+            sockstate = PySSL_select(sock, 1, timeout);
+        } else {
+            sockstate = SOCKET_OPERATION_OK;
+        }
+
+        if (sockstate == SOCKET_HAS_TIMED_OUT) {
+            PyErr_SetString(PySocketModule.timeout_error,
+                            "The write operation timed out");
+            goto error;
+        } else if (sockstate == SOCKET_HAS_BEEN_CLOSED) {
+            PyErr_SetString(PySSLErrorObject,
+                            "Underlying socket has been closed.");
+            goto error;
+        } else if (sockstate == SOCKET_IS_NONBLOCKING) {
+            break;
+        }
+    } while (err.ssl == SSL_ERROR_WANT_READ ||
+             err.ssl == SSL_ERROR_WANT_WRITE);
+
+    Py_XDECREF(sock);
+    if (len > 0)
+        return PyLong_FromSsize_t(len);
+    else
+        return PySSL_SetError(self, (int)len, __FILE__, __LINE__);
+
+error:
+    Py_XDECREF(sock);
+    return NULL;
+}
+#endif /* HAVE_KTLS */
+
 /*[clinic input]
 _ssl._SSLSocket.pending
 
@@ -2947,6 +3375,14 @@ static PyMethodDef PySSLMethods[] = {
     _SSL__SSLSOCKET_COMPRESSION_METHODDEF
     _SSL__SSLSOCKET_SHUTDOWN_METHODDEF
     _SSL__SSLSOCKET_VERIFY_CLIENT_POST_HANDSHAKE_METHODDEF
+#if HAVE_KTLS
+    {"sendfile", (PyCFunction)PySSL_sendfile, METH_VARARGS,
+     PySSL_sendfile_doc},
+    {"uses_ktls_for_send", (PyCFunction)PySSL_uses_ktls_for_send,
+     METH_NOARGS, PySSL_uses_ktls_for_send_doc},
+    {"uses_ktls_for_recv", (PyCFunction)PySSL_uses_ktls_for_recv,
+     METH_NOARGS, PySSL_uses_ktls_for_recv_doc},
+#endif
     {NULL, NULL}
 };
 
@@ -3217,6 +3653,8 @@ _ssl__SSLContext_impl(PyTypeObject *type, int proto_version)
     self->post_handshake_auth = 0;
     SSL_CTX_set_post_handshake_auth(self->ctx, self->post_handshake_auth);
 #endif
+    self->shared_session_cache = 0;
+    self->session_cache_id = ++_ssl_session_cache_last_id;
 
     return (PyObject *)self;
 }
@@ -3245,6 +3683,8 @@ context_dealloc(PySSLContext *self)
     /* bpo-31095: UnTrack is needed before calling any callbacks */
     PyObject_GC_UnTrack(self);
     context_clear(self);
+    if (self->shared_session_cache)
+        _session_cache_clear_context(self->session_cache_id);
     SSL_CTX_free(self->ctx);
 #if HAVE_NPN
     PyMem_FREE(self->npn_protocols);
@@ -3714,6 +4154,31 @@ set_check_hostname(PySSLContext *self, PyObject *arg, void *c)
     return 0;
 }
 
+static PyObject *
+get_shared_session_cache(PySSLContext *self, void *c)
+{
+    return PyBool_FromLong(self->shared_session_cache);
+}
+
+static int
+set_shared_session_cache(PySSLContext *self, PyObject *arg, void *c)
+{
+    int shared;
+    if (!PyArg_Parse(arg, "p", &shared))
+        return -1;
+    if (shared) {
+        /* sessions are kept in the shared cache only */
+        SSL_CTX_set_session_cache_mode(self->ctx,
+            SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(self->ctx, _session_cache_new_cb);
+    } else {
+        SSL_CTX_set_session_cache_mode(self->ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_new_cb(self->ctx, NULL);
+    }
+    self->shared_session_cache = shared;
+    return 0;
+}
+
 static PyObject *
 get_post_handshake_auth(PySSLContext *self, void *c) {
 #if TLS1_3_VERSION
@@ -4632,6 +5097,12 @@ _ssl__SSLContext_get_ca_certs_impl(PySSLContext *self, int binary_form)
 }
 
 
+PyDoc_STRVAR(PySSLContext_shared_session_cache_doc,
+"Store the sessions of client sockets in the process-wide session cache\n\
+and resume them in later connections of this context to the same server\n\
+and port, with the same verification settings. Disables server-side\n\
+caching.");
+
 static PyGetSetDef context_getsetlist[] = {
     {"check_hostname", (getter) get_check_hostname,
                        (setter) set_check_hostname, NULL},
@@ -4656,6 +5127,9 @@ static PyGetSetDef context_getsetlist[] = {
                             NULL},
     {"protocol", (getter) get_protocol,
                  NULL, NULL},
+    {"shared_session_cache", (getter) get_shared_session_cache,
+                             (setter) set_shared_session_cache,
+                             PySSLContext_shared_session_cache_doc},
     {"verify_flags", (getter) get_verify_flags,
                      (setter) set_verify_flags, NULL},
     {"verify_mode", (getter) get_verify_mode,
@@ -5729,6 +6203,96 @@ _ssl_enum_crls_impl(PyObject *module, const char *store_name)
 #endif /* _MSC_VER */
 
 /* List of functions exported by this module. */
+PyDoc_STRVAR(client_session_cache_info_doc,
+"client_session_cache_info($module, /)\n\
+--\n\
+\n\
+Return a dict with the statistics of the shared client session cache.");
+
+static PyObject *
+client_session_cache_info(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    unsigned long long hits, misses, stores, evictions;
+    Py_ssize_t size, maxsize;
+
+    PyThread_acquire_lock(_ssl_session_cache.lock, WAIT_LOCK);
+    hits = _ssl_session_cache.hits;
+    misses = _ssl_session_cache.misses;
+    stores = _ssl_session_cache.stores;
+    evictions = _ssl_session_cache.evictions;
+    size = _ssl_session_cache.size;
+    maxsize = _ssl_session_cache.maxsize;
+    PyThread_release_lock(_ssl_session_cache.lock);
+
+    return Py_BuildValue("{sKsKsKsKsnsn}",
+                         "hits", hits, "misses", misses,
+                         "stores", stores, "evictions", evictions,
+                         "currsize", size, "maxsize", maxsize);
+}
+
+PyDoc_STRVAR(set_client_session_cache_size_doc,
+"set_client_session_cache_size($module, maxsize, /)\n\
+--\n\
+\n\
+Set the maximum number of sessions in the shared client session cache.\n\
+\n\
+The least recently used sessions are evicted if the cache holds more.\n\
+0 disables the cache.");
+
+static PyObject *
+set_client_session_cache_size(PyObject *module, PyObject *arg)
+{
+    _PySSLSessionCacheEntry *entries;
+    Py_ssize_t maxsize;
+
+    maxsize = PyNumber_AsSsize_t(arg, PyExc_OverflowError);
+    if (maxsize == -1 && PyErr_Occurred())
+        return NULL;
+    if (maxsize < 0) {
+        PyErr_SetString(PyExc_ValueError, "maxsize must be non-negative");
+        return NULL;
+    }
+    if ((size_t)maxsize > PY_SSIZE_T_MAX / sizeof(_PySSLSessionCacheEntry))
+        return PyErr_NoMemory();
+
+    PyThread_acquire_lock(_ssl_session_cache.lock, WAIT_LOCK);
+    while (_ssl_session_cache.size > maxsize)
+        _session_cache_evict();
+    if (_ssl_session_cache.entries != NULL) {
+        entries = PyMem_RawRealloc(_ssl_session_cache.entries,
+            Py_MAX(maxsize, 1) * sizeof(_PySSLSessionCacheEntry));
+        if (entries == NULL) {
+            PyThread_release_lock(_ssl_session_cache.lock);
+            return PyErr_NoMemory();
+        }
+        _ssl_session_cache.entries = entries;
+    }
+    _ssl_session_cache.maxsize = maxsize;
+    PyThread_release_lock(_ssl_session_cache.lock);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(clear_client_session_cache_doc,
+"clear_client_session_cache($module, /)\n\
+--\n\
+\n\
+Remove all sessions from the shared client session cache and reset\n\
+its statistics.");
+
+static PyObject *
+clear_client_session_cache(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyThread_acquire_lock(_ssl_session_cache.lock, WAIT_LOCK);
+    while (_ssl_session_cache.size > 0)
+        _session_cache_remove(_ssl_session_cache.size - 1);
+    _ssl_session_cache.hits = 0;
+    _ssl_session_cache.misses = 0;
+    _ssl_session_cache.stores = 0;
+    _ssl_session_cache.evictions = 0;
+    PyThread_release_lock(_ssl_session_cache.lock);
+    Py_RETURN_NONE;
+}
+
 static PyMethodDef PySSL_methods[] = {
     _SSL__TEST_DECODE_CERT_METHODDEF
     _SSL_RAND_ADD_METHODDEF
@@ -5741,6 +6305,13 @@ static PyMethodDef PySSL_methods[] = {
     _SSL_ENUM_CRLS_METHODDEF
     _SSL_TXT2OBJ_METHODDEF
     _SSL_NID2OBJ_METHODDEF
+    {"client_session_cache_info", (PyCFunction)client_session_cache_info,
+     METH_NOARGS, client_session_cache_info_doc},
+    {"set_client_session_cache_size",
+     (PyCFunction)set_client_session_cache_size,
+     METH_O, set_client_session_cache_size_doc},
+    {"clear_client_session_cache", (PyCFunction)clear_client_session_cache,
+     METH_NOARGS, clear_client_session_cache_doc},
     {NULL,                  NULL}            /* Sentinel */
 };
 
@@ -5885,6 +6456,14 @@ PyInit__ssl(void)
     if (PyType_Ready(&PySSLSession_Type) < 0)
         return NULL;
 
+    if (_ssl_session_cache.lock == NULL) {
+        _ssl_session_cache.lock = PyThread_allocate_lock();
+        if (_ssl_session_cache.lock == NULL) {
+            PyErr_SetString(PyExc_RuntimeError, "can't allocate lock");
+            return NULL;
+        }
+    }
+
 
     m = PyModule_Create(&_sslmodule);
     if (m == NULL)
@@ -6123,6 +6702,10 @@ PyInit__ssl(void)
     PyModule_AddIntConstant(m, "OP_NO_RENEGOTIATION",
                             SSL_OP_NO_RENEGOTIATION);
 #endif
+#ifdef SSL_OP_ENABLE_KTLS
+    PyModule_AddIntConstant(m, "OP_ENABLE_KTLS",
+                            SSL_OP_ENABLE_KTLS);
+#endif
 
 #ifdef X509_CHECK_FLAG_ALWAYS_CHECK_SUBJECT
     PyModule_AddIntConstant(m, "HOSTFLAG_ALWAYS_CHECK_SUBJECT",
@@ -6190,6 +6773,12 @@ PyInit__ssl(void)
     addbool(m, "HAS_ALPN", 0);
 #endif
 
+#if HAVE_KTLS
+    addbool(m, "HAS_KTLS", 1);
+#else
+    addbool(m, "HAS_KTLS", 0);
+#endif
+
 #if defined(SSL2_VERSION) && !defined(OPENSSL_NO_SSL2)
     addbool(m, "HAS_SSLv2", 1);
 #else
@@ -1580,6 +1580,164 @@ Struct_unpack_from_impl(PyStructObject *self, Py_buffer *buffer,
     return s_unpack_internal(self, (char*)buffer->buf + offset);
 }
 
+/* Bulk unpacking: unpack_many() */
+
+/* Fill list with the values of one field of count records, found every
+   stride bytes from p. */
+static int
+s_unpack_column(const formatcode *code, const char *p, Py_ssize_t stride,
+                Py_ssize_t count, PyObject *list)
+{
+    const formatdef *e = code->fmtdef;
+    Py_ssize_t i;
+    PyObject *v;
+
+#if PY_LITTLE_ENDIAN && defined(DOUBLE_IS_LITTLE_ENDIAN_IEEE754)
+    /* The standard size floats are the native ones here: bypass the
+       portable decoding of lu_float() and lu_double() */
+    if (e->unpack == lu_double || e->unpack == nu_double) {
+        double x;
+        for (i = 0; i < count; i++, p += stride) {
+            memcpy((char *)&x, p, sizeof x);
+            v = PyFloat_FromDouble(x);
+            if (v == NULL)
+                return -1;
+            PyList_SET_ITEM(list, i, v);
+        }
+        return 0;
+    }
+    if (e->unpack == lu_float || e->unpack == nu_float) {
+        float x;
+        for (i = 0; i < count; i++, p += stride) {
+            memcpy((char *)&x, p, sizeof x);
+            v = PyFloat_FromDouble(x);
+            if (v == NULL)
+                return -1;
+            PyList_SET_ITEM(list, i, v);
+        }
+        return 0;
+    }
+#endif
+
+    for (i = 0; i < count; i++, p += stride) {
+        if (e->format == 's') {
+            v = PyBytes_FromStringAndSize(p, code->size);
+        } else if (e->format == 'p') {
+            Py_ssize_t n = *(unsigned char*)p;
+            if (n >= code->size)
+                n = code->size - 1;
+            v = PyBytes_FromStringAndSize(p + 1, n);
+        } else {
+            v = e->unpack(p, e);
+        }
+        if (v == NULL)
+            return -1;
+        PyList_SET_ITEM(list, i, v);
+    }
+    return 0;
+}
+
+/* Unpack count records from startfrom into a tuple of lists, one list
+   per field.  The fields are decoded one at a time, in a single loop over
+   the records. */
+static PyObject *
+s_unpack_many_internal(PyStructObject *soself, const char *startfrom,
+                       Py_ssize_t count)
+{
+    formatcode *code;
+    Py_ssize_t i = 0;
+    PyObject *result = PyTuple_New(soself->s_len);
+    if (result == NULL)
+        return NULL;
+
+    for (code = soself->s_codes; code->fmtdef != NULL; code++) {
+        const char *res = startfrom + code->offset;
+        Py_ssize_t j = code->repeat;
+        while (j--) {
+            PyObject *column = PyList_New(count);
+            if (column == NULL)
+                goto fail;
+            PyTuple_SET_ITEM(result, i++, column);
+            if (s_unpack_column(code, res, soself->s_size, count, column) < 0)
+                goto fail;
+            res += code->size;
+        }
+    }
+
+    return result;
+fail:
+    Py_DECREF(result);
+    return NULL;
+}
+
+static PyObject *
+s_unpack_many_buffer(PyStructObject *soself, Py_buffer *buffer,
+                     Py_ssize_t count, Py_ssize_t offset)
+{
+    Py_ssize_t available;
+
+    if (offset < 0)
+        offset += buffer->len;
+    if (offset < 0 || offset > buffer->len) {
+        PyErr_SetString(StructError, "offset out of range");
+        return NULL;
+    }
+    available = buffer->len - offset;
+    if (count < 0) {
+        if (soself->s_size == 0) {
+            PyErr_SetString(StructError,
+                            "cannot unpack many records with a struct "
+                            "of length 0 without a count");
+            return NULL;
+        }
+        if (available % soself->s_size != 0) {
+            PyErr_Format(StructError,
+                         "unpack_many requires a buffer of "
+                         "a multiple of %zd bytes",
+                         soself->s_size);
+            return NULL;
+        }
+        count = available / soself->s_size;
+    }
+    else if (soself->s_size != 0 && count > available / soself->s_size) {
+        PyErr_Format(StructError,
+                     "unpack_many requires a buffer of at least %zd "
+                     "records of %zd bytes",
+                     count, soself->s_size);
+        return NULL;
+    }
+    return s_unpack_many_internal(soself, (char*)buffer->buf + offset, count);
+}
+
+PyDoc_STRVAR(s_unpack_many__doc__,
+"unpack_many($self, /, buffer, count=-1, offset=0)\n"
+"--\n"
+"\n"
+"Return a tuple of lists, one per field, holding count unpacked records.\n"
+"\n"
+"The records are read one after the other from the buffer, starting at\n"
+"offset.  With the default count, the remaining bytes must be a multiple\n"
+"of Struct.size and all the records are unpacked.\n"
+"\n"
+"See help(struct) for more on format strings.");
+
+static PyObject *
+s_unpack_many(PyStructObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"buffer", "count", "offset", NULL};
+    Py_buffer buffer;
+    Py_ssize_t count = -1, offset = 0;
+    PyObject *result;
+
+    assert(self->s_codes != NULL);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|nn:unpack_many", kwlist,
+                                     &buffer, &count, &offset))
+        return NULL;
+    result = s_unpack_many_buffer(self, &buffer, count, offset);
+    PyBuffer_Release(&buffer);
+    return result;
+}
+
 
 
 /* Unpack iterator type */
@@ -1991,6 +2149,7 @@ static struct PyMethodDef s_methods[] = {
     {"pack_into",       (PyCFunction)s_pack_into, METH_FASTCALL, s_pack_into__doc__},
     STRUCT_UNPACK_METHODDEF
     STRUCT_UNPACK_FROM_METHODDEF
+    {"unpack_many",     (PyCFunction)s_unpack_many, METH_VARARGS | METH_KEYWORDS, s_unpack_many__doc__},
     {"__sizeof__",      (PyCFunction)s_sizeof, METH_NOARGS, s_sizeof__doc__},
     {NULL,       NULL}          /* sentinel */
 };
@@ -2241,6 +2400,38 @@ iter_unpack_impl(PyObject *module, PyStructObject *s_object,
     return Struct_iter_unpack(s_object, buffer);
 }
 
+PyDoc_STRVAR(unpack_many_doc,
+"unpack_many(format, /, buffer, count=-1, offset=0)\n"
+"--\n"
+"\n"
+"Return a tuple of lists, one per field, holding count records unpacked\n"
+"according to the format string.\n"
+"\n"
+"With the default count, the buffer's size minus offset must be a\n"
+"multiple of calcsize(format) and all the records are unpacked.\n"
+"\n"
+"See help(struct) for more on format strings.");
+
+static PyObject *
+unpack_many(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"", "buffer", "count", "offset", NULL};
+    PyObject *s_object = NULL;
+    Py_buffer buffer;
+    Py_ssize_t count = -1, offset = 0;
+    PyObject *result;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&y*|nn:unpack_many",
+                                     kwlist, cache_struct_converter,
+                                     &s_object, &buffer, &count, &offset))
+        return NULL;
+    result = s_unpack_many_buffer((PyStructObject *)s_object, &buffer,
+                                  count, offset);
+    PyBuffer_Release(&buffer);
+    Py_DECREF(s_object);
+    return result;
+}
+
 static struct PyMethodDef module_functions[] = {
     _CLEARCACHE_METHODDEF
     CALCSIZE_METHODDEF
@@ -2249,6 +2440,7 @@ static struct PyMethodDef module_functions[] = {
     {"pack_into",       (PyCFunction)pack_into, METH_FASTCALL,   pack_into_doc},
     UNPACK_METHODDEF
     UNPACK_FROM_METHODDEF
+    {"unpack_many",     (PyCFunction)unpack_many, METH_VARARGS | METH_KEYWORDS, unpack_many_doc},
     {NULL,       NULL}          /* sentinel */
 };
 
@@ -49,7 +49,12 @@ static struct {
     /* use domain in trace key?
        Variable protected by the GIL. */
     int use_domain;
-} tracemalloc_config = {TRACEMALLOC_NOT_INITIALIZED, 0, 1, 0};
+
+    /* sampling mode: mean number of bytes allocated between two sampled
+       memory blocks, 0 to trace all memory blocks.
+       Variable protected by the GIL. */
+    size_t sample_rate;
+} tracemalloc_config = {TRACEMALLOC_NOT_INITIALIZED, 0, 1, 0, 0};
 
 #if defined(TRACE_RAW_MALLOC)
 /* This lock is needed because tracemalloc_free() is called without
@@ -148,6 +153,30 @@ static _Py_hashtable_t *tracemalloc_tracebacks = NULL;
    Protected by TABLES_LOCK(). */
 static _Py_hashtable_t *tracemalloc_traces = NULL;
 
+/* Sampling mode: number of bytes left to allocate before the next sampled
+   memory block, and state of the generator of the sampling intervals.
+   Protected by the GIL. */
+static size_t tracemalloc_sample_countdown = 0;
+static uint64_t tracemalloc_sample_seed = 0;
+
+/* Sampling mode: number of traces per bucket of memory block addresses,
+   so that freeing a block which was not sampled doesn't have to take
+   TABLES_LOCK() to look into tracemalloc_traces.
+   Modified with TABLES_LOCK() held, read without it.  Once allocated, it is
+   only released by tracemalloc_deinit(): a thread freeing memory may still
+   be reading it after tracemalloc_stop().  Its counters stay exact even
+   when tracemalloc is restarted without sampling. */
+#define SAMPLE_FILTER_SIZE (1 << 16)
+static unsigned int *tracemalloc_sample_filter = NULL;
+
+#define SAMPLE_FILTER_INDEX(ptr) \
+        ((size_t)_Py_HashPointer((void *)(ptr)) & (SAMPLE_FILTER_SIZE - 1))
+
+/* Can the memory block at ptr have a trace? */
+#define MAYBE_TRACED(ptr) \
+        (tracemalloc_sample_filter == NULL \
+         || tracemalloc_sample_filter[SAMPLE_FILTER_INDEX(ptr)] != 0)
+
 
 #ifdef TRACE_DEBUG
 static void
@@ -514,6 +543,70 @@ traceback_new(void)
 }
 
 
+/* Draw the number of bytes to allocate before the next sampled memory
+   block from an exponential distribution of mean sample_rate: sampled
+   bytes then form a Poisson process, like tcmalloc's heap profiler.
+   The GIL must be held. */
+static size_t
+tracemalloc_sample_interval(void)
+{
+    uint64_t x = tracemalloc_sample_seed;
+    double u, interval;
+
+    /* xorshift64* */
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    tracemalloc_sample_seed = x;
+    x *= 0x2545F4914F6CDD1DULL;
+
+    /* uniform in (0; 1] */
+    u = ((double)(x >> 11) + 1.0) / 9007199254740992.0;
+    interval = -log(u) * (double)tracemalloc_config.sample_rate;
+    if (interval < 1.0)
+        return 1;
+    if (interval >= (double)(PY_SSIZE_T_MAX))
+        return (size_t)PY_SSIZE_T_MAX;
+    return (size_t)interval;
+}
+
+
+/* Return 1 if a new memory block of size bytes must be traced, 0 if it
+   is not sampled. The GIL must be held. */
+static int
+tracemalloc_sample(size_t size)
+{
+    if (tracemalloc_config.sample_rate == 0)
+        return 1;
+
+    if (size < tracemalloc_sample_countdown) {
+        tracemalloc_sample_countdown -= size;
+        return 0;
+    }
+    tracemalloc_sample_countdown = tracemalloc_sample_interval();
+    return 1;
+}
+
+
+/* Size recorded in the trace of a sampled memory block: a block of size
+   bytes is sampled with probability 1 - exp(-size / sample_rate), so each
+   sample stands for size / (1 - exp(-size / sample_rate)) bytes. */
+static size_t
+tracemalloc_sample_weight(size_t size)
+{
+    double rate = (double)tracemalloc_config.sample_rate;
+    double weight;
+
+    if (tracemalloc_config.sample_rate == 0 || size == 0)
+        return size;
+
+    weight = (double)size / -expm1(-(double)size / rate);
+    if (weight >= (double)(PY_SSIZE_T_MAX))
+        return (size_t)PY_SSIZE_T_MAX;
+    return (size_t)weight;
+}
+
+
 static int
 tracemalloc_use_domain_cb(_Py_hashtable_t *old_traces,
                            _Py_hashtable_entry_t *entry, void *user_data)
@@ -585,6 +678,11 @@ tracemalloc_remove_trace(unsigned int domain, uintptr_t ptr)
         return;
     }
 
+    if (tracemalloc_sample_filter != NULL) {
+        assert(tracemalloc_sample_filter[SAMPLE_FILTER_INDEX(ptr)] != 0);
+        tracemalloc_sample_filter[SAMPLE_FILTER_INDEX(ptr)]--;
+    }
+
     assert(tracemalloc_traced_memory >= trace.size);
     tracemalloc_traced_memory -= trace.size;
 }
@@ -648,6 +746,10 @@ tracemalloc_add_trace(unsigned int domain, uintptr_t ptr,
         if (res != 0) {
             return res;
         }
+
+        if (tracemalloc_sample_filter != NULL) {
+            tracemalloc_sample_filter[SAMPLE_FILTER_INDEX(ptr)]++;
+        }
     }
 
     assert(tracemalloc_traced_memory <= SIZE_MAX - size);
@@ -658,7 +760,8 @@ tracemalloc_add_trace(unsigned int domain, uintptr_t ptr,
 }
 
 #define ADD_TRACE(ptr, size) \
-            tracemalloc_add_trace(DEFAULT_DOMAIN, (uintptr_t)(ptr), size)
+            tracemalloc_add_trace(DEFAULT_DOMAIN, (uintptr_t)(ptr), \
+                                  tracemalloc_sample_weight(size))
 
 
 static void*
@@ -698,6 +801,16 @@ tracemalloc_realloc(void *ctx, void *ptr, size_t new_size)
     if (ptr2 == NULL)
         return NULL;
 
+    if (!tracemalloc_sample(new_size)) {
+        /* the resized block is not sampled: drop the old trace, if any */
+        if (ptr != NULL && MAYBE_TRACED(ptr)) {
+            TABLES_LOCK();
+            REMOVE_TRACE(ptr);
+            TABLES_UNLOCK();
+        }
+        return ptr2;
+    }
+
     if (ptr != NULL) {
         /* an existing memory block has been resized */
 
@@ -718,8 +831,13 @@ tracemalloc_realloc(void *ctx, void *ptr, size_t new_size)
                released, so the hash table should have at least one free entry.
 
                The GIL and the table lock ensures that only one thread is
-               allocating memory. */
-            Py_UNREACHABLE();
+               allocating memory.
+
+               In sampling mode, ptr may not have been traced: ptr2 is
+               then left untraced, which only loses one sample. */
+            if (tracemalloc_config.sample_rate == 0) {
+                Py_UNREACHABLE();
+            }
         }
         TABLES_UNLOCK();
     }
@@ -752,6 +870,9 @@ tracemalloc_free(void *ctx, void *ptr)
 
     alloc->free(alloc->ctx, ptr);
 
+    if (!MAYBE_TRACED(ptr))
+        return;
+
     TABLES_LOCK();
     REMOVE_TRACE(ptr);
     TABLES_UNLOCK();
@@ -771,6 +892,15 @@ tracemalloc_alloc_gil(int use_calloc, void *ctx, size_t nelem, size_t elsize)
             return alloc->malloc(alloc->ctx, nelem * elsize);
     }
 
+    if (!tracemalloc_sample(nelem * elsize)) {
+        /* sampling mode: don't trace this memory block */
+        PyMemAllocatorEx *alloc = (PyMemAllocatorEx *)ctx;
+        if (use_calloc)
+            return alloc->calloc(alloc->ctx, nelem, elsize);
+        else
+            return alloc->malloc(alloc->ctx, nelem * elsize);
+    }
+
     /* Ignore reentrant call. PyObjet_Malloc() calls PyMem_Malloc() for
        allocations larger than 512 bytes, don't trace the same memory
        allocation twice. */
@@ -851,7 +981,17 @@ tracemalloc_raw_alloc(int use_calloc, void *ctx, size_t nelem, size_t elsize)
     set_reentrant(1);
 
     gil_state = PyGILState_Ensure();
-    ptr = tracemalloc_alloc(use_calloc, ctx, nelem, elsize);
+    if (tracemalloc_sample(nelem * elsize)) {
+        ptr = tracemalloc_alloc(use_calloc, ctx, nelem, elsize);
+    }
+    else {
+        /* sampling mode: don't trace this memory block */
+        PyMemAllocatorEx *alloc = (PyMemAllocatorEx *)ctx;
+        if (use_calloc)
+            ptr = alloc->calloc(alloc->ctx, nelem, elsize);
+        else
+            ptr = alloc->malloc(alloc->ctx, nelem * elsize);
+    }
     PyGILState_Release(gil_state);
 
     set_reentrant(0);
@@ -943,6 +1083,10 @@ tracemalloc_clear_traces(void)
     _Py_hashtable_clear(tracemalloc_traces);
     tracemalloc_traced_memory = 0;
     tracemalloc_peak_traced_memory = 0;
+    if (tracemalloc_sample_filter != NULL) {
+        memset(tracemalloc_sample_filter, 0,
+               SAMPLE_FILTER_SIZE * sizeof(tracemalloc_sample_filter[0]));
+    }
     TABLES_UNLOCK();
 
     _Py_hashtable_foreach(tracemalloc_tracebacks, traceback_free_traceback, NULL);
@@ -1040,6 +1184,11 @@ tracemalloc_deinit(void)
 
     tracemalloc_stop();
 
+    if (tracemalloc_sample_filter != NULL) {
+        raw_free(tracemalloc_sample_filter);
+        tracemalloc_sample_filter = NULL;
+    }
+
     /* destroy hash tables */
     _Py_hashtable_destroy(tracemalloc_tracebacks);
     _Py_hashtable_destroy(tracemalloc_filenames);
@@ -1061,7 +1210,7 @@ tracemalloc_deinit(void)
 
 
 static int
-tracemalloc_start(int max_nframe)
+tracemalloc_start(int max_nframe, Py_ssize_t sample_rate)
 {
     PyMemAllocatorEx alloc;
     size_t size;
@@ -1073,6 +1222,13 @@ tracemalloc_start(int max_nframe)
         return -1;
     }
 
+    if (sample_rate < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "the sample rate must be a positive number of bytes "
+                        "or 0");
+        return -1;
+    }
+
     if (tracemalloc_init() < 0) {
         return -1;
     }
@@ -1094,6 +1250,27 @@ tracemalloc_start(int max_nframe)
         return -1;
     }
 
+    if (sample_rate != 0) {
+        if (tracemalloc_sample_filter == NULL) {
+            size = SAMPLE_FILTER_SIZE * sizeof(tracemalloc_sample_filter[0]);
+            tracemalloc_sample_filter = raw_malloc(size);
+            if (tracemalloc_sample_filter == NULL) {
+                raw_free(tracemalloc_traceback);
+                tracemalloc_traceback = NULL;
+                PyErr_NoMemory();
+                return -1;
+            }
+            memset(tracemalloc_sample_filter, 0, size);
+        }
+
+        tracemalloc_sample_seed = ((uint64_t)_PyTime_GetPerfCounter()
+                                   ^ (uintptr_t)tracemalloc_sample_filter);
+        tracemalloc_sample_seed |= 1;
+    }
+    tracemalloc_config.sample_rate = (size_t)sample_rate;
+    tracemalloc_sample_countdown = (sample_rate != 0
+                                    ? tracemalloc_sample_interval() : 0);
+
 #ifdef TRACE_RAW_MALLOC
     alloc.malloc = tracemalloc_raw_malloc;
     alloc.calloc = tracemalloc_raw_calloc;
@@ -1146,6 +1323,9 @@ tracemalloc_stop(void)
     /* release memory */
     raw_free(tracemalloc_traceback);
     tracemalloc_traceback = NULL;
+
+    /* tracemalloc_sample_filter is kept: see its declaration */
+    tracemalloc_config.sample_rate = 0;
 }
 
 
@@ -1515,19 +1695,24 @@ _PyMem_DumpTraceback(int fd, const void *ptr)
 _tracemalloc.start
 
     nframe: int = 1
+    sample_rate: Py_ssize_t = 0
     /
 
 Start tracing Python memory allocations.
 
 Also set the maximum number of frames stored in the traceback of a
 trace to nframe.
+
+If sample_rate is non-zero, only trace about one memory block per
+sample_rate bytes allocated.  The sizes of traces and the traced
+memory are then estimates of the memory allocated at each traceback.
 [clinic start generated code]*/
 
 static PyObject *
-_tracemalloc_start_impl(PyObject *module, int nframe)
+_tracemalloc_start_impl(PyObject *module, int nframe, Py_ssize_t sample_rate)
 /*[clinic end generated code: output=caae05c23c159d3c input=40d849b5b29d1933]*/
 {
-    if (tracemalloc_start(nframe) < 0) {
+    if (tracemalloc_start(nframe, sample_rate) < 0) {
         return NULL;
     }
     Py_RETURN_NONE;
@@ -1568,6 +1753,21 @@ _tracemalloc_get_traceback_limit_impl(PyObject *module)
 }
 
 
+PyDoc_STRVAR(tracemalloc_get_sample_rate_doc,
+"get_sample_rate($module, /)\n"
+"--\n"
+"\n"
+"Get the mean number of bytes allocated between two traced memory blocks.\n"
+"\n"
+"Return 0 if every memory block is traced.");
+
+static PyObject *
+tracemalloc_get_sample_rate(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return PyLong_FromSize_t(tracemalloc_config.sample_rate);
+}
+
+
 
 /*[clinic input]
 _tracemalloc.get_tracemalloc_memory
@@ -1588,6 +1788,9 @@ _tracemalloc_get_tracemalloc_memory_impl(PyObject *module)
 
     TABLES_LOCK();
     size += _Py_hashtable_size(tracemalloc_traces);
+    if (tracemalloc_sample_filter != NULL) {
+        size += SAMPLE_FILTER_SIZE * sizeof(tracemalloc_sample_filter[0]);
+    }
     TABLES_UNLOCK();
 
     return PyLong_FromSize_t(size);
@@ -1629,6 +1832,8 @@ static PyMethodDef module_methods[] = {
     _TRACEMALLOC_START_METHODDEF
     _TRACEMALLOC_STOP_METHODDEF
     _TRACEMALLOC_GET_TRACEBACK_LIMIT_METHODDEF
+    {"get_sample_rate", tracemalloc_get_sample_rate, METH_NOARGS,
+     tracemalloc_get_sample_rate_doc},
     _TRACEMALLOC_GET_TRACEMALLOC_MEMORY_METHODDEF
     _TRACEMALLOC_GET_TRACED_MEMORY_METHODDEF
     /* sentinel */
@@ -1671,7 +1876,7 @@ _PyTraceMalloc_Init(int nframe)
     if (nframe == 0) {
         return 0;
     }
-    return tracemalloc_start(nframe);
+    return tracemalloc_start(nframe, 0);
 }
 
 
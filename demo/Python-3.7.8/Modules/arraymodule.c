@@ -35,6 +35,11 @@ struct arraydescr {
     const char *formats;
     int is_integer_type;
     int is_signed;
+    /* Element-wise kernels, NULL for 'u' */
+    void (*arith)(int, char *, const char *, Py_ssize_t, int);
+    PyObject * (*minmax)(const char *, Py_ssize_t, int);
+    PyObject * (*sum)(const char *, Py_ssize_t);
+    void (*tofloat)(const char *, Py_ssize_t, char *, int);
 };
 
 typedef struct arrayobject {
@@ -542,25 +547,216 @@ DEFINE_COMPAREITEMS(LL, unsigned long)
 DEFINE_COMPAREITEMS(q, long long)
 DEFINE_COMPAREITEMS(QQ, unsigned long long)
 
+/* Element-wise kernels behind add(), sub(), mul(), sum(), min(), max()
+ * and astype().  They are plain loops over the C type of the items, left
+ * to the compiler to vectorize for the target.  Integer arithmetic is done
+ * on an unsigned type, so that it wraps around instead of overflowing.
+ */
+enum array_arith_op {
+    ARRAY_ADD,
+    ARRAY_SUB,
+    ARRAY_MUL
+};
+
+#define ARRAY_ARITH_LOOP(type, utype, OP, rhs) \
+    for (i = 0; i < n; i++) \
+        a[i] = (type)((utype)a[i] OP (utype)(rhs));
+
+/* Apply op to the n items at dst and the n items at src, or the single
+   item at src if scalar is true.  n must be positive. */
+#define DEFINE_ARITH(code, type, utype) \
+    static void \
+    code##_arith(int op, char *dst, const char *src, Py_ssize_t n, int scalar) \
+    { \
+        type *a = (type *)dst; \
+        const type *b = (const type *)src; \
+        const type s = b[0]; \
+        Py_ssize_t i; \
+        switch (op) { \
+        case ARRAY_ADD: \
+            if (scalar) { ARRAY_ARITH_LOOP(type, utype, +, s) } \
+            else { ARRAY_ARITH_LOOP(type, utype, +, b[i]) } \
+            break; \
+        case ARRAY_SUB: \
+            if (scalar) { ARRAY_ARITH_LOOP(type, utype, -, s) } \
+            else { ARRAY_ARITH_LOOP(type, utype, -, b[i]) } \
+            break; \
+        case ARRAY_MUL: \
+            if (scalar) { ARRAY_ARITH_LOOP(type, utype, *, s) } \
+            else { ARRAY_ARITH_LOOP(type, utype, *, b[i]) } \
+            break; \
+        } \
+    }
+
+/* Return the smallest or the largest of the n items at src, comparing
+   like the min() and max() builtins.  n must be positive. */
+#define DEFINE_MINMAX(code, type, FROM) \
+    static PyObject * \
+    code##_minmax(const char *src, Py_ssize_t n, int want_max) \
+    { \
+        const type *a = (const type *)src; \
+        type m = a[0]; \
+        Py_ssize_t i; \
+        if (want_max) { \
+            for (i = 1; i < n; i++) \
+                m = a[i] > m ? a[i] : m; \
+        } \
+        else { \
+            for (i = 1; i < n; i++) \
+                m = a[i] < m ? a[i] : m; \
+        } \
+        return FROM(m); \
+    }
+
+/* Integer sums are accumulated in a wide C integer over blocks of items
+   small enough not to overflow it, then added as Python ints.  Items of
+   more than 32 bits are split in high and low halves. */
+#define ARRAY_SUM_BLOCK (1 << 24)
+
+static PyObject *
+array_sum_halves(PyObject *hi, PyObject *lo)
+{
+    PyObject *shift, *result = NULL;
+
+    if (hi == NULL || lo == NULL)
+        goto done;
+    shift = PyLong_FromLong(32);
+    if (shift == NULL)
+        goto done;
+    Py_SETREF(hi, PyNumber_Lshift(hi, shift));
+    Py_DECREF(shift);
+    if (hi != NULL)
+        result = PyNumber_Add(hi, lo);
+done:
+    Py_XDECREF(hi);
+    Py_XDECREF(lo);
+    return result;
+}
+
+#define DEFINE_SUM(code, type, wtype, FROM) \
+    static PyObject * \
+    code##_sum(const char *src, Py_ssize_t n) \
+    { \
+        const type *a = (const type *)src; \
+        PyObject *total, *part; \
+        Py_ssize_t i, end; \
+        total = PyLong_FromLong(0); \
+        for (i = 0; total != NULL && i < n; i = end) { \
+            wtype hi = 0, lo = 0; \
+            end = Py_MIN(n, i + ARRAY_SUM_BLOCK); \
+            if (sizeof(type) <= 4) { \
+                for (; i < end; i++) \
+                    lo += a[i]; \
+                part = FROM(lo); \
+            } \
+            else { \
+                for (; i < end; i++) { \
+                    hi += a[i] / ((wtype)1 << 32); \
+                    lo += a[i] % ((wtype)1 << 32); \
+                } \
+                part = array_sum_halves(FROM(hi), FROM(lo)); \
+            } \
+            if (part == NULL) { \
+                Py_CLEAR(total); \
+                break; \
+            } \
+            Py_SETREF(total, PyNumber_Add(total, part)); \
+            Py_DECREF(part); \
+        } \
+        return total; \
+    }
+
+#define DEFINE_FSUM(code, type) \
+    static PyObject * \
+    code##_sum(const char *src, Py_ssize_t n) \
+    { \
+        const type *a = (const type *)src; \
+        double s = 0.0; \
+        Py_ssize_t i; \
+        for (i = 0; i < n; i++) \
+            s += a[i]; \
+        return PyFloat_FromDouble(s); \
+    }
+
+/* Convert the n items at src to floats, or doubles if to_double is true */
+#define DEFINE_TOFLOAT(code, type) \
+    static void \
+    code##_tofloat(const char *src, Py_ssize_t n, char *dst, int to_double) \
+    { \
+        const type *a = (const type *)src; \
+        Py_ssize_t i; \
+        if (to_double) { \
+            double *d = (double *)dst; \
+            for (i = 0; i < n; i++) \
+                d[i] = (double)a[i]; \
+        } \
+        else { \
+            float *f = (float *)dst; \
+            for (i = 0; i < n; i++) \
+                f[i] = (float)a[i]; \
+        } \
+    }
+
+#define DEFINE_KERNELS(code, type, utype, wtype, FROM) \
+    DEFINE_ARITH(code, type, utype) \
+    DEFINE_MINMAX(code, type, FROM) \
+    DEFINE_SUM(code, type, wtype, FROM) \
+    DEFINE_TOFLOAT(code, type)
+
+DEFINE_KERNELS(b, signed char, unsigned int, long long, PyLong_FromLongLong)
+DEFINE_KERNELS(BB, unsigned char, unsigned int, unsigned long long, PyLong_FromUnsignedLongLong)
+DEFINE_KERNELS(h, short, unsigned int, long long, PyLong_FromLongLong)
+DEFINE_KERNELS(HH, unsigned short, unsigned int, unsigned long long, PyLong_FromUnsignedLongLong)
+DEFINE_KERNELS(i, int, unsigned int, long long, PyLong_FromLongLong)
+DEFINE_KERNELS(II, unsigned int, unsigned int, unsigned long long, PyLong_FromUnsignedLongLong)
+DEFINE_KERNELS(l, long, unsigned long, long long, PyLong_FromLongLong)
+DEFINE_KERNELS(LL, unsigned long, unsigned long, unsigned long long, PyLong_FromUnsignedLongLong)
+DEFINE_KERNELS(q, long long, unsigned long long, long long, PyLong_FromLongLong)
+DEFINE_KERNELS(QQ, unsigned long long, unsigned long long, unsigned long long, PyLong_FromUnsignedLongLong)
+
+DEFINE_ARITH(f, float, float)
+DEFINE_MINMAX(f, float, PyFloat_FromDouble)
+DEFINE_FSUM(f, float)
+DEFINE_TOFLOAT(f, float)
+DEFINE_ARITH(d, double, double)
+DEFINE_MINMAX(d, double, PyFloat_FromDouble)
+DEFINE_FSUM(d, double)
+DEFINE_TOFLOAT(d, double)
+
+#define ARRAY_KERNELS(code) \
+    code##_arith, code##_minmax, code##_sum, code##_tofloat
+
 /* Description of types.
  *
  * Don't forget to update typecode_to_mformat_code() if you add a new
  * typecode.
  */
 static const struct arraydescr descriptors[] = {
-    {'b', 1, b_getitem, b_setitem, b_compareitems, "b", 1, 1},
-    {'B', 1, BB_getitem, BB_setitem, BB_compareitems, "B", 1, 0},
+    {'b', 1, b_getitem, b_setitem, b_compareitems, "b", 1, 1,
+     ARRAY_KERNELS(b)},
+    {'B', 1, BB_getitem, BB_setitem, BB_compareitems, "B", 1, 0,
+     ARRAY_KERNELS(BB)},
     {'u', sizeof(Py_UNICODE), u_getitem, u_setitem, u_compareitems, "u", 0, 0},
-    {'h', sizeof(short), h_getitem, h_setitem, h_compareitems, "h", 1, 1},
-    {'H', sizeof(short), HH_getitem, HH_setitem, HH_compareitems, "H", 1, 0},
-    {'i', sizeof(int), i_getitem, i_setitem, i_compareitems, "i", 1, 1},
-    {'I', sizeof(int), II_getitem, II_setitem, II_compareitems, "I", 1, 0},
-    {'l', sizeof(long), l_getitem, l_setitem, l_compareitems, "l", 1, 1},
-    {'L', sizeof(long), LL_getitem, LL_setitem, LL_compareitems, "L", 1, 0},
-    {'q', sizeof(long long), q_getitem, q_setitem, q_compareitems, "q", 1, 1},
-    {'Q', sizeof(long long), QQ_getitem, QQ_setitem, QQ_compareitems, "Q", 1, 0},
-    {'f', sizeof(float), f_getitem, f_setitem, NULL, "f", 0, 0},
-    {'d', sizeof(double), d_getitem, d_setitem, NULL, "d", 0, 0},
+    {'h', sizeof(short), h_getitem, h_setitem, h_compareitems, "h", 1, 1,
+     ARRAY_KERNELS(h)},
+    {'H', sizeof(short), HH_getitem, HH_setitem, HH_compareitems, "H", 1, 0,
+     ARRAY_KERNELS(HH)},
+    {'i', sizeof(int), i_getitem, i_setitem, i_compareitems, "i", 1, 1,
+     ARRAY_KERNELS(i)},
+    {'I', sizeof(int), II_getitem, II_setitem, II_compareitems, "I", 1, 0,
+     ARRAY_KERNELS(II)},
+    {'l', sizeof(long), l_getitem, l_setitem, l_compareitems, "l", 1, 1,
+     ARRAY_KERNELS(l)},
+    {'L', sizeof(long), LL_getitem, LL_setitem, LL_compareitems, "L", 1, 0,
+     ARRAY_KERNELS(LL)},
+    {'q', sizeof(long long), q_getitem, q_setitem, q_compareitems, "q", 1, 1,
+     ARRAY_KERNELS(q)},
+    {'Q', sizeof(long long), QQ_getitem, QQ_setitem, QQ_compareitems, "Q", 1, 0,
+     ARRAY_KERNELS(QQ)},
+    {'f', sizeof(float), f_getitem, f_setitem, NULL, "f", 0, 0,
+     ARRAY_KERNELS(f)},
+    {'d', sizeof(double), d_getitem, d_setitem, NULL, "d", 0, 0,
+     ARRAY_KERNELS(d)},
     {'\0', 0, 0, 0, 0, 0, 0} /* Sentinel */
 };
 
@@ -1343,35 +1539,31 @@ array_array_byteswap_impl(arrayobject *self)
         break;
     case 2:
         for (p = self->ob_item, i = Py_SIZE(self); --i >= 0; p += 2) {
-            char p0 = p[0];
-            p[0] = p[1];
-            p[1] = p0;
+            uint16_t x;
+            memcpy(&x, p, 2);
+            x = (uint16_t)((x >> 8) | (x << 8));
+            memcpy(p, &x, 2);
         }
         break;
     case 4:
         for (p = self->ob_item, i = Py_SIZE(self); --i >= 0; p += 4) {
-            char p0 = p[0];
-            char p1 = p[1];
-            p[0] = p[3];
-            p[1] = p[2];
-            p[2] = p1;
-            p[3] = p0;
+            uint32_t x;
+            memcpy(&x, p, 4);
+            x = ((x >> 24) | ((x >> 8) & 0xff00U) |
+                 ((x << 8) & 0xff0000U) | (x << 24));
+            memcpy(p, &x, 4);
         }
         break;
     case 8:
         for (p = self->ob_item, i = Py_SIZE(self); --i >= 0; p += 8) {
-            char p0 = p[0];
-            char p1 = p[1];
-            char p2 = p[2];
-            char p3 = p[3];
-            p[0] = p[7];
-            p[1] = p[6];
-            p[2] = p[5];
-            p[3] = p[4];
-            p[4] = p3;
-            p[5] = p2;
-            p[6] = p1;
-            p[7] = p0;
+            uint64_t x;
+            memcpy(&x, p, 8);
+            x = ((x >> 56) | ((x >> 40) & 0xff00U) |
+                 ((x >> 24) & 0xff0000U) | ((x >> 8) & 0xff000000U) |
+                 ((x << 8) & 0xff00000000ULL) |
+                 ((x << 24) & 0xff0000000000ULL) |
+                 ((x << 40) & 0xff000000000000ULL) | (x << 56));
+            memcpy(p, &x, 8);
         }
         break;
     default:
@@ -1382,6 +1574,222 @@ array_array_byteswap_impl(arrayobject *self)
     Py_RETURN_NONE;
 }
 
+static PyObject *
+array_arith(arrayobject *self, PyObject *other, int op)
+{
+    const struct arraydescr *descr = self->ob_descr;
+    arrayobject *tmp = NULL;
+    const char *src;
+    int scalar;
+
+    if (descr->arith == NULL) {
+        PyErr_Format(PyExc_TypeError,
+                     "arithmetic is not supported for typecode '%c'",
+                     descr->typecode);
+        return NULL;
+    }
+    if (array_Check(other)) {
+        arrayobject *b = (arrayobject *)other;
+        if (b->ob_descr->typecode != descr->typecode) {
+            PyErr_SetString(PyExc_TypeError,
+                            "arrays must have the same typecode");
+            return NULL;
+        }
+        if (Py_SIZE(b) != Py_SIZE(self)) {
+            PyErr_SetString(PyExc_ValueError,
+                            "arrays must have the same length");
+            return NULL;
+        }
+        src = b->ob_item;
+        scalar = 0;
+    }
+    else {
+        /* Convert the number as an item of the array */
+        tmp = (arrayobject *)newarrayobject(&Arraytype, 1, descr);
+        if (tmp == NULL)
+            return NULL;
+        if (descr->setitem(tmp, 0, other) < 0) {
+            Py_DECREF(tmp);
+            return NULL;
+        }
+        src = tmp->ob_item;
+        scalar = 1;
+    }
+    if (Py_SIZE(self) > 0)
+        descr->arith(op, self->ob_item, src, Py_SIZE(self), scalar);
+    Py_XDECREF(tmp);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(array_add_doc,
+"add(x, /)\n\
+--\n\
+\n\
+Add x to the items of the array, in place.\n\
+\n\
+x is a number, or an array of the same typecode and length which is added\n\
+item by item.  Integer arithmetic wraps around on overflow.");
+
+static PyObject *
+array_array_add(arrayobject *self, PyObject *x)
+{
+    return array_arith(self, x, ARRAY_ADD);
+}
+
+PyDoc_STRVAR(array_sub_doc,
+"sub(x, /)\n\
+--\n\
+\n\
+Subtract x from the items of the array, in place.\n\
+\n\
+x is a number, or an array of the same typecode and length which is\n\
+subtracted item by item.  Integer arithmetic wraps around on overflow.");
+
+static PyObject *
+array_array_sub(arrayobject *self, PyObject *x)
+{
+    return array_arith(self, x, ARRAY_SUB);
+}
+
+PyDoc_STRVAR(array_mul_doc,
+"mul(x, /)\n\
+--\n\
+\n\
+Multiply the items of the array by x, in place.\n\
+\n\
+x is a number, or an array of the same typecode and length which\n\
+multiplies item by item.  Integer arithmetic wraps around on overflow.");
+
+static PyObject *
+array_array_mul(arrayobject *self, PyObject *x)
+{
+    return array_arith(self, x, ARRAY_MUL);
+}
+
+static PyObject *
+array_minmax(arrayobject *self, int want_max)
+{
+    if (self->ob_descr->minmax == NULL) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s() is not supported for typecode '%c'",
+                     want_max ? "max" : "min", self->ob_descr->typecode);
+        return NULL;
+    }
+    if (Py_SIZE(self) == 0) {
+        PyErr_Format(PyExc_ValueError, "%s() of an empty array",
+                     want_max ? "max" : "min");
+        return NULL;
+    }
+    return self->ob_descr->minmax(self->ob_item, Py_SIZE(self), want_max);
+}
+
+PyDoc_STRVAR(array_min_doc,
+"min($self, /)\n\
+--\n\
+\n\
+Return the smallest item of the array.");
+
+static PyObject *
+array_array_min(arrayobject *self, PyObject *Py_UNUSED(ignored))
+{
+    return array_minmax(self, 0);
+}
+
+PyDoc_STRVAR(array_max_doc,
+"max($self, /)\n\
+--\n\
+\n\
+Return the largest item of the array.");
+
+static PyObject *
+array_array_max(arrayobject *self, PyObject *Py_UNUSED(ignored))
+{
+    return array_minmax(self, 1);
+}
+
+PyDoc_STRVAR(array_sum_doc,
+"sum($self, /)\n\
+--\n\
+\n\
+Return the sum of the items of the array.\n\
+\n\
+The sum of integers is exact; floats are summed as C doubles.");
+
+static PyObject *
+array_array_sum(arrayobject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (self->ob_descr->sum == NULL) {
+        PyErr_Format(PyExc_TypeError,
+                     "sum() is not supported for typecode '%c'",
+                     self->ob_descr->typecode);
+        return NULL;
+    }
+    return self->ob_descr->sum(self->ob_item, Py_SIZE(self));
+}
+
+PyDoc_STRVAR(array_astype_doc,
+"astype(typecode, /)\n\
+--\n\
+\n\
+Return a new array holding the items converted to typecode.\n\
+\n\
+Items are converted as by the array constructor: OverflowError is raised\n\
+for an integer out of the range of typecode, and TypeError for a float\n\
+converted to an integer typecode.");
+
+static PyObject *
+array_array_astype(arrayobject *self, PyObject *arg)
+{
+    const struct arraydescr *descr, *src = self->ob_descr;
+    arrayobject *np;
+    Py_ssize_t i, n = Py_SIZE(self);
+    int c;
+
+    if (!PyArg_Parse(arg, "C;astype() argument must be a unicode character",
+                     &c))
+        return NULL;
+    for (descr = descriptors; descr->typecode != '\0'; descr++) {
+        if (descr->typecode == c)
+            break;
+    }
+    if (descr->typecode == '\0') {
+        PyErr_SetString(PyExc_ValueError,
+                        "bad typecode (must be b, B, u, h, H, i, I, l, L, "
+                        "q, Q, f or d)");
+        return NULL;
+    }
+
+    np = (arrayobject *)newarrayobject(&Arraytype, n, descr);
+    if (np == NULL)
+        return NULL;
+    if (n == 0)
+        return (PyObject *)np;
+
+    if (descr == src ||
+        (src->is_integer_type && descr->is_integer_type &&
+         src->is_signed == descr->is_signed &&
+         src->itemsize == descr->itemsize)) {
+        /* Same representation */
+        memcpy(np->ob_item, self->ob_item, n * src->itemsize);
+    }
+    else if ((descr->typecode == 'f' || descr->typecode == 'd') &&
+             src->tofloat != NULL) {
+        src->tofloat(self->ob_item, n, np->ob_item, descr->typecode == 'd');
+    }
+    else {
+        for (i = 0; i < n; i++) {
+            PyObject *v = src->getitem(self, i);
+            if (v == NULL || descr->setitem(np, i, v) < 0) {
+                Py_XDECREF(v);
+                Py_DECREF(np);
+                return NULL;
+            }
+            Py_DECREF(v);
+        }
+    }
+    return (PyObject *)np;
+}
+
 /*[clinic input]
 array.array.reverse
 
@@ -2300,6 +2708,13 @@ static PyMethodDef array_methods[] = {
     ARRAY_ARRAY_TOBYTES_METHODDEF
     ARRAY_ARRAY_TOUNICODE_METHODDEF
     ARRAY_ARRAY___SIZEOF___METHODDEF
+    {"add", (PyCFunction)array_array_add, METH_O, array_add_doc},
+    {"sub", (PyCFunction)array_array_sub, METH_O, array_sub_doc},
+    {"mul", (PyCFunction)array_array_mul, METH_O, array_mul_doc},
+    {"sum", (PyCFunction)array_array_sum, METH_NOARGS, array_sum_doc},
+    {"min", (PyCFunction)array_array_min, METH_NOARGS, array_min_doc},
+    {"max", (PyCFunction)array_array_max, METH_NOARGS, array_max_doc},
+    {"astype", (PyCFunction)array_array_astype, METH_O, array_astype_doc},
     {NULL, NULL}  /* sentinel */
 };
 
@@ -2803,7 +3218,9 @@ C compiler used to build Python supports 'long long', or, on Windows, \n\
 \n\
 Methods:\n\
 \n\
+add() -- add a number or an array to the items, in place\n\
 append() -- append a new item to the end of the array\n\
+astype() -- return the array converted to another typecode\n\
 buffer_info() -- return information giving the current memory info\n\
 byteswap() -- byteswap all the items of the array\n\
 count() -- return number of occurrences of an object\n\
@@ -2813,9 +3230,14 @@ fromlist() -- append items from the list\n\
 frombytes() -- append items from the string\n\
 index() -- return index of first occurrence of an object\n\
 insert() -- insert a new item into the array at a provided position\n\
+max() -- return the largest item\n\
+min() -- return the smallest item\n\
+mul() -- multiply the items by a number or an array, in place\n\
 pop() -- remove and return item (default last)\n\
 remove() -- remove first occurrence of an object\n\
 reverse() -- reverse the order of the items in the array\n\
+sub() -- subtract a number or an array from the items, in place\n\
+sum() -- return the sum of the items\n\
 tofile() -- write all items to a file object\n\
 tolist() -- return the array converted to an ordinary list\n\
 tobytes() -- return the array converted to a string\n\
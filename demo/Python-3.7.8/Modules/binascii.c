@@ -465,6 +465,35 @@ binascii_a2b_base64_impl(PyObject *module, Py_buffer *data)
     bin_data_start = bin_data;
 
     for( ; ascii_len > 0; ascii_len--, ascii_data++) {
+        /* Decode runs of whole quads of valid characters four at a time;
+        ** anything else goes through the character loop below.
+        */
+        while (quad_pos == 0 && ascii_len >= 4) {
+            unsigned char c0 = ascii_data[0], c1 = ascii_data[1];
+            unsigned char c2 = ascii_data[2], c3 = ascii_data[3];
+            unsigned int v0, v1, v2, v3, quad;
+
+            if ((c0 | c1 | c2 | c3) > 0x7f ||
+                c2 == BASE64_PAD || c3 == BASE64_PAD)
+                break;
+            v0 = (unsigned char)table_a2b_base64[c0];
+            v1 = (unsigned char)table_a2b_base64[c1];
+            v2 = (unsigned char)table_a2b_base64[c2];
+            v3 = (unsigned char)table_a2b_base64[c3];
+            if ((v0 | v1 | v2 | v3) > 0x3f ||
+                c0 == BASE64_PAD || c1 == BASE64_PAD)
+                break;
+            quad = (v0 << 18) | (v1 << 12) | (v2 << 6) | v3;
+            bin_data[0] = (quad >> 16) & 0xff;
+            bin_data[1] = (quad >> 8) & 0xff;
+            bin_data[2] = quad & 0xff;
+            bin_data += 3;
+            ascii_data += 4;
+            ascii_len -= 4;
+        }
+        if (ascii_len == 0)
+            break;
+
         this_ch = *ascii_data;
 
         if (this_ch > 0x7f ||
@@ -568,16 +597,27 @@ binascii_b2a_base64_impl(PyObject *module, Py_buffer *data, int newline)
         return NULL;
     }
 
-    /* We're lazy and allocate too much (fixed up later).
-       "+2" leaves room for up to two pad characters.
-       Note that 'b' gets encoded as 'Yg==\n' (1 in, 5 out). */
-    out_len = bin_len*2 + 2;
+    /* Every started group of three bytes becomes four characters,
+       the last one padded. Note that 'b' gets encoded as 'Yg==\n'
+       (1 in, 5 out). */
+    out_len = (bin_len + 2) / 3 * 4;
     if (newline)
         out_len++;
     ascii_data = _PyBytesWriter_Alloc(&writer, out_len);
     if (ascii_data == NULL)
         return NULL;
 
+    /* Encode the whole groups of three bytes */
+    for( ; bin_len >= 3 ; bin_len -= 3, bin_data += 3 ) {
+        leftchar = (bin_data[0] << 16) | (bin_data[1] << 8) | bin_data[2];
+        ascii_data[0] = table_b2a_base64[(leftchar >> 18) & 0x3f];
+        ascii_data[1] = table_b2a_base64[(leftchar >> 12) & 0x3f];
+        ascii_data[2] = table_b2a_base64[(leftchar >> 6) & 0x3f];
+        ascii_data[3] = table_b2a_base64[leftchar & 0x3f];
+        ascii_data += 4;
+    }
+    leftchar = 0;
+
     for( ; bin_len > 0 ; bin_len--, bin_data++ ) {
         /* Shift the data into our buffer */
         leftchar = (leftchar << 8) | *bin_data;
@@ -1088,7 +1128,24 @@ binascii_crc32_impl(PyObject *module, Py_buffer *data, unsigned int crc)
 
     buf = (Byte*)data->buf;
     len = data->len;
-    signed_val = crc32(crc, buf, len);
+
+    /* Releasing the GIL for very small buffers is inefficient
+       and may lower performance */
+    if (len > 1024*5) {
+        Py_BEGIN_ALLOW_THREADS
+        /* crc32() takes the length as an unsigned int, which may be
+           narrower than Py_ssize_t. */
+        while ((size_t)len > UINT_MAX) {
+            crc = crc32(crc, buf, UINT_MAX);
+            buf += (size_t) UINT_MAX;
+            len -= (size_t) UINT_MAX;
+        }
+        signed_val = crc32(crc, buf, (unsigned int)len);
+        Py_END_ALLOW_THREADS
+    }
+    else {
+        signed_val = crc32(crc, buf, (unsigned int)len);
+    }
     return (unsigned int)signed_val & 0xffffffffU;
 }
 #else  /* USE_ZLIB_CRC32 */
@@ -1145,19 +1202,18 @@ binascii_hexlify_impl(PyObject *module, Py_buffer *data)
     return _Py_strhex_bytes((const char *)data->buf, data->len);
 }
 
-static int
-to_int(int c)
-{
-    if (Py_ISDIGIT(c))
-        return c - '0';
-    else {
-        if (Py_ISUPPER(c))
-            c = Py_TOLOWER(c);
-        if (c >= 'a' && c <= 'f')
-            return c - 'a' + 10;
-    }
-    return -1;
-}
+static const int table_hex[128] = {
+  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+   0, 1, 2, 3,  4, 5, 6, 7,  8, 9,-1,-1, -1,-1,-1,-1,
+  -1,10,11,12, 13,14,15,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+  -1,10,11,12, 13,14,15,-1, -1,-1,-1,-1, -1,-1,-1,-1,
+  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1
+};
+
+#define hexval(c) table_hex[(unsigned int)(c)]
 
 
 /*[clinic input]
@@ -1202,8 +1258,10 @@ binascii_a2b_hex_impl(PyObject *module, Py_buffer *hexstr)
     retbuf = PyBytes_AS_STRING(retval);
 
     for (i=j=0; i < arglen; i += 2) {
-        int top = to_int(Py_CHARMASK(argbuf[i]));
-        int bot = to_int(Py_CHARMASK(argbuf[i+1]));
+        unsigned int c0 = Py_CHARMASK(argbuf[i]);
+        unsigned int c1 = Py_CHARMASK(argbuf[i+1]);
+        int top = (c0 | c1) < 128 ? hexval(c0) : -1;
+        int bot = (c0 | c1) < 128 ? hexval(c1) : -1;
         if (top == -1 || bot == -1) {
             PyErr_SetString(Error,
                             "Non-hexadecimal digit found");
@@ -1233,19 +1291,6 @@ binascii_unhexlify_impl(PyObject *module, Py_buffer *hexstr)
     return binascii_a2b_hex_impl(module, hexstr);
 }
 
-static const int table_hex[128] = {
-  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-   0, 1, 2, 3,  4, 5, 6, 7,  8, 9,-1,-1, -1,-1,-1,-1,
-  -1,10,11,12, 13,14,15,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-  -1,10,11,12, 13,14,15,-1, -1,-1,-1,-1, -1,-1,-1,-1,
-  -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1
-};
-
-#define hexval(c) table_hex[(unsigned int)(c)]
-
 #define MAXLINESIZE 76
 
 
@@ -24,6 +24,8 @@
       SIGILL can be handled by the process, and these signals can only be used
       with enable(), not using register() */
 #  define FAULTHANDLER_USER
+   /* the stall watchdog captures tracebacks through a non-blocking pipe */
+#  define FAULTHANDLER_WATCHDOG
 #endif
 
 #define PUTS(fd, str) _Py_write_noraise(fd, str, strlen(str))
@@ -77,6 +79,40 @@ static struct {
 } thread;
 #endif
 
+#ifdef FAULTHANDLER_WATCHDOG
+/* Size of the traceback text kept for each stall report */
+#define WATCHDOG_REPORT_SIZE (8 * 1024)
+/* Stall durations are counted in buckets of timeout * 2**i */
+#define WATCHDOG_HISTOGRAM_SIZE 8
+
+typedef struct {
+    /* Odd while the watchdog thread writes the report: readers retry
+       instead of taking a lock */
+    _Py_atomic_int seq;
+    _PyTime_t start;        /* monotonic clock of the last heartbeat */
+    _PyTime_t duration;     /* grows until the next heartbeat */
+    size_t len;
+    char text[WATCHDOG_REPORT_SIZE];
+} watchdog_report_t;
+
+static struct {
+    int enabled;
+    PY_TIMEOUT_T timeout_us;   /* timeout in microseconds */
+    PyInterpreterState *interp;
+    /* incremented by heartbeat(), only compared by the watchdog thread */
+    _Py_atomic_int heartbeat;
+    /* tracebacks are written to the pipe and read back into a report */
+    int pipe_fds[2];
+    watchdog_report_t *reports;   /* ring buffer of capacity reports */
+    Py_ssize_t capacity;
+    _Py_atomic_int nreports;      /* number of reports ever written */
+    _Py_atomic_int histogram[WATCHDOG_HISTOGRAM_SIZE];
+    /* same protocol as the thread.cancel_event and thread.running locks */
+    PyThread_type_lock cancel_event;
+    PyThread_type_lock running;
+} watchdog = {0, 0, NULL, {0}, {-1, -1}};
+#endif
+
 #ifdef FAULTHANDLER_USER
 typedef struct {
     int enabled;
@@ -725,6 +761,357 @@ faulthandler_cancel_dump_traceback_later_py(PyObject *self)
 }
 #endif  /* FAULTHANDLER_LATER */
 
+#ifdef FAULTHANDLER_WATCHDOG
+static Py_ssize_t
+watchdog_bucket(_PyTime_t duration)
+{
+    _PyTime_t bound = (_PyTime_t)watchdog.timeout_us * 1000 * 2;
+    Py_ssize_t i;
+
+    for (i = 0; i < WATCHDOG_HISTOGRAM_SIZE - 1; i++) {
+        if (duration < bound)
+            break;
+        bound *= 2;
+    }
+    return i;
+}
+
+/* Dump the tracebacks of all threads into the next slot of the ring
+   buffer. Called by the watchdog thread, without the GIL. */
+static watchdog_report_t*
+watchdog_record(_PyTime_t start, _PyTime_t now)
+{
+    int n = _Py_atomic_load_relaxed(&watchdog.nreports);
+    watchdog_report_t *report = &watchdog.reports[n % watchdog.capacity];
+    int seq = _Py_atomic_load_relaxed(&report->seq);
+    size_t len = 0;
+    Py_ssize_t res;
+    char discard[512];
+
+    _Py_atomic_store_relaxed(&report->seq, seq + 1);
+    _Py_atomic_thread_fence(_Py_memory_order_release);
+
+    report->start = start;
+    report->duration = now - start;
+    /* The pipe is non-blocking: a traceback larger than the pipe buffer is
+       truncated instead of blocking the watchdog */
+    _Py_DumpTracebackThreads(watchdog.pipe_fds[1], watchdog.interp, NULL);
+    while (len < sizeof(report->text)) {
+        res = read(watchdog.pipe_fds[0], report->text + len,
+                   sizeof(report->text) - len);
+        if (res <= 0)
+            break;
+        len += res;
+    }
+    while (read(watchdog.pipe_fds[0], discard, sizeof(discard)) > 0)
+        ;
+    report->len = len;
+
+    _Py_atomic_store_explicit(&report->seq, seq + 2,
+                              _Py_memory_order_release);
+    _Py_atomic_store_relaxed(&watchdog.nreports, n + 1);
+    return report;
+}
+
+static void
+watchdog_update(watchdog_report_t *report, _PyTime_t now)
+{
+    int seq = _Py_atomic_load_relaxed(&report->seq);
+
+    _Py_atomic_store_relaxed(&report->seq, seq + 1);
+    _Py_atomic_thread_fence(_Py_memory_order_release);
+    report->duration = now - report->start;
+    _Py_atomic_store_explicit(&report->seq, seq + 2,
+                              _Py_memory_order_release);
+}
+
+static void
+watchdog_stall_end(watchdog_report_t *report, _PyTime_t now)
+{
+    _Py_atomic_int *bucket;
+
+    watchdog_update(report, now);
+    bucket = &watchdog.histogram[watchdog_bucket(report->duration)];
+    _Py_atomic_store_relaxed(bucket, _Py_atomic_load_relaxed(bucket) + 1);
+}
+
+static void
+faulthandler_watchdog_thread(void *unused)
+{
+    PyLockStatus st;
+    PY_TIMEOUT_T interval;
+    _PyTime_t timeout, last_beat_time, now;
+    int last_beat, beat;
+    watchdog_report_t *stall = NULL;
+#if defined(HAVE_PTHREAD_SIGMASK) && !defined(HAVE_BROKEN_PTHREAD_SIGMASK)
+    sigset_t set;
+
+    /* we don't want to receive any signal */
+    sigfillset(&set);
+    pthread_sigmask(SIG_SETMASK, &set, NULL);
+#endif
+
+    /* Poll a few times per timeout so that a stall is reported at most
+       25% late */
+    interval = Py_MAX(watchdog.timeout_us / 4, 1000);
+    timeout = (_PyTime_t)watchdog.timeout_us * 1000;
+    last_beat = _Py_atomic_load_relaxed(&watchdog.heartbeat);
+    last_beat_time = _PyTime_GetMonotonicClock();
+
+    while (1) {
+        st = PyThread_acquire_lock_timed(watchdog.cancel_event, interval, 0);
+        if (st == PY_LOCK_ACQUIRED) {
+            PyThread_release_lock(watchdog.cancel_event);
+            break;
+        }
+        assert(st == PY_LOCK_FAILURE);
+
+        now = _PyTime_GetMonotonicClock();
+        beat = _Py_atomic_load_relaxed(&watchdog.heartbeat);
+        if (beat != last_beat) {
+            if (stall != NULL) {
+                watchdog_stall_end(stall, now);
+                stall = NULL;
+            }
+            last_beat = beat;
+            last_beat_time = now;
+        }
+        else if (stall != NULL) {
+            watchdog_update(stall, now);
+        }
+        else if (now - last_beat_time >= timeout) {
+            stall = watchdog_record(last_beat_time, now);
+        }
+    }
+    if (stall != NULL)
+        watchdog_stall_end(stall, _PyTime_GetMonotonicClock());
+
+    /* The only way out */
+    PyThread_release_lock(watchdog.running);
+}
+
+static void
+disable_stall_watchdog(void)
+{
+    if (!watchdog.enabled)
+        return;
+
+    /* Notify cancellation and wait for thread to join */
+    PyThread_release_lock(watchdog.cancel_event);
+    PyThread_acquire_lock(watchdog.running, 1);
+    PyThread_release_lock(watchdog.running);
+    PyThread_acquire_lock(watchdog.cancel_event, 1);
+
+    watchdog.enabled = 0;
+    close(watchdog.pipe_fds[0]);
+    close(watchdog.pipe_fds[1]);
+    watchdog.pipe_fds[0] = watchdog.pipe_fds[1] = -1;
+    PyMem_Free(watchdog.reports);
+    watchdog.reports = NULL;
+}
+
+static PyObject*
+faulthandler_enable_stall_watchdog(PyObject *self,
+                                   PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"timeout", "capacity", NULL};
+    PyObject *timeout_obj;
+    _PyTime_t timeout, timeout_us;
+    Py_ssize_t capacity = 16, i;
+    PyThreadState *tstate;
+    watchdog_report_t *reports;
+    int fds[2];
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+        "O|n:enable_stall_watchdog", kwlist,
+        &timeout_obj, &capacity))
+        return NULL;
+
+    if (_PyTime_FromSecondsObject(&timeout, timeout_obj,
+                                  _PyTime_ROUND_TIMEOUT) < 0) {
+        return NULL;
+    }
+    timeout_us = _PyTime_AsMicroseconds(timeout, _PyTime_ROUND_TIMEOUT);
+    if (timeout_us <= 0) {
+        PyErr_SetString(PyExc_ValueError, "timeout must be greater than 0");
+        return NULL;
+    }
+    /* the histogram bounds are timeout * 2**WATCHDOG_HISTOGRAM_SIZE ns */
+    if (timeout_us >= PY_TIMEOUT_MAX
+        || timeout_us >= (_PyTime_MAX / 1000) >> WATCHDOG_HISTOGRAM_SIZE) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "timeout value is too large");
+        return NULL;
+    }
+    if (capacity <= 0 || capacity > INT_MAX / 2) {
+        PyErr_SetString(PyExc_ValueError, "invalid capacity");
+        return NULL;
+    }
+
+    tstate = get_thread_state();
+    if (tstate == NULL)
+        return NULL;
+
+    reports = PyMem_Calloc(capacity, sizeof(watchdog_report_t));
+    if (reports == NULL)
+        return PyErr_NoMemory();
+    if (pipe(fds) < 0) {
+        PyMem_Free(reports);
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    if (_Py_set_inheritable(fds[0], 0, NULL) < 0
+        || _Py_set_inheritable(fds[1], 0, NULL) < 0
+        || _Py_set_blocking(fds[0], 0) < 0
+        || _Py_set_blocking(fds[1], 0) < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        PyMem_Free(reports);
+        return NULL;
+    }
+
+    /* Stop the previous watchdog, if running */
+    disable_stall_watchdog();
+
+    watchdog.timeout_us = (PY_TIMEOUT_T)timeout_us;
+    watchdog.interp = tstate->interp;
+    watchdog.pipe_fds[0] = fds[0];
+    watchdog.pipe_fds[1] = fds[1];
+    watchdog.reports = reports;
+    watchdog.capacity = capacity;
+    _Py_atomic_store_relaxed(&watchdog.nreports, 0);
+    for (i = 0; i < WATCHDOG_HISTOGRAM_SIZE; i++)
+        _Py_atomic_store_relaxed(&watchdog.histogram[i], 0);
+
+    /* Arm these locks to serve as events when released */
+    PyThread_acquire_lock(watchdog.running, 1);
+
+    if (PyThread_start_new_thread(faulthandler_watchdog_thread, NULL)
+        == PYTHREAD_INVALID_THREAD_ID) {
+        PyThread_release_lock(watchdog.running);
+        close(fds[0]);
+        close(fds[1]);
+        watchdog.pipe_fds[0] = watchdog.pipe_fds[1] = -1;
+        PyMem_Free(reports);
+        watchdog.reports = NULL;
+        PyErr_SetString(PyExc_RuntimeError,
+                        "unable to start watchdog thread");
+        return NULL;
+    }
+    watchdog.enabled = 1;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+faulthandler_disable_stall_watchdog_py(PyObject *self)
+{
+    if (!watchdog.enabled) {
+        Py_RETURN_FALSE;
+    }
+    disable_stall_watchdog();
+    Py_RETURN_TRUE;
+}
+
+static PyObject*
+faulthandler_heartbeat(PyObject *self)
+{
+    _Py_atomic_store_relaxed(&watchdog.heartbeat,
+                             _Py_atomic_load_relaxed(&watchdog.heartbeat) + 1);
+    Py_RETURN_NONE;
+}
+
+/* Copy a report written concurrently by the watchdog thread. Return 0 if
+   the slot keeps changing under us. */
+static int
+watchdog_read_report(watchdog_report_t *report, watchdog_report_t *copy)
+{
+    int attempt, seq;
+
+    for (attempt = 0; attempt < 100; attempt++) {
+        seq = _Py_atomic_load_explicit(&report->seq,
+                                       _Py_memory_order_acquire);
+        if (seq & 1)
+            continue;
+        copy->start = report->start;
+        copy->duration = report->duration;
+        copy->len = Py_MIN(report->len, sizeof(copy->text));
+        memcpy(copy->text, report->text, copy->len);
+        _Py_atomic_thread_fence(_Py_memory_order_acquire);
+        if (_Py_atomic_load_relaxed(&report->seq) == seq)
+            return 1;
+    }
+    return 0;
+}
+
+static PyObject*
+faulthandler_stall_reports(PyObject *self)
+{
+    PyObject *list, *item;
+    watchdog_report_t *copy;
+    int n, first, i;
+
+    list = PyList_New(0);
+    if (list == NULL || !watchdog.enabled)
+        return list;
+
+    copy = PyMem_Malloc(sizeof(watchdog_report_t));
+    if (copy == NULL) {
+        Py_DECREF(list);
+        return PyErr_NoMemory();
+    }
+    n = _Py_atomic_load_explicit(&watchdog.nreports,
+                                 _Py_memory_order_acquire);
+    first = (int)Py_MAX(n - watchdog.capacity, 0);
+    for (i = first; i < n; i++) {
+        if (!watchdog_read_report(&watchdog.reports[i % watchdog.capacity],
+                                  copy))
+            continue;
+        item = Py_BuildValue("(ddN)",
+            _PyTime_AsSecondsDouble(copy->start),
+            _PyTime_AsSecondsDouble(copy->duration),
+            PyUnicode_DecodeUTF8(copy->text, copy->len, "backslashreplace"));
+        if (item == NULL || PyList_Append(list, item) < 0) {
+            Py_XDECREF(item);
+            Py_CLEAR(list);
+            break;
+        }
+        Py_DECREF(item);
+    }
+    PyMem_Free(copy);
+    return list;
+}
+
+static PyObject*
+faulthandler_stall_histogram(PyObject *self)
+{
+    PyObject *list, *item;
+    double bound;
+    Py_ssize_t i;
+
+    list = PyList_New(WATCHDOG_HISTOGRAM_SIZE);
+    if (list == NULL)
+        return NULL;
+    bound = (double)watchdog.timeout_us * 2 / SEC_TO_US;
+    for (i = 0; i < WATCHDOG_HISTOGRAM_SIZE; i++) {
+        if (i == WATCHDOG_HISTOGRAM_SIZE - 1) {
+            item = Py_BuildValue("(Oi)", Py_None,
+                _Py_atomic_load_relaxed(&watchdog.histogram[i]));
+        }
+        else {
+            item = Py_BuildValue("(di)", bound,
+                _Py_atomic_load_relaxed(&watchdog.histogram[i]));
+        }
+        if (item == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+        bound *= 2;
+    }
+    return list;
+}
+#endif  /* FAULTHANDLER_WATCHDOG */
+
 #ifdef FAULTHANDLER_USER
 static int
 faulthandler_register(int signum, int chain, _Py_sighandler_t *p_previous)
@@ -1207,6 +1594,30 @@ static PyMethodDef module_methods[] = {
      PyDoc_STR("cancel_dump_traceback_later():\ncancel the previous call "
                "to dump_traceback_later().")},
 #endif
+#ifdef FAULTHANDLER_WATCHDOG
+    {"enable_stall_watchdog",
+     (PyCFunction)faulthandler_enable_stall_watchdog, METH_VARARGS|METH_KEYWORDS,
+     PyDoc_STR("enable_stall_watchdog(timeout, capacity=16):\n"
+               "start a thread recording the traceback of all threads when "
+               "heartbeat() is not called for timeout seconds. The last "
+               "capacity reports are kept.")},
+    {"disable_stall_watchdog",
+     (PyCFunction)faulthandler_disable_stall_watchdog_py, METH_NOARGS,
+     PyDoc_STR("disable_stall_watchdog(): stop the stall watchdog and "
+               "discard its reports")},
+    {"heartbeat",
+     (PyCFunction)faulthandler_heartbeat, METH_NOARGS,
+     PyDoc_STR("heartbeat(): tell the stall watchdog that the program "
+               "is making progress")},
+    {"stall_reports",
+     (PyCFunction)faulthandler_stall_reports, METH_NOARGS,
+     PyDoc_STR("stall_reports(): list of (start, duration, traceback) "
+               "tuples of the last stalls, oldest first")},
+    {"stall_histogram",
+     (PyCFunction)faulthandler_stall_histogram, METH_NOARGS,
+     PyDoc_STR("stall_histogram(): list of (upper_bound, count) tuples of "
+               "the durations of the finished stalls")},
+#endif
 
 #ifdef FAULTHANDLER_USER
     {"register",
@@ -1352,6 +1763,14 @@ _PyFaulthandler_Init(int enable)
     }
     PyThread_acquire_lock(thread.cancel_event, 1);
 #endif
+#ifdef FAULTHANDLER_WATCHDOG
+    watchdog.cancel_event = PyThread_allocate_lock();
+    watchdog.running = PyThread_allocate_lock();
+    if (!watchdog.cancel_event || !watchdog.running) {
+        return _Py_INIT_ERR("failed to allocate locks for faulthandler");
+    }
+    PyThread_acquire_lock(watchdog.cancel_event, 1);
+#endif
 
     if (enable) {
         if (faulthandler_init_enable() < 0) {
@@ -1376,6 +1795,19 @@ void _PyFaulthandler_Fini(void)
         thread.running = NULL;
     }
 #endif
+#ifdef FAULTHANDLER_WATCHDOG
+    /* stall watchdog */
+    if (watchdog.cancel_event) {
+        disable_stall_watchdog();
+        PyThread_release_lock(watchdog.cancel_event);
+        PyThread_free_lock(watchdog.cancel_event);
+        watchdog.cancel_event = NULL;
+    }
+    if (watchdog.running) {
+        PyThread_free_lock(watchdog.running);
+        watchdog.running = NULL;
+    }
+#endif
 
 #ifdef FAULTHANDLER_USER
     /* user */
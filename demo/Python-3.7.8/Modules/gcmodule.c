@@ -56,6 +56,64 @@ static PyObject *gc_str = NULL;
 
 #define GEN_HEAD(n) (&_PyRuntime.gc.generations[n].head)
 
+/* The state of incremental collection of the oldest generation.  See
+   collect_increment(). */
+static struct {
+    int enabled;            /* automatic collections are incremental? */
+    Py_ssize_t budget;      /* default number of objects in an increment */
+    Py_ssize_t remaining;   /* objects left to visit in the current pass */
+    Py_ssize_t closure_left;    /* objects that may still be added to the
+                                   current increment */
+    Py_ssize_t increments;  /* number of increments collected */
+    Py_ssize_t passes;      /* number of passes completed */
+} incremental = {0, 10000, 0, 0, 0, 0};
+
+/* The phases of a collection that are timed.  See gc_get_phase_stats(). */
+enum {
+    PHASE_UPDATE_REFS,
+    PHASE_SUBTRACT_REFS,
+    PHASE_MOVE_UNREACHABLE,
+    PHASE_HANDLE_WEAKREFS,
+    PHASE_FINALIZE_GARBAGE,
+    PHASE_DELETE_GARBAGE,
+    PHASE_TOTAL,
+    NUM_PHASES
+};
+
+static const char * const phase_names[NUM_PHASES] = {
+    "update_refs",
+    "subtract_refs",
+    "move_unreachable",
+    "handle_weakrefs",
+    "finalize_garbage",
+    "delete_garbage",
+    "total"
+};
+
+/* The upper bound of histogram bucket i is 2**i microseconds, except for
+   the last bucket which is unbounded. */
+#define NUM_BUCKETS 24
+
+struct gc_phase_stats {
+    Py_ssize_t count;
+    _PyTime_t total;
+    _PyTime_t max;
+    Py_ssize_t histogram[NUM_BUCKETS];
+};
+
+static struct {
+    struct gc_phase_stats phases[NUM_GENERATIONS][NUM_PHASES];
+    Py_ssize_t allocations;         /* objects allocated since the last
+                                       collection */
+    Py_ssize_t last_allocations;    /* objects allocated between the last
+                                       two collections */
+    _PyTime_t last_collection;      /* when the last collection ended */
+    _PyTime_t last_interval;        /* time between the last two
+                                       collections */
+    PyObject *type_counts;          /* {type name: count} of unreachable
+                                       objects, or NULL if not counted */
+} phase_stats;
+
 void
 _PyGC_Initialize(struct _gc_runtime_state *state)
 {
@@ -791,58 +849,87 @@ clear_freelists(void)
     (void)PyContext_ClearFreeList();
 }
 
-/* This is the main function.  Read this to understand how the
- * collection process works. */
-static Py_ssize_t
-collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
-        int nofail)
+/* Add the time since start to the stats of a phase of a collection of a
+ * generation and return the current time.
+ */
+static _PyTime_t
+record_phase(int generation, int phase, _PyTime_t start)
 {
-    int i;
-    Py_ssize_t m = 0; /* # objects collected */
-    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
-    PyGC_Head *young; /* the generation we are examining */
-    PyGC_Head *old; /* next older generation */
-    PyGC_Head unreachable; /* non-problematic unreachable trash */
-    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
-    PyGC_Head *gc;
-    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
+    _PyTime_t now = _PyTime_GetMonotonicClock();
+    _PyTime_t elapsed = now - start;
+    _PyTime_t us = _PyTime_AsMicroseconds(elapsed, _PyTime_ROUND_CEILING);
+    struct gc_phase_stats *ps = &phase_stats.phases[generation][phase];
+    int bucket;
 
-    struct gc_generation_stats *stats = &_PyRuntime.gc.generation_stats[generation];
+    for (bucket = 0; bucket < NUM_BUCKETS - 1; bucket++) {
+        if (us <= ((_PyTime_t)1 << bucket))
+            break;
+    }
+    ps->count++;
+    ps->total += elapsed;
+    if (elapsed > ps->max)
+        ps->max = elapsed;
+    ps->histogram[bucket]++;
 
-    if (_PyRuntime.gc.debug & DEBUG_STATS) {
-        PySys_WriteStderr("gc: collecting generation %d...\n",
-                          generation);
-        PySys_WriteStderr("gc: objects in each generation:");
-        for (i = 0; i < NUM_GENERATIONS; i++)
-            PySys_FormatStderr(" %zd",
-                              gc_list_size(GEN_HEAD(i)));
-        PySys_WriteStderr("\ngc: objects in permanent generation: %zd",
-                         gc_list_size(&_PyRuntime.gc.permanent_generation.head));
-        t1 = _PyTime_GetMonotonicClock();
+    if (PyDTrace_GC_PHASE_ENABLED())
+        PyDTrace_GC_PHASE(generation, phase_names[phase], (long)us);
 
-        PySys_WriteStderr("\n");
-    }
+    return now;
+}
 
-    if (PyDTrace_GC_START_ENABLED())
-        PyDTrace_GC_START(generation);
+/* Count the objects in a list by type.  Counting is stopped if there is an
+ * error.
+ */
+static void
+count_types(PyGC_Head *list)
+{
+    PyGC_Head *gc;
 
-    /* update collection and allocation counters */
-    if (generation+1 < NUM_GENERATIONS)
-        _PyRuntime.gc.generations[generation+1].count += 1;
-    for (i = 0; i <= generation; i++)
-        _PyRuntime.gc.generations[i].count = 0;
+    for (gc = list->gc.gc_next; gc != list; gc = gc->gc.gc_next) {
+        PyObject *name, *count;
+        Py_ssize_t n = 1;
+        int err;
 
-    /* merge younger generations with one we are currently collecting */
-    for (i = 0; i < generation; i++) {
-        gc_list_merge(GEN_HEAD(i), GEN_HEAD(generation));
+        name = PyUnicode_FromString(Py_TYPE(FROM_GC(gc))->tp_name);
+        if (name == NULL)
+            goto error;
+        count = PyDict_GetItem(phase_stats.type_counts, name);
+        if (count != NULL)
+            n += PyLong_AsSsize_t(count);
+        count = PyLong_FromSsize_t(n);
+        if (count == NULL) {
+            Py_DECREF(name);
+            goto error;
+        }
+        err = PyDict_SetItem(phase_stats.type_counts, name, count);
+        Py_DECREF(name);
+        Py_DECREF(count);
+        if (err != 0)
+            goto error;
     }
+    return;
 
-    /* handy references */
-    young = GEN_HEAD(generation);
-    if (generation < NUM_GENERATIONS-1)
-        old = GEN_HEAD(generation+1);
-    else
-        old = young;
+error:
+    PyErr_Clear();
+    Py_CLEAR(phase_stats.type_counts);
+}
+
+/* Collect the objects in young, moving those that survive to old.  Return
+ * the number of objects collected and set *n_uncollectable to the number of
+ * unreachable objects that couldn't be collected.
+ */
+static Py_ssize_t
+collect_list(int generation, PyGC_Head *young, PyGC_Head *old,
+             Py_ssize_t *n_uncollectable)
+{
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    PyGC_Head unreachable; /* non-problematic unreachable trash */
+    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
+    PyGC_Head *gc;
+    _PyTime_t t_start, t;
+
+    t_start = t = _PyTime_GetMonotonicClock();
 
     /* Using ob_refcnt and gc_refs, calculate which objects in the
      * container set are reachable from outside the set (i.e., have a
@@ -850,7 +937,9 @@ collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
      * set are taken into account).
      */
     update_refs(young);
+    t = record_phase(generation, PHASE_UPDATE_REFS, t);
     subtract_refs(young);
+    t = record_phase(generation, PHASE_SUBTRACT_REFS, t);
 
     /* Leave everything reachable from outside young in young, and move
      * everything else (in young) to unreachable.
@@ -860,6 +949,7 @@ collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
      */
     gc_list_init(&unreachable);
     move_unreachable(young, &unreachable);
+    t = record_phase(generation, PHASE_MOVE_UNREACHABLE, t);
 
     /* Move reachable objects to next generation. */
     if (young != old) {
@@ -894,11 +984,18 @@ collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
         }
     }
 
+    if (phase_stats.type_counts != NULL) {
+        count_types(&unreachable);
+    }
+
     /* Clear weakrefs and invoke callbacks as necessary. */
+    t = _PyTime_GetMonotonicClock();
     m += handle_weakrefs(&unreachable, old);
+    t = record_phase(generation, PHASE_HANDLE_WEAKREFS, t);
 
     /* Call tp_finalize on objects which have one. */
     finalize_garbage(&unreachable);
+    t = record_phase(generation, PHASE_FINALIZE_GARBAGE, t);
 
     if (check_garbage(&unreachable)) {
         revive_garbage(&unreachable);
@@ -912,6 +1009,7 @@ collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
         m += gc_list_size(&unreachable);
         delete_garbage(&unreachable, old);
     }
+    t = record_phase(generation, PHASE_DELETE_GARBAGE, t);
 
     /* Collect statistics on uncollectable objects found and print
      * debugging information. */
@@ -922,6 +1020,93 @@ collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
         if (_PyRuntime.gc.debug & DEBUG_UNCOLLECTABLE)
             debug_cycle("uncollectable", FROM_GC(gc));
     }
+
+    /* Append instances in the uncollectable set to a Python
+     * reachable list of garbage.  The programmer has to deal with
+     * this if they insist on creating this type of structure.
+     */
+    handle_legacy_finalizers(&finalizers, old);
+
+    t = record_phase(generation, PHASE_TOTAL, t_start);
+    phase_stats.last_allocations = phase_stats.allocations;
+    phase_stats.allocations = 0;
+    if (phase_stats.last_collection != 0)
+        phase_stats.last_interval = t - phase_stats.last_collection;
+    phase_stats.last_collection = t;
+
+    *n_uncollectable = n;
+    return m;
+}
+
+/* Handle any exception raised during a collection. */
+static void
+check_collect_error(int nofail)
+{
+    if (PyErr_Occurred()) {
+        if (nofail) {
+            PyErr_Clear();
+        }
+        else {
+            if (gc_str == NULL)
+                gc_str = PyUnicode_FromString("garbage collection");
+            PyErr_WriteUnraisable(gc_str);
+            Py_FatalError("unexpected exception during garbage collection");
+        }
+    }
+}
+
+/* This is the main function.  Read this to understand how the
+ * collection process works. */
+static Py_ssize_t
+collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
+        int nofail)
+{
+    int i;
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    PyGC_Head *young; /* the generation we are examining */
+    PyGC_Head *old; /* next older generation */
+    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
+
+    struct gc_generation_stats *stats = &_PyRuntime.gc.generation_stats[generation];
+
+    if (_PyRuntime.gc.debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting generation %d...\n",
+                          generation);
+        PySys_WriteStderr("gc: objects in each generation:");
+        for (i = 0; i < NUM_GENERATIONS; i++)
+            PySys_FormatStderr(" %zd",
+                              gc_list_size(GEN_HEAD(i)));
+        PySys_WriteStderr("\ngc: objects in permanent generation: %zd",
+                         gc_list_size(&_PyRuntime.gc.permanent_generation.head));
+        t1 = _PyTime_GetMonotonicClock();
+
+        PySys_WriteStderr("\n");
+    }
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(generation);
+
+    /* update collection and allocation counters */
+    if (generation+1 < NUM_GENERATIONS)
+        _PyRuntime.gc.generations[generation+1].count += 1;
+    for (i = 0; i <= generation; i++)
+        _PyRuntime.gc.generations[i].count = 0;
+
+    /* merge younger generations with one we are currently collecting */
+    for (i = 0; i < generation; i++) {
+        gc_list_merge(GEN_HEAD(i), GEN_HEAD(generation));
+    }
+
+    /* handy references */
+    young = GEN_HEAD(generation);
+    if (generation < NUM_GENERATIONS-1)
+        old = GEN_HEAD(generation+1);
+    else
+        old = young;
+
+    m = collect_list(generation, young, old, &n);
+
     if (_PyRuntime.gc.debug & DEBUG_STATS) {
         _PyTime_t t2 = _PyTime_GetMonotonicClock();
 
@@ -935,36 +1120,156 @@ collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
                           _PyTime_AsSecondsDouble(t2 - t1));
     }
 
-    /* Append instances in the uncollectable set to a Python
-     * reachable list of garbage.  The programmer has to deal with
-     * this if they insist on creating this type of structure.
-     */
-    handle_legacy_finalizers(&finalizers, old);
-
     /* Clear free list only during the collection of the highest
      * generation */
     if (generation == NUM_GENERATIONS-1) {
         clear_freelists();
+        /* A full collection also completes any incremental pass. */
+        incremental.remaining = 0;
     }
 
-    if (PyErr_Occurred()) {
-        if (nofail) {
-            PyErr_Clear();
-        }
-        else {
-            if (gc_str == NULL)
-                gc_str = PyUnicode_FromString("garbage collection");
-            PyErr_WriteUnraisable(gc_str);
-            Py_FatalError("unexpected exception during garbage collection");
+    check_collect_error(nofail);
+
+    /* Update stats */
+    if (n_collected)
+        *n_collected = m;
+    if (n_uncollectable)
+        *n_uncollectable = n;
+    stats->collections++;
+    stats->collected += m;
+    stats->uncollectable += n;
+
+    if (PyDTrace_GC_DONE_ENABLED())
+        PyDTrace_GC_DONE(n+m);
+
+    return n+m;
+}
+
+/* A traversal callback for collect_increment(). */
+static int
+visit_increment(PyObject *op, PyGC_Head *increment)
+{
+    if (PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+
+        /* Anything tracked and not already in the increment is added. */
+        if (_PyGCHead_REFS(gc) == GC_REACHABLE &&
+            incremental.closure_left > 0) {
+            gc_list_move(gc, increment);
+            _PyGCHead_SET_REFS(gc, GC_TENTATIVELY_UNREACHABLE);
+            incremental.closure_left--;
         }
     }
+    return 0;
+}
+
+/* Collect the younger generations and the next (at most) budget objects of
+ * the oldest generation.  Objects in the oldest generation are visited in
+ * turn and any that survive are moved to its end, so a series of increments
+ * eventually covers everything.
+ *
+ * An increment is a complete collection of a set of objects.  References
+ * into the set from objects outside it are found by update_refs() and
+ * subtract_refs() in the same way as for a younger generation, so the
+ * result is correct for any set and no write barrier is needed between
+ * increments.  A cycle can only be collected if all of it is in the same
+ * increment, so the objects that the set refers to are added to it as
+ * well (up to budget more objects).  This isn't done when there are frozen
+ * objects as they would be pulled out of the permanent generation.  Cycles
+ * that are too big for an increment are left for a full collection.
+ */
+static Py_ssize_t
+collect_increment(Py_ssize_t budget, Py_ssize_t *n_collected,
+                  Py_ssize_t *n_uncollectable)
+{
+    int i;
+    Py_ssize_t m, n, taken;
+    PyGC_Head *oldest = GEN_HEAD(NUM_GENERATIONS - 1);
+    PyGC_Head increment;
+    PyGC_Head *gc;
+    _PyTime_t t1 = 0;
+
+    struct gc_generation_stats *stats = &_PyRuntime.gc.generation_stats[NUM_GENERATIONS - 1];
+
+    if (_PyRuntime.gc.debug & DEBUG_STATS) {
+        PySys_FormatStderr("gc: collecting increment of %zd objects...\n",
+                           budget);
+        t1 = _PyTime_GetMonotonicClock();
+    }
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(NUM_GENERATIONS - 1);
+
+    /* Start a new pass over the oldest generation if necessary. */
+    if (incremental.remaining <= 0)
+        incremental.remaining = gc_list_size(oldest);
+
+    /* update collection and allocation counters */
+    for (i = 0; i < NUM_GENERATIONS; i++)
+        _PyRuntime.gc.generations[i].count = 0;
+
+    /* The increment is the younger generations and the start of the oldest
+     * one. */
+    gc_list_init(&increment);
+    for (i = 0; i < NUM_GENERATIONS - 1; i++) {
+        gc_list_merge(GEN_HEAD(i), &increment);
+    }
+    for (taken = 0; taken < budget && !gc_list_is_empty(oldest); taken++) {
+        gc_list_move(oldest->gc.gc_next, &increment);
+    }
+    incremental.remaining -= taken;
+
+    /* Add what the increment refers to, marking the objects that are in it
+     * so that they aren't added twice. */
+    for (gc = increment.gc.gc_next; gc != &increment; gc = gc->gc.gc_next) {
+        _PyGCHead_SET_REFS(gc, GC_TENTATIVELY_UNREACHABLE);
+    }
+    incremental.closure_left = gc_list_is_empty(
+            &_PyRuntime.gc.permanent_generation.head) ? budget : 0;
+    for (gc = increment.gc.gc_next;
+         gc != &increment && incremental.closure_left > 0;
+         gc = gc->gc.gc_next) {
+        traverseproc traverse = Py_TYPE(FROM_GC(gc))->tp_traverse;
+        (void) traverse(FROM_GC(gc),
+                        (visitproc)visit_increment,
+                        (void *)&increment);
+    }
+    for (gc = increment.gc.gc_next; gc != &increment; gc = gc->gc.gc_next) {
+        _PyGCHead_SET_REFS(gc, GC_REACHABLE);
+    }
+
+    m = collect_list(NUM_GENERATIONS - 1, &increment, oldest, &n);
+
+    if (_PyRuntime.gc.debug & DEBUG_STATS) {
+        _PyTime_t t2 = _PyTime_GetMonotonicClock();
+
+        if (m == 0 && n == 0)
+            PySys_WriteStderr("gc: done");
+        else
+            PySys_FormatStderr(
+                "gc: done, %zd unreachable, %zd uncollectable",
+                n+m, n);
+        PySys_WriteStderr(", %.4fs elapsed\n",
+                          _PyTime_AsSecondsDouble(t2 - t1));
+    }
+
+    /* At the end of a pass do what a full collection would. */
+    if (incremental.remaining <= 0) {
+        untrack_dicts(oldest);
+        _PyRuntime.gc.long_lived_pending = 0;
+        _PyRuntime.gc.long_lived_total = gc_list_size(oldest);
+        clear_freelists();
+        incremental.passes++;
+    }
+    incremental.increments++;
+
+    check_collect_error(0);
 
     /* Update stats */
     if (n_collected)
         *n_collected = m;
     if (n_uncollectable)
         *n_uncollectable = n;
-    stats->collections++;
     stats->collected += m;
     stats->uncollectable += n;
 
@@ -1027,6 +1332,18 @@ collect_with_callback(int generation)
     return result;
 }
 
+/* Perform an incremental collection and invoke progress callbacks. */
+static Py_ssize_t
+collect_increment_with_callback(Py_ssize_t budget)
+{
+    Py_ssize_t result, collected, uncollectable;
+    invoke_gc_callback("start", NUM_GENERATIONS - 1, 0, 0);
+    result = collect_increment(budget, &collected, &uncollectable);
+    invoke_gc_callback("stop", NUM_GENERATIONS - 1, collected,
+                       uncollectable);
+    return result;
+}
+
 static Py_ssize_t
 collect_generations(void)
 {
@@ -1042,6 +1359,11 @@ collect_generations(void)
                of tracked objects. See comments at the beginning
                of this file, and issue #4074.
             */
+            if (i == NUM_GENERATIONS - 1 && incremental.enabled) {
+                /* An increment is bounded so doesn't need the check. */
+                n = collect_increment_with_callback(incremental.budget);
+                break;
+            }
             if (i == NUM_GENERATIONS - 1
                 && _PyRuntime.gc.long_lived_pending < _PyRuntime.gc.long_lived_total / 4)
                 continue;
@@ -1194,6 +1516,227 @@ gc_set_thresh(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(gc_set_incremental__doc__,
+"set_incremental(enabled, [budget]) -> None\n"
+"\n"
+"Sets whether automatic collections of the oldest generation are done in\n"
+"increments and the number of its objects visited by each increment.\n");
+
+static PyObject *
+gc_set_incremental(PyObject *self, PyObject *args)
+{
+    int enabled;
+    Py_ssize_t budget = incremental.budget;
+
+    if (!PyArg_ParseTuple(args, "p|n:set_incremental", &enabled, &budget))
+        return NULL;
+    if (budget < 1) {
+        PyErr_SetString(PyExc_ValueError, "budget must be at least 1");
+        return NULL;
+    }
+    incremental.enabled = enabled;
+    incremental.budget = budget;
+
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gc_get_incremental__doc__,
+"get_incremental() -> dict\n"
+"\n"
+"Return a dictionary describing the state of incremental collection.\n");
+
+static PyObject *
+gc_get_incremental(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    return Py_BuildValue("{sOsnsnsnsn}",
+                         "enabled", incremental.enabled ? Py_True : Py_False,
+                         "budget", incremental.budget,
+                         "remaining", Py_MAX(incremental.remaining, 0),
+                         "increments", incremental.increments,
+                         "passes", incremental.passes);
+}
+
+PyDoc_STRVAR(gc_collect_increment__doc__,
+"collect_increment([budget, [timeout]]) -> n\n"
+"\n"
+"Collect the younger generations and the next budget objects of the\n"
+"oldest generation.  If a timeout (in seconds) is given then further\n"
+"increments are collected until it expires or the current pass over the\n"
+"oldest generation is complete.  This is intended to be called when an\n"
+"application is idle, eg. from an event loop.\n"
+"\n"
+"The number of unreachable objects is returned.\n");
+
+static PyObject *
+gc_collect_increment(PyObject *self, PyObject *args)
+{
+    Py_ssize_t budget = incremental.budget, n = 0;
+    double timeout = -1.0;
+    _PyTime_t deadline = 0;
+
+    if (!PyArg_ParseTuple(args, "|nd:collect_increment", &budget, &timeout))
+        return NULL;
+    if (budget < 1) {
+        PyErr_SetString(PyExc_ValueError, "budget must be at least 1");
+        return NULL;
+    }
+    if (timeout > 0) {
+        _PyTime_t t;
+
+        if (_PyTime_FromSecondsObject(&t, PyTuple_GET_ITEM(args, 1),
+                                      _PyTime_ROUND_CEILING) < 0)
+            return NULL;
+        deadline = _PyTime_GetMonotonicClock() + t;
+    }
+
+    if (_PyRuntime.gc.collecting)
+        return PyLong_FromSsize_t(0); /* already collecting */
+
+    _PyRuntime.gc.collecting = 1;
+    do {
+        n += collect_increment_with_callback(budget);
+    } while (timeout > 0 && incremental.remaining > 0 &&
+             _PyTime_GetMonotonicClock() < deadline);
+    _PyRuntime.gc.collecting = 0;
+
+    return PyLong_FromSsize_t(n);
+}
+
+PyDoc_STRVAR(gc_get_phase_stats__doc__,
+"get_phase_stats() -> dict\n"
+"\n"
+"Return a dictionary of the time spent in each phase of collections.\n"
+"\n"
+"'generations' is a list of dictionaries, one for each generation, that\n"
+"map the name of a phase to a dictionary of the number of times it has\n"
+"run, the total and maximum time in seconds and a histogram tuple of\n"
+"counts.  The upper bounds in seconds of the histogram buckets are given\n"
+"by 'bounds' (the last bucket is unbounded).  'allocations' is the number\n"
+"of objects allocated since the last collection and 'allocation_rate' is\n"
+"the number allocated per second between the last two collections.\n"
+"'types' maps type names to the number of unreachable objects found if\n"
+"counting was enabled by reset_phase_stats(), otherwise it is None.\n");
+
+static PyObject *
+gc_get_phase_stats(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *result, *bounds, *generations, *types, *item;
+    double rate = 0.0;
+    int i, j, k;
+
+    bounds = PyTuple_New(NUM_BUCKETS - 1);
+    if (bounds == NULL)
+        return NULL;
+    for (k = 0; k < NUM_BUCKETS - 1; k++) {
+        item = PyFloat_FromDouble((double)((_PyTime_t)1 << k) * 1e-6);
+        if (item == NULL) {
+            Py_DECREF(bounds);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(bounds, k, item);
+    }
+
+    generations = PyList_New(0);
+    if (generations == NULL) {
+        Py_DECREF(bounds);
+        return NULL;
+    }
+    for (i = 0; i < NUM_GENERATIONS; i++) {
+        PyObject *phases = PyDict_New();
+
+        if (phases == NULL)
+            goto error;
+        if (PyList_Append(generations, phases) < 0) {
+            Py_DECREF(phases);
+            goto error;
+        }
+        Py_DECREF(phases);
+
+        for (j = 0; j < NUM_PHASES; j++) {
+            struct gc_phase_stats *ps = &phase_stats.phases[i][j];
+            PyObject *histogram;
+            int err;
+
+            histogram = PyTuple_New(NUM_BUCKETS);
+            if (histogram == NULL)
+                goto error;
+            for (k = 0; k < NUM_BUCKETS; k++) {
+                PyObject *count = PyLong_FromSsize_t(ps->histogram[k]);
+                if (count == NULL) {
+                    Py_DECREF(histogram);
+                    goto error;
+                }
+                PyTuple_SET_ITEM(histogram, k, count);
+            }
+            item = Py_BuildValue("{snsdsdsN}",
+                                 "count", ps->count,
+                                 "total", _PyTime_AsSecondsDouble(ps->total),
+                                 "max", _PyTime_AsSecondsDouble(ps->max),
+                                 "histogram", histogram);
+            if (item == NULL)
+                goto error;
+            err = PyDict_SetItemString(phases, phase_names[j], item);
+            Py_DECREF(item);
+            if (err < 0)
+                goto error;
+        }
+    }
+
+    if (phase_stats.last_interval > 0) {
+        rate = phase_stats.last_allocations /
+                _PyTime_AsSecondsDouble(phase_stats.last_interval);
+    }
+    if (phase_stats.type_counts != NULL) {
+        types = PyDict_Copy(phase_stats.type_counts);
+        if (types == NULL)
+            goto error;
+    }
+    else {
+        types = Py_None;
+        Py_INCREF(types);
+    }
+
+    result = Py_BuildValue("{sNsNsnsdsN}",
+                           "bounds", bounds,
+                           "generations", generations,
+                           "allocations", phase_stats.allocations,
+                           "allocation_rate", rate,
+                           "types", types);
+    return result;
+
+error:
+    Py_DECREF(bounds);
+    Py_DECREF(generations);
+    return NULL;
+}
+
+PyDoc_STRVAR(gc_reset_phase_stats__doc__,
+"reset_phase_stats([count_types]) -> None\n"
+"\n"
+"Reset the statistics returned by get_phase_stats().  If count_types is\n"
+"true then unreachable objects will be counted by type.\n");
+
+static PyObject *
+gc_reset_phase_stats(PyObject *self, PyObject *args)
+{
+    int count_types = 0;
+
+    if (!PyArg_ParseTuple(args, "|p:reset_phase_stats", &count_types))
+        return NULL;
+
+    memset(phase_stats.phases, 0, sizeof(phase_stats.phases));
+    phase_stats.last_allocations = 0;
+    phase_stats.last_interval = 0;
+    Py_CLEAR(phase_stats.type_counts);
+    if (count_types) {
+        phase_stats.type_counts = PyDict_New();
+        if (phase_stats.type_counts == NULL)
+            return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
 /*[clinic input]
 gc.get_threshold
 
@@ -1468,8 +2011,13 @@ PyDoc_STRVAR(gc__doc__,
 "disable() -- Disable automatic garbage collection.\n"
 "isenabled() -- Returns true if automatic collection is enabled.\n"
 "collect() -- Do a full collection right now.\n"
+"collect_increment() -- Do an incremental collection right now.\n"
+"set_incremental() -- Set whether automatic collection is incremental.\n"
+"get_incremental() -- Return the state of incremental collection.\n"
 "get_count() -- Return the current collection counts.\n"
 "get_stats() -- Return list of dictionaries containing per-generation stats.\n"
+"get_phase_stats() -- Return the time spent in each phase of collections.\n"
+"reset_phase_stats() -- Reset the statistics returned by get_phase_stats().\n"
 "set_debug() -- Set debugging flags.\n"
 "get_debug() -- Get debugging flags.\n"
 "set_threshold() -- Set the collection thresholds.\n"
@@ -1490,6 +2038,16 @@ static PyMethodDef GcMethods[] = {
     GC_GET_DEBUG_METHODDEF
     GC_GET_COUNT_METHODDEF
     {"set_threshold",  gc_set_thresh, METH_VARARGS, gc_set_thresh__doc__},
+    {"set_incremental",  gc_set_incremental, METH_VARARGS,
+        gc_set_incremental__doc__},
+    {"get_incremental",  gc_get_incremental, METH_NOARGS,
+        gc_get_incremental__doc__},
+    {"collect_increment",  gc_collect_increment, METH_VARARGS,
+        gc_collect_increment__doc__},
+    {"get_phase_stats",  gc_get_phase_stats, METH_NOARGS,
+        gc_get_phase_stats__doc__},
+    {"reset_phase_stats",  gc_reset_phase_stats, METH_VARARGS,
+        gc_reset_phase_stats__doc__},
     GC_GET_THRESHOLD_METHODDEF
     GC_COLLECT_METHODDEF
     GC_GET_OBJECTS_METHODDEF
@@ -1645,6 +2203,7 @@ void
 _PyGC_Fini(void)
 {
     Py_CLEAR(_PyRuntime.gc.callbacks);
+    Py_CLEAR(phase_stats.type_counts);
 }
 
 /* for debugging */
@@ -1696,6 +2255,7 @@ _PyObject_GC_Alloc(int use_calloc, size_t basicsize)
     g->gc.gc_refs = 0;
     _PyGCHead_SET_REFS(g, GC_UNTRACKED);
     _PyRuntime.gc.generations[0].count++; /* number of allocated GC objects */
+    phase_stats.allocations++;
     if (_PyRuntime.gc.generations[0].count > _PyRuntime.gc.generations[0].threshold &&
         _PyRuntime.gc.enabled &&
         _PyRuntime.gc.generations[0].threshold &&
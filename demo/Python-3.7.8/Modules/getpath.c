@@ -91,6 +91,17 @@
  * known use of sys.prefix and sys.exec_prefix is for the ILU installation
  * process to find the installed Python tree.
  *
+ * A deployment can skip all of these searches by writing a "pypath.cfg"
+ * file next to the executable.  It holds the resolved values as
+ * "key = value" lines: "prefix", "exec_prefix" and one "path" line for each
+ * entry of the module search path, in order.  Relative values are relative
+ * to argv0_path.  $PYTHONPATH is still inserted in front of the path, and
+ * the file is ignored if $PYTHONHOME is set or if a key is missing.
+ *
+ * If $PYTHONGETPATHTRACE is set, each filesystem probe is reported on
+ * stderr with its cost, followed by the result in the format of
+ * pypath.cfg (each line prefixed with "getpath: ").
+ *
  * An embedding application can use Py_SetPath() to override all of
  * these authomatic path computations.
  *
@@ -110,6 +121,10 @@ extern "C" {
 #define LANDMARK L"os.py"
 #endif
 
+#ifndef PATHCONFIG
+#define PATHCONFIG L"pypath.cfg"
+#endif
+
 #define DECODE_LOCALE_ERR(NAME, LEN) \
     ((LEN) == (size_t)-2) \
      ? _Py_INIT_USER_ERR("cannot decode " NAME) \
@@ -133,6 +148,19 @@ typedef struct {
 static const wchar_t delimiter[2] = {DELIM, '\0'};
 static const wchar_t separator[2] = {SEP, '\0'};
 
+/* Set if $PYTHONGETPATHTRACE is set: report the filesystem probes */
+static int trace_probes = 0;
+
+
+static void
+trace_probe(const char *op, const wchar_t *path, int found, _PyTime_t start)
+{
+    _PyTime_t us = _PyTime_AsMicroseconds(
+        _PyTime_GetMonotonicClock() - start, _PyTime_ROUND_CEILING);
+    fprintf(stderr, "getpath: %s %ls: %s (%ld us)\n",
+            op, path, found ? "found" : "missing", (long)us);
+}
+
 
 /* Get file status. Encode the path to the locale encoding. */
 static int
@@ -140,17 +168,41 @@ _Py_wstat(const wchar_t* path, struct stat *buf)
 {
     int err;
     char *fname;
+    _PyTime_t start = 0;
     fname = _Py_EncodeLocaleRaw(path, NULL);
     if (fname == NULL) {
         errno = EINVAL;
         return -1;
     }
+    if (trace_probes) {
+        start = _PyTime_GetMonotonicClock();
+    }
     err = stat(fname, buf);
+    if (trace_probes) {
+        trace_probe("stat", path, err == 0, start);
+    }
     PyMem_RawFree(fname);
     return err;
 }
 
 
+/* Open a configuration file, reporting the probe if requested */
+static FILE*
+getpath_wfopen(const wchar_t *path, const wchar_t *mode)
+{
+    FILE *f;
+    _PyTime_t start = 0;
+    if (trace_probes) {
+        start = _PyTime_GetMonotonicClock();
+    }
+    f = _Py_wfopen(path, mode);
+    if (trace_probes) {
+        trace_probe("open", path, f != NULL, start);
+    }
+    return f;
+}
+
+
 static void
 reduce(wchar_t *dir)
 {
@@ -474,7 +526,7 @@ search_for_exec_prefix(const _PyCoreConfig *core_config,
     exec_prefix[MAXPATHLEN] = L'\0';
     joinpath(exec_prefix, L"pybuilddir.txt");
     if (isfile(exec_prefix)) {
-        FILE *f = _Py_wfopen(exec_prefix, L"rb");
+        FILE *f = getpath_wfopen(exec_prefix, L"rb");
         if (f == NULL) {
             errno = 0;
         }
@@ -747,7 +799,7 @@ calculate_read_pyenv(PyCalculatePath *calculate)
     wcscpy(tmpbuffer, calculate->argv0_path);
 
     joinpath(tmpbuffer, env_cfg);
-    env_file = _Py_wfopen(tmpbuffer, L"r");
+    env_file = getpath_wfopen(tmpbuffer, L"r");
     if (env_file == NULL) {
         errno = 0;
 
@@ -755,7 +807,7 @@ calculate_read_pyenv(PyCalculatePath *calculate)
         reduce(tmpbuffer);
         joinpath(tmpbuffer, env_cfg);
 
-        env_file = _Py_wfopen(tmpbuffer, L"r");
+        env_file = getpath_wfopen(tmpbuffer, L"r");
         if (env_file == NULL) {
             errno = 0;
         }
@@ -773,6 +825,179 @@ calculate_read_pyenv(PyCalculatePath *calculate)
 }
 
 
+/* Append an entry of the pypath.cfg file to the module search path */
+static int
+pathconfig_add_path(wchar_t **buf, size_t *bufsz, const wchar_t *entry)
+{
+    size_t len = *buf ? wcslen(*buf) : 0;
+    size_t size = len + 1 + wcslen(entry) + 1;
+    if (size > *bufsz) {
+        size_t newsz = Py_MAX(size, *bufsz * 2);
+        wchar_t *newbuf = PyMem_RawRealloc(*buf, newsz * sizeof(wchar_t));
+        if (newbuf == NULL) {
+            return -1;
+        }
+        *buf = newbuf;
+        *bufsz = newsz;
+    }
+    if (len) {
+        wcscpy(*buf + len, delimiter);
+        len++;
+    }
+    wcscpy(*buf + len, entry);
+    return 0;
+}
+
+
+/* Read the "pypath.cfg" file of a deployment in argv0_path and use the
+   resolved paths instead of searching for them.  *found is set to 0 if
+   there is no usable file.
+*/
+static _PyInitError
+calculate_read_pathconfig(const _PyCoreConfig *core_config,
+                          PyCalculatePath *calculate, _PyPathConfig *config,
+                          int *found)
+{
+    wchar_t tmpbuffer[MAXPATHLEN+1];
+    wchar_t prefix[MAXPATHLEN+1] = L"";
+    wchar_t exec_prefix[MAXPATHLEN+1] = L"";
+    wchar_t *paths = NULL;
+    size_t pathsz = 0;
+    char line[MAXPATHLEN*2+1];
+    FILE *f;
+
+    *found = 0;
+    /* PYTHONHOME overrides the deployment */
+    if (core_config->home) {
+        return _Py_INIT_OK();
+    }
+
+    wcscpy(tmpbuffer, calculate->argv0_path);
+    joinpath(tmpbuffer, PATHCONFIG);
+    f = getpath_wfopen(tmpbuffer, L"rb");
+    if (f == NULL) {
+        errno = 0;
+        return _Py_INIT_OK();
+    }
+
+    if (core_config->module_search_path_env) {
+        if (pathconfig_add_path(&paths, &pathsz,
+                                core_config->module_search_path_env) < 0) {
+            fclose(f);
+            return _Py_INIT_NO_MEMORY();
+        }
+    }
+    int npaths = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char *key = line, *value, *end;
+
+        value = strchr(line, '=');
+        if (line[0] == '#' || value == NULL) {
+            continue;
+        }
+        /* strip the key and the value */
+        end = value;
+        *value++ = '\0';
+        while (end > key && (end[-1] == ' ' || end[-1] == '\t')) {
+            *--end = '\0';
+        }
+        while (*key == ' ' || *key == '\t') {
+            key++;
+        }
+        while (*value == ' ' || *value == '\t') {
+            value++;
+        }
+        end = value + strlen(value);
+        while (end > value && (end[-1] == '\n' || end[-1] == '\r' ||
+                               end[-1] == ' ' || end[-1] == '\t')) {
+            *--end = '\0';
+        }
+
+        wchar_t *wvalue = _Py_DecodeUTF8_surrogateescape(value, end - value);
+        if (wvalue == NULL) {
+            fclose(f);
+            PyMem_RawFree(paths);
+            return _Py_INIT_NO_MEMORY();
+        }
+        if (wvalue[0] == SEP) {
+            wcsncpy(tmpbuffer, wvalue, MAXPATHLEN);
+            tmpbuffer[MAXPATHLEN] = L'\0';
+        }
+        else {
+            wcscpy(tmpbuffer, calculate->argv0_path);
+            joinpath(tmpbuffer, wvalue);
+        }
+        PyMem_RawFree(wvalue);
+
+        if (strcmp(key, "prefix") == 0) {
+            wcscpy(prefix, tmpbuffer);
+        }
+        else if (strcmp(key, "exec_prefix") == 0) {
+            wcscpy(exec_prefix, tmpbuffer);
+        }
+        else if (strcmp(key, "path") == 0) {
+            if (pathconfig_add_path(&paths, &pathsz, tmpbuffer) < 0) {
+                fclose(f);
+                PyMem_RawFree(paths);
+                return _Py_INIT_NO_MEMORY();
+            }
+            npaths++;
+        }
+    }
+    fclose(f);
+
+    if (!prefix[0] || !exec_prefix[0] || !npaths) {
+        if (trace_probes) {
+            fprintf(stderr, "getpath: incomplete %ls, ignored\n",
+                    PATHCONFIG);
+        }
+        PyMem_RawFree(paths);
+        return _Py_INIT_OK();
+    }
+
+    config->module_search_path = paths;
+    config->prefix = _PyMem_RawWcsdup(prefix);
+    config->exec_prefix = _PyMem_RawWcsdup(exec_prefix);
+    if (config->prefix == NULL || config->exec_prefix == NULL) {
+        return _Py_INIT_NO_MEMORY();
+    }
+    *found = 1;
+    return _Py_INIT_OK();
+}
+
+
+/* Report the result in the format of pypath.cfg */
+static void
+trace_result(const _PyCoreConfig *core_config, _PyPathConfig *config,
+             _PyTime_t start)
+{
+    _PyTime_t us = _PyTime_AsMicroseconds(
+        _PyTime_GetMonotonicClock() - start, _PyTime_ROUND_CEILING);
+    const wchar_t *path = config->module_search_path;
+    size_t skip = 0;
+
+    fprintf(stderr, "getpath: paths computed in %ld us\n", (long)us);
+    fprintf(stderr, "getpath: prefix = %ls\n", config->prefix);
+    fprintf(stderr, "getpath: exec_prefix = %ls\n", config->exec_prefix);
+    /* $PYTHONPATH doesn't belong to the deployment */
+    if (core_config->module_search_path_env) {
+        skip = wcslen(core_config->module_search_path_env) + 1;
+    }
+    if (skip <= wcslen(path)) {
+        path += skip;
+    }
+    while (1) {
+        const wchar_t *delim = wcschr(path, DELIM);
+        if (delim == NULL) {
+            fprintf(stderr, "getpath: path = %ls\n", path);
+            break;
+        }
+        fprintf(stderr, "getpath: path = %.*ls\n", (int)(delim - path), path);
+        path = delim + 1;
+    }
+}
+
+
 static void
 calculate_zip_path(PyCalculatePath *calculate, const wchar_t *prefix)
 {
@@ -947,6 +1172,12 @@ calculate_path_impl(const _PyCoreConfig *core_config,
         return err;
     }
 
+    int found;
+    err = calculate_read_pathconfig(core_config, calculate, config, &found);
+    if (_Py_INIT_FAILED(err) || found) {
+        return err;
+    }
+
     calculate_read_pyenv(calculate);
 
     wchar_t prefix[MAXPATHLEN+1];
@@ -996,6 +1227,9 @@ _PyPathConfig_Calculate(_PyPathConfig *config, const _PyCoreConfig *core_config)
     PyCalculatePath calculate;
     memset(&calculate, 0, sizeof(calculate));
 
+    _PyTime_t start = _PyTime_GetMonotonicClock();
+    trace_probes = (Py_GETENV("PYTHONGETPATHTRACE") != NULL);
+
     _PyInitError err = calculate_init(&calculate, core_config);
     if (_Py_INIT_FAILED(err)) {
         goto done;
@@ -1005,6 +1239,10 @@ _PyPathConfig_Calculate(_PyPathConfig *config, const _PyCoreConfig *core_config)
     if (_Py_INIT_FAILED(err)) {
         goto done;
     }
+    if (trace_probes) {
+        trace_result(core_config, config, start);
+    }
+    _PyStartupTrace_Event("python", "calculate path configuration", start);
 
     err = _Py_INIT_OK();
 
@@ -1,5 +1,5 @@
-/* The implementation of the hash table (_Py_hashtable_t) is based on the
-   cfuhash project:
+/* The implementation of the hash table (_Py_hashtable_t) was originally
+   based on the cfuhash project:
    http://sourceforge.net/projects/libcfu/
 
    Copyright of cfuhash:
@@ -47,19 +47,29 @@
 #include "Python.h"
 #include "hashtable.h"
 
+/* The table uses open addressing with linear probing.  Entries live
+   inline in the bucket array, so set() and pop() don't allocate, and
+   pop() uses backward shift deletion instead of tombstones. */
+
 #define HASHTABLE_MIN_SIZE 16
 #define HASHTABLE_HIGH 0.50
 #define HASHTABLE_LOW 0.10
 #define HASHTABLE_REHASH_FACTOR 2.0 / (HASHTABLE_LOW + HASHTABLE_HIGH)
 
-#define BUCKETS_HEAD(SLIST) \
-        ((_Py_hashtable_entry_t *)_Py_SLIST_HEAD(&(SLIST)))
-#define TABLE_HEAD(HT, BUCKET) \
-        ((_Py_hashtable_entry_t *)_Py_SLIST_HEAD(&(HT)->buckets[BUCKET]))
-#define ENTRY_NEXT(ENTRY) \
-        ((_Py_hashtable_entry_t *)_Py_SLIST_ITEM_NEXT(ENTRY))
-#define HASHTABLE_ITEM_SIZE(HT) \
-        (sizeof(_Py_hashtable_entry_t) + (HT)->key_size + (HT)->data_size)
+#define TABLE_ENTRY(HT, BUCKET) \
+        ((_Py_hashtable_entry_t *)((HT)->buckets + (BUCKET) * (HT)->entry_size))
+#define HASHTABLE_ITEM_SIZE(KEY_SIZE, DATA_SIZE) \
+        _Py_SIZE_ROUND_UP(sizeof(_Py_hashtable_entry_t) \
+                          + (KEY_SIZE) + (DATA_SIZE), SIZEOF_SIZE_T)
+
+/* Scramble the hash before masking it: linear probing is sensitive to
+   clustered hashes, and _Py_HashPointer() of neighbouring heap blocks
+   only differ in a few low bits. */
+#if SIZEOF_SIZE_T == 8
+#  define HASHTABLE_MULTIPLIER 0x9E3779B97F4A7C15ULL
+#else
+#  define HASHTABLE_MULTIPLIER 0x9E3779B9UL
+#endif
 
 #define ENTRY_READ_PDATA(TABLE, ENTRY, DATA_SIZE, PDATA) \
     do { \
@@ -76,31 +86,14 @@
     } while (0)
 
 /* Forward declaration */
-static void hashtable_rehash(_Py_hashtable_t *ht);
-
-static void
-_Py_slist_init(_Py_slist_t *list)
-{
-    list->head = NULL;
-}
-
-
-static void
-_Py_slist_prepend(_Py_slist_t *list, _Py_slist_item_t *item)
-{
-    item->next = list->head;
-    list->head = item;
-}
+static int hashtable_rehash(_Py_hashtable_t *ht);
 
-
-static void
-_Py_slist_remove(_Py_slist_t *list, _Py_slist_item_t *previous,
-                 _Py_slist_item_t *item)
+static size_t
+hashtable_index(_Py_hashtable_t *ht, Py_uhash_t key_hash)
 {
-    if (previous != NULL)
-        previous->next = item->next;
-    else
-        list->head = item->next;
+    size_t h = (size_t)key_hash * HASHTABLE_MULTIPLIER;
+    h ^= h >> (SIZEOF_SIZE_T * 4);
+    return h & (ht->num_buckets - 1);
 }
 
 
@@ -163,8 +156,9 @@ _Py_hashtable_new_full(size_t key_size, size_t data_size,
     ht->entries = 0;
     ht->key_size = key_size;
     ht->data_size = data_size;
+    ht->entry_size = HASHTABLE_ITEM_SIZE(key_size, data_size);
 
-    buckets_size = ht->num_buckets * sizeof(ht->buckets[0]);
+    buckets_size = ht->num_buckets * ht->entry_size;
     ht->buckets = alloc.malloc(buckets_size);
     if (ht->buckets == NULL) {
         alloc.free(ht);
@@ -198,11 +192,8 @@ _Py_hashtable_size(_Py_hashtable_t *ht)
 
     size = sizeof(_Py_hashtable_t);
 
-    /* buckets */
-    size += ht->num_buckets * sizeof(_Py_hashtable_entry_t *);
-
-    /* entries */
-    size += ht->entries * HASHTABLE_ITEM_SIZE(ht);
+    /* buckets, entries included */
+    size += ht->num_buckets * ht->entry_size;
 
     return size;
 }
@@ -213,7 +204,7 @@ void
 _Py_hashtable_print_stats(_Py_hashtable_t *ht)
 {
     size_t size;
-    size_t chain_len, max_chain_len, total_chain_len, nchains;
+    size_t probe_len, max_probe_len, total_probe_len;
     _Py_hashtable_entry_t *entry;
     size_t hv;
     double load;
@@ -222,29 +213,27 @@ _Py_hashtable_print_stats(_Py_hashtable_t *ht)
 
     load = (double)ht->entries / ht->num_buckets;
 
-    max_chain_len = 0;
-    total_chain_len = 0;
-    nchains = 0;
+    max_probe_len = 0;
+    total_probe_len = 0;
     for (hv = 0; hv < ht->num_buckets; hv++) {
-        entry = TABLE_HEAD(ht, hv);
-        if (entry != NULL) {
-            chain_len = 0;
-            for (; entry; entry = ENTRY_NEXT(entry)) {
-                chain_len++;
-            }
-            if (chain_len > max_chain_len)
-                max_chain_len = chain_len;
-            total_chain_len += chain_len;
-            nchains++;
-        }
+        entry = TABLE_ENTRY(ht, hv);
+        if (!entry->used)
+            continue;
+        /* distance from the bucket the entry hashes to */
+        probe_len = (hv - hashtable_index(ht, entry->key_hash))
+                    & (ht->num_buckets - 1);
+        if (probe_len > max_probe_len)
+            max_probe_len = probe_len;
+        total_probe_len += probe_len;
     }
     printf("hash table %p: entries=%"
            PY_FORMAT_SIZE_T "u/%" PY_FORMAT_SIZE_T "u (%.0f%%), ",
            ht, ht->entries, ht->num_buckets, load * 100.0);
-    if (nchains)
-        printf("avg_chain_len=%.1f, ", (double)total_chain_len / nchains);
-    printf("max_chain_len=%" PY_FORMAT_SIZE_T "u, %" PY_FORMAT_SIZE_T "u KiB\n",
-           max_chain_len, size / 1024);
+    if (ht->entries)
+        printf("avg_probe_len=%.1f, ",
+               (double)total_probe_len / ht->entries);
+    printf("max_probe_len=%" PY_FORMAT_SIZE_T "u, %" PY_FORMAT_SIZE_T "u KiB\n",
+           max_probe_len, size / 1024);
 }
 #endif
 
@@ -254,20 +243,24 @@ _Py_hashtable_get_entry(_Py_hashtable_t *ht,
                         size_t key_size, const void *pkey)
 {
     Py_uhash_t key_hash;
-    size_t index;
+    size_t index, mask;
     _Py_hashtable_entry_t *entry;
 
     assert(key_size == ht->key_size);
 
     key_hash = ht->hash_func(ht, pkey);
-    index = key_hash & (ht->num_buckets - 1);
-
-    for (entry = TABLE_HEAD(ht, index); entry != NULL; entry = ENTRY_NEXT(entry)) {
+    mask = ht->num_buckets - 1;
+    index = hashtable_index(ht, key_hash);
+
+    /* there is always at least one free bucket, so this terminates */
+    for (;;) {
+        entry = TABLE_ENTRY(ht, index);
+        if (!entry->used)
+            return NULL;
         if (entry->key_hash == key_hash && ht->compare_func(ht, pkey, entry))
-            break;
+            return entry;
+        index = (index + 1) & mask;
     }
-
-    return entry;
 }
 
 
@@ -275,35 +268,40 @@ static int
 _Py_hashtable_pop_entry(_Py_hashtable_t *ht, size_t key_size, const void *pkey,
                         void *data, size_t data_size)
 {
-    Py_uhash_t key_hash;
-    size_t index;
-    _Py_hashtable_entry_t *entry, *previous;
-
-    assert(key_size == ht->key_size);
-
-    key_hash = ht->hash_func(ht, pkey);
-    index = key_hash & (ht->num_buckets - 1);
-
-    previous = NULL;
-    for (entry = TABLE_HEAD(ht, index); entry != NULL; entry = ENTRY_NEXT(entry)) {
-        if (entry->key_hash == key_hash && ht->compare_func(ht, pkey, entry))
-            break;
-        previous = entry;
-    }
+    _Py_hashtable_entry_t *entry, *next;
+    size_t index, next_index, mask;
 
+    entry = _Py_hashtable_get_entry(ht, key_size, pkey);
     if (entry == NULL)
         return 0;
 
-    _Py_slist_remove(&ht->buckets[index], (_Py_slist_item_t *)previous,
-                     (_Py_slist_item_t *)entry);
-    ht->entries--;
-
     if (data != NULL)
         ENTRY_READ_PDATA(ht, entry, data_size, data);
-    ht->alloc.free(entry);
+
+    /* backward shift deletion: move later entries of the same cluster
+       into the hole, unless that would put them before their home
+       bucket */
+    mask = ht->num_buckets - 1;
+    index = ((char *)entry - ht->buckets) / ht->entry_size;
+    next_index = index;
+    for (;;) {
+        size_t home;
+
+        next_index = (next_index + 1) & mask;
+        next = TABLE_ENTRY(ht, next_index);
+        if (!next->used)
+            break;
+        home = hashtable_index(ht, next->key_hash);
+        if (((next_index - home) & mask) >= ((next_index - index) & mask)) {
+            memcpy(TABLE_ENTRY(ht, index), next, ht->entry_size);
+            index = next_index;
+        }
+    }
+    TABLE_ENTRY(ht, index)->used = 0;
+    ht->entries--;
 
     if ((float)ht->entries / (float)ht->num_buckets < HASHTABLE_LOW)
-        hashtable_rehash(ht);
+        (void)hashtable_rehash(ht);
     return 1;
 }
 
@@ -313,7 +311,7 @@ _Py_hashtable_set(_Py_hashtable_t *ht, size_t key_size, const void *pkey,
                   size_t data_size, const void *data)
 {
     Py_uhash_t key_hash;
-    size_t index;
+    size_t index, mask;
     _Py_hashtable_entry_t *entry;
 
     assert(key_size == ht->key_size);
@@ -327,25 +325,30 @@ _Py_hashtable_set(_Py_hashtable_t *ht, size_t key_size, const void *pkey,
     assert(entry == NULL);
 #endif
 
-    key_hash = ht->hash_func(ht, pkey);
-    index = key_hash & (ht->num_buckets - 1);
+    /* grow before inserting: the table must always keep a free bucket */
+    if ((float)(ht->entries + 1) / (float)ht->num_buckets > HASHTABLE_HIGH) {
+        if (hashtable_rehash(ht) < 0 && ht->entries + 1 >= ht->num_buckets) {
+            /* memory allocation failed */
+            return -1;
+        }
+    }
 
-    entry = ht->alloc.malloc(HASHTABLE_ITEM_SIZE(ht));
-    if (entry == NULL) {
-        /* memory allocation failed */
-        return -1;
+    key_hash = ht->hash_func(ht, pkey);
+    mask = ht->num_buckets - 1;
+    index = hashtable_index(ht, key_hash);
+    for (;;) {
+        entry = TABLE_ENTRY(ht, index);
+        if (!entry->used)
+            break;
+        index = (index + 1) & mask;
     }
 
     entry->key_hash = key_hash;
+    entry->used = 1;
     memcpy((void *)_Py_HASHTABLE_ENTRY_PKEY(entry), pkey, ht->key_size);
     if (data)
         ENTRY_WRITE_PDATA(ht, entry, data_size, data);
-
-    _Py_slist_prepend(&ht->buckets[index], (_Py_slist_item_t*)entry);
     ht->entries++;
-
-    if ((float)ht->entries / (float)ht->num_buckets > HASHTABLE_HIGH)
-        hashtable_rehash(ht);
     return 0;
 }
 
@@ -399,7 +402,8 @@ _Py_hashtable_foreach(_Py_hashtable_t *ht,
     size_t hv;
 
     for (hv = 0; hv < ht->num_buckets; hv++) {
-        for (entry = TABLE_HEAD(ht, hv); entry; entry = ENTRY_NEXT(entry)) {
+        entry = TABLE_ENTRY(ht, hv);
+        if (entry->used) {
             int res = func(ht, entry, arg);
             if (res)
                 return res;
@@ -409,82 +413,70 @@ _Py_hashtable_foreach(_Py_hashtable_t *ht,
 }
 
 
-static void
+/* Resize the bucket array for the current number of entries.
+   Return 0 on success (or if the size doesn't change), -1 on memory
+   allocation failure, in which case the table is left unchanged. */
+static int
 hashtable_rehash(_Py_hashtable_t *ht)
 {
-    size_t buckets_size, new_size, bucket;
-    _Py_slist_t *old_buckets = NULL;
+    size_t buckets_size, new_size, bucket, mask;
+    char *old_buckets = NULL;
     size_t old_num_buckets;
 
     new_size = round_size((size_t)(ht->entries * HASHTABLE_REHASH_FACTOR));
     if (new_size == ht->num_buckets)
-        return;
+        return 0;
 
     old_num_buckets = ht->num_buckets;
 
-    buckets_size = new_size * sizeof(ht->buckets[0]);
+    buckets_size = new_size * ht->entry_size;
     old_buckets = ht->buckets;
     ht->buckets = ht->alloc.malloc(buckets_size);
     if (ht->buckets == NULL) {
         /* cancel rehash on memory allocation failure */
         ht->buckets = old_buckets ;
         /* memory allocation failed */
-        return;
+        return -1;
     }
     memset(ht->buckets, 0, buckets_size);
 
     ht->num_buckets = new_size;
+    mask = new_size - 1;
 
     for (bucket = 0; bucket < old_num_buckets; bucket++) {
-        _Py_hashtable_entry_t *entry, *next;
-        for (entry = BUCKETS_HEAD(old_buckets[bucket]); entry != NULL; entry = next) {
-            size_t entry_index;
+        _Py_hashtable_entry_t *entry;
+        size_t entry_index;
 
+        entry = (_Py_hashtable_entry_t *)(old_buckets
+                                          + bucket * ht->entry_size);
+        if (!entry->used)
+            continue;
 
-            assert(ht->hash_func(ht, _Py_HASHTABLE_ENTRY_PKEY(entry)) == entry->key_hash);
-            next = ENTRY_NEXT(entry);
-            entry_index = entry->key_hash & (new_size - 1);
+        assert(ht->hash_func(ht, _Py_HASHTABLE_ENTRY_PKEY(entry)) == entry->key_hash);
+        entry_index = hashtable_index(ht, entry->key_hash);
+        while (TABLE_ENTRY(ht, entry_index)->used)
+            entry_index = (entry_index + 1) & mask;
 
-            _Py_slist_prepend(&ht->buckets[entry_index], (_Py_slist_item_t*)entry);
-        }
+        memcpy(TABLE_ENTRY(ht, entry_index), entry, ht->entry_size);
     }
 
     ht->alloc.free(old_buckets);
+    return 0;
 }
 
 
 void
 _Py_hashtable_clear(_Py_hashtable_t *ht)
 {
-    _Py_hashtable_entry_t *entry, *next;
-    size_t i;
-
-    for (i=0; i < ht->num_buckets; i++) {
-        for (entry = TABLE_HEAD(ht, i); entry != NULL; entry = next) {
-            next = ENTRY_NEXT(entry);
-            ht->alloc.free(entry);
-        }
-        _Py_slist_init(&ht->buckets[i]);
-    }
+    memset(ht->buckets, 0, ht->num_buckets * ht->entry_size);
     ht->entries = 0;
-    hashtable_rehash(ht);
+    (void)hashtable_rehash(ht);
 }
 
 
 void
 _Py_hashtable_destroy(_Py_hashtable_t *ht)
 {
-    size_t i;
-
-    for (i = 0; i < ht->num_buckets; i++) {
-        _Py_slist_item_t *entry = ht->buckets[i].head;
-        while (entry) {
-            _Py_slist_item_t *entry_next = entry->next;
-            ht->alloc.free(entry);
-            entry = entry_next;
-        }
-    }
-
     ht->alloc.free(ht->buckets);
     ht->alloc.free(ht);
 }
@@ -493,14 +485,9 @@ _Py_hashtable_destroy(_Py_hashtable_t *ht)
 _Py_hashtable_t *
 _Py_hashtable_copy(_Py_hashtable_t *src)
 {
-    const size_t key_size = src->key_size;
-    const size_t data_size = src->data_size;
     _Py_hashtable_t *dst;
-    _Py_hashtable_entry_t *entry;
-    size_t bucket;
-    int err;
 
-    dst = _Py_hashtable_new_full(key_size, data_size,
+    dst = _Py_hashtable_new_full(src->key_size, src->data_size,
                                  src->num_buckets,
                                  src->hash_func,
                                  src->compare_func,
@@ -508,17 +495,10 @@ _Py_hashtable_copy(_Py_hashtable_t *src)
     if (dst == NULL)
         return NULL;
 
-    for (bucket=0; bucket < src->num_buckets; bucket++) {
-        entry = TABLE_HEAD(src, bucket);
-        for (; entry; entry = ENTRY_NEXT(entry)) {
-            const void *pkey = _Py_HASHTABLE_ENTRY_PKEY(entry);
-            const void *pdata = _Py_HASHTABLE_ENTRY_PDATA(src, entry);
-            err = _Py_hashtable_set(dst, key_size, pkey, data_size, pdata);
-            if (err) {
-                _Py_hashtable_destroy(dst);
-                return NULL;
-            }
-        }
-    }
+    /* same size and same hash function: the bucket array can be copied
+       as is */
+    assert(dst->num_buckets == src->num_buckets);
+    memcpy(dst->buckets, src->buckets, src->num_buckets * src->entry_size);
+    dst->entries = src->entries;
     return dst;
 }
@@ -3,29 +3,19 @@
 /* The whole API is private */
 #ifndef Py_LIMITED_API
 
-/* Single linked list */
-
-typedef struct _Py_slist_item_s {
-    struct _Py_slist_item_s *next;
-} _Py_slist_item_t;
-
-typedef struct {
-    _Py_slist_item_t *head;
-} _Py_slist_t;
-
-#define _Py_SLIST_ITEM_NEXT(ITEM) (((_Py_slist_item_t *)ITEM)->next)
-
-#define _Py_SLIST_HEAD(SLIST) (((_Py_slist_t *)SLIST)->head)
-
-
 /* _Py_hashtable: table entry */
 
-typedef struct {
-    /* used by _Py_hashtable_t.buckets to link entries */
-    _Py_slist_item_t _Py_slist_item;
+/* Entries are stored inline in the bucket array (open addressing with
+   linear probing), so an entry pointer is only valid until the next
+   _Py_hashtable_set(), _Py_hashtable_pop() or _Py_hashtable_clear()
+   call on the same table. */
 
+typedef struct {
     Py_uhash_t key_hash;
 
+    /* non-zero if the bucket holds an entry */
+    int used;
+
     /* key (key_size bytes) and then data (data_size bytes) follows */
 } _Py_hashtable_entry_t;
 
@@ -92,9 +82,10 @@ typedef struct {
 typedef struct _Py_hashtable_t {
     size_t num_buckets;
     size_t entries; /* Total number of entries in the table. */
-    _Py_slist_t *buckets;
+    char *buckets; /* num_buckets entries of entry_size bytes */
     size_t key_size;
     size_t data_size;
+    size_t entry_size;
 
     _Py_hashtable_hash_func hash_func;
     _Py_hashtable_compare_func compare_func;
@@ -379,6 +379,209 @@ static PyTypeObject _grouper_type = {
 };
 
 
+/* groupcount object *********************************************************/
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *it;
+    PyObject *keyfunc;
+    PyObject *currkey;          /* key of the current group, or NULL */
+    Py_ssize_t count;           /* number of values read in the group */
+} groupcountobject;
+
+static PyTypeObject groupcount_type;
+
+static PyObject *
+groupcount_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    static char *kwargs[] = {"iterable", "key", NULL};
+    groupcountobject *gco;
+    PyObject *it, *keyfunc = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:groupcount", kwargs,
+                                     &it, &keyfunc))
+        return NULL;
+
+    gco = (groupcountobject *)type->tp_alloc(type, 0);
+    if (gco == NULL)
+        return NULL;
+    gco->currkey = NULL;
+    gco->count = 0;
+    gco->keyfunc = keyfunc;
+    Py_INCREF(keyfunc);
+    gco->it = PyObject_GetIter(it);
+    if (gco->it == NULL) {
+        Py_DECREF(gco);
+        return NULL;
+    }
+    return (PyObject *)gco;
+}
+
+static void
+groupcount_dealloc(groupcountobject *gco)
+{
+    PyObject_GC_UnTrack(gco);
+    Py_XDECREF(gco->it);
+    Py_XDECREF(gco->keyfunc);
+    Py_XDECREF(gco->currkey);
+    Py_TYPE(gco)->tp_free(gco);
+}
+
+static int
+groupcount_traverse(groupcountobject *gco, visitproc visit, void *arg)
+{
+    Py_VISIT(gco->it);
+    Py_VISIT(gco->keyfunc);
+    Py_VISIT(gco->currkey);
+    return 0;
+}
+
+static PyObject *
+groupcount_next(groupcountobject *gco)
+{
+    PyObject *value, *key, *r;
+    int rcmp;
+
+    for (;;) {
+        value = PyIter_Next(gco->it);
+        if (value == NULL) {
+            if (PyErr_Occurred() || gco->currkey == NULL)
+                return NULL;
+            /* end of the last group */
+            key = NULL;
+            break;
+        }
+
+        if (gco->keyfunc == Py_None) {
+            key = value;
+        } else {
+            key = PyObject_CallFunctionObjArgs(gco->keyfunc, value, NULL);
+            Py_DECREF(value);
+            if (key == NULL)
+                return NULL;
+        }
+
+        if (gco->currkey == NULL) {
+            gco->currkey = key;
+            gco->count = 1;
+            continue;
+        }
+        rcmp = PyObject_RichCompareBool(gco->currkey, key, Py_EQ);
+        if (rcmp == -1) {
+            Py_DECREF(key);
+            return NULL;
+        }
+        if (rcmp == 0)
+            break;
+        Py_DECREF(key);
+        gco->count++;
+    }
+
+    /* key starts the next group */
+    r = Py_BuildValue("(On)", gco->currkey, gco->count);
+    if (r == NULL) {
+        Py_XDECREF(key);
+        return NULL;
+    }
+    Py_XSETREF(gco->currkey, key);
+    gco->count = key != NULL;
+    return r;
+}
+
+static PyObject *
+groupcount_reduce(groupcountobject *lz)
+{
+    /* reduce as a 'new' call with an optional 'setstate' if a group
+     * has been started
+     */
+    if (lz->currkey)
+        return Py_BuildValue("O(OO)(On)", Py_TYPE(lz),
+            lz->it, lz->keyfunc, lz->currkey, lz->count);
+    return Py_BuildValue("O(OO)", Py_TYPE(lz),
+        lz->it, lz->keyfunc);
+}
+
+static PyObject *
+groupcount_setstate(groupcountobject *lz, PyObject *state)
+{
+    PyObject *currkey;
+    Py_ssize_t count;
+    if (!PyTuple_Check(state)) {
+        PyErr_SetString(PyExc_TypeError, "state is not a tuple");
+        return NULL;
+    }
+    if (!PyArg_ParseTuple(state, "On", &currkey, &count)) {
+        return NULL;
+    }
+    if (count <= 0) {
+        PyErr_SetString(PyExc_ValueError, "invalid count");
+        return NULL;
+    }
+    Py_INCREF(currkey);
+    Py_XSETREF(lz->currkey, currkey);
+    lz->count = count;
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef groupcount_methods[] = {
+    {"__reduce__",      (PyCFunction)groupcount_reduce,   METH_NOARGS,
+     reduce_doc},
+    {"__setstate__",    (PyCFunction)groupcount_setstate, METH_O,
+     setstate_doc},
+    {NULL,              NULL}           /* sentinel */
+};
+
+PyDoc_STRVAR(groupcount_doc,
+"groupcount(iterable, key=None) -> make an iterator that returns (key, count)\n\
+pairs for the runs of consecutive elements with equal keys.  Unlike groupby(),\n\
+no object is created per group and the elements are not kept.  If the key\n\
+function is not specified or is None, the element itself is used.\n");
+
+static PyTypeObject groupcount_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "itertools.groupcount",             /* tp_name */
+    sizeof(groupcountobject),           /* tp_basicsize */
+    0,                                  /* tp_itemsize */
+    /* methods */
+    (destructor)groupcount_dealloc,     /* tp_dealloc */
+    0,                                  /* tp_print */
+    0,                                  /* tp_getattr */
+    0,                                  /* tp_setattr */
+    0,                                  /* tp_reserved */
+    0,                                  /* tp_repr */
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash */
+    0,                                  /* tp_call */
+    0,                                  /* tp_str */
+    PyObject_GenericGetAttr,            /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+        Py_TPFLAGS_BASETYPE,            /* tp_flags */
+    groupcount_doc,                     /* tp_doc */
+    (traverseproc)groupcount_traverse,  /* tp_traverse */
+    0,                                  /* tp_clear */
+    0,                                  /* tp_richcompare */
+    0,                                  /* tp_weaklistoffset */
+    PyObject_SelfIter,                  /* tp_iter */
+    (iternextfunc)groupcount_next,      /* tp_iternext */
+    groupcount_methods,                 /* tp_methods */
+    0,                                  /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    0,                                  /* tp_alloc */
+    groupcount_new,                     /* tp_new */
+    PyObject_GC_Del,                    /* tp_free */
+};
+
+
 /* tee object and with supporting function and objects ***********************/
 
 /* The teedataobject pre-allocates space for LINKCELLS number of objects.
@@ -388,39 +591,78 @@ static PyTypeObject _grouper_type = {
    value, the less memory overhead per object and the less time spent
    allocating/deallocating new links.  The smaller the number, the less
    wasted space and the more rapid freeing of older data.
+
+   LINKCELLS is the default size; tee(it, n, blocksize=...) allocates
+   larger links for long streams.  To keep the memory of large links
+   bounded, the values of the oldest link are released as soon as every
+   tee iterator reading it has passed them, and freed links are kept in
+   a small pool for reuse.
 */
 #define LINKCELLS 57
 
+/* At most TEE_POOL_MAXBLOCKS links of TEE_POOL_MAXCELLS cells in total are
+   kept in the pool */
+#define TEE_POOL_MAXBLOCKS 16
+#define TEE_POOL_MAXCELLS (64 * 1024)
+
+struct teeobject;
+
 typedef struct {
-    PyObject_HEAD
+    PyObject_VAR_HEAD           /* ob_size is the number of cells */
     PyObject *it;
-    int numread;                /* 0 <= numread <= LINKCELLS */
+    int numread;                /* 0 <= numread <= ob_size */
+    int released;               /* values[:released] have been cleared */
     int running;
     PyObject *nextlink;
-    PyObject *(values[LINKCELLS]);
+    struct teeobject *readers;  /* tee iterators reading this link */
+    PyObject *(values[1]);
 } teedataobject;
 
-typedef struct {
+typedef struct teeobject {
     PyObject_HEAD
     teedataobject *dataobj;
-    int index;                  /* 0 <= index <= LINKCELLS */
+    int index;                  /* 0 <= index <= Py_SIZE(dataobj) */
     PyObject *weakreflist;
+    /* list of the readers of dataobj, borrowed references */
+    struct teeobject *nextreader;
+    struct teeobject *prevreader;
 } teeobject;
 
 static PyTypeObject teedataobject_type;
 
+/* Freed links, chained through their nextlink member */
+static teedataobject *tee_pool = NULL;
+static Py_ssize_t tee_pool_blocks = 0;
+static Py_ssize_t tee_pool_cells = 0;
+
 static PyObject *
-teedataobject_newinternal(PyObject *it)
+teedataobject_newinternal(PyObject *it, Py_ssize_t size)
 {
-    teedataobject *tdo;
+    teedataobject *tdo, **ptdo;
 
-    tdo = PyObject_GC_New(teedataobject, &teedataobject_type);
-    if (tdo == NULL)
-        return NULL;
+    for (ptdo = &tee_pool; *ptdo != NULL;
+         ptdo = (teedataobject **)&(*ptdo)->nextlink) {
+        if (Py_SIZE(*ptdo) == size)
+            break;
+    }
+    if (*ptdo != NULL) {
+        tdo = *ptdo;
+        *ptdo = (teedataobject *)tdo->nextlink;
+        tee_pool_blocks--;
+        tee_pool_cells -= size;
+        _Py_NewReference((PyObject *)tdo);
+    }
+    else {
+        tdo = PyObject_GC_NewVar(teedataobject, &teedataobject_type, size);
+        if (tdo == NULL)
+            return NULL;
+    }
 
     tdo->running = 0;
     tdo->numread = 0;
+    tdo->released = 0;
     tdo->nextlink = NULL;
+    tdo->readers = NULL;
     Py_INCREF(it);
     tdo->it = it;
     PyObject_GC_Track(tdo);
@@ -431,7 +673,7 @@ static PyObject *
 teedataobject_jumplink(teedataobject *tdo)
 {
     if (tdo->nextlink == NULL)
-        tdo->nextlink = teedataobject_newinternal(tdo->it);
+        tdo->nextlink = teedataobject_newinternal(tdo->it, Py_SIZE(tdo));
     Py_XINCREF(tdo->nextlink);
     return tdo->nextlink;
 }
@@ -441,9 +683,11 @@ teedataobject_getitem(teedataobject *tdo, int i)
 {
     PyObject *value;
 
-    assert(i < LINKCELLS);
-    if (i < tdo->numread)
+    assert(i < Py_SIZE(tdo));
+    if (i < tdo->numread) {
         value = tdo->values[i];
+        assert(value != NULL);
+    }
     else {
         /* this is the lead iterator, so fetch more data */
         assert(i == tdo->numread);
@@ -509,9 +753,47 @@ teedataobject_dealloc(teedataobject *tdo)
 {
     PyObject_GC_UnTrack(tdo);
     teedataobject_clear(tdo);
+    assert(tdo->readers == NULL);
+    if (tee_pool_blocks < TEE_POOL_MAXBLOCKS &&
+        tee_pool_cells + Py_SIZE(tdo) <= TEE_POOL_MAXCELLS) {
+        tdo->nextlink = (PyObject *)tee_pool;
+        tee_pool = tdo;
+        tee_pool_blocks++;
+        tee_pool_cells += Py_SIZE(tdo);
+        return;
+    }
     PyObject_GC_Del(tdo);
 }
 
+/* Clear the values of the link which no tee iterator can read anymore:
+   the link must be the oldest one (only referenced by its readers) and the
+   values must be before the index of every reader. */
+static void
+teedataobject_release(teedataobject *tdo)
+{
+    teeobject *to;
+    Py_ssize_t nreaders = 0;
+    int low = Py_SAFE_DOWNCAST(Py_SIZE(tdo), Py_ssize_t, int);
+    PyObject *value;
+
+    for (to = tdo->readers; to != NULL; to = to->nextreader) {
+        nreaders++;
+        low = Py_MIN(low, to->index);
+    }
+    if (Py_REFCNT(tdo) != nreaders || low <= tdo->released)
+        return;
+
+    /* Decref'ing a value can run arbitrary code */
+    Py_INCREF(tdo);
+    while (tdo->released < low) {
+        value = tdo->values[tdo->released];
+        tdo->values[tdo->released] = NULL;
+        tdo->released++;
+        Py_DECREF(value);
+    }
+    Py_DECREF(tdo);
+}
+
 static PyObject *
 teedataobject_reduce(teedataobject *tdo)
 {
@@ -522,12 +804,15 @@ teedataobject_reduce(teedataobject *tdo)
     if (!values)
         return NULL;
     for (i=0 ; i<tdo->numread ; i++) {
-        Py_INCREF(tdo->values[i]);
-        PyList_SET_ITEM(values, i, tdo->values[i]);
+        /* released values can't be read anymore, keep their place */
+        PyObject *value = tdo->values[i] ? tdo->values[i] : Py_None;
+        Py_INCREF(value);
+        PyList_SET_ITEM(values, i, value);
     }
-    return Py_BuildValue("O(ONO)", Py_TYPE(tdo), tdo->it,
+    return Py_BuildValue("O(ONOn)", Py_TYPE(tdo), tdo->it,
                          values,
-                         tdo->nextlink ? tdo->nextlink : Py_None);
+                         tdo->nextlink ? tdo->nextlink : Py_None,
+                         Py_SIZE(tdo));
 }
 
 static PyTypeObject teedataobject_type;
@@ -537,27 +822,32 @@ teedataobject_new(PyTypeObject *type, PyObject *args, PyObject *kw)
 {
     teedataobject *tdo;
     PyObject *it, *values, *next;
-    Py_ssize_t i, len;
+    Py_ssize_t i, len, size = LINKCELLS;
 
     assert(type == &teedataobject_type);
-    if (!PyArg_ParseTuple(args, "OO!O", &it, &PyList_Type, &values, &next))
+    if (!PyArg_ParseTuple(args, "OO!O|n", &it, &PyList_Type, &values, &next,
+                          &size))
+        return NULL;
+    if (size <= 0 || size > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Invalid arguments");
         return NULL;
+    }
 
-    tdo = (teedataobject *)teedataobject_newinternal(it);
+    tdo = (teedataobject *)teedataobject_newinternal(it, size);
     if (!tdo)
         return NULL;
 
     len = PyList_GET_SIZE(values);
-    if (len > LINKCELLS)
+    if (len > size)
         goto err;
     for (i=0; i<len; i++) {
         tdo->values[i] = PyList_GET_ITEM(values, i);
         Py_INCREF(tdo->values[i]);
     }
-    /* len <= LINKCELLS < INT_MAX */
+    /* len <= size <= INT_MAX */
     tdo->numread = Py_SAFE_DOWNCAST(len, Py_ssize_t, int);
 
-    if (len == LINKCELLS) {
+    if (len == size) {
         if (next != Py_None) {
             if (Py_TYPE(next) != &teedataobject_type)
                 goto err;
@@ -588,8 +878,8 @@ PyDoc_STRVAR(teedataobject_doc, "Data container common to multiple tee objects."
 static PyTypeObject teedataobject_type = {
     PyVarObject_HEAD_INIT(0, 0)                 /* Must fill in type value later */
     "itertools._tee_dataobject",                /* tp_name */
-    sizeof(teedataobject),                      /* tp_basicsize */
-    0,                                          /* tp_itemsize */
+    sizeof(teedataobject) - sizeof(PyObject *), /* tp_basicsize */
+    sizeof(PyObject *),                         /* tp_itemsize */
     /* methods */
     (destructor)teedataobject_dealloc,          /* tp_dealloc */
     0,                                          /* tp_print */
@@ -631,22 +921,60 @@ static PyTypeObject teedataobject_type = {
 
 static PyTypeObject tee_type;
 
+/* Make the tee iterator read the link tdo, stealing a reference to it */
+static void
+tee_attach(teeobject *to, teedataobject *tdo)
+{
+    to->dataobj = tdo;
+    to->prevreader = NULL;
+    to->nextreader = tdo->readers;
+    if (tdo->readers != NULL)
+        tdo->readers->prevreader = to;
+    tdo->readers = to;
+}
+
+/* Remove the tee iterator from the readers of its link and return the
+   reference to the link */
+static teedataobject *
+tee_detach(teeobject *to)
+{
+    teedataobject *tdo = to->dataobj;
+
+    if (tdo == NULL)
+        return NULL;
+    if (to->prevreader != NULL)
+        to->prevreader->nextreader = to->nextreader;
+    else
+        tdo->readers = to->nextreader;
+    if (to->nextreader != NULL)
+        to->nextreader->prevreader = to->prevreader;
+    to->dataobj = NULL;
+    to->nextreader = to->prevreader = NULL;
+    return tdo;
+}
+
 static PyObject *
 tee_next(teeobject *to)
 {
     PyObject *value, *link;
+    teedataobject *tdo;
 
-    if (to->index >= LINKCELLS) {
+    if (to->index >= Py_SIZE(to->dataobj)) {
         link = teedataobject_jumplink(to->dataobj);
         if (link == NULL)
             return NULL;
-        Py_SETREF(to->dataobj, (teedataobject *)link);
+        tdo = tee_detach(to);
+        tee_attach(to, (teedataobject *)link);
         to->index = 0;
+        Py_DECREF(tdo);
     }
     value = teedataobject_getitem(to->dataobj, to->index);
     if (value == NULL)
         return NULL;
     to->index++;
+    /* the slowest reader of the link may release the values behind it */
+    if (to->index - 1 == to->dataobj->released)
+        teedataobject_release(to->dataobj);
     return value;
 }
 
@@ -666,7 +994,7 @@ tee_copy(teeobject *to)
     if (newto == NULL)
         return NULL;
     Py_INCREF(to->dataobj);
-    newto->dataobj = to->dataobj;
+    tee_attach(newto, to->dataobj);
     newto->index = to->index;
     newto->weakreflist = NULL;
     PyObject_GC_Track(newto);
@@ -676,9 +1004,10 @@ tee_copy(teeobject *to)
 PyDoc_STRVAR(teecopy_doc, "Returns an independent iterator.");
 
 static PyObject *
-tee_fromiterable(PyObject *iterable)
+tee_fromiterable(PyObject *iterable, Py_ssize_t blocksize)
 {
     teeobject *to;
+    teedataobject *tdo;
     PyObject *it = NULL;
 
     it = PyObject_GetIter(iterable);
@@ -692,13 +1021,14 @@ tee_fromiterable(PyObject *iterable)
     to = PyObject_GC_New(teeobject, &tee_type);
     if (to == NULL)
         goto done;
-    to->dataobj = (teedataobject *)teedataobject_newinternal(it);
-    if (!to->dataobj) {
+    tdo = (teedataobject *)teedataobject_newinternal(it, blocksize);
+    if (!tdo) {
         PyObject_GC_Del(to);
         to = NULL;
         goto done;
     }
 
+    tee_attach(to, tdo);
     to->index = 0;
     to->weakreflist = NULL;
     PyObject_GC_Track(to);
@@ -714,7 +1044,7 @@ tee_new(PyTypeObject *type, PyObject *args, PyObject *kw)
 
     if (!PyArg_UnpackTuple(args, "_tee", 1, 1, &iterable))
         return NULL;
-    return tee_fromiterable(iterable);
+    return tee_fromiterable(iterable, LINKCELLS);
 }
 
 static int
@@ -722,7 +1052,7 @@ tee_clear(teeobject *to)
 {
     if (to->weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject *) to);
-    Py_CLEAR(to->dataobj);
+    Py_XDECREF(tee_detach(to));
     return 0;
 }
 
@@ -743,7 +1073,7 @@ tee_reduce(teeobject *to)
 static PyObject *
 tee_setstate(teeobject *to, PyObject *state)
 {
-    teedataobject *tdo;
+    teedataobject *tdo, *old;
     int index;
     if (!PyTuple_Check(state)) {
         PyErr_SetString(PyExc_TypeError, "state is not a tuple");
@@ -752,13 +1082,15 @@ tee_setstate(teeobject *to, PyObject *state)
     if (!PyArg_ParseTuple(state, "O!i", &teedataobject_type, &tdo, &index)) {
         return NULL;
     }
-    if (index < 0 || index > LINKCELLS) {
+    if (index < tdo->released || index > Py_SIZE(tdo)) {
         PyErr_SetString(PyExc_ValueError, "Index out of range");
         return NULL;
     }
     Py_INCREF(tdo);
-    Py_XSETREF(to->dataobj, tdo);
+    old = tee_detach(to);
+    tee_attach(to, tdo);
     to->index = index;
+    Py_XDECREF(old);
     Py_RETURN_NONE;
 }
 
@@ -816,18 +1148,24 @@ static PyTypeObject tee_type = {
 };
 
 static PyObject *
-tee(PyObject *self, PyObject *args)
+tee(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    Py_ssize_t i, n=2;
+    static char *kwargs[] = {"iterable", "n", "blocksize", NULL};
+    Py_ssize_t i, n=2, blocksize=LINKCELLS;
     PyObject *it, *iterable, *copyable, *copyfunc, *result;
     _Py_IDENTIFIER(__copy__);
 
-    if (!PyArg_ParseTuple(args, "O|n", &iterable, &n))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|n$n:tee", kwargs,
+                                     &iterable, &n, &blocksize))
         return NULL;
     if (n < 0) {
         PyErr_SetString(PyExc_ValueError, "n must be >= 0");
         return NULL;
     }
+    if (blocksize <= 0 || blocksize > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "blocksize out of range");
+        return NULL;
+    }
     result = PyTuple_New(n);
     if (result == NULL)
         return NULL;
@@ -848,7 +1186,7 @@ tee(PyObject *self, PyObject *args)
         copyable = it;
     }
     else {
-        copyable = tee_fromiterable(it);
+        copyable = tee_fromiterable(it, blocksize);
         Py_DECREF(it);
         if (copyable == NULL) {
             Py_DECREF(result);
@@ -877,7 +1215,9 @@ tee(PyObject *self, PyObject *args)
 }
 
 PyDoc_STRVAR(tee_doc,
-"tee(iterable, n=2) --> tuple of n independent iterators.");
+"tee(iterable, n=2, *, blocksize=57) --> tuple of n independent iterators.\n\
+\n\
+The values are buffered in links of blocksize values each.");
 
 
 /* cycle object **************************************************************/
@@ -4628,6 +4968,7 @@ chain.from_iterable([p, q, ...]) --> p0, p1, ... plast, q0, q1, ... \n\
 compress(data, selectors) --> (d[0] if s[0]), (d[1] if s[1]), ...\n\
 dropwhile(pred, seq) --> seq[n], seq[n+1], starting when pred fails\n\
 groupby(iterable[, keyfunc]) --> sub-iterators grouped by value of keyfunc(v)\n\
+groupcount(iterable[, keyfunc]) --> (key, count) of each run of keyfunc(v)\n\
 filterfalse(pred, seq) --> elements of seq where pred(elem) is False\n\
 islice(seq, [start,] stop [, step]) --> elements from\n\
        seq[start:stop:step]\n\
@@ -4645,7 +4986,8 @@ combinations_with_replacement(p, r)\n\
 
 
 static PyMethodDef module_methods[] = {
-    {"tee",     (PyCFunction)tee,       METH_VARARGS, tee_doc},
+    {"tee",     (PyCFunction)tee,       METH_VARARGS | METH_KEYWORDS,
+     tee_doc},
     {NULL,              NULL}           /* sentinel */
 };
 
@@ -4687,6 +5029,7 @@ PyInit_itertools(void)
         &repeat_type,
         &groupby_type,
         &_grouper_type,
+        &groupcount_type,
         &tee_type,
         &teedataobject_type,
         NULL
@@ -5,8 +5,12 @@
 #include "internal/import.h"
 #include "internal/pygetopt.h"
 #include "internal/pystate.h"
+#include "pythread.h"
 
 #include <locale.h>
+#ifdef HAVE_FCNTL_H
+#  include <fcntl.h>
+#endif
 
 #if defined(MS_WINDOWS) || defined(__CYGWIN__)
 #  include <windows.h>
@@ -175,7 +179,13 @@ static const char usage_6[] =
 "   locale coercion and locale compatibility warnings on stderr.\n"
 "PYTHONBREAKPOINT: if this variable is set to 0, it disables the default\n"
 "   debugger. It can be set to the callable of your debugger of choice.\n"
-"PYTHONDEVMODE: enable the development mode.\n";
+"PYTHONDEVMODE: enable the development mode.\n"
+"PYTHONZIPPREFETCH: import manifest of files in Zip archives to decompress\n"
+"   in background threads at startup.\n"
+"PYTHONGETPATHTRACE: report the filesystem probes made to compute sys.path\n"
+"   and their cost on stderr.\n"
+"PYTHONSTARTUPTRACE: file to append the duration of the startup phases and\n"
+"   of the imports from Zip archives to, in the Chrome trace event format.\n";
 
 static void
 pymain_usage(int error, const wchar_t* program)
@@ -253,6 +263,111 @@ config_get_env_var_dup(wchar_t **dest, wchar_t *wname, char *name)
 }
 
 
+/* The startup trace: if $PYTHONSTARTUPTRACE names a file, the duration of
+   the startup phases, of the path configuration and of each import from a
+   Zip archive is appended to it as a "complete" event of the Chrome trace
+   event format.  The file uses the JSON array format, whose closing bracket
+   is optional, and events are timestamped with the monotonic clock, so that
+   other libraries of the process (e.g. Qt with $QT_STARTUP_TRACE) can append
+   their own events to the same file.  It can be opened with chrome://tracing
+   or Perfetto. */
+
+/* -2: $PYTHONSTARTUPTRACE not read yet, -1: no startup trace */
+static int startup_trace_fd = -2;
+
+int
+_PyStartupTrace_Enabled(void)
+{
+    if (startup_trace_fd != -2) {
+        return startup_trace_fd >= 0;
+    }
+    startup_trace_fd = -1;
+
+    const char *path = config_get_env_var("PYTHONSTARTUPTRACE");
+    if (path == NULL) {
+        return 0;
+    }
+
+    int flags = O_WRONLY | O_CREAT | O_APPEND;
+#ifdef MS_WINDOWS
+    flags |= O_BINARY | O_NOINHERIT;
+#elif defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+    int fd = open(path, flags, 0666);
+    if (fd < 0) {
+        fprintf(stderr, "Failed opening PYTHONSTARTUPTRACE %s: %s\n",
+                path, strerror(errno));
+        return 0;
+    }
+    /* O_APPEND makes each event a single atomic write: only the first
+       writer of the file starts the array */
+    if (lseek(fd, 0, SEEK_END) == 0) {
+        _Py_write_noraise(fd, "[\n", 2);
+    }
+    startup_trace_fd = fd;
+    return 1;
+}
+
+
+/* Copy a UTF-8 string as the contents of a JSON string */
+static void
+startup_trace_escape(char *dest, size_t size, const char *str)
+{
+    size_t len = 0;
+
+    for (; *str != '\0' && len + 7 < size; str++) {
+        unsigned char ch = (unsigned char)*str;
+        if (ch == '"' || ch == '\\') {
+            dest[len++] = '\\';
+            dest[len++] = ch;
+        }
+        else if (ch < 0x20) {
+            len += sprintf(dest + len, "\\u%04x", ch);
+        }
+        else {
+            dest[len++] = ch;
+        }
+    }
+    dest[len] = '\0';
+}
+
+
+/* Append the event of something which started at 'start' (see
+   _PyTime_GetMonotonicClock()) and is ending now.  Doesn't need the GIL. */
+void
+_PyStartupTrace_Event(const char *category, const char *name,
+                      _PyTime_t start)
+{
+    if (!_PyStartupTrace_Enabled()) {
+        return;
+    }
+
+    _PyTime_t duration = _PyTime_GetMonotonicClock() - start;
+    char escaped[512];
+    char event[sizeof(escaped) + 160];
+    long pid;
+
+#ifdef MS_WINDOWS
+    pid = (long)GetCurrentProcessId();
+#else
+    pid = (long)getpid();
+#endif
+    startup_trace_escape(escaped, sizeof(escaped), name);
+    int len = PyOS_snprintf(
+        event, sizeof(event),
+        "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,"
+        "\"dur\":%lld,\"pid\":%ld,\"tid\":%lu},\n",
+        escaped, category,
+        (long long)_PyTime_AsMicroseconds(start, _PyTime_ROUND_FLOOR),
+        (long long)_PyTime_AsMicroseconds(duration, _PyTime_ROUND_CEILING),
+        pid, PyThread_get_thread_ident());
+    if (len > 0 && (size_t)len < sizeof(event)) {
+        _Py_write_noraise(startup_trace_fd, event, (size_t)len);
+    }
+}
+
+
 static void
 pymain_run_startup(PyCompilerFlags *cf)
 {
@@ -279,6 +394,36 @@ pymain_run_startup(PyCompilerFlags *cf)
     fclose(fp);
 }
 
+/* Start decompressing the files listed in the PYTHONZIPPREFETCH import
+   manifest so that they are ready by the time they are imported. */
+static void
+pymain_run_zip_prefetch(void)
+{
+    const char *manifest = config_get_env_var("PYTHONZIPPREFETCH");
+    if (manifest == NULL) {
+        return;
+    }
+
+    PyObject *zipimport, *result;
+    zipimport = PyImport_ImportModule("zipimport");
+    if (zipimport == NULL) {
+        goto error;
+    }
+
+    result = PyObject_CallMethod(zipimport, "_prefetch", "s", manifest);
+    Py_DECREF(zipimport);
+    if (result == NULL) {
+        goto error;
+    }
+    Py_DECREF(result);
+    return;
+
+error:
+    PySys_WriteStderr("Failed prefetching PYTHONZIPPREFETCH\n");
+    PyErr_Print();
+    PyErr_Clear();
+}
+
 static void
 pymain_run_interactive_hook(void)
 {
@@ -2893,7 +3038,9 @@ static void
 pymain_run_python(_PyMain *pymain)
 {
     PyCompilerFlags cf = {.cf_flags = 0};
+    _PyTime_t start = _PyTime_GetMonotonicClock();
 
+    pymain_run_zip_prefetch();
     pymain_header(pymain);
     pymain_import_readline(pymain);
 
@@ -2908,6 +3055,7 @@ pymain_run_python(_PyMain *pymain)
     }
 
     pymain_repl(pymain, &cf);
+    _PyStartupTrace_Event("python", "run", start);
 }
 
 
@@ -3026,6 +3174,7 @@ pymain_init(_PyMain *pymain)
     config->install_signal_handlers = 1;
     _PyCoreConfig_GetGlobalConfig(config);
 
+    _PyTime_t start = _PyTime_GetMonotonicClock();
     int res = pymain_cmdline(pymain, config);
     if (res < 0) {
         _Py_FatalInitError(pymain->err);
@@ -3036,16 +3185,20 @@ pymain_init(_PyMain *pymain)
     }
 
     pymain_init_stdio(pymain);
+    _PyStartupTrace_Event("python", "read configuration", start);
 
+    start = _PyTime_GetMonotonicClock();
     PyInterpreterState *interp;
     pymain->err = _Py_InitializeCore(&interp, config);
     if (_Py_INIT_FAILED(pymain->err)) {
         _Py_FatalInitError(pymain->err);
     }
+    _PyStartupTrace_Event("python", "initialize core", start);
 
     pymain_clear_config(&local_config);
     config = &interp->core_config;
 
+    start = _PyTime_GetMonotonicClock();
     if (pymain_init_python_main(pymain, interp) < 0) {
         _Py_FatalInitError(pymain->err);
     }
@@ -3053,6 +3206,7 @@ pymain_init(_PyMain *pymain)
     if (pymain_init_sys_path(pymain, config) < 0) {
         _Py_FatalInitError(pymain->err);
     }
+    _PyStartupTrace_Event("python", "initialize main interpreter", start);
     return 0;
 }
 
@@ -3067,11 +3221,13 @@ pymain_main(_PyMain *pymain)
 
     pymain_run_python(pymain);
 
+    _PyTime_t start = _PyTime_GetMonotonicClock();
     if (Py_FinalizeEx() < 0) {
         /* Value unlikely to be confused with a non-error exit status or
            other special meaning */
         pymain->status = 120;
     }
+    _PyStartupTrace_Event("python", "finalize", start);
 
 done:
     pymain_free(pymain);
@@ -1231,6 +1231,30 @@ FUNC1(tanh, tanh, 0,
 
 #define NUM_PARTIALS  32  /* initial partials array size, on stack */
 
+/* Running state of an fsum: the partials and the sums of special values */
+typedef struct {
+    Py_ssize_t n, m;
+    double *p;
+    double ps[NUM_PARTIALS];
+    double special_sum, inf_sum;
+} fsum_state;
+
+static void
+_fsum_init(fsum_state *st)
+{
+    st->n = 0;
+    st->m = NUM_PARTIALS;
+    st->p = st->ps;
+    st->special_sum = st->inf_sum = 0.0;
+}
+
+static void
+_fsum_free(fsum_state *st)
+{
+    if (st->p != st->ps)
+        PyMem_Free(st->p);
+}
+
 /* Extend the partials array p[] by doubling its size. */
 static int                          /* non-zero on error */
 _fsum_realloc(double **p_ptr, Py_ssize_t  n,
@@ -1289,6 +1313,133 @@ _fsum_realloc(double **p_ptr, Py_ssize_t  n,
    Depends on IEEE 754 arithmetic guarantees and half-even rounding.
 */
 
+/* Add x to the partials:  the body of the "for x in iterable" loop. */
+static int                          /* non-zero on error */
+_fsum_add(fsum_state *st, double x)
+{
+    Py_ssize_t i, j, n = st->n;
+    double y, t, xsave, *p = st->p;
+    volatile double hi, yr, lo;
+
+    assert(0 <= n && n <= st->m);
+    assert((st->m == NUM_PARTIALS && p == st->ps) ||
+           (st->m >  NUM_PARTIALS && p != NULL));
+
+    xsave = x;
+    for (i = j = 0; j < n; j++) {       /* for y in partials */
+        y = p[j];
+        if (fabs(x) < fabs(y)) {
+            t = x; x = y; y = t;
+        }
+        hi = x + y;
+        yr = hi - x;
+        lo = y - yr;
+        if (lo != 0.0)
+            p[i++] = lo;
+        x = hi;
+    }
+
+    n = i;                              /* ps[i:] = [x] */
+    if (x != 0.0) {
+        if (! Py_IS_FINITE(x)) {
+            /* a nonfinite x could arise either as
+               a result of intermediate overflow, or
+               as a result of a nan or inf in the
+               summands */
+            if (Py_IS_FINITE(xsave)) {
+                PyErr_SetString(PyExc_OverflowError,
+                      "intermediate overflow in fsum");
+                return 1;
+            }
+            if (Py_IS_INFINITY(xsave))
+                st->inf_sum += xsave;
+            st->special_sum += xsave;
+            /* reset partials */
+            n = 0;
+        }
+        else if (n >= st->m && _fsum_realloc(&st->p, n, st->ps, &st->m))
+            return 1;
+        else
+            st->p[n++] = x;
+    }
+    st->n = n;
+    return 0;
+}
+
+/* Return the correctly rounded sum of the partials as a float object. */
+static PyObject *
+_fsum_result(fsum_state *st)
+{
+    Py_ssize_t n = st->n;
+    double x, y, *p = st->p;
+    volatile double hi, yr, lo;
+
+    if (st->special_sum != 0.0) {
+        if (Py_IS_NAN(st->inf_sum)) {
+            PyErr_SetString(PyExc_ValueError,
+                            "-inf + inf in fsum");
+            return NULL;
+        }
+        return PyFloat_FromDouble(st->special_sum);
+    }
+
+    hi = 0.0;
+    if (n > 0) {
+        hi = p[--n];
+        /* sum_exact(ps, hi) from the top, stop when the sum becomes
+           inexact. */
+        while (n > 0) {
+            x = hi;
+            y = p[--n];
+            assert(fabs(y) < fabs(x));
+            hi = x + y;
+            yr = hi - x;
+            lo = y - yr;
+            if (lo != 0.0)
+                break;
+        }
+        /* Make half-even rounding work across multiple partials.
+           Needed so that sum([1e-16, 1, 1e16]) will round-up the last
+           digit to two instead of down to zero (the 1e-16 makes the 1
+           slightly closer to two).  With a potential 1 ULP rounding
+           error fixed-up, math.fsum() can guarantee commutativity. */
+        if (n > 0 && ((lo < 0.0 && p[n-1] < 0.0) ||
+                      (lo > 0.0 && p[n-1] > 0.0))) {
+            y = lo * 2.0;
+            x = hi + y;
+            yr = x - hi;
+            if (y == yr)
+                hi = x;
+        }
+    }
+    return PyFloat_FromDouble(hi);
+}
+
+/* If obj exports its items as a contiguous vector of C doubles (an
+   array('d'), a memoryview cast to 'd', ...), get that buffer and return
+   1.  Return 0 if it doesn't; the caller then goes through the iterator
+   protocol, which yields the same values. */
+static int
+_get_double_buffer(PyObject *obj, Py_buffer *view)
+{
+    const char *format;
+
+    if (!PyObject_CheckBuffer(obj))
+        return 0;
+    if (PyObject_GetBuffer(obj, view, PyBUF_ND | PyBUF_FORMAT) < 0) {
+        PyErr_Clear();
+        return 0;
+    }
+    format = view->format;
+    if (format != NULL && *format == '@')
+        format++;
+    if (view->ndim <= 1 && view->itemsize == sizeof(double) &&
+        format != NULL && strcmp(format, "d") == 0)
+        return 1;
+    PyBuffer_Release(view);
+    return 0;
+}
+
 /*[clinic input]
 math.fsum
 
@@ -1305,10 +1456,30 @@ math_fsum(PyObject *module, PyObject *seq)
 /*[clinic end generated code: output=ba5c672b87fe34fc input=c51b7d8caf6f6e82]*/
 {
     PyObject *item, *iter, *sum = NULL;
-    Py_ssize_t i, j, n = 0, m = NUM_PARTIALS;
-    double x, y, t, ps[NUM_PARTIALS], *p = ps;
-    double xsave, special_sum = 0.0, inf_sum = 0.0;
-    volatile double hi, yr, lo;
+    Py_buffer view;
+    Py_ssize_t i, len;
+    fsum_state st;
+    double x;
+
+    _fsum_init(&st);
+
+    /* Doubles straight from a buffer, without a float object per item */
+    if (_get_double_buffer(seq, &view)) {
+        const double *data = (const double *)view.buf;
+
+        len = view.len / sizeof(double);
+        PyFPE_START_PROTECT("fsum", PyBuffer_Release(&view); return NULL)
+        for (i = 0; i < len; i++) {
+            if (_fsum_add(&st, data[i]))
+                break;
+        }
+        if (i == len)
+            sum = _fsum_result(&st);
+        PyFPE_END_PROTECT(st.special_sum)
+        PyBuffer_Release(&view);
+        _fsum_free(&st);
+        return sum;
+    }
 
     iter = PyObject_GetIter(seq);
     if (iter == NULL)
@@ -1317,10 +1488,6 @@ math_fsum(PyObject *module, PyObject *seq)
     PyFPE_START_PROTECT("fsum", Py_DECREF(iter); return NULL)
 
     for(;;) {           /* for x in iterable */
-        assert(0 <= n && n <= m);
-        assert((m == NUM_PARTIALS && p == ps) ||
-               (m >  NUM_PARTIALS && p != NULL));
-
         item = PyIter_Next(iter);
         if (item == NULL) {
             if (PyErr_Occurred())
@@ -1331,92 +1498,245 @@ math_fsum(PyObject *module, PyObject *seq)
         Py_DECREF(item);
         if (PyErr_Occurred())
             goto _fsum_error;
+        if (_fsum_add(&st, x))
+            goto _fsum_error;
+    }
 
-        xsave = x;
-        for (i = j = 0; j < n; j++) {       /* for y in partials */
-            y = p[j];
-            if (fabs(x) < fabs(y)) {
-                t = x; x = y; y = t;
-            }
-            hi = x + y;
-            yr = hi - x;
-            lo = y - yr;
-            if (lo != 0.0)
-                p[i++] = lo;
-            x = hi;
-        }
+    sum = _fsum_result(&st);
 
-        n = i;                              /* ps[i:] = [x] */
-        if (x != 0.0) {
-            if (! Py_IS_FINITE(x)) {
-                /* a nonfinite x could arise either as
-                   a result of intermediate overflow, or
-                   as a result of a nan or inf in the
-                   summands */
-                if (Py_IS_FINITE(xsave)) {
-                    PyErr_SetString(PyExc_OverflowError,
-                          "intermediate overflow in fsum");
-                    goto _fsum_error;
-                }
-                if (Py_IS_INFINITY(xsave))
-                    inf_sum += xsave;
-                special_sum += xsave;
-                /* reset partials */
-                n = 0;
+_fsum_error:
+    PyFPE_END_PROTECT(st.special_sum)
+    Py_DECREF(iter);
+    _fsum_free(&st);
+    return sum;
+}
+
+
+PyDoc_STRVAR(math_prod_doc,
+"prod($module, iterable, /, *, start=1)\n"
+"--\n"
+"\n"
+"Return the product of a 'start' value (default: 1) times an iterable\n"
+"of numbers.\n"
+"\n"
+"When the iterable is empty, return the start value.  A buffer of\n"
+"doubles, such as array('d'), is multiplied without creating a float\n"
+"object per item.");
+
+static PyObject *
+math_prod(PyObject *module, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"", "start", NULL};
+    PyObject *iterable, *start = NULL, *result, *iter, *item, *temp;
+    Py_buffer view;
+    Py_ssize_t i, len;
+    double f_result;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|$O:prod", kwlist,
+                                     &iterable, &start))
+        return NULL;
+
+    if (start == NULL)
+        result = PyLong_FromLong(1);
+    else {
+        Py_INCREF(start);
+        result = start;
+    }
+    if (result == NULL)
+        return NULL;
+
+    if ((PyFloat_CheckExact(result) || PyLong_CheckExact(result)) &&
+        _get_double_buffer(iterable, &view)) {
+        const double *data = (const double *)view.buf;
+
+        len = view.len / sizeof(double);
+        if (len > 0) {
+            f_result = PyFloat_AsDouble(result);
+            Py_DECREF(result);
+            if (f_result == -1.0 && PyErr_Occurred()) {
+                PyBuffer_Release(&view);
+                return NULL;
             }
-            else if (n >= m && _fsum_realloc(&p, n, ps, &m))
-                goto _fsum_error;
-            else
-                p[n++] = x;
+            for (i = 0; i < len; i++)
+                f_result *= data[i];
+            result = PyFloat_FromDouble(f_result);
         }
+        PyBuffer_Release(&view);
+        return result;
     }
 
-    if (special_sum != 0.0) {
-        if (Py_IS_NAN(inf_sum))
-            PyErr_SetString(PyExc_ValueError,
-                            "-inf + inf in fsum");
-        else
-            sum = PyFloat_FromDouble(special_sum);
-        goto _fsum_error;
+    iter = PyObject_GetIter(iterable);
+    if (iter == NULL) {
+        Py_DECREF(result);
+        return NULL;
     }
 
-    hi = 0.0;
-    if (n > 0) {
-        hi = p[--n];
-        /* sum_exact(ps, hi) from the top, stop when the sum becomes
-           inexact. */
-        while (n > 0) {
-            x = hi;
-            y = p[--n];
-            assert(fabs(y) < fabs(x));
-            hi = x + y;
-            yr = hi - x;
-            lo = y - yr;
-            if (lo != 0.0)
+    /* Multiply runs of floats as C doubles */
+    while ((item = PyIter_Next(iter)) != NULL) {
+        if (PyFloat_CheckExact(result) && PyFloat_CheckExact(item)) {
+            f_result = PyFloat_AS_DOUBLE(result) * PyFloat_AS_DOUBLE(item);
+            Py_DECREF(item);
+            while ((item = PyIter_Next(iter)) != NULL &&
+                   PyFloat_CheckExact(item)) {
+                f_result *= PyFloat_AS_DOUBLE(item);
+                Py_DECREF(item);
+            }
+            Py_SETREF(result, PyFloat_FromDouble(f_result));
+            if (result == NULL || item == NULL) {
+                Py_XDECREF(item);
                 break;
+            }
         }
-        /* Make half-even rounding work across multiple partials.
-           Needed so that sum([1e-16, 1, 1e16]) will round-up the last
-           digit to two instead of down to zero (the 1e-16 makes the 1
-           slightly closer to two).  With a potential 1 ULP rounding
-           error fixed-up, math.fsum() can guarantee commutativity. */
-        if (n > 0 && ((lo < 0.0 && p[n-1] < 0.0) ||
-                      (lo > 0.0 && p[n-1] > 0.0))) {
-            y = lo * 2.0;
-            x = hi + y;
-            yr = x - hi;
-            if (y == yr)
-                hi = x;
+        temp = PyNumber_Multiply(result, item);
+        Py_DECREF(item);
+        Py_SETREF(result, temp);
+        if (result == NULL)
+            break;
+    }
+    Py_DECREF(iter);
+    if (PyErr_Occurred()) {
+        Py_XDECREF(result);
+        return NULL;
+    }
+    return result;
+}
+
+
+/* Add the exact product x*y to the partials: fma() gives the rounding
+   error of x*y, so the two parts sum to the product exactly. */
+static int                          /* non-zero on error */
+_fsum_add_product(fsum_state *st, double x, double y)
+{
+    double p = x * y;
+
+    if (_fsum_add(st, p))
+        return 1;
+    if (Py_IS_FINITE(p) && _fsum_add(st, fma(x, y, -p)))
+        return 1;
+    return 0;
+}
+
+PyDoc_STRVAR(math_sumprod_doc,
+"sumprod($module, p, q, /)\n"
+"--\n"
+"\n"
+"Return the sum of products of values from two iterables p and q.\n"
+"\n"
+"Roughly equivalent to sum(map(operator.mul, p, q)), but p and q must\n"
+"have the same length.  Products of floats are summed as accurately as\n"
+"fsum() does; other products are added up with +.  Two buffers of\n"
+"doubles, such as array('d'), are used without creating float objects.");
+
+static PyObject *
+math_sumprod(PyObject *module, PyObject *args)
+{
+    PyObject *p, *q, *p_it = NULL, *q_it = NULL, *p_item, *q_item;
+    PyObject *total = NULL, *term, *fsum, *result = NULL;
+    Py_buffer p_view, q_view;
+    Py_ssize_t i, len;
+    fsum_state st;
+    int float_terms = 0;
+
+    if (!PyArg_UnpackTuple(args, "sumprod", 2, 2, &p, &q))
+        return NULL;
+
+    _fsum_init(&st);
+
+    if (_get_double_buffer(p, &p_view)) {
+        if (_get_double_buffer(q, &q_view)) {
+            const double *pd = (const double *)p_view.buf;
+            const double *qd = (const double *)q_view.buf;
+
+            len = p_view.len / sizeof(double);
+            if (len != q_view.len / (Py_ssize_t)sizeof(double))
+                PyErr_SetString(PyExc_ValueError,
+                                "Inputs are not the same length");
+            else {
+                for (i = 0; i < len; i++) {
+                    if (_fsum_add_product(&st, pd[i], qd[i]))
+                        break;
+                }
+                if (i == len)
+                    result = _fsum_result(&st);
+            }
+            PyBuffer_Release(&q_view);
+            PyBuffer_Release(&p_view);
+            _fsum_free(&st);
+            return result;
+        }
+        PyBuffer_Release(&p_view);
+    }
+
+    p_it = PyObject_GetIter(p);
+    if (p_it == NULL)
+        goto done;
+    q_it = PyObject_GetIter(q);
+    if (q_it == NULL)
+        goto done;
+    total = PyLong_FromLong(0);
+    if (total == NULL)
+        goto done;
+
+    for (;;) {
+        p_item = PyIter_Next(p_it);
+        if (p_item == NULL && PyErr_Occurred())
+            goto done;
+        q_item = PyIter_Next(q_it);
+        if (q_item == NULL && PyErr_Occurred()) {
+            Py_XDECREF(p_item);
+            goto done;
+        }
+        if (p_item == NULL || q_item == NULL) {
+            if (p_item != NULL || q_item != NULL) {
+                Py_XDECREF(p_item);
+                Py_XDECREF(q_item);
+                PyErr_SetString(PyExc_ValueError,
+                                "Inputs are not the same length");
+                goto done;
+            }
+            break;
+        }
+        if (PyFloat_CheckExact(p_item) && PyFloat_CheckExact(q_item)) {
+            float_terms = 1;
+            if (_fsum_add_product(&st, PyFloat_AS_DOUBLE(p_item),
+                                  PyFloat_AS_DOUBLE(q_item))) {
+                Py_DECREF(p_item);
+                Py_DECREF(q_item);
+                goto done;
+            }
+            Py_DECREF(p_item);
+            Py_DECREF(q_item);
+            continue;
         }
+        term = PyNumber_Multiply(p_item, q_item);
+        Py_DECREF(p_item);
+        Py_DECREF(q_item);
+        if (term == NULL)
+            goto done;
+        Py_SETREF(total, PyNumber_Add(total, term));
+        Py_DECREF(term);
+        if (total == NULL)
+            goto done;
+    }
+
+    if (float_terms) {
+        fsum = _fsum_result(&st);
+        if (fsum == NULL)
+            goto done;
+        result = PyNumber_Add(total, fsum);
+        Py_DECREF(fsum);
+    }
+    else {
+        Py_INCREF(total);
+        result = total;
     }
-    sum = PyFloat_FromDouble(hi);
 
-_fsum_error:
-    PyFPE_END_PROTECT(hi)
-    Py_DECREF(iter);
-    if (p != ps)
-        PyMem_Free(p);
-    return sum;
+done:
+    Py_XDECREF(p_it);
+    Py_XDECREF(q_it);
+    Py_XDECREF(total);
+    _fsum_free(&st);
+    return result;
 }
 
 #undef NUM_PARTIALS
@@ -2362,11 +2682,14 @@ static PyMethodDef math_methods[] = {
     MATH_LOG2_METHODDEF
     MATH_MODF_METHODDEF
     MATH_POW_METHODDEF
+    {"prod",            (PyCFunction)math_prod, METH_VARARGS | METH_KEYWORDS,
+                        math_prod_doc},
     MATH_RADIANS_METHODDEF
     {"remainder",       math_remainder, METH_VARARGS,   math_remainder_doc},
     {"sin",             math_sin,       METH_O,         math_sin_doc},
     {"sinh",            math_sinh,      METH_O,         math_sinh_doc},
     {"sqrt",            math_sqrt,      METH_O,         math_sqrt_doc},
+    {"sumprod",         math_sumprod,   METH_VARARGS,   math_sumprod_doc},
     {"tan",             math_tan,       METH_O,         math_tan_doc},
     {"tanh",            math_tanh,      METH_O,         math_tanh_doc},
     MATH_TRUNC_METHODDEF
@@ -66,6 +66,11 @@ my_getpagesize(void)
 #define my_getpagesize getpagesize
 #endif
 
+/* madvise() is not checked by configure: the advice constants come with it */
+#ifdef MADV_NORMAL
+#define HAVE_MADVISE
+#endif
+
 #endif /* UNIX */
 
 #include <string.h>
@@ -587,6 +592,43 @@ mmap_flush_method(mmap_object *self, PyObject *args)
 #endif
 }
 
+#ifdef HAVE_MADVISE
+static PyObject *
+mmap_madvise_method(mmap_object *self, PyObject *args)
+{
+    int option;
+    Py_ssize_t start = 0, length;
+
+    CHECK_VALID(NULL);
+    length = self->size;
+
+    if (!PyArg_ParseTuple(args, "i|nn:madvise", &option, &start, &length))
+        return NULL;
+
+    if (start < 0 || start >= self->size) {
+        PyErr_SetString(PyExc_ValueError, "madvise start out of bounds");
+        return NULL;
+    }
+    if (length < 0) {
+        PyErr_SetString(PyExc_ValueError, "madvise length invalid");
+        return NULL;
+    }
+    if (PY_SSIZE_T_MAX - start < length) {
+        PyErr_SetString(PyExc_OverflowError, "madvise length too large");
+        return NULL;
+    }
+
+    if (start + length > self->size)
+        length = self->size - start;
+
+    if (madvise(self->data + start, length, option) != 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+#endif /* HAVE_MADVISE */
+
 static PyObject *
 mmap_seek_method(mmap_object *self, PyObject *args)
 {
@@ -697,6 +739,9 @@ static struct PyMethodDef mmap_object_methods[] = {
     {"find",            (PyCFunction) mmap_find_method,         METH_VARARGS},
     {"rfind",           (PyCFunction) mmap_rfind_method,        METH_VARARGS},
     {"flush",           (PyCFunction) mmap_flush_method,        METH_VARARGS},
+#ifdef HAVE_MADVISE
+    {"madvise",         (PyCFunction) mmap_madvise_method,      METH_VARARGS},
+#endif
     {"move",            (PyCFunction) mmap_move_method,         METH_VARARGS},
     {"read",            (PyCFunction) mmap_read_method,         METH_VARARGS},
     {"read_byte",       (PyCFunction) mmap_read_byte_method,    METH_NOARGS},
@@ -974,7 +1019,9 @@ flags specifies the nature of the mapping. MAP_PRIVATE creates a\n\
 private copy-on-write mapping, so changes to the contents of the mmap\n\
 object will be private to this process, and MAP_SHARED creates a mapping\n\
 that's shared with all other processes mapping the same areas of the file.\n\
-The default value is MAP_SHARED.\n\
+The default value is MAP_SHARED. Other MAP_* constants, such as\n\
+MAP_POPULATE or MAP_HUGETLB, can be or-ed into flags where the platform\n\
+supports them.\n\
 \n\
 To map anonymous memory, pass -1 as the fileno (both versions).");
 
@@ -1453,6 +1500,15 @@ PyInit_mmap(void)
     setint(dict, "MAP_ANON", MAP_ANONYMOUS);
     setint(dict, "MAP_ANONYMOUS", MAP_ANONYMOUS);
 #endif
+#ifdef MAP_POPULATE
+    setint(dict, "MAP_POPULATE", MAP_POPULATE);
+#endif
+#ifdef MAP_HUGETLB
+    setint(dict, "MAP_HUGETLB", MAP_HUGETLB);
+#endif
+#ifdef MAP_NORESERVE
+    setint(dict, "MAP_NORESERVE", MAP_NORESERVE);
+#endif
 
     setint(dict, "PAGESIZE", (long)my_getpagesize());
 
@@ -1462,5 +1518,78 @@ PyInit_mmap(void)
     setint(dict, "ACCESS_READ", ACCESS_READ);
     setint(dict, "ACCESS_WRITE", ACCESS_WRITE);
     setint(dict, "ACCESS_COPY", ACCESS_COPY);
+
+#ifdef HAVE_MADVISE
+    /* Portable advice values */
+    setint(dict, "MADV_NORMAL", MADV_NORMAL);
+#ifdef MADV_RANDOM
+    setint(dict, "MADV_RANDOM", MADV_RANDOM);
+#endif
+#ifdef MADV_SEQUENTIAL
+    setint(dict, "MADV_SEQUENTIAL", MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_WILLNEED
+    setint(dict, "MADV_WILLNEED", MADV_WILLNEED);
+#endif
+#ifdef MADV_DONTNEED
+    setint(dict, "MADV_DONTNEED", MADV_DONTNEED);
+#endif
+
+    /* Linux-specific advice values */
+#ifdef MADV_REMOVE
+    setint(dict, "MADV_REMOVE", MADV_REMOVE);
+#endif
+#ifdef MADV_DONTFORK
+    setint(dict, "MADV_DONTFORK", MADV_DONTFORK);
+#endif
+#ifdef MADV_DOFORK
+    setint(dict, "MADV_DOFORK", MADV_DOFORK);
+#endif
+#ifdef MADV_MERGEABLE
+    setint(dict, "MADV_MERGEABLE", MADV_MERGEABLE);
+#endif
+#ifdef MADV_UNMERGEABLE
+    setint(dict, "MADV_UNMERGEABLE", MADV_UNMERGEABLE);
+#endif
+#ifdef MADV_HUGEPAGE
+    setint(dict, "MADV_HUGEPAGE", MADV_HUGEPAGE);
+#endif
+#ifdef MADV_NOHUGEPAGE
+    setint(dict, "MADV_NOHUGEPAGE", MADV_NOHUGEPAGE);
+#endif
+#ifdef MADV_DONTDUMP
+    setint(dict, "MADV_DONTDUMP", MADV_DONTDUMP);
+#endif
+#ifdef MADV_DODUMP
+    setint(dict, "MADV_DODUMP", MADV_DODUMP);
+#endif
+
+    /* Linux and FreeBSD */
+#ifdef MADV_FREE
+    setint(dict, "MADV_FREE", MADV_FREE);
+#endif
+
+    /* FreeBSD-specific */
+#ifdef MADV_NOSYNC
+    setint(dict, "MADV_NOSYNC", MADV_NOSYNC);
+#endif
+#ifdef MADV_AUTOSYNC
+    setint(dict, "MADV_AUTOSYNC", MADV_AUTOSYNC);
+#endif
+#ifdef MADV_NOCORE
+    setint(dict, "MADV_NOCORE", MADV_NOCORE);
+#endif
+#ifdef MADV_CORE
+    setint(dict, "MADV_CORE", MADV_CORE);
+#endif
+
+    /* Apple-specific */
+#ifdef MADV_FREE_REUSABLE
+    setint(dict, "MADV_FREE_REUSABLE", MADV_FREE_REUSABLE);
+#endif
+#ifdef MADV_FREE_REUSE
+    setint(dict, "MADV_FREE_REUSE", MADV_FREE_REUSE);
+#endif
+#endif /* HAVE_MADVISE */
     return module;
 }
@@ -138,7 +138,7 @@ corresponding Unix manual entries for more information on calls.");
 #ifdef HAVE_LINUX_RANDOM_H
 #  include <linux/random.h>
 #endif
-#ifdef HAVE_GETRANDOM_SYSCALL
+#if defined(HAVE_GETRANDOM_SYSCALL) || defined(__linux__)
 #  include <sys/syscall.h>
 #endif
 
@@ -8532,6 +8532,249 @@ done:
 }
 #endif /* HAVE_SENDFILE */
 
+#if defined(__linux__) && defined(__NR_copy_file_range)
+#define HAVE_COPY_FILE_RANGE_SYSCALL
+
+/* glibc only wraps the system call since 2.27 */
+static ssize_t
+posix_copy_file_range_syscall(int src, loff_t *offset_src, int dst,
+                              loff_t *offset_dst, size_t count)
+{
+    return syscall(__NR_copy_file_range, src, offset_src, dst, offset_dst,
+                   count, 0);
+}
+
+PyDoc_STRVAR(posix_copy_file_range__doc__,
+"copy_file_range(src, dst, count, offset_src=None, offset_dst=None)\n\
+    -> byteswritten\n\n\
+Copy count bytes from file descriptor src to file descriptor dst,\n\
+without going through userspace.\n\
+\n\
+If offset_src or offset_dst is None, the data is read from (written to)\n\
+the current file position, which is updated; otherwise it is read from\n\
+(written to) the given offset and the file position is left unchanged.");
+
+static PyObject *
+posix_copy_file_range(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *keywords[] = {"src", "dst", "count",
+                               "offset_src", "offset_dst", NULL};
+    int src, dst;
+    Py_ssize_t count, ret;
+    PyObject *offset_src_obj = Py_None, *offset_dst_obj = Py_None;
+    Py_off_t offset;
+    loff_t offset_src, offset_dst, *p_offset_src = NULL, *p_offset_dst = NULL;
+    int async_err = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+                                     "iin|OO:copy_file_range", keywords,
+                                     &src, &dst, &count,
+                                     &offset_src_obj, &offset_dst_obj))
+        return NULL;
+    if (count < 0) {
+        PyErr_SetString(PyExc_ValueError, "negative count");
+        return NULL;
+    }
+    if (offset_src_obj != Py_None) {
+        if (!Py_off_t_converter(offset_src_obj, &offset))
+            return NULL;
+        offset_src = offset;
+        p_offset_src = &offset_src;
+    }
+    if (offset_dst_obj != Py_None) {
+        if (!Py_off_t_converter(offset_dst_obj, &offset))
+            return NULL;
+        offset_dst = offset;
+        p_offset_dst = &offset_dst;
+    }
+
+    do {
+        Py_BEGIN_ALLOW_THREADS
+        ret = posix_copy_file_range_syscall(src, p_offset_src, dst,
+                                            p_offset_dst, count);
+        Py_END_ALLOW_THREADS
+    } while (ret < 0 && errno == EINTR && !(async_err = PyErr_CheckSignals()));
+    if (ret < 0)
+        return (!async_err) ? posix_error() : NULL;
+    return PyLong_FromSsize_t(ret);
+}
+#endif /* __linux__ && __NR_copy_file_range */
+
+#ifndef MS_WINDOWS
+
+#if defined(__linux__) && defined(HAVE_SYS_IOCTL_H) && !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
+/* Largest request passed to the kernel at once by _fcopy() */
+#define FCOPY_CHUNK_SIZE (1 << 30)
+/* Size of the buffer of the read()/write() fallback of _fcopy() */
+#define FCOPY_BUFFER_SIZE (1 << 20)
+
+enum {
+    FCOPY_CLONE,
+    FCOPY_COPY_FILE_RANGE,
+    FCOPY_SENDFILE,
+    FCOPY_READ_WRITE
+};
+
+typedef struct {
+    int in, out;
+    int method;
+    Py_off_t copied;
+    char *buffer;
+} fcopy_state;
+
+/* Return 1 if errno after the first call of a copy method means that the
+   method does not apply to these file descriptors. */
+static int
+fcopy_unsupported(void)
+{
+    return (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+            errno == EOPNOTSUPP || errno == ENOTTY || errno == EBADF ||
+            errno == EPERM || errno == ETXTBSY);
+}
+
+/* Copy from state->in to state->out until the end of the input, trying
+   the methods from state->method on. Called without the GIL. Return -1
+   with errno set on error; the copy can be resumed after EINTR. */
+static int
+fcopy_run(fcopy_state *state)
+{
+    ssize_t n;
+
+#ifdef FICLONE
+    if (state->method == FCOPY_CLONE) {
+        STRUCT_STAT st;
+
+        /* the clone replaces the whole output file with the whole input
+           file, so it only applies to a copy from start to start */
+        state->method = FCOPY_COPY_FILE_RANGE;
+        if (state->copied == 0 &&
+            lseek(state->in, 0, SEEK_CUR) == 0 &&
+            lseek(state->out, 0, SEEK_CUR) == 0 &&
+            ioctl(state->out, FICLONE, state->in) == 0) {
+            if (FSTAT(state->in, &st) != 0)
+                return -1;
+            if (lseek(state->in, st.st_size, SEEK_SET) < 0 ||
+                lseek(state->out, st.st_size, SEEK_SET) < 0)
+                return -1;
+            state->copied = st.st_size;
+            return 0;
+        }
+    }
+#endif
+    if (state->method == FCOPY_CLONE)
+        state->method = FCOPY_COPY_FILE_RANGE;
+
+#ifdef HAVE_COPY_FILE_RANGE_SYSCALL
+    if (state->method == FCOPY_COPY_FILE_RANGE) {
+        for (;;) {
+            n = posix_copy_file_range_syscall(state->in, NULL, state->out,
+                                              NULL, FCOPY_CHUNK_SIZE);
+            if (n < 0) {
+                if (state->copied == 0 && fcopy_unsupported())
+                    break;
+                return -1;
+            }
+            /* files of procfs, sysfs and some FUSE or network file systems
+               report a size of 0, or nothing to copy in the range, but
+               can be read: only trust the end of the input once
+               something was copied */
+            if (n == 0 && state->copied == 0)
+                break;
+            if (n == 0)
+                return 0;
+            state->copied += n;
+        }
+    }
+#endif
+    if (state->method == FCOPY_COPY_FILE_RANGE)
+        state->method = FCOPY_SENDFILE;
+
+#if defined(HAVE_SENDFILE) && defined(__linux__)
+    if (state->method == FCOPY_SENDFILE) {
+        for (;;) {
+            n = sendfile(state->out, state->in, NULL, FCOPY_CHUNK_SIZE);
+            if (n < 0) {
+                if (state->copied == 0 && fcopy_unsupported())
+                    break;
+                return -1;
+            }
+            /* as with copy_file_range(): read() has the last word */
+            if (n == 0 && state->copied == 0)
+                break;
+            if (n == 0)
+                return 0;
+            state->copied += n;
+        }
+    }
+#endif
+    state->method = FCOPY_READ_WRITE;
+
+    if (state->buffer == NULL) {
+        state->buffer = PyMem_RawMalloc(FCOPY_BUFFER_SIZE);
+        if (state->buffer == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    for (;;) {
+        ssize_t pos = 0;
+
+        n = read(state->in, state->buffer, FCOPY_BUFFER_SIZE);
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            return 0;
+        while (pos < n) {
+            ssize_t written = write(state->out, state->buffer + pos, n - pos);
+            if (written < 0) {
+                /* the data read would be lost, so retry here */
+                if (errno == EINTR)
+                    continue;
+                return -1;
+            }
+            pos += written;
+        }
+        state->copied += n;
+    }
+}
+
+PyDoc_STRVAR(posix__fcopy__doc__,
+"_fcopy(infd, outfd) -> bytescopied\n\n\
+Copy the data of file descriptor infd from its current position to the\n\
+end to file descriptor outfd, at its current position.\n\
+\n\
+The copy is delegated to the kernel where possible: by cloning the file\n\
+(FICLONE) when both positions are at the start, else with\n\
+copy_file_range() or sendfile(), else with a read()/write() loop.");
+
+static PyObject *
+posix__fcopy(PyObject *self, PyObject *args)
+{
+    fcopy_state state;
+    int res;
+    int async_err = 0;
+
+    if (!PyArg_ParseTuple(args, "ii:_fcopy", &state.in, &state.out))
+        return NULL;
+    state.method = FCOPY_CLONE;
+    state.copied = 0;
+    state.buffer = NULL;
+
+    do {
+        Py_BEGIN_ALLOW_THREADS
+        res = fcopy_run(&state);
+        Py_END_ALLOW_THREADS
+    } while (res < 0 && errno == EINTR && !(async_err = PyErr_CheckSignals()));
+    PyMem_RawFree(state.buffer);
+    if (res < 0)
+        return (!async_err) ? posix_error() : NULL;
+    return PyLong_FromPy_off_t(state.copied);
+}
+#endif /* !MS_WINDOWS */
+
 
 /*[clinic input]
 os.fstat
@@ -12534,6 +12777,380 @@ error:
     return NULL;
 }
 
+#ifndef MS_WINDOWS
+
+#if defined(__linux__) && defined(SYS_getdents64)
+#define SCANDIR_ENTRIES_GETDENTS
+#define SCANDIR_ENTRIES_BUFSIZE (32 * 1024)
+
+/* Record returned by the getdents64 system call */
+struct scandir_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+#if defined(SCANDIR_ENTRIES_GETDENTS) || defined(HAVE_DIRENT_D_TYPE)
+#ifdef DTTOIF
+#define SCANDIR_DTTOIF(d_type) DTTOIF(d_type)
+#else
+#define SCANDIR_DTTOIF(d_type) ((d_type) << 12)
+#endif
+#endif
+
+/* An entry collected by scandir_entries(). The names of all the entries
+   are stored one after another in a separate buffer. */
+typedef struct {
+    size_t name_offset;
+    size_t name_len;
+    ino_t d_ino;
+    int mode;           /* file type bits of st_mode, 0 if unknown */
+    int stat_errno;     /* 0 if st is valid */
+    STRUCT_STAT st;
+} scandir_entry;
+
+typedef struct {
+    scandir_entry *entries;
+    Py_ssize_t count;
+    Py_ssize_t allocated;
+    char *names;
+    size_t names_used;
+    size_t names_allocated;
+} scandir_entry_list;
+
+/* Append an entry, skipping . and ..; called without the GIL. Return -1
+   with errno set on memory error. */
+static int
+scandir_entry_list_append(scandir_entry_list *list, const char *name,
+                          size_t name_len, ino_t d_ino, int mode)
+{
+    scandir_entry *entry;
+
+    if (name[0] == '.' &&
+        (name_len == 1 || (name[1] == '.' && name_len == 2)))
+        return 0;
+
+    if (list->count == list->allocated) {
+        Py_ssize_t allocated = list->allocated ? list->allocated * 2 : 64;
+        scandir_entry *entries;
+
+        if ((size_t)allocated > PY_SSIZE_T_MAX / sizeof(scandir_entry))
+            entries = NULL;
+        else
+            entries = PyMem_RawRealloc(list->entries,
+                                       allocated * sizeof(scandir_entry));
+        if (entries == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        list->entries = entries;
+        list->allocated = allocated;
+    }
+    if (list->names_allocated - list->names_used < name_len + 1) {
+        size_t allocated = list->names_allocated ?
+                           list->names_allocated : 4096;
+        char *names;
+
+        while (allocated - list->names_used < name_len + 1)
+            allocated *= 2;
+        names = PyMem_RawRealloc(list->names, allocated);
+        if (names == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        list->names = names;
+        list->names_allocated = allocated;
+    }
+
+    entry = &list->entries[list->count++];
+    entry->name_offset = list->names_used;
+    entry->name_len = name_len;
+    entry->d_ino = d_ino;
+    entry->mode = mode;
+    entry->stat_errno = -1;
+    memcpy(list->names + list->names_used, name, name_len);
+    list->names[list->names_used + name_len] = '\0';
+    list->names_used += name_len + 1;
+    return 0;
+}
+
+/* Read the whole directory and lstat() the entries if do_stat is true,
+   without the GIL. Return -1 with errno set on error. */
+#ifdef SCANDIR_ENTRIES_GETDENTS
+static int
+scandir_entries_read(int fd, Py_ssize_t bufsize, int do_stat,
+                     scandir_entry_list *list)
+{
+    char *buf, *name;
+    long n, pos;
+    Py_ssize_t i;
+    struct scandir_dirent64 *d;
+
+    buf = PyMem_RawMalloc(bufsize);
+    if (buf == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    for (;;) {
+        n = syscall(SYS_getdents64, fd, buf, (size_t)bufsize);
+        if (n < 0) {
+            PyMem_RawFree(buf);
+            return -1;
+        }
+        if (n == 0)
+            break;
+        for (pos = 0; pos < n; pos += d->d_reclen) {
+            d = (struct scandir_dirent64 *)(buf + pos);
+            name = d->d_name;
+            if (scandir_entry_list_append(list, name, strlen(name),
+                                          (ino_t)d->d_ino,
+                                          SCANDIR_DTTOIF(d->d_type)) < 0) {
+                PyMem_RawFree(buf);
+                return -1;
+            }
+        }
+    }
+    PyMem_RawFree(buf);
+
+    if (do_stat) {
+        for (i = 0; i < list->count; i++) {
+            scandir_entry *entry = &list->entries[i];
+            if (fstatat(fd, list->names + entry->name_offset, &entry->st,
+                        AT_SYMLINK_NOFOLLOW) == 0)
+                entry->stat_errno = 0;
+            else
+                entry->stat_errno = errno;
+        }
+    }
+    return 0;
+}
+#else
+static int
+scandir_entries_read(DIR *dirp, Py_ssize_t bufsize, int do_stat,
+                     scandir_entry_list *list)
+{
+    struct dirent *ep;
+    int mode = 0;
+
+    for (;;) {
+        errno = 0;
+        ep = readdir(dirp);
+        if (ep == NULL) {
+            if (errno != 0)
+                return -1;
+            break;
+        }
+#ifdef HAVE_DIRENT_D_TYPE
+        mode = SCANDIR_DTTOIF(ep->d_type);
+#endif
+        if (scandir_entry_list_append(list, ep->d_name, NAMLEN(ep),
+                                      ep->d_ino, mode) < 0)
+            return -1;
+    }
+
+#if defined(HAVE_FSTATAT) && defined(HAVE_DIRFD)
+    if (do_stat) {
+        Py_ssize_t i;
+
+        for (i = 0; i < list->count; i++) {
+            scandir_entry *entry = &list->entries[i];
+            if (fstatat(dirfd(dirp), list->names + entry->name_offset,
+                        &entry->st, AT_SYMLINK_NOFOLLOW) == 0)
+                entry->stat_errno = 0;
+            else
+                entry->stat_errno = errno;
+        }
+    }
+#endif
+    return 0;
+}
+#endif
+
+PyDoc_STRVAR(scandir_entries__doc__,
+"scandir_entries(path=None, *, stat=False, bufsize=0)\n\
+--\n\
+\n\
+Return a list of (name, type, inode, stat) tuples for the entries of\n\
+the directory given by path, in arbitrary order.\n\
+\n\
+type holds the file type bits of st_mode for the entry (compare it with\n\
+stat.S_IFDIR and the like), or 0 if the file system does not report it.\n\
+If stat is true, the entries are lstat()ed in the same pass, with the GIL\n\
+released, and stat is their stat_result; it is None otherwise, and for\n\
+entries removed meanwhile.\n\
+\n\
+path is as for scandir(). On Linux the directory is read with the\n\
+getdents64 system call, with a buffer of bufsize bytes (0 for a default\n\
+size); bufsize is ignored elsewhere.");
+
+static PyObject *
+posix_scandir_entries(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *keywords[] = {"path", "stat", "bufsize", NULL};
+    path_t path = PATH_T_INITIALIZE("scandir_entries", "path", 1,
+                                    PATH_HAVE_FDOPENDIR);
+    int do_stat = 0, return_str, err = 0, saved_errno = 0;
+    Py_ssize_t bufsize = 0, i;
+    scandir_entry_list list = {NULL, 0, 0, NULL, 0, 0};
+    PyObject *result = NULL, *name, *item, *st;
+    const char *path_str;
+#ifdef SCANDIR_ENTRIES_GETDENTS
+    int fd = -1;
+#else
+    DIR *dirp = NULL;
+#ifdef HAVE_FDOPENDIR
+    int fd = -1;
+#endif
+#endif
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O&$pn:scandir_entries",
+                                     keywords, path_converter, &path,
+                                     &do_stat, &bufsize))
+        return NULL;
+    if (bufsize < 0) {
+        PyErr_SetString(PyExc_ValueError, "bufsize must be non-negative");
+        goto exit;
+    }
+#ifdef SCANDIR_ENTRIES_GETDENTS
+    if (bufsize == 0)
+        bufsize = SCANDIR_ENTRIES_BUFSIZE;
+    /* a buffer must hold at least one record with a maximum length name */
+    bufsize = Py_MAX(bufsize, (Py_ssize_t)sizeof(struct scandir_dirent64) +
+                              NAME_MAX + 8);
+    bufsize = Py_MIN(bufsize, INT_MAX);
+#elif !defined(HAVE_FSTATAT) || !defined(HAVE_DIRFD)
+    if (do_stat) {
+        PyErr_SetString(PyExc_NotImplementedError,
+                        "scandir_entries: stat unavailable on this platform");
+        goto exit;
+    }
+#endif
+
+    return_str = !path.narrow || !PyObject_CheckBuffer(path.object);
+    path_str = path.narrow ? path.narrow : ".";
+
+#ifdef SCANDIR_ENTRIES_GETDENTS
+    if (path.fd != -1) {
+        /* the duplicate shares the offset, which is rewound after use */
+        fd = _Py_dup(path.fd);
+        if (fd == -1)
+            goto exit;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    if (fd == -1)
+        fd = open(path_str, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1 || lseek(fd, 0, SEEK_SET) < 0)
+        err = -1;
+    else
+        err = scandir_entries_read(fd, bufsize, do_stat, &list);
+    saved_errno = errno;
+    if (fd != -1) {
+        if (path.fd != -1)
+            (void)lseek(fd, 0, SEEK_SET);
+        close(fd);
+    }
+    Py_END_ALLOW_THREADS
+#else
+#ifdef HAVE_FDOPENDIR
+    if (path.fd != -1) {
+        /* closedir() closes the FD, so we duplicate it */
+        fd = _Py_dup(path.fd);
+        if (fd == -1)
+            goto exit;
+    }
+#endif
+    Py_BEGIN_ALLOW_THREADS
+#ifdef HAVE_FDOPENDIR
+    if (fd != -1) {
+        dirp = fdopendir(fd);
+        if (dirp == NULL) {
+            saved_errno = errno;
+            close(fd);
+            errno = saved_errno;
+        }
+    }
+    else
+#endif
+        dirp = opendir(path_str);
+    if (dirp == NULL)
+        err = -1;
+    else
+        err = scandir_entries_read(dirp, bufsize, do_stat, &list);
+    saved_errno = errno;
+    if (dirp != NULL) {
+#ifdef HAVE_FDOPENDIR
+        if (path.fd != -1)
+            rewinddir(dirp);
+#endif
+        closedir(dirp);
+    }
+    Py_END_ALLOW_THREADS
+#endif
+
+    if (err < 0) {
+        errno = saved_errno;
+        path_error(&path);
+        goto exit;
+    }
+
+    result = PyList_New(list.count);
+    if (result == NULL)
+        goto exit;
+    for (i = 0; i < list.count; i++) {
+        scandir_entry *entry = &list.entries[i];
+        const char *entry_name = list.names + entry->name_offset;
+        int mode = entry->mode;
+
+        if (return_str)
+            name = PyUnicode_DecodeFSDefaultAndSize(entry_name,
+                                                    entry->name_len);
+        else
+            name = PyBytes_FromStringAndSize(entry_name, entry->name_len);
+        if (name == NULL)
+            goto error;
+
+        if (entry->stat_errno == 0) {
+            st = _pystat_fromstructstat(&entry->st);
+            if (st == NULL) {
+                Py_DECREF(name);
+                goto error;
+            }
+            mode = entry->st.st_mode & S_IFMT;
+        }
+        else if (entry->stat_errno == -1 || entry->stat_errno == ENOENT) {
+            /* not requested, or removed since the directory was read */
+            st = Py_None;
+            Py_INCREF(st);
+        }
+        else {
+            errno = entry->stat_errno;
+            PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, name);
+            Py_DECREF(name);
+            goto error;
+        }
+
+        item = Py_BuildValue("NiNN", name, mode,
+                             PyLong_FromUnsignedLongLong(entry->d_ino), st);
+        if (item == NULL)
+            goto error;
+        PyList_SET_ITEM(result, i, item);
+    }
+    goto exit;
+
+error:
+    Py_CLEAR(result);
+exit:
+    PyMem_RawFree(list.entries);
+    PyMem_RawFree(list.names);
+    path_cleanup(&path);
+    return result;
+}
+
+#endif /* !MS_WINDOWS */
+
 /*
     Return the file system path representation of the object.
 
@@ -12787,6 +13404,14 @@ static PyMethodDef posix_methods[] = {
 #ifdef HAVE_SENDFILE
     {"sendfile",        (PyCFunction)posix_sendfile, METH_VARARGS | METH_KEYWORDS,
                             posix_sendfile__doc__},
+#endif
+#ifdef HAVE_COPY_FILE_RANGE_SYSCALL
+    {"copy_file_range", (PyCFunction)posix_copy_file_range,
+                        METH_VARARGS | METH_KEYWORDS,
+                        posix_copy_file_range__doc__},
+#endif
+#ifndef MS_WINDOWS
+    {"_fcopy",          posix__fcopy, METH_VARARGS, posix__fcopy__doc__},
 #endif
     OS_FSTAT_METHODDEF
     OS_ISATTY_METHODDEF
@@ -12853,6 +13478,11 @@ static PyMethodDef posix_methods[] = {
     {"set_blocking", posix_set_blocking, METH_VARARGS, set_blocking__doc__},
 #endif
     OS_SCANDIR_METHODDEF
+#ifndef MS_WINDOWS
+    {"scandir_entries", (PyCFunction)posix_scandir_entries,
+                        METH_VARARGS | METH_KEYWORDS,
+                        scandir_entries__doc__},
+#endif
     OS_FSPATH_METHODDEF
     OS_GETRANDOM_METHODDEF
     {NULL,              NULL}            /* Sentinel */
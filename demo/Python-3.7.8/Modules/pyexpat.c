@@ -64,6 +64,7 @@ typedef struct {
                                 /* NULL if not enabled */
     int buffer_size;            /* Size of buffer, in XML_Char units */
     int buffer_used;            /* Buffer units in use */
+    int buffer_max_size;        /* Size up to which buffer may grow */
     PyObject *intern;           /* Dictionary to intern strings */
     PyObject **handlers;
 } xmlparseobject;
@@ -305,6 +306,31 @@ flush_character_buffer(xmlparseobject *self)
     return rc;
 }
 
+/* Grow the buffer so that it can hold needed units, doubling its size up
+ * to buffer_max_size. Return 0 on success, -1 if the buffer cannot grow
+ * enough; no exception is set in that case, and the caller flushes the
+ * buffer instead.
+ */
+static int
+grow_character_buffer(xmlparseobject *self, Py_ssize_t needed)
+{
+    Py_ssize_t new_size = self->buffer_size;
+    XML_Char *new_buffer;
+
+    if (needed > self->buffer_max_size)
+        return -1;
+    while (new_size < needed)
+        new_size *= 2;
+    if (new_size > self->buffer_max_size)
+        new_size = self->buffer_max_size;
+    new_buffer = PyMem_Realloc(self->buffer, new_size * sizeof(XML_Char));
+    if (new_buffer == NULL)
+        return -1;
+    self->buffer = new_buffer;
+    self->buffer_size = (int)new_size;
+    return 0;
+}
+
 static void
 my_CharacterDataHandler(void *userData, const XML_Char *data, int len)
 {
@@ -316,7 +342,9 @@ my_CharacterDataHandler(void *userData, const XML_Char *data, int len)
     if (self->buffer == NULL)
         call_character_handler(self, data, len);
     else {
-        if ((self->buffer_used + len) > self->buffer_size) {
+        if ((Py_ssize_t)self->buffer_used + len > self->buffer_size &&
+            grow_character_buffer(self,
+                                  (Py_ssize_t)self->buffer_used + len) < 0) {
             if (flush_character_buffer(self) < 0)
                 return;
             /* handler might have changed; drop the rest on the floor
@@ -325,7 +353,7 @@ my_CharacterDataHandler(void *userData, const XML_Char *data, int len)
             if (!have_handler(self, CharacterData))
                 return;
         }
-        if (len > self->buffer_size) {
+        if (len > self->buffer_size && grow_character_buffer(self, len) < 0) {
             call_character_handler(self, data, len);
             self->buffer_used = 0;
         }
@@ -763,6 +791,10 @@ done:
 
 #define BUF_SIZE 2048
 
+/* Files with a readinto() method are read straight into the buffer of
+   the parser, in larger pieces. */
+#define READINTO_BUF_SIZE (64 * 1024)
+
 static int
 readinst(char *buf, int buf_size, PyObject *meth)
 {
@@ -802,6 +834,48 @@ error:
     return -1;
 }
 
+static int
+readinst_into(char *buf, int buf_size, PyObject *meth)
+{
+    PyObject *view, *res, *tmp;
+    Py_ssize_t len;
+    _Py_IDENTIFIER(release);
+
+    view = PyMemoryView_FromMemory(buf, buf_size, PyBUF_WRITE);
+    if (view == NULL)
+        return -1;
+    res = PyObject_CallFunctionObjArgs(meth, view, NULL);
+    /* buf belongs to the parser, so it must not outlive this call */
+    tmp = _PyObject_CallMethodId(view, &PyId_release, NULL);
+    Py_DECREF(view);
+    if (tmp == NULL) {
+        Py_XDECREF(res);
+        return -1;
+    }
+    Py_DECREF(tmp);
+    if (res == NULL)
+        return -1;
+
+    if (res == Py_None) {
+        Py_DECREF(res);
+        PyErr_SetString(PyExc_TypeError,
+                        "readinto() returned None (non-blocking file?)");
+        return -1;
+    }
+    len = PyLong_AsSsize_t(res);
+    Py_DECREF(res);
+    if (len == -1 && PyErr_Occurred())
+        return -1;
+    if (len < 0 || len > buf_size) {
+        PyErr_Format(PyExc_ValueError,
+                     "readinto() returned %zd, "
+                     "outside of range 0 to %i",
+                     len, buf_size);
+        return -1;
+    }
+    return (int)len;
+}
+
 /*[clinic input]
 pyexpat.xmlparser.ParseFile
 
@@ -816,24 +890,37 @@ pyexpat_xmlparser_ParseFile(xmlparseobject *self, PyObject *file)
 /*[clinic end generated code: output=2adc6a13100cc42b input=fbb5a12b6038d735]*/
 {
     int rv = 1;
+    int use_readinto = 1, buf_size = READINTO_BUF_SIZE;
     PyObject *readmethod = NULL;
     _Py_IDENTIFIER(read);
+    _Py_IDENTIFIER(readinto);
 
-    readmethod = _PyObject_GetAttrId(file, &PyId_read);
+    readmethod = _PyObject_GetAttrId(file, &PyId_readinto);
     if (readmethod == NULL) {
-        PyErr_SetString(PyExc_TypeError,
-                        "argument must have 'read' attribute");
-        return NULL;
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+            return NULL;
+        PyErr_Clear();
+        use_readinto = 0;
+        buf_size = BUF_SIZE;
+        readmethod = _PyObject_GetAttrId(file, &PyId_read);
+        if (readmethod == NULL) {
+            PyErr_SetString(PyExc_TypeError,
+                            "argument must have 'read' attribute");
+            return NULL;
+        }
     }
     for (;;) {
         int bytes_read;
-        void *buf = XML_GetBuffer(self->itself, BUF_SIZE);
+        void *buf = XML_GetBuffer(self->itself, buf_size);
         if (buf == NULL) {
             Py_XDECREF(readmethod);
             return get_parse_result(self, 0);
         }
 
-        bytes_read = readinst(buf, BUF_SIZE, readmethod);
+        if (use_readinto)
+            bytes_read = readinst_into(buf, buf_size, readmethod);
+        else
+            bytes_read = readinst(buf, buf_size, readmethod);
         if (bytes_read < 0) {
             Py_DECREF(readmethod);
             return NULL;
@@ -935,6 +1022,7 @@ pyexpat_xmlparser_ExternalEntityParserCreate_impl(xmlparseobject *self,
         return NULL;
     new_parser->buffer_size = self->buffer_size;
     new_parser->buffer_used = 0;
+    new_parser->buffer_max_size = self->buffer_max_size;
     new_parser->buffer = NULL;
     new_parser->ordered_attributes = self->ordered_attributes;
     new_parser->specified_attributes = self->specified_attributes;
@@ -1069,6 +1157,7 @@ pyexpat_xmlparser___dir___impl(xmlparseobject *self)
     APPEND(rc, "CurrentLineNumber");
     APPEND(rc, "CurrentColumnNumber");
     APPEND(rc, "CurrentByteIndex");
+    APPEND(rc, "buffer_max_size");
     APPEND(rc, "buffer_size");
     APPEND(rc, "buffer_text");
     APPEND(rc, "buffer_used");
@@ -1174,6 +1263,7 @@ newxmlparseobject(const char *encoding, const char *namespace_separator, PyObjec
     self->buffer = NULL;
     self->buffer_size = CHARACTER_DATA_BUFFER_SIZE;
     self->buffer_used = 0;
+    self->buffer_max_size = 0;
     self->ordered_attributes = 0;
     self->specified_attributes = 0;
     self->in_callback = 0;
@@ -1306,6 +1396,8 @@ xmlparse_getattro(xmlparseobject *self, PyObject *nameobj)
                                   XML_GetCurrentByteIndex(self->itself));
     }
     if (first_char == 'b') {
+        if (_PyUnicode_EqualToASCIIString(nameobj, "buffer_max_size"))
+            return PyLong_FromLong((long) self->buffer_max_size);
         if (_PyUnicode_EqualToASCIIString(nameobj, "buffer_size"))
             return PyLong_FromLong((long) self->buffer_size);
         if (_PyUnicode_EqualToASCIIString(nameobj, "buffer_text"))
@@ -1425,6 +1517,25 @@ xmlparse_setattro(xmlparseobject *self, PyObject *name, PyObject *v)
         return 0;
     }
 
+    if (_PyUnicode_EqualToASCIIString(name, "buffer_max_size")) {
+      long new_max_size;
+      if (!PyLong_Check(v)) {
+        PyErr_SetString(PyExc_TypeError, "buffer_max_size must be an integer");
+        return -1;
+      }
+
+      new_max_size = PyLong_AsLong(v);
+      if (new_max_size == -1 && PyErr_Occurred())
+        return -1;
+      if (new_max_size < 0 || new_max_size > INT_MAX) {
+        PyErr_Format(PyExc_ValueError,
+                     "buffer_max_size must be in range 0 to %i", INT_MAX);
+        return -1;
+      }
+      self->buffer_max_size = (int)new_max_size;
+      return 0;
+    }
+
     if (_PyUnicode_EqualToASCIIString(name, "buffer_size")) {
       long new_buffer_size;
       if (!PyLong_Check(v)) {
@@ -1226,6 +1226,9 @@ static int select_have_broken_poll(void)
 typedef struct {
     PyObject_HEAD
     SOCKET epfd;                        /* epoll control file descriptor */
+    struct epoll_event *evs;            /* event buffer reused by poll() */
+    int evs_size;
+    int evs_busy;                       /* evs is used by a poll() call */
 } pyEpoll_Object;
 
 static PyTypeObject pyEpoll_Type;
@@ -1323,6 +1326,7 @@ static void
 pyepoll_dealloc(pyEpoll_Object *self)
 {
     (void)pyepoll_internal_close(self);
+    PyMem_Free(self->evs);
     Py_TYPE(self)->tp_free(self);
 }
 
@@ -1496,23 +1500,144 @@ PyDoc_STRVAR(pyepoll_unregister_doc,
 fd is the target file descriptor of the operation.");
 
 static PyObject *
-pyepoll_poll(pyEpoll_Object *self, PyObject *args, PyObject *kwds)
+pyepoll_internal_ctl_many(int epfd, int op, PyObject *iterable,
+                          const char *fname)
 {
-    static char *kwlist[] = {"timeout", "maxevents", NULL};
-    PyObject *timeout_obj = NULL;
-    int maxevents = -1;
-    int nfds, i;
-    PyObject *elist = NULL, *etuple = NULL;
-    struct epoll_event *evs = NULL;
-    _PyTime_t timeout, ms, deadline;
+    PyObject *seq, *item, *pfd;
+    struct epoll_event *evs;
+    unsigned int events;
+    Py_ssize_t i, n;
+    int result = 0;
+    int fd;
 
-    if (self->epfd < 0)
+    if (epfd < 0)
         return pyepoll_err_closed();
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oi:poll", kwlist,
-                                     &timeout_obj, &maxevents)) {
+    /* A snapshot: the fileno() methods called below may change a list
+       passed in, and the tuple keeps the pairs alive meanwhile. */
+    seq = PySequence_Tuple(iterable);
+    if (seq == NULL)
+        return NULL;
+    n = PyTuple_GET_SIZE(seq);
+    evs = PyMem_New(struct epoll_event, n);
+    if (evs == NULL) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    /* Convert all the pairs first, so that a bad argument doesn't leave
+       the epoll object half-updated */
+    for (i = 0; i < n; i++) {
+        item = PyTuple_GET_ITEM(seq, i);
+        if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 2) {
+            PyErr_Format(PyExc_TypeError,
+                         "%s() items must be (fd, eventmask) tuples", fname);
+            goto error;
+        }
+        if (!PyArg_ParseTuple(item, "OI", &pfd, &events))
+            goto error;
+        fd = PyObject_AsFileDescriptor(pfd);
+        if (fd == -1)
+            goto error;
+        evs[i].events = events;
+        evs[i].data.fd = fd;
+    }
+    Py_DECREF(seq);
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < n; i++) {
+        result = epoll_ctl(epfd, op, evs[i].data.fd, &evs[i]);
+        if (result < 0)
+            break;
+    }
+    Py_END_ALLOW_THREADS
+
+    PyMem_Free(evs);
+    if (result < 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
         return NULL;
     }
+    Py_RETURN_NONE;
+
+error:
+    Py_DECREF(seq);
+    PyMem_Free(evs);
+    return NULL;
+}
+
+static PyObject *
+pyepoll_register_many(pyEpoll_Object *self, PyObject *iterable)
+{
+    return pyepoll_internal_ctl_many(self->epfd, EPOLL_CTL_ADD, iterable,
+                                     "register_many");
+}
+
+PyDoc_STRVAR(pyepoll_register_many_doc,
+"register_many(iterable) -> None\n\
+\n\
+Register each fd of an iterable of (fd, eventmask) pairs, releasing the\n\
+GIL only once. Raises an OSError at the first fd which cannot be\n\
+registered; the fds before it stay registered.");
+
+static PyObject *
+pyepoll_modify_many(pyEpoll_Object *self, PyObject *iterable)
+{
+    return pyepoll_internal_ctl_many(self->epfd, EPOLL_CTL_MOD, iterable,
+                                     "modify_many");
+}
+
+PyDoc_STRVAR(pyepoll_modify_many_doc,
+"modify_many(iterable) -> None\n\
+\n\
+Modify each fd of an iterable of (fd, eventmask) pairs, releasing the\n\
+GIL only once. Raises an OSError at the first fd which cannot be\n\
+modified; the fds before it stay modified.");
+
+/* Return a buffer of maxevents events. Reuse the buffer of the epoll
+   object, unless another thread is polling with it. */
+static struct epoll_event *
+pyepoll_get_events(pyEpoll_Object *self, int maxevents)
+{
+    struct epoll_event *evs;
+
+    if (self->evs_busy) {
+        evs = PyMem_New(struct epoll_event, maxevents);
+        if (evs == NULL)
+            PyErr_NoMemory();
+        return evs;
+    }
+    if (self->evs_size < maxevents) {
+        evs = PyMem_New(struct epoll_event, maxevents);
+        if (evs == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        PyMem_Free(self->evs);
+        self->evs = evs;
+        self->evs_size = maxevents;
+    }
+    self->evs_busy = 1;
+    return self->evs;
+}
+
+static void
+pyepoll_release_events(pyEpoll_Object *self, struct epoll_event *evs)
+{
+    if (evs == self->evs)
+        self->evs_busy = 0;
+    else
+        PyMem_Free(evs);
+}
+
+/* Wait for events, retrying on EINTR. Return the number of events or -1
+   with an exception set. */
+static int
+pyepoll_internal_poll(pyEpoll_Object *self, PyObject *timeout_obj,
+                      struct epoll_event *evs, int maxevents)
+{
+    _PyTime_t timeout, ms, deadline;
+    int nfds;
 
     if (timeout_obj == NULL || timeout_obj == Py_None) {
         timeout = -1;
@@ -1528,34 +1653,18 @@ pyepoll_poll(pyEpoll_Object *self, PyObject *args, PyObject *kwds)
                 PyErr_SetString(PyExc_TypeError,
                                 "timeout must be an integer or None");
             }
-            return NULL;
+            return -1;
         }
 
         ms = _PyTime_AsMilliseconds(timeout, _PyTime_ROUND_CEILING);
         if (ms < INT_MIN || ms > INT_MAX) {
             PyErr_SetString(PyExc_OverflowError, "timeout is too large");
-            return NULL;
+            return -1;
         }
 
         deadline = _PyTime_GetMonotonicClock() + timeout;
     }
 
-    if (maxevents == -1) {
-        maxevents = FD_SETSIZE-1;
-    }
-    else if (maxevents < 1) {
-        PyErr_Format(PyExc_ValueError,
-                     "maxevents must be greater than 0, got %d",
-                     maxevents);
-        return NULL;
-    }
-
-    evs = PyMem_New(struct epoll_event, maxevents);
-    if (evs == NULL) {
-        PyErr_NoMemory();
-        return NULL;
-    }
-
     do {
         Py_BEGIN_ALLOW_THREADS
         errno = 0;
@@ -1567,7 +1676,7 @@ pyepoll_poll(pyEpoll_Object *self, PyObject *args, PyObject *kwds)
 
         /* poll() was interrupted by a signal */
         if (PyErr_CheckSignals())
-            goto error;
+            return -1;
 
         if (timeout >= 0) {
             timeout = deadline - _PyTime_GetMonotonicClock();
@@ -1582,6 +1691,46 @@ pyepoll_poll(pyEpoll_Object *self, PyObject *args, PyObject *kwds)
 
     if (nfds < 0) {
         PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+    return nfds;
+}
+
+static PyObject *
+pyepoll_poll(pyEpoll_Object *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"timeout", "maxevents", NULL};
+    PyObject *timeout_obj = NULL;
+    int maxevents = -1;
+    int nfds, i;
+    PyObject *elist = NULL, *etuple = NULL;
+    struct epoll_event *evs = NULL;
+
+    if (self->epfd < 0)
+        return pyepoll_err_closed();
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oi:poll", kwlist,
+                                     &timeout_obj, &maxevents)) {
+        return NULL;
+    }
+
+    if (maxevents == -1) {
+        maxevents = FD_SETSIZE-1;
+    }
+    else if (maxevents < 1) {
+        PyErr_Format(PyExc_ValueError,
+                     "maxevents must be greater than 0, got %d",
+                     maxevents);
+        return NULL;
+    }
+
+    evs = pyepoll_get_events(self, maxevents);
+    if (evs == NULL) {
+        return NULL;
+    }
+
+    nfds = pyepoll_internal_poll(self, timeout_obj, evs, maxevents);
+    if (nfds < 0) {
         goto error;
     }
 
@@ -1600,7 +1749,7 @@ pyepoll_poll(pyEpoll_Object *self, PyObject *args, PyObject *kwds)
     }
 
     error:
-    PyMem_Free(evs);
+    pyepoll_release_events(self, evs);
     return elist;
 }
 
@@ -1611,6 +1760,65 @@ Wait for events on the epoll file descriptor for a maximum time of timeout\n\
 in seconds (as float). -1 makes poll wait indefinitely.\n\
 Up to maxevents are returned to the caller.");
 
+static PyObject *
+pyepoll_poll_into(pyEpoll_Object *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"buffer", "timeout", NULL};
+    PyObject *timeout_obj = NULL;
+    Py_buffer buffer;
+    struct epoll_event *evs;
+    Py_ssize_t maxevents;
+    int nfds, i;
+    int pair[2];
+    char *out;
+
+    if (self->epfd < 0)
+        return pyepoll_err_closed();
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|O:poll_into", kwlist,
+                                     &buffer, &timeout_obj)) {
+        return NULL;
+    }
+
+    maxevents = Py_MIN(buffer.len / (Py_ssize_t)sizeof(pair), INT_MAX);
+    if (maxevents < 1) {
+        PyErr_SetString(PyExc_ValueError,
+                        "buffer is too small to hold one event");
+        PyBuffer_Release(&buffer);
+        return NULL;
+    }
+
+    evs = pyepoll_get_events(self, (int)maxevents);
+    if (evs == NULL) {
+        PyBuffer_Release(&buffer);
+        return NULL;
+    }
+
+    nfds = pyepoll_internal_poll(self, timeout_obj, evs, (int)maxevents);
+    out = buffer.buf;
+    for (i = 0; i < nfds; i++) {
+        pair[0] = evs[i].data.fd;
+        pair[1] = (int)evs[i].events;
+        /* the buffer is not necessarily aligned */
+        memcpy(out, pair, sizeof(pair));
+        out += sizeof(pair);
+    }
+
+    pyepoll_release_events(self, evs);
+    PyBuffer_Release(&buffer);
+    if (nfds < 0)
+        return NULL;
+    return PyLong_FromLong(nfds);
+}
+
+PyDoc_STRVAR(pyepoll_poll_into_doc,
+"poll_into(buffer[, timeout=-1]) -> int\n\
+\n\
+Like poll(), but store the events in a writable buffer as pairs of C int\n\
+(fd, events), for example an array.array('i'), and return the number of\n\
+events. Up to len(buffer) // (2 * sizeof(int)) events are returned; no\n\
+object is allocated per event.");
+
 static PyObject *
 pyepoll_enter(pyEpoll_Object *self, PyObject *args)
 {
@@ -1642,8 +1850,14 @@ static PyMethodDef pyepoll_methods[] = {
      METH_VARARGS | METH_KEYWORDS,      pyepoll_register_doc},
     {"unregister",      (PyCFunction)pyepoll_unregister,
      METH_VARARGS | METH_KEYWORDS,      pyepoll_unregister_doc},
+    {"register_many",   (PyCFunction)pyepoll_register_many,
+     METH_O,                            pyepoll_register_many_doc},
+    {"modify_many",     (PyCFunction)pyepoll_modify_many,
+     METH_O,                            pyepoll_modify_many_doc},
     {"poll",            (PyCFunction)pyepoll_poll,
      METH_VARARGS | METH_KEYWORDS,      pyepoll_poll_doc},
+    {"poll_into",       (PyCFunction)pyepoll_poll_into,
+     METH_VARARGS | METH_KEYWORDS,      pyepoll_poll_into_doc},
     {"__enter__",           (PyCFunction)pyepoll_enter,     METH_NOARGS,
      NULL},
     {"__exit__",           (PyCFunction)pyepoll_exit,     METH_VARARGS,
@@ -107,7 +107,7 @@ typedef struct {
 #define F2(x,y,z)  ((x & y) | (z & (x | y)))
 #define F3(x,y,z)  (x ^ y ^ z)
 
-static void sha1_compress(struct sha1_state *sha1, unsigned char *buf)
+static void sha1_compress_block(SHA1_INT32 *state, const unsigned char *buf)
 {
     SHA1_INT32 a,b,c,d,e,W[80],i;
 
@@ -117,11 +117,11 @@ static void sha1_compress(struct sha1_state *sha1, unsigned char *buf)
     }
 
     /* copy state */
-    a = sha1->state[0];
-    b = sha1->state[1];
-    c = sha1->state[2];
-    d = sha1->state[3];
-    e = sha1->state[4];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
 
     /* expand it */
     for (i = 16; i < 80; i++) {
@@ -176,11 +176,119 @@ static void sha1_compress(struct sha1_state *sha1, unsigned char *buf)
     #undef FF_3
 
     /* store */
-    sha1->state[0] = sha1->state[0] + a;
-    sha1->state[1] = sha1->state[1] + b;
-    sha1->state[2] = sha1->state[2] + c;
-    sha1->state[3] = sha1->state[3] + d;
-    sha1->state[4] = sha1->state[4] + e;
+    state[0] = state[0] + a;
+    state[1] = state[1] + b;
+    state[2] = state[2] + c;
+    state[3] = state[3] + d;
+    state[4] = state[4] + e;
+}
+
+static void
+sha1_compress_generic(SHA1_INT32 *state, const unsigned char *buf,
+                      Py_ssize_t nblocks)
+{
+    while (nblocks-- > 0) {
+        sha1_compress_block(state, buf);
+        buf += SHA1_BLOCKSIZE;
+    }
+}
+
+/* Block functions using the SHA extensions of x86 CPUs (SHA-NI), which are
+   looked for at run time.  The code is compiled for them with a target
+   attribute so that the rest of the module is not. */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ >= 5)
+#define HAVE_SHA1_COMPRESS_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#ifdef HAVE_SHA1_COMPRESS_SHANI
+static int
+sha1_have_shani(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+    /* SSSE3 and SSE4.1 */
+    if (!(ecx & (1 << 9)) || !(ecx & (1 << 19)))
+        return 0;
+    if (__get_cpuid_max(0, NULL) < 7)
+        return 0;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 29)) != 0;
+}
+
+/* Four rounds g*4 .. g*4+3 with the e value E; EN gets the one of the next
+   four rounds.  M[g % 4] holds the message words of these rounds; the
+   schedule of the later words is computed on the way. */
+#define SHANI_RNDS4(g, E, EN) \
+    if ((g) == 0) \
+        E = _mm_add_epi32(E, M[0]); \
+    else \
+        E = _mm_sha1nexte_epu32(E, M[(g) % 4]); \
+    EN = ABCD; \
+    if ((g) >= 3 && (g) <= 18) \
+        M[((g) + 1) % 4] = _mm_sha1msg2_epu32(M[((g) + 1) % 4], M[(g) % 4]); \
+    ABCD = _mm_sha1rnds4_epu32(ABCD, E, (g) / 5); \
+    if ((g) >= 1 && (g) <= 16) \
+        M[((g) + 3) % 4] = _mm_sha1msg1_epu32(M[((g) + 3) % 4], M[(g) % 4]); \
+    if ((g) >= 2 && (g) <= 17) \
+        M[((g) + 2) % 4] = _mm_xor_si128(M[((g) + 2) % 4], M[(g) % 4]);
+
+__attribute__((target("sha,sse4.1")))
+static void
+sha1_compress_shani(SHA1_INT32 *state, const unsigned char *buf,
+                    Py_ssize_t nblocks)
+{
+    __m128i ABCD, ABCD_SAVE, E0, E0_SAVE, E1, M[4];
+    const __m128i MASK = _mm_set_epi64x(0x0001020304050607ULL,
+                                        0x08090a0b0c0d0e0fULL);
+    int i;
+
+    ABCD = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0x1B);
+    E0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    while (nblocks-- > 0) {
+        ABCD_SAVE = ABCD;
+        E0_SAVE = E0;
+        for (i = 0; i < 4; i++) {
+            M[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i *)(buf + 16 * i)), MASK);
+        }
+        SHANI_RNDS4(0, E0, E1);  SHANI_RNDS4(1, E1, E0);
+        SHANI_RNDS4(2, E0, E1);  SHANI_RNDS4(3, E1, E0);
+        SHANI_RNDS4(4, E0, E1);  SHANI_RNDS4(5, E1, E0);
+        SHANI_RNDS4(6, E0, E1);  SHANI_RNDS4(7, E1, E0);
+        SHANI_RNDS4(8, E0, E1);  SHANI_RNDS4(9, E1, E0);
+        SHANI_RNDS4(10, E0, E1); SHANI_RNDS4(11, E1, E0);
+        SHANI_RNDS4(12, E0, E1); SHANI_RNDS4(13, E1, E0);
+        SHANI_RNDS4(14, E0, E1); SHANI_RNDS4(15, E1, E0);
+        SHANI_RNDS4(16, E0, E1); SHANI_RNDS4(17, E1, E0);
+        SHANI_RNDS4(18, E0, E1); SHANI_RNDS4(19, E1, E0);
+        E0 = _mm_sha1nexte_epu32(E0, E0_SAVE);
+        ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+        buf += SHA1_BLOCKSIZE;
+    }
+
+    ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+    _mm_storeu_si128((__m128i *)state, ABCD);
+    state[4] = (SHA1_INT32)_mm_extract_epi32(E0, 3);
+}
+
+#undef SHANI_RNDS4
+#endif /* HAVE_SHA1_COMPRESS_SHANI */
+
+/* The block function, chosen when the module is initialized */
+static void (*sha1_compress_blocks)(SHA1_INT32 *, const unsigned char *,
+                                    Py_ssize_t) = sha1_compress_generic;
+
+static void
+sha1_compress(struct sha1_state *sha1, const unsigned char *buf)
+{
+    sha1_compress_blocks(sha1->state, buf, 1);
 }
 
 /**
@@ -218,10 +326,12 @@ sha1_process(struct sha1_state *sha1,
 
     while (inlen > 0) {
         if (sha1->curlen == 0 && inlen >= SHA1_BLOCKSIZE) {
-           sha1_compress(sha1, (unsigned char *)in);
-           sha1->length   += SHA1_BLOCKSIZE * 8;
-           in             += SHA1_BLOCKSIZE;
-           inlen          -= SHA1_BLOCKSIZE;
+           /* whole blocks are compressed straight from the input */
+           n = inlen / SHA1_BLOCKSIZE;
+           sha1_compress_blocks(sha1->state, in, n);
+           sha1->length   += n * SHA1_BLOCKSIZE * 8;
+           in             += n * SHA1_BLOCKSIZE;
+           inlen          -= n * SHA1_BLOCKSIZE;
         } else {
            n = Py_MIN(inlen, (Py_ssize_t)(SHA1_BLOCKSIZE - sha1->curlen));
            memcpy(sha1->buf + sha1->curlen, in, (size_t)n);
@@ -547,6 +657,11 @@ PyInit__sha1(void)
 {
     PyObject *m;
 
+#ifdef HAVE_SHA1_COMPRESS_SHANI
+    if (sha1_have_shani())
+        sha1_compress_blocks = sha1_compress_shani;
+#endif
+
     Py_TYPE(&SHA1type) = &PyType_Type;
     if (PyType_Ready(&SHA1type) < 0)
         return NULL;
@@ -123,21 +123,21 @@ static void SHAcopy(SHAobject *src, SHAobject *dest)
 
 
 static void
-sha_transform(SHAobject *sha_info)
+sha_transform_block(SHA_INT32 *digest, const SHA_BYTE *data)
 {
     int i;
         SHA_INT32 S[8], W[64], t0, t1;
 
-    memcpy(W, sha_info->data, sizeof(sha_info->data));
+    memcpy(W, data, SHA_BLOCKSIZE);
 #if PY_LITTLE_ENDIAN
-    longReverse(W, (int)sizeof(sha_info->data));
+    longReverse(W, SHA_BLOCKSIZE);
 #endif
 
     for (i = 16; i < 64; ++i) {
                 W[i] = Gamma1(W[i - 2]) + W[i - 7] + Gamma0(W[i - 15]) + W[i - 16];
     }
     for (i = 0; i < 8; ++i) {
-        S[i] = sha_info->digest[i];
+        S[i] = digest[i];
     }
 
     /* Compress */
@@ -216,9 +216,142 @@ sha_transform(SHAobject *sha_info)
 
     /* feedback */
     for (i = 0; i < 8; i++) {
-        sha_info->digest[i] = sha_info->digest[i] + S[i];
+        digest[i] = digest[i] + S[i];
+    }
+
+}
+
+static void
+sha_transform_generic(SHA_INT32 *digest, const SHA_BYTE *data,
+                      Py_ssize_t nblocks)
+{
+    while (nblocks-- > 0) {
+        sha_transform_block(digest, data);
+        data += SHA_BLOCKSIZE;
+    }
+}
+
+/* Block functions using the SHA extensions of x86 CPUs (SHA-NI), which are
+   looked for at run time.  The code is compiled for them with a target
+   attribute so that the rest of the module is not. */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ >= 5)
+#define HAVE_SHA_TRANSFORM_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#ifdef HAVE_SHA_TRANSFORM_SHANI
+static const SHA_INT32 sha_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+#ifdef HAVE_SHA_TRANSFORM_SHANI
+static int
+sha_have_shani(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+    /* SSSE3 and SSE4.1 */
+    if (!(ecx & (1 << 9)) || !(ecx & (1 << 19)))
+        return 0;
+    if (__get_cpuid_max(0, NULL) < 7)
+        return 0;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 29)) != 0;
+}
+
+/* Four rounds g*4 .. g*4+3.  M[g % 4] holds the message words of these
+   rounds; the schedule of the later words is computed on the way. */
+#define SHANI_RNDS4(g) \
+    MSG = _mm_add_epi32(M[(g) % 4], \
+                        _mm_loadu_si128((const __m128i *)&sha_K[4 * (g)])); \
+    STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG); \
+    if ((g) >= 3 && (g) <= 14) { \
+        TMP = _mm_alignr_epi8(M[(g) % 4], M[((g) + 3) % 4], 4); \
+        M[((g) + 1) % 4] = _mm_add_epi32(M[((g) + 1) % 4], TMP); \
+        M[((g) + 1) % 4] = _mm_sha256msg2_epu32(M[((g) + 1) % 4], \
+                                                M[(g) % 4]); \
+    } \
+    MSG = _mm_shuffle_epi32(MSG, 0x0E); \
+    STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG); \
+    if ((g) >= 1 && (g) <= 12) { \
+        M[((g) + 3) % 4] = _mm_sha256msg1_epu32(M[((g) + 3) % 4], \
+                                                M[(g) % 4]); \
     }
 
+__attribute__((target("sha,sse4.1")))
+static void
+sha_transform_shani(SHA_INT32 *digest, const SHA_BYTE *data,
+                    Py_ssize_t nblocks)
+{
+    __m128i STATE0, STATE1, MSG, TMP, M[4], ABEF_SAVE, CDGH_SAVE;
+    const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                        0x0405060700010203ULL);
+    int i;
+
+    /* The digest words are kept as ABEF and CDGH */
+    TMP = _mm_loadu_si128((const __m128i *)&digest[0]);
+    STATE1 = _mm_loadu_si128((const __m128i *)&digest[4]);
+    TMP = _mm_shuffle_epi32(TMP, 0xB1);
+    STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);
+    STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);
+    STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0);
+
+    while (nblocks-- > 0) {
+        ABEF_SAVE = STATE0;
+        CDGH_SAVE = STATE1;
+        for (i = 0; i < 4; i++) {
+            M[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i *)(data + 16 * i)), MASK);
+        }
+        SHANI_RNDS4(0);  SHANI_RNDS4(1);  SHANI_RNDS4(2);  SHANI_RNDS4(3);
+        SHANI_RNDS4(4);  SHANI_RNDS4(5);  SHANI_RNDS4(6);  SHANI_RNDS4(7);
+        SHANI_RNDS4(8);  SHANI_RNDS4(9);  SHANI_RNDS4(10); SHANI_RNDS4(11);
+        SHANI_RNDS4(12); SHANI_RNDS4(13); SHANI_RNDS4(14); SHANI_RNDS4(15);
+        STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+        STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+        data += SHA_BLOCKSIZE;
+    }
+
+    TMP = _mm_shuffle_epi32(STATE0, 0x1B);
+    STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);
+    STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0);
+    STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);
+    _mm_storeu_si128((__m128i *)&digest[0], STATE0);
+    _mm_storeu_si128((__m128i *)&digest[4], STATE1);
+}
+
+#undef SHANI_RNDS4
+#endif /* HAVE_SHA_TRANSFORM_SHANI */
+
+/* The block function, chosen when the module is initialized */
+static void (*sha_transform_blocks)(SHA_INT32 *, const SHA_BYTE *,
+                                    Py_ssize_t) = sha_transform_generic;
+
+static void
+sha_transform(SHAobject *sha_info)
+{
+    sha_transform_blocks(sha_info->digest, sha_info->data, 1);
 }
 
 
@@ -290,11 +423,12 @@ sha_update(SHAobject *sha_info, SHA_BYTE *buffer, Py_ssize_t count)
             return;
         }
     }
-    while (count >= SHA_BLOCKSIZE) {
-        memcpy(sha_info->data, buffer, SHA_BLOCKSIZE);
-        buffer += SHA_BLOCKSIZE;
-        count -= SHA_BLOCKSIZE;
-        sha_transform(sha_info);
+    if (count >= SHA_BLOCKSIZE) {
+        /* whole blocks are compressed straight from the buffer */
+        i = count / SHA_BLOCKSIZE;
+        sha_transform_blocks(sha_info->digest, buffer, i);
+        buffer += i * SHA_BLOCKSIZE;
+        count -= i * SHA_BLOCKSIZE;
     }
     memcpy(sha_info->data, buffer, count);
     sha_info->local = (int)count;
@@ -709,6 +843,11 @@ PyInit__sha256(void)
 {
     PyObject *m;
 
+#ifdef HAVE_SHA_TRANSFORM_SHANI
+    if (sha_have_shani())
+        sha_transform_blocks = sha_transform_shani;
+#endif
+
     Py_TYPE(&SHA224type) = &PyType_Type;
     if (PyType_Ready(&SHA224type) < 0)
         return NULL;
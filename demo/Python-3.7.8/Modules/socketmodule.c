@@ -294,6 +294,11 @@ http://cvsweb.netbsd.org/bsdweb.cgi/src/lib/libc/net/getaddrinfo.c.diff?r1=1.82&
 # include <netdb.h>
 # include <unistd.h>
 
+#ifdef __linux__
+/* UDP_SEGMENT and UDP_GRO */
+# include <netinet/udp.h>
+#endif
+
 /* Headers needed for inet_ntoa() and inet_addr() */
 #   include <arpa/inet.h>
 
@@ -4419,6 +4424,328 @@ the message.  The return value is the number of bytes of non-ancillary\n\
 data sent.");
 #endif    /* CMSG_LEN */
 
+/* The recvmmsg_into() and sendmmsg() methods move several datagrams per
+   system call.  They are only available on Linux. */
+#if defined(CMSG_LEN) && defined(MSG_WAITFORONE)
+#define HAVE_SOCK_MMSG 1
+
+struct sock_mmsg {
+    struct mmsghdr *msgs;
+    unsigned int vlen;
+    int flags;
+    int result;
+};
+
+static int
+sock_recvmmsg_impl(PySocketSockObject *s, void *data)
+{
+    struct sock_mmsg *ctx = data;
+
+    ctx->result = recvmmsg(s->sock_fd, ctx->msgs, ctx->vlen, ctx->flags,
+                           NULL);
+    return (ctx->result >= 0);
+}
+
+static int
+sock_sendmmsg_impl(PySocketSockObject *s, void *data)
+{
+    struct sock_mmsg *ctx = data;
+
+    ctx->result = sendmmsg(s->sock_fd, ctx->msgs, ctx->vlen, ctx->flags);
+    return (ctx->result >= 0);
+}
+
+/* s.recvmmsg_into(buffers[, flags]) method */
+
+static PyObject *
+sock_recvmmsg_into(PySocketSockObject *s, PyObject *args)
+{
+    int flags = 0;
+    Py_ssize_t i, nitems, nbufs = 0;
+    Py_buffer *bufs = NULL;
+    struct iovec *iovs = NULL;
+    struct mmsghdr *msgs = NULL;
+    sock_addr_t *addrbufs = NULL;
+    char *controlbufs = NULL;
+    size_t controllen = 0;
+    socklen_t addrbuflen;
+    PyObject *buffers_arg, *fast, *retval = NULL;
+    struct sock_mmsg ctx;
+
+    if (!PyArg_ParseTuple(args, "O|i:recvmmsg_into", &buffers_arg, &flags))
+        return NULL;
+
+    if (!getsockaddrlen(s, &addrbuflen))
+        return NULL;
+    if ((fast = PySequence_Fast(buffers_arg,
+                                "recvmmsg_into() argument 1 must be an "
+                                "iterable")) == NULL)
+        return NULL;
+    nitems = PySequence_Fast_GET_SIZE(fast);
+    if (nitems > INT_MAX) {
+        PyErr_SetString(PyExc_OSError,
+                        "recvmmsg_into() argument 1 is too long");
+        goto finally;
+    }
+    if (nitems == 0) {
+        retval = PyList_New(0);
+        goto finally;
+    }
+
+    /* One iovec, address buffer and control buffer per datagram, all
+       allocated up front. */
+#ifdef UDP_GRO
+    controllen = CMSG_SPACE(sizeof(int));
+#endif
+    bufs = PyMem_New(Py_buffer, nitems);
+    iovs = PyMem_New(struct iovec, nitems);
+    msgs = PyMem_Calloc(nitems, sizeof(struct mmsghdr));
+    addrbufs = PyMem_New(sock_addr_t, nitems);
+    if (controllen > 0)
+        controlbufs = PyMem_Malloc(nitems * controllen);
+    if (bufs == NULL || iovs == NULL || msgs == NULL || addrbufs == NULL ||
+            (controllen > 0 && controlbufs == NULL)) {
+        PyErr_NoMemory();
+        goto finally;
+    }
+    for (; nbufs < nitems; nbufs++) {
+        struct msghdr *msg = &msgs[nbufs].msg_hdr;
+
+        if (!PyArg_Parse(PySequence_Fast_GET_ITEM(fast, nbufs),
+                         "w*;recvmmsg_into() argument 1 must be an iterable "
+                         "of single-segment read-write buffers",
+                         &bufs[nbufs]))
+            goto finally;
+        iovs[nbufs].iov_base = bufs[nbufs].buf;
+        iovs[nbufs].iov_len = bufs[nbufs].len;
+        memset(&addrbufs[nbufs], 0, addrbuflen);
+        SAS2SA(&addrbufs[nbufs])->sa_family = AF_UNSPEC;
+        msg->msg_name = SAS2SA(&addrbufs[nbufs]);
+        msg->msg_namelen = addrbuflen;
+        msg->msg_iov = &iovs[nbufs];
+        msg->msg_iovlen = 1;
+        if (controllen > 0) {
+            msg->msg_control = controlbufs + nbufs * controllen;
+            msg->msg_controllen = controllen;
+        }
+    }
+
+    /* Make the system call. */
+    if (!IS_SELECTABLE(s)) {
+        select_error();
+        goto finally;
+    }
+
+    ctx.msgs = msgs;
+    ctx.vlen = (unsigned int)nitems;
+    /* Return as soon as one datagram is there, even for blocking sockets */
+    ctx.flags = flags | MSG_WAITFORONE;
+    if (sock_call(s, 0, sock_recvmmsg_impl, &ctx) < 0)
+        goto finally;
+
+    if ((retval = PyList_New(ctx.result)) == NULL)
+        goto finally;
+    for (i = 0; i < ctx.result; i++) {
+        struct msghdr *msg = &msgs[i].msg_hdr;
+        int segment_size = 0;
+        PyObject *item;
+
+#ifdef UDP_GRO
+        struct cmsghdr *cmsgh;
+
+        for (cmsgh = ((msg->msg_controllen > 0) ? CMSG_FIRSTHDR(msg) : NULL);
+             cmsgh != NULL; cmsgh = CMSG_NXTHDR(msg, cmsgh)) {
+            if (cmsgh->cmsg_level == SOL_UDP &&
+                cmsgh->cmsg_type == UDP_GRO &&
+                cmsgh->cmsg_len >= CMSG_LEN(sizeof(int)))
+                memcpy(&segment_size, CMSG_DATA(cmsgh), sizeof(int));
+        }
+#endif
+        item = Py_BuildValue("INi",
+                             msgs[i].msg_len,
+                             makesockaddr(s->sock_fd, msg->msg_name,
+                                          ((msg->msg_namelen > addrbuflen) ?
+                                           addrbuflen : msg->msg_namelen),
+                                          s->sock_proto),
+                             segment_size);
+        if (item == NULL) {
+            Py_CLEAR(retval);
+            goto finally;
+        }
+        PyList_SET_ITEM(retval, i, item);
+    }
+
+finally:
+    for (i = 0; i < nbufs; i++)
+        PyBuffer_Release(&bufs[i]);
+    PyMem_Free(bufs);
+    PyMem_Free(iovs);
+    PyMem_Free(msgs);
+    PyMem_Free(addrbufs);
+    PyMem_Free(controlbufs);
+    Py_DECREF(fast);
+    return retval;
+}
+
+PyDoc_STRVAR(recvmmsg_into_doc,
+"recvmmsg_into(buffers[, flags]) -> list of (nbytes, address, segment_size)\n\
+\n\
+Receive up to len(buffers) datagrams with a single system call, each\n\
+into its own buffer.  The buffers argument must be an iterable of\n\
+objects that export writable buffers (e.g. bytearray objects).  The\n\
+flags argument has the same meaning as for recv(); the call returns as\n\
+soon as at least one datagram has been received.\n\
+\n\
+The return value has one item for each datagram received, filling the\n\
+first buffers in order.  nbytes is the size of the datagram and address\n\
+the address of the sending socket.  If UDP_GRO is enabled on the socket,\n\
+segment_size is the size of the coalesced segments, 0 otherwise.");
+
+/* s.sendmmsg(messages[, flags]) method */
+
+static PyObject *
+sock_sendmmsg(PySocketSockObject *s, PyObject *args)
+{
+    int flags = 0;
+    Py_ssize_t i, nitems, nbufs = 0;
+    Py_buffer *bufs = NULL;
+    struct iovec *iovs = NULL;
+    struct mmsghdr *msgs = NULL;
+    sock_addr_t *addrbufs = NULL;
+    char *controlbufs = NULL;
+    size_t controllen = 0;
+    PyObject *msgs_arg, *fast, *retval = NULL;
+    struct sock_mmsg ctx;
+
+    if (!PyArg_ParseTuple(args, "O|i:sendmmsg", &msgs_arg, &flags))
+        return NULL;
+
+    if ((fast = PySequence_Fast(msgs_arg,
+                                "sendmmsg() argument 1 must be an "
+                                "iterable")) == NULL)
+        return NULL;
+    nitems = PySequence_Fast_GET_SIZE(fast);
+    if (nitems > INT_MAX) {
+        PyErr_SetString(PyExc_OSError, "sendmmsg() argument 1 is too long");
+        goto finally;
+    }
+    if (nitems == 0) {
+        retval = PyLong_FromLong(0);
+        goto finally;
+    }
+
+#ifdef UDP_SEGMENT
+    controllen = CMSG_SPACE(sizeof(uint16_t));
+#endif
+    bufs = PyMem_New(Py_buffer, nitems);
+    iovs = PyMem_New(struct iovec, nitems);
+    msgs = PyMem_Calloc(nitems, sizeof(struct mmsghdr));
+    addrbufs = PyMem_New(sock_addr_t, nitems);
+    if (controllen > 0)
+        controlbufs = PyMem_Calloc(nitems, controllen);
+    if (bufs == NULL || iovs == NULL || msgs == NULL || addrbufs == NULL ||
+            (controllen > 0 && controlbufs == NULL)) {
+        PyErr_NoMemory();
+        goto finally;
+    }
+    for (; nbufs < nitems; nbufs++) {
+        struct msghdr *msg = &msgs[nbufs].msg_hdr;
+        PyObject *item, *data_arg, *addr_arg = NULL;
+        int segment_size = 0;
+
+        /* Each message is data, or a (data[, address[, segment_size]])
+           tuple. */
+        item = data_arg = PySequence_Fast_GET_ITEM(fast, nbufs);
+        if (PyTuple_Check(item) &&
+                !PyArg_ParseTuple(item, "O|Oi:[sendmmsg() messages]",
+                                  &data_arg, &addr_arg, &segment_size))
+            goto finally;
+        if (!PyArg_Parse(data_arg,
+                         "y*;sendmmsg() argument 1 must be an iterable of "
+                         "bytes-like objects or tuples",
+                         &bufs[nbufs]))
+            goto finally;
+        iovs[nbufs].iov_base = bufs[nbufs].buf;
+        iovs[nbufs].iov_len = bufs[nbufs].len;
+        msg->msg_iov = &iovs[nbufs];
+        msg->msg_iovlen = 1;
+
+        if (addr_arg != NULL && addr_arg != Py_None) {
+            int addrlen;
+
+            if (!getsockaddrarg(s, addr_arg, SAS2SA(&addrbufs[nbufs]),
+                                &addrlen))
+                goto finally;
+            msg->msg_name = SAS2SA(&addrbufs[nbufs]);
+            msg->msg_namelen = addrlen;
+        }
+
+        if (segment_size != 0) {
+#ifdef UDP_SEGMENT
+            struct cmsghdr *cmsgh;
+            uint16_t gso_size;
+
+            if (segment_size < 0 || segment_size > 0xffff) {
+                PyErr_SetString(PyExc_ValueError,
+                                "sendmmsg(): segment_size out of range");
+                goto finally;
+            }
+            gso_size = (uint16_t)segment_size;
+            msg->msg_control = controlbufs + nbufs * controllen;
+            msg->msg_controllen = controllen;
+            cmsgh = CMSG_FIRSTHDR(msg);
+            cmsgh->cmsg_level = SOL_UDP;
+            cmsgh->cmsg_type = UDP_SEGMENT;
+            cmsgh->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            memcpy(CMSG_DATA(cmsgh), &gso_size, sizeof(uint16_t));
+#else
+            PyErr_SetString(PyExc_OSError,
+                            "UDP segmentation offload is not supported "
+                            "on this system");
+            goto finally;
+#endif
+        }
+    }
+
+    /* Make the system call. */
+    if (!IS_SELECTABLE(s)) {
+        select_error();
+        goto finally;
+    }
+
+    ctx.msgs = msgs;
+    ctx.vlen = (unsigned int)nitems;
+    ctx.flags = flags;
+    if (sock_call(s, 1, sock_sendmmsg_impl, &ctx) < 0)
+        goto finally;
+
+    retval = PyLong_FromLong(ctx.result);
+
+finally:
+    for (i = 0; i < nbufs; i++)
+        PyBuffer_Release(&bufs[i]);
+    PyMem_Free(bufs);
+    PyMem_Free(iovs);
+    PyMem_Free(msgs);
+    PyMem_Free(addrbufs);
+    PyMem_Free(controlbufs);
+    Py_DECREF(fast);
+    return retval;
+}
+
+PyDoc_STRVAR(sendmmsg_doc,
+"sendmmsg(messages[, flags]) -> count\n\
+\n\
+Send several datagrams with a single system call.  Each item of the\n\
+messages iterable is either a bytes-like object or a tuple\n\
+(data[, address[, segment_size]]).  If address is supplied and not\n\
+None, it sets the destination address of that datagram.  A non-zero\n\
+segment_size asks the kernel to split data into datagrams of that\n\
+size (UDP_SEGMENT).  The flags argument defaults to 0 and has the same\n\
+meaning as for send().  The return value is the number of messages\n\
+sent, which may be less than the number given.");
+#endif    /* CMSG_LEN && MSG_WAITFORONE */
+
 #ifdef HAVE_SOCKADDR_ALG
 static PyObject*
 sock_sendmsg_afalg(PySocketSockObject *self, PyObject *args, PyObject *kwds)
@@ -4764,6 +5091,12 @@ static PyMethodDef sock_methods[] = {
     {"sendmsg",           (PyCFunction)sock_sendmsg, METH_VARARGS,
                       sendmsg_doc},
 #endif
+#ifdef HAVE_SOCK_MMSG
+    {"recvmmsg_into",     (PyCFunction)sock_recvmmsg_into, METH_VARARGS,
+                      recvmmsg_into_doc},
+    {"sendmmsg",          (PyCFunction)sock_sendmmsg, METH_VARARGS,
+                      sendmmsg_doc},
+#endif
 #ifdef HAVE_SOCKADDR_ALG
     {"sendmsg_afalg",     (PyCFunction)sock_sendmsg_afalg, METH_VARARGS | METH_KEYWORDS,
                       sendmsg_afalg_doc},
@@ -7322,6 +7655,9 @@ PyInit__socket(void)
 #ifdef  MSG_CONFIRM
     PyModule_AddIntMacro(m, MSG_CONFIRM);
 #endif
+#ifdef  MSG_WAITFORONE
+    PyModule_AddIntMacro(m, MSG_WAITFORONE);
+#endif
 #ifdef  MSG_MORE
     PyModule_AddIntMacro(m, MSG_MORE);
 #endif
@@ -7798,6 +8134,14 @@ PyInit__socket(void)
     PyModule_AddIntMacro(m, TCP_NOTSENT_LOWAT);
 #endif
 
+    /* UDP options */
+#ifdef  UDP_SEGMENT
+    PyModule_AddIntMacro(m, UDP_SEGMENT);
+#endif
+#ifdef  UDP_GRO
+    PyModule_AddIntMacro(m, UDP_GRO);
+#endif
+
     /* IPX options */
 #ifdef  IPX_TYPE
     PyModule_AddIntMacro(m, IPX_TYPE);
@@ -83,6 +83,9 @@ typedef struct {
     size_t data_stack_base;
     /* current repeat context */
     SRE_REPEAT *repeat;
+    /* search prefilter: membership of chars < 256 in the INFO charset */
+    SRE_CODE* charset_table_set;
+    unsigned char charset_table[256];
 } SRE_STATE;
 
 typedef struct {
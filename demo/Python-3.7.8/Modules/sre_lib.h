@@ -522,6 +522,26 @@ do { \
     jumplabel: \
     while (0) /* gcc doesn't like labels at end of scopes */ \
 
+#define CHECK_SIGNALS() \
+    do { \
+        if ((0 == (++sigcount & 0xfff)) && PyErr_CheckSignals()) \
+            RETURN_ERROR(SRE_ERROR_INTERRUPTED); \
+    } while (0)
+
+/* with computed gotos every opcode handler jumps straight to the next
+   one; otherwise DISPATCH falls back to the switch */
+#if USE_COMPUTED_GOTOS
+#define TARGET(op) TARGET_##op: case op
+#define DISPATCH \
+    do { \
+        CHECK_SIGNALS(); \
+        goto *sre_targets[*ctx->pattern++]; \
+    } while (0)
+#else
+#define TARGET(op) case op
+#define DISPATCH break
+#endif
+
 #define DO_JUMP(jumpvalue, jumplabel, nextpattern) \
     DO_JUMPX(jumpvalue, jumplabel, nextpattern, ctx->toplevel)
 
@@ -557,6 +577,10 @@ SRE(match)(SRE_STATE* state, SRE_CODE* pattern, int toplevel)
     SRE(match_context)* ctx;
     SRE(match_context)* nextctx;
 
+#if USE_COMPUTED_GOTOS
+#include "sre_targets.h"
+#endif
+
     TRACE(("|%p|%p|ENTER\n", pattern, state->ptr));
 
     DATA_ALLOC(SRE(match_context), ctx);
@@ -583,13 +607,11 @@ entrance:
     }
 
     for (;;) {
-        ++sigcount;
-        if ((0 == (sigcount & 0xfff)) && PyErr_CheckSignals())
-            RETURN_ERROR(SRE_ERROR_INTERRUPTED);
+        CHECK_SIGNALS();
 
         switch (*ctx->pattern++) {
 
-        case SRE_OP_MARK:
+        TARGET(SRE_OP_MARK):
             /* set mark */
             /* <MARK> <gid> */
             TRACE(("|%p|%p|MARK %d\n", ctx->pattern,
@@ -609,20 +631,28 @@ entrance:
             }
             state->mark[i] = ctx->ptr;
             ctx->pattern++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_LITERAL:
+        TARGET(SRE_OP_LITERAL):
             /* match literal string */
             /* <LITERAL> <code> */
-            TRACE(("|%p|%p|LITERAL %d\n", ctx->pattern,
-                   ctx->ptr, *ctx->pattern));
-            if (ctx->ptr >= end || (SRE_CODE) ctx->ptr[0] != ctx->pattern[0])
-                RETURN_FAILURE;
-            ctx->pattern++;
-            ctx->ptr++;
-            break;
+            /* a run of literals is matched here in one go, rather than
+               going back through the dispatcher for every character */
+            for (;;) {
+                TRACE(("|%p|%p|LITERAL %d\n", ctx->pattern,
+                       ctx->ptr, *ctx->pattern));
+                if (ctx->ptr >= end ||
+                    (SRE_CODE) ctx->ptr[0] != ctx->pattern[0])
+                    RETURN_FAILURE;
+                ctx->pattern++;
+                ctx->ptr++;
+                if (ctx->pattern[0] != SRE_OP_LITERAL)
+                    break;
+                ctx->pattern++;
+            }
+            DISPATCH;
 
-        case SRE_OP_NOT_LITERAL:
+        TARGET(SRE_OP_NOT_LITERAL):
             /* match anything that is not literal character */
             /* <NOT_LITERAL> <code> */
             TRACE(("|%p|%p|NOT_LITERAL %d\n", ctx->pattern,
@@ -631,9 +661,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_SUCCESS:
+        TARGET(SRE_OP_SUCCESS):
             /* end of pattern */
             TRACE(("|%p|%p|SUCCESS\n", ctx->pattern, ctx->ptr));
             if (ctx->toplevel &&
@@ -645,16 +675,16 @@ entrance:
             state->ptr = ctx->ptr;
             RETURN_SUCCESS;
 
-        case SRE_OP_AT:
+        TARGET(SRE_OP_AT):
             /* match at given position */
             /* <AT> <code> */
             TRACE(("|%p|%p|AT %d\n", ctx->pattern, ctx->ptr, *ctx->pattern));
             if (!SRE(at)(state, ctx->ptr, *ctx->pattern))
                 RETURN_FAILURE;
             ctx->pattern++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_CATEGORY:
+        TARGET(SRE_OP_CATEGORY):
             /* match at given category */
             /* <CATEGORY> <code> */
             TRACE(("|%p|%p|CATEGORY %d\n", ctx->pattern,
@@ -663,27 +693,27 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_ANY:
+        TARGET(SRE_OP_ANY):
             /* match anything (except a newline) */
             /* <ANY> */
             TRACE(("|%p|%p|ANY\n", ctx->pattern, ctx->ptr));
             if (ctx->ptr >= end || SRE_IS_LINEBREAK(ctx->ptr[0]))
                 RETURN_FAILURE;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_ANY_ALL:
+        TARGET(SRE_OP_ANY_ALL):
             /* match anything */
             /* <ANY_ALL> */
             TRACE(("|%p|%p|ANY_ALL\n", ctx->pattern, ctx->ptr));
             if (ctx->ptr >= end)
                 RETURN_FAILURE;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_IN:
+        TARGET(SRE_OP_IN):
             /* match set member (or non_member) */
             /* <IN> <skip> <set> */
             TRACE(("|%p|%p|IN\n", ctx->pattern, ctx->ptr));
@@ -692,9 +722,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern += ctx->pattern[0];
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_LITERAL_IGNORE:
+        TARGET(SRE_OP_LITERAL_IGNORE):
             TRACE(("|%p|%p|LITERAL_IGNORE %d\n",
                    ctx->pattern, ctx->ptr, ctx->pattern[0]));
             if (ctx->ptr >= end ||
@@ -702,9 +732,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_LITERAL_UNI_IGNORE:
+        TARGET(SRE_OP_LITERAL_UNI_IGNORE):
             TRACE(("|%p|%p|LITERAL_UNI_IGNORE %d\n",
                    ctx->pattern, ctx->ptr, ctx->pattern[0]));
             if (ctx->ptr >= end ||
@@ -712,9 +742,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_LITERAL_LOC_IGNORE:
+        TARGET(SRE_OP_LITERAL_LOC_IGNORE):
             TRACE(("|%p|%p|LITERAL_LOC_IGNORE %d\n",
                    ctx->pattern, ctx->ptr, ctx->pattern[0]));
             if (ctx->ptr >= end
@@ -722,9 +752,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_NOT_LITERAL_IGNORE:
+        TARGET(SRE_OP_NOT_LITERAL_IGNORE):
             TRACE(("|%p|%p|NOT_LITERAL_IGNORE %d\n",
                    ctx->pattern, ctx->ptr, *ctx->pattern));
             if (ctx->ptr >= end ||
@@ -732,9 +762,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_NOT_LITERAL_UNI_IGNORE:
+        TARGET(SRE_OP_NOT_LITERAL_UNI_IGNORE):
             TRACE(("|%p|%p|NOT_LITERAL_UNI_IGNORE %d\n",
                    ctx->pattern, ctx->ptr, *ctx->pattern));
             if (ctx->ptr >= end ||
@@ -742,9 +772,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_NOT_LITERAL_LOC_IGNORE:
+        TARGET(SRE_OP_NOT_LITERAL_LOC_IGNORE):
             TRACE(("|%p|%p|NOT_LITERAL_LOC_IGNORE %d\n",
                    ctx->pattern, ctx->ptr, *ctx->pattern));
             if (ctx->ptr >= end
@@ -752,9 +782,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern++;
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_IN_IGNORE:
+        TARGET(SRE_OP_IN_IGNORE):
             TRACE(("|%p|%p|IN_IGNORE\n", ctx->pattern, ctx->ptr));
             if (ctx->ptr >= end
                 || !SRE(charset)(state, ctx->pattern+1,
@@ -762,9 +792,9 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern += ctx->pattern[0];
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_IN_UNI_IGNORE:
+        TARGET(SRE_OP_IN_UNI_IGNORE):
             TRACE(("|%p|%p|IN_UNI_IGNORE\n", ctx->pattern, ctx->ptr));
             if (ctx->ptr >= end
                 || !SRE(charset)(state, ctx->pattern+1,
@@ -772,27 +802,27 @@ entrance:
                 RETURN_FAILURE;
             ctx->pattern += ctx->pattern[0];
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_IN_LOC_IGNORE:
+        TARGET(SRE_OP_IN_LOC_IGNORE):
             TRACE(("|%p|%p|IN_LOC_IGNORE\n", ctx->pattern, ctx->ptr));
             if (ctx->ptr >= end
                 || !SRE(charset_loc_ignore)(state, ctx->pattern+1, *ctx->ptr))
                 RETURN_FAILURE;
             ctx->pattern += ctx->pattern[0];
             ctx->ptr++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_JUMP:
-        case SRE_OP_INFO:
+        TARGET(SRE_OP_JUMP):
+        TARGET(SRE_OP_INFO):
             /* jump forward */
             /* <JUMP> <offset> */
             TRACE(("|%p|%p|JUMP %d\n", ctx->pattern,
                    ctx->ptr, ctx->pattern[0]));
             ctx->pattern += ctx->pattern[0];
-            break;
+            DISPATCH;
 
-        case SRE_OP_BRANCH:
+        TARGET(SRE_OP_BRANCH):
             /* alternation */
             /* <BRANCH> <0=skip> code <JUMP> ... <NULL> */
             TRACE(("|%p|%p|BRANCH\n", ctx->pattern, ctx->ptr));
@@ -826,7 +856,7 @@ entrance:
                 MARK_POP_DISCARD(ctx->lastmark);
             RETURN_FAILURE;
 
-        case SRE_OP_REPEAT_ONE:
+        TARGET(SRE_OP_REPEAT_ONE):
             /* match repeated sequence (maximizing regexp) */
 
             /* this operator only works if the repeated item is
@@ -912,7 +942,7 @@ entrance:
             }
             RETURN_FAILURE;
 
-        case SRE_OP_MIN_REPEAT_ONE:
+        TARGET(SRE_OP_MIN_REPEAT_ONE):
             /* match repeated sequence (minimizing regexp) */
 
             /* this operator only works if the repeated item is
@@ -980,7 +1010,7 @@ entrance:
             }
             RETURN_FAILURE;
 
-        case SRE_OP_REPEAT:
+        TARGET(SRE_OP_REPEAT):
             /* create repeat context.  all the hard work is done
                by the UNTIL operator (MAX_UNTIL, MIN_UNTIL) */
             /* <REPEAT> <skip> <1=min> <2=max> item <UNTIL> tail */
@@ -1010,7 +1040,7 @@ entrance:
             }
             RETURN_FAILURE;
 
-        case SRE_OP_MAX_UNTIL:
+        TARGET(SRE_OP_MAX_UNTIL):
             /* maximizing repeat */
             /* <REPEAT> <skip> <1=min> <2=max> item <MAX_UNTIL> tail */
 
@@ -1076,7 +1106,7 @@ entrance:
             state->ptr = ctx->ptr;
             RETURN_FAILURE;
 
-        case SRE_OP_MIN_UNTIL:
+        TARGET(SRE_OP_MIN_UNTIL):
             /* minimizing repeat */
             /* <REPEAT> <skip> <1=min> <2=max> item <MIN_UNTIL> tail */
 
@@ -1140,7 +1170,7 @@ entrance:
             state->ptr = ctx->ptr;
             RETURN_FAILURE;
 
-        case SRE_OP_GROUPREF:
+        TARGET(SRE_OP_GROUPREF):
             /* match backreference */
             TRACE(("|%p|%p|GROUPREF %d\n", ctx->pattern,
                    ctx->ptr, ctx->pattern[0]));
@@ -1163,9 +1193,9 @@ entrance:
                 }
             }
             ctx->pattern++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_GROUPREF_IGNORE:
+        TARGET(SRE_OP_GROUPREF_IGNORE):
             /* match backreference */
             TRACE(("|%p|%p|GROUPREF_IGNORE %d\n", ctx->pattern,
                    ctx->ptr, ctx->pattern[0]));
@@ -1189,9 +1219,9 @@ entrance:
                 }
             }
             ctx->pattern++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_GROUPREF_UNI_IGNORE:
+        TARGET(SRE_OP_GROUPREF_UNI_IGNORE):
             /* match backreference */
             TRACE(("|%p|%p|GROUPREF_UNI_IGNORE %d\n", ctx->pattern,
                    ctx->ptr, ctx->pattern[0]));
@@ -1215,9 +1245,9 @@ entrance:
                 }
             }
             ctx->pattern++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_GROUPREF_LOC_IGNORE:
+        TARGET(SRE_OP_GROUPREF_LOC_IGNORE):
             /* match backreference */
             TRACE(("|%p|%p|GROUPREF_LOC_IGNORE %d\n", ctx->pattern,
                    ctx->ptr, ctx->pattern[0]));
@@ -1241,9 +1271,9 @@ entrance:
                 }
             }
             ctx->pattern++;
-            break;
+            DISPATCH;
 
-        case SRE_OP_GROUPREF_EXISTS:
+        TARGET(SRE_OP_GROUPREF_EXISTS):
             TRACE(("|%p|%p|GROUPREF_EXISTS %d\n", ctx->pattern,
                    ctx->ptr, ctx->pattern[0]));
             /* <GROUPREF_EXISTS> <group> <skip> codeyes <JUMP> codeno ... */
@@ -1252,20 +1282,20 @@ entrance:
                 Py_ssize_t groupref = i+i;
                 if (groupref >= state->lastmark) {
                     ctx->pattern += ctx->pattern[1];
-                    break;
+                    DISPATCH;
                 } else {
                     SRE_CHAR* p = (SRE_CHAR*) state->mark[groupref];
                     SRE_CHAR* e = (SRE_CHAR*) state->mark[groupref+1];
                     if (!p || !e || e < p) {
                         ctx->pattern += ctx->pattern[1];
-                        break;
+                        DISPATCH;
                     }
                 }
             }
             ctx->pattern += 2;
-            break;
+            DISPATCH;
 
-        case SRE_OP_ASSERT:
+        TARGET(SRE_OP_ASSERT):
             /* assert subpattern */
             /* <ASSERT> <skip> <back> <pattern> */
             TRACE(("|%p|%p|ASSERT %d\n", ctx->pattern,
@@ -1276,9 +1306,9 @@ entrance:
             DO_JUMP0(JUMP_ASSERT, jump_assert, ctx->pattern+2);
             RETURN_ON_FAILURE(ret);
             ctx->pattern += ctx->pattern[0];
-            break;
+            DISPATCH;
 
-        case SRE_OP_ASSERT_NOT:
+        TARGET(SRE_OP_ASSERT_NOT):
             /* assert not subpattern */
             /* <ASSERT_NOT> <skip> <back> <pattern> */
             TRACE(("|%p|%p|ASSERT_NOT %d\n", ctx->pattern,
@@ -1292,13 +1322,16 @@ entrance:
                 }
             }
             ctx->pattern += ctx->pattern[0];
-            break;
+            DISPATCH;
 
-        case SRE_OP_FAILURE:
+        TARGET(SRE_OP_FAILURE):
             /* immediate failure */
             TRACE(("|%p|%p|FAILURE\n", ctx->pattern, ctx->ptr));
             RETURN_FAILURE;
 
+#if USE_COMPUTED_GOTOS
+        _unknown_opcode:
+#endif
         default:
             TRACE(("|%p|%p|UNKNOWN %d\n", ctx->pattern, ctx->ptr,
                    ctx->pattern[-1]));
@@ -1367,6 +1400,149 @@ exit:
 #define RESET_CAPTURE_GROUP() \
     do { state->lastmark = state->lastindex = -1; } while (0)
 
+LOCAL(SRE_CHAR*)
+SRE(find_char)(SRE_CHAR* ptr, SRE_CHAR* end, SRE_CHAR c)
+{
+    /* return a pointer to the first c in [ptr, end), or NULL */
+
+#if SIZEOF_SRE_CHAR == 1
+    if (end - ptr > SRE_MEMCHR_CUT_OFF)
+        return (SRE_CHAR *)memchr(ptr, c, end - ptr);
+#else
+    /* memchr on one byte of the character, unless that would give
+       us a false positive for every character below 256 */
+    unsigned char needle = c & 0xff;
+    if (needle != 0 && end - ptr > SRE_MEMCHR_CUT_OFF) {
+        SRE_CHAR* e1;
+        do {
+            SRE_CHAR* s1 = ptr;
+            void* candidate = memchr(ptr, needle,
+                                     (end - ptr) * sizeof(SRE_CHAR));
+            if (candidate == NULL)
+                return NULL;
+            ptr = (SRE_CHAR *)_Py_ALIGN_DOWN(candidate, sizeof(SRE_CHAR));
+            if (*ptr == c)
+                return ptr;
+            /* false positive; if they come close together, fall back
+               to a plain loop for a while */
+            ptr++;
+            if (ptr - s1 > SRE_MEMCHR_CUT_OFF)
+                continue;
+            if (end - ptr <= SRE_MEMCHR_CUT_OFF)
+                break;
+            e1 = ptr + SRE_MEMCHR_CUT_OFF;
+            while (ptr != e1) {
+                if (*ptr == c)
+                    return ptr;
+                ptr++;
+            }
+        } while (end - ptr > SRE_MEMCHR_CUT_OFF);
+    }
+#endif
+    for (; ptr < end; ptr++)
+        if (*ptr == c)
+            return ptr;
+    return NULL;
+}
+
+LOCAL(SRE_CHAR*)
+SRE(find_prefix)(SRE_CHAR* ptr, SRE_CHAR* end, SRE_CODE* prefix,
+                 Py_ssize_t prefix_len)
+{
+    /* return a pointer to the first occurrence of the literal prefix
+       in [ptr, end), or NULL.  this is the boyer-moore-horspool/bloom
+       filter scan from stringlib's fastsearch, working directly on
+       the SRE_CODE prefix and never reading past end.  the caller has
+       already checked that every prefix character fits in SRE_CHAR */
+
+    Py_ssize_t w = (end - ptr) - prefix_len;
+    Py_ssize_t mlast = prefix_len - 1;
+    Py_ssize_t skip = mlast - 1;
+    Py_ssize_t i, j;
+    unsigned long mask = 0;
+    SRE_CODE last = prefix[mlast];
+
+    if (w < 0)
+        return NULL;
+
+    for (i = 0; i < mlast; i++) {
+        SRE_BLOOM_ADD(mask, prefix[i]);
+        if (prefix[i] == last)
+            skip = mlast - i - 1;
+    }
+    SRE_BLOOM_ADD(mask, last);
+
+    for (i = 0; i <= w; i++) {
+        if ((SRE_CODE) ptr[i + mlast] == last) {
+            /* candidate match */
+            for (j = 0; j < mlast; j++)
+                if ((SRE_CODE) ptr[i + j] != prefix[j])
+                    break;
+            if (j == mlast)
+                return ptr + i;
+            /* miss: check if next character is part of pattern */
+            if (i < w && !SRE_BLOOM(mask, ptr[i + prefix_len]))
+                i = i + prefix_len;
+            else
+                i = i + skip;
+        } else {
+            /* skip: check if next character is part of pattern */
+            if (i < w && !SRE_BLOOM(mask, ptr[i + prefix_len]))
+                i = i + prefix_len;
+        }
+    }
+    return NULL;
+}
+
+LOCAL(SRE_CHAR*)
+SRE(find_charset)(SRE_STATE* state, SRE_CODE* charset,
+                  SRE_CHAR* ptr, SRE_CHAR* end)
+{
+    /* return a pointer to the first character in [ptr, end) that is
+       a member of charset, or NULL */
+
+    if (state->charset_table_set != charset &&
+        end - ptr >= SRE_CHARSET_TABLE_MIN) {
+        /* long haul: evaluate the set once for every character below
+           256, and keep the table around for the next search on this
+           state (finditer, sub, split and friends) */
+        unsigned char* table = state->charset_table;
+        SRE_CODE ch;
+        if (charset[0] == SRE_OP_CHARSET &&
+            charset[1 + 256/SRE_CODE_BITS] == SRE_OP_FAILURE) {
+            /* a plain bitmap; no need to walk the set */
+            SRE_CODE* bitmap = charset + 1;
+            for (ch = 0; ch < 256; ch++)
+                table[ch] = (bitmap[ch/SRE_CODE_BITS] >>
+                             (ch & (SRE_CODE_BITS-1))) & 1;
+        } else {
+            for (ch = 0; ch < 256; ch++)
+                table[ch] = (unsigned char) SRE(charset)(state, charset, ch);
+        }
+        state->charset_table_set = charset;
+    }
+
+    if (state->charset_table_set == charset) {
+        const unsigned char* table = state->charset_table;
+        for (; ptr < end; ptr++) {
+#if SIZEOF_SRE_CHAR == 1
+            if (table[*ptr])
+                return ptr;
+#else
+            if (*ptr < 256 ? table[*ptr]
+                           : SRE(charset)(state, charset, *ptr))
+                return ptr;
+#endif
+        }
+        return NULL;
+    }
+
+    for (; ptr < end; ptr++)
+        if (SRE(charset)(state, charset, *ptr))
+            return ptr;
+    return NULL;
+}
+
 LOCAL(Py_ssize_t)
 SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
 {
@@ -1431,10 +1607,9 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
         end = (SRE_CHAR *)state->end;
         state->must_advance = 0;
         while (ptr < end) {
-            while (*ptr != c) {
-                if (++ptr >= end)
-                    return 0;
-            }
+            ptr = SRE(find_char)(ptr, end, c);
+            if (ptr == NULL)
+                return 0;
             TRACE(("|%p|%p|SEARCH LITERAL\n", pattern, ptr));
             state->start = ptr;
             state->ptr = ptr + prefix_skip;
@@ -1462,13 +1637,29 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
             if ((SRE_CODE)(SRE_CHAR) prefix[i] != prefix[i])
                 return 0; /* literal can't match: doesn't fit in char width */
 #endif
-        while (ptr < end) {
-            SRE_CHAR c = (SRE_CHAR) prefix[0];
-            while (*ptr++ != c) {
-                if (ptr >= end)
+        if (prefix_len >= SRE_FASTSEARCH_MIN_PREFIX) {
+            /* long prefix: let the horspool scan skip ahead */
+            state->must_advance = 0;
+            while (ptr < end) {
+                ptr = SRE(find_prefix)(ptr, end, prefix, prefix_len);
+                if (ptr == NULL)
                     return 0;
+                TRACE(("|%p|%p|SEARCH FAST\n", pattern, ptr));
+                state->start = ptr;
+                state->ptr = ptr + prefix_skip;
+                if (flags & SRE_INFO_LITERAL)
+                    return 1; /* we got all of it */
+                status = SRE(match)(state, pattern + 2*prefix_skip, 0);
+                if (status != 0)
+                    return status;
+                ++ptr;
+                RESET_CAPTURE_GROUP();
             }
-            if (ptr >= end)
+            return 0;
+        }
+        while (ptr < end) {
+            ptr = SRE(find_char)(ptr, end, (SRE_CHAR) prefix[0]);
+            if (ptr == NULL || ++ptr >= end)
                 return 0;
 
             i = 1;
@@ -1505,9 +1696,8 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
         end = (SRE_CHAR *)state->end;
         state->must_advance = 0;
         for (;;) {
-            while (ptr < end && !SRE(charset)(state, charset, *ptr))
-                ptr++;
-            if (ptr >= end)
+            ptr = SRE(find_charset)(state, charset, ptr, end);
+            if (ptr == NULL)
                 return 0;
             TRACE(("|%p|%p|SEARCH CHARSET\n", pattern, ptr));
             state->start = ptr;
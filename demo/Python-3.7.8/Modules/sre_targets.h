@@ -0,0 +1,46 @@
+/* opcode dispatch table for SRE(match); indexed by SRE_OP_* */
+/* see USE_COMPUTED_GOTOS in _sre.c.  opcodes that only appear
+   inside sets or are never emitted go to _unknown_opcode */
+static void *sre_targets[] = {
+    &&TARGET_SRE_OP_FAILURE,
+    &&TARGET_SRE_OP_SUCCESS,
+    &&TARGET_SRE_OP_ANY,
+    &&TARGET_SRE_OP_ANY_ALL,
+    &&TARGET_SRE_OP_ASSERT,
+    &&TARGET_SRE_OP_ASSERT_NOT,
+    &&TARGET_SRE_OP_AT,
+    &&TARGET_SRE_OP_BRANCH,
+    &&_unknown_opcode,
+    &&TARGET_SRE_OP_CATEGORY,
+    &&_unknown_opcode,
+    &&_unknown_opcode,
+    &&TARGET_SRE_OP_GROUPREF,
+    &&TARGET_SRE_OP_GROUPREF_EXISTS,
+    &&TARGET_SRE_OP_IN,
+    &&TARGET_SRE_OP_INFO,
+    &&TARGET_SRE_OP_JUMP,
+    &&TARGET_SRE_OP_LITERAL,
+    &&TARGET_SRE_OP_MARK,
+    &&TARGET_SRE_OP_MAX_UNTIL,
+    &&TARGET_SRE_OP_MIN_UNTIL,
+    &&TARGET_SRE_OP_NOT_LITERAL,
+    &&_unknown_opcode,
+    &&_unknown_opcode,
+    &&TARGET_SRE_OP_REPEAT,
+    &&TARGET_SRE_OP_REPEAT_ONE,
+    &&_unknown_opcode,
+    &&TARGET_SRE_OP_MIN_REPEAT_ONE,
+    &&TARGET_SRE_OP_GROUPREF_IGNORE,
+    &&TARGET_SRE_OP_IN_IGNORE,
+    &&TARGET_SRE_OP_LITERAL_IGNORE,
+    &&TARGET_SRE_OP_NOT_LITERAL_IGNORE,
+    &&TARGET_SRE_OP_GROUPREF_LOC_IGNORE,
+    &&TARGET_SRE_OP_IN_LOC_IGNORE,
+    &&TARGET_SRE_OP_LITERAL_LOC_IGNORE,
+    &&TARGET_SRE_OP_NOT_LITERAL_LOC_IGNORE,
+    &&TARGET_SRE_OP_GROUPREF_UNI_IGNORE,
+    &&TARGET_SRE_OP_IN_UNI_IGNORE,
+    &&TARGET_SRE_OP_LITERAL_UNI_IGNORE,
+    &&TARGET_SRE_OP_NOT_LITERAL_UNI_IGNORE,
+    &&_unknown_opcode
+};
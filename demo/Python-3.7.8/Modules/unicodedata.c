@@ -36,7 +36,7 @@ typedef struct {
     const unsigned char mirrored;       /* true if mirrored in bidir mode */
     const unsigned char east_asian_width;       /* index into
                                                    _PyUnicode_EastAsianWidth */
-    const unsigned char normalization_quick_check; /* see is_normalized() */
+    const unsigned char normalization_quick_check; /* see is_normalized_quickcheck() */
 } _PyUnicode_DatabaseRecord;
 
 typedef struct change_record {
@@ -770,41 +770,123 @@ nfc_nfkc(PyObject *self, PyObject *input, int k)
     return result;
 }
 
-/* Return 1 if the input is certainly normalized, 0 if it might not be. */
-static int
-is_normalized(PyObject *self, PyObject *input, int nfc, int k)
+/* Result of the quickcheck of a string. The values match the two
+   quickcheck bits of a database record, as described in
+   http://unicode.org/reports/tr15/#Annex8. */
+typedef enum {YES = 0, MAYBE = 1, NO = 2} QuickcheckResult;
+
+/* Return YES if the input is certainly normalized, NO if it certainly
+   is not, and MAYBE if only running the normalization can tell. If
+   yes_only is true, MAYBE is returned as soon as a character which is
+   not a Yes is found. */
+static QuickcheckResult
+is_normalized_quickcheck(PyObject *self, PyObject *input, int nfc, int k,
+                         int yes_only)
 {
     Py_ssize_t i, len;
     int kind;
     void *data;
-    unsigned char prev_combining = 0, quickcheck_mask;
+    unsigned char prev_combining = 0, quickcheck_shift;
+    QuickcheckResult result = YES;
+
+    /* ASCII strings are left unchanged by all the normalization forms
+       of all the versions of the database. */
+    if (PyUnicode_IS_ASCII(input))
+        return YES;
 
     /* An older version of the database is requested, quickchecks must be
        disabled. */
     if (self && UCD_Check(self))
-        return 0;
-
-    /* The two quickcheck bits at this shift mean 0=Yes, 1=Maybe, 2=No,
-       as described in http://unicode.org/reports/tr15/#Annex8. */
-    quickcheck_mask = 3 << ((nfc ? 4 : 0) + (k ? 2 : 0));
+        return MAYBE;
 
     i = 0;
     kind = PyUnicode_KIND(input);
     data = PyUnicode_DATA(input);
     len = PyUnicode_GET_LENGTH(input);
+
+    if (kind == PyUnicode_1BYTE_KIND) {
+        /* No Latin-1 character combines, and none is changed by NFC.
+           Only the letters from U+00C0 have a canonical decomposition,
+           and only the characters from U+00A0 a compatibility one. */
+        const Py_UCS1 *s = (const Py_UCS1 *)data;
+        Py_UCS1 limit;
+
+        if (nfc && !k)
+            return YES;
+        limit = k ? 0xA0 : 0xC0;
+        while (i < len && s[i] < limit)
+            i++;
+        if (i == len)
+            return YES;
+    }
+
+    quickcheck_shift = (nfc ? 4 : 0) + (k ? 2 : 0);
     while (i < len) {
         Py_UCS4 ch = PyUnicode_READ(kind, data, i++);
         const _PyUnicode_DatabaseRecord *record = _getrecord_ex(ch);
         unsigned char combining = record->combining;
-        unsigned char quickcheck = record->normalization_quick_check;
-
-        if (quickcheck & quickcheck_mask)
-            return 0; /* this string might need normalization */
+        unsigned char quickcheck =
+            (record->normalization_quick_check >> quickcheck_shift) & 3;
+
+        if (quickcheck == NO)
+            return NO;
+        if (quickcheck == MAYBE) {
+            if (yes_only)
+                return MAYBE;
+            result = MAYBE; /* this string might need normalization */
+        }
         if (combining && prev_combining > combining)
-            return 0; /* non-canonical sort order, not normalized */
+            return NO; /* non-canonical sort order, not normalized */
         prev_combining = combining;
     }
-    return 1; /* certainly normalized */
+    return result;
+}
+
+/* Set *nfc and *k from the name of a normalization form. Return -1 with
+   an exception set if the name is not valid. */
+static int
+normalization_form(const char *form, int *nfc, int *k)
+{
+    if (strcmp(form, "NFC") == 0) {
+        *nfc = 1;
+        *k = 0;
+    }
+    else if (strcmp(form, "NFKC") == 0) {
+        *nfc = 1;
+        *k = 1;
+    }
+    else if (strcmp(form, "NFD") == 0) {
+        *nfc = 0;
+        *k = 0;
+    }
+    else if (strcmp(form, "NFKD") == 0) {
+        *nfc = 0;
+        *k = 1;
+    }
+    else {
+        PyErr_SetString(PyExc_ValueError, "invalid normalization form");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *
+normalize_string(PyObject *self, PyObject *input, int nfc, int k)
+{
+    if (PyUnicode_GET_LENGTH(input) == 0) {
+        /* Special case empty input strings, since resizing
+           them  later would cause internal errors. */
+        Py_INCREF(input);
+        return input;
+    }
+
+    if (is_normalized_quickcheck(self, input, nfc, k, 1) == YES) {
+        Py_INCREF(input);
+        return input;
+    }
+    if (nfc)
+        return nfc_nfkc(self, input, k);
+    return nfd_nfkd(self, input, k);
 }
 
 /*[clinic input]
@@ -825,42 +907,101 @@ unicodedata_UCD_normalize_impl(PyObject *self, const char *form,
                                PyObject *input)
 /*[clinic end generated code: output=62d1f8870027efdc input=1744c55f4ab79bf0]*/
 {
-    if (PyUnicode_GET_LENGTH(input) == 0) {
-        /* Special case empty input strings, since resizing
-           them  later would cause internal errors. */
-        Py_INCREF(input);
-        return input;
-    }
+    int nfc, k;
 
-    if (strcmp(form, "NFC") == 0) {
-        if (is_normalized(self, input, 1, 0)) {
-            Py_INCREF(input);
-            return input;
-        }
-        return nfc_nfkc(self, input, 0);
-    }
-    if (strcmp(form, "NFKC") == 0) {
-        if (is_normalized(self, input, 1, 1)) {
-            Py_INCREF(input);
-            return input;
-        }
-        return nfc_nfkc(self, input, 1);
-    }
-    if (strcmp(form, "NFD") == 0) {
-        if (is_normalized(self, input, 0, 0)) {
-            Py_INCREF(input);
-            return input;
-        }
-        return nfd_nfkd(self, input, 0);
+    if (normalization_form(form, &nfc, &k) < 0)
+        return NULL;
+    return normalize_string(self, input, nfc, k);
+}
+
+PyDoc_STRVAR(unicodedata_UCD_is_normalized__doc__,
+"is_normalized($self, form, unistr, /)\n\
+--\n\
+\n\
+Return whether the Unicode string unistr is in the normal form 'form'.\n\
+\n\
+Valid values for form are 'NFC', 'NFKC', 'NFD', and 'NFKD'.");
+
+static PyObject *
+unicodedata_UCD_is_normalized(PyObject *self, PyObject *args)
+{
+    const char *form;
+    PyObject *input, *cmp;
+    QuickcheckResult m;
+    int nfc, k, match;
+
+    if (!PyArg_ParseTuple(args, "sU:is_normalized", &form, &input))
+        return NULL;
+    if (normalization_form(form, &nfc, &k) < 0)
+        return NULL;
+    if (PyUnicode_READY(input) == -1)
+        return NULL;
+
+    if (PyUnicode_GET_LENGTH(input) == 0)
+        Py_RETURN_TRUE;
+    m = is_normalized_quickcheck(self, input, nfc, k, 0);
+    if (m == MAYBE) {
+        cmp = nfc ? nfc_nfkc(self, input, k) : nfd_nfkd(self, input, k);
+        if (cmp == NULL)
+            return NULL;
+        match = PyUnicode_Compare(input, cmp);
+        Py_DECREF(cmp);
+        if (match == -1 && PyErr_Occurred())
+            return NULL;
+        return PyBool_FromLong(match == 0);
     }
-    if (strcmp(form, "NFKD") == 0) {
-        if (is_normalized(self, input, 0, 1)) {
-            Py_INCREF(input);
-            return input;
+    return PyBool_FromLong(m == YES);
+}
+
+PyDoc_STRVAR(unicodedata_UCD_normalize_many__doc__,
+"normalize_many($self, form, strings, /)\n\
+--\n\
+\n\
+Return a list of the normal forms 'form' of a sequence of Unicode strings.\n\
+\n\
+This is equivalent to [normalize(form, s) for s in strings].");
+
+static PyObject *
+unicodedata_UCD_normalize_many(PyObject *self, PyObject *args)
+{
+    const char *form;
+    PyObject *strings, *seq, *result, *item, *normal;
+    Py_ssize_t i, n;
+    int nfc, k;
+
+    if (!PyArg_ParseTuple(args, "sO:normalize_many", &form, &strings))
+        return NULL;
+    if (normalization_form(form, &nfc, &k) < 0)
+        return NULL;
+
+    seq = PySequence_Fast(strings, "strings must be a sequence");
+    if (seq == NULL)
+        return NULL;
+    n = PySequence_Fast_GET_SIZE(seq);
+    result = PyList_New(n);
+    if (result == NULL)
+        goto error;
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!PyUnicode_Check(item)) {
+            PyErr_Format(PyExc_TypeError,
+                         "normalize_many() argument 2 must be a sequence "
+                         "of str, not %.200s", Py_TYPE(item)->tp_name);
+            goto error;
         }
-        return nfd_nfkd(self, input, 1);
+        if (PyUnicode_READY(item) == -1)
+            goto error;
+        normal = normalize_string(self, item, nfc, k);
+        if (normal == NULL)
+            goto error;
+        PyList_SET_ITEM(result, i, normal);
     }
-    PyErr_SetString(PyExc_ValueError, "invalid normalization form");
+    Py_DECREF(seq);
+    return result;
+
+error:
+    Py_XDECREF(result);
+    Py_DECREF(seq);
     return NULL;
 }
 
@@ -1272,6 +1413,10 @@ static PyMethodDef unicodedata_functions[] = {
     UNICODEDATA_UCD_NAME_METHODDEF
     UNICODEDATA_UCD_LOOKUP_METHODDEF
     UNICODEDATA_UCD_NORMALIZE_METHODDEF
+    {"is_normalized", unicodedata_UCD_is_normalized, METH_VARARGS,
+     unicodedata_UCD_is_normalized__doc__},
+    {"normalize_many", unicodedata_UCD_normalize_many, METH_VARARGS,
+     unicodedata_UCD_normalize_many__doc__},
     {NULL, NULL}                /* sentinel */
 };
 
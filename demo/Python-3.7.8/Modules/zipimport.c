@@ -4,8 +4,17 @@
 #include "structmember.h"
 #include "osdefs.h"
 #include "marshal.h"
+#include "pythread.h"
 #include <time.h>
 
+#ifndef MS_WINDOWS
+#define ZIPIMPORT_MMAP
+#include <sys/mman.h>
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#endif
+
 
 #define IS_SOURCE   0x0
 #define IS_BYTECODE 0x1
@@ -44,15 +53,63 @@ struct _zipimporter {
     PyObject *prefix;   /* file prefix: "a/sub/directory/",
                            encoded to the filesystem encoding */
     PyObject *files;    /* dict with file info {path: toc_entry} */
+    PyObject *index;    /* capsule wrapping the ZipIndex of the archive,
+                           or NULL if it has no central directory index */
 };
 
+/* A memory mapped archive with a deploy-time hash index of its central
+   directory.  See read_index() for the format of the index. */
+typedef struct {
+    unsigned char *map;             /* the mapped archive */
+    size_t map_size;
+    const unsigned char *cdir;      /* start of the central directory */
+    size_t cdir_size;
+    unsigned long arc_offset;       /* absolute offset to start of the
+                                       zip-archive */
+    unsigned int header_offset;     /* offset of the central directory */
+    const unsigned char *slots;     /* the hash index */
+    unsigned int nslots;            /* number of slots, a power of 2 */
+    unsigned int flags;             /* ZIP_INDEX_SEALED */
+    int complete;                   /* the files dict holds every entry,
+                                       see fill_directory() */
+} ZipIndex;
+
+/* The archive is sealed, ie. its .pyc files are always used without being
+   checked against the modification time of any .py file. */
+#define ZIP_INDEX_SEALED    0x0001
+
+/* The maximum total size of the decompressed data kept by the get_data()
+   cache of a memory mapped archive and the maximum number of files. */
+#ifndef ZIP_DATA_CACHE_SIZE
+#define ZIP_DATA_CACHE_SIZE (4 * 1024 * 1024)
+#endif
+#define ZIP_DATA_CACHE_ENTRIES  32
+
+/* The maximum total size of the data decompressed by prefetch() that has
+   not been imported yet. */
+#ifndef ZIP_PREFETCH_CACHE_SIZE
+#define ZIP_PREFETCH_CACHE_SIZE (32 * 1024 * 1024)
+#endif
+
 static PyObject *ZipImportError;
 /* read_directory() cache */
 static PyObject *zip_directory_cache = NULL;
+/* read_index() cache, {archive: capsule} */
+static PyObject *zip_index_cache = NULL;
+/* prefetch() results, {toc_entry: data} */
+static PyObject *zip_prefetch_cache = NULL;
+/* The total size of the data in zip_prefetch_cache. */
+static Py_ssize_t zip_prefetch_size = 0;
+/* The number of running prefetch() threads. */
+static int zip_prefetch_threads = 0;
 
 /* forward decls */
 static PyObject *read_directory(PyObject *archive);
-static PyObject *get_data(PyObject *archive, PyObject *toc_entry);
+static PyObject *read_index(PyObject *archive);
+static int fill_directory(PyObject *archive, PyObject *files, PyObject *index);
+static PyObject *get_toc_entry(ZipImporter *self, PyObject *path);
+static int prefetch_forget(PyObject *archive);
+static PyObject *get_data(ZipImporter *self, PyObject *toc_entry);
 static PyObject *get_module_code(ZipImporter *self, PyObject *fullname,
                                  int *p_ispackage, PyObject **p_modpath);
 
@@ -102,6 +159,7 @@ zipimport_zipimporter___init___impl(ZipImporter *self, PyObject *path)
 {
     PyObject *files, *tmp;
     PyObject *filename = NULL;
+    PyObject *index = NULL;
     Py_ssize_t len, flen;
 
     if (PyUnicode_READY(path) == -1)
@@ -157,15 +215,50 @@ zipimport_zipimporter___init___impl(ZipImporter *self, PyObject *path)
 
     files = PyDict_GetItem(zip_directory_cache, filename);
     if (files == NULL) {
-        files = read_directory(filename);
+        /* The directory is read again, so what was prefetched from the
+           archive may be out of date. */
+        if (prefetch_forget(filename) < 0)
+            goto error;
+        /* An archive with a central directory index starts with an empty
+           dict that is filled lazily by get_toc_entry(). */
+        index = read_index(filename);
+        if (index == NULL)
+            goto error;
+        if (index != Py_None) {
+            files = PyDict_New();
+        }
+        else {
+            Py_CLEAR(index);
+            files = read_directory(filename);
+        }
         if (files == NULL)
             goto error;
-        if (PyDict_SetItem(zip_directory_cache, filename, files) != 0)
+        if (PyDict_SetItem(zip_directory_cache, filename, files) != 0) {
+            Py_DECREF(files);
             goto error;
+        }
+        if (index != NULL) {
+            if (PyDict_SetItem(zip_index_cache, filename, index) != 0) {
+                Py_DECREF(files);
+                goto error;
+            }
+        }
+        else if (PyDict_GetItem(zip_index_cache, filename) != NULL) {
+            /* The archive has been replaced by one without an index. */
+            if (PyDict_DelItem(zip_index_cache, filename) != 0) {
+                Py_DECREF(files);
+                goto error;
+            }
+        }
     }
-    else
+    else {
         Py_INCREF(files);
+        index = PyDict_GetItem(zip_index_cache, filename);
+        Py_XINCREF(index);
+    }
     Py_XSETREF(self->files, files);
+    Py_XSETREF(self->index, index);
+    index = NULL;
 
     /* Transfer reference */
     Py_XSETREF(self->archive, filename);
@@ -195,6 +288,7 @@ zipimport_zipimporter___init___impl(ZipImporter *self, PyObject *path)
 error:
     Py_DECREF(path);
     Py_XDECREF(filename);
+    Py_XDECREF(index);
     return -1;
 }
 
@@ -214,6 +308,7 @@ zipimporter_dealloc(ZipImporter *self)
     Py_XDECREF(self->archive);
     Py_XDECREF(self->prefix);
     Py_XDECREF(self->files);
+    Py_XDECREF(self->index);
     Py_TYPE(self)->tp_free((PyObject *)self);
 }
 
@@ -310,7 +405,10 @@ check_is_directory(ZipImporter *self, PyObject* prefix, PyObject *path)
     if (dirpath == NULL)
         return -1;
     /* If dirpath is present in self->files, we have a directory. */
-    res = PyDict_Contains(self->files, dirpath);
+    if (get_toc_entry(self, dirpath) != NULL)
+        res = 1;
+    else
+        res = PyErr_Occurred() ? -1 : 0;
     Py_DECREF(dirpath);
     return res;
 }
@@ -344,8 +442,12 @@ get_module_info(ZipImporter *self, PyObject *fullname)
             Py_DECREF(path);
             return MI_ERROR;
         }
-        item = PyDict_GetItem(self->files, fullpath);
+        item = get_toc_entry(self, fullpath);
         Py_DECREF(fullpath);
+        if (item == NULL && PyErr_Occurred()) {
+            Py_DECREF(path);
+            return MI_ERROR;
+        }
         if (item != NULL) {
             Py_DECREF(path);
             if (zso->type & IS_PACKAGE)
@@ -525,6 +627,7 @@ zipimport_zipimporter_load_module_impl(ZipImporter *self, PyObject *fullname)
     PyObject *code = NULL, *mod, *dict;
     PyObject *modpath = NULL;
     int ispackage;
+    _PyTime_t start = _PyTime_GetMonotonicClock();
 
     if (PyUnicode_READY(fullname) == -1)
         return NULL;
@@ -575,6 +678,14 @@ zipimport_zipimporter_load_module_impl(ZipImporter *self, PyObject *fullname)
     if (Py_VerboseFlag)
         PySys_FormatStderr("import %U # loaded from Zip %U\n",
                            fullname, modpath);
+    if (_PyStartupTrace_Enabled()) {
+        /* Includes the imports made by the module's code, shown nested */
+        const char *name = PyUnicode_AsUTF8(fullname);
+        if (name != NULL)
+            _PyStartupTrace_Event("import", name, start);
+        else
+            PyErr_Clear();
+    }
     Py_DECREF(modpath);
     return mod;
 error:
@@ -688,15 +799,16 @@ zipimport_zipimporter_get_data_impl(ZipImporter *self, PyObject *path)
     key = PyUnicode_Substring(path, path_start, path_len);
     if (key == NULL)
         goto error;
-    toc_entry = PyDict_GetItem(self->files, key);
+    toc_entry = get_toc_entry(self, key);
     if (toc_entry == NULL) {
-        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, key);
+        if (!PyErr_Occurred())
+            PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, key);
         Py_DECREF(key);
         goto error;
     }
     Py_DECREF(key);
     Py_DECREF(path);
-    return get_data(self->archive, toc_entry);
+    return get_data(self, toc_entry);
   error:
     Py_DECREF(path);
     return NULL;
@@ -767,11 +879,13 @@ zipimport_zipimporter_get_source_impl(ZipImporter *self, PyObject *fullname)
     if (fullpath == NULL)
         return NULL;
 
-    toc_entry = PyDict_GetItem(self->files, fullpath);
+    toc_entry = get_toc_entry(self, fullpath);
     Py_DECREF(fullpath);
+    if (toc_entry == NULL && PyErr_Occurred())
+        return NULL;
     if (toc_entry != NULL) {
         PyObject *res, *bytes;
-        bytes = get_data(self->archive, toc_entry);
+        bytes = get_data(self, toc_entry);
         if (bytes == NULL)
             return NULL;
         res = PyUnicode_FromStringAndSize(PyBytes_AS_STRING(bytes),
@@ -830,7 +944,25 @@ static PyMethodDef zipimporter_methods[] = {
 static PyMemberDef zipimporter_members[] = {
     {"archive",  T_OBJECT, offsetof(ZipImporter, archive),  READONLY},
     {"prefix",   T_OBJECT, offsetof(ZipImporter, prefix),   READONLY},
-    {"_files",   T_OBJECT, offsetof(ZipImporter, files),    READONLY},
+    {NULL}
+};
+
+/* _files is read by code that enumerates the archive, so the lazily read
+   directory of an archive with an index is completed first. */
+static PyObject *
+zipimporter_get_files(ZipImporter *self, void *closure)
+{
+    if (self->files == NULL)
+        Py_RETURN_NONE;
+    if (self->index != NULL &&
+        fill_directory(self->archive, self->files, self->index) < 0)
+        return NULL;
+    Py_INCREF(self->files);
+    return self->files;
+}
+
+static PyGetSetDef zipimporter_getset[] = {
+    {"_files", (getter)zipimporter_get_files, NULL, NULL, NULL},
     {NULL}
 };
 
@@ -867,7 +999,7 @@ static PyTypeObject ZipImporter_Type = {
     0,                                          /* tp_iternext */
     zipimporter_methods,                        /* tp_methods */
     zipimporter_members,                        /* tp_members */
-    0,                                          /* tp_getset */
+    zipimporter_getset,                         /* tp_getset */
     0,                                          /* tp_base */
     0,                                          /* tp_dict */
     0,                                          /* tp_descr_get */
@@ -919,6 +1051,102 @@ set_file_error(PyObject *archive, int eof)
     }
 }
 
+/* Given a central directory file header and the file name that follows it
+   (with '/' already replaced by SEP), return the toc entry as a new
+   reference.  The decoded file name is returned as a new reference in
+   *p_nameobj. */
+static PyObject *
+make_toc_entry(PyObject *archive, const unsigned char *header,
+               const char *name, unsigned short name_size,
+               unsigned long arc_offset, unsigned int header_offset,
+               PyObject **p_nameobj)
+{
+    unsigned short flags, compress, time, date;
+    unsigned int crc, data_size, file_size;
+    unsigned long file_offset;
+    PyObject *nameobj, *path, *t;
+    const char *charset;
+    int bootstrap;
+
+    flags = get_uint16(header + 8);
+    compress = get_uint16(header + 10);
+    time = get_uint16(header + 12);
+    date = get_uint16(header + 14);
+    crc = get_uint32(header + 16);
+    data_size = get_uint32(header + 20);
+    file_size = get_uint32(header + 24);
+
+    file_offset = get_uint32(header + 42);
+    if (file_offset > header_offset) {
+        PyErr_Format(ZipImportError, "bad local header offset: %R", archive);
+        return NULL;
+    }
+    file_offset += arc_offset;
+
+    bootstrap = 0;
+    if (flags & 0x0800) {
+        charset = "utf-8";
+    }
+    else if (!PyThreadState_GET()->interp->codecs_initialized) {
+        /* During bootstrap, we may need to load the encodings
+           package from a ZIP file. But the cp437 encoding is implemented
+           in Python in the encodings package.
+
+           Break out of this dependency by assuming that the path to
+           the encodings module is ASCII-only. */
+        charset = "ascii";
+        bootstrap = 1;
+    }
+    else {
+        charset = "cp437";
+    }
+    nameobj = PyUnicode_Decode(name, name_size, charset, NULL);
+    if (nameobj == NULL) {
+        if (bootstrap) {
+            PyErr_Format(PyExc_NotImplementedError,
+                "bootstrap issue: python%i%i.zip contains non-ASCII "
+                "filenames without the unicode flag",
+                PY_MAJOR_VERSION, PY_MINOR_VERSION);
+        }
+        return NULL;
+    }
+    if (PyUnicode_READY(nameobj) == -1) {
+        Py_DECREF(nameobj);
+        return NULL;
+    }
+    path = PyUnicode_FromFormat("%U%c%U", archive, SEP, nameobj);
+    if (path == NULL) {
+        Py_DECREF(nameobj);
+        return NULL;
+    }
+    t = Py_BuildValue("NHIIkHHI", path, compress, data_size,
+                      file_size, file_offset, time, date, crc);
+    if (t == NULL) {
+        Py_DECREF(nameobj);
+        return NULL;
+    }
+    *p_nameobj = nameobj;
+    return t;
+}
+
+/* Search the last 'size' bytes of an archive for the End of Central Dir
+   record and return its offset in 'tail', or -1 if there isn't one.  The
+   record is followed by a comment of up to 64K so we look for the last
+   signature whose comment length is consistent with where it was found. */
+static Py_ssize_t
+find_end_of_central_dir(const unsigned char *tail, Py_ssize_t size)
+{
+    Py_ssize_t pos;
+
+    for (pos = size - 22; pos >= 0 && size - pos <= 22 + 0xFFFF; pos--) {
+        if (tail[pos] == 0x50 && get_uint32(tail + pos) == 0x06054B50u &&
+            pos + 22 + get_uint16(tail + pos + 20) == size) {
+            return pos;
+        }
+    }
+    return -1;
+}
+
 /*
    read_directory(archive) -> files dict (new reference)
 
@@ -946,17 +1174,14 @@ read_directory(PyObject *archive)
 {
     PyObject *files = NULL;
     FILE *fp;
-    unsigned short flags, compress, time, date, name_size;
-    unsigned int crc, data_size, file_size, header_size, header_offset;
-    unsigned long file_offset, header_position;
+    unsigned short name_size;
+    unsigned int header_size, header_offset;
+    unsigned long header_position;
     unsigned long arc_offset;  /* Absolute offset to start of the zip-archive. */
     unsigned int count, i;
     unsigned char buffer[46];
     char name[MAXPATHLEN + 5];
     PyObject *nameobj = NULL;
-    PyObject *path;
-    const char *charset;
-    int bootstrap;
     const char *errmsg = NULL;
 
     fp = _Py_fopen_obj(archive, "rb");
@@ -980,9 +1205,36 @@ read_directory(PyObject *archive)
         goto file_error;
     }
     if (get_uint32(buffer) != 0x06054B50u) {
-        /* Bad: End of Central Dir signature */
-        errmsg = "not a Zip file";
-        goto invalid_header;
+        /* The archive may have a comment (eg. a central directory index)
+           so search the tail of the file. */
+        unsigned char *tail;
+        Py_ssize_t tail_size, pos;
+
+        tail_size = (Py_ssize_t)Py_MIN(header_position + 22,
+                                       (unsigned long)(22 + 0xFFFF));
+        if (fseek(fp, -(long)tail_size, SEEK_END) == -1) {
+            goto file_error;
+        }
+        tail = PyMem_Malloc(tail_size);
+        if (tail == NULL) {
+            PyErr_NoMemory();
+            goto error;
+        }
+        if (fread(tail, 1, tail_size, fp) != (size_t)tail_size) {
+            PyMem_Free(tail);
+            goto file_error;
+        }
+        pos = find_end_of_central_dir(tail, tail_size);
+        if (pos >= 0) {
+            memcpy(buffer, tail + pos, 22);
+            header_position -= (unsigned long)(tail_size - 22 - pos);
+        }
+        PyMem_Free(tail);
+        if (pos < 0) {
+            /* Bad: End of Central Dir signature */
+            errmsg = "not a Zip file";
+            goto invalid_header;
+        }
     }
 
     header_size = get_uint32(buffer + 12);
@@ -1027,25 +1279,11 @@ read_directory(PyObject *archive)
         if (n != 46) {
             goto eof_error;
         }
-        flags = get_uint16(buffer + 8);
-        compress = get_uint16(buffer + 10);
-        time = get_uint16(buffer + 12);
-        date = get_uint16(buffer + 14);
-        crc = get_uint32(buffer + 16);
-        data_size = get_uint32(buffer + 20);
-        file_size = get_uint32(buffer + 24);
         name_size = get_uint16(buffer + 28);
         header_size = (unsigned int)name_size +
            get_uint16(buffer + 30) /* extra field */ +
            get_uint16(buffer + 32) /* comment */;
 
-        file_offset = get_uint32(buffer + 42);
-        if (file_offset > header_offset) {
-            errmsg = "bad local header offset";
-            goto invalid_header;
-        }
-        file_offset += arc_offset;
-
         if (name_size > MAXPATHLEN) {
             name_size = MAXPATHLEN;
         }
@@ -1071,42 +1309,8 @@ read_directory(PyObject *archive)
             }
         }
 
-        bootstrap = 0;
-        if (flags & 0x0800) {
-            charset = "utf-8";
-        }
-        else if (!PyThreadState_GET()->interp->codecs_initialized) {
-            /* During bootstrap, we may need to load the encodings
-               package from a ZIP file. But the cp437 encoding is implemented
-               in Python in the encodings package.
-
-               Break out of this dependency by assuming that the path to
-               the encodings module is ASCII-only. */
-            charset = "ascii";
-            bootstrap = 1;
-        }
-        else {
-            charset = "cp437";
-        }
-        nameobj = PyUnicode_Decode(name, name_size, charset, NULL);
-        if (nameobj == NULL) {
-            if (bootstrap) {
-                PyErr_Format(PyExc_NotImplementedError,
-                    "bootstrap issue: python%i%i.zip contains non-ASCII "
-                    "filenames without the unicode flag",
-                    PY_MAJOR_VERSION, PY_MINOR_VERSION);
-            }
-            goto error;
-        }
-        if (PyUnicode_READY(nameobj) == -1) {
-            goto error;
-        }
-        path = PyUnicode_FromFormat("%U%c%U", archive, SEP, nameobj);
-        if (path == NULL) {
-            goto error;
-        }
-        t = Py_BuildValue("NHIIkHHI", path, compress, data_size,
-                          file_size, file_offset, time, date, crc);
+        t = make_toc_entry(archive, buffer, name, name_size, arc_offset,
+                           header_offset, &nameobj);
         if (t == NULL) {
             goto error;
         }
@@ -1145,6 +1349,298 @@ error:
     return NULL;
 }
 
+/* The signature of a central directory index in the archive comment. */
+#define ZIP_INDEX_MAGIC "PyZI"
+
+/* The value of an unused slot of a central directory index. */
+#define ZIP_INDEX_EMPTY 0xFFFFFFFFu
+
+/* Return the hash of a file name as stored in the central directory.  This
+   is the 32 bit FNV-1a hash and must match the one used to build the
+   index. */
+static unsigned int
+zip_index_hash(const unsigned char *name, Py_ssize_t name_size)
+{
+    unsigned int h = 2166136261u;
+    Py_ssize_t i;
+
+    for (i = 0; i < name_size; i++) {
+        h ^= name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+#ifdef ZIPIMPORT_MMAP
+static void
+zip_index_destructor(PyObject *capsule)
+{
+    ZipIndex *zi = (ZipIndex *)PyCapsule_GetPointer(capsule, NULL);
+
+    munmap(zi->map, zi->map_size);
+    PyMem_Free(zi);
+}
+#endif
+
+/*
+   read_index(archive) -> capsule (new reference)
+
+   Given a path to a Zip archive, memory map it and, if its comment contains
+   a central directory index, return a capsule wrapping a ZipIndex.  Return
+   None if the archive has no index (or can't be mapped) and the caller
+   should fall back to read_directory().
+
+   The index is built at deploy time and stored as the archive comment:
+
+   "PyZI"          # signature
+   nslots          # uint32, number of slots, must be a power of 2
+   slot * nslots   # uint32, offset of a file header from the start of the
+                   # central directory, or 0xFFFFFFFF if the slot is unused
+   flags           # uint32, optional, ZIP_INDEX_SEALED
+
+   A file is found by starting at slot (zip_index_hash(name) & (nslots - 1))
+   and probing linearly until an unused slot is found.  name is the file
+   name exactly as it is stored in the central directory (it is always
+   compared as UTF-8 with '/' as the separator) and directories must be
+   included.  All values are little endian.
+*/
+static PyObject *
+read_index(PyObject *archive)
+{
+#ifdef ZIPIMPORT_MMAP
+    PyObject *fsarchive, *capsule;
+    ZipIndex *zi;
+    struct _Py_stat_struct status;
+    unsigned char *map;
+    const unsigned char *eocd, *comment;
+    size_t map_size;
+    unsigned long header_position, header_size, header_offset;
+    Py_ssize_t tail_size, pos;
+    unsigned int comment_size, nslots;
+    int fd;
+
+    fsarchive = PyUnicode_EncodeFSDefault(archive);
+    if (fsarchive == NULL)
+        return NULL;
+    fd = _Py_open_noraise(PyBytes_AS_STRING(fsarchive), O_RDONLY);
+    Py_DECREF(fsarchive);
+    if (fd < 0)
+        Py_RETURN_NONE;
+    if (_Py_fstat_noraise(fd, &status) != 0 || status.st_size < 22 ||
+        (unsigned long long)status.st_size > (unsigned long long)PY_SSIZE_T_MAX) {
+        close(fd);
+        Py_RETURN_NONE;
+    }
+    map_size = (size_t)status.st_size;
+    map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        Py_RETURN_NONE;
+
+    tail_size = (Py_ssize_t)Py_MIN(map_size, (size_t)(22 + 0xFFFF));
+    pos = find_end_of_central_dir(map + map_size - tail_size, tail_size);
+    if (pos < 0)
+        goto no_index;
+    eocd = map + map_size - tail_size + pos;
+    comment = eocd + 22;
+    comment_size = get_uint16(eocd + 20);
+    if (comment_size < 8 || memcmp(comment, ZIP_INDEX_MAGIC, 4) != 0)
+        goto no_index;
+    nslots = get_uint32(comment + 4);
+    if (nslots == 0 || (nslots & (nslots - 1)) != 0 ||
+        nslots > (comment_size - 8) / 4)
+        goto no_index;
+
+    /* Apply the same checks as read_directory(). */
+    header_position = (unsigned long)(eocd - map);
+    header_size = get_uint32(eocd + 12);
+    header_offset = get_uint32(eocd + 16);
+    if (header_position < header_size || header_position < header_offset ||
+        header_position - header_size < header_offset)
+        goto no_index;
+    header_position -= header_size;
+
+    zi = PyMem_Malloc(sizeof (ZipIndex));
+    if (zi == NULL) {
+        munmap(map, map_size);
+        return PyErr_NoMemory();
+    }
+    zi->map = map;
+    zi->map_size = map_size;
+    zi->cdir = map + header_position;
+    zi->cdir_size = header_size;
+    zi->arc_offset = header_position - header_offset;
+    zi->header_offset = (unsigned int)header_offset;
+    zi->slots = comment + 8;
+    zi->nslots = nslots;
+    zi->flags = 0;
+    zi->complete = 0;
+    if (comment_size - 8 - 4 * nslots >= 4)
+        zi->flags = get_uint32(zi->slots + 4 * nslots);
+
+    capsule = PyCapsule_New(zi, NULL, zip_index_destructor);
+    if (capsule == NULL) {
+        munmap(map, map_size);
+        PyMem_Free(zi);
+        return NULL;
+    }
+    if (Py_VerboseFlag) {
+        PySys_FormatStderr("# zipimport: using central directory index "
+                           "of %u slots in %R\n", nslots, archive);
+    }
+    return capsule;
+
+no_index:
+    munmap(map, map_size);
+#endif
+    Py_RETURN_NONE;
+}
+
+/* Look up a file in the central directory index of the archive and, if
+   found, add its toc entry to self->files.  Return the toc entry as a
+   borrowed reference, or NULL if it wasn't found (or with an exception set
+   on error). */
+static PyObject *
+index_lookup(ZipImporter *self, PyObject *path)
+{
+    ZipIndex *zi;
+    PyObject *encoded, *toc_entry, *nameobj;
+    unsigned char *name;
+    Py_ssize_t name_size, i;
+    unsigned int h, mask, probe;
+    int err;
+
+    zi = (ZipIndex *)PyCapsule_GetPointer(self->index, NULL);
+    if (zi == NULL)
+        return NULL;
+    if (zi->complete)
+        return NULL;
+
+    encoded = PyUnicode_AsUTF8String(path);
+    if (encoded == NULL)
+        return NULL;
+    name = (unsigned char *)PyBytes_AS_STRING(encoded);
+    name_size = PyBytes_GET_SIZE(encoded);
+    if (name_size > MAXPATHLEN) {
+        /* read_directory() would have truncated it so it can't match. */
+        Py_DECREF(encoded);
+        return NULL;
+    }
+#if SEP != '/'
+    for (i = 0; i < name_size; i++) {
+        if (name[i] == SEP) {
+            name[i] = '/';
+        }
+    }
+#endif
+
+    h = zip_index_hash(name, name_size);
+    mask = zi->nslots - 1;
+    for (probe = 0; probe < zi->nslots; probe++) {
+        const unsigned char *header;
+        unsigned int offset;
+        unsigned short centry_name_size;
+
+        offset = get_uint32(zi->slots + 4 * ((h + probe) & mask));
+        if (offset == ZIP_INDEX_EMPTY)
+            break;
+        if (offset > zi->cdir_size || zi->cdir_size - offset < 46)
+            goto invalid_index;
+        header = zi->cdir + offset;
+        if (get_uint32(header) != 0x02014B50u)
+            goto invalid_index;
+        centry_name_size = get_uint16(header + 28);
+        if (zi->cdir_size - offset - 46 < centry_name_size)
+            goto invalid_index;
+        if (centry_name_size != name_size ||
+            memcmp(header + 46, name, name_size) != 0)
+            continue;
+
+        /* The stored name is only used if it is actually UTF-8 (or ASCII
+           which make_toc_entry() will decode identically). */
+        if (!(get_uint16(header + 8) & 0x0800)) {
+            for (i = 0; i < name_size; i++) {
+                if (name[i] & 0x80)
+                    break;
+            }
+            if (i < name_size)
+                break;
+        }
+#if SEP != '/'
+        for (i = 0; i < name_size; i++) {
+            if (name[i] == '/') {
+                name[i] = SEP;
+            }
+        }
+#endif
+        toc_entry = make_toc_entry(self->archive, header, (char *)name,
+                                   (unsigned short)name_size,
+                                   zi->arc_offset, zi->header_offset,
+                                   &nameobj);
+        Py_DECREF(encoded);
+        if (toc_entry == NULL)
+            return NULL;
+        err = PyDict_SetItem(self->files, nameobj, toc_entry);
+        Py_DECREF(nameobj);
+        Py_DECREF(toc_entry);
+        if (err != 0)
+            return NULL;
+        /* self->files now owns the entry. */
+        return toc_entry;
+    }
+    Py_DECREF(encoded);
+    return NULL;
+
+invalid_index:
+    Py_DECREF(encoded);
+    PyErr_Format(ZipImportError, "bad central directory index: %R",
+                 self->archive);
+    return NULL;
+}
+
+/* Read the whole central directory of an archive with an index into its
+   files dict, for code that enumerates the dict (eg. pkgutil.iter_modules())
+   rather than looking entries up.  Entries that have been looked up already
+   are kept.  Return 0 on success, or -1 with an exception set. */
+static int
+fill_directory(PyObject *archive, PyObject *files, PyObject *index)
+{
+    ZipIndex *zi;
+    PyObject *all;
+    int err;
+
+    zi = (ZipIndex *)PyCapsule_GetPointer(index, NULL);
+    if (zi == NULL)
+        return -1;
+    if (zi->complete)
+        return 0;
+
+    all = read_directory(archive);
+    if (all == NULL)
+        return -1;
+    err = PyDict_Merge(files, all, 0);
+    Py_DECREF(all);
+    if (err != 0)
+        return -1;
+    zi->complete = 1;
+    return 0;
+}
+
+/* Return the toc entry for a file in the archive as a borrowed reference,
+   or NULL if there is no such file (or with an exception set on error).
+   Entries of an archive with a central directory index are only read when
+   they are first asked for. */
+static PyObject *
+get_toc_entry(ZipImporter *self, PyObject *path)
+{
+    PyObject *toc_entry;
+
+    toc_entry = PyDict_GetItem(self->files, path);
+    if (toc_entry != NULL || self->index == NULL)
+        return toc_entry;
+    return index_lookup(self, path);
+}
+
 /* Return the zlib.decompress function object, or NULL if zlib couldn't
    be imported. The function is cached when found, so subsequent calls
    don't import zlib again. */
@@ -1181,7 +1677,7 @@ get_decompress_func(void)
 /* Given a path to a Zip file and a toc_entry, return the (uncompressed)
    data as a new reference. */
 static PyObject *
-get_data(PyObject *archive, PyObject *toc_entry)
+read_data(PyObject *archive, PyObject *toc_entry)
 {
     PyObject *raw_data = NULL, *data, *decompress;
     char *buf;
@@ -1311,6 +1807,576 @@ error:
     return NULL;
 }
 
+/* The get_data() cache of decompressed data from memory mapped archives,
+   most recently used first.  The toc entry is the key. */
+static struct {
+    PyObject *toc_entry;
+    PyObject *data;
+} zip_data_cache[ZIP_DATA_CACHE_ENTRIES];
+static int zip_data_cache_len = 0;
+static Py_ssize_t zip_data_cache_bytes = 0;
+
+/* Return the cached data for a toc entry as a new reference, or NULL if it
+   isn't cached. */
+static PyObject *
+data_cache_get(PyObject *toc_entry)
+{
+    PyObject *data;
+    int i;
+
+    for (i = 0; i < zip_data_cache_len; i++) {
+        if (zip_data_cache[i].toc_entry == toc_entry)
+            break;
+    }
+    if (i == zip_data_cache_len)
+        return NULL;
+
+    /* Move it to the front. */
+    data = zip_data_cache[i].data;
+    memmove(&zip_data_cache[1], &zip_data_cache[0],
+            i * sizeof (zip_data_cache[0]));
+    zip_data_cache[0].toc_entry = toc_entry;
+    zip_data_cache[0].data = data;
+
+    Py_INCREF(data);
+    return data;
+}
+
+/* Add the data for a toc entry to the cache, discarding the least recently
+   used data to make room for it. */
+static void
+data_cache_put(PyObject *toc_entry, PyObject *data)
+{
+    Py_ssize_t size = PyBytes_GET_SIZE(data);
+
+    /* Don't let one large file flush everything else. */
+    if (size > ZIP_DATA_CACHE_SIZE / 4)
+        return;
+
+    while (zip_data_cache_len > 0 &&
+           (zip_data_cache_len == ZIP_DATA_CACHE_ENTRIES ||
+            zip_data_cache_bytes + size > ZIP_DATA_CACHE_SIZE)) {
+        zip_data_cache_len--;
+        zip_data_cache_bytes -= PyBytes_GET_SIZE(
+                zip_data_cache[zip_data_cache_len].data);
+        Py_DECREF(zip_data_cache[zip_data_cache_len].toc_entry);
+        Py_DECREF(zip_data_cache[zip_data_cache_len].data);
+    }
+
+    memmove(&zip_data_cache[1], &zip_data_cache[0],
+            zip_data_cache_len * sizeof (zip_data_cache[0]));
+    Py_INCREF(toc_entry);
+    zip_data_cache[0].toc_entry = toc_entry;
+    Py_INCREF(data);
+    zip_data_cache[0].data = data;
+    zip_data_cache_len++;
+    zip_data_cache_bytes += size;
+}
+
+/* Given a toc_entry of a memory mapped archive, return a pointer to the
+   (possibly compressed) data of the file in the mapping, or NULL with an
+   exception set on error.  The compression kind and size of the data are
+   returned in *p_compress and *p_data_size. */
+static const unsigned char *
+find_mapped_data(ZipImporter *self, PyObject *toc_entry,
+                 unsigned short *p_compress, Py_ssize_t *p_data_size)
+{
+    ZipIndex *zi;
+    PyObject *datapath;
+    unsigned short compress, time, date;
+    unsigned int crc;
+    Py_ssize_t data_size, file_size;
+    unsigned long file_offset, header_size;
+    const unsigned char *header;
+    const char *errmsg = NULL;
+
+    if (!PyArg_ParseTuple(toc_entry, "OHnnkHHI", &datapath, &compress,
+                          &data_size, &file_size, &file_offset, &time,
+                          &date, &crc)) {
+        return NULL;
+    }
+    if (data_size < 0) {
+        PyErr_Format(ZipImportError, "negative data size");
+        return NULL;
+    }
+
+    zi = (ZipIndex *)PyCapsule_GetPointer(self->index, NULL);
+    if (zi == NULL)
+        return NULL;
+
+    /* Check to make sure the local file header is correct */
+    if (file_offset > zi->map_size || zi->map_size - file_offset < 30) {
+        set_file_error(self->archive, 1);
+        return NULL;
+    }
+    header = zi->map + file_offset;
+    if (get_uint32(header) != 0x04034B50u) {
+        /* Bad: Local File Header */
+        errmsg = "bad local file header";
+        goto invalid_header;
+    }
+
+    header_size = (unsigned int)30 +
+        get_uint16(header + 26) /* file name */ +
+        get_uint16(header + 28) /* extra field */;
+    if (zi->map_size - file_offset < header_size) {
+        errmsg = "bad local file header size";
+        goto invalid_header;
+    }
+    file_offset += header_size;  /* Start of file data */
+    if ((size_t)data_size > zi->map_size - file_offset) {
+        set_file_error(self->archive, 1);
+        return NULL;
+    }
+
+    *p_compress = compress;
+    *p_data_size = data_size;
+    return zi->map + file_offset;
+
+invalid_header:
+    assert(errmsg != NULL);
+    PyErr_Format(ZipImportError, "%s: %R", errmsg, self->archive);
+    return NULL;
+}
+
+/* Decompress the data of a file in a memory mapped archive and return it as
+   a new reference. */
+static PyObject *
+inflate_mapped_data(const unsigned char *buf, Py_ssize_t data_size)
+{
+    PyObject *raw_data, *data, *decompress;
+
+    /* Decompress with zlib, reading directly from the mapping */
+    decompress = get_decompress_func();
+    if (decompress == NULL) {
+        PyErr_SetString(ZipImportError,
+                        "can't decompress data; "
+                        "zlib not available");
+        return NULL;
+    }
+    raw_data = PyMemoryView_FromMemory((char *)buf, data_size, PyBUF_READ);
+    if (raw_data == NULL) {
+        Py_DECREF(decompress);
+        return NULL;
+    }
+    data = PyObject_CallFunction(decompress, "Oi", raw_data, -15);
+    Py_DECREF(decompress);
+    Py_DECREF(raw_data);
+    if (data != NULL && !PyBytes_Check(data)) {
+        PyErr_Format(PyExc_TypeError,
+                     "zlib.decompress() must return a bytes object, not "
+                     "%.200s",
+                     Py_TYPE(data)->tp_name);
+        Py_DECREF(data);
+        return NULL;
+    }
+    return data;
+}
+
+/* Given a toc_entry of a memory mapped archive, return the (uncompressed)
+   data as a new reference.  Stored data is copied straight from the
+   mapping and decompressed data is cached. */
+static PyObject *
+get_mapped_data(ZipImporter *self, PyObject *toc_entry)
+{
+    PyObject *data;
+    const unsigned char *buf;
+    unsigned short compress;
+    Py_ssize_t data_size;
+
+    buf = find_mapped_data(self, toc_entry, &compress, &data_size);
+    if (buf == NULL)
+        return NULL;
+
+    if (compress == 0)  /* data is not compressed */
+        return PyBytes_FromStringAndSize((const char *)buf, data_size);
+
+    data = data_cache_get(toc_entry);
+    if (data != NULL)
+        return data;
+
+    data = inflate_mapped_data(buf, data_size);
+    if (data != NULL)
+        data_cache_put(toc_entry, data);
+    return data;
+}
+
+/* Given a zipimporter and a toc_entry, return the (uncompressed) data as a
+   new reference. */
+static PyObject *
+get_data(ZipImporter *self, PyObject *toc_entry)
+{
+    if (self->index != NULL) {
+        /* Data decompressed by prefetch() is only used once.  While
+           prefetching is in progress anything read here is marked with None
+           so that the threads don't bother with it. */
+        if (zip_prefetch_threads != 0 ||
+            PyDict_GET_SIZE(zip_prefetch_cache) != 0) {
+            PyObject *data = PyDict_GetItem(zip_prefetch_cache, toc_entry);
+
+            if (data != NULL && data != Py_None) {
+                Py_INCREF(data);
+                if (PyDict_DelItem(zip_prefetch_cache, toc_entry) != 0) {
+                    Py_DECREF(data);
+                    return NULL;
+                }
+                zip_prefetch_size -= PyBytes_GET_SIZE(data);
+                return data;
+            }
+            if (data == NULL && zip_prefetch_threads != 0) {
+                if (PyDict_SetItem(zip_prefetch_cache, toc_entry,
+                                   Py_None) != 0)
+                    return NULL;
+            }
+        }
+        return get_mapped_data(self, toc_entry);
+    }
+    return read_data(self->archive, toc_entry);
+}
+
+/* The state shared by the threads started by prefetch(). */
+typedef struct {
+    PyObject *work;         /* list of (zipimporter, toc_entry, isbytecode) */
+    Py_ssize_t next;        /* index of the next item of work */
+    int nthreads;           /* number of running threads */
+} PrefetchState;
+
+/* A prefetch() thread.  Python code isn't run, the GIL is held only while
+   handling the work list and the results and it is released by
+   zlib.decompress() while inflating. */
+static void
+prefetch_thread(void *arg)
+{
+    PrefetchState *state = (PrefetchState *)arg;
+    PyGILState_STATE gstate;
+
+    gstate = PyGILState_Ensure();
+
+    while (state->next < PyList_GET_SIZE(state->work)) {
+        PyObject *item, *toc_entry, *data;
+        ZipImporter *importer;
+        const unsigned char *buf;
+        unsigned short compress;
+        Py_ssize_t data_size;
+        int isbytecode, keep;
+
+        item = PyList_GET_ITEM(state->work, state->next++);
+        importer = (ZipImporter *)PyTuple_GET_ITEM(item, 0);
+        toc_entry = PyTuple_GET_ITEM(item, 1);
+        isbytecode = (PyTuple_GET_ITEM(item, 2) == Py_True);
+
+        /* Skip duplicates and anything that has already been read. */
+        if (PyDict_GetItem(zip_prefetch_cache, toc_entry) != NULL)
+            continue;
+
+        buf = find_mapped_data(importer, toc_entry, &compress, &data_size);
+        if (buf == NULL || compress == 0) {
+            /* Any error will be raised again by the import. */
+            PyErr_Clear();
+            continue;
+        }
+
+        data = inflate_mapped_data(buf, data_size);
+        if (data == NULL) {
+            PyErr_Clear();
+            continue;
+        }
+
+        /* Only keep bytecode that unmarshal_code() would accept (and
+           nothing that has been read while the GIL was released), as long
+           as the results fit in ZIP_PREFETCH_CACHE_SIZE. */
+        keep = (PyDict_GetItem(zip_prefetch_cache, toc_entry) == NULL &&
+                PyBytes_GET_SIZE(data) <=
+                        ZIP_PREFETCH_CACHE_SIZE - zip_prefetch_size);
+        if (keep && isbytecode) {
+            keep = (PyBytes_GET_SIZE(data) >= 16 &&
+                    get_uint32((unsigned char *)PyBytes_AS_STRING(data)) ==
+                            (unsigned int)PyImport_GetMagicNumber());
+        }
+        if (keep) {
+            if (PyDict_SetItem(zip_prefetch_cache, toc_entry, data) == 0)
+                zip_prefetch_size += PyBytes_GET_SIZE(data);
+            else
+                PyErr_Clear();
+        }
+        Py_DECREF(data);
+    }
+
+    zip_prefetch_threads--;
+    if (--state->nthreads == 0) {
+        if (zip_prefetch_threads == 0) {
+            /* Discard the markers of what was read during prefetching. */
+            PyObject *key, *value, *done = PyList_New(0);
+            Py_ssize_t pos = 0;
+
+            if (done != NULL) {
+                while (PyDict_Next(zip_prefetch_cache, &pos, &key, &value)) {
+                    if (value == Py_None && PyList_Append(done, key) != 0)
+                        break;
+                }
+                for (pos = 0; pos < PyList_GET_SIZE(done); pos++) {
+                    PyDict_DelItem(zip_prefetch_cache,
+                                   PyList_GET_ITEM(done, pos));
+                }
+                Py_DECREF(done);
+            }
+            PyErr_Clear();
+        }
+        if (Py_VerboseFlag) {
+            PySys_FormatStderr("# zipimport: finished prefetching "
+                               "%zd files\n", PyList_GET_SIZE(state->work));
+        }
+        Py_DECREF(state->work);
+        PyMem_RawFree(state);
+    }
+
+    PyGILState_Release(gstate);
+}
+
+/* Drop the prefetch() results (and markers) of the files of archive.
+   Return 0 on success, or -1 with an exception set. */
+static int
+prefetch_forget(PyObject *archive)
+{
+    PyObject *toc_entry, *data, *path, *stale;
+    Py_ssize_t pos = 0, len, i;
+    int err = 0;
+
+    if (PyDict_GET_SIZE(zip_prefetch_cache) == 0)
+        return 0;
+    if (PyUnicode_READY(archive) == -1)
+        return -1;
+    len = PyUnicode_GET_LENGTH(archive);
+
+    stale = PyList_New(0);
+    if (stale == NULL)
+        return -1;
+    while (PyDict_Next(zip_prefetch_cache, &pos, &toc_entry, &data)) {
+        /* The path of a toc entry is archive + SEP + name. */
+        path = PyTuple_GET_ITEM(toc_entry, 0);
+        if (PyUnicode_GET_LENGTH(path) > len &&
+            PyUnicode_READ_CHAR(path, len) == SEP &&
+            PyUnicode_Tailmatch(path, archive, 0, len, -1) == 1) {
+            if (PyList_Append(stale, toc_entry) != 0) {
+                Py_DECREF(stale);
+                return -1;
+            }
+        }
+    }
+    for (i = 0; i < PyList_GET_SIZE(stale) && err == 0; i++) {
+        toc_entry = PyList_GET_ITEM(stale, i);
+        data = PyDict_GetItem(zip_prefetch_cache, toc_entry);
+        if (data != NULL && data != Py_None)
+            zip_prefetch_size -= PyBytes_GET_SIZE(data);
+        err = PyDict_DelItem(zip_prefetch_cache, toc_entry);
+    }
+    Py_DECREF(stale);
+    return err;
+}
+
+/* Add the work for one line of an import manifest to a work list. */
+static int
+prefetch_add(PyObject *work, PyObject *importers, PyObject *path,
+             PyObject *bytecode_suffix)
+{
+    PyObject *dirpath, *importer, *name, *toc_entry, *item;
+    Py_ssize_t len, sep;
+    int isbytecode, err;
+
+    if (PyUnicode_READY(path) == -1)
+        return -1;
+    len = PyUnicode_GET_LENGTH(path);
+    isbytecode = PyUnicode_Tailmatch(path, bytecode_suffix, 0, len, 1);
+    if (isbytecode < 0)
+        return -1;
+
+    /* Use an importer for the directory containing the file. */
+    sep = PyUnicode_FindChar(path, SEP, 0, len, -1);
+    if (sep == -2)
+        return -1;
+    if (sep == -1)
+        return 0;
+    dirpath = PyUnicode_Substring(path, 0, sep);
+    if (dirpath == NULL)
+        return -1;
+    importer = PyDict_GetItem(importers, dirpath);
+    if (importer == NULL) {
+        importer = PyObject_CallFunctionObjArgs((PyObject *)&ZipImporter_Type,
+                                                dirpath, NULL);
+        if (importer == NULL) {
+            Py_DECREF(dirpath);
+            /* Ignore anything that isn't in an archive. */
+            if (!PyErr_ExceptionMatches(ZipImportError))
+                return -1;
+            PyErr_Clear();
+            return 0;
+        }
+        err = PyDict_SetItem(importers, dirpath, importer);
+        Py_DECREF(importer);
+        if (err != 0) {
+            Py_DECREF(dirpath);
+            return -1;
+        }
+    }
+    Py_DECREF(dirpath);
+
+    /* Only memory mapped archives are prefetched. */
+    if (((ZipImporter *)importer)->index == NULL)
+        return 0;
+
+    name = PyUnicode_Substring(path, sep + 1, len);
+    if (name == NULL)
+        return -1;
+    item = PyUnicode_Concat(((ZipImporter *)importer)->prefix, name);
+    Py_DECREF(name);
+    if (item == NULL)
+        return -1;
+    toc_entry = get_toc_entry((ZipImporter *)importer, item);
+    Py_DECREF(item);
+    if (toc_entry == NULL)
+        return PyErr_Occurred() ? -1 : 0;
+
+    item = Py_BuildValue("OOO", importer, toc_entry,
+                         isbytecode ? Py_True : Py_False);
+    if (item == NULL)
+        return -1;
+    err = PyList_Append(work, item);
+    Py_DECREF(item);
+    return err;
+}
+
+PyDoc_STRVAR(prefetch_doc,
+"_prefetch(manifest, nthreads=4)\n\
+\n\
+Decompress the files named in an import manifest in background threads.\n\
+\n\
+The manifest is a text file containing the full path of a file in a Zip\n\
+archive (as used in __file__) on each line, in the order it is expected\n\
+to be imported.  Blank lines and lines starting with '#' are ignored.\n\
+Only files in archives with a central directory index are prefetched and\n\
+the data of each is used by the first import that reads it.");
+
+static PyObject *
+prefetch(PyObject *module, PyObject *args)
+{
+    PyObject *manifest, *decompress, *bytecode_suffix, *importers, *work;
+    PrefetchState *state;
+    FILE *fp;
+    char line[MAXPATHLEN + 2];
+    Py_ssize_t nwork;
+    int nthreads = 4, i;
+
+    if (!PyArg_ParseTuple(args, "O&|i:_prefetch", PyUnicode_FSDecoder,
+                          &manifest, &nthreads))
+        return NULL;
+    if (nthreads < 1) {
+        Py_DECREF(manifest);
+        PyErr_SetString(PyExc_ValueError, "nthreads must be at least 1");
+        return NULL;
+    }
+
+    /* Make sure zlib is imported before any thread needs it. */
+    decompress = get_decompress_func();
+    if (decompress == NULL) {
+        Py_DECREF(manifest);
+        Py_RETURN_NONE;
+    }
+    Py_DECREF(decompress);
+
+    fp = _Py_fopen_obj(manifest, "rb");
+    Py_DECREF(manifest);
+    if (fp == NULL)
+        return NULL;
+
+    bytecode_suffix = PyUnicode_FromString(".pyc");
+    importers = PyDict_New();
+    work = PyList_New(0);
+    if (bytecode_suffix == NULL || importers == NULL || work == NULL)
+        goto error;
+
+    while (fgets(line, sizeof (line), fp) != NULL) {
+        PyObject *path;
+        size_t n = strlen(line);
+        int err;
+
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r'))
+            line[--n] = '\0';
+        if (n == 0 || line[0] == '#')
+            continue;
+
+        path = PyUnicode_DecodeFSDefaultAndSize(line, n);
+        if (path == NULL)
+            goto error;
+#ifdef ALTSEP
+        {
+            PyObject *tmp = _PyObject_CallMethodId(path, &PyId_replace, "CC",
+                                                   ALTSEP, SEP);
+            Py_SETREF(path, tmp);
+            if (path == NULL)
+                goto error;
+        }
+#endif
+        err = prefetch_add(work, importers, path, bytecode_suffix);
+        Py_DECREF(path);
+        if (err != 0)
+            goto error;
+    }
+    if (ferror(fp)) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        goto error;
+    }
+    fclose(fp);
+    fp = NULL;
+    Py_CLEAR(bytecode_suffix);
+    Py_CLEAR(importers);
+
+    nwork = PyList_GET_SIZE(work);
+    if (nwork == 0) {
+        Py_DECREF(work);
+        Py_RETURN_NONE;
+    }
+    if (nthreads > nwork)
+        nthreads = (int)nwork;
+
+    state = PyMem_RawMalloc(sizeof (PrefetchState));
+    if (state == NULL) {
+        Py_DECREF(work);
+        return PyErr_NoMemory();
+    }
+    state->work = work;
+    state->next = 0;
+    state->nthreads = 0;
+
+    /* The threads don't start work until we release the GIL. */
+    PyEval_InitThreads();
+    for (i = 0; i < nthreads; i++) {
+        if (PyThread_start_new_thread(prefetch_thread, state) ==
+                PYTHREAD_INVALID_THREAD_ID)
+            break;
+        state->nthreads++;
+        zip_prefetch_threads++;
+    }
+    if (state->nthreads == 0) {
+        Py_DECREF(work);
+        PyMem_RawFree(state);
+        PyErr_SetString(PyExc_RuntimeError, "can't start new thread");
+        return NULL;
+    }
+    if (Py_VerboseFlag) {
+        PySys_FormatStderr("# zipimport: prefetching %zd files with %d "
+                           "threads\n", nwork, state->nthreads);
+    }
+    Py_RETURN_NONE;
+
+error:
+    if (fp != NULL)
+        fclose(fp);
+    Py_XDECREF(bytecode_suffix);
+    Py_XDECREF(importers);
+    Py_XDECREF(work);
+    return NULL;
+}
+
 /* Lenient date/time comparison function. The precision of the mtime
    in the archive is lower than the mtime stored in a .pyc: we
    must allow a difference of at most one second. */
@@ -1330,11 +2396,10 @@ eq_mtime(time_t t1, time_t t2)
    to .py if available and we don't want to mask other errors).
    Returns a new reference. */
 static PyObject *
-unmarshal_code(PyObject *pathname, PyObject *data, time_t mtime)
+unmarshal_code(PyObject *pathname, const unsigned char *buf, Py_ssize_t size,
+               time_t mtime)
 {
     PyObject *code;
-    unsigned char *buf = (unsigned char *)PyBytes_AsString(data);
-    Py_ssize_t size = PyBytes_Size(data);
 
     if (size < 16) {
         PyErr_SetString(ZipImportError,
@@ -1482,8 +2547,10 @@ get_mtime_of_source(ZipImporter *self, PyObject *path)
     if (stripped == NULL)
         return (time_t)-1;
 
-    toc_entry = PyDict_GetItem(self->files, stripped);
+    toc_entry = get_toc_entry(self, stripped);
     Py_DECREF(stripped);
+    if (toc_entry == NULL && PyErr_Occurred())
+        return (time_t)-1;
     if (toc_entry != NULL && PyTuple_Check(toc_entry) &&
         PyTuple_Size(toc_entry) == 8) {
         /* fetch the time stamp of the .py file for comparison
@@ -1505,19 +2572,47 @@ get_code_from_data(ZipImporter *self, int ispackage, int isbytecode,
 {
     PyObject *data, *modpath, *code;
 
-    data = get_data(self->archive, toc_entry);
+    modpath = PyTuple_GetItem(toc_entry, 0);
+
+    if (isbytecode && self->index != NULL) {
+        const unsigned char *buf;
+        unsigned short compress;
+        Py_ssize_t data_size;
+
+        /* Unmarshal stored bytecode in place. */
+        buf = find_mapped_data(self, toc_entry, &compress, &data_size);
+        if (buf == NULL)
+            return NULL;
+        if (compress == 0)
+            return unmarshal_code(modpath, buf, data_size, mtime);
+    }
+
+    data = get_data(self, toc_entry);
     if (data == NULL)
         return NULL;
 
-    modpath = PyTuple_GetItem(toc_entry, 0);
     if (isbytecode)
-        code = unmarshal_code(modpath, data, mtime);
+        code = unmarshal_code(modpath,
+                              (unsigned char *)PyBytes_AS_STRING(data),
+                              PyBytes_GET_SIZE(data), mtime);
     else
         code = compile_source(modpath, data);
     Py_DECREF(data);
     return code;
 }
 
+/* Return non-zero if the archive is sealed. */
+static int
+is_sealed(ZipImporter *self)
+{
+    ZipIndex *zi;
+
+    if (self->index == NULL)
+        return 0;
+    zi = (ZipIndex *)PyCapsule_GetPointer(self->index, NULL);
+    return zi != NULL && (zi->flags & ZIP_INDEX_SEALED);
+}
+
 /* Get the code object associated with the module specified by
    'fullname'. */
 static PyObject *
@@ -1553,13 +2648,15 @@ get_module_code(ZipImporter *self, PyObject *fullname,
         if (Py_VerboseFlag > 1)
             PySys_FormatStderr("# trying %U%c%U\n",
                                self->archive, (int)SEP, fullpath);
-        toc_entry = PyDict_GetItem(self->files, fullpath);
+        toc_entry = get_toc_entry(self, fullpath);
+        if (toc_entry == NULL && PyErr_Occurred())
+            goto exit;
         if (toc_entry != NULL) {
             time_t mtime = 0;
             int ispackage = zso->type & IS_PACKAGE;
             int isbytecode = zso->type & IS_BYTECODE;
 
-            if (isbytecode) {
+            if (isbytecode && !is_sealed(self)) {
                 mtime = get_mtime_of_source(self, fullpath);
                 if (mtime == (time_t)-1 && PyErr_Occurred()) {
                     goto exit;
@@ -1604,18 +2701,170 @@ This module exports three objects:\n\
 - ZipImportError: exception raised by zipimporter objects. It's a\n\
   subclass of ImportError, so it can be caught as ImportError, too.\n\
 - _zip_directory_cache: a dict, mapping archive paths to zip directory\n\
-  info dicts, as used in zipimporter._files.\n\
+  info dicts, as used in zipimporter._files.  The directory of an archive\n\
+  with a central directory index is read lazily, and completed when it\n\
+  is read from this mapping or from zipimporter._files.\n\
 \n\
 It is usually not needed to use the zipimport module explicitly; it is\n\
 used by the builtin import mechanism for sys.path items that are paths\n\
 to Zip archives.");
 
+/* _zip_directory_cache is a dict subclass: the C code reads it with
+   PyDict_GetItem(), and so keeps the directories of archives with an index
+   lazy, while reading an entry or the values from Python, eg. to enumerate
+   the files of an archive, completes them first. */
+
+/* Complete the directory of archive if it has an index. */
+static int
+complete_cached_directory(PyObject *archive)
+{
+    PyObject *index, *files;
+
+    index = PyDict_GetItem(zip_index_cache, archive);
+    if (index == NULL)
+        return 0;
+    files = PyDict_GetItem(zip_directory_cache, archive);
+    if (files == NULL || !PyDict_Check(files))
+        return 0;
+    return fill_directory(archive, files, index);
+}
+
+/* Complete the directories of all the archives with an index. */
+static int
+complete_cached_directories(void)
+{
+    PyObject *archives;
+    Py_ssize_t i;
+
+    /* Reading a directory may import a codec, and with it open further
+       archives, so iterate over a copy of the index cache. */
+    archives = PyDict_Keys(zip_index_cache);
+    if (archives == NULL)
+        return -1;
+    for (i = 0; i < PyList_GET_SIZE(archives); i++) {
+        if (complete_cached_directory(PyList_GET_ITEM(archives, i)) < 0) {
+            Py_DECREF(archives);
+            return -1;
+        }
+    }
+    Py_DECREF(archives);
+    return 0;
+}
+
+/* Call the dict method name on cache, once the directories it holds are
+   complete. */
+static PyObject *
+directory_cache_complete_and_call(PyObject *cache, const char *name)
+{
+    PyObject *method, *result;
+
+    if (complete_cached_directories() < 0)
+        return NULL;
+    method = PyObject_GetAttrString((PyObject *)&PyDict_Type, name);
+    if (method == NULL)
+        return NULL;
+    result = PyObject_CallFunctionObjArgs(method, cache, NULL);
+    Py_DECREF(method);
+    return result;
+}
+
+static PyObject *
+directory_cache_subscript(PyObject *cache, PyObject *archive)
+{
+    if (complete_cached_directory(archive) < 0)
+        return NULL;
+    return PyDict_Type.tp_as_mapping->mp_subscript(cache, archive);
+}
+
+static PyObject *
+directory_cache_get(PyObject *cache, PyObject *args)
+{
+    PyObject *archive, *failobj = Py_None, *files;
+
+    if (!PyArg_UnpackTuple(args, "get", 1, 2, &archive, &failobj))
+        return NULL;
+    if (complete_cached_directory(archive) < 0)
+        return NULL;
+    files = PyDict_GetItemWithError(cache, archive);
+    if (files == NULL) {
+        if (PyErr_Occurred())
+            return NULL;
+        files = failobj;
+    }
+    Py_INCREF(files);
+    return files;
+}
+
+static PyObject *
+directory_cache_values(PyObject *cache, PyObject *unused)
+{
+    return directory_cache_complete_and_call(cache, "values");
+}
+
+static PyObject *
+directory_cache_items(PyObject *cache, PyObject *unused)
+{
+    return directory_cache_complete_and_call(cache, "items");
+}
+
+static PyMappingMethods directory_cache_as_mapping = {
+    0,                                          /* mp_length */
+    directory_cache_subscript,                  /* mp_subscript */
+    0,                                          /* mp_ass_subscript */
+};
+
+static PyMethodDef directory_cache_methods[] = {
+    {"get",     directory_cache_get,    METH_VARARGS, NULL},
+    {"values",  directory_cache_values, METH_NOARGS,  NULL},
+    {"items",   directory_cache_items,  METH_NOARGS,  NULL},
+    {NULL,      NULL}   /* sentinel */
+};
+
+static PyTypeObject DirectoryCache_Type = {
+    PyVarObject_HEAD_INIT(DEFERRED_ADDRESS(&PyType_Type), 0)
+    "zipimport._DirectoryCache",
+    0,                                          /* tp_basicsize */
+    0,                                          /* tp_itemsize */
+    0,                                          /* tp_dealloc */
+    0,                                          /* tp_print */
+    0,                                          /* tp_getattr */
+    0,                                          /* tp_setattr */
+    0,                                          /* tp_reserved */
+    0,                                          /* tp_repr */
+    0,                                          /* tp_as_number */
+    0,                                          /* tp_as_sequence */
+    &directory_cache_as_mapping,                /* tp_as_mapping */
+    0,                                          /* tp_hash */
+    0,                                          /* tp_call */
+    0,                                          /* tp_str */
+    0,                                          /* tp_getattro */
+    0,                                          /* tp_setattro */
+    0,                                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                         /* tp_flags */
+    0,                                          /* tp_doc */
+    0,                                          /* tp_traverse */
+    0,                                          /* tp_clear */
+    0,                                          /* tp_richcompare */
+    0,                                          /* tp_weaklistoffset */
+    0,                                          /* tp_iter */
+    0,                                          /* tp_iternext */
+    directory_cache_methods,                    /* tp_methods */
+    0,                                          /* tp_members */
+    0,                                          /* tp_getset */
+    DEFERRED_ADDRESS(&PyDict_Type),             /* tp_base */
+};
+
+static PyMethodDef zipimport_functions[] = {
+    {"_prefetch", prefetch, METH_VARARGS, prefetch_doc},
+    {NULL, NULL}    /* sentinel */
+};
+
 static struct PyModuleDef zipimportmodule = {
     PyModuleDef_HEAD_INIT,
     "zipimport",
     zipimport_doc,
     -1,
-    NULL,
+    zipimport_functions,
     NULL,
     NULL,
     NULL,
@@ -1629,6 +2878,9 @@ PyInit_zipimport(void)
 
     if (PyType_Ready(&ZipImporter_Type) < 0)
         return NULL;
+    DirectoryCache_Type.tp_base = &PyDict_Type;
+    if (PyType_Ready(&DirectoryCache_Type) < 0)
+        return NULL;
 
     /* Correct directory separator */
     zip_searchorder[0].suffix[0] = SEP;
@@ -1653,12 +2905,21 @@ PyInit_zipimport(void)
                            (PyObject *)&ZipImporter_Type) < 0)
         return NULL;
 
-    zip_directory_cache = PyDict_New();
+    zip_directory_cache = PyObject_CallObject(
+        (PyObject *)&DirectoryCache_Type, NULL);
     if (zip_directory_cache == NULL)
         return NULL;
     Py_INCREF(zip_directory_cache);
     if (PyModule_AddObject(mod, "_zip_directory_cache",
                            zip_directory_cache) < 0)
         return NULL;
+
+    zip_index_cache = PyDict_New();
+    if (zip_index_cache == NULL)
+        return NULL;
+
+    zip_prefetch_cache = PyDict_New();
+    if (zip_prefetch_cache == NULL)
+        return NULL;
     return mod;
 }
@@ -187,6 +187,13 @@ arrange_output_buffer(z_stream *zst, PyObject **buffer, Py_ssize_t length)
     return ret;
 }
 
+static void
+arrange_output_view(z_stream *zst, Py_ssize_t *remains)
+{
+    zst->avail_out = (uInt)Py_MIN((size_t)*remains, UINT_MAX);
+    *remains -= zst->avail_out;
+}
+
 /*[clinic input]
 zlib.compress
 
@@ -418,6 +425,123 @@ zlib_decompress_impl(PyObject *module, Py_buffer *data, int wbits,
     return NULL;
 }
 
+PyDoc_STRVAR(zlib_decompress_into__doc__,
+"decompress_into($module, data, buffer, /, wbits=MAX_WBITS)\n"
+"--\n"
+"\n"
+"Decompress data directly into a writable buffer.\n"
+"\n"
+"  data\n"
+"    Compressed data.\n"
+"  buffer\n"
+"    A writable bytes-like object receiving the uncompressed data.\n"
+"  wbits\n"
+"    The window buffer size and container format.\n"
+"\n"
+"Returns a tuple (written, consumed): the number of bytes written to the\n"
+"buffer and the number of bytes of data which formed the compressed\n"
+"stream; data[consumed:] is the input past the end of the stream.\n"
+"Raises an error if the buffer is too small for the uncompressed data.");
+
+static PyObject *
+zlib_decompress_into(PyObject *module, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"", "", "wbits", NULL};
+    Py_buffer data, out;
+    Py_ssize_t ibuflen, obuflen;
+    int wbits = MAX_WBITS, err, flush;
+    z_stream zst;
+    PyObject *RetVal = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*w*|i:decompress_into",
+                                     kwlist, &data, &out, &wbits))
+        return NULL;
+
+    ibuflen = data.len;
+    obuflen = out.len;
+
+    zst.opaque = NULL;
+    zst.zalloc = PyZlib_Malloc;
+    zst.zfree = PyZlib_Free;
+    zst.avail_in = 0;
+    zst.next_in = data.buf;
+    err = inflateInit2(&zst, wbits);
+
+    switch (err) {
+    case Z_OK:
+        break;
+    case Z_MEM_ERROR:
+        PyErr_SetString(PyExc_MemoryError,
+                        "Out of memory while decompressing data");
+        goto done;
+    default:
+        inflateEnd(&zst);
+        zlib_error(zst, err, "while preparing to decompress data");
+        goto done;
+    }
+
+    zst.next_out = out.buf;
+    zst.avail_out = 0;
+    do {
+        if (zst.avail_in == 0)
+            arrange_input_buffer(&zst, &ibuflen);
+        if (zst.avail_out == 0)
+            arrange_output_view(&zst, &obuflen);
+        flush = ibuflen == 0 ? Z_FINISH : Z_NO_FLUSH;
+
+        Py_BEGIN_ALLOW_THREADS
+        err = inflate(&zst, flush);
+        Py_END_ALLOW_THREADS
+
+        switch (err) {
+        case Z_OK:            /* fall through */
+        case Z_BUF_ERROR:     /* fall through */
+        case Z_STREAM_END:
+            break;
+        case Z_MEM_ERROR:
+            inflateEnd(&zst);
+            PyErr_SetString(PyExc_MemoryError,
+                            "Out of memory while decompressing data");
+            goto done;
+        default:
+            inflateEnd(&zst);
+            zlib_error(zst, err, "while decompressing data");
+            goto done;
+        }
+
+        if (err != Z_STREAM_END && zst.avail_out == 0 && obuflen == 0 &&
+            (zst.avail_in != 0 || ibuflen != 0)) {
+            inflateEnd(&zst);
+            PyErr_SetString(ZlibError,
+                            "Error -5 while decompressing data: "
+                            "output buffer is too small");
+            goto done;
+        }
+    } while (err != Z_STREAM_END &&
+             (zst.avail_in != 0 || ibuflen != 0 ||
+              (zst.avail_out == 0 && obuflen != 0)));
+
+    if (err != Z_STREAM_END) {
+        inflateEnd(&zst);
+        zlib_error(zst, Z_BUF_ERROR, "while decompressing data");
+        goto done;
+    }
+
+    err = inflateEnd(&zst);
+    if (err != Z_OK) {
+        zlib_error(zst, err, "while finishing decompression");
+        goto done;
+    }
+
+    RetVal = Py_BuildValue("nn", (Py_ssize_t)(zst.next_out - (Byte *)out.buf),
+                           (Py_ssize_t)(zst.next_in - (Byte *)data.buf));
+
+ done:
+    PyBuffer_Release(&data);
+    PyBuffer_Release(&out);
+    return RetVal;
+}
+
 /*[clinic input]
 zlib.compressobj
 
@@ -845,6 +969,105 @@ zlib_Decompress_decompress_impl(compobject *self, Py_buffer *data,
     return RetVal;
 }
 
+PyDoc_STRVAR(zlib_Decompress_decompress_into__doc__,
+"decompress_into($self, data, buffer, /)\n"
+"--\n"
+"\n"
+"Decompress data directly into a writable buffer.\n"
+"\n"
+"  data\n"
+"    The binary data to decompress.\n"
+"  buffer\n"
+"    A writable bytes-like object receiving the decompressed data.\n"
+"\n"
+"Returns a tuple (written, consumed): the number of bytes written to the\n"
+"buffer and the number of bytes of data which were consumed.  Decompression\n"
+"stops when the buffer is full; the input left over is not copied to the\n"
+"unconsumed_tail attribute, pass data[consumed:] to the next call instead.");
+
+static PyObject *
+zlib_Decompress_decompress_into(compobject *self, PyObject *args)
+{
+    Py_buffer data, out;
+    int err = Z_OK;
+    Py_ssize_t ibuflen, obuflen, consumed;
+    PyObject *RetVal = NULL;
+
+    if (!PyArg_ParseTuple(args, "y*w*:decompress_into", &data, &out))
+        return NULL;
+
+    ENTER_ZLIB(self);
+
+    self->zst.next_in = data.buf;
+    ibuflen = data.len;
+    self->zst.next_out = out.buf;
+    self->zst.avail_out = 0;
+    obuflen = out.len;
+
+    do {
+        arrange_input_buffer(&self->zst, &ibuflen);
+
+        do {
+            if (self->zst.avail_out == 0) {
+                if (obuflen == 0)
+                    goto save;
+                arrange_output_view(&self->zst, &obuflen);
+            }
+
+            Py_BEGIN_ALLOW_THREADS
+            err = inflate(&self->zst, Z_SYNC_FLUSH);
+            Py_END_ALLOW_THREADS
+
+            switch (err) {
+            case Z_OK:            /* fall through */
+            case Z_BUF_ERROR:     /* fall through */
+            case Z_STREAM_END:
+                break;
+            default:
+                if (err == Z_NEED_DICT && self->zdict != NULL) {
+                    if (set_inflate_zdict(self) < 0)
+                        goto abort;
+                    else
+                        break;
+                }
+                goto save;
+            }
+
+        } while (self->zst.avail_out == 0 || err == Z_NEED_DICT);
+
+    } while (err != Z_STREAM_END && ibuflen != 0);
+
+ save:
+    consumed = (Byte *)self->zst.next_in - (Byte *)data.buf;
+    /* The caller keeps the unconsumed input, a stale tail left by
+       decompress() would be fed again to flush(). */
+    if (PyBytes_GET_SIZE(self->unconsumed_tail)) {
+        PyObject *empty = PyBytes_FromStringAndSize("", 0);
+        if (empty == NULL)
+            goto abort;
+        Py_SETREF(self->unconsumed_tail, empty);
+    }
+
+    if (err == Z_STREAM_END) {
+        if (save_unconsumed_input(self, &data, err) < 0)
+            goto abort;
+        self->eof = 1;
+    } else if (err != Z_OK && err != Z_BUF_ERROR) {
+        zlib_error(self->zst, err, "while decompressing data");
+        goto abort;
+    }
+
+    RetVal = Py_BuildValue("nn",
+                           (Py_ssize_t)(self->zst.next_out - (Byte *)out.buf),
+                           consumed);
+
+ abort:
+    LEAVE_ZLIB(self);
+    PyBuffer_Release(&data);
+    PyBuffer_Release(&out);
+    return RetVal;
+}
+
 /*[clinic input]
 zlib.Compress.flush
 
@@ -1145,6 +1368,8 @@ static PyMethodDef comp_methods[] =
 static PyMethodDef Decomp_methods[] =
 {
     ZLIB_DECOMPRESS_DECOMPRESS_METHODDEF
+    {"decompress_into", (PyCFunction)zlib_Decompress_decompress_into,
+     METH_VARARGS, zlib_Decompress_decompress_into__doc__},
     ZLIB_DECOMPRESS_FLUSH_METHODDEF
     ZLIB_DECOMPRESS_COPY_METHODDEF
     {NULL, NULL}
@@ -1239,6 +1464,608 @@ zlib_crc32_impl(PyObject *module, Py_buffer *data, unsigned int value)
 }
 
 
+#ifdef AT_LEAST_ZLIB_1_2_2_1
+
+/* Parallel compressor, after pigz.
+
+   The input is cut into blocks which are deflated independently on
+   several threads.  Each block is primed with the window preceding it
+   as a preset dictionary, so the compression ratio stays close to the
+   one of a single stream.  Every block but the last ends with a sync
+   flush, which aligns it on a byte boundary; the raw deflate blocks are
+   then concatenated and wrapped in a zlib or gzip header and trailer,
+   with the check value combined from the checksums of the blocks. */
+
+#define PARALLEL_MAX_THREADS 64
+#define PARALLEL_MIN_BLOCKSIZE (1 << 15)    /* at least one full window */
+#define PARALLEL_MAX_BLOCKSIZE (1 << 30)
+#define PARALLEL_DEF_BLOCKSIZE (128 * 1024)
+
+typedef enum {
+    PARALLEL_RAW,
+    PARALLEL_ZLIB,
+    PARALLEL_GZIP
+} parallel_format;
+
+typedef struct
+{
+    PyObject_HEAD
+    int level;
+    int window_bits;            /* 9..15 */
+    parallel_format format;
+    Py_ssize_t blocksize;
+    int threads;
+    char *pending;              /* input which is not compressed yet */
+    Py_ssize_t pending_len;
+    Py_ssize_t pending_size;
+    char window[1 << MAX_WBITS];    /* end of the input already compressed */
+    Py_ssize_t window_len;
+    uLong check;                /* CRC-32 or Adler-32 of the input so far */
+    unsigned long long total_in;
+    char header_written;
+    char finished;
+    PyThread_type_lock lock;
+} parcompobject;
+
+static PyTypeObject ParallelComptype;
+
+/* One block of a batch */
+typedef struct {
+    const Bytef *in;
+    Py_ssize_t in_len;
+    const Bytef *dict;
+    Py_ssize_t dict_len;
+    int final;
+    Bytef *out;                 /* allocated with PyMem_RawMalloc() */
+    Py_ssize_t out_len;
+    uLong check;
+    int err;
+    const char *msg;
+} parallel_block;
+
+/* Blocks of a batch handled by one thread: first, first + step, ... */
+typedef struct {
+    parcompobject *self;
+    parallel_block *blocks;
+    Py_ssize_t nblocks;
+    Py_ssize_t first;
+    int step;
+    PyThread_type_lock done;
+} parallel_job;
+
+static void
+parallel_deflate_block(parcompobject *self, parallel_block *block)
+{
+    z_stream zst;
+    uLong bound;
+    int err;
+
+    block->out = NULL;
+    block->out_len = 0;
+    block->msg = NULL;
+    if (self->format == PARALLEL_GZIP)
+        block->check = crc32(0, block->in, (uInt)block->in_len);
+    else
+        block->check = adler32(1, block->in, (uInt)block->in_len);
+
+    zst.opaque = NULL;
+    zst.zalloc = PyZlib_Malloc;
+    zst.zfree = PyZlib_Free;
+    err = deflateInit2(&zst, self->level, DEFLATED, -self->window_bits,
+                       DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+    if (err != Z_OK) {
+        block->err = err;
+        block->msg = "while compressing data";
+        return;
+    }
+    if (block->dict_len) {
+        err = deflateSetDictionary(&zst, block->dict, (uInt)block->dict_len);
+        if (err != Z_OK) {
+            block->msg = "while setting zdict";
+            goto done;
+        }
+    }
+
+    /* room for the compressed data and the sync flush marker */
+    bound = deflateBound(&zst, (uLong)block->in_len) + 16;
+    block->out = PyMem_RawMalloc(bound);
+    if (block->out == NULL) {
+        err = Z_MEM_ERROR;
+        block->msg = "while compressing data";
+        goto done;
+    }
+    zst.next_in = (Bytef *)block->in;
+    zst.avail_in = (uInt)block->in_len;
+    zst.next_out = block->out;
+    zst.avail_out = (uInt)bound;
+    err = deflate(&zst, block->final ? Z_FINISH : Z_SYNC_FLUSH);
+    if (block->final ? err != Z_STREAM_END : (err != Z_OK || zst.avail_in)) {
+        if (err == Z_OK || err == Z_STREAM_END)
+            err = Z_BUF_ERROR;
+        block->msg = "while compressing data";
+        goto done;
+    }
+    block->out_len = bound - zst.avail_out;
+    err = Z_OK;
+
+done:
+    block->err = err;
+    deflateEnd(&zst);
+}
+
+static void
+parallel_run_job(parallel_job *job)
+{
+    Py_ssize_t i;
+
+    for (i = job->first; i < job->nblocks; i += job->step)
+        parallel_deflate_block(job->self, &job->blocks[i]);
+}
+
+static void
+parallel_thread(void *arg)
+{
+    parallel_job *job = (parallel_job *)arg;
+
+    parallel_run_job(job);
+    PyThread_release_lock(job->done);
+}
+
+/* Deflate the blocks, using up to self->threads threads. The calling
+   thread is one of them and runs the jobs of threads which cannot be
+   started. Called without the GIL. */
+static void
+parallel_deflate_blocks(parcompobject *self, parallel_block *blocks,
+                        Py_ssize_t nblocks)
+{
+    parallel_job jobs[PARALLEL_MAX_THREADS];
+    int i, started, nthreads;
+
+    nthreads = (int)Py_MIN(nblocks, self->threads);
+    for (i = 0; i < nthreads; i++) {
+        jobs[i].self = self;
+        jobs[i].blocks = blocks;
+        jobs[i].nblocks = nblocks;
+        jobs[i].first = i;
+        jobs[i].step = nthreads;
+        jobs[i].done = NULL;
+    }
+    for (started = 1; started < nthreads; started++) {
+        jobs[started].done = PyThread_allocate_lock();
+        if (jobs[started].done == NULL)
+            break;
+        PyThread_acquire_lock(jobs[started].done, WAIT_LOCK);
+        if (PyThread_start_new_thread(parallel_thread, &jobs[started])
+            == PYTHREAD_INVALID_THREAD_ID) {
+            PyThread_release_lock(jobs[started].done);
+            PyThread_free_lock(jobs[started].done);
+            break;
+        }
+    }
+    for (i = started; i < nthreads; i++)
+        parallel_run_job(&jobs[i]);
+    if (nthreads > 0)
+        parallel_run_job(&jobs[0]);
+    for (i = 1; i < started; i++) {
+        PyThread_acquire_lock(jobs[i].done, WAIT_LOCK);
+        PyThread_release_lock(jobs[i].done);
+        PyThread_free_lock(jobs[i].done);
+    }
+}
+
+static Py_ssize_t
+parallel_header(parcompobject *self, unsigned char *out)
+{
+    unsigned int header, level_flags;
+    int level = self->level;
+
+    switch (self->format) {
+    case PARALLEL_ZLIB:
+        /* same header as deflate() */
+        if (level == Z_DEFAULT_COMPRESSION)
+            level = 6;
+        if (level < 2)
+            level_flags = 0;
+        else if (level < 6)
+            level_flags = 1;
+        else if (level == 6)
+            level_flags = 2;
+        else
+            level_flags = 3;
+        header = (DEFLATED + ((self->window_bits - 8) << 4)) << 8;
+        header |= level_flags << 6;
+        header += 31 - (header % 31);
+        out[0] = (unsigned char)(header >> 8);
+        out[1] = (unsigned char)header;
+        return 2;
+    case PARALLEL_GZIP:
+        out[0] = 0x1f;
+        out[1] = 0x8b;
+        out[2] = DEFLATED;
+        out[3] = 0;                                 /* flags */
+        out[4] = out[5] = out[6] = out[7] = 0;      /* mtime */
+        out[8] = (level == 9) ? 2 : (level == 1) ? 4 : 0;
+        out[9] = 255;                               /* unknown OS */
+        return 10;
+    default:
+        return 0;
+    }
+}
+
+static Py_ssize_t
+parallel_trailer(parcompobject *self, unsigned char *out)
+{
+    uLong check = self->check;
+    unsigned long isize = (unsigned long)(self->total_in & 0xffffffffU);
+    int i;
+
+    switch (self->format) {
+    case PARALLEL_ZLIB:
+        for (i = 0; i < 4; i++)
+            out[i] = (unsigned char)(check >> (24 - 8 * i));
+        return 4;
+    case PARALLEL_GZIP:
+        for (i = 0; i < 4; i++) {
+            out[i] = (unsigned char)(check >> (8 * i));
+            out[4 + i] = (unsigned char)(isize >> (8 * i));
+        }
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/* Compress the first len bytes of the pending input, as blocks of
+   self->blocksize bytes; if finish is true, the last block ends the
+   stream. Return the compressed data, with the header and the trailer
+   when needed. */
+static PyObject *
+parallel_compress_pending(parcompobject *self, Py_ssize_t len, int finish)
+{
+    parallel_block *blocks;
+    Py_ssize_t nblocks, i, pos, out_len;
+    unsigned char header[10], trailer[8];
+    Py_ssize_t header_len = 0, trailer_len = 0;
+    const Bytef *in = (const Bytef *)self->pending;
+    PyObject *result = NULL;
+    char *out;
+
+    nblocks = (len + self->blocksize - 1) / self->blocksize;
+    if (finish && nblocks == 0)
+        nblocks = 1;        /* an empty final block */
+    blocks = PyMem_New(parallel_block, Py_MAX(nblocks, 1));
+    if (blocks == NULL)
+        return PyErr_NoMemory();
+
+    for (i = 0, pos = 0; i < nblocks; i++, pos += self->blocksize) {
+        blocks[i].in = in + pos;
+        blocks[i].in_len = Py_MIN(self->blocksize, len - pos);
+        if (i == 0) {
+            blocks[i].dict = (const Bytef *)self->window;
+            blocks[i].dict_len = self->window_len;
+        }
+        else {
+            blocks[i].dict_len = Py_MIN(pos, (Py_ssize_t)1 << self->window_bits);
+            blocks[i].dict = in + pos - blocks[i].dict_len;
+        }
+        blocks[i].final = finish && (i == nblocks - 1);
+        blocks[i].out = NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    parallel_deflate_blocks(self, blocks, nblocks);
+    Py_END_ALLOW_THREADS
+
+    out_len = 0;
+    for (i = 0; i < nblocks; i++) {
+        if (blocks[i].err != Z_OK) {
+            z_stream zst;
+            zst.msg = NULL;
+            zlib_error(zst, blocks[i].err, blocks[i].msg);
+            goto done;
+        }
+        out_len += blocks[i].out_len;
+    }
+
+    if (!self->header_written) {
+        header_len = parallel_header(self, header);
+        self->header_written = 1;
+    }
+    for (i = 0; i < nblocks; i++) {
+        if (self->format == PARALLEL_GZIP)
+            self->check = crc32_combine(self->check, blocks[i].check,
+                                        (z_off_t)blocks[i].in_len);
+        else
+            self->check = adler32_combine(self->check, blocks[i].check,
+                                          (z_off_t)blocks[i].in_len);
+    }
+    self->total_in += len;
+    if (finish) {
+        trailer_len = parallel_trailer(self, trailer);
+        self->finished = 1;
+    }
+
+    result = PyBytes_FromStringAndSize(NULL,
+                                       header_len + out_len + trailer_len);
+    if (result == NULL)
+        goto done;
+    out = PyBytes_AS_STRING(result);
+    memcpy(out, header, header_len);
+    out += header_len;
+    for (i = 0; i < nblocks; i++) {
+        memcpy(out, blocks[i].out, blocks[i].out_len);
+        out += blocks[i].out_len;
+    }
+    memcpy(out, trailer, trailer_len);
+
+    /* Keep the end of the input to prime the next block, and drop the
+       compressed input */
+    if (len >= ((Py_ssize_t)1 << self->window_bits)) {
+        self->window_len = (Py_ssize_t)1 << self->window_bits;
+        memcpy(self->window, self->pending + len - self->window_len,
+               self->window_len);
+    }
+    else if (len > 0) {
+        Py_ssize_t keep = Py_MIN(self->window_len,
+                                 ((Py_ssize_t)1 << self->window_bits) - len);
+        memmove(self->window, self->window + self->window_len - keep, keep);
+        memcpy(self->window + keep, self->pending, len);
+        self->window_len = keep + len;
+    }
+    self->pending_len -= len;
+    memmove(self->pending, self->pending + len, self->pending_len);
+
+done:
+    for (i = 0; i < nblocks; i++)
+        PyMem_RawFree(blocks[i].out);
+    PyMem_Free(blocks);
+    return result;
+}
+
+PyDoc_STRVAR(parallel_compress__doc__,
+"compress($self, data, /)\n"
+"--\n"
+"\n"
+"Returns a bytes object containing compressed data.\n"
+"\n"
+"  data\n"
+"    Binary data to be compressed.\n"
+"\n"
+"Data is buffered until a batch of one block per thread is available.\n"
+"After calling this function, some of the input data may still be\n"
+"stored in internal buffers for later processing.\n"
+"Call the flush() method to compress all remaining data.");
+
+static PyObject *
+parallel_compress(parcompobject *self, PyObject *arg)
+{
+    Py_buffer data;
+    Py_ssize_t len;
+    PyObject *result = NULL;
+
+    if (PyObject_GetBuffer(arg, &data, PyBUF_SIMPLE) < 0)
+        return NULL;
+
+    ENTER_ZLIB(self);
+
+    if (self->finished) {
+        PyErr_SetString(ZlibError, "the stream is already flushed");
+        goto done;
+    }
+    if (data.len > self->pending_size - self->pending_len) {
+        char *pending;
+        Py_ssize_t size;
+
+        if (data.len > PY_SSIZE_T_MAX - self->pending_len) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        size = Py_MAX(self->pending_len + data.len,
+                      self->blocksize * self->threads);
+        pending = PyMem_Realloc(self->pending, size);
+        if (pending == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        self->pending = pending;
+        self->pending_size = size;
+    }
+    memcpy(self->pending + self->pending_len, data.buf, data.len);
+    self->pending_len += data.len;
+
+    if (self->pending_len < self->blocksize * self->threads) {
+        if (!self->header_written) {
+            unsigned char header[10];
+            Py_ssize_t header_len = parallel_header(self, header);
+            self->header_written = 1;
+            result = PyBytes_FromStringAndSize((char *)header, header_len);
+        }
+        else {
+            result = PyBytes_FromStringAndSize(NULL, 0);
+        }
+        goto done;
+    }
+    /* Compress all the complete blocks */
+    len = self->pending_len - self->pending_len % self->blocksize;
+    result = parallel_compress_pending(self, len, 0);
+
+done:
+    LEAVE_ZLIB(self);
+    PyBuffer_Release(&data);
+    return result;
+}
+
+PyDoc_STRVAR(parallel_flush__doc__,
+"flush($self, /)\n"
+"--\n"
+"\n"
+"Return a bytes object containing any remaining compressed data.\n"
+"\n"
+"The stream is finished: the compressor cannot be used afterwards.");
+
+static PyObject *
+parallel_flush(parcompobject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *result;
+
+    ENTER_ZLIB(self);
+    if (self->finished) {
+        result = PyBytes_FromStringAndSize(NULL, 0);
+    }
+    else {
+        result = parallel_compress_pending(self, self->pending_len, 1);
+    }
+    LEAVE_ZLIB(self);
+    return result;
+}
+
+static void
+ParallelComp_dealloc(parcompobject *self)
+{
+    PyMem_Free(self->pending);
+    if (self->lock != NULL)
+        PyThread_free_lock(self->lock);
+    PyObject_Del(self);
+}
+
+PyDoc_STRVAR(zlib_parallel_compressobj__doc__,
+"parallel_compressobj($module, /, level=Z_DEFAULT_COMPRESSION,\n"
+"                     wbits=MAX_WBITS, blocksize=131072, threads=4)\n"
+"--\n"
+"\n"
+"Return a compressor object which deflates blocks on several threads.\n"
+"\n"
+"  level\n"
+"    The compression level (an integer in the range 0-9 or -1).\n"
+"  wbits\n"
+"    The window size and container format, as for compressobj():\n"
+"    +9 to +15 for a zlib stream, +25 to +31 for a gzip stream,\n"
+"    -9 to -15 for a raw deflate stream.\n"
+"  blocksize\n"
+"    The amount of input deflated by one thread at a time, at least\n"
+"    32768 bytes.\n"
+"  threads\n"
+"    The number of threads.\n"
+"\n"
+"The output is a standard stream which any decompressor accepts;\n"
+"it is slightly larger than the output of compressobj().");
+
+static PyObject *
+zlib_parallel_compressobj(PyObject *module, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"level", "wbits", "blocksize", "threads", NULL};
+    int level = Z_DEFAULT_COMPRESSION, wbits = MAX_WBITS, threads = 4;
+    Py_ssize_t blocksize = PARALLEL_DEF_BLOCKSIZE;
+    parallel_format format;
+    parcompobject *self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+                                     "|iini:parallel_compressobj", kwlist,
+                                     &level, &wbits, &blocksize, &threads))
+        return NULL;
+
+    if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+        PyErr_SetString(PyExc_ValueError, "invalid compression level");
+        return NULL;
+    }
+    if (wbits >= 9 && wbits <= MAX_WBITS) {
+        format = PARALLEL_ZLIB;
+    }
+    else if (wbits >= 16 + 9 && wbits <= 16 + MAX_WBITS) {
+        format = PARALLEL_GZIP;
+        wbits -= 16;
+    }
+    else if (wbits >= -MAX_WBITS && wbits <= -9) {
+        format = PARALLEL_RAW;
+        wbits = -wbits;
+    }
+    else {
+        PyErr_SetString(PyExc_ValueError, "invalid wbits value");
+        return NULL;
+    }
+    if (blocksize < PARALLEL_MIN_BLOCKSIZE ||
+        blocksize > PARALLEL_MAX_BLOCKSIZE) {
+        PyErr_Format(PyExc_ValueError,
+                     "blocksize must be in range %d to %d",
+                     PARALLEL_MIN_BLOCKSIZE, PARALLEL_MAX_BLOCKSIZE);
+        return NULL;
+    }
+    if (threads < 1 || threads > PARALLEL_MAX_THREADS) {
+        PyErr_Format(PyExc_ValueError,
+                     "threads must be in range 1 to %d",
+                     PARALLEL_MAX_THREADS);
+        return NULL;
+    }
+
+    self = PyObject_New(parcompobject, &ParallelComptype);
+    if (self == NULL)
+        return NULL;
+    self->level = level;
+    self->window_bits = wbits;
+    self->format = format;
+    self->blocksize = blocksize;
+    self->threads = threads;
+    self->pending = NULL;
+    self->pending_len = 0;
+    self->pending_size = 0;
+    self->window_len = 0;
+    self->check = (format == PARALLEL_GZIP) ? crc32(0, NULL, 0)
+                                            : adler32(0, NULL, 0);
+    self->total_in = 0;
+    self->header_written = 0;
+    self->finished = 0;
+    self->lock = PyThread_allocate_lock();
+    if (self->lock == NULL) {
+        Py_DECREF(self);
+        PyErr_SetString(PyExc_MemoryError, "Unable to allocate lock");
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static PyMethodDef ParallelComp_methods[] =
+{
+    {"compress", (PyCFunction)parallel_compress, METH_O,
+     parallel_compress__doc__},
+    {"flush", (PyCFunction)parallel_flush, METH_NOARGS,
+     parallel_flush__doc__},
+    {NULL, NULL}
+};
+
+static PyTypeObject ParallelComptype = {
+    PyVarObject_HEAD_INIT(0, 0)
+    "zlib.ParallelCompress",
+    sizeof(parcompobject),
+    0,
+    (destructor)ParallelComp_dealloc, /*tp_dealloc*/
+    0,                              /*tp_print*/
+    0,                              /*tp_getattr*/
+    0,                              /*tp_setattr*/
+    0,                              /*tp_reserved*/
+    0,                              /*tp_repr*/
+    0,                              /*tp_as_number*/
+    0,                              /*tp_as_sequence*/
+    0,                              /*tp_as_mapping*/
+    0,                              /*tp_hash*/
+    0,                              /*tp_call*/
+    0,                              /*tp_str*/
+    0,                              /*tp_getattro*/
+    0,                              /*tp_setattro*/
+    0,                              /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,             /*tp_flags*/
+    0,                              /*tp_doc*/
+    0,                              /*tp_traverse*/
+    0,                              /*tp_clear*/
+    0,                              /*tp_richcompare*/
+    0,                              /*tp_weaklistoffset*/
+    0,                              /*tp_iter*/
+    0,                              /*tp_iternext*/
+    ParallelComp_methods,           /*tp_methods*/
+};
+
+#endif /* AT_LEAST_ZLIB_1_2_2_1 */
+
+
 static PyMethodDef zlib_methods[] =
 {
     ZLIB_ADLER32_METHODDEF
@@ -1246,7 +2073,13 @@ static PyMethodDef zlib_methods[] =
     ZLIB_COMPRESSOBJ_METHODDEF
     ZLIB_CRC32_METHODDEF
     ZLIB_DECOMPRESS_METHODDEF
+    {"decompress_into", (PyCFunction)zlib_decompress_into,
+     METH_VARARGS | METH_KEYWORDS, zlib_decompress_into__doc__},
     ZLIB_DECOMPRESSOBJ_METHODDEF
+#ifdef AT_LEAST_ZLIB_1_2_2_1
+    {"parallel_compressobj", (PyCFunction)zlib_parallel_compressobj,
+     METH_VARARGS | METH_KEYWORDS, zlib_parallel_compressobj__doc__},
+#endif
     {NULL, NULL}
 };
 
@@ -1322,7 +2155,9 @@ PyDoc_STRVAR(zlib_module_documentation,
 "compressobj([level[, ...]]) -- Return a compressor object.\n"
 "crc32(string[, start]) -- Compute a CRC-32 checksum.\n"
 "decompress(string,[wbits],[bufsize]) -- Decompresses a compressed string.\n"
+"decompress_into(string, buffer[, wbits]) -- Decompresses into a buffer.\n"
 "decompressobj([wbits[, zdict]]]) -- Return a decompressor object.\n"
+"parallel_compressobj([level[, ...]]) -- Return a multi-threaded compressor.\n"
 "\n"
 "'wbits' is window buffer size and container format.\n"
 "Compressor objects support compress() and flush() methods; decompressor\n"
@@ -1348,6 +2183,10 @@ PyInit_zlib(void)
             return NULL;
     if (PyType_Ready(&Decomptype) < 0)
             return NULL;
+#ifdef AT_LEAST_ZLIB_1_2_2_1
+    if (PyType_Ready(&ParallelComptype) < 0)
+            return NULL;
+#endif
     m = PyModule_Create(&zlibmodule);
     if (m == NULL)
         return NULL;
@@ -120,6 +120,23 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                 /* Out-of-range */
                 goto Return;
             *p++ = ch;
+#if STRINGLIB_MAX_CHAR >= 0x07FF
+            /* Fast path for runs of two-byte sequences (Latin-1
+               Supplement, Greek, Cyrillic, Hebrew, Arabic...): decode
+               them two at a time without going through the dispatch on
+               the leading byte. Anything else ends the run. */
+            while (end - s >= 4) {
+                Py_UCS4 b0 = (unsigned char)s[0], b1 = (unsigned char)s[1];
+                Py_UCS4 b2 = (unsigned char)s[2], b3 = (unsigned char)s[3];
+                if (b0 < 0xC2 || b0 >= 0xE0 || !IS_CONTINUATION_BYTE(b1) ||
+                    b2 < 0xC2 || b2 >= 0xE0 || !IS_CONTINUATION_BYTE(b3))
+                    break;
+                p[0] = (STRINGLIB_CHAR)(((b0 & 0x1F) << 6) | (b1 & 0x3F));
+                p[1] = (STRINGLIB_CHAR)(((b2 & 0x1F) << 6) | (b3 & 0x3F));
+                p += 2;
+                s += 4;
+            }
+#endif
             continue;
         }
 
@@ -170,6 +187,23 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                 /* Out-of-range */
                 goto Return;
             *p++ = ch;
+#if STRINGLIB_MAX_CHAR >= 0xFFFF
+            /* Fast path for runs of three-byte sequences (CJK, most
+               Indic scripts...), which stops at anything else, including
+               overlong forms and surrogates */
+            while (end - s >= 3) {
+                Py_UCS4 b0 = (unsigned char)s[0];
+                Py_UCS4 b1 = (unsigned char)s[1], b2 = (unsigned char)s[2];
+                if ((b0 & 0xF0) != 0xE0 || !IS_CONTINUATION_BYTE(b1) ||
+                    !IS_CONTINUATION_BYTE(b2))
+                    break;
+                ch = ((b0 & 0x0F) << 12) | ((b1 & 0x3F) << 6) | (b2 & 0x3F);
+                if (ch < 0x0800 || Py_UNICODE_IS_SURROGATE(ch))
+                    break;
+                *p++ = (STRINGLIB_CHAR)ch;
+                s += 3;
+            }
+#endif
             continue;
         }
 
@@ -160,6 +160,12 @@ STRINGLIB(rfind_char)(const STRINGLIB_CHAR* s, Py_ssize_t n, STRINGLIB_CHAR ch)
 
 #undef MEMCHR_CUT_OFF
 
+/* the memchr() candidate filter of FASTSEARCH is used on haystacks longer
+   than the cut off, as long as it finds no more than one false candidate
+   per MEMCHR_SEARCH_SPACING characters */
+#define MEMCHR_SEARCH_CUT_OFF 64
+#define MEMCHR_SEARCH_SPACING 32
+
 Py_LOCAL_INLINE(Py_ssize_t)
 FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
            const STRINGLIB_CHAR* p, Py_ssize_t m,
@@ -167,7 +173,7 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
 {
     unsigned long mask;
     Py_ssize_t skip, count = 0;
-    Py_ssize_t i, j, mlast, w;
+    Py_ssize_t i, j, mlast, w, start = 0;
 
     w = n - m;
 
@@ -199,6 +205,41 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
     skip = mlast - 1;
     mask = 0;
 
+#if STRINGLIB_SIZEOF_CHAR == 1
+    if (mode != FAST_RSEARCH && w > MEMCHR_SEARCH_CUT_OFF) {
+        /* let memchr() jump to the candidates starting with the first
+           character, then test the last character before comparing the
+           rest.  this wins big when the first character is rare; once
+           the false candidates come thicker than one every
+           MEMCHR_SEARCH_SPACING characters, go on with the loop below. */
+        const STRINGLIB_CHAR *ps = s, *pe = s + w + 1;
+        Py_ssize_t misses = 0;
+
+        while (ps < pe) {
+            ps = memchr(ps, p[0], pe - ps);
+            if (ps == NULL)
+                return mode == FAST_COUNT ? count : -1;
+            if (ps[mlast] == p[mlast] &&
+                memcmp(ps + 1, p + 1, mlast - 1) == 0) {
+                /* got a match! */
+                if (mode != FAST_COUNT)
+                    return ps - s;
+                count++;
+                if (count == maxcount)
+                    return maxcount;
+                ps += m;
+                continue;
+            }
+            ps++;
+            if (++misses * MEMCHR_SEARCH_SPACING > (ps - s) + 256)
+                break;
+        }
+        if (ps >= pe)
+            return mode == FAST_COUNT ? count : -1;
+        start = ps - s;
+    }
+#endif
+
     if (mode != FAST_RSEARCH) {
         const STRINGLIB_CHAR *ss = s + m - 1;
         const STRINGLIB_CHAR *pp = p + m - 1;
@@ -214,7 +255,7 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
         /* process pattern[-1] outside the loop */
         STRINGLIB_BLOOM_ADD(mask, p[mlast]);
 
-        for (i = 0; i <= w; i++) {
+        for (i = start; i <= w; i++) {
             /* note: using mlast in the skip path slows things down on x86 */
             if (ss[i] == pp[0]) {
                 /* candidate match */
@@ -282,3 +323,5 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
     return count;
 }
 
+#undef MEMCHR_SEARCH_CUT_OFF
+#undef MEMCHR_SEARCH_SPACING
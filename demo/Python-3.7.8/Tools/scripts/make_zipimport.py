@@ -0,0 +1,225 @@
+#! /usr/bin/env python3
+
+"""Build a Zip archive of compiled modules laid out for fast importing.
+
+usage: make_zipimport.py [-o archive] [-t manifest] [-O] [--seal] dir...
+
+Every .py file below each dir is compiled to a .pyc in a single pass and
+stored uncompressed, so that zipimport unmarshals the code objects in place
+from its mapping of the archive.  The files named in the import manifest
+(the format used by PYTHONZIPPREFETCH: the __file__ of a module on each
+line, in import order) come first, in that order, so that starting the
+application reads the archive mostly front to back.  The remaining files
+follow in name order.
+
+A central directory index (see read_index() in Modules/zipimport.c) is
+stored as the archive comment, so modules are found with a hash lookup
+instead of reading the whole central directory at startup.  With --seal the
+archive is marked as sealed and its .pyc files are never checked against
+the modification time of a source file.
+
+The archive must be used with the same Python version as the one running
+this script, as the .pyc files are only valid for that magic number.
+
+-o archive: the archive to create (default: modules.zip)
+-t manifest: the import manifest giving the order of the files
+-O: compile with optimization level 1 (-OO: level 2)
+--seal: mark the archive as sealed
+"""
+
+import getopt
+import importlib.util
+import marshal
+import os
+import struct
+import sys
+import zipfile
+
+
+ZIP_INDEX_MAGIC = b'PyZI'
+ZIP_INDEX_EMPTY = 0xFFFFFFFF
+ZIP_INDEX_SEALED = 0x0001
+
+# The comment holding the index is limited to 64K.
+MAX_SLOTS = 8192
+
+
+def usage(msg=None):
+    if msg:
+        sys.stderr.write(msg + '\n')
+    sys.stderr.write(__doc__)
+    sys.exit(2)
+
+
+def find_sources(dirs):
+    """Return a dict of {archive name: source path} of the .py files."""
+    sources = {}
+    for top in dirs:
+        for dirpath, dirnames, filenames in os.walk(top):
+            dirnames.sort()
+            for filename in filenames:
+                if not filename.endswith('.py'):
+                    continue
+                path = os.path.join(dirpath, filename)
+                name = os.path.relpath(path, top).replace(os.sep, '/')
+                sources[name[:-3] + '.pyc'] = path
+    return sources
+
+
+def compile_pyc(path, optimize):
+    """Return the contents of the timestamp based .pyc of a source file."""
+    with open(path, 'rb') as f:
+        source = f.read()
+    code = compile(source, path, 'exec', dont_inherit=True,
+                   optimize=optimize)
+    st = os.stat(path)
+    return (importlib.util.MAGIC_NUMBER +
+            struct.pack('<III', 0, int(st.st_mtime) & 0xFFFFFFFF,
+                        st.st_size & 0xFFFFFFFF) +
+            marshal.dumps(code))
+
+
+def manifest_order(manifest, names):
+    """Return the names in the order they are imported according to an
+    import manifest, followed by the ones it doesn't mention."""
+    ordered = []
+    seen = set()
+    with open(manifest, encoding='utf-8') as f:
+        for line in f:
+            line = line.strip().replace(os.sep, '/')
+            if not line or line.startswith('#'):
+                continue
+            if line.endswith('.py'):
+                line += 'c'
+            # The longest trailing part of the path that is a file of the
+            # archive, ie. the path without the archive's own path.
+            start = 0
+            while True:
+                candidate = line[start:]
+                if candidate in names:
+                    if candidate not in seen:
+                        seen.add(candidate)
+                        ordered.append(candidate)
+                    break
+                start = line.find('/', start) + 1
+                if start == 0:
+                    break
+    ordered.extend(sorted(name for name in names if name not in seen))
+    return ordered
+
+
+def directories(names):
+    """Return the directory entries needed by a list of files."""
+    dirs = set()
+    for name in names:
+        parts = name.split('/')[:-1]
+        for i in range(1, len(parts) + 1):
+            dirs.add('/'.join(parts[:i]) + '/')
+    return sorted(dirs)
+
+
+def zip_index_hash(name):
+    """The 32 bit FNV-1a hash used by zipimport."""
+    h = 2166136261
+    for byte in name:
+        h = ((h ^ byte) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def central_directory(data):
+    """Return a list of (offset, name) of the central directory entries
+    of an archive without a comment, the offset being relative to the
+    start of the central directory."""
+    eocd = data[-22:]
+    if eocd[:4] != b'PK\x05\x06':
+        raise ValueError('unexpected end of central directory record')
+    count, size, start = struct.unpack('<HII', eocd[10:20])
+    entries = []
+    offset = 0
+    while offset < size:
+        header = data[start + offset:start + offset + 46]
+        if header[:4] != b'PK\x01\x02':
+            raise ValueError('bad central directory entry')
+        name_size, extra_size, comment_size = struct.unpack(
+                '<HHH', header[28:34])
+        name = data[start + offset + 46:start + offset + 46 + name_size]
+        entries.append((offset, name))
+        offset += 46 + name_size + extra_size + comment_size
+    if len(entries) != count:
+        raise ValueError('central directory entry count mismatch')
+    return entries
+
+
+def build_index(entries, flags):
+    """Return the archive comment holding the index of a central
+    directory."""
+    nslots = 1
+    while nslots * 3 < len(entries) * 4:
+        nslots *= 2
+    if nslots > MAX_SLOTS:
+        raise ValueError('too many files (%d) for a central directory index'
+                         % len(entries))
+    slots = [ZIP_INDEX_EMPTY] * nslots
+    mask = nslots - 1
+    for offset, name in entries:
+        h = zip_index_hash(name)
+        probe = 0
+        while slots[(h + probe) & mask] != ZIP_INDEX_EMPTY:
+            probe += 1
+        slots[(h + probe) & mask] = offset
+    return (ZIP_INDEX_MAGIC + struct.pack('<I', nslots) +
+            struct.pack('<%dI' % nslots, *slots) + struct.pack('<I', flags))
+
+
+def main():
+    try:
+        opts, dirs = getopt.getopt(sys.argv[1:], 'ho:t:O', ['seal'])
+    except getopt.error as msg:
+        usage(str(msg))
+
+    archive = 'modules.zip'
+    manifest = None
+    optimize = 0
+    flags = 0
+    for o, a in opts:
+        if o == '-h':
+            usage()
+        elif o == '-o':
+            archive = a
+        elif o == '-t':
+            manifest = a
+        elif o == '-O':
+            optimize += 1
+        elif o == '--seal':
+            flags |= ZIP_INDEX_SEALED
+    if not dirs:
+        usage('at least one directory is required')
+
+    sources = find_sources(dirs)
+    if manifest:
+        names = manifest_order(manifest, sources)
+    else:
+        names = sorted(sources)
+
+    # The date of the entries doesn't matter, keep the archive reproducible.
+    date_time = (1980, 1, 1, 0, 0, 0)
+    with zipfile.ZipFile(archive, 'w', zipfile.ZIP_STORED) as zf:
+        for name in directories(names):
+            zf.writestr(zipfile.ZipInfo(name, date_time), b'')
+        for name in names:
+            zf.writestr(zipfile.ZipInfo(name, date_time),
+                        compile_pyc(sources[name], optimize))
+
+    # Store the index as the comment, which follows the central directory
+    # and so leaves the offsets it refers to unchanged.
+    with open(archive, 'r+b') as f:
+        data = f.read()
+        comment = build_index(central_directory(data), flags)
+        f.seek(len(data) - 2)
+        f.write(struct.pack('<H', len(comment)) + comment)
+
+    print('%s: %d modules' % (archive, len(names)))
+
+
+if __name__ == '__main__':
+    main()
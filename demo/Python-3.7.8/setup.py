@@ -749,6 +749,8 @@ class PyBuildExt(build_ext):
         exts.append( Extension('_testmultiphase', ['_testmultiphase.c']) )
         # profiler (_lsprof is for cProfile.py)
         exts.append( Extension('_lsprof', ['_lsprof.c', 'rotatingtree.c']) )
+        # statistical profiler
+        exts.append( Extension('_sampleprof', ['_sampleprof.c']) )
         # static Unicode character database
         exts.append( Extension('unicodedata', ['unicodedata.c'],
                                depends=['unicodedata_db.h', 'unicodename_db.h']) )
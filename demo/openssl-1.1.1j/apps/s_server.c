@@ -102,6 +102,7 @@ static char *keymatexportlabel = NULL;
 static int keymatexportlen = 20;
 
 static int async = 0;
+static int s_conn_stats = 0;
 
 static const char *session_id_prefix = NULL;
 
@@ -740,7 +741,7 @@ typedef enum OPTION_choice {
     OPT_CRLF, OPT_QUIET, OPT_BRIEF, OPT_NO_DHE,
     OPT_NO_RESUME_EPHEMERAL, OPT_PSK_IDENTITY, OPT_PSK_HINT, OPT_PSK,
     OPT_PSK_SESS, OPT_SRPVFILE, OPT_SRPUSERSEED, OPT_REV, OPT_WWW,
-    OPT_UPPER_WWW, OPT_HTTP, OPT_ASYNC, OPT_SSL_CONFIG,
+    OPT_UPPER_WWW, OPT_HTTP, OPT_ASYNC, OPT_CONN_STATS, OPT_SSL_CONFIG,
     OPT_MAX_SEND_FRAG, OPT_SPLIT_SEND_FRAG, OPT_MAX_PIPELINES, OPT_READ_BUF,
     OPT_SSL3, OPT_TLS1_3, OPT_TLS1_2, OPT_TLS1_1, OPT_TLS1, OPT_DTLS, OPT_DTLS1,
     OPT_DTLS1_2, OPT_SCTP, OPT_TIMEOUT, OPT_MTU, OPT_LISTEN, OPT_STATELESS,
@@ -880,6 +881,8 @@ const OPTIONS s_server_options[] = {
     {"rev", OPT_REV, '-',
      "act as a simple test server which just sends back with the received text reversed"},
     {"async", OPT_ASYNC, '-', "Operate in asynchronous mode"},
+    {"conn_stats", OPT_CONN_STATS, '-',
+     "Print bytes, CPU time and async pauses of each connection"},
     {"ssl_config", OPT_SSL_CONFIG, 's',
      "Configure SSL_CTX using the configuration 'val'"},
     {"max_send_frag", OPT_MAX_SEND_FRAG, 'p', "Maximum Size of send frames "},
@@ -1062,6 +1065,7 @@ int s_server_main(int argc, char *argv[])
     s_quiet = 0;
     s_brief = 0;
     async = 0;
+    s_conn_stats = 0;
 
     cctx = SSL_CONF_CTX_new();
     vpm = X509_VERIFY_PARAM_new();
@@ -1558,6 +1562,9 @@ int s_server_main(int argc, char *argv[])
         case OPT_ASYNC:
             async = 1;
             break;
+        case OPT_CONN_STATS:
+            s_conn_stats = 1;
+            break;
         case OPT_MAX_SEND_FRAG:
             max_send_fragment = atoi(opt_arg());
             break;
@@ -2232,6 +2239,8 @@ static int sv_body(int s, int stype, int prot, unsigned char *context)
     int ret = 1, width;
     int k, i;
     unsigned long l;
+    long bytes_read = 0, bytes_written = 0;
+    int async_pauses = 0;
     SSL *con = NULL;
     BIO *sbio;
     struct timeval timeout;
@@ -2247,6 +2256,8 @@ static int sv_body(int s, int stype, int prot, unsigned char *context)
 #endif
 
     buf = app_malloc(bufsize, "server buffer");
+    if (s_conn_stats)
+        app_tminterval(TM_START, 1);
     if (s_nbio) {
         if (!BIO_socket_nbio(s, 1))
             ERR_print_errors(bio_err);
@@ -2596,6 +2607,7 @@ static int sv_body(int s, int stype, int prot, unsigned char *context)
                     BIO_printf(bio_s_out, "Write BLOCK (Async)\n");
                     (void)BIO_flush(bio_s_out);
                     wait_for_async(con);
+                    async_pauses++;
                     break;
                 case SSL_ERROR_WANT_WRITE:
                 case SSL_ERROR_WANT_READ:
@@ -2624,6 +2636,7 @@ static int sv_body(int s, int stype, int prot, unsigned char *context)
                 if (k > 0) {
                     l += k;
                     i -= k;
+                    bytes_written += k;
                 }
                 if (i <= 0)
                     break;
@@ -2671,6 +2684,7 @@ static int sv_body(int s, int stype, int prot, unsigned char *context)
 #endif
                     raw_write_stdout(buf, (unsigned int)i);
                     (void)BIO_flush(bio_s_out);
+                    bytes_read += i;
                     if (SSL_has_pending(con))
                         goto again;
                     break;
@@ -2678,6 +2692,7 @@ static int sv_body(int s, int stype, int prot, unsigned char *context)
                     BIO_printf(bio_s_out, "Read BLOCK (Async)\n");
                     (void)BIO_flush(bio_s_out);
                     wait_for_async(con);
+                    async_pauses++;
                     break;
                 case SSL_ERROR_WANT_WRITE:
                 case SSL_ERROR_WANT_READ:
@@ -2711,6 +2726,11 @@ static int sv_body(int s, int stype, int prot, unsigned char *context)
         SSL_free(con);
     }
     BIO_printf(bio_s_out, "CONNECTION CLOSED\n");
+    if (s_conn_stats)
+        BIO_printf(bio_s_out,
+                   "CONNECTION STATS: %ld bytes read, %ld bytes written, "
+                   "%.3fs CPU, %d async pauses\n", bytes_read, bytes_written,
+                   app_tminterval(TM_STOP, 1), async_pauses);
     OPENSSL_clear_free(buf, bufsize);
     return ret;
 }
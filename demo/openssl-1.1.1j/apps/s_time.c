@@ -26,6 +26,9 @@
 #if !defined(OPENSSL_SYS_MSDOS)
 # include OPENSSL_UNISTD
 #endif
+#if !defined(_WIN32)
+# include <time.h>
+#endif
 
 #define SSL_CONNECT_NAME        "localhost:4433"
 
@@ -34,6 +37,13 @@
 
 static SSL *doConnection(SSL *scon, const char *host, SSL_CTX *ctx);
 
+/* Wall-clock time taken by each connection, in seconds */
+typedef struct conn_times_st {
+    double *times;
+    size_t num;
+    size_t size;
+} CONN_TIMES;
+
 /*
  * Define a HTTP get command globally.
  * Also define the size of the command, this is two bytes less than
@@ -88,6 +98,70 @@ static double tm_Time_F(int s)
     return app_tminterval(s, 1);
 }
 
+/*
+ * A clock for timing single connections. app_tminterval() can't be used for
+ * it as it keeps a single start time, which tm_Time_F() already owns.
+ */
+static double conn_clock(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER freq, now;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+    return (double)time(NULL);
+#endif
+}
+
+static int conn_times_add(CONN_TIMES *ct, double t)
+{
+    if (ct->num == ct->size) {
+        size_t size = ct->size == 0 ? 1024 : ct->size * 2;
+        double *times = OPENSSL_realloc(ct->times, size * sizeof(*times));
+
+        if (times == NULL)
+            return 0;
+        ct->times = times;
+        ct->size = size;
+    }
+    ct->times[ct->num++] = t;
+    return 1;
+}
+
+static int conn_times_cmp(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+
+    return da < db ? -1 : da > db;
+}
+
+/* Print the distribution of the recorded times and forget them */
+static void conn_times_print(CONN_TIMES *ct)
+{
+    static const double pcts[] = { 50, 90, 99, 99.9 };
+    size_t i, idx;
+
+    if (ct->num == 0)
+        return;
+    qsort(ct->times, ct->num, sizeof(*ct->times), conn_times_cmp);
+    printf("connection time (ms): min %.2f", ct->times[0] * 1e3);
+    for (i = 0; i < OSSL_NELEM(pcts); i++) {
+        idx = (size_t)(ct->num * pcts[i] / 100);
+        if (idx >= ct->num)
+            idx = ct->num - 1;
+        printf(", p%g %.2f", pcts[i], ct->times[idx] * 1e3);
+    }
+    printf(", max %.2f\n", ct->times[ct->num - 1] * 1e3);
+    ct->num = 0;
+}
+
 int s_time_main(int argc, char **argv)
 {
     char buf[1024 * 8];
@@ -104,6 +178,8 @@ int s_time_main(int argc, char **argv)
     OPTION_CHOICE o;
     int max_version = 0, ver, buf_len;
     size_t buf_size;
+    CONN_TIMES conn_times = { NULL, 0, 0 };
+    double conn_start;
 
     meth = TLS_client_method();
 
@@ -223,6 +299,7 @@ int s_time_main(int argc, char **argv)
         if (finishtime < (long)time(NULL))
             break;
 
+        conn_start = conn_clock();
         if ((scon = doConnection(NULL, host, ctx)) == NULL)
             goto end;
 
@@ -236,6 +313,10 @@ int s_time_main(int argc, char **argv)
         }
         SSL_set_shutdown(scon, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
         BIO_closesocket(SSL_get_fd(scon));
+        if (!conn_times_add(&conn_times, conn_clock() - conn_start)) {
+            BIO_printf(bio_err, "%s: out of memory\n", prog);
+            goto end;
+        }
 
         nConn += 1;
         if (SSL_session_reused(scon)) {
@@ -264,6 +345,7 @@ int s_time_main(int argc, char **argv)
     printf
         ("%d connections in %ld real seconds, %ld bytes read per connection\n",
          nConn, (long)time(NULL) - finishtime + maxtime, bytes_read / nConn);
+    conn_times_print(&conn_times);
 
     /*
      * Now loop and time connections using the same session id over and over
@@ -303,6 +385,7 @@ int s_time_main(int argc, char **argv)
         if (finishtime < (long)time(NULL))
             break;
 
+        conn_start = conn_clock();
         if ((doConnection(scon, host, ctx)) == NULL)
             goto end;
 
@@ -316,6 +399,10 @@ int s_time_main(int argc, char **argv)
         }
         SSL_set_shutdown(scon, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
         BIO_closesocket(SSL_get_fd(scon));
+        if (!conn_times_add(&conn_times, conn_clock() - conn_start)) {
+            BIO_printf(bio_err, "%s: out of memory\n", prog);
+            goto end;
+        }
 
         nConn += 1;
         if (SSL_session_reused(scon)) {
@@ -340,12 +427,14 @@ int s_time_main(int argc, char **argv)
     printf
         ("%d connections in %ld real seconds, %ld bytes read per connection\n",
          nConn, (long)time(NULL) - finishtime + maxtime, bytes_read / nConn);
+    conn_times_print(&conn_times);
 
     ret = 0;
 
  end:
     SSL_free(scon);
     SSL_CTX_free(ctx);
+    OPENSSL_free(conn_times.times);
     return ret;
 }
 
@@ -34,6 +34,8 @@
 
 #if defined(_WIN32)
 # include <windows.h>
+#else
+# include <time.h>
 #endif
 
 #include <openssl/bn.h>
@@ -130,6 +132,7 @@ static volatile int run = 0;
 
 static int mr = 0;
 static int usertime = 1;
+static int latency = 0;
 
 #ifndef OPENSSL_NO_MD2
 static int EVP_Digest_MD2_loop(void *args);
@@ -193,6 +196,7 @@ static void print_message(const char *s, long num, int length, int tm);
 static void pkey_print_message(const char *str, const char *str2,
                                long num, unsigned int bits, int sec);
 static void print_result(int alg, int run_no, int count, double time_used);
+static void print_latency(const char *name, int size_num);
 #ifndef NO_FORK
 static int do_multi(int multi, int size_num);
 #endif
@@ -300,7 +304,7 @@ typedef enum OPTION_choice {
     OPT_ERR = -1, OPT_EOF = 0, OPT_HELP,
     OPT_ELAPSED, OPT_EVP, OPT_DECRYPT, OPT_ENGINE, OPT_MULTI,
     OPT_MR, OPT_MB, OPT_MISALIGN, OPT_ASYNCJOBS, OPT_R_ENUM,
-    OPT_PRIMES, OPT_SECONDS, OPT_BYTES, OPT_AEAD
+    OPT_PRIMES, OPT_SECONDS, OPT_BYTES, OPT_AEAD, OPT_LATENCY
 } OPTION_CHOICE;
 
 const OPTIONS speed_options[] = {
@@ -315,6 +319,8 @@ const OPTIONS speed_options[] = {
     {"mb", OPT_MB, '-',
      "Enable (tls1>=1) multi-block mode on EVP-named cipher"},
     {"mr", OPT_MR, '-', "Produce machine readable output"},
+    {"latency", OPT_LATENCY, '-',
+     "Report per-operation latency percentiles (only EVP)"},
 #ifndef NO_FORK
     {"multi", OPT_MULTI, 'p', "Run benchmarks in parallel"},
 #endif
@@ -914,6 +920,90 @@ static int RAND_bytes_loop(void *args)
     return count;
 }
 
+/*
+ * Per-operation latency for -latency, kept in a log-linear histogram per
+ * block size: values below 16ns get a bucket each, every power of two
+ * above that is split in 16 buckets, so any percentile read back is within
+ * 1/16 of the measured value.
+ */
+#define LATENCY_SUB_BITS 4
+#define LATENCY_SUB      (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS  ((64 - LATENCY_SUB_BITS + 1) * LATENCY_SUB)
+static unsigned long latency_hist[OSSL_NELEM(lengths_list)][LATENCY_BUCKETS];
+
+static uint64_t latency_now(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+#endif
+}
+
+static unsigned int latency_bucket(uint64_t ns)
+{
+    unsigned int e = 0;
+
+    if (ns < LATENCY_SUB)
+        return (unsigned int)ns;
+    while ((ns >> e) >= 2 * LATENCY_SUB)
+        e++;
+    return (e + 1) * LATENCY_SUB + (unsigned int)(ns >> e) - LATENCY_SUB;
+}
+
+static uint64_t latency_bucket_value(unsigned int b)
+{
+    if (b < LATENCY_SUB)
+        return b;
+    return (uint64_t)(b % LATENCY_SUB + LATENCY_SUB) << (b / LATENCY_SUB - 1);
+}
+
+static ossl_inline uint64_t latency_start(void)
+{
+    return latency ? latency_now() : 0;
+}
+
+static ossl_inline void latency_stop(uint64_t start)
+{
+    if (latency)
+        latency_hist[testnum][latency_bucket(latency_now() - start)]++;
+}
+
+/* Lower bound of the bucket holding the |pct| percentile of |run_no| */
+static double latency_percentile(unsigned int run_no, double pct)
+{
+    unsigned long total = 0, seen = 0, want;
+    unsigned int b;
+
+    for (b = 0; b < LATENCY_BUCKETS; b++)
+        total += latency_hist[run_no][b];
+    if (total == 0)
+        return 0;
+    want = (unsigned long)(total * pct / 100);
+    if (want == 0)
+        want = 1;
+    for (b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += latency_hist[run_no][b];
+        if (seen >= want)
+            break;
+    }
+    return (double)latency_bucket_value(b);
+}
+
 static long save_count = 0;
 static int decrypt = 0;
 static int EVP_Update_loop(void *args)
@@ -922,12 +1012,15 @@ static int EVP_Update_loop(void *args)
     unsigned char *buf = tempargs->buf;
     EVP_CIPHER_CTX *ctx = tempargs->ctx;
     int outl, count, rc;
+    uint64_t t;
 #ifndef SIGALRM
     int nb_iter = save_count * 4 * lengths[0] / lengths[testnum];
 #endif
     if (decrypt) {
         for (count = 0; COND(nb_iter); count++) {
+            t = latency_start();
             rc = EVP_DecryptUpdate(ctx, buf, &outl, buf, lengths[testnum]);
+            latency_stop(t);
             if (rc != 1) {
                 /* reset iv in case of counter overflow */
                 EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1);
@@ -935,7 +1028,9 @@ static int EVP_Update_loop(void *args)
         }
     } else {
         for (count = 0; COND(nb_iter); count++) {
+            t = latency_start();
             rc = EVP_EncryptUpdate(ctx, buf, &outl, buf, lengths[testnum]);
+            latency_stop(t);
             if (rc != 1) {
                 /* reset iv in case of counter overflow */
                 EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1);
@@ -961,23 +1056,28 @@ static int EVP_Update_loop_ccm(void *args)
     EVP_CIPHER_CTX *ctx = tempargs->ctx;
     int outl, count;
     unsigned char tag[12];
+    uint64_t t;
 #ifndef SIGALRM
     int nb_iter = save_count * 4 * lengths[0] / lengths[testnum];
 #endif
     if (decrypt) {
         for (count = 0; COND(nb_iter); count++) {
+            t = latency_start();
             EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, sizeof(tag), tag);
             /* reset iv */
             EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, iv);
             /* counter is reset on every update */
             EVP_DecryptUpdate(ctx, buf, &outl, buf, lengths[testnum]);
+            latency_stop(t);
         }
     } else {
         for (count = 0; COND(nb_iter); count++) {
+            t = latency_start();
             /* restore iv length field */
             EVP_EncryptUpdate(ctx, NULL, &outl, NULL, lengths[testnum]);
             /* counter is reset on every update */
             EVP_EncryptUpdate(ctx, buf, &outl, buf, lengths[testnum]);
+            latency_stop(t);
         }
     }
     if (decrypt)
@@ -1000,24 +1100,29 @@ static int EVP_Update_loop_aead(void *args)
     int outl, count;
     unsigned char aad[13] = { 0xcc };
     unsigned char faketag[16] = { 0xcc };
+    uint64_t t;
 #ifndef SIGALRM
     int nb_iter = save_count * 4 * lengths[0] / lengths[testnum];
 #endif
     if (decrypt) {
         for (count = 0; COND(nb_iter); count++) {
+            t = latency_start();
             EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, iv);
             EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG,
                                 sizeof(faketag), faketag);
             EVP_DecryptUpdate(ctx, NULL, &outl, aad, sizeof(aad));
             EVP_DecryptUpdate(ctx, buf, &outl, buf, lengths[testnum]);
             EVP_DecryptFinal_ex(ctx, buf + outl, &outl);
+            latency_stop(t);
         }
     } else {
         for (count = 0; COND(nb_iter); count++) {
+            t = latency_start();
             EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, iv);
             EVP_EncryptUpdate(ctx, NULL, &outl, aad, sizeof(aad));
             EVP_EncryptUpdate(ctx, buf, &outl, buf, lengths[testnum]);
             EVP_EncryptFinal_ex(ctx, buf + outl, &outl);
+            latency_stop(t);
         }
     }
     return count;
@@ -1030,13 +1135,16 @@ static int EVP_Digest_loop(void *args)
     unsigned char *buf = tempargs->buf;
     unsigned char md[EVP_MAX_MD_SIZE];
     int count;
+    uint64_t t;
 #ifndef SIGALRM
     int nb_iter = save_count * 4 * lengths[0] / lengths[testnum];
 #endif
 
     for (count = 0; COND(nb_iter); count++) {
+        t = latency_start();
         if (!EVP_Digest(buf, lengths[testnum], md, NULL, evp_md, NULL))
             return -1;
+        latency_stop(t);
     }
     return count;
 }
@@ -1619,6 +1727,9 @@ int speed_main(int argc, char **argv)
         case OPT_MR:
             mr = 1;
             break;
+        case OPT_LATENCY:
+            latency = 1;
+            break;
         case OPT_MB:
             multiblock = 1;
 #ifdef OPENSSL_NO_MULTIBLOCK
@@ -1653,6 +1764,13 @@ int speed_main(int argc, char **argv)
     argc = opt_num_rest();
     argv = opt_rest();
 
+#ifndef NO_FORK
+    if (latency && multi) {
+        BIO_printf(bio_err, "%s: -latency cannot be used with -multi\n", prog);
+        goto end;
+    }
+#endif
+
     /* Remaining arguments are algorithms. */
     for (; *argv; argv++) {
         if (found(*argv, doit_choices, &i)) {
@@ -3248,6 +3366,8 @@ int speed_main(int argc, char **argv)
         }
         printf("\n");
     }
+    if (latency && doit[D_EVP])
+        print_latency(names[D_EVP], size_num);
 #ifndef OPENSSL_NO_RSA
     testnum = 1;
     for (k = 0; k < RSA_NUM; k++) {
@@ -3386,6 +3506,30 @@ int speed_main(int argc, char **argv)
     return ret;
 }
 
+static void print_latency(const char *name, int size_num)
+{
+    static const double pcts[] = { 50, 99, 99.9 };
+    static const char *pct_names[] = { "p50", "p99", "p99.9" };
+    char label[64];
+    int run_no;
+    unsigned int j;
+
+    if (!mr)
+        printf("\nThe 'numbers' are latencies per operation in microseconds.\n");
+    for (j = 0; j < OSSL_NELEM(pcts); j++) {
+        if (mr) {
+            printf("+L:%s:%s", name, pct_names[j]);
+        } else {
+            BIO_snprintf(label, sizeof(label), "%s %s", name, pct_names[j]);
+            printf("%-13s", label);
+        }
+        for (run_no = 0; run_no < size_num; run_no++)
+            printf(mr ? ":%.3f" : " %11.3f ",
+                   latency_percentile(run_no, pcts[j]) / 1e3);
+        printf("\n");
+    }
+}
+
 static void print_message(const char *s, long num, int length, int tm)
 {
 #ifdef SIGALRM
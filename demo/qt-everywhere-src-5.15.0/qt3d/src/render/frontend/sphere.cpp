@@ -93,6 +93,25 @@ bool intersectRaySphere(const Qt3DRender::RayCasting::QRay3D &ray, const Qt3DRen
     return true;
 }
 
+// Returns the point of points farthest from p and its squared distance to p.
+// Unlike std::max_element with a distance comparator, which computes the
+// distance of the current maximum again for every comparison, this computes
+// each distance once.
+inline const Vector3D &farthestPoint(const QVector<Vector3D> &points, const Vector3D &p, float *distSq)
+{
+    const Vector3D *farthest = points.constData();
+    float maxDistSq = (*farthest - p).lengthSquared();
+    for (const Vector3D *it = farthest + 1, *end = points.constEnd(); it != end; ++it) {
+        const float d = (*it - p).lengthSquared();
+        if (d > maxDistSq) {
+            maxDistSq = d;
+            farthest = it;
+        }
+    }
+    *distSq = maxDistSq;
+    return *farthest;
+}
+
 inline void constructRitterSphere(Qt3DRender::Render::Sphere &s, const QVector<Vector3D> &points)
 {
     //def bounding_sphere(points):
@@ -110,13 +129,14 @@ inline void constructRitterSphere(Qt3DRender::Render::Sphere &s, const QVector<V
     //
     //  return bounding_sphere
 
+    float distSq;
     const Vector3D x = points[0];
-    const Vector3D y = *std::max_element(points.begin(), points.end(), [&x](const Vector3D& lhs, const Vector3D& rhs){ return (lhs - x).lengthSquared() < (rhs - x).lengthSquared(); });
-    const Vector3D z = *std::max_element(points.begin(), points.end(), [&y](const Vector3D& lhs, const Vector3D& rhs){ return (lhs - y).lengthSquared() < (rhs - y).lengthSquared(); });
+    const Vector3D y = farthestPoint(points, x, &distSq);
+    const Vector3D z = farthestPoint(points, y, &distSq);
 
     const Vector3D center = (y + z) * 0.5f;
-    const Vector3D maxDistPt = *std::max_element(points.begin(), points.end(), [&center](const Vector3D& lhs, const Vector3D& rhs){ return (lhs - center).lengthSquared() < (rhs - center).lengthSquared(); });
-    const float radius = (maxDistPt - center).length();
+    farthestPoint(points, center, &distSq);
+    const float radius = sqrt(distSq);
 
     s.setCenter(center);
     s.setRadius(radius);
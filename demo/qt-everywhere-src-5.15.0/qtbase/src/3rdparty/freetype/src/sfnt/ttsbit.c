@@ -1276,7 +1276,36 @@
 
 
     /* First, we find the correct strike range that applies to this */
-    /* glyph index.                                                 */
+    /* glyph index.  In valid fonts the ranges are sorted by glyph   */
+    /* index, so we first try a binary search; CJK fonts can have    */
+    /* hundreds of ranges per strike.  A linear scan handles tables  */
+    /* that are not sorted.                                          */
+    {
+      FT_Byte*  ranges = p;
+      FT_ULong  min    = 0;
+      FT_ULong  max    = num_ranges;
+
+
+      while ( min < max )
+      {
+        FT_ULong  mid = ( min + max ) >> 1;
+
+
+        p     = ranges + 8 * mid;
+        start = FT_NEXT_USHORT( p );
+        end   = FT_NEXT_USHORT( p );
+
+        if ( glyph_index < start )
+          max = mid;
+        else if ( glyph_index > end )
+          min = mid + 1;
+        else
+          goto FoundRange;
+      }
+
+      p = ranges;
+    }
+
     for ( ; num_ranges > 0; num_ranges-- )
     {
       start = FT_NEXT_USHORT( p );
@@ -42,6 +42,7 @@
 
 #include "qalgorithms.h"
 #include <private/qsimd_p.h>
+#include <private/qsimddispatch_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -762,7 +763,7 @@ QT_BEGIN_NAMESPACE
     \sa qint64
 */
 
-#if defined(__SSSE3__)
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(SSSE3)
 using ShuffleMask = uchar[16];
 Q_DECL_ALIGN(16) static const ShuffleMask shuffleMasks[3] = {
     // 16-bit
@@ -773,20 +774,18 @@ Q_DECL_ALIGN(16) static const ShuffleMask shuffleMasks[3] = {
     {7, 6, 5, 4, 3, 2, 1, 0,   15, 14, 13, 12, 11, 10, 9, 8}
 };
 
-static size_t sseSwapLoop(const uchar *src, size_t bytes, uchar *dst,
-                          const __m128i *shuffleMaskPtr) noexcept
+template <typename T> static inline const __m128i *shuffleMaskFor() noexcept
+{
+    auto shuffleMaskPtr = reinterpret_cast<const __m128i *>(shuffleMasks[0]);
+    return shuffleMaskPtr + qCountTrailingZeroBits(sizeof(T)) - 1;
+}
+
+template <typename T> QT_FUNCTION_TARGET(SSSE3)
+static size_t ssse3SwapLoop(const uchar *src, size_t bytes, uchar *dst) noexcept
 {
     size_t i = 0;
-    const __m128i shuffleMask = _mm_load_si128(shuffleMaskPtr);
+    const __m128i shuffleMask = _mm_load_si128(shuffleMaskFor<T>());
 
-#  ifdef __AVX2__
-    const __m256i shuffleMask256 = _mm256_inserti128_si256(_mm256_castsi128_si256(shuffleMask), shuffleMask, 1);
-    for ( ; i + sizeof(__m256i) <= bytes; i += sizeof(__m256i)) {
-        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
-        data = _mm256_shuffle_epi8(data, shuffleMask256);
-        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), data);
-    }
-#  else
     for ( ; i + 2 * sizeof(__m128i) <= bytes; i += 2 * sizeof(__m128i)) {
         __m128i data1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
         __m128i data2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i) + 1);
@@ -795,7 +794,6 @@ static size_t sseSwapLoop(const uchar *src, size_t bytes, uchar *dst,
         _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), data1);
         _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i) + 1, data2);
     }
-#  endif
 
     if (i + sizeof(__m128i) <= bytes) {
         __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
@@ -807,30 +805,43 @@ static size_t sseSwapLoop(const uchar *src, size_t bytes, uchar *dst,
     return i;
 }
 
-template <typename T> static Q_ALWAYS_INLINE
-size_t simdSwapLoop(const uchar *src, size_t bytes, uchar *dst) noexcept
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+template <typename T> QT_FUNCTION_TARGET(AVX2)
+static size_t avx2SwapLoop(const uchar *src, size_t bytes, uchar *dst) noexcept
 {
-    auto shuffleMaskPtr = reinterpret_cast<const __m128i *>(shuffleMasks[0]);
-    shuffleMaskPtr += qCountTrailingZeroBits(sizeof(T)) - 1;
-    size_t i = sseSwapLoop(src, bytes, dst, shuffleMaskPtr);
+    size_t i = 0;
+    const __m128i shuffleMask = _mm_load_si128(shuffleMaskFor<T>());
+    const __m256i shuffleMask256 = _mm256_inserti128_si256(_mm256_castsi128_si256(shuffleMask), shuffleMask, 1);
 
-    // epilogue
-    for (size_t _i = 0 ; i < bytes && _i < sizeof(__m128i); i += sizeof(T), _i += sizeof(T))
-        qbswap(qFromUnaligned<T>(src + i), dst + i);
+    for ( ; i + sizeof(__m256i) <= bytes; i += sizeof(__m256i)) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        data = _mm256_shuffle_epi8(data, shuffleMask256);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), data);
+    }
+
+    if (i + sizeof(__m128i) <= bytes) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        data = _mm_shuffle_epi8(data, shuffleMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), data);
+        i += sizeof(__m128i);
+    }
 
-    // return the total, so the bswapLoop below does nothing
-    return bytes;
+    return i;
 }
-#elif defined(__SSE2__)
+#  endif
+#  define QT_ENDIAN_DISPATCH
+#endif
+
+#if defined(__SSE2__)
 template <typename T> static
-size_t simdSwapLoop(const uchar *, size_t, uchar *) noexcept
+size_t sse2SwapLoop(const uchar *, size_t, uchar *) noexcept
 {
     // no generic version: we can't do 32- and 64-bit swaps easily,
     // so we won't try
     return 0;
 }
 
-template <> size_t simdSwapLoop<quint16>(const uchar *src, size_t bytes, uchar *dst) noexcept
+template <> size_t sse2SwapLoop<quint16>(const uchar *src, size_t bytes, uchar *dst) noexcept
 {
     auto swapEndian = [](__m128i &data) {
         __m128i lows = _mm_srli_epi16(data, 8);
@@ -855,18 +866,66 @@ template <> size_t simdSwapLoop<quint16>(const uchar *src, size_t bytes, uchar *
         i += sizeof(__m128i);
     }
 
-    // epilogue
-    for (size_t _i = 0 ; i < bytes && _i < sizeof(__m128i); i += sizeof(quint16), _i += sizeof(quint16))
-        qbswap(qFromUnaligned<quint16>(src + i), dst + i);
+    return i;
+}
+#else
+template <typename T> static
+size_t sse2SwapLoop(const uchar *, size_t, uchar *) noexcept
+{
+    return 0;
+}
+#endif
+
+#ifdef QT_ENDIAN_DISPATCH
+typedef size_t SwapLoopFunction(const uchar *, size_t, uchar *);
 
-    // return the total, so the bswapLoop below does nothing
-    return bytes;
+// The SSSE3 and AVX2 loops are selected at runtime, so that builds for the
+// baseline architecture use them too. All versions return how many bytes
+// they swapped; the scalar loop in bswapLoop() does the rest.
+static const QCpuDispatchVersion<SwapLoopFunction> swapLoop16Versions[] = {
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    { CpuFeatureAVX2, avx2SwapLoop<quint16>, "avx2" },
+#  endif
+    { CpuFeatureSSSE3, ssse3SwapLoop<quint16>, "ssse3" },
+    { 0, sse2SwapLoop<quint16>, "sse2" }
+};
+static const QCpuDispatchVersion<SwapLoopFunction> swapLoop32Versions[] = {
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    { CpuFeatureAVX2, avx2SwapLoop<quint32>, "avx2" },
+#  endif
+    { CpuFeatureSSSE3, ssse3SwapLoop<quint32>, "ssse3" },
+    { 0, sse2SwapLoop<quint32>, "none" }
+};
+static const QCpuDispatchVersion<SwapLoopFunction> swapLoop64Versions[] = {
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    { CpuFeatureAVX2, avx2SwapLoop<quint64>, "avx2" },
+#  endif
+    { CpuFeatureSSSE3, ssse3SwapLoop<quint64>, "ssse3" },
+    { 0, sse2SwapLoop<quint64>, "none" }
+};
+
+static QCpuDispatcher<SwapLoopFunction> swapLoop16 =
+        Q_CPU_DISPATCHER_INITIALIZER("qbswap<2>", swapLoop16Versions);
+static QCpuDispatcher<SwapLoopFunction> swapLoop32 =
+        Q_CPU_DISPATCHER_INITIALIZER("qbswap<4>", swapLoop32Versions);
+static QCpuDispatcher<SwapLoopFunction> swapLoop64 =
+        Q_CPU_DISPATCHER_INITIALIZER("qbswap<8>", swapLoop64Versions);
+
+template <typename T> static Q_ALWAYS_INLINE
+size_t simdSwapLoop(const uchar *src, size_t bytes, uchar *dst) noexcept
+{
+    if (bytes < sizeof(__m128i))
+        return 0;
+
+    QCpuDispatcher<SwapLoopFunction> &dispatcher =
+            sizeof(T) == 2 ? swapLoop16 : sizeof(T) == 4 ? swapLoop32 : swapLoop64;
+    return dispatcher(src, bytes, dst);
 }
 #else
 template <typename T> static Q_ALWAYS_INLINE
-size_t simdSwapLoop(const uchar *, size_t, uchar *) noexcept
+size_t simdSwapLoop(const uchar *src, size_t bytes, uchar *dst) noexcept
 {
-    return 0;
+    return sse2SwapLoop<T>(src, bytes, dst);
 }
 #endif
 
@@ -211,10 +211,23 @@ extern "C" {
 
 f16cextern void qFloatToFloat16_fast(quint16 *out, const float *in, qsizetype len) noexcept;
 f16cextern void qFloatFromFloat16_fast(float *out, const quint16 *in, qsizetype len) noexcept;
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512F)
+f16cextern void qFloatToFloat16_avx512(quint16 *out, const float *in, qsizetype len) noexcept;
+f16cextern void qFloatFromFloat16_avx512(float *out, const quint16 *in, qsizetype len) noexcept;
+#  endif
 
 #undef f16cextern
 }
 
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512F)
+#    define QFLOAT16_HAVE_AVX512
+static inline bool hasAvx512F16()
+{
+    // qCpuHasFeature() only reports AVX512F if the OS saves the ZMM state
+    return qCpuHasFeature(AVX512F);
+}
+#  endif
+
 #elif defined(__ARM_FP16_FORMAT_IEEE) && defined(__ARM_NEON__) && (__ARM_FP & 2)
 static inline bool hasFastF16()
 {
@@ -225,6 +238,12 @@ static void qFloatToFloat16_fast(quint16 *out, const float *in, qsizetype len) n
 {
     __fp16 *out_f16 = reinterpret_cast<__fp16 *>(out);
     qsizetype i = 0;
+#  ifdef Q_PROCESSOR_ARM_64
+    for (; i < len - 7; i += 8) {
+        const float16x4_t low = vcvt_f16_f32(vld1q_f32(in + i));
+        vst1q_f16(out_f16 + i, vcvt_high_f16_f32(low, vld1q_f32(in + i + 4)));
+    }
+#  endif
     for (; i < len - 3; i += 4)
         vst1_f16(out_f16 + i, vcvt_f16_f32(vld1q_f32(in + i)));
     SIMD_EPILOGUE(i, len, 3)
@@ -235,6 +254,13 @@ static void qFloatFromFloat16_fast(float *out, const quint16 *in, qsizetype len)
 {
     const __fp16 *in_f16 = reinterpret_cast<const __fp16 *>(in);
     qsizetype i = 0;
+#  ifdef Q_PROCESSOR_ARM_64
+    for (; i < len - 7; i += 8) {
+        const float16x8_t halves = vld1q_f16(in_f16 + i);
+        vst1q_f32(out + i, vcvt_f32_f16(vget_low_f16(halves)));
+        vst1q_f32(out + i + 4, vcvt_high_f32_f16(halves));
+    }
+#  endif
     for (; i < len - 3; i += 4)
         vst1q_f32(out + i, vcvt_f32_f16(vld1_f16(in_f16 + i)));
     SIMD_EPILOGUE(i, len, 3)
@@ -265,6 +291,10 @@ static void qFloatFromFloat16_fast(float *, const quint16 *, qsizetype) noexcept
 */
 Q_CORE_EXPORT void qFloatToFloat16(qfloat16 *out, const float *in, qsizetype len) noexcept
 {
+#ifdef QFLOAT16_HAVE_AVX512
+    if (len >= 16 && hasAvx512F16())
+        return qFloatToFloat16_avx512(reinterpret_cast<quint16 *>(out), in, len);
+#endif
     if (hasFastF16())
         return qFloatToFloat16_fast(reinterpret_cast<quint16 *>(out), in, len);
 
@@ -281,6 +311,10 @@ Q_CORE_EXPORT void qFloatToFloat16(qfloat16 *out, const float *in, qsizetype len
 */
 Q_CORE_EXPORT void qFloatFromFloat16(float *out, const qfloat16 *in, qsizetype len) noexcept
 {
+#ifdef QFLOAT16_HAVE_AVX512
+    if (len >= 16 && hasAvx512F16())
+        return qFloatFromFloat16_avx512(out, reinterpret_cast<const quint16 *>(in), len);
+#endif
     if (hasFastF16())
         return qFloatFromFloat16_fast(out, reinterpret_cast<const quint16 *>(in), len);
 
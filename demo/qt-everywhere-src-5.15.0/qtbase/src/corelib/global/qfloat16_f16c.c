@@ -85,6 +85,28 @@ void qFloatFromFloat16_fast(float *out, const quint16 *in, qsizetype len) Q_DECL
         out[i] = _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(in[i])));
 }
 
+#if QT_COMPILER_SUPPORTS_HERE(AVX512F)
+// The remaining elements are left to the F16C functions: storing a partial
+// vector of 16-bit elements needs AVX512BW.
+QT_FUNCTION_TARGET(AVX512F)
+void qFloatToFloat16_avx512(quint16 *out, const float *in, qsizetype len) Q_DECL_NOEXCEPT
+{
+    qsizetype i = 0;
+    for (; i < len - 15; i += 16)
+        _mm256_storeu_si256((__m256i *)(out + i), _mm512_cvtps_ph(_mm512_loadu_ps(in + i), 0));
+    qFloatToFloat16_fast(out + i, in + i, len - i);
+}
+
+QT_FUNCTION_TARGET(AVX512F)
+void qFloatFromFloat16_avx512(float *out, const quint16 *in, qsizetype len) Q_DECL_NOEXCEPT
+{
+    qsizetype i = 0;
+    for (; i < len - 15; i += 16)
+        _mm512_storeu_ps(out + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *)(in + i))));
+    qFloatFromFloat16_fast(out + i, in + i, len - i);
+}
+#endif
+
 #ifdef __cplusplus
 } // extern "C"
 QT_END_NAMESPACE
@@ -164,6 +164,14 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
 #include <memory>
 #include <vector>
 
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED) && defined(Q_COMPILER_THREAD_LOCAL)
+#  define QLOGGING_HAVE_ASYNC_OUTPUT
+#  include <chrono>
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
 #include <stdio.h>
 
 QT_BEGIN_NAMESPACE
@@ -1737,6 +1745,202 @@ static bool wasm_default_message_handler(QtMsgType type,
 
 // --------------------------------------------------------------------------
 
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+namespace {
+
+/*
+    Asynchronous stderr output, enabled by setting QT_LOGGING_ASYNC to 1.
+
+    Every thread that logs owns a single-producer/single-consumer ring of
+    formatted records, so posting a message takes no lock. A writer thread
+    drains all rings and writes the records to stderr. When a ring is full,
+    the message is dropped and counted, and the writer reports the number
+    of dropped messages. Order is only kept among the messages of one thread.
+*/
+struct AsyncLogRing
+{
+    enum { Capacity = 256 };
+
+    AsyncLogRing *next = nullptr;
+    QAtomicInt owned{1};
+    QAtomicInteger<quint32> head;   // written by the producer
+    QAtomicInteger<quint32> tail;   // written by the consumer
+    QAtomicInteger<quint32> dropped;
+    QByteArray records[Capacity];
+
+    void push(QByteArray &&record)
+    {
+        const quint32 h = head.loadRelaxed();
+        if (h - tail.loadAcquire() == Capacity) {
+            dropped.fetchAndAddRelaxed(1);
+            return;
+        }
+        records[h % Capacity] = std::move(record);
+        head.storeRelease(h + 1);
+    }
+
+    void drain()
+    {
+        const quint32 h = head.loadAcquire();
+        quint32 t = tail.loadRelaxed();
+        for (; t != h; ++t) {
+            QByteArray &record = records[t % Capacity];
+            fwrite(record.constData(), 1, size_t(record.size()), stderr);
+            record = QByteArray();
+        }
+        tail.storeRelease(t);
+        if (const quint32 n = dropped.fetchAndStoreRelaxed(0))
+            fprintf(stderr, "qt.logging: %u messages dropped by asynchronous output\n", n);
+    }
+};
+
+class AsyncLogWriter
+{
+public:
+    AsyncLogWriter();
+    ~AsyncLogWriter();
+
+    bool isRunning() const { return thread.joinable(); }
+    void post(QByteArray &&record);
+    void flush();
+
+private:
+    AsyncLogRing *acquireRing();
+    void run();
+
+    QAtomicPointer<AsyncLogRing> rings;
+    QAtomicInt pending;
+    bool quit = false;
+    std::mutex drainMutex;      // held by whoever consumes the rings
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::thread thread;
+};
+
+struct AsyncLogRingHolder
+{
+    AsyncLogRing *ring = nullptr;
+    ~AsyncLogRingHolder()
+    {
+        // hand the ring, and whatever it still holds, to the next thread
+        if (ring)
+            ring->owned.storeRelease(0);
+    }
+};
+static thread_local AsyncLogRingHolder asyncLogRing;
+
+AsyncLogWriter::AsyncLogWriter()
+{
+    QT_TRY {
+        thread = std::thread([this] { run(); });
+    } QT_CATCH(...) {
+        // stay synchronous
+    }
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    if (!isRunning())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        quit = true;
+    }
+    wake.notify_one();
+#ifdef Q_OS_WIN
+    // joining a thread while the loader lock is held deadlocks; by the time
+    // static objects of a DLL are destroyed, the other threads are gone
+    thread.detach();
+    flush();
+#else
+    thread.join();
+    for (AsyncLogRing *ring = rings.loadAcquire(); ring; ) {
+        AsyncLogRing *next = ring->next;
+        // rings of threads that are still running stay allocated
+        if (ring->owned.testAndSetAcquire(0, 1))
+            delete ring;
+        ring = next;
+    }
+#endif
+}
+
+AsyncLogRing *AsyncLogWriter::acquireRing()
+{
+    if (asyncLogRing.ring)
+        return asyncLogRing.ring;
+
+    AsyncLogRing *ring = rings.loadAcquire();
+    for (; ring; ring = ring->next) {
+        if (ring->owned.testAndSetAcquire(0, 1))
+            break;
+    }
+    if (!ring) {
+        ring = new AsyncLogRing;
+        AsyncLogRing *first = rings.loadRelaxed();
+        do {
+            ring->next = first;
+        } while (!rings.testAndSetOrdered(first, ring, first));
+    }
+    return asyncLogRing.ring = ring;
+}
+
+void AsyncLogWriter::post(QByteArray &&record)
+{
+    acquireRing()->push(std::move(record));
+
+    // the writer also wakes up periodically, so a notification racing with
+    // the writer going to sleep only delays the output
+    if (!pending.fetchAndStoreRelease(1))
+        wake.notify_one();
+}
+
+void AsyncLogWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(drainMutex);
+    for (AsyncLogRing *ring = rings.loadAcquire(); ring; ring = ring->next)
+        ring->drain();
+    fflush(stderr);
+}
+
+void AsyncLogWriter::run()
+{
+    for (;;) {
+        bool done;
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(100),
+                          [this] { return quit || pending.loadAcquire(); });
+            done = quit;
+        }
+        pending.storeRelease(0);
+        flush();
+        if (done)
+            return;
+    }
+}
+
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(AsyncLogWriter, asyncLogWriter)
+
+static AsyncLogWriter *asyncStderrWriter()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_LOGGING_ASYNC");
+    if (!enabled)
+        return nullptr;
+    AsyncLogWriter *writer = asyncLogWriter();
+    return writer && writer->isRunning() ? writer : nullptr;
+}
+
+static void flushAsyncOutput()
+{
+    if (asyncLogWriter.exists() && !asyncLogWriter.isDestroyed())
+        asyncLogWriter->flush();
+}
+#else
+static void flushAsyncOutput() { }
+#endif // QLOGGING_HAVE_ASYNC_OUTPUT
+
 static void stderr_message_handler(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
     QString formattedMessage = qFormatLogMessage(type, context, message);
@@ -1746,6 +1950,19 @@ static void stderr_message_handler(QtMsgType type, const QMessageLogContext &con
     if (formattedMessage.isNull())
         return;
 
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (!isFatal(type)) {
+        if (AsyncLogWriter *writer = asyncStderrWriter()) {
+            QByteArray record = formattedMessage.toLocal8Bit();
+            record += '\n';
+            writer->post(std::move(record));
+            return;
+        }
+    }
+    // keep earlier messages before a fatal one
+    flushAsyncOutput();
+#endif
+
     fprintf(stderr, "%s\n", formattedMessage.toLocal8Bit().constData());
     fflush(stderr);
 }
@@ -1922,8 +2139,10 @@ static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const
 void qt_message_output(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
 {
     qt_message_print(msgType, context, message);
-    if (isFatal(msgType))
+    if (isFatal(msgType)) {
+        flushAsyncOutput();
         qt_message_fatal(msgType, context, message);
+    }
 }
 
 void qErrnoWarning(const char *msg, ...)
@@ -2009,6 +2228,13 @@ void qErrnoWarning(int code, const char *msg, ...)
 
     To restore the message handler, call \c qInstallMessageHandler(0).
 
+    If the \c QT_LOGGING_ASYNC environment variable is set to \c 1, the
+    default message handler formats messages on the calling thread and
+    leaves writing them to stderr to a background thread. Messages of
+    different threads may then appear out of order, and messages are
+    dropped, and counted, while a thread outruns the output. All pending
+    messages are written before a fatal message.
+
     Example:
 
     \snippet code/src_corelib_global_qglobal.cpp 23
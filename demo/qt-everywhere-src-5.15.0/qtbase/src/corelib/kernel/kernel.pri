@@ -36,6 +36,8 @@ HEADERS += \
         kernel/qcoreglobaldata_p.h \
         kernel/qsharedmemory.h \
         kernel/qsharedmemory_p.h \
+        kernel/qsharedmemoryring_p.h \
+        kernel/qstartuptrace_p.h \
         kernel/qsystemsemaphore.h \
         kernel/qsystemsemaphore_p.h \
         kernel/qfunctions_p.h \
@@ -67,6 +69,8 @@ SOURCES += \
         kernel/qvariant.cpp \
         kernel/qcoreglobaldata.cpp \
         kernel/qsharedmemory.cpp \
+        kernel/qsharedmemoryring.cpp \
+        kernel/qstartuptrace.cpp \
         kernel/qsystemsemaphore.cpp \
         kernel/qpointer.cpp \
         kernel/qmath.cpp \
@@ -59,6 +59,12 @@
 #  include <sys/eventfd.h>
 #endif
 
+#if defined(QT_EVENTDISPATCHER_UNIX_EPOLL)
+#  include <sys/epoll.h>
+#elif defined(QT_EVENTDISPATCHER_UNIX_KQUEUE)
+#  include <sys/event.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -226,12 +232,17 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    initEventQueue();
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
-    // cleanup timers
-    qDeleteAll(timerList);
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    if (eventQueue >= 0)
+        qt_safe_close(eventQueue);
+#endif
 }
 
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
@@ -255,39 +266,217 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
         if (pfd.fd < 0 || pfd.revents == 0)
             continue;
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+        if (pfd.fd == eventQueue) {
+            markQueuedSocketNotifiers();
+            continue;
+        }
+#endif
+
         auto it = socketNotifiers.find(pfd.fd);
         Q_ASSERT(it != socketNotifiers.end());
 
-        const QSocketNotifierSetUNIX &sn_set = it.value();
+        markPendingSocketNotifiers(it.key(), it.value(), pfd.revents);
+    }
 
-        static const struct {
-            QSocketNotifier::Type type;
-            short flags;
-        } notifiers[] = {
-            { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
-            { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
-            { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
-        };
+    pollfds.clear();
+}
 
-        for (const auto &n : notifiers) {
-            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers(int fd, const QSocketNotifierSetUNIX &sn_set,
+                                                             short revents)
+{
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
+
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+
+        if (!notifier)
+            continue;
 
-            if (!notifier)
-                continue;
+        if (revents & POLLNVAL) {
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     fd, socketType(n.type));
+            notifier->setEnabled(false);
+        }
 
-            if (pfd.revents & POLLNVAL) {
-                qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
-                         it.key(), socketType(n.type));
-                notifier->setEnabled(false);
-            }
+        if (revents & n.flags)
+            setSocketNotifierPending(notifier);
+    }
+}
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+bool QEventDispatcherUNIXPrivate::initEventQueue()
+{
+    if (qEnvironmentVariableIsSet("QT_EVENTDISPATCHER_UNIX_POLL"))
+        return false;
+
+#if defined(QT_EVENTDISPATCHER_UNIX_EPOLL)
+    eventQueue = epoll_create1(EPOLL_CLOEXEC);
+#else
+    eventQueue = kqueue();
+    if (eventQueue >= 0)
+        ::fcntl(eventQueue, F_SETFD, FD_CLOEXEC);
+#endif
+    return eventQueue >= 0;
+}
+
+// Changes the events watched for fd in the kernel event queue, returns false
+// if the queue can't watch them
+bool QEventDispatcherUNIXPrivate::queueSocket(int fd, short oldEvents, short newEvents)
+{
+#if defined(QT_EVENTDISPATCHER_UNIX_EPOLL)
+    if (!newEvents) {
+        // fails if fd was closed already, which removed it from the queue
+        if (oldEvents)
+            epoll_ctl(eventQueue, EPOLL_CTL_DEL, fd, nullptr);
+        return true;
+    }
+
+    epoll_event ev = {};
+    ev.data.fd = fd;
+    if (newEvents & POLLIN)
+        ev.events |= EPOLLIN;
+    if (newEvents & POLLOUT)
+        ev.events |= EPOLLOUT;
+    if (newEvents & POLLPRI)
+        ev.events |= EPOLLPRI;
+
+    int ret = epoll_ctl(eventQueue, oldEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    // the socket was closed and its descriptor reused without unregistering
+    // the notifiers first, or it is still open in another descriptor
+    if (ret == -1 && errno == ENOENT)
+        ret = epoll_ctl(eventQueue, EPOLL_CTL_ADD, fd, &ev);
+    else if (ret == -1 && errno == EEXIST)
+        ret = epoll_ctl(eventQueue, EPOLL_CTL_MOD, fd, &ev);
+    // EPERM for regular files, which poll() reports as always ready, and
+    // EBADF for invalid sockets, which poll() reports with POLLNVAL
+    return ret == 0;
+#else
+    // kqueue has no filter for out-of-band data
+    if (newEvents & POLLPRI)
+        return false;
+
+    struct kevent changes[2];
+    int nchanges = 0;
+    if ((oldEvents ^ newEvents) & POLLIN) {
+        EV_SET(&changes[nchanges++], fd, EVFILT_READ,
+               (newEvents & POLLIN) ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+    }
+    if ((oldEvents ^ newEvents) & POLLOUT) {
+        EV_SET(&changes[nchanges++], fd, EVFILT_WRITE,
+               (newEvents & POLLOUT) ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+    }
+    if (!nchanges)
+        return true;
+
+    int ret;
+    EINTR_LOOP(ret, kevent(eventQueue, changes, nchanges, nullptr, 0, nullptr));
+    // deleting the filters of a closed descriptor fails, it was removed
+    return ret == 0 || !newEvents;
+#endif
+}
 
-            if (pfd.revents & n.flags)
-                setSocketNotifierPending(notifier);
+void QEventDispatcherUNIXPrivate::updateQueuedSocket(int fd, QSocketNotifierSetUNIX &sn_set)
+{
+    if (sn_set.polled)
+        return;
+
+    const short events = sn_set.events();
+    if (queueSocket(fd, sn_set.queuedEvents, events)) {
+        sn_set.queuedEvents = events;
+        return;
+    }
+
+    // poll() this socket from now on
+    queueSocket(fd, sn_set.queuedEvents, 0);
+    sn_set.queuedEvents = 0;
+    sn_set.polled = true;
+    polledSockets.append(fd);
+}
+
+void QEventDispatcherUNIXPrivate::unqueueSocket(int fd, QSocketNotifierSetUNIX &sn_set)
+{
+    if (sn_set.polled)
+        polledSockets.removeOne(fd);
+    else
+        queueSocket(fd, sn_set.queuedEvents, 0);
+}
+
+void QEventDispatcherUNIXPrivate::markQueuedSocketNotifiers()
+{
+    // Events are level triggered: those left in the queue are reported by
+    // the next iteration
+    enum { MaxEvents = 256 };
+    bool stale = false;
+    int nevents;
+
+#if defined(QT_EVENTDISPATCHER_UNIX_EPOLL)
+    epoll_event events[MaxEvents];
+    EINTR_LOOP(nevents, epoll_wait(eventQueue, events, MaxEvents, 0));
+#else
+    struct kevent events[MaxEvents];
+    const timespec noWait = { 0, 0 };
+    EINTR_LOOP(nevents, kevent(eventQueue, nullptr, 0, events, MaxEvents, &noWait));
+#endif
+
+    for (int i = 0; i < nevents; ++i) {
+#if defined(QT_EVENTDISPATCHER_UNIX_EPOLL)
+        const int fd = events[i].data.fd;
+        short revents = 0;
+        if (events[i].events & EPOLLIN)
+            revents |= POLLIN;
+        if (events[i].events & EPOLLOUT)
+            revents |= POLLOUT;
+        if (events[i].events & EPOLLPRI)
+            revents |= POLLPRI;
+        if (events[i].events & EPOLLHUP)
+            revents |= POLLHUP;
+        if (events[i].events & EPOLLERR)
+            revents |= POLLERR;
+#else
+        const int fd = int(events[i].ident);
+        short revents = events[i].filter == EVFILT_WRITE ? POLLOUT : POLLIN;
+        if (events[i].flags & EV_EOF)
+            revents |= POLLHUP;
+        if (events[i].flags & EV_ERROR)
+            revents |= POLLERR;
+#endif
+
+        auto it = socketNotifiers.constFind(fd);
+        if (it == socketNotifiers.cend() || it.value().polled) {
+            stale = true;
+            continue;
         }
+        markPendingSocketNotifiers(fd, it.value(), revents);
     }
 
-    pollfds.clear();
+    if (Q_LIKELY(!stale))
+        return;
+
+    // A descriptor closed without unregistering its notifiers stays in an
+    // epoll set while it's open elsewhere: build a new queue to drop it
+    qt_safe_close(eventQueue);
+    eventQueue = -1;
+    if (!initEventQueue()) {
+        // keep going with poll()
+        polledSockets.clear();
+        for (auto it = socketNotifiers.begin(); it != socketNotifiers.end(); ++it)
+            it.value().polled = false;
+        return;
+    }
+    for (auto it = socketNotifiers.begin(); it != socketNotifiers.end(); ++it) {
+        it.value().queuedEvents = 0;
+        updateQueuedSocket(it.key(), it.value());
+    }
 }
+#endif // QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
 
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
 {
@@ -412,6 +601,11 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
                  Q_FUNC_INFO, sockfd, socketType(type));
 
     sn_set.notifiers[type] = notifier;
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    if (d->eventQueue >= 0)
+        d->updateQueuedSocket(sockfd, sn_set);
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -452,6 +646,15 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 
     sn_set.notifiers[type] = nullptr;
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    if (d->eventQueue >= 0) {
+        if (sn_set.isEmpty())
+            d->unqueueSocket(sockfd, sn_set);
+        else
+            d->updateQueuedSocket(sockfd, sn_set);
+    }
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -488,11 +691,27 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
         tm = &wait_tm;
 
     d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    if (d->eventQueue >= 0) {
+        // The queue is readable when one of its sockets is ready, only the
+        // sockets it can't watch are polled
+        d->pollfds.reserve(2 + (include_notifiers ? d->polledSockets.size() : 0));
+
+        if (include_notifiers) {
+            for (int fd : qAsConst(d->polledSockets))
+                d->pollfds.append(qt_make_pollfd(fd, d->socketNotifiers.value(fd).events()));
+            d->pollfds.append(qt_make_pollfd(d->eventQueue, POLLIN));
+        }
+    } else
+#endif
+    {
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+
+        if (include_notifiers)
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+    }
 
     // This must be last, as it's popped off the end below
     d->pollfds.append(d->threadPipe.prepare());
@@ -58,6 +58,18 @@
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+// Socket notifiers are kept registered in a kernel event queue instead of
+// building a pollfd array of all of them on each iteration
+#if defined(Q_OS_LINUX) && !defined(QT_NO_EPOLL)
+#  define QT_EVENTDISPATCHER_UNIX_EPOLL
+#elif (defined(Q_OS_DARWIN) || defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD) \
+       || defined(Q_OS_OPENBSD)) && !defined(QT_NO_KQUEUE)
+#  define QT_EVENTDISPATCHER_UNIX_KQUEUE
+#endif
+#if defined(QT_EVENTDISPATCHER_UNIX_EPOLL) || defined(QT_EVENTDISPATCHER_UNIX_KQUEUE)
+#  define QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -70,6 +82,10 @@ struct Q_CORE_EXPORT QSocketNotifierSetUNIX final
     inline short events() const noexcept;
 
     QSocketNotifier *notifiers[3];
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    short queuedEvents; // events registered in the kernel event queue
+    bool polled;        // the event queue can't watch this socket
+#endif
 };
 
 Q_DECLARE_TYPEINFO(QSocketNotifierSetUNIX, Q_PRIMITIVE_TYPE);
@@ -137,9 +153,23 @@ public:
     int activateTimers();
 
     void markPendingSocketNotifiers();
+    void markPendingSocketNotifiers(int fd, const QSocketNotifierSetUNIX &sn_set, short revents);
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    bool initEventQueue();
+    bool queueSocket(int fd, short oldEvents, short newEvents);
+    void updateQueuedSocket(int fd, QSocketNotifierSetUNIX &sn_set);
+    void unqueueSocket(int fd, QSocketNotifierSetUNIX &sn_set);
+    void markQueuedSocketNotifiers();
+
+    // -1 if the kernel event queue is unavailable, then all the socket
+    // notifiers are polled
+    int eventQueue = -1;
+    QVector<int> polledSockets;
+#endif
+
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
@@ -155,6 +185,10 @@ inline QSocketNotifierSetUNIX::QSocketNotifierSetUNIX() noexcept
     notifiers[0] = nullptr;
     notifiers[1] = nullptr;
     notifiers[2] = nullptr;
+#ifdef QT_EVENTDISPATCHER_UNIX_EVENTQUEUE
+    queuedEvents = 0;
+    polled = false;
+#endif
 }
 
 inline bool QSocketNotifierSetUNIX::isEmpty() const noexcept
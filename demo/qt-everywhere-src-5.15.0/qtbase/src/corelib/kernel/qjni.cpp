@@ -42,14 +42,17 @@
 #include <QtCore/qthreadstorage.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qstringbuilder.h>
 #include <QtCore/QThread>
 #include <QtCore/QReadWriteLock>
 
 QT_BEGIN_NAMESPACE
 
-static inline QLatin1String keyBase()
+// Builds the "<class><name>:<sig>" key of the method and field ID caches in a
+// single allocation; this runs on every cached call.
+static inline QString memberKey(const QByteArray &className, const char *name, const char *sig)
 {
-    return QLatin1String("%1%2:%3");
+    return QLatin1String(className) % QLatin1String(name) % QLatin1Char(':') % QLatin1String(sig);
 }
 
 static QString qt_convertJString(jstring string)
@@ -154,7 +157,7 @@ static jmethodID getCachedMethodID(JNIEnv *env,
     if (className.isEmpty())
         return getMethodID(env, clazz, name, sig, isStatic);
 
-    const QString key = keyBase().arg(QLatin1String(className), QLatin1String(name), QLatin1String(sig));
+    const QString key = memberKey(className, name, sig);
     QHash<QString, jmethodID>::const_iterator it;
 
     {
@@ -206,7 +209,7 @@ static jfieldID getCachedFieldID(JNIEnv *env,
     if (className.isNull())
         return getFieldID(env, clazz, name, sig, isStatic);
 
-    const QString key = keyBase().arg(QLatin1String(className), QLatin1String(name), QLatin1String(sig));
+    const QString key = memberKey(className, name, sig);
     QHash<QString, jfieldID>::const_iterator it;
 
     {
@@ -2383,4 +2386,95 @@ bool QJNIObjectPrivate::isSameObject(const QJNIObjectPrivate &other) const
     return isSameObject(other.d->m_jobject);
 }
 
+QJNIMethodPrivate::QJNIMethodPrivate(const char *className,
+                                     const char *methodName,
+                                     const char *sig,
+                                     Kind kind)
+    : m_jclass(0),
+      m_id(0),
+      m_kind(kind)
+{
+    QJNIEnvironmentPrivate env;
+    // The class cache owns the global ref. and keeps it for the lifetime of the process
+    m_jclass = QJNIEnvironmentPrivate::findClass(className, env);
+    if (m_jclass)
+        m_id = getMethodID(env, m_jclass, methodName, sig, kind == Static);
+}
+
+#define Q_JNI_METHOD_CALL(Type, Name) \
+template <> \
+Q_CORE_EXPORT Type QJNIMethodPrivate::call<Type>(jobject object, const jvalue *args) const \
+{ \
+    Q_ASSERT(m_kind == Instance); \
+    Type res = 0; \
+    if (m_id && object) { \
+        QJNIEnvironmentPrivate env; \
+        res = env->Call##Name##MethodA(object, m_id, args); \
+    } \
+    return res; \
+} \
+\
+template <> \
+Q_CORE_EXPORT Type QJNIMethodPrivate::callStatic<Type>(const jvalue *args) const \
+{ \
+    Q_ASSERT(m_kind == Static); \
+    Type res = 0; \
+    if (m_id) { \
+        QJNIEnvironmentPrivate env; \
+        res = env->CallStatic##Name##MethodA(m_jclass, m_id, args); \
+    } \
+    return res; \
+}
+
+Q_JNI_METHOD_CALL(jboolean, Boolean)
+Q_JNI_METHOD_CALL(jbyte, Byte)
+Q_JNI_METHOD_CALL(jchar, Char)
+Q_JNI_METHOD_CALL(jshort, Short)
+Q_JNI_METHOD_CALL(jint, Int)
+Q_JNI_METHOD_CALL(jlong, Long)
+Q_JNI_METHOD_CALL(jfloat, Float)
+Q_JNI_METHOD_CALL(jdouble, Double)
+
+#undef Q_JNI_METHOD_CALL
+
+template <>
+Q_CORE_EXPORT void QJNIMethodPrivate::call<void>(jobject object, const jvalue *args) const
+{
+    Q_ASSERT(m_kind == Instance);
+    if (m_id && object) {
+        QJNIEnvironmentPrivate env;
+        env->CallVoidMethodA(object, m_id, args);
+    }
+}
+
+template <>
+Q_CORE_EXPORT void QJNIMethodPrivate::callStatic<void>(const jvalue *args) const
+{
+    Q_ASSERT(m_kind == Static);
+    if (m_id) {
+        QJNIEnvironmentPrivate env;
+        env->CallStaticVoidMethodA(m_jclass, m_id, args);
+    }
+}
+
+QJNIObjectPrivate QJNIMethodPrivate::callObject(jobject object, const jvalue *args) const
+{
+    Q_ASSERT(m_kind == Instance);
+    if (!m_id || !object)
+        return QJNIObjectPrivate();
+
+    QJNIEnvironmentPrivate env;
+    return QJNIObjectPrivate::fromLocalRef(env->CallObjectMethodA(object, m_id, args));
+}
+
+QJNIObjectPrivate QJNIMethodPrivate::callStaticObject(const jvalue *args) const
+{
+    Q_ASSERT(m_kind == Static);
+    if (!m_id)
+        return QJNIObjectPrivate();
+
+    QJNIEnvironmentPrivate env;
+    return QJNIObjectPrivate::fromLocalRef(env->CallStaticObjectMethodA(m_jclass, m_id, args));
+}
+
 QT_END_NAMESPACE
@@ -252,6 +252,37 @@ private:
     QSharedPointer<QJNIObjectData> d;
 };
 
+// A Java method resolved once: the class and the method ID are looked up at
+// construction, so call() and callStatic() go straight to JNI, with the
+// arguments passed as an array instead of being parsed from a signature.
+// Handles are cheap to copy and can be used from any thread.
+class Q_CORE_EXPORT QJNIMethodPrivate
+{
+public:
+    enum Kind { Instance, Static };
+
+    QJNIMethodPrivate(const char *className,
+                      const char *methodName,
+                      const char *sig,
+                      Kind kind = Instance);
+
+    bool isValid() const { return m_id != 0; }
+    jclass objectClass() const { return m_jclass; }
+    jmethodID methodID() const { return m_id; }
+
+    template <typename T>
+    T call(jobject object, const jvalue *args = nullptr) const;
+    QJNIObjectPrivate callObject(jobject object, const jvalue *args = nullptr) const;
+    template <typename T>
+    T callStatic(const jvalue *args = nullptr) const;
+    QJNIObjectPrivate callStaticObject(const jvalue *args = nullptr) const;
+
+private:
+    jclass m_jclass;
+    jmethodID m_id;
+    Kind m_kind;
+};
+
 inline bool operator==(const QJNIObjectPrivate&obj1, const QJNIObjectPrivate&obj2)
 {
     return obj1.isSameObject(obj2);
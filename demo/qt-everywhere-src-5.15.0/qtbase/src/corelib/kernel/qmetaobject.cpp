@@ -46,6 +46,7 @@
 #include <qcoreapplication.h>
 #include <qcoreevent.h>
 #include <qdatastream.h>
+#include <qhashfunctions.h>
 #include <qstringlist.h>
 #include <qthread.h>
 #include <qvariant.h>
@@ -1386,6 +1387,114 @@ static inline QByteArray findMethodCandidates(const QMetaObject *metaObject, con
     return candidateMessage;
 }
 
+/*
+    Cache of the method indexes found by QMetaObject::invokeMethod(), keyed by
+    the metaobject and the signature built from the member name and the
+    argument type names, so that repeated invocations skip the signature
+    parsing, the normalization and the linear search.
+
+    Entries are never replaced nor freed, so lookups need no locking; once the
+    probed slots for a signature are taken, it is looked up the slow way.
+    Since metaobjects built at runtime can be freed and their address reused,
+    a hit is only accepted if the method at the cached index still has the
+    same name and the same type data.
+*/
+namespace {
+struct InvokeCacheEntry
+{
+    const QMetaObject *meta;
+    int index;
+    int argc;
+    uint types[MaximumParamCount]; // return type, then parameter types
+    int length;
+    char signature[1];
+};
+}
+
+enum { InvokeCacheSize = 1024, InvokeCacheProbes = 4 };
+static QBasicAtomicPointer<InvokeCacheEntry> invokeCache[InvokeCacheSize];
+
+// Returns the type data of the method at the absolute \a index of \a meta and
+// stores its name and parameter count, or returns nullptr if it has too many
+// parameters to be cached.
+static const uint *invokeCacheMethodData(const QMetaObject *meta, int index,
+                                         QByteArray *name, int *argc)
+{
+    const QMetaObject *m = meta;
+    int offset = m->methodOffset();
+    while (index < offset) {
+        m = m->d.superdata;
+        offset -= priv(m->d.data)->methodCount;
+    }
+    const int handle = priv(m->d.data)->methodData + 5 * (index - offset);
+    *name = stringData(m, m->d.data[handle]);
+    *argc = int(m->d.data[handle + 1]);
+    if (*argc >= MaximumParamCount)
+        return nullptr;
+    return m->d.data + m->d.data[handle + 2];
+}
+
+static int cachedIndexOfMethod(const QMetaObject *meta, const char *member, int memberLength,
+                               const char *signature, int length)
+{
+    const uint h = qHashBits(signature, length, qHash(quintptr(meta)));
+    for (int i = 0; i < InvokeCacheProbes; ++i) {
+        const InvokeCacheEntry *e = invokeCache[(h + i) % InvokeCacheSize].loadAcquire();
+        if (!e)
+            break;
+        if (e->meta != meta || e->length != length
+                || memcmp(e->signature, signature, length) != 0) {
+            continue;
+        }
+
+        QByteArray name;
+        int argc;
+        if (e->index >= meta->methodCount())
+            return -1;
+        const uint *types = invokeCacheMethodData(meta, e->index, &name, &argc);
+        if (!types || argc != e->argc || name.size() != memberLength
+                || memcmp(name.constData(), member, memberLength) != 0
+                || memcmp(types, e->types, (argc + 1) * sizeof(uint)) != 0) {
+            return -1;
+        }
+        return e->index;
+    }
+    return -1;
+}
+
+static void cacheIndexOfMethod(const QMetaObject *meta, const char *signature, int length,
+                               int index)
+{
+    QByteArray name;
+    int argc;
+    const uint *types = invokeCacheMethodData(meta, index, &name, &argc);
+    if (!types)
+        return;
+
+    InvokeCacheEntry *e = nullptr;
+    const uint h = qHashBits(signature, length, qHash(quintptr(meta)));
+    for (int i = 0; i < InvokeCacheProbes; ++i) {
+        QBasicAtomicPointer<InvokeCacheEntry> &slot = invokeCache[(h + i) % InvokeCacheSize];
+        if (slot.loadRelaxed())
+            continue;
+        if (!e) {
+            e = static_cast<InvokeCacheEntry *>(malloc(sizeof(InvokeCacheEntry) + length));
+            if (!e)
+                return;
+            e->meta = meta;
+            e->index = index;
+            e->argc = argc;
+            memcpy(e->types, types, (argc + 1) * sizeof(uint));
+            e->length = length;
+            memcpy(e->signature, signature, length);
+            e->signature[length] = '\0';
+        }
+        if (slot.testAndSetRelease(nullptr, e))
+            return;
+    }
+    free(e);
+}
+
 /*!
     \threadsafe
 
@@ -1452,6 +1561,11 @@ static inline QByteArray findMethodCandidates(const QMetaObject *metaObject, con
     If the "compute" slot does not take exactly one QString, one int
     and one double in the specified order, the call will fail.
 
+    The method found for a given member name and set of argument types is
+    cached, so repeated invocations do not search for it again. To skip the
+    lookup entirely, retrieve the QMetaMethod once, for instance with
+    indexOfMethod() and method(), and call QMetaMethod::invoke() on it.
+
     \sa Q_ARG(), Q_RETURN_ARG(), qRegisterMetaType(), QMetaMethod::invoke()
 */
 bool QMetaObject::invokeMethod(QObject *obj,
@@ -1473,10 +1587,10 @@ bool QMetaObject::invokeMethod(QObject *obj,
         return false;
 
     QVarLengthArray<char, 512> sig;
-    int len = qstrlen(member);
-    if (len <= 0)
+    const int memberLength = qstrlen(member);
+    if (memberLength <= 0)
         return false;
-    sig.append(member, len);
+    sig.append(member, memberLength);
     sig.append('(');
 
     const char *typeNames[] = {ret.name(), val0.name(), val1.name(), val2.name(), val3.name(),
@@ -1485,7 +1599,7 @@ bool QMetaObject::invokeMethod(QObject *obj,
 
     int paramCount;
     for (paramCount = 1; paramCount < MaximumParamCount; ++paramCount) {
-        len = qstrlen(typeNames[paramCount]);
+        const int len = qstrlen(typeNames[paramCount]);
         if (len <= 0)
             break;
         sig.append(typeNames[paramCount], len);
@@ -1498,10 +1612,15 @@ bool QMetaObject::invokeMethod(QObject *obj,
     sig.append('\0');
 
     const QMetaObject *meta = obj->metaObject();
-    int idx = meta->indexOfMethod(sig.constData());
+    int idx = cachedIndexOfMethod(meta, member, memberLength, sig.constData(), sig.size() - 1);
     if (idx < 0) {
-        QByteArray norm = QMetaObject::normalizedSignature(sig.constData());
-        idx = meta->indexOfMethod(norm.constData());
+        idx = meta->indexOfMethod(sig.constData());
+        if (idx < 0) {
+            QByteArray norm = QMetaObject::normalizedSignature(sig.constData());
+            idx = meta->indexOfMethod(norm.constData());
+        }
+        if (idx >= 0 && idx < meta->methodCount())
+            cacheIndexOfMethod(meta, sig.constData(), sig.size() - 1, idx);
     }
 
     if (idx < 0 || idx >= meta->methodCount()) {
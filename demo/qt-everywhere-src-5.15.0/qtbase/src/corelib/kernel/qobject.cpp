@@ -3722,14 +3722,13 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     while (argumentTypes[nargs-1])
         ++nargs;
 
-    QBasicMutexLocker locker(signalSlotLock(c->receiver.loadRelaxed()));
-    if (!c->receiver.loadRelaxed()) {
-        // the connection has been disconnected before we got the lock
+    // activate() holds a reference to the sender's connection data, so even if
+    // the connection gets disconnected now, it and its slot object stay around
+    // as an orphan until the emission is over. Only posting needs the lock.
+    if (!c->receiver.loadAcquire())
         return;
-    }
     if (c->isSlotObject)
         c->slotObj->ref();
-    locker.unlock();
 
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs) :
@@ -3749,7 +3748,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
             args[n] = QMetaType::create(types[n], argv[n]);
     }
 
-    locker.relock();
+    QBasicMutexLocker locker(signalSlotLock(c->receiver.loadRelaxed()));
     if (c->isSlotObject)
         c->slotObj->destroyIfLastRef();
     if (!c->receiver.loadRelaxed()) {
@@ -3811,6 +3810,7 @@ void doActivate(QObject *sender, int signal_index, void **argv)
 
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
     bool inSenderThread = currentThreadId == QObjectPrivate::get(sender)->threadData.loadRelaxed()->threadId.loadRelaxed();
+    QThreadData *currentThreadData = inSenderThread ? nullptr : QThreadData::current(false);
 
     // We need to check against the highest connection id to ensure that signals added
     // during the signal emission are not emitted in this emission.
@@ -3833,9 +3833,11 @@ void doActivate(QObject *sender, int signal_index, void **argv)
             if (inSenderThread) {
                 receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
             } else {
-                // need to lock before reading the threadId, because moveToThread() could interfere
-                QMutexLocker lock(signalSlotLock(receiver));
-                receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
+                // Compare the thread data instead of locking the receiver to read its
+                // threadId: an object can only be moved away from the thread it lives in,
+                // so if the receiver lives in this one, td cannot change under us. Not
+                // dereferencing td also keeps a concurrent moveToThread() from freeing it.
+                receiverInSameThread = td == currentThreadData;
             }
 
 
@@ -0,0 +1,393 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsharedmemoryring_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qmath.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+#if !defined(QT_NO_SHAREDMEMORY) && !defined(QT_NO_SYSTEMSEMAPHORE)
+
+/*
+    The segment starts with this header, followed by the ring buffer itself.
+    The producer owns head and the consumer owns tail; they are free-running
+    byte counters, so head - tail is the number of bytes in use even after
+    they wrap around. They are kept on separate cache lines, so the two sides
+    don't contend for one line on every message.
+
+    Each message is stored as a 32-bit length, 4 reserved bytes, and the
+    payload, padded to 8 bytes. A message never wraps around the end of the
+    buffer: if it doesn't fit before the end, the producer stores WrapMarker
+    as the length and continues at the start of the buffer. That's what lets
+    readers access a message in place.
+*/
+struct QSharedMemoryRingHeader
+{
+    QBasicAtomicInteger<quint32> magic;
+    quint32 capacity;
+    char padding0[56];
+    QBasicAtomicInteger<quint32> head;
+    QBasicAtomicInt consumerWaiting;
+    char padding1[56];
+    QBasicAtomicInteger<quint32> tail;
+    QBasicAtomicInt producerWaiting;
+    char padding2[56];
+};
+
+enum : quint32 {
+    RingMagic = 0x51524e47,     // "QRNG"
+    RecordHeaderSize = 8,
+    WrapMarker = 0xffffffff,
+    MinimumCapacity = 64,
+    MaximumCapacity = 1U << 30
+};
+
+static inline quint32 recordSize(quint32 size)
+{
+    return (RecordHeaderSize + size + 7) & ~7U;
+}
+
+static inline QString semaphoreKey(const QString &key, const char *suffix)
+{
+    return key + QLatin1String(suffix);
+}
+
+/*!
+    \class QSharedMemoryRing
+    \inmodule QtCore
+    \internal
+    \since 5.15
+
+    \brief The QSharedMemoryRing class passes variable-length messages from
+    one process to another through shared memory.
+
+    A ring has exactly one producer and one consumer, identified by the same
+    \a key. One of them calls create() and the other attach(). Messages are
+    copied into the shared segment by write() or tryWrite(), and the consumer
+    accesses them in place: read() and tryRead() return a pointer to the
+    message inside the segment, which remains valid until release() is
+    called. Neither side takes a lock; a side only sleeps on a
+    QSystemSemaphore when the ring is empty or full, and the other side only
+    signals it when it is actually waiting.
+
+    The blocking functions wait without a timeout. If the peer process dies,
+    a blocked read() or write() does not return.
+*/
+
+/*!
+    Constructs a ring for \a key, used from the side given by \a role. The
+    ring is unusable until create() or attach() succeeds.
+*/
+QSharedMemoryRing::QSharedMemoryRing(const QString &key, Role role)
+    : memory(key),
+      dataAvailable(QString()),
+      spaceAvailable(QString()),
+      ringKey(key),
+      ringRole(role)
+{
+}
+
+/*!
+    Detaches from the segment.
+
+    \sa detach()
+*/
+QSharedMemoryRing::~QSharedMemoryRing()
+{
+    detach();
+}
+
+/*!
+    Creates the shared segment with room for \a capacity bytes of messages,
+    rounded up to a power of two, and attaches to it. Returns \c true on
+    success; otherwise returns \c false and sets errorString().
+*/
+bool QSharedMemoryRing::create(qsizetype capacity)
+{
+    if (isAttached()) {
+        error = QCoreApplication::translate("QSharedMemoryRing", "already attached");
+        return false;
+    }
+    if (capacity <= 0 || capacity > qsizetype(MaximumCapacity)) {
+        error = QCoreApplication::translate("QSharedMemoryRing", "invalid capacity");
+        return false;
+    }
+    const quint32 size = qMax(qNextPowerOfTwo(quint32(capacity - 1)), quint32(MinimumCapacity));
+    if (!memory.create(int(sizeof(QSharedMemoryRingHeader) + size))) {
+        error = memory.errorString();
+        return false;
+    }
+
+    header = static_cast<QSharedMemoryRingHeader *>(memory.data());
+    buffer = reinterpret_cast<char *>(header + 1);
+    header->capacity = size;
+    header->head.storeRelaxed(0);
+    header->tail.storeRelaxed(0);
+    header->consumerWaiting.storeRelaxed(0);
+    header->producerWaiting.storeRelaxed(0);
+    if (!setUp(QSystemSemaphore::Create))
+        return false;
+    // publish the header last, so a peer attaching concurrently doesn't
+    // see a half-initialized ring
+    header->magic.storeRelease(RingMagic);
+    return true;
+}
+
+/*!
+    Attaches to a segment that the other side created. Returns \c true on
+    success; otherwise returns \c false and sets errorString().
+*/
+bool QSharedMemoryRing::attach()
+{
+    if (isAttached()) {
+        error = QCoreApplication::translate("QSharedMemoryRing", "already attached");
+        return false;
+    }
+    if (!memory.attach()) {
+        error = memory.errorString();
+        return false;
+    }
+
+    header = static_cast<QSharedMemoryRingHeader *>(memory.data());
+    buffer = reinterpret_cast<char *>(header + 1);
+    const qsizetype available = memory.size() - qsizetype(sizeof(QSharedMemoryRingHeader));
+    if (available < 0 || header->magic.loadAcquire() != RingMagic
+            || header->capacity < MinimumCapacity || header->capacity > MaximumCapacity
+            || (header->capacity & (header->capacity - 1)) || available < qsizetype(header->capacity)) {
+        error = QCoreApplication::translate("QSharedMemoryRing", "not a message ring");
+        detach();
+        return false;
+    }
+    return setUp(QSystemSemaphore::Open);
+}
+
+bool QSharedMemoryRing::setUp(QSystemSemaphore::AccessMode mode)
+{
+    dataAvailable.setKey(semaphoreKey(ringKey, "_qsmr_data"), 0, mode);
+    spaceAvailable.setKey(semaphoreKey(ringKey, "_qsmr_space"), 0, mode);
+    if (dataAvailable.error() != QSystemSemaphore::NoError) {
+        error = dataAvailable.errorString();
+    } else if (spaceAvailable.error() != QSystemSemaphore::NoError) {
+        error = spaceAvailable.errorString();
+    } else {
+        error.clear();
+        return true;
+    }
+    if (mode == QSystemSemaphore::Create) {
+        memory.detach();
+        header = nullptr;
+        buffer = nullptr;
+    } else {
+        detach();
+    }
+    return false;
+}
+
+/*!
+    Detaches from the shared segment. A message leased by tryRead() or
+    read() is released first.
+*/
+void QSharedMemoryRing::detach()
+{
+    if (!header)
+        return;
+    if (leased)
+        release();
+    memory.detach();
+    header = nullptr;
+    buffer = nullptr;
+}
+
+/*!
+    Returns the size of the ring buffer in bytes, or 0 if not attached.
+*/
+qsizetype QSharedMemoryRing::capacity() const
+{
+    return header ? qsizetype(header->capacity) : 0;
+}
+
+bool QSharedMemoryRing::checkMessageSize(qsizetype size)
+{
+    if (size < 0 || size > maxMessageSize()) {
+        error = QCoreApplication::translate("QSharedMemoryRing", "invalid message size");
+        return false;
+    }
+    return true;
+}
+
+/*!
+    Copies the \a size bytes at \a data into the ring as one message, if
+    there is room for it. Returns \c false if the ring is too full or \a size
+    is larger than maxMessageSize().
+*/
+bool QSharedMemoryRing::tryWrite(const char *data, qsizetype size)
+{
+    Q_ASSERT(header && ringRole == Producer);
+    if (!checkMessageSize(size))
+        return false;
+
+    const quint32 capacity = header->capacity;
+    const quint32 head = header->head.loadRelaxed();
+    const quint32 tail = header->tail.loadAcquire();
+    const quint32 needed = recordSize(quint32(size));
+    const quint32 offset = head & (capacity - 1);
+    const quint32 skip = capacity - offset < needed ? capacity - offset : 0;
+    if (capacity - (head - tail) < skip + needed)
+        return false;
+
+    if (skip)
+        *reinterpret_cast<quint32 *>(buffer + offset) = WrapMarker;
+    char *record = buffer + ((head + skip) & (capacity - 1));
+    *reinterpret_cast<quint32 *>(record) = quint32(size);
+    memcpy(record + RecordHeaderSize, data, size_t(size));
+    header->head.storeRelease(head + skip + needed);
+
+    if (header->consumerWaiting.fetchAndStoreOrdered(0))
+        dataAvailable.release();
+    return true;
+}
+
+/*!
+    Copies the \a size bytes at \a data into the ring as one message, waiting
+    until the consumer has made room for it. Returns \c false if \a size is
+    larger than maxMessageSize() or waiting failed.
+*/
+bool QSharedMemoryRing::write(const char *data, qsizetype size)
+{
+    if (!checkMessageSize(size))
+        return false;
+    while (!tryWrite(data, size)) {
+        // announce that we are going to sleep, then check again: either the
+        // consumer sees the flag after releasing space, or we see the space
+        header->producerWaiting.fetchAndStoreOrdered(1);
+        if (tryWrite(data, size))
+            break;
+        if (!spaceAvailable.acquire()) {
+            error = spaceAvailable.errorString();
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+    Returns a pointer to the oldest message in the ring and stores its size
+    in \a size, or returns \c nullptr if the ring is empty. The message stays
+    in the ring, and the pointer valid, until release() is called; calling
+    this function again before that returns the same message.
+*/
+const char *QSharedMemoryRing::tryRead(qsizetype *size)
+{
+    Q_ASSERT(header && ringRole == Consumer);
+    Q_ASSERT(size);
+    const quint32 capacity = header->capacity;
+    const quint32 tail = header->tail.loadRelaxed();
+    const quint32 used = header->head.loadAcquire() - tail;
+    if (used == 0)
+        return nullptr;
+
+    // the header is shared with another process, so don't trust it
+    quint32 offset = tail & (capacity - 1);
+    quint32 length = *reinterpret_cast<const quint32 *>(buffer + offset);
+    quint32 skip = 0;
+    if (length == WrapMarker) {
+        skip = capacity - offset;
+        offset = 0;
+        length = *reinterpret_cast<const quint32 *>(buffer);
+    }
+    if (length > capacity || skip + recordSize(length) > used) {
+        error = QCoreApplication::translate("QSharedMemoryRing", "corrupt message ring");
+        return nullptr;
+    }
+
+    leased = skip + recordSize(length);
+    *size = qsizetype(length);
+    return buffer + offset + RecordHeaderSize;
+}
+
+/*!
+    Returns a pointer to the oldest message in the ring and stores its size
+    in \a size, waiting for the producer to write one if the ring is empty.
+    Returns \c nullptr if waiting failed.
+
+    \sa tryRead(), release()
+*/
+const char *QSharedMemoryRing::read(qsizetype *size)
+{
+    error.clear();
+    for (;;) {
+        if (const char *message = tryRead(size))
+            return message;
+        if (!error.isEmpty())
+            return nullptr;
+        header->consumerWaiting.fetchAndStoreOrdered(1);
+        if (const char *message = tryRead(size))
+            return message;
+        if (!dataAvailable.acquire()) {
+            error = dataAvailable.errorString();
+            return nullptr;
+        }
+    }
+}
+
+/*!
+    Removes the message returned by the last call to tryRead() or read()
+    from the ring, making its space available to the producer again.
+*/
+void QSharedMemoryRing::release()
+{
+    Q_ASSERT(header && ringRole == Consumer);
+    if (!leased)
+        return;
+    header->tail.storeRelease(header->tail.loadRelaxed() + leased);
+    leased = 0;
+
+    if (header->producerWaiting.fetchAndStoreOrdered(0))
+        spaceAvailable.release();
+}
+
+#endif // !QT_NO_SHAREDMEMORY && !QT_NO_SYSTEMSEMAPHORE
+
+QT_END_NAMESPACE
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSHAREDMEMORYRING_P_H
+#define QSHAREDMEMORYRING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qsharedmemory.h>
+#include <QtCore/qsystemsemaphore.h>
+
+QT_BEGIN_NAMESPACE
+
+#if !defined(QT_NO_SHAREDMEMORY) && !defined(QT_NO_SYSTEMSEMAPHORE)
+
+struct QSharedMemoryRingHeader;
+
+class Q_CORE_EXPORT QSharedMemoryRing
+{
+public:
+    enum Role {
+        Producer,
+        Consumer
+    };
+
+    explicit QSharedMemoryRing(const QString &key, Role role);
+    ~QSharedMemoryRing();
+
+    bool create(qsizetype capacity);
+    bool attach();
+    void detach();
+    bool isAttached() const { return header != nullptr; }
+
+    QString key() const { return ringKey; }
+    Role role() const { return ringRole; }
+    qsizetype capacity() const;
+    qsizetype maxMessageSize() const { return capacity() / 2 - 8; }
+    QString errorString() const { return error; }
+
+    // producer side
+    bool tryWrite(const char *data, qsizetype size);
+    bool write(const char *data, qsizetype size);
+
+    // consumer side
+    const char *tryRead(qsizetype *size);
+    const char *read(qsizetype *size);
+    void release();
+
+private:
+    bool setUp(QSystemSemaphore::AccessMode mode);
+    bool checkMessageSize(qsizetype size);
+
+    QSharedMemory memory;
+    QSystemSemaphore dataAvailable;
+    QSystemSemaphore spaceAvailable;
+    QString ringKey;
+    QString error;
+    QSharedMemoryRingHeader *header = nullptr;
+    char *buffer = nullptr;
+    quint32 leased = 0;     // bytes the current read lease covers
+    Role ringRole;
+
+    Q_DISABLE_COPY(QSharedMemoryRing)
+};
+
+#endif // !QT_NO_SHAREDMEMORY && !QT_NO_SYSTEMSEMAPHORE
+
+QT_END_NAMESPACE
+
+#endif // QSHAREDMEMORYRING_P_H
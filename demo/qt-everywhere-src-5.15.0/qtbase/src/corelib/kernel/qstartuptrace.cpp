@@ -0,0 +1,187 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qstartuptrace_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct QStartupTraceFile
+{
+    QStartupTraceFile()
+    {
+        const QString fileName = qEnvironmentVariable("QT_STARTUP_TRACE");
+        if (fileName.isEmpty())
+            return;
+        // With Append, each unbuffered write() is appended atomically, so
+        // other writers can share the file (e.g. Python's
+        // $PYTHONSTARTUPTRACE). Only the first one starts the array.
+        file.setFileName(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+            qWarning("QT_STARTUP_TRACE: cannot open %s: %s", qPrintable(fileName),
+                     qPrintable(file.errorString()));
+            return;
+        }
+        if (file.size() == 0)
+            file.write("[\n", 2);
+        enabled = true;
+    }
+
+    QBasicMutex mutex;
+    QFile file;
+    bool enabled = false;
+};
+}
+
+Q_GLOBAL_STATIC(QStartupTraceFile, startupTraceFile)
+
+static void appendJsonString(QByteArray &out, const QString &str)
+{
+    const QByteArray utf8 = str.toUtf8();
+    for (char c : utf8) {
+        const uchar ch = uchar(c);
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += c;
+        } else if (ch < 0x20) {
+            static const char hexDigits[] = "0123456789abcdef";
+            out += "\\u00";
+            out += hexDigits[ch >> 4];
+            out += hexDigits[ch & 0xf];
+        } else {
+            out += c;
+        }
+    }
+}
+
+/*!
+    \class QStartupTrace
+    \inmodule QtCore
+    \internal
+    \since 5.15
+
+    \brief The QStartupTrace class records how long the steps of starting an
+    application take.
+
+    If the \c QT_STARTUP_TRACE environment variable names a file, each call
+    to addEvent() appends a "complete" event of the Chrome trace event format
+    to it, which can be opened with chrome://tracing or Perfetto. The file
+    uses the JSON array format, whose closing bracket is optional, and the
+    events are timestamped with the monotonic clock in microseconds, so other
+    libraries of the same process can write their own events to the same
+    file. An embedded Python interpreter does so with \c PYTHONSTARTUPTRACE.
+
+    Only steps that happen once, or once per file, should be traced: the
+    events are written as they happen, without buffering.
+
+    QStartupTraceScope records the event of its own lifetime.
+*/
+
+/*!
+    Returns \c true if \c QT_STARTUP_TRACE names a file that could be opened.
+*/
+bool QStartupTrace::isEnabled()
+{
+    QStartupTraceFile *traceFile = startupTraceFile();
+    return traceFile && traceFile->enabled;
+}
+
+/*!
+    Returns the current time of the monotonic clock in nanoseconds, to be
+    passed to addEvent() as the start of an event.
+*/
+qint64 QStartupTrace::timestamp()
+{
+    return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+/*!
+    Appends the event \a name of \a category, which started at \a start
+    (see timestamp()) and ends now. This function is thread-safe.
+*/
+void QStartupTrace::addEvent(const char *category, const QString &name, qint64 start)
+{
+    const qint64 end = timestamp();
+    QStartupTraceFile *traceFile = startupTraceFile();
+    if (!traceFile || !traceFile->enabled)
+        return;
+
+    QByteArray event;
+    event.reserve(160 + name.size());
+    event += "{\"name\":\"";
+    appendJsonString(event, name);
+    event += "\",\"cat\":\"";
+    event += category;
+    event += "\",\"ph\":\"X\",\"ts\":";
+    event += QByteArray::number(start / 1000);
+    event += ",\"dur\":";
+    event += QByteArray::number((end - start + 999) / 1000);
+    event += ",\"pid\":";
+    event += QByteArray::number(QCoreApplication::applicationPid());
+    event += ",\"tid\":";
+    event += QByteArray::number(quintptr(QThread::currentThreadId()));
+    event += "},\n";
+
+    QMutexLocker locker(&traceFile->mutex);
+    traceFile->file.write(event);
+}
+
+/*!
+    \class QStartupTraceScope
+    \inmodule QtCore
+    \internal
+    \since 5.15
+
+    \brief The QStartupTraceScope class records the event of its lifetime in
+    the startup trace.
+
+    The constructor takes the \a category and \a name of the event, and
+    does nothing else unless the startup trace is enabled.
+
+    \sa QStartupTrace
+*/
+
+QT_END_NAMESPACE
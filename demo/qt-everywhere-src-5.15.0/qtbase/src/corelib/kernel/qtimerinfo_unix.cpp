@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qalgorithms.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -62,6 +63,17 @@ Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
  * timerBitVec array is used for keeping track of timer identifiers.
  */
 
+// the wheel works in milliseconds, rounding up so that no timer fires early
+static inline qint64 wheelMSecs(const timespec &t)
+{
+    return qint64(t.tv_sec) * 1000 + (t.tv_nsec + 999999) / (1000 * 1000);
+}
+
+static inline qint64 currentMSecs(const timespec &t)
+{
+    return qint64(t.tv_sec) * 1000 + t.tv_nsec / (1000 * 1000);
+}
+
 QTimerInfoList::QTimerInfoList()
 {
 #if (_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC) && !defined(Q_OS_NACL)
@@ -83,7 +95,17 @@ QTimerInfoList::QTimerInfoList()
     }
 #endif
 
-    firstTimerInfo = nullptr;
+    wheelTime = currentMSecs(qt_gettime());
+    for (int i = 0; i < WheelSlots; ++i)
+        wheel[i] = nullptr;
+    for (int i = 0; i < WheelLevels; ++i)
+        wheelBits[i] = 0;
+    activation = 0;
+}
+
+QTimerInfoList::~QTimerInfoList()
+{
+    qDeleteAll(timers);
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -150,11 +172,18 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 */
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    // repair all timers, the wheel is rebuilt from the current time
+    QVector<QTimerInfo *> queued;
+    for (QTimerInfo *t : qAsConst(timers)) {
         t->timeout = t->timeout + diff;
+        if (t->position != NoPosition) {
+            timerRemove(t);
+            queued.append(t);
+        }
     }
+    wheelTime = currentMSecs(currentTime);
+    for (QTimerInfo *t : qAsConst(queued))
+        timerInsert(t);
 }
 
 void QTimerInfoList::repairTimersIfNeeded()
@@ -174,18 +203,259 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+/*
+  The precise timers are in a binary heap ordered by timeout.
+*/
+inline void QTimerInfoList::heapMove(QTimerInfo *t, int index)
+{
+    preciseTimers[index] = t;
+    t->position = index;
+}
+
+void QTimerInfoList::heapUp(int index)
+{
+    QTimerInfo *t = preciseTimers.at(index);
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        QTimerInfo *p = preciseTimers.at(parent);
+        if (!(t->timeout < p->timeout))
+            break;
+        heapMove(p, index);
+        index = parent;
+    }
+    heapMove(t, index);
+}
+
+void QTimerInfoList::heapDown(int index)
+{
+    QTimerInfo *t = preciseTimers.at(index);
+    const int count = preciseTimers.size();
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count
+            && preciseTimers.at(child + 1)->timeout < preciseTimers.at(child)->timeout)
+            ++child;
+        QTimerInfo *c = preciseTimers.at(child);
+        if (!(c->timeout < t->timeout))
+            break;
+        heapMove(c, index);
+        index = child;
+    }
+    heapMove(t, index);
+}
+
+/*
+  The coarse and very coarse timers are in a hierarchical timer wheel of
+  WheelLevels levels of WheelLevelSlots slots. A slot of level n holds the
+  timers of one span of WheelLevelSlots^n milliseconds: the slots of level 0
+  are expired as wheelTime reaches them, and each time level n wraps around,
+  the next slot of level n + 1 is cascaded down into the lower levels. The
+  wheel keeps the millisecond of every timeout, so no timer fires early or
+  late because of it.
+*/
+void QTimerInfoList::wheelAppend(QTimerInfo *t, int slot)
+{
+    QTimerInfo *&head = wheel[slot];
+    const qint64 msecs = wheelMSecs(t->timeout);
+    t->position = slot;
+    t->next = nullptr;
+    if (head) {
+        // head->prev is the tail of the slot
+        t->prev = head->prev;
+        head->prev->next = t;
+        head->prev = t;
+        if (msecs < wheelTimeouts[slot])
+            wheelTimeouts[slot] = msecs;
+    } else {
+        t->prev = t;
+        head = t;
+        wheelTimeouts[slot] = msecs;
+        if (slot != ExpiredSlot)
+            wheelBits[slot / WheelLevelSlots] |= Q_UINT64_C(1) << (slot % WheelLevelSlots);
+    }
+}
+
+void QTimerInfoList::wheelInsert(QTimerInfo *t)
+{
+    qint64 msecs = wheelMSecs(t->timeout);
+    qint64 delta = msecs - wheelTime;
+    if (delta <= 0) {
+        wheelAppend(t, ExpiredSlot);
+        return;
+    }
+
+    int level = 0;
+    while (level < WheelLevels - 1 && delta >= Q_INT64_C(1) << ((level + 1) * WheelLevelBits))
+        ++level;
+    if (delta >= Q_INT64_C(1) << (WheelLevels * WheelLevelBits)) {
+        // farther than the wheel reaches, it will be cascaded again
+        msecs = wheelTime + (Q_INT64_C(1) << (WheelLevels * WheelLevelBits)) - 1;
+    }
+    const int index = int(msecs >> (level * WheelLevelBits)) & (WheelLevelSlots - 1);
+    wheelAppend(t, level * WheelLevelSlots + index);
+}
+
+void QTimerInfoList::wheelRemove(QTimerInfo *t)
+{
+    const int slot = t->position;
+    QTimerInfo *&head = wheel[slot];
+    if (t == head) {
+        head = t->next;
+        if (head)
+            head->prev = t->prev;
+        else if (slot != ExpiredSlot)
+            wheelBits[slot / WheelLevelSlots] &= ~(Q_UINT64_C(1) << (slot % WheelLevelSlots));
+    } else {
+        t->prev->next = t->next;
+        if (t->next)
+            t->next->prev = t->prev;
+        else
+            head->prev = t->prev;
+    }
+    // wheelTimeouts[slot] may now be early, wheelFirstTimeout() deals with it
+}
+
+// move the timers of the slot of level 0 to the expired ones
+void QTimerInfoList::wheelExpire(int index)
+{
+    QTimerInfo *t = wheel[index];
+    wheel[index] = nullptr;
+    wheelBits[0] &= ~(Q_UINT64_C(1) << index);
+    while (t) {
+        QTimerInfo *next = t->next;
+        wheelAppend(t, ExpiredSlot);
+        t = next;
+    }
+}
+
+// spread the next slot of the level over the lower ones
+void QTimerInfoList::wheelCascade(int level)
+{
+    const int index = int(wheelTime >> (level * WheelLevelBits)) & (WheelLevelSlots - 1);
+    if (index == 0 && level + 1 < WheelLevels)
+        wheelCascade(level + 1);
+
+    const int slot = level * WheelLevelSlots + index;
+    QTimerInfo *t = wheel[slot];
+    if (!t)
+        return;
+    wheel[slot] = nullptr;
+    wheelBits[level] &= ~(Q_UINT64_C(1) << index);
+    while (t) {
+        QTimerInfo *next = t->next;
+        wheelInsert(t);
+        t = next;
+    }
+}
+
+// expire the wheel's timers up to msecs
+void QTimerInfoList::wheelAdvance(qint64 msecs)
+{
+    const qint64 mask = WheelLevelSlots - 1;
+    while (wheelTime < msecs) {
+        // the slots of level 0 after wheelTime, up to msecs or the end of the lap
+        const qint64 until = qMin(msecs, wheelTime | mask);
+        quint64 bits = wheelBits[0]
+                & (~Q_UINT64_C(0) << (wheelTime & mask) << 1)
+                & ~(~Q_UINT64_C(0) << (until & mask) << 1);
+        while (bits) {
+            wheelExpire(qCountTrailingZeroBits(bits));
+            bits &= bits - 1;
+        }
+        wheelTime = until;
+
+        if (wheelTime < msecs) {
+            // start the next lap of level 0
+            ++wheelTime;
+            wheelCascade(1);
+            if (wheelBits[0] & 1)
+                wheelExpire(0);
+        }
+    }
+}
+
+/*
+  Returns the earliest timeout in the wheel. The slots of each level are
+  in the order of their timeouts, starting after the current one, so only
+  the first non-empty one of each level is looked at.
+*/
+bool QTimerInfoList::wheelFirstTimeout(qint64 *msecs)
+{
+    if (wheel[ExpiredSlot]) {
+        *msecs = wheelTime;
+        return true;
+    }
+
+    bool found = false;
+    for (int level = 0; level < WheelLevels; ++level) {
+        const quint64 bits = wheelBits[level];
+        if (!bits)
+            continue;
+        const int current = int(wheelTime >> (level * WheelLevelBits)) & (WheelLevelSlots - 1);
+        const quint64 after = current + 1 < WheelLevelSlots
+                ? bits & (~Q_UINT64_C(0) << (current + 1)) : 0;
+        const int slot = level * WheelLevelSlots + qCountTrailingZeroBits(after ? after : bits);
+
+        qint64 &timeout = wheelTimeouts[slot];
+        if (timeout <= wheelTime) {
+            // the earliest timer of the slot was removed
+            timeout = wheelMSecs(wheel[slot]->timeout);
+            for (const QTimerInfo *t = wheel[slot]->next; t; t = t->next)
+                timeout = qMin(timeout, wheelMSecs(t->timeout));
+        }
+        if (!found || timeout < *msecs)
+            *msecs = timeout;
+        found = true;
+    }
+    return found;
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    if (ti->timerType == Qt::PreciseTimer) {
+        preciseTimers.append(ti);
+        heapUp(preciseTimers.size() - 1);
+    } else {
+        wheelInsert(ti);
+    }
+}
+
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    if (ti->position == NoPosition)
+        return;
+    if (ti->timerType == Qt::PreciseTimer) {
+        const int index = ti->position;
+        QTimerInfo *last = preciseTimers.takeLast();
+        if (last != ti) {
+            heapMove(last, index);
+            heapUp(index);
+            heapDown(last->position);
+        }
+    } else {
+        wheelRemove(ti);
+    }
+    ti->position = NoPosition;
+}
+
+/*
+  Returns the expired timer with the earliest timeout, wheelAdvance() must
+  have been called for the current time.
+*/
+QTimerInfo *QTimerInfoList::nextExpiredTimer(const timespec &currentTime) const
+{
+    QTimerInfo *t = wheel[ExpiredSlot];
+    if (!preciseTimers.isEmpty()) {
+        QTimerInfo *p = preciseTimers.constFirst();
+        if (!(currentTime < p->timeout) && (!t || p->timeout < t->timeout))
+            t = p;
     }
-    insert(index+1, ti);
+    return t;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -388,21 +658,29 @@ bool QTimerInfoList::timerWait(timespec &tm)
     timespec currentTime = updateCurrentTime();
     repairTimersIfNeeded();
 
-    // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
+    // Find first waiting timer, the active ones are out of the list
+    timespec timeout;
+    bool found = false;
+    if (!preciseTimers.isEmpty()) {
+        timeout = preciseTimers.constFirst()->timeout;
+        found = true;
+    }
+    qint64 msecs;
+    if (wheelFirstTimeout(&msecs)) {
+        timespec t;
+        t.tv_sec = msecs / 1000;
+        t.tv_nsec = msecs % 1000 * 1000 * 1000;
+        if (!found || t < timeout)
+            timeout = t;
+        found = true;
     }
 
-    if (!t)
+    if (!found)
       return false;
 
-    if (currentTime < t->timeout) {
+    if (currentTime < timeout) {
         // time to wait
-        tm = roundToMillisecond(t->timeout - currentTime);
+        tm = roundToMillisecond(timeout - currentTime);
     } else {
         // no time to wait
         tm.tv_sec  = 0;
@@ -423,16 +701,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -451,6 +726,8 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = nullptr;
+    t->position = NoPosition;
+    t->activation = activation;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -493,6 +770,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
+    timers.insert(timerId, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -508,39 +786,33 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timers.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+    timerRemove(t);
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
+    for (auto it = timers.begin(); it != timers.end(); ) {
+        QTimerInfo *t = it.value();
         if (t->obj == object) {
             // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
+            it = timers.erase(it);
+            timerRemove(t);
             if (t->activateRef)
                 *(t->activateRef) = nullptr;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+        } else {
+            ++it;
         }
     }
     return true;
@@ -549,8 +821,7 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
+    for (const QTimerInfo *t : timers) {
         if (t->obj == object) {
             list << QAbstractEventDispatcher::TimerInfo(t->id,
                                                         (t->timerType == Qt::VeryCoarseTimer
@@ -570,42 +841,26 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
-    firstTimerInfo = nullptr;
+    int n_act = 0;
+    const uint pass = ++activation;
 
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
 
-
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    // Move the coarse timers which have expired out of the wheel
+    wheelAdvance(currentMSecs(currentTime));
 
     //fire the timers.
-    while (maxCount--) {
-        if (isEmpty())
-            break;
-
-        QTimerInfo *currentTimerInfo = constFirst();
-        if (currentTime < currentTimerInfo->timeout)
-            break; // no timer has expired
-
-        if (!firstTimerInfo) {
-            firstTimerInfo = currentTimerInfo;
-        } else if (firstTimerInfo == currentTimerInfo) {
-            // avoid sending the same timer multiple times
+    while (QTimerInfo *currentTimerInfo = nextExpiredTimer(currentTime)) {
+        // avoid sending the same timer multiple times, including the timers
+        // fired by a nested activateTimers() call
+        if (int(currentTimerInfo->activation - pass) >= 0)
             break;
-        } else if (currentTimerInfo->interval <  firstTimerInfo->interval
-                   || currentTimerInfo->interval == firstTimerInfo->interval) {
-            firstTimerInfo = currentTimerInfo;
-        }
+        currentTimerInfo->activation = pass;
 
         // remove from list
-        removeFirst();
+        timerRemove(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -629,25 +884,22 @@ int QTimerInfoList::activateTimers()
 
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, currentTime);
-
-        // reinsert timer
-        timerInsert(currentTimerInfo);
         if (currentTimerInfo->interval > 0)
             n_act++;
 
-        if (!currentTimerInfo->activateRef) {
-            // send event, but don't allow it to recurse
-            currentTimerInfo->activateRef = &currentTimerInfo;
+        // send event, but don't allow it to recurse: the timer is reinserted
+        // once the event has been delivered
+        currentTimerInfo->activateRef = &currentTimerInfo;
 
-            QTimerEvent e(currentTimerInfo->id);
-            QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
+        QTimerEvent e(currentTimerInfo->id);
+        QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
 
-            if (currentTimerInfo)
-                currentTimerInfo->activateRef = nullptr;
+        if (currentTimerInfo) {
+            currentTimerInfo->activateRef = nullptr;
+            timerInsert(currentTimerInfo);
         }
     }
 
-    firstTimerInfo = nullptr;
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
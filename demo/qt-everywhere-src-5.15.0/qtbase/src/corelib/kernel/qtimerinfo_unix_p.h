@@ -56,6 +56,8 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
+#include "qvector.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -70,6 +72,12 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // position in QTimerInfoList
+    int position;     // - index in the heap of precise timers or wheel slot
+    uint activation;  // - activateTimers() pass which last fired the timer
+    QTimerInfo *next; // - list of the timers of the same wheel slot
+    QTimerInfo *prev;
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -77,7 +85,11 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+// Precise timers are kept in a binary heap ordered by timeout. Coarse and
+// very coarse timers, whose timeouts are whole milliseconds, are kept in a
+// hierarchical timer wheel: registering, unregistering and firing them
+// doesn't depend on the number of timers.
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
@@ -89,11 +101,46 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     void timerRepair(const timespec &);
 #endif
 
-    // state variables used by activateTimers()
-    QTimerInfo *firstTimerInfo;
+    enum {
+        WheelLevelBits = 6,
+        WheelLevelSlots = 1 << WheelLevelBits,
+        WheelLevels = 6,
+        // timers whose timeout the wheel has already passed
+        ExpiredSlot = WheelLevels * WheelLevelSlots,
+        WheelSlots = ExpiredSlot + 1,
+        // neither in the heap nor in the wheel, such as while being activated
+        NoPosition = -1
+    };
+
+    QHash<int, QTimerInfo *> timers;
+    QVector<QTimerInfo *> preciseTimers; // heap
+
+    qint64 wheelTime; // - milliseconds up to which the wheel has expired its slots
+    QTimerInfo *wheel[WheelSlots];
+    qint64 wheelTimeouts[WheelSlots]; // - earliest timeout of each slot, or earlier
+    quint64 wheelBits[WheelLevels]; // - non-empty slots of each level
+
+    uint activation;
+
+    void heapMove(QTimerInfo *t, int index);
+    void heapUp(int index);
+    void heapDown(int index);
+    void wheelAppend(QTimerInfo *t, int slot);
+    void wheelInsert(QTimerInfo *t);
+    void wheelRemove(QTimerInfo *t);
+    void wheelExpire(int index);
+    void wheelCascade(int level);
+    void wheelAdvance(qint64 msecs);
+    bool wheelFirstTimeout(qint64 *msecs);
+    void timerRemove(QTimerInfo *t);
+    QTimerInfo *nextExpiredTimer(const timespec &currentTime) const;
 
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+    int size() const { return timers.size(); }
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -1054,7 +1054,9 @@ bool QCborStreamReader::next(int maxRecursion)
         if (lastError() == QCborError::NoError)
             leaveContainer();
     } else if (isString() || isByteArray()) {
-        auto r = _readByteArray_helper();
+        // no need to copy the contents out of an in-memory buffer just to
+        // validate and drop them
+        auto r = readRawStringChunk();
         while (r.status == Ok) {
             if (isString() && r.data.size() > MaxStringSize) {
                 d->handleError(CborErrorDataTooLarge);
@@ -1064,7 +1066,7 @@ bool QCborStreamReader::next(int maxRecursion)
                 d->handleError(CborErrorInvalidUtf8TextString);
                 break;
             }
-            r = _readByteArray_helper();
+            r = readRawStringChunk();
         }
     } else {
         // fixed types
@@ -1337,7 +1339,8 @@ bool QCborStreamReader::leaveContainer()
  */
 QCborStreamReader::StringResult<QString> QCborStreamReader::_readString_helper()
 {
-    auto r = _readByteArray_helper();
+    // decode straight from the source buffer, if there is one
+    auto r = readRawStringChunk();
     QCborStreamReader::StringResult<QString> result;
     result.status = r.status;
 
@@ -1460,88 +1463,155 @@ qsizetype QCborStreamReader::_currentStringChunkSize() const
 QCborStreamReader::StringResult<qsizetype>
 QCborStreamReader::readStringChunk(char *ptr, qsizetype maxlen)
 {
-    CborError err;
-    size_t len;
-    const void *content = nullptr;
+    qptrdiff offset;
+    qsizetype len;
     QCborStreamReader::StringResult<qsizetype> result;
     result.data = 0;
+    result.status = _nextStringChunk(&offset, &len);
+    if (result.status != Ok)
+        return result;
     result.status = Error;
 
+    // Read the chunk into the user's buffer.
+    qint64 actuallyRead;
+    qsizetype toRead = len;
+    qsizetype left = toRead - maxlen;
+    if (left < 0)
+        left = 0;               // buffer bigger than string
+    else
+        toRead = maxlen;        // buffer smaller than string
+
+    if (d->device) {
+        // This first skip can't fail because we've already read this many bytes.
+        d->device->skip(d->bufferStart + offset);
+        actuallyRead = d->device->read(ptr, toRead);
+
+        if (actuallyRead != toRead)  {
+            actuallyRead = -1;
+        } else if (left) {
+            qint64 skipped = d->device->skip(left);
+            if (skipped != left)
+                actuallyRead = -1;
+        }
+
+        if (actuallyRead < 0) {
+            d->handleError(CborErrorIO);
+            return result;
+        }
+
+        d->updateBufferAfterString(offset, len);
+    } else {
+        actuallyRead = toRead;
+        memcpy(ptr, d->buffer.constData() + d->bufferStart + offset, toRead);
+        d->bufferStart += QByteArray::size_type(offset + len);
+    }
+
+    d->preread();
+    result.data = actuallyRead;
+    result.status = Ok;
+    return result;
+}
+
+/*!
+    \internal
+
+    Moves past the header of the next chunk of the current string, without
+    touching its contents. On success, stores where the contents start,
+    relative to the current buffer position, in \a offset and their size in
+    \a len, and returns Ok. After the last chunk, finishes the string and
+    returns EndOfString.
+ */
+QCborStreamReader::StringResultCode QCborStreamReader::_nextStringChunk(qptrdiff *offset, qsizetype *len)
+{
+    CborError err;
+    size_t chunkLen;
+    const void *content = nullptr;
+
     d->lastError = {};
     if (!d->ensureStringIteration())
-        return result;
+        return Error;
 
 #if 1
     // Using internal TinyCBOR API!
-    err = _cbor_value_get_string_chunk(&d->currentElement, &content, &len, &d->currentElement);
+    err = _cbor_value_get_string_chunk(&d->currentElement, &content, &chunkLen, &d->currentElement);
 #else
     // the above is effectively the same as:
     if (cbor_value_is_byte_string(&currentElement))
         err = cbor_value_get_byte_string_chunk(&d->currentElement, reinterpret_cast<const uint8_t **>(&content),
-                                               &len, &d->currentElement);
+                                               &chunkLen, &d->currentElement);
     else
         err = cbor_value_get_text_string_chunk(&d->currentElement, reinterpret_cast<const char **>(&content),
-                                               &len, &d->currentElement);
+                                               &chunkLen, &d->currentElement);
 #endif
 
     // Range check: using implementation-defined behavior in converting an
     // unsigned value out of range of the destination signed type (same as
     // "len > size_t(std::numeric_limits<qsizetype>::max())", but generates
     // better code with ICC and MSVC).
-    if (!err && qsizetype(len) < 0)
+    if (!err && qsizetype(chunkLen) < 0)
         err = CborErrorDataTooLarge;
 
     if (err) {
+        StringResultCode status = Error;
         if (err == CborErrorNoMoreStringChunks) {
             d->preread();
             err = cbor_value_finish_string_iteration(&d->currentElement);
-            result.status = EndOfString;
+            status = EndOfString;
         }
         if (err)
             d->handleError(err);
         else
             preparse();
-        return result;
+        return status;
     }
 
-    // Read the chunk into the user's buffer.
-    qint64 actuallyRead;
-    qptrdiff offset = qptrdiff(content);
-    qsizetype toRead = qsizetype(len);
-    qsizetype left = toRead - maxlen;
-    if (left < 0)
-        left = 0;               // buffer bigger than string
-    else
-        toRead = maxlen;        // buffer smaller than string
+    *offset = qptrdiff(content);
+    *len = qsizetype(chunkLen);
+    return Ok;
+}
 
-    if (d->device) {
-        // This first skip can't fail because we've already read this many bytes.
-        d->device->skip(d->bufferStart + qptrdiff(content));
-        actuallyRead = d->device->read(ptr, toRead);
+/*!
+    \since 5.15
 
-        if (actuallyRead != toRead)  {
-            actuallyRead = -1;
-        } else if (left) {
-            qint64 skipped = d->device->skip(left);
-            if (skipped != left)
-                actuallyRead = -1;
-        }
+    Reads the current string chunk and returns it as a QByteArray. This
+    function can be called for both \l String and \l ByteArray types; for
+    strings, it returns the UTF-8 contents without decoding or validating
+    them.
 
-        if (actuallyRead < 0) {
-            d->handleError(CborErrorIO);
-            return result;
-        }
+    When this reader was created from a buffer in memory, such as a QByteArray
+    or the region returned by QFile::map(), the returned QByteArray refers to
+    that memory directly instead of copying it (see QByteArray::fromRawData()).
+    It stays valid only as long as that memory does and addData() is not
+    called. When reading from a QIODevice, the chunk is copied.
 
-        d->updateBufferAfterString(offset, len);
-    } else {
-        actuallyRead = toRead;
-        memcpy(ptr, d->buffer.constData() + d->bufferStart + offset, toRead);
-        d->bufferStart += QByteArray::size_type(offset + len);
+    Like readString() and readByteArray(), this function must be called in a
+    loop until it returns EndOfString, even if isLengthKnown() is \c true.
+
+    \sa readStringChunk(), readByteArray(), readString()
+ */
+QCborStreamReader::StringResult<QByteArray> QCborStreamReader::readRawStringChunk()
+{
+    Q_ASSERT(isString() || isByteArray());
+    if (d->device)
+        return _readByteArray_helper();
+
+    qptrdiff offset;
+    qsizetype len;
+    QCborStreamReader::StringResult<QByteArray> result;
+    result.status = _nextStringChunk(&offset, &len);
+    if (result.status != Ok)
+        return result;
+
+    if (len > MaxByteArraySize) {
+        d->handleError(CborErrorDataTooLarge);
+        result.status = Error;
+        return result;
     }
 
+    result.data = QByteArray::fromRawData(d->buffer.constData() + d->bufferStart + offset,
+                                          QByteArray::size_type(len));
+    d->bufferStart += QByteArray::size_type(offset + len);
     d->preread();
-    result.data = actuallyRead;
-    result.status = Ok;
     return result;
 }
 
@@ -157,6 +157,7 @@ public:
     StringResult<QByteArray> readByteArray(){ Q_ASSERT(isByteArray()); return _readByteArray_helper(); }
     qsizetype currentStringChunkSize() const{ Q_ASSERT(isString() || isByteArray()); return _currentStringChunkSize(); }
     StringResult<qsizetype> readStringChunk(char *ptr, qsizetype maxlen);
+    StringResult<QByteArray> readRawStringChunk();
 
     bool toBool() const                 { Q_ASSERT(isBool()); return value64 - int(QCborSimpleType::False); }
     QCborTag toTag() const              { Q_ASSERT(isTag()); return QCborTag(value64); }
@@ -182,6 +183,7 @@ private:
     StringResult<QString> _readString_helper();
     StringResult<QByteArray> _readByteArray_helper();
     qsizetype _currentStringChunkSize() const;
+    StringResultCode _nextStringChunk(qptrdiff *offset, qsizetype *len);
 
     template <typename FP> FP _toFloatingPoint() const noexcept
     {
@@ -1397,6 +1397,107 @@ int QDataStream::skipRawData(int len)
     return skipResult;
 }
 
+namespace QtPrivate {
+
+static inline bool needsSwap(const QDataStream &s)
+{
+    return s.byteOrder() != QDataStream::ByteOrder(QSysInfo::ByteOrder);
+}
+
+static void swapArray(const void *source, qint64 count, int elementSize, void *dest)
+{
+    switch (elementSize) {
+    case 2:
+        qbswap<2>(source, count, dest);
+        break;
+    case 4:
+        qbswap<4>(source, count, dest);
+        break;
+    case 8:
+        qbswap<8>(source, count, dest);
+        break;
+    default:
+        Q_UNREACHABLE();
+    }
+}
+
+/*!
+    \internal
+
+    Reads \a count elements of \a elementSize bytes each from \a s into
+    \a data with as few device reads as possible, then converts them from
+    the stream's byte order in place. Returns \c false if not all of the data
+    could be read, in which case the status of \a s tells why.
+
+    This is only correct for types whose stream format is their memory
+    representation, see IsRawStreamable.
+*/
+bool readRawArray(QDataStream &s, void *data, qint64 count, int elementSize)
+{
+    Q_ASSERT(count >= 0 && (elementSize == 1 || elementSize == 2 || elementSize == 4
+                            || elementSize == 8));
+
+    char *ptr = static_cast<char *>(data);
+    qint64 bytes = count * elementSize;
+    // readRawData() takes an int; keep the blocks a multiple of the element size
+    const int maxBlockSize = (std::numeric_limits<int>::max() / 8) * 8;
+    while (bytes > 0) {
+        const int block = int(qMin(bytes, qint64(maxBlockSize)));
+        if (s.readRawData(ptr, block) != block)
+            return false;
+        ptr += block;
+        bytes -= block;
+    }
+
+    if (elementSize > 1 && needsSwap(s))
+        swapArray(data, count, elementSize, data);
+    return s.status() == QDataStream::Ok;
+}
+
+/*!
+    \internal
+
+    Writes \a count elements of \a elementSize bytes each from \a data to
+    \a s in the stream's byte order. Data that needs no conversion is written
+    in one go, otherwise it is converted through a bounded buffer. Returns
+    \c false if the write failed.
+
+    This is only correct for types whose stream format is their memory
+    representation, see IsRawStreamable.
+*/
+bool writeRawArray(QDataStream &s, const void *data, qint64 count, int elementSize)
+{
+    Q_ASSERT(count >= 0 && (elementSize == 1 || elementSize == 2 || elementSize == 4
+                            || elementSize == 8));
+
+    const char *ptr = static_cast<const char *>(data);
+    qint64 bytes = count * elementSize;
+    if (elementSize == 1 || !needsSwap(s)) {
+        const int maxBlockSize = (std::numeric_limits<int>::max() / 8) * 8;
+        while (bytes > 0) {
+            const int block = int(qMin(bytes, qint64(maxBlockSize)));
+            if (s.writeRawData(ptr, block) != block)
+                return false;
+            ptr += block;
+            bytes -= block;
+        }
+        return true;
+    }
+
+    char buffer[16384];
+    while (bytes > 0) {
+        const int block = int(qMin(bytes, qint64(sizeof(buffer))));
+        swapArray(ptr, block / elementSize, elementSize, buffer);
+        if (s.writeRawData(buffer, block) != block)
+            return false;
+        ptr += block;
+        bytes -= block;
+    }
+    return true;
+}
+
+} // QtPrivate namespace
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_DATASTREAM
@@ -44,6 +44,8 @@
 #include <QtCore/qiodevice.h>
 #include <QtCore/qpair.h>
 
+#include <limits>
+
 #ifdef Status
 #error qdatastream.h must be included before any header file that defines Status
 #endif
@@ -359,6 +361,108 @@ QDataStream &writeAssociativeContainer(QDataStream &s, const Container &c)
     return s;
 }
 
+Q_CORE_EXPORT bool readRawArray(QDataStream &s, void *data, qint64 count, int elementSize);
+Q_CORE_EXPORT bool writeRawArray(QDataStream &s, const void *data, qint64 count, int elementSize);
+
+template <typename T>
+inline bool readRawArray(QDataStream &s, T *data, qint64 count)
+{
+    return readRawArray(s, static_cast<void *>(data), count, int(sizeof(T)));
+}
+
+template <typename T>
+inline bool writeRawArray(QDataStream &s, const T *data, qint64 count)
+{
+    return writeRawArray(s, static_cast<const void *>(data), count, int(sizeof(T)));
+}
+
+// Types stored in the stream as their memory representation in the stream's
+// byte order, so that arrays of them can be read and written in bulk.
+template <typename T> struct IsRawStreamable : std::false_type {};
+template <> struct IsRawStreamable<qint8> : std::true_type {};
+template <> struct IsRawStreamable<quint8> : std::true_type {};
+template <> struct IsRawStreamable<qint16> : std::true_type {};
+template <> struct IsRawStreamable<quint16> : std::true_type {};
+template <> struct IsRawStreamable<qint32> : std::true_type {};
+template <> struct IsRawStreamable<quint32> : std::true_type {};
+template <> struct IsRawStreamable<qint64> : std::true_type {};
+template <> struct IsRawStreamable<quint64> : std::true_type {};
+template <> struct IsRawStreamable<float> : std::true_type {};
+template <> struct IsRawStreamable<double> : std::true_type {};
+
+// float and double are converted to the other type for the other precision
+template <typename T>
+inline bool canStreamRaw(const QDataStream &) { return true; }
+template <>
+inline bool canStreamRaw<float>(const QDataStream &s)
+{
+    return s.version() < QDataStream::Qt_4_6
+            || s.floatingPointPrecision() == QDataStream::SinglePrecision;
+}
+template <>
+inline bool canStreamRaw<double>(const QDataStream &s)
+{
+    return s.version() < QDataStream::Qt_4_6
+            || s.floatingPointPrecision() == QDataStream::DoublePrecision;
+}
+
+template <typename T>
+inline QDataStream &readVector(QDataStream &s, QVector<T> &v, std::false_type)
+{
+    return readArrayBasedContainer(s, v);
+}
+
+template <typename T>
+QDataStream &readVector(QDataStream &s, QVector<T> &v, std::true_type)
+{
+    if (!canStreamRaw<T>(s))
+        return readArrayBasedContainer(s, v);
+
+    StreamStateSaver stateSaver(&s);
+
+    v.clear();
+    quint32 n;
+    s >> n;
+    if (n > quint32(std::numeric_limits<int>::max())) {
+        s.setStatus(QDataStream::ReadCorruptData);
+        return s;
+    }
+
+    // grow in blocks, so that a corrupt count does not make us allocate
+    // more memory than the stream has data for
+    const quint32 blockSize = (1 << 20) / sizeof(T);
+    v.reserve(int(qMin(n, blockSize)));
+    quint32 i = 0;
+    while (i < n && s.status() == QDataStream::Ok) {
+        const quint32 block = qMin(n - i, blockSize);
+        v.resize(int(i + block));
+        if (!readRawArray(s, v.data() + i, block))
+            break;
+        i += block;
+    }
+    if (s.status() != QDataStream::Ok)
+        v.clear();
+
+    return s;
+}
+
+template <typename T>
+inline QDataStream &writeVector(QDataStream &s, const QVector<T> &v, std::false_type)
+{
+    return writeSequentialContainer(s, v);
+}
+
+template <typename T>
+QDataStream &writeVector(QDataStream &s, const QVector<T> &v, std::true_type)
+{
+    if (!canStreamRaw<T>(s))
+        return writeSequentialContainer(s, v);
+
+    s << quint32(v.size());
+    writeRawArray(s, v.constData(), v.size());
+    return s;
+}
+
 } // QtPrivate namespace
 
 /*****************************************************************************
@@ -434,13 +538,13 @@ inline QDataStream &operator<<(QDataStream &s, const QList<T> &l)
 template<typename T>
 inline QDataStream &operator>>(QDataStream &s, QVector<T> &v)
 {
-    return QtPrivate::readArrayBasedContainer(s, v);
+    return QtPrivate::readVector(s, v, QtPrivate::IsRawStreamable<T>());
 }
 
 template<typename T>
 inline QDataStream &operator<<(QDataStream &s, const QVector<T> &v)
 {
-    return QtPrivate::writeSequentialContainer(s, v);
+    return QtPrivate::writeVector(s, v, QtPrivate::IsRawStreamable<T>());
 }
 
 template <typename T>
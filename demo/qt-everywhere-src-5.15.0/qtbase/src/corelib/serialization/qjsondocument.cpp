@@ -229,7 +229,8 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
 /*! \enum QJsonDocument::DataValidation
 
   This value is used to tell QJsonDocument whether to validate the binary data
-  when converting to a QJsonDocument using fromBinaryData() or fromRawData().
+  when converting to a QJsonDocument using fromBinaryData(), fromRawData() or
+  fromJson().
 
   \value Validate Validate the data before using it. This is the default.
   \value BypassValidation Bypasses data validation. Only use if you received the
@@ -511,7 +512,26 @@ QByteArray QJsonDocument::toJson(JsonFormat format) const
  */
 QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *error)
 {
-    QJsonPrivate::Parser parser(json.constData(), json.length());
+    return fromJson(json, Validate, error);
+}
+
+/*!
+ \since 5.15
+ \overload
+
+ Parses \a json as a UTF-8 encoded JSON document, and creates a QJsonDocument
+ from it.
+
+ If \a validation is BypassValidation, strings that contain no escape sequences
+ are stored without checking that they are valid UTF-8. Only use this for input
+ that is known to be valid, such as data this application wrote itself.
+
+ \sa toJson(), QJsonParseError, isNull()
+ */
+QJsonDocument QJsonDocument::fromJson(const QByteArray &json, DataValidation validation,
+                                      QJsonParseError *error)
+{
+    QJsonPrivate::Parser parser(json.constData(), json.length(), validation == Validate);
     QJsonDocument result;
     const QCborValue val = parser.parse(error);
     if (val.isArray() || val.isMap()) {
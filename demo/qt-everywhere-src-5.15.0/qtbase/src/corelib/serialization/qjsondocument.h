@@ -134,6 +134,8 @@ public:
     };
 
     static QJsonDocument fromJson(const QByteArray &json, QJsonParseError *error = nullptr);
+    static QJsonDocument fromJson(const QByteArray &json, DataValidation validation,
+                                  QJsonParseError *error = nullptr);
 
 #if !defined(QT_JSON_READONLY) || defined(Q_CLANG_QDOC)
     QByteArray toJson() const; //### Merge in Qt6
@@ -42,11 +42,13 @@
 #include <qcoreapplication.h>
 #endif
 #include <qdebug.h>
+#include <qvarlengtharray.h>
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -62,6 +64,9 @@ static int indent = 0;
 
 static const int nestingLimit = 1024;
 
+// Documents at least this large get a structural scan before they are parsed
+static const int structureScanThreshold = 64 * 1024;
+
 QT_BEGIN_NAMESPACE
 
 // error strings for the JSON parser
@@ -222,10 +227,12 @@ private:
     QExplicitlySharedDataPointer<QCborContainerPrivate> *current;
 };
 
-Parser::Parser(const char *json, int length)
+Parser::Parser(const char *json, int length, bool validateUtf8)
     : head(json), json(json)
     , nestingLevel(0)
     , lastError(QJsonParseError::NoError)
+    , validateUtf8(validateUtf8)
+    , nextContainer(0)
 {
     end = json + length;
 }
@@ -272,6 +279,134 @@ enum {
     Quote = 0x22
 };
 
+static inline bool isStructuralByte(char c)
+{
+    switch (c) {
+    case '"':
+    case '\\':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+    case ',':
+        return true;
+    default:
+        return false;
+    }
+}
+
+#ifdef __SSE2__
+// Returns a mask of the bytes among the 16 at p that the structural scan needs to look at
+static inline uint structuralMask(const char *p)
+{
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                             _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}')));
+    return uint(_mm_movemask_epi8(m));
+}
+#endif
+
+/*
+    The first stage for large documents: a quick pass that only follows strings
+    and brackets, and counts the values and string bytes of every container in
+    the order they are opened. The second stage reserves those sizes when it
+    creates the containers, instead of growing them one value at a time.
+
+    The counts are only hints. Malformed input just makes them wrong, the
+    second stage still reports the errors.
+*/
+void Parser::scanStructure()
+{
+    struct OpenContainer {
+        int index;
+        bool isObject;
+    };
+    QVarLengthArray<OpenContainer, 64> open;
+    bool inString = false;
+    const char *stringStart = nullptr;
+
+    const char *p = json;
+    while (p < end) {
+#ifdef __SSE2__
+        if (end - p >= 16) {
+            const uint mask = structuralMask(p);
+            if (!mask) {
+                p += 16;
+                continue;
+            }
+            p += qCountTrailingZeroBits(mask);
+        } else
+#endif
+        if (!isStructuralByte(*p)) {
+            ++p;
+            continue;
+        }
+
+        const char c = *p++;
+        if (inString) {
+            if (c == '\\') {
+                ++p;
+            } else if (c == '"') {
+                inString = false;
+                if (!open.isEmpty()) {
+                    containerSizes[open.last().index].stringBytes += (p - 1 - stringStart)
+                            + sizeof(QtCbor::ByteData) + Q_ALIGNOF(QtCbor::ByteData) - 1;
+                }
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            inString = true;
+            stringStart = p;
+            break;
+        case '[':
+        case '{':
+            if (open.size() > nestingLimit)
+                return;
+            open.append({ containerSizes.size(), c == '{' });
+            containerSizes.append(ContainerSize());
+            Q_FALLTHROUGH();
+        case ',':
+            // Count one value more than there are separators, objects store
+            // the key and the value of each member.
+            if (!open.isEmpty())
+                containerSizes[open.last().index].elements += open.last().isObject ? 2 : 1;
+            break;
+        case ']':
+        case '}':
+            if (!open.isEmpty())
+                open.removeLast();
+            break;
+        }
+    }
+}
+
+// Returns the sizes the structural scan found for the next container to be opened.
+Parser::ContainerSize Parser::nextContainerSize()
+{
+    if (nextContainer < containerSizes.size())
+        return containerSizes.at(nextContainer++);
+    return ContainerSize();
+}
+
+void Parser::createContainer(const ContainerSize &size)
+{
+    container = new QCborContainerPrivate;
+    // Never reserve more than the document could possibly hold
+    const qsizetype limit = end - head;
+    if (size.elements)
+        container->elements.reserve(int(qMin(size.elements, limit)));
+    if (size.stringBytes)
+        container->data.reserve(int(qMin(size.stringBytes, limit)));
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -329,19 +464,19 @@ QCborValue Parser::parse(QJsonParseError *error)
     qDebug(">>>>> parser begin");
 #endif
     eatBOM();
+    if (end - json >= structureScanThreshold)
+        scanStructure();
     char token = nextToken();
 
     QCborValue data;
 
     DEBUG << Qt::hex << (uint)token;
     if (token == BeginArray) {
-        container = new QCborContainerPrivate;
         if (!parseArray())
             goto error;
         data = QCborContainerPrivate::makeValue(QCborValue::Array, -1, container.take(),
                                                 QCborContainerPrivate::MoveContainer);
     } else if (token == BeginObject) {
-        container = new QCborContainerPrivate;
         if (!parseObject())
             goto error;
         data = QCborContainerPrivate::makeValue(QCborValue::Map, -1, container.take(),
@@ -466,10 +601,11 @@ bool Parser::parseObject()
 
     BEGIN << "parseObject" << json;
 
+    const ContainerSize size = nextContainerSize();
     char token = nextToken();
     while (token == Quote) {
         if (!container)
-            container = new QCborContainerPrivate;
+            createContainer(size);
         if (!parseMember())
             return false;
         token = nextToken();
@@ -534,6 +670,7 @@ bool Parser::parseArray()
         return false;
     }
 
+    const ContainerSize size = nextContainerSize();
     if (!eatSpace()) {
         lastError = QJsonParseError::UnterminatedArray;
         return false;
@@ -547,7 +684,7 @@ bool Parser::parseArray()
                 return false;
             }
             if (!container)
-                container = new QCborContainerPrivate;
+                createContainer(size);
             if (!parseValue())
                 return false;
             char token = nextToken();
@@ -855,6 +992,28 @@ static inline bool scanUtf8Char(const char *&json, const char *end, uint *result
     return true;
 }
 
+// Returns the first quote, backslash or non-ASCII byte in [json, end), or end.
+static inline const char *skipPlainAscii(const char *json, const char *end)
+{
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - json >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                             _mm_cmpeq_epi8(chunk, backslash));
+        // the sign bit of the chunk itself flags the non-ASCII bytes
+        const uint mask = uint(_mm_movemask_epi8(_mm_or_si128(special, chunk)));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+        json += 16;
+    }
+#endif
+    while (json < end && uchar(*json) < 0x80 && *json != '"' && *json != '\\')
+        ++json;
+    return json;
+}
+
 bool Parser::parseString()
 {
     const char *start = json;
@@ -865,6 +1024,9 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        json = skipPlainAscii(json, end);
+        if (json >= end)
+            break;
         uint ch = 0;
         if (*json == '"')
             break;
@@ -876,12 +1038,15 @@ bool Parser::parseString()
             isUtf8 = false;
             break;
         }
+        isAscii = false;
+        if (!validateUtf8) {
+            ++json;
+            continue;
+        }
         if (!scanUtf8Char(json, end, &ch)) {
             lastError = QJsonParseError::IllegalUTF8String;
             return false;
         }
-        if (ch > 0x7f)
-            isAscii = false;
         DEBUG << "  " << ch << char(ch);
     }
     ++json;
@@ -62,11 +62,20 @@ namespace QJsonPrivate {
 class Parser
 {
 public:
-    Parser(const char *json, int length);
+    Parser(const char *json, int length, bool validateUtf8 = true);
 
     QCborValue parse(QJsonParseError *error);
 
 private:
+    struct ContainerSize {
+        qsizetype elements = 0;
+        qsizetype stringBytes = 0;
+    };
+
+    void scanStructure();
+    ContainerSize nextContainerSize();
+    void createContainer(const ContainerSize &size);
+
     inline void eatBOM();
     inline bool eatSpace();
     inline char nextToken();
@@ -84,6 +93,10 @@ private:
     int nestingLevel;
     QJsonParseError::ParseError lastError;
     QExplicitlySharedDataPointer<QCborContainerPrivate> container;
+
+    bool validateUtf8;
+    int nextContainer;
+    QVector<ContainerSize> containerSizes;
 };
 
 }
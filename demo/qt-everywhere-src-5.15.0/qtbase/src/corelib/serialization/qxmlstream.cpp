@@ -507,6 +507,10 @@ void QXmlStreamReader::addData(const QByteArray &data)
         qWarning("QXmlStreamReader: addData() with device()");
         return;
     }
+    if (d->dataBufferPos) {
+        d->dataBuffer.remove(0, d->dataBufferPos);
+        d->dataBufferPos = 0;
+    }
     d->dataBuffer += data;
 }
 
@@ -863,6 +867,7 @@ void QXmlStreamReaderPrivate::init()
     namespaceProcessing = true;
     rawReadBuffer.clear();
     dataBuffer.clear();
+    dataBufferPos = 0;
     readBuffer.clear();
     tagStackStringStorageSize = initialTagStackStringStorageSize;
 
@@ -1495,12 +1500,21 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         int nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
         nbytesread += qMax(nbytesreadOrMinus1, 0);
     } else {
+        // decode data added in memory in chunks as well, so that a large
+        // document is not held both encoded and decoded at the same time
+        const int chunk = qMin(dataBuffer.size() - dataBufferPos, BUFFER_SIZE);
         if (nbytesread)
-            rawReadBuffer += dataBuffer;
-        else
+            rawReadBuffer += dataBuffer.mid(dataBufferPos, chunk);
+        else if (chunk == dataBuffer.size())
             rawReadBuffer = dataBuffer;
+        else
+            rawReadBuffer = dataBuffer.mid(dataBufferPos, chunk);
         nbytesread = rawReadBuffer.size();
-        dataBuffer.clear();
+        dataBufferPos += chunk;
+        if (dataBufferPos == dataBuffer.size()) {
+            dataBuffer.clear();
+            dataBufferPos = 0;
+        }
     }
     if (!nbytesread) {
         atEnd = true;
@@ -749,6 +749,7 @@ public:
 
     QByteArray rawReadBuffer;
     QByteArray dataBuffer;
+    int dataBufferPos;
     uchar firstByte;
     qint64 nbytesread;
     QString readBuffer;
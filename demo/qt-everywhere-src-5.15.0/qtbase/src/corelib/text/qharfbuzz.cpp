@@ -43,6 +43,12 @@
 #if QT_CONFIG(library)
 #include "qlibrary.h"
 #endif
+#include "qatomic.h"
+#include "qcache.h"
+#include "qhashfunctions.h"
+#include "qmutex.h"
+#include "qvector.h"
+#include "private/qlocking_p.h"
 
 QT_USE_NAMESPACE
 
@@ -86,9 +92,163 @@ void (*HB_Library_Resolve(const char *library, int version, const char *symbol))
 
 QT_BEGIN_NAMESPACE
 
+/*
+    Shaping the same text with the same font again gives the same glyphs, so
+    the results of qShapeItem() are kept in a cache. The key holds everything
+    that goes into shaping: the face and the font with its scale, the item
+    and the text around it (shapers look at the neighbouring characters), the
+    flags and the glyph indices passed in. Entries of a face are dropped when
+    the face is freed, as its address can be reused for another one.
+
+    QT_HARFBUZZ_SHAPE_CACHE_SIZE sets the size of the cache in glyphs; 0
+    disables it. qHBShapeCacheStatistics() returns the hits and misses, which
+    helps tuning it. Only short strings, like labels, are cached: long texts
+    are rarely shaped again, and the key would copy all of them for every item.
+*/
+enum { MaxCachedStringLength = 256 };
+
+struct QHBShapeKey
+{
+    HB_Face face;
+    HB_Font font;
+    HB_UShort x_ppem, y_ppem;
+    HB_16Dot16 x_scale, y_scale;
+    hb_uint32 pos, length;
+    int script;
+    int bidiLevel;
+    int shaperFlags;
+    QByteArray input; // the string, followed by the glyph indices if present
+};
+
+static bool operator==(const QHBShapeKey &key1, const QHBShapeKey &key2)
+{
+    return key1.face == key2.face && key1.font == key2.font
+            && key1.x_ppem == key2.x_ppem && key1.y_ppem == key2.y_ppem
+            && key1.x_scale == key2.x_scale && key1.y_scale == key2.y_scale
+            && key1.pos == key2.pos && key1.length == key2.length
+            && key1.script == key2.script && key1.bidiLevel == key2.bidiLevel
+            && key1.shaperFlags == key2.shaperFlags && key1.input == key2.input;
+}
+
+static uint qHash(const QHBShapeKey &key, uint seed = 0) noexcept
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.face);
+    seed = hash(seed, key.font);
+    seed = hash(seed, key.x_scale);
+    seed = hash(seed, key.y_scale);
+    seed = hash(seed, key.pos);
+    seed = hash(seed, key.length);
+    seed = hash(seed, key.script | key.bidiLevel << 8 | key.shaperFlags << 16);
+    seed = hash(seed, key.input);
+    return seed;
+}
+
+struct QHBShapeResult
+{
+    QVector<HB_Glyph> glyphs;
+    QVector<HB_GlyphAttributes> attributes;
+    QVector<HB_Fixed> advances;
+    QVector<HB_FixedPoint> offsets;
+    QVector<unsigned short> logClusters;
+    HB_Bool kerningApplied;
+};
+
+struct QHBShapeCache
+{
+    QHBShapeCache()
+        : results(qEnvironmentVariableIsSet("QT_HARFBUZZ_SHAPE_CACHE_SIZE")
+                  ? qMax(0, qEnvironmentVariableIntValue("QT_HARFBUZZ_SHAPE_CACHE_SIZE"))
+                  : 64 * 1024)
+    {}
+    QCache<QHBShapeKey, QHBShapeResult> results;
+    QAtomicInt hits;
+    QAtomicInt misses;
+};
+Q_GLOBAL_STATIC(QHBShapeCache, shapeCache)
+static QBasicMutex shapeCacheMutex;
+
+static QHBShapeKey shapeKey(const HB_ShaperItem *item)
+{
+    QHBShapeKey key;
+    key.face = item->face;
+    key.font = item->font;
+    key.x_ppem = item->font->x_ppem;
+    key.y_ppem = item->font->y_ppem;
+    key.x_scale = item->font->x_scale;
+    key.y_scale = item->font->y_scale;
+    key.pos = item->item.pos;
+    key.length = item->item.length;
+    key.script = item->item.script;
+    key.bidiLevel = item->item.bidiLevel;
+    key.shaperFlags = item->shaperFlags;
+
+    const int stringSize = int(item->stringLength * sizeof(HB_UChar16));
+    const int glyphsSize = item->glyphIndicesPresent
+            ? int(item->initialGlyphCount * sizeof(HB_Glyph)) : 0;
+    key.input.resize(stringSize + glyphsSize);
+    memcpy(key.input.data(), item->string, stringSize);
+    if (glyphsSize)
+        memcpy(key.input.data() + stringSize, item->glyphs, glyphsSize);
+    return key;
+}
+
 HB_Bool qShapeItem(HB_ShaperItem *item)
 {
-    return HB_ShapeItem(item);
+    QHBShapeCache *cache = shapeCache();
+    if (!cache || cache->results.maxCost() == 0 || !item->font || !item->face
+        || item->stringLength > MaxCachedStringLength) {
+        return HB_ShapeItem(item);
+    }
+
+    QHBShapeKey key = shapeKey(item);
+    {
+        const auto locker = qt_scoped_lock(shapeCacheMutex);
+        if (const QHBShapeResult *result = cache->results.object(key)) {
+            cache->hits.ref();
+            const hb_uint32 count = hb_uint32(result->glyphs.size());
+            if (count > item->num_glyphs) {
+                // like the shaper, report the capacity needed
+                item->num_glyphs = count;
+                return false;
+            }
+            memcpy(item->glyphs, result->glyphs.constData(), count * sizeof(HB_Glyph));
+            memcpy(item->attributes, result->attributes.constData(), count * sizeof(HB_GlyphAttributes));
+            memcpy(item->advances, result->advances.constData(), count * sizeof(HB_Fixed));
+            memcpy(item->offsets, result->offsets.constData(), count * sizeof(HB_FixedPoint));
+            memcpy(item->log_clusters, result->logClusters.constData(),
+                   result->logClusters.size() * sizeof(unsigned short));
+            item->num_glyphs = count;
+            item->kerning_applied = result->kerningApplied;
+            return true;
+        }
+    }
+
+    cache->misses.ref();
+    const HB_Bool shaped = HB_ShapeItem(item);
+    if (!shaped)
+        return shaped;
+
+    const int count = int(item->num_glyphs);
+    QHBShapeResult *result = new QHBShapeResult;
+    result->glyphs = QVector<HB_Glyph>(item->glyphs, item->glyphs + count);
+    result->attributes = QVector<HB_GlyphAttributes>(item->attributes, item->attributes + count);
+    result->advances = QVector<HB_Fixed>(item->advances, item->advances + count);
+    result->offsets = QVector<HB_FixedPoint>(item->offsets, item->offsets + count);
+    result->logClusters = QVector<unsigned short>(item->log_clusters,
+                                                  item->log_clusters + item->item.length);
+    result->kerningApplied = item->kerning_applied;
+
+    const auto locker = qt_scoped_lock(shapeCacheMutex);
+    cache->results.insert(key, result, qMax(count, 1));
+    return shaped;
+}
+
+void qHBShapeCacheStatistics(int *hits, int *misses)
+{
+    QHBShapeCache *cache = shapeCache();
+    *hits = cache ? cache->hits.loadRelaxed() : 0;
+    *misses = cache ? cache->misses.loadRelaxed() : 0;
 }
 
 HB_Face qHBNewFace(void *font, HB_GetFontTableFunc tableFunc)
@@ -103,6 +263,14 @@ HB_Face qHBLoadFace(HB_Face face)
 
 void qHBFreeFace(HB_Face face)
 {
+    if (QHBShapeCache *cache = shapeCache()) {
+        const auto locker = qt_scoped_lock(shapeCacheMutex);
+        const auto keys = cache->results.keys();
+        for (const QHBShapeKey &key : keys) {
+            if (key.face == face)
+                cache->results.remove(key);
+        }
+    }
     HB_FreeFace(face);
 }
 
@@ -342,6 +342,7 @@ static inline uchar hbscript_to_script(uchar script)
 }
 
 Q_CORE_EXPORT HB_Bool qShapeItem(HB_ShaperItem *item);
+Q_CORE_EXPORT void qHBShapeCacheStatistics(int *hits, int *misses);
 
 // ### temporary
 Q_CORE_EXPORT HB_Face qHBNewFace(void *font, HB_GetFontTableFunc tableFunc);
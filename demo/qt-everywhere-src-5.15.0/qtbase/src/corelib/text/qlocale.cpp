@@ -63,6 +63,7 @@
 #include "qvariant.h"
 #include "qstringbuilder.h"
 #include "private/qnumeric_p.h"
+#include <cfloat>
 #include <cmath>
 #ifndef QT_NO_SYSTEMLOCALE
 #   include "qmutex.h"
@@ -4120,9 +4121,127 @@ bool QLocaleData::validateChars(QStringView str, NumberMode numMode, QByteArray
     return true;
 }
 
+/*
+    Fast paths for stringToDouble() and friends: they parse plain decimal
+    numbers, which is what QString::toDouble() and QString::toInt() get most
+    of the time, straight from the UTF-16 data instead of going through
+    numberToCLocale() and the general conversion. Anything else (whitespace,
+    group separators, exponents, localized digits and signs, too many digits)
+    makes them return false, and the caller takes the slow path.
+*/
+static bool qt_fastDecimalDigits(const QChar *&p, const QChar *end, quint64 limit,
+                                 quint64 *value, int *digits)
+{
+    quint64 v = *value;
+    int n = 0;
+    for (; p != end && p->unicode() >= '0' && p->unicode() <= '9'; ++p, ++n) {
+        const uint digit = p->unicode() - '0';
+        if (v > (limit - digit) / 10)
+            return false;
+        v = v * 10 + digit;
+    }
+    *value = v;
+    *digits = n;
+    return true;
+}
+
+static bool qt_fastStringToDouble(QStringView str, char16_t decimal, bool rejectTrailingZeroes,
+                                  double *result)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+    // With excess precision (x87) the division below could round twice
+    Q_UNUSED(str);
+    Q_UNUSED(decimal);
+    Q_UNUSED(rejectTrailingZeroes);
+    Q_UNUSED(result);
+    return false;
+#else
+    // An integer below 2^53 and a power of ten up to 1e22 are both exact
+    // doubles, so the correctly rounded division is the correctly rounded
+    // result of the conversion.
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const quint64 maxMantissa = Q_UINT64_C(1) << 53;
+
+    const QChar *p = str.data();
+    const QChar *end = p + str.size();
+    bool negative = false;
+    if (p != end && (p->unicode() == '-' || p->unicode() == '+'))
+        negative = (p++)->unicode() == '-';
+
+    quint64 mantissa = 0;
+    int intDigits, fracDigits = 0;
+    if (!qt_fastDecimalDigits(p, end, maxMantissa, &mantissa, &intDigits) || intDigits == 0)
+        return false;
+    if (p != end && p->unicode() == decimal) {
+        ++p;
+        if (rejectTrailingZeroes)
+            return false;
+        if (!qt_fastDecimalDigits(p, end, maxMantissa, &mantissa, &fracDigits)
+                || fracDigits == 0 || fracDigits >= int(sizeof(powersOfTen) / sizeof(double))) {
+            return false;
+        }
+    }
+    if (p != end)
+        return false;
+
+    double d = double(mantissa);
+    if (fracDigits)
+        d /= powersOfTen[fracDigits];
+    *result = negative ? -d : d;
+    return true;
+#endif
+}
+
+static bool qt_fastStringToLongLong(QStringView str, qint64 *result)
+{
+    const QChar *p = str.data();
+    const QChar *end = p + str.size();
+    bool negative = false;
+    if (p != end && (p->unicode() == '-' || p->unicode() == '+'))
+        negative = (p++)->unicode() == '-';
+
+    // 18 digits always fit, larger values are range checked on the slow path
+    quint64 value = 0;
+    int digits;
+    if (!qt_fastDecimalDigits(p, end, Q_UINT64_C(999999999999999999), &value, &digits)
+            || digits == 0 || p != end) {
+        return false;
+    }
+    *result = negative ? -qint64(value) : qint64(value);
+    return true;
+}
+
+static bool qt_fastStringToUnsLongLong(QStringView str, quint64 *result)
+{
+    const QChar *p = str.data();
+    const QChar *end = p + str.size();
+    if (p != end && p->unicode() == '+')
+        ++p;
+
+    quint64 value = 0;
+    int digits;
+    if (!qt_fastDecimalDigits(p, end, Q_UINT64_C(9999999999999999999), &value, &digits)
+            || digits == 0 || p != end) {
+        return false;
+    }
+    *result = value;
+    return true;
+}
+
 double QLocaleData::stringToDouble(QStringView str, bool *ok,
                                    QLocale::NumberOptions number_options) const
 {
+    double fast;
+    if (qt_fastStringToDouble(str, m_decimal,
+                              number_options & QLocale::RejectTrailingZeroesAfterDot, &fast)) {
+        if (ok != nullptr)
+            *ok = true;
+        return fast;
+    }
+
     CharBuff buff;
     if (!numberToCLocale(str, number_options, &buff)) {
         if (ok != nullptr)
@@ -4140,6 +4259,13 @@ double QLocaleData::stringToDouble(QStringView str, bool *ok,
 qlonglong QLocaleData::stringToLongLong(QStringView str, int base, bool *ok,
                                         QLocale::NumberOptions number_options) const
 {
+    qint64 fast;
+    if (base == 10 && qt_fastStringToLongLong(str, &fast)) {
+        if (ok != nullptr)
+            *ok = true;
+        return fast;
+    }
+
     CharBuff buff;
     if (!numberToCLocale(str, number_options, &buff)) {
         if (ok != nullptr)
@@ -4153,6 +4279,13 @@ qlonglong QLocaleData::stringToLongLong(QStringView str, int base, bool *ok,
 qulonglong QLocaleData::stringToUnsLongLong(QStringView str, int base, bool *ok,
                                             QLocale::NumberOptions number_options) const
 {
+    quint64 fast;
+    if (base == 10 && qt_fastStringToUnsLongLong(str, &fast)) {
+        if (ok != nullptr)
+            *ok = true;
+        return fast;
+    }
+
     CharBuff buff;
     if (!numberToCLocale(str, number_options, &buff)) {
         if (ok != nullptr)
@@ -42,6 +42,7 @@
 #include "qregularexpression.h"
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qcache.h>
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qvector.h>
@@ -840,6 +841,24 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    A compiled (and, if enabled, JIT-compiled) PCRE2 pattern. It is never
+    modified after it has been built: pcre2_match() only reads the code, so
+    one instance can be shared by any number of QRegularExpression objects,
+    in any thread.
+*/
+struct QRegularExpressionCompiledPattern : QSharedData
+{
+    explicit QRegularExpressionCompiledPattern(pcre2_code_16 *code)
+        : code(code) {}
+    ~QRegularExpressionCompiledPattern() { pcre2_code_free_16(code); }
+
+    pcre2_code_16 * const code;
+
+private:
+    Q_DISABLE_COPY(QRegularExpressionCompiledPattern)
+};
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -876,9 +895,10 @@ struct QRegularExpressionPrivate : QSharedData
     // (right after a detach happened).
     mutable QMutex mutex;
 
-    // The PCRE code pointer is reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // it is set to nullptr
+    // The PCRE code is shared through the compiled pattern cache; compiledPattern
+    // is a shortcut to compiledCode->code. When the private is copied (i.e. a
+    // detach happened) both are reset.
+    QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> compiledCode;
     pcre2_code_16 *compiledPattern;
     int errorCode;
     int errorOffset;
@@ -947,6 +967,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate()
       patternOptions(),
       pattern(),
       mutex(),
+      compiledCode(),
       compiledPattern(nullptr),
       errorCode(0),
       errorOffset(-1),
@@ -978,6 +999,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
       patternOptions(other.patternOptions),
       pattern(other.pattern),
       mutex(),
+      compiledCode(),
       compiledPattern(nullptr),
       errorCode(0),
       errorOffset(-1),
@@ -992,7 +1014,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre2_code_free_16(compiledPattern);
+    compiledCode.reset();
     compiledPattern = nullptr;
     errorCode = 0;
     errorOffset = -1;
@@ -1000,6 +1022,83 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
     usingCrLfNewlines = false;
 }
 
+/*
+    The QRegularExpressionCacheKey struct uniquely identifies a compiled pattern.
+*/
+struct QRegularExpressionCacheKey
+{
+    QString pattern;
+    QRegularExpression::PatternOptions patternOptions;
+
+    inline QRegularExpressionCacheKey(const QString &pattern,
+                                      QRegularExpression::PatternOptions patternOptions)
+        : pattern(pattern), patternOptions(patternOptions) {}
+};
+
+static bool operator==(const QRegularExpressionCacheKey &key1, const QRegularExpressionCacheKey &key2)
+{
+    return key1.pattern == key2.pattern && key1.patternOptions == key2.patternOptions;
+}
+
+static uint qHash(const QRegularExpressionCacheKey &key, uint seed = 0) noexcept
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.pattern);
+    seed = hash(seed, int(key.patternOptions));
+    return seed;
+}
+
+/*
+    Process-wide cache of the most recently used compiled patterns, so that
+    QRegularExpression objects built over and over from the same pattern
+    (in loops, per delegate, in different threads) compile and JIT it once.
+    The entries are reference counted: a pattern evicted from the cache stays
+    alive as long as a QRegularExpression still uses it.
+*/
+struct QRegularExpressionCacheEntry
+{
+    QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> compiledCode;
+};
+
+struct QRegularExpressionCache
+{
+    QRegularExpressionCache() : patterns(256) {}
+
+    QMutex mutex;
+    QCache<QRegularExpressionCacheKey, QRegularExpressionCacheEntry> patterns;
+};
+
+Q_GLOBAL_STATIC(QRegularExpressionCache, compiledPatternCache)
+
+static QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern>
+cachedCompiledPattern(const QRegularExpressionCacheKey &key)
+{
+    if (QRegularExpressionCache *c = compiledPatternCache()) {
+        const QMutexLocker lock(&c->mutex);
+        if (QRegularExpressionCacheEntry *entry = c->patterns.object(key))
+            return entry->compiledCode;
+    }
+    return QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern>();
+}
+
+/*
+    Inserts \a compiledCode in the cache and returns it, or returns the
+    pattern another thread compiled and cached for \a key in the meantime.
+    The cached code must not be modified any more.
+*/
+static QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern>
+cacheCompiledPattern(const QRegularExpressionCacheKey &key,
+                     const QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> &compiledCode)
+{
+    if (QRegularExpressionCache *c = compiledPatternCache()) {
+        const QMutexLocker lock(&c->mutex);
+        if (QRegularExpressionCacheEntry *entry = c->patterns.object(key))
+            return entry->compiledCode;
+        c->patterns.insert(key, new QRegularExpressionCacheEntry{ compiledCode });
+    }
+    return compiledCode;
+}
+
 /*!
     \internal
 */
@@ -1013,26 +1112,34 @@ void QRegularExpressionPrivate::compilePattern()
     isDirty = false;
     cleanCompiledPattern();
 
-    int options = convertToPcreOptions(patternOptions);
-    options |= PCRE2_UTF;
-
-    PCRE2_SIZE patternErrorOffset;
-    compiledPattern = pcre2_compile_16(pattern.utf16(),
-                                       pattern.length(),
-                                       options,
-                                       &errorCode,
-                                       &patternErrorOffset,
-                                       nullptr);
+    const QRegularExpressionCacheKey key(pattern, patternOptions);
+    compiledCode = cachedCompiledPattern(key);
+    if (!compiledCode) {
+        int options = convertToPcreOptions(patternOptions);
+        options |= PCRE2_UTF;
+
+        PCRE2_SIZE patternErrorOffset;
+        pcre2_code_16 *code = pcre2_compile_16(pattern.utf16(),
+                                               pattern.length(),
+                                               options,
+                                               &errorCode,
+                                               &patternErrorOffset,
+                                               nullptr);
+
+        if (!code) {
+            errorOffset = static_cast<int>(patternErrorOffset);
+            return;
+        }
 
-    if (!compiledPattern) {
-        errorOffset = static_cast<int>(patternErrorOffset);
-        return;
-    } else {
-        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
-        errorCode = 0;
+        compiledCode = new QRegularExpressionCompiledPattern(code);
+        compiledPattern = code;
+        optimizePattern();
+        compiledCode = cacheCompiledPattern(key, compiledCode);
     }
 
-    optimizePattern();
+    // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
+    errorCode = 0;
+    compiledPattern = compiledCode->code;
     getPatternInfo();
 }
 
@@ -1134,7 +1241,8 @@ static bool isJitEnabled()
     JIT-compiles the pattern.
 
     It gets called when a pattern is recompiled by us (in compilePattern()),
-    under mutex protection.
+    under mutex protection, before the pattern is published in the compiled
+    pattern cache.
 */
 void QRegularExpressionPrivate::optimizePattern()
 {
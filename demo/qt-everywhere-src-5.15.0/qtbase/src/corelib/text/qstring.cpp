@@ -341,6 +341,286 @@ const ushort *QtPrivate::qustrchr(QStringView str, ushort c) noexcept
 }
 
 #ifdef __SSE2__
+// Runtime-dispatched AVX2 and AVX-512BW kernels, for builds that do not already
+// target those instruction sets. Each kernel only processes whole vectors and
+// stops at the first one that needs a closer look, returning how far it got;
+// the SSE2 code that follows takes over from there.
+#  if !defined(__AVX2__) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+#    define QT_STRING_DISPATCH_AVX2
+#  endif
+#  if !defined(__AVX512BW__) && QT_COMPILER_SUPPORTS_HERE(AVX512BW)
+#    define QT_STRING_DISPATCH_AVX512BW
+#  endif
+
+#  ifdef QT_STRING_DISPATCH_AVX2
+QT_FUNCTION_TARGET(AVX2)
+static const char *qt_find_non_ascii_avx2(const char *ptr, const char *end) noexcept
+{
+    for ( ; ptr + 32 <= end; ptr += 32) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        if (_mm256_movemask_epi8(data))
+            break;
+    }
+    return ptr;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static const char *qt_skip_mask_avx2(const char *ptr, const char *end, quint32 maskval) noexcept
+{
+    const __m256i mask = _mm256_set1_epi32(int(maskval));
+    for ( ; ptr + 32 <= end; ptr += 32) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        if (!_mm256_testz_si256(mask, data))
+            break;
+    }
+    return ptr;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static qsizetype qt_from_latin1_avx2(ushort *dst, const char *str, qsizetype size) noexcept
+{
+    qsizetype offset = 0;
+    for ( ; offset + 32 <= size; offset += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + offset));
+        __m256i first = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk));
+        __m256i second = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset), first);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset + 16), second);
+    }
+    return offset;
+}
+
+// not a lambda: those don't inherit the target attribute
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i mergeQuestionMarks_avx2(__m256i chunk) noexcept
+{
+    // See mergeQuestionMarks in qt_to_latin1_internal for details
+    const __m256i questionMark = _mm256_set1_epi16('?');
+    const __m256i outOfRange = _mm256_set1_epi16(0x100);
+    chunk = _mm256_min_epu16(chunk, outOfRange);
+    const __m256i offLimitMask = _mm256_cmpeq_epi16(chunk, outOfRange);
+    return _mm256_blendv_epi8(chunk, questionMark, offLimitMask);
+}
+
+template <bool Checked>
+QT_FUNCTION_TARGET(AVX2)
+static qsizetype qt_to_latin1_avx2(uchar *dst, const ushort *src, qsizetype length) noexcept
+{
+    qsizetype offset = 0;
+    for ( ; offset + 32 <= length; offset += 32) {
+        __m256i chunk1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + offset));
+        __m256i chunk2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + offset + 16));
+        if (Checked) {
+            chunk1 = mergeQuestionMarks_avx2(chunk1);
+            chunk2 = mergeQuestionMarks_avx2(chunk2);
+        }
+
+        // VPACKUSWB packs each 128-bit lane separately, so put the quadwords back in order
+        __m256i result = _mm256_packus_epi16(chunk1, chunk2);
+        result = _mm256_permute4x64_epi64(result, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset), result);
+    }
+    return offset;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static qsizetype ucstrncmp_avx2(const ushort *a, const ushort *b, qsizetype l) noexcept
+{
+    qsizetype offset = 0;
+    for ( ; offset + 16 <= l; offset += 16) {
+        __m256i a_data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + offset));
+        __m256i b_data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + offset));
+        __m256i result = _mm256_cmpeq_epi16(a_data, b_data);
+        if (~uint(_mm256_movemask_epi8(result)))
+            break;
+    }
+    return offset;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static qsizetype ucstrncmp_avx2(const ushort *uc, const uchar *c, qsizetype l) noexcept
+{
+    qsizetype offset = 0;
+    for ( ; offset + 16 <= l; offset += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c + offset));
+        __m256i ldata = _mm256_cvtepu8_epi16(chunk);
+        __m256i ucdata = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(uc + offset));
+        __m256i result = _mm256_cmpeq_epi16(ldata, ucdata);
+        if (~uint(_mm256_movemask_epi8(result)))
+            break;
+    }
+    return offset;
+}
+#  endif // QT_STRING_DISPATCH_AVX2
+
+#  ifdef QT_STRING_DISPATCH_AVX512BW
+QT_FUNCTION_TARGET(AVX512BW)
+static const char *qt_find_non_ascii_avx512bw(const char *ptr, const char *end) noexcept
+{
+    for ( ; ptr + 64 <= end; ptr += 64) {
+        __m512i data = _mm512_loadu_si512(ptr);
+        if (_mm512_movepi8_mask(data))
+            break;
+    }
+    return ptr;
+}
+
+QT_FUNCTION_TARGET(AVX512BW)
+static const char *qt_skip_mask_avx512bw(const char *ptr, const char *end, quint32 maskval) noexcept
+{
+    const __m512i mask = _mm512_set1_epi32(int(maskval));
+    for ( ; ptr + 64 <= end; ptr += 64) {
+        __m512i data = _mm512_loadu_si512(ptr);
+        if (_mm512_test_epi32_mask(mask, data))
+            break;
+    }
+    return ptr;
+}
+
+QT_FUNCTION_TARGET(AVX512BW)
+static qsizetype qt_from_latin1_avx512bw(ushort *dst, const char *str, qsizetype size) noexcept
+{
+    qsizetype offset = 0;
+    for ( ; offset + 32 <= size; offset += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + offset));
+        _mm512_storeu_si512(dst + offset, _mm512_cvtepu8_epi16(chunk));
+    }
+    return offset;
+}
+
+template <bool Checked>
+QT_FUNCTION_TARGET(AVX512BW)
+static qsizetype qt_to_latin1_avx512bw(uchar *dst, const ushort *src, qsizetype length) noexcept
+{
+    const __m512i questionMark = _mm512_set1_epi16('?');
+    const __m512i latin1Max = _mm512_set1_epi16(0xff);
+    // VPACKUSWB packs each 128-bit lane separately, so gather the even quadwords
+    const __m512i order = _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+
+    qsizetype offset = 0;
+    for ( ; offset + 32 <= length; offset += 32) {
+        __m512i chunk = _mm512_loadu_si512(src + offset);
+        if (Checked)
+            chunk = _mm512_mask_mov_epi16(chunk, _mm512_cmpgt_epu16_mask(chunk, latin1Max), questionMark);
+
+        __m512i packed = _mm512_permutexvar_epi64(order, _mm512_packus_epi16(chunk, chunk));
+        __m256i result = _mm512_castsi512_si256(packed);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset), result);
+    }
+    return offset;
+}
+
+QT_FUNCTION_TARGET(AVX512BW)
+static qsizetype ucstrncmp_avx512bw(const ushort *a, const ushort *b, qsizetype l) noexcept
+{
+    qsizetype offset = 0;
+    for ( ; offset + 32 <= l; offset += 32) {
+        __m512i a_data = _mm512_loadu_si512(a + offset);
+        __m512i b_data = _mm512_loadu_si512(b + offset);
+        if (_mm512_cmpneq_epi16_mask(a_data, b_data))
+            break;
+    }
+    return offset;
+}
+
+QT_FUNCTION_TARGET(AVX512BW)
+static qsizetype ucstrncmp_avx512bw(const ushort *uc, const uchar *c, qsizetype l) noexcept
+{
+    qsizetype offset = 0;
+    for ( ; offset + 32 <= l; offset += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + offset));
+        __m512i ldata = _mm512_cvtepu8_epi16(chunk);
+        __m512i ucdata = _mm512_loadu_si512(uc + offset);
+        if (_mm512_cmpneq_epi16_mask(ldata, ucdata))
+            break;
+    }
+    return offset;
+}
+#  endif // QT_STRING_DISPATCH_AVX512BW
+
+// The dispatchers: the wide kernels are only worth it for longer strings. If
+// no kernel runs, they return the input position.
+static inline const char *qt_find_non_ascii_wide(const char *ptr, const char *end) noexcept
+{
+#  ifdef QT_STRING_DISPATCH_AVX512BW
+    if (end - ptr >= 128 && qCpuHasFeature(AVX512BW))
+        return qt_find_non_ascii_avx512bw(ptr, end);
+#  endif
+#  ifdef QT_STRING_DISPATCH_AVX2
+    if (end - ptr >= 64 && qCpuHasFeature(AVX2))
+        return qt_find_non_ascii_avx2(ptr, end);
+#  endif
+    Q_UNUSED(end);
+    return ptr;
+}
+
+static inline const char *qt_skip_mask_wide(const char *ptr, const char *end, quint32 maskval) noexcept
+{
+#  ifdef QT_STRING_DISPATCH_AVX512BW
+    if (end - ptr >= 128 && qCpuHasFeature(AVX512BW))
+        return qt_skip_mask_avx512bw(ptr, end, maskval);
+#  endif
+#  ifdef QT_STRING_DISPATCH_AVX2
+    if (end - ptr >= 64 && qCpuHasFeature(AVX2))
+        return qt_skip_mask_avx2(ptr, end, maskval);
+#  endif
+    Q_UNUSED(end);
+    Q_UNUSED(maskval);
+    return ptr;
+}
+
+static inline qsizetype qt_from_latin1_wide(ushort *dst, const char *str, qsizetype size) noexcept
+{
+#  ifdef QT_STRING_DISPATCH_AVX512BW
+    if (size >= 64 && qCpuHasFeature(AVX512BW))
+        return qt_from_latin1_avx512bw(dst, str, size);
+#  endif
+#  ifdef QT_STRING_DISPATCH_AVX2
+    if (size >= 32 && qCpuHasFeature(AVX2))
+        return qt_from_latin1_avx2(dst, str, size);
+#  endif
+    Q_UNUSED(dst);
+    Q_UNUSED(str);
+    Q_UNUSED(size);
+    return 0;
+}
+
+template <bool Checked>
+static inline qsizetype qt_to_latin1_wide(uchar *dst, const ushort *src, qsizetype length) noexcept
+{
+#  ifdef QT_STRING_DISPATCH_AVX512BW
+    if (length >= 64 && qCpuHasFeature(AVX512BW))
+        return qt_to_latin1_avx512bw<Checked>(dst, src, length);
+#  endif
+#  ifdef QT_STRING_DISPATCH_AVX2
+    if (length >= 32 && qCpuHasFeature(AVX2))
+        return qt_to_latin1_avx2<Checked>(dst, src, length);
+#  endif
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(length);
+    return 0;
+}
+
+// Returns the offset of the first vector that has a difference, or of the
+// part too short to be handled
+template <typename Char>
+static inline qsizetype ucstrncmp_wide(const ushort *a, const Char *b, qsizetype l) noexcept
+{
+#  ifdef QT_STRING_DISPATCH_AVX512BW
+    if (l >= 64 && qCpuHasFeature(AVX512BW))
+        return ucstrncmp_avx512bw(a, b, l);
+#  endif
+#  ifdef QT_STRING_DISPATCH_AVX2
+    if (l >= 32 && qCpuHasFeature(AVX2))
+        return ucstrncmp_avx2(a, b, l);
+#  endif
+    Q_UNUSED(a);
+    Q_UNUSED(b);
+    Q_UNUSED(l);
+    return 0;
+}
+
 // Scans from \a ptr to \a end until \a maskval is non-zero. Returns true if
 // the no non-zero was found. Returns false and updates \a ptr to point to the
 // first 16-bit word that has any bit set (note: if the input is 8-bit, \a ptr
@@ -354,6 +634,8 @@ static bool simdTestMask(const char *&ptr, const char *end, quint32 maskval)
         return false;
     };
 
+    ptr = qt_skip_mask_wide(ptr, end, maskval);
+
 #  if defined(__SSE4_1__)
     __m128i mask;
     auto updatePtrSimd = [&](__m128i data) {
@@ -460,6 +742,8 @@ static Q_ALWAYS_INLINE __m128i mm_load8_zero_extend(const void *ptr)
 bool qt_is_ascii(const char *&ptr, const char *end) noexcept
 {
 #if defined(__SSE2__)
+    ptr = qt_find_non_ascii_wide(ptr, end);
+
     // Testing for the high bit can be done efficiently with just PMOVMSKB
 #  if defined(__AVX2__)
     while (ptr + 32 <= end) {
@@ -493,6 +777,12 @@ bool qt_is_ascii(const char *&ptr, const char *end) noexcept
         }
         ptr += 8;
     }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vmaxv is only available on Aarch64
+    // stop at the first chunk with a non-ASCII byte and find it below
+    for ( ; ptr + 16 <= end; ptr += 16) {
+        if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(ptr))) & 0x80)
+            break;
+    }
 #endif
 
     while (ptr + 4 <= end) {
@@ -534,6 +824,11 @@ static bool isAscii(const QChar *&ptr, const QChar *end)
     ptr = reinterpret_cast<const QChar *>(ptr8);
     if (!ok)
         return false;
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vmaxv is only available on Aarch64
+    for ( ; end - ptr >= 8; ptr += 8) {
+        if (vmaxvq_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(ptr))) >= 0x80)
+            break;
+    }
 #endif
 
     while (ptr != end) {
@@ -582,6 +877,11 @@ bool QtPrivate::isLatin1(QStringView s) noexcept
         if (_mm_movemask_epi8(comparison))
             return false;
     }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vmaxv is only available on Aarch64
+    for ( ; end - ptr >= 8; ptr += 8) {
+        if (vmaxvq_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(ptr))) > 0xff)
+            return false;
+    }
 #endif
 
     while (ptr != end) {
@@ -615,7 +915,7 @@ void qt_from_latin1(ushort *dst, const char *str, size_t size) noexcept
      */
 #if defined(__SSE2__)
     const char *e = str + size;
-    qptrdiff offset = 0;
+    qptrdiff offset = qt_from_latin1_wide(dst, str, qsizetype(size));
 
     // we're going to read str[offset..offset+15] (16 bytes)
     for ( ; str + offset + 15 < e; offset += 16) {
@@ -669,7 +969,7 @@ static void qt_to_latin1_internal(uchar *dst, const ushort *src, qsizetype lengt
 {
 #if defined(__SSE2__)
     uchar *e = dst + length;
-    qptrdiff offset = 0;
+    qptrdiff offset = qt_to_latin1_wide<Checked>(dst, src, length);
 
 #  ifdef __AVX2__
     const __m256i questionMark256 = _mm256_broadcastw_epi16(_mm_cvtsi32_si128('?'));
@@ -913,7 +1213,8 @@ static int ucstrncmp(const QChar *a, const QChar *b, size_t l)
 #endif // __mips_dsp
 #ifdef __SSE2__
     const QChar *end = a + l;
-    qptrdiff offset = 0;
+    qptrdiff offset = ucstrncmp_wide(reinterpret_cast<const ushort *>(a),
+                                     reinterpret_cast<const ushort *>(b), qsizetype(l));
 
     // Using the PMOVMSKB instruction, we get two bits for each character
     // we compare.
@@ -1060,7 +1361,7 @@ static int ucstrncmp(const QChar *a, const uchar *c, size_t l)
 
 #ifdef __SSE2__
     __m128i nullmask = _mm_setzero_si128();
-    qptrdiff offset = 0;
+    qptrdiff offset = ucstrncmp_wide(uc, c, qsizetype(l));
 
 #  if !defined(__OPTIMIZE_SIZE__)
     // Using the PMOVMSKB instruction, we get two bits for each character
@@ -1150,6 +1451,14 @@ static int ucstrncmp(const QChar *a, const uchar *c, size_t l)
     const auto lambda = [=](size_t i) { return uc[i] - ushort(c[i]); };
     return UnrollTailLoop<MaxTailLength>::exec(e - uc, 0, lambda, lambda);
 #  endif
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vminv is only available on Aarch64
+    // stop at the first chunk with a difference and find it below
+    for ( ; e - uc >= 8; uc += 8, c += 8) {
+        uint16x8_t ldata = vmovl_u8(vld1_u8(c));
+        uint16x8_t ucdata = vld1q_u16(uc);
+        if (!vminvq_u16(vceqq_u16(ldata, ucdata)))
+            break;
+    }
 #endif
 
     while (uc < e) {
@@ -12093,6 +12402,8 @@ static inline qsizetype qFindChar(QStringView str, QChar ch, qsizetype from, Qt:
             n = QtPrivate::qustrchr(QStringView(n, e), c);
             if (n != e)
                 return n - s;
+        } else if (c <= 0xff) {
+            return qt_find_latin1_case_insensitive(str, from, QStringView(&ch, 1));
         } else {
             c = foldCase(c);
             --n;
@@ -12120,6 +12431,9 @@ qsizetype QtPrivate::findString(QStringView haystack0, qsizetype from, QStringVi
     if (sl == 1)
         return qFindChar(haystack0, needle0[0], from, cs);
 
+    if (cs == Qt::CaseInsensitive && qt_can_find_latin1_case_insensitive(needle0))
+        return qt_find_latin1_case_insensitive(haystack0, from, needle0);
+
     /*
         We use the Boyer-Moore algorithm in cases where the overhead
         for the skip table should pay off, otherwise we use a simple
@@ -121,6 +121,120 @@ static inline qsizetype bm_find(const ushort *uc, qsizetype l, qsizetype index,
     return -1; // not found
 }
 
+// Case-insensitive search for needles that start and end with Latin-1
+// characters: a SIMD scan finds the positions where both the first and the
+// last character of the needle can match, and only those are compared in
+// full. Haystack characters outside Latin-1 are always candidates, since some
+// of them fold to Latin-1 ones (e.g. U+212A KELVIN SIGN to 'k').
+static inline bool qt_can_find_latin1_case_insensitive(QStringView needle) noexcept
+{
+    return !needle.isEmpty() && needle.front().unicode() <= 0xff && needle.back().unicode() <= 0xff;
+}
+
+// Within Latin-1, case folding only maps the letters below to their lower
+// case forms (U+00B5 MICRO SIGN folds outside Latin-1, to U+03BC).
+static inline ushort latin1FoldLower(ushort c) noexcept
+{
+    if ((c >= 'A' && c <= 'Z') || (c >= 0xc0 && c <= 0xde && c != 0xd7))
+        return c + 0x20;
+    return c;
+}
+
+static inline ushort latin1FoldUpper(ushort c) noexcept
+{
+    if ((c >= 'a' && c <= 'z') || (c >= 0xe0 && c <= 0xfe && c != 0xf7))
+        return c - 0x20;
+    return c;
+}
+
+static qsizetype qt_find_latin1_case_insensitive(QStringView haystack0, qsizetype from,
+                                                 QStringView needle0) noexcept
+{
+    Q_ASSERT(qt_can_find_latin1_case_insensitive(needle0));
+    const ushort *haystack = reinterpret_cast<const ushort *>(haystack0.data());
+    const qsizetype l = haystack0.size();
+    const qsizetype sl = needle0.size();
+    const qsizetype last = sl - 1;
+
+    const ushort firstLower = latin1FoldLower(needle0.front().unicode());
+    const ushort firstUpper = latin1FoldUpper(firstLower);
+    const ushort lastLower = latin1FoldLower(needle0.back().unicode());
+    const ushort lastUpper = latin1FoldUpper(lastLower);
+    const ushort foldedFirst = foldCase(needle0.front().unicode());
+
+    // haystack[i] is a case variant of the needle's first character or is
+    // outside Latin-1, and the same goes for the last one
+    auto matchesAt = [=](qsizetype i) {
+        if (haystack[i] > 0xff && foldCase(haystack[i]) != foldedFirst)
+            return false;
+        return sl == 1 || QtPrivate::compareStrings(needle0, QStringView(haystack + i, sl),
+                                                    Qt::CaseInsensitive) == 0;
+    };
+
+    qsizetype i = qMax(from, qsizetype(0));
+#if defined(__SSE2__)
+    const __m128i firstLowerV = _mm_set1_epi16(short(firstLower));
+    const __m128i firstUpperV = _mm_set1_epi16(short(firstUpper));
+    const __m128i lastLowerV = _mm_set1_epi16(short(lastLower));
+    const __m128i lastUpperV = _mm_set1_epi16(short(lastUpper));
+    const __m128i highByte = _mm_set1_epi16(short(0xff00));
+
+    // Using the PMOVMSKB instruction, we get two bits for each character
+    auto candidates = [=](const ushort *ptr, __m128i lower, __m128i upper) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i variant = _mm_or_si128(_mm_cmpeq_epi16(data, lower), _mm_cmpeq_epi16(data, upper));
+        const __m128i latin1 = _mm_cmpeq_epi16(_mm_and_si128(data, highByte), _mm_setzero_si128());
+        return uint(_mm_movemask_epi8(variant)) | (~uint(_mm_movemask_epi8(latin1)) & 0xffff);
+    };
+
+    // we're going to read haystack[i..i+7] and haystack[i+last..i+last+7]
+    for ( ; i + last + 8 <= l; i += 8) {
+        uint mask = candidates(haystack + i, firstLowerV, firstUpperV)
+                & candidates(haystack + i + last, lastLowerV, lastUpperV);
+        while (mask) {
+            const qsizetype idx = qCountTrailingZeroBits(mask) / 2;
+            if (matchesAt(i + idx))
+                return i + idx;
+            mask &= ~(3u << (2 * idx));
+        }
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vaddv is only available on Aarch64
+    const uint16x8_t firstLowerV = vdupq_n_u16(firstLower);
+    const uint16x8_t firstUpperV = vdupq_n_u16(firstUpper);
+    const uint16x8_t lastLowerV = vdupq_n_u16(lastLower);
+    const uint16x8_t lastUpperV = vdupq_n_u16(lastUpper);
+    const uint16x8_t latin1Max = vdupq_n_u16(0xff);
+    const uint16x8_t bits = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+
+    auto candidates = [=](const ushort *ptr, uint16x8_t lower, uint16x8_t upper) {
+        const uint16x8_t data = vld1q_u16(ptr);
+        uint16x8_t result = vorrq_u16(vceqq_u16(data, lower), vceqq_u16(data, upper));
+        result = vorrq_u16(result, vcgtq_u16(data, latin1Max));
+        return uint(vaddvq_u16(vandq_u16(result, bits)));
+    };
+
+    for ( ; i + last + 8 <= l; i += 8) {
+        uint mask = candidates(haystack + i, firstLowerV, firstUpperV)
+                & candidates(haystack + i + last, lastLowerV, lastUpperV);
+        while (mask) {
+            const qsizetype idx = qCountTrailingZeroBits(mask);
+            if (matchesAt(i + idx))
+                return i + idx;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for ( ; i + last < l; ++i) {
+        const ushort a = haystack[i];
+        const ushort b = haystack[i + last];
+        if ((a == firstLower || a == firstUpper || a > 0xff)
+                && (b == lastLower || b == lastUpper || b > 0xff) && matchesAt(i))
+            return i;
+    }
+    return -1;
+}
+
 /*!
     \class QStringMatcher
     \inmodule QtCore
@@ -316,6 +430,11 @@ qsizetype QStringMatcher::indexIn(QStringView str, qsizetype from) const
 {
     if (from < 0)
         from = 0;
+    if (q_cs == Qt::CaseInsensitive) {
+        const QStringView pattern(p.uc, p.len);
+        if (qt_can_find_latin1_case_insensitive(pattern))
+            return qt_find_latin1_case_insensitive(str, from, pattern);
+    }
     return bm_find((const ushort *)str.data(), str.size(), from,
                    (const ushort *)p.uc, p.len,
                    p.q_skiptable, q_cs);
@@ -41,6 +41,16 @@
 #include <qcryptographichash.h>
 #include <qiodevice.h>
 
+#if !defined(QT_BOOTSTRAPPED)
+#include "qcryptographichash_p.h"
+#include <qfile.h>
+#include <qatomic.h>
+#if QT_CONFIG(thread)
+#include <qthreadpool.h>
+#include <qsemaphore.h>
+#endif
+#endif
+
 #include "../../3rdparty/sha1/sha1.cpp"
 
 #if defined(QT_BOOTSTRAPPED) && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1)
@@ -421,6 +431,9 @@ void QCryptographicHash::addData(const QByteArray &data)
 /*!
   Reads the data from the open QIODevice \a device until it ends
   and hashes it. Returns \c true if reading was successful.
+
+  Files that can be memory-mapped are hashed directly from the mapping,
+  in large windows, instead of being copied through a read buffer.
   \since 5.0
  */
 bool QCryptographicHash::addData(QIODevice* device)
@@ -431,7 +444,28 @@ bool QCryptographicHash::addData(QIODevice* device)
     if (!device->isOpen())
         return false;
 
-    char buffer[1024];
+#if !defined(QT_BOOTSTRAPPED)
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if (file && !file->isSequential() && !file->isWritable() && !file->isTextModeEnabled()) {
+        // 64 MB at a time keeps the address space use bounded on 32-bit
+        const qint64 windowSize = 64 * 1024 * 1024;
+        const qint64 size = file->size();
+        qint64 pos = file->pos();
+        while (pos < size) {
+            const qint64 length = qMin(windowSize, size - pos);
+            uchar *window = file->map(pos, length);
+            if (!window)
+                break;  // not mappable, read the rest below
+            addData(reinterpret_cast<const char *>(window), int(length));
+            file->unmap(window);
+            pos += length;
+        }
+        if (pos != file->pos() && !file->seek(pos))
+            return false;
+    }
+#endif
+
+    char buffer[16 * 1024];
     int length;
 
     while ((length = device->read(buffer,sizeof(buffer))) > 0)
@@ -548,6 +582,62 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+#if !defined(QT_BOOTSTRAPPED)
+/*!
+  \internal
+
+  Returns the hashes of the files \a fileNames using \a method, in the
+  same order. Files that cannot be read get an empty hash.
+
+  The files are distributed over the global QThreadPool, using at most
+  \a maxThreads threads (all of the pool's if negative); the calling
+  thread hashes files too.
+*/
+QVector<QByteArray> qt_hashFiles(const QStringList &fileNames,
+                                 QCryptographicHash::Algorithm method, int maxThreads)
+{
+    QVector<QByteArray> results(fileNames.size());
+    QByteArray *out = results.data();   // detach once, before the threads start
+    QAtomicInt next(0);
+
+    auto hashFiles = [&]() {
+        int i;
+        while ((i = next.fetchAndAddRelaxed(1)) < fileNames.size()) {
+            QFile file(fileNames.at(i));
+            if (!file.open(QIODevice::ReadOnly))
+                continue;
+            QCryptographicHash hash(method);
+            if (hash.addData(&file))
+                out[i] = hash.result();
+        }
+    };
+
+    int helpers = 0;
+#if QT_CONFIG(thread)
+    QThreadPool *pool = QThreadPool::globalInstance();
+    if (maxThreads < 0)
+        maxThreads = pool->maxThreadCount();
+    helpers = qMax(0, qMin(maxThreads, fileNames.size()) - 1);
+    QSemaphore done;
+    for (int started = 0; started < helpers; ++started) {
+        if (!pool->tryStart([&]() { hashFiles(); done.release(); })) {
+            helpers = started;
+            break;
+        }
+    }
+#else
+    Q_UNUSED(maxThreads);
+#endif
+
+    hashFiles();
+
+#if QT_CONFIG(thread)
+    done.acquire(helpers);
+#endif
+    return results;
+}
+#endif // QT_BOOTSTRAPPED
+
 /*!
   Returns the size of the output of the selected hash \a method in bytes.
 
@@ -0,0 +1,777 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qcontainerfwd.h>
+#include <QtCore/qglobal.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define QFLATHASH_NEON
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QFlatHashPrivate {
+
+// Every slot of the table has a control byte: Empty, Deleted, or, for a
+// used slot, the low 7 bits of the hash of its key. Lookups compare the
+// control bytes of a whole group of slots at once.
+enum : qint8 {
+    Empty = -128,
+    Deleted = -2
+};
+
+enum { GroupWidth = 16 };
+
+struct BitMask
+{
+#ifdef QFLATHASH_NEON
+    // four bits per slot, see Group::toMask()
+    typedef quint64 Mask;
+    enum { Shift = 2 };
+#else
+    typedef uint Mask;
+    enum { Shift = 0 };
+#endif
+    Mask mask;
+
+    explicit operator bool() const noexcept { return mask != 0; }
+    int lowest() const noexcept { return int(qCountTrailingZeroBits(mask) >> Shift); }
+    void removeLowest() noexcept { mask &= mask - 1; }
+    void removeBelow(int slot) noexcept { mask &= ~Mask(0) << (slot << Shift); }
+};
+
+struct Group
+{
+#if defined(__SSE2__)
+    __m128i ctrl;
+
+    explicit Group(const qint8 *p) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+
+    BitMask match(qint8 tag) const noexcept
+    { return { uint(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag)))) }; }
+    BitMask matchEmpty() const noexcept { return match(Empty); }
+    // Empty and Deleted are the control bytes with the sign bit set
+    BitMask matchFree() const noexcept { return { uint(_mm_movemask_epi8(ctrl)) }; }
+    BitMask matchUsed() const noexcept { return { uint(~_mm_movemask_epi8(ctrl)) & 0xffffu }; }
+#elif defined(QFLATHASH_NEON)
+    int8x16_t ctrl;
+
+    explicit Group(const qint8 *p) noexcept : ctrl(vld1q_s8(p)) {}
+
+    // There is no movemask on NEON: narrowing each 16-bit lane by four bits
+    // leaves one nibble per byte of the comparison result.
+    static BitMask toMask(uint8x16_t cmp) noexcept
+    {
+        const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+        return { vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & Q_UINT64_C(0x8888888888888888) };
+    }
+
+    BitMask match(qint8 tag) const noexcept { return toMask(vceqq_s8(ctrl, vdupq_n_s8(tag))); }
+    BitMask matchEmpty() const noexcept { return match(Empty); }
+    BitMask matchFree() const noexcept { return toMask(vcltq_s8(ctrl, vdupq_n_s8(0))); }
+    BitMask matchUsed() const noexcept { return toMask(vcgeq_s8(ctrl, vdupq_n_s8(0))); }
+#else
+    qint8 ctrl[GroupWidth];
+
+    explicit Group(const qint8 *p) noexcept { memcpy(ctrl, p, GroupWidth); }
+
+    BitMask match(qint8 tag) const noexcept
+    {
+        uint mask = 0;
+        for (int i = 0; i < GroupWidth; ++i)
+            mask |= uint(ctrl[i] == tag) << i;
+        return { mask };
+    }
+    BitMask matchEmpty() const noexcept { return match(Empty); }
+    BitMask matchFree() const noexcept
+    {
+        uint mask = 0;
+        for (int i = 0; i < GroupWidth; ++i)
+            mask |= uint(ctrl[i] < 0) << i;
+        return { mask };
+    }
+    BitMask matchUsed() const noexcept { return { ~matchFree().mask & 0xffffu }; }
+#endif
+};
+
+// At most 7/8 of the slots are used, so that probing always finds an
+// empty slot quickly.
+inline size_t maxLoad(size_t capacity) noexcept
+{
+    return capacity - capacity / 8;
+}
+
+inline size_t capacityForSize(size_t size) noexcept
+{
+    if (!size)
+        return 0;
+    size_t capacity = GroupWidth;
+    while (maxLoad(capacity) < size)
+        capacity *= 2;
+    return capacity;
+}
+
+// qHash() of integers and pointers is the identity, but the table needs
+// well-distributed bits in both halves of the hash.
+inline size_t mix(uint hash) noexcept
+{
+    const quint64 h = quint64(hash) * Q_UINT64_C(0x9e3779b97f4a7c15);
+    return size_t(h ^ (h >> 32));
+}
+
+template <typename Node>
+struct Data
+{
+    QtPrivate::RefCount ref;
+    size_t capacity;            // a power of two, at least GroupWidth
+    size_t size;
+    size_t growthLeft;          // empty slots that may still be used before rehashing
+    uint seed;
+    Node *nodes;
+    qint8 *ctrl;                // capacity bytes, stored after the nodes
+
+    static Data *allocate(size_t capacity, uint seed)
+    {
+        Q_ASSERT(capacity && (capacity & (capacity - 1)) == 0);
+        Data *d = new Data;
+        d->nodes = static_cast<Node *>(::malloc(capacity * (sizeof(Node) + 1)));
+        if (!d->nodes) {
+            delete d;
+            qBadAlloc();
+        }
+        d->ref.initializeOwned();
+        d->capacity = capacity;
+        d->size = 0;
+        d->growthLeft = maxLoad(capacity);
+        d->seed = seed;
+        d->ctrl = reinterpret_cast<qint8 *>(d->nodes + capacity);
+        memset(d->ctrl, Empty, capacity);
+        return d;
+    }
+
+    static void free(Data *d)
+    {
+        if (QTypeInfo<Node>::isComplex) {
+            for (size_t i = d->nextUsed(0); i < d->capacity; i = d->nextUsed(i + 1))
+                d->nodes[i].~Node();
+        }
+        ::free(d->nodes);
+        delete d;
+    }
+
+    // Copies the table slot for slot, so that indexes stay valid
+    Data *clone() const
+    {
+        Data *x = allocate(capacity, seed);
+        for (size_t i = nextUsed(0); i < capacity; i = nextUsed(i + 1)) {
+            new (x->nodes + i) Node(nodes[i]);
+        }
+        x->size = size;
+        x->growthLeft = growthLeft;
+        memcpy(x->ctrl, ctrl, capacity);
+        return x;
+    }
+
+    size_t nextUsed(size_t i) const noexcept
+    {
+        while (i < capacity) {
+            const size_t base = i & ~size_t(GroupWidth - 1);
+            BitMask used = Group(ctrl + base).matchUsed();
+            used.removeBelow(int(i - base));
+            if (used)
+                return base + used.lowest();
+            i = base + GroupWidth;
+        }
+        return capacity;
+    }
+
+    // Returns the first free slot on the probe sequence of hash
+    size_t findFree(size_t hash) const noexcept
+    {
+        const size_t groupMask = capacity / GroupWidth - 1;
+        size_t group = (hash >> 7) & groupMask;
+        for (size_t step = 1; ; ++step) {
+            const size_t base = group * GroupWidth;
+            const BitMask free = Group(ctrl + base).matchFree();
+            if (free)
+                return base + free.lowest();
+            group = (group + step) & groupMask;
+        }
+    }
+
+    void markUsed(size_t i, size_t hash) noexcept
+    {
+        if (ctrl[i] == Empty)
+            --growthLeft;
+        ctrl[i] = qint8(hash & 0x7f);
+        ++size;
+    }
+
+    void erase(size_t i) noexcept
+    {
+        nodes[i].~Node();
+        // Probing stops at the first group with an empty slot, so if this
+        // group has one, no probe sequence continues past it and the slot
+        // can be made empty again instead of leaving a tombstone.
+        const size_t base = i & ~size_t(GroupWidth - 1);
+        if (Group(ctrl + base).matchEmpty()) {
+            ctrl[i] = Empty;
+            ++growthLeft;
+        } else {
+            ctrl[i] = Deleted;
+        }
+        --size;
+    }
+};
+
+} // namespace QFlatHashPrivate
+
+template <class Key, class T>
+class QFlatHash
+{
+    struct Node
+    {
+        Key key;
+        T value;
+
+        Node(const Key &k, const T &v) : key(k), value(v) {}
+        Node(const Key &k, T &&v) : key(k), value(std::move(v)) {}
+    };
+    typedef QFlatHashPrivate::Data<Node> Data;
+
+    Data *d;
+
+    static size_t hashOf(const Key &key, uint seed)
+    { return QFlatHashPrivate::mix(qHash(key, seed)); }
+
+public:
+    inline QFlatHash() noexcept : d(nullptr) {}
+    inline QFlatHash(std::initializer_list<std::pair<Key, T> > list)
+        : d(nullptr)
+    {
+        reserve(int(list.size()));
+        for (auto it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+    QFlatHash(const QFlatHash &other) noexcept : d(other.d) { if (d) d->ref.ref(); }
+    QFlatHash(QFlatHash &&other) noexcept : d(other.d) { other.d = nullptr; }
+    ~QFlatHash() { if (d && !d->ref.deref()) Data::free(d); }
+
+    QFlatHash &operator=(const QFlatHash &other) noexcept
+    {
+        QFlatHash copy(other);
+        swap(copy);
+        return *this;
+    }
+    QFlatHash &operator=(QFlatHash &&other) noexcept
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+    void swap(QFlatHash &other) noexcept { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    inline bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const noexcept { return d ? int(d->size) : 0; }
+    inline int count() const noexcept { return size(); }
+    inline bool isEmpty() const noexcept { return size() == 0; }
+    inline int capacity() const noexcept { return d ? int(d->capacity) : 0; }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d && d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const noexcept { return !d || !d->ref.isShared(); }
+    inline bool isSharedWith(const QFlatHash &other) const noexcept { return d && d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return find_helper(key) != npos(); }
+    int count(const Key &key) const { return contains(key) ? 1 : 0; }
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    const Key key(const T &value) const;
+    const Key key(const T &value, const Key &defaultKey) const;
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QFlatHash;
+        friend class const_iterator;
+        Data *d;
+        size_t i;
+        iterator(Data *data, size_t index) noexcept : d(data), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        constexpr iterator() noexcept : d(nullptr), i(0) {}
+
+        inline const Key &key() const noexcept { return d->nodes[i].key; }
+        inline T &value() const noexcept { return d->nodes[i].value; }
+        inline T &operator*() const noexcept { return value(); }
+        inline T *operator->() const noexcept { return &value(); }
+        inline bool operator==(const iterator &o) const noexcept { return i == o.i && d == o.d; }
+        inline bool operator!=(const iterator &o) const noexcept { return !(*this == o); }
+
+        inline iterator &operator++() noexcept { i = d->nextUsed(i + 1); return *this; }
+        inline iterator operator++(int) noexcept { iterator r = *this; ++*this; return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class QFlatHash;
+        const Data *d;
+        size_t i;
+        const_iterator(const Data *data, size_t index) noexcept : d(data), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        constexpr const_iterator() noexcept : d(nullptr), i(0) {}
+        inline const_iterator(const iterator &o) noexcept : d(o.d), i(o.i) {}
+
+        inline const Key &key() const noexcept { return d->nodes[i].key; }
+        inline const T &value() const noexcept { return d->nodes[i].value; }
+        inline const T &operator*() const noexcept { return value(); }
+        inline const T *operator->() const noexcept { return &value(); }
+        inline bool operator==(const const_iterator &o) const noexcept { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const noexcept { return !(*this == o); }
+
+        inline const_iterator &operator++() noexcept { i = d->nextUsed(i + 1); return *this; }
+        inline const_iterator operator++(int) noexcept { const_iterator r = *this; ++*this; return r; }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, d ? d->nextUsed(0) : 0); }
+    inline const_iterator begin() const noexcept { return constBegin(); }
+    inline const_iterator cbegin() const noexcept { return constBegin(); }
+    inline const_iterator constBegin() const noexcept { return const_iterator(d, d ? d->nextUsed(0) : 0); }
+    inline iterator end() { detach(); return iterator(d, npos()); }
+    inline const_iterator end() const noexcept { return constEnd(); }
+    inline const_iterator cend() const noexcept { return constEnd(); }
+    inline const_iterator constEnd() const noexcept { return const_iterator(d, npos()); }
+    iterator erase(const_iterator it);
+
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const { return const_iterator(d, find_helper(key)); }
+    iterator insert(const Key &key, const T &value);
+    iterator insert(const Key &key, T &&value);
+    void insert(const QFlatHash &other);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const noexcept { return isEmpty(); }
+
+private:
+    void detach_helper();
+    void rehash(size_t capacity);
+    inline size_t npos() const noexcept { return d ? d->capacity : 0; }
+    // Growing moves the nodes, so arguments referring into the table must be copied first
+    bool isInside(const void *p) const noexcept
+    {
+        const char *c = static_cast<const char *>(p);
+        return d && std::less_equal<const char *>()(reinterpret_cast<const char *>(d->nodes), c)
+                && std::less<const char *>()(c, reinterpret_cast<const char *>(d->nodes + d->capacity));
+    }
+    size_t find_helper(const Key &key) const;
+    size_t findOrPrepareInsert(const Key &key, size_t *hash, bool *found);
+};
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    Data *x = d->clone();
+    if (!d->ref.deref())
+        Data::free(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(size_t capacity)
+{
+    Q_ASSERT(capacity >= size_t(size()));
+    Data *x = capacity ? Data::allocate(capacity, d ? d->seed : uint(qGlobalQHashSeed())) : nullptr;
+    if (d) {
+        const bool shared = d->ref.isShared();
+        for (size_t i = d->nextUsed(0); i < d->capacity; i = d->nextUsed(i + 1)) {
+            Node &n = d->nodes[i];
+            const size_t hash = hashOf(n.key, x->seed);
+            const size_t j = x->findFree(hash);
+            if (shared) {
+                new (x->nodes + j) Node(n);
+            } else {
+                new (x->nodes + j) Node(std::move(n));
+                n.~Node();
+            }
+            x->markUsed(j, hash);
+        }
+        if (!shared) {
+            // the nodes were destroyed above
+            ::free(d->nodes);
+            delete d;
+        } else if (!d->ref.deref()) {
+            Data::free(d);
+        }
+    }
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE size_t QFlatHash<Key, T>::find_helper(const Key &key) const
+{
+    if (!d || !d->size)
+        return npos();
+
+    const size_t hash = hashOf(key, d->seed);
+    const qint8 tag = qint8(hash & 0x7f);
+    const size_t groupMask = d->capacity / QFlatHashPrivate::GroupWidth - 1;
+    size_t group = (hash >> 7) & groupMask;
+    for (size_t step = 1; ; ++step) {
+        const size_t base = group * QFlatHashPrivate::GroupWidth;
+        const QFlatHashPrivate::Group g(d->ctrl + base);
+        for (QFlatHashPrivate::BitMask m = g.match(tag); m; m.removeLowest()) {
+            const size_t i = base + m.lowest();
+            if (d->nodes[i].key == key)
+                return i;
+        }
+        if (g.matchEmpty())
+            return d->capacity;
+        group = (group + step) & groupMask;
+    }
+}
+
+// Returns the slot holding key, or else the free slot where it should be
+// inserted, growing the table if needed. The caller constructs the node in
+// a free slot and then marks it used.
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE size_t QFlatHash<Key, T>::findOrPrepareInsert(const Key &key, size_t *hash,
+                                                                   bool *found)
+{
+    if (!d)
+        rehash(QFlatHashPrivate::GroupWidth);
+    else
+        detach();
+
+    *hash = hashOf(key, d->seed);
+    const qint8 tag = qint8(*hash & 0x7f);
+    const size_t groupMask = d->capacity / QFlatHashPrivate::GroupWidth - 1;
+    size_t group = (*hash >> 7) & groupMask;
+    size_t slot = d->capacity;
+    for (size_t step = 1; ; ++step) {
+        const size_t base = group * QFlatHashPrivate::GroupWidth;
+        const QFlatHashPrivate::Group g(d->ctrl + base);
+        for (QFlatHashPrivate::BitMask m = g.match(tag); m; m.removeLowest()) {
+            const size_t i = base + m.lowest();
+            if (d->nodes[i].key == key) {
+                *found = true;
+                return i;
+            }
+        }
+        if (slot == d->capacity) {
+            const QFlatHashPrivate::BitMask free = g.matchFree();
+            if (free)
+                slot = base + free.lowest();
+        }
+        if (g.matchEmpty())
+            break;
+        group = (group + step) & groupMask;
+    }
+
+    *found = false;
+    if (d->ctrl[slot] == QFlatHashPrivate::Empty && !d->growthLeft) {
+        // Out of empty slots: if much of the table is tombstones, rehashing
+        // at the same capacity is enough to reclaim them.
+        if (d->size + 1 <= QFlatHashPrivate::maxLoad(d->capacity) / 2)
+            rehash(d->capacity);
+        else
+            rehash(d->capacity * 2);
+        slot = d->findFree(*hash);
+    }
+    return slot;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+    for (const_iterator it = constBegin(); it != constEnd(); ++it) {
+        const size_t i = other.find_helper(it.key());
+        if (i == other.npos() || !(other.d->nodes[i].value == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const size_t capacity = QFlatHashPrivate::capacityForSize(size_t(qMax(asize, size())));
+    if (capacity > size_t(this->capacity()))
+        rehash(capacity);
+    else
+        detach();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    const size_t capacity = QFlatHashPrivate::capacityForSize(size_t(size()));
+    if (capacity != size_t(this->capacity()))
+        rehash(capacity);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    size_t i = find_helper(key);
+    if (i == npos())
+        return 0;
+    detach();
+    d->erase(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    size_t i = find_helper(key);
+    if (i == npos())
+        return T();
+    detach();
+    T t = std::move(d->nodes[i].value);
+    d->erase(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key) const
+{
+    const size_t i = find_helper(key);
+    return i == npos() ? T() : d->nodes[i].value;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const size_t i = find_helper(key);
+    return i == npos() ? defaultValue : d->nodes[i].value;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue) const
+{
+    return key(avalue, Key());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue, const Key &defaultKey) const
+{
+    for (const_iterator it = constBegin(); it != constEnd(); ++it) {
+        if (it.value() == avalue)
+            return it.key();
+    }
+    return defaultKey;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    if (Q_UNLIKELY(isInside(&key)))
+        return operator[](Key(key));
+
+    size_t hash;
+    bool found;
+    const size_t i = findOrPrepareInsert(key, &hash, &found);
+    if (!found) {
+        new (d->nodes + i) Node(key, T());
+        d->markUsed(i, hash);
+    }
+    return d->nodes[i].value;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it != constEnd(), "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    const size_t i = it.i;
+    // detaching keeps the table layout, so the index stays valid
+    detach();
+    d->erase(i);
+    return iterator(d, d->nextUsed(i + 1));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &key)
+{
+    const size_t i = find_helper(key);
+    if (i == npos())
+        return end();
+    detach();
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key,
+                                                                                    const T &value)
+{
+    if (Q_UNLIKELY(isInside(&key) || isInside(&value)))
+        return insert(Key(key), T(value));
+
+    size_t hash;
+    bool found;
+    const size_t i = findOrPrepareInsert(key, &hash, &found);
+    if (found) {
+        d->nodes[i].value = value;
+    } else {
+        new (d->nodes + i) Node(key, value);
+        d->markUsed(i, hash);
+    }
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key,
+                                                                                    T &&value)
+{
+    if (Q_UNLIKELY(isInside(&key) || isInside(&value))) {
+        T moved(std::move(value));
+        return insert(Key(key), std::move(moved));
+    }
+
+    size_t hash;
+    bool found;
+    const size_t i = findOrPrepareInsert(key, &hash, &found);
+    if (found) {
+        d->nodes[i].value = std::move(value);
+    } else {
+        new (d->nodes + i) Node(key, std::move(value));
+        d->markUsed(i, hash);
+    }
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::insert(const QFlatHash &other)
+{
+    if (d == other.d)
+        return;
+    reserve(size() + other.size());
+    for (const_iterator it = other.constBegin(); it != other.constEnd(); ++it)
+        insert(it.key(), it.value());
+}
+
+template <class Key, class T>
+inline void swap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2) noexcept
+{
+    value1.swap(value2);
+}
+
+QT_END_NAMESPACE
+
+#undef QFLATHASH_NEON
+
+#endif // QFLATHASH_H
@@ -44,6 +44,9 @@
 
 QT_BEGIN_NAMESPACE
 
+// released chunks of up to this many basic blocks are kept for reuse
+static const int MaxFreeChunkBlocks = 4;
+
 void QRingChunk::allocate(int alloc)
 {
     Q_ASSERT(alloc > 0 && size() == 0);
@@ -84,6 +87,65 @@ QByteArray QRingChunk::toByteArray()
     return chunk;
 }
 
+/*!
+    \internal
+
+    Return a chunk with room for at least \a size bytes. Sizes within
+    the pooled range are rounded up to a power-of-two multiple of the
+    basic block size, so that released chunks can serve requests of a
+    similar size, and are taken from the free-list when possible.
+*/
+QRingChunk QRingBuffer::takeChunk(int size)
+{
+    Q_ASSERT(size > 0);
+
+    if (basicBlockSize > 0 && size > basicBlockSize
+            && size <= qint64(basicBlockSize) * MaxFreeChunkBlocks) {
+        int alloc = basicBlockSize;
+        while (alloc < size)
+            alloc *= 2;
+        size = alloc;
+    }
+
+    int best = -1;
+    for (int i = 0; i < freeChunks.size(); ++i) {
+        const QByteArray &storage = freeChunks.at(i);
+        if (storage.size() >= size && storage.isDetached()
+                && (best < 0 || storage.size() < freeChunks.at(best).size())) {
+            best = i;
+        }
+    }
+
+    if (best < 0)
+        return QRingChunk(size);
+
+    if (best != freeChunks.size() - 1)
+        freeChunks[best].swap(freeChunks.last());
+    QRingChunk chunk;
+    chunk.setStorage(std::move(freeChunks.last()));
+    freeChunks.removeLast();
+    return chunk;
+}
+
+/*!
+    \internal
+
+    Put the storage of \a chunk on the free-list if it is not shared and
+    within the pooled size range, otherwise release it. \a chunk is left
+    empty.
+*/
+void QRingBuffer::recycleChunk(QRingChunk &chunk)
+{
+    const int capacity = chunk.capacity();
+    if (basicBlockSize > 0 && capacity >= basicBlockSize
+            && capacity <= qint64(basicBlockSize) * MaxFreeChunkBlocks
+            && freeChunks.size() < QRINGBUFFER_FREECHUNKS && !chunk.isShared()) {
+        freeChunks.append(chunk.takeStorage());
+    } else {
+        chunk.clear();
+    }
+}
+
 /*!
     \internal
 
@@ -124,6 +186,7 @@ void QRingBuffer::free(qint64 bytes)
                 if (chunk.capacity() <= basicBlockSize && !chunk.isShared()) {
                     chunk.reset();
                     bufferSize = 0;
+                    squeeze(); // idle buffers don't keep spare chunks
                 } else {
                     clear(); // try to minify/squeeze us
                 }
@@ -137,6 +200,7 @@ void QRingBuffer::free(qint64 bytes)
 
         bufferSize -= chunkSize;
         bytes -= chunkSize;
+        recycleChunk(buffers.first());
         buffers.removeFirst();
     }
 }
@@ -148,15 +212,20 @@ char *QRingBuffer::reserve(qint64 bytes)
     const int chunkSize = qMax(basicBlockSize, int(bytes));
     int tail = 0;
     if (bufferSize == 0) {
-        if (buffers.isEmpty())
-            buffers.append(QRingChunk(chunkSize));
-        else
-            buffers.first().allocate(chunkSize);
+        if (buffers.isEmpty()) {
+            buffers.append(takeChunk(chunkSize));
+        } else {
+            QRingChunk &chunk = buffers.first();
+            if (chunk.capacity() < chunkSize || chunk.isShared()) {
+                recycleChunk(chunk);
+                chunk = takeChunk(chunkSize);
+            }
+        }
     } else {
         const QRingChunk &chunk = buffers.constLast();
         // if need a new buffer
         if (basicBlockSize == 0 || chunk.isShared() || bytes > chunk.available())
-            buffers.append(QRingChunk(chunkSize));
+            buffers.append(takeChunk(chunkSize));
         else
             tail = chunk.size();
     }
@@ -177,17 +246,22 @@ char *QRingBuffer::reserveFront(qint64 bytes)
 
     const int chunkSize = qMax(basicBlockSize, int(bytes));
     if (bufferSize == 0) {
-        if (buffers.isEmpty())
-            buffers.prepend(QRingChunk(chunkSize));
-        else
-            buffers.first().allocate(chunkSize);
+        if (buffers.isEmpty()) {
+            buffers.prepend(takeChunk(chunkSize));
+        } else {
+            QRingChunk &chunk = buffers.first();
+            if (chunk.capacity() < chunkSize || chunk.isShared()) {
+                recycleChunk(chunk);
+                chunk = takeChunk(chunkSize);
+            }
+        }
         buffers.first().grow(chunkSize);
         buffers.first().advance(chunkSize - bytes);
     } else {
         const QRingChunk &chunk = buffers.constFirst();
         // if need a new buffer
         if (basicBlockSize == 0 || chunk.isShared() || bytes > chunk.head()) {
-            buffers.prepend(QRingChunk(chunkSize));
+            buffers.prepend(takeChunk(chunkSize));
             buffers.first().grow(chunkSize);
             buffers.first().advance(chunkSize - bytes);
         } else {
@@ -215,6 +289,7 @@ void QRingBuffer::chop(qint64 bytes)
                 if (chunk.capacity() <= basicBlockSize && !chunk.isShared()) {
                     chunk.reset();
                     bufferSize = 0;
+                    squeeze(); // idle buffers don't keep spare chunks
                 } else {
                     clear(); // try to minify/squeeze us
                 }
@@ -228,12 +303,14 @@ void QRingBuffer::chop(qint64 bytes)
 
         bufferSize -= chunkSize;
         bytes -= chunkSize;
+        recycleChunk(buffers.last());
         buffers.removeLast();
     }
 }
 
 void QRingBuffer::clear()
 {
+    squeeze();
     if (buffers.isEmpty())
         return;
 
@@ -242,6 +319,80 @@ void QRingBuffer::clear()
     bufferSize = 0;
 }
 
+/*!
+    \internal
+
+    Fill \a spans with up to \a maxSpans pointers to the bytes starting at
+    position \a pos, covering at most \a maxLength bytes (all the bytes if
+    \a maxLength is negative), and return the number of spans filled in.
+    The data is not consumed; it is meant to be passed to a vectored write
+    (e.g. writev()) and then released with free(). The pointers are valid
+    until the buffer is next modified.
+*/
+int QRingBuffer::readSpans(ReadSpan *spans, int maxSpans, qint64 maxLength, qint64 pos) const
+{
+    Q_ASSERT(maxSpans >= 0 && pos >= 0);
+
+    if (maxLength < 0)
+        maxLength = bufferSize;
+
+    int count = 0;
+    for (const QRingChunk &chunk : buffers) {
+        if (count == maxSpans || maxLength == 0)
+            break;
+
+        qint64 blockLength = chunk.size();
+        if (pos < blockLength) {
+            blockLength = qMin(blockLength - pos, maxLength);
+            spans[count].data = chunk.data() + pos;
+            spans[count].size = blockLength;
+            ++count;
+            maxLength -= blockLength;
+            pos = 0;
+        } else {
+            pos -= blockLength;
+        }
+    }
+
+    return count;
+}
+
+/*!
+    \internal
+
+    Reserve \a bytes at the end of the buffer in up to \a maxSpans pieces
+    and return the number of spans filled in. The free space of the last
+    chunk is used first, then whole basic blocks; the last span takes the
+    remainder. This is meant for a vectored read (e.g. readv()), after
+    which the unused bytes are given back with chop().
+*/
+int QRingBuffer::reserveSpans(WriteSpan *spans, int maxSpans, qint64 bytes)
+{
+    Q_ASSERT(maxSpans > 0 && bytes > 0 && bytes < MaxByteArraySize);
+
+    int count = 0;
+    while (bytes > 0) {
+        qint64 length = bytes;
+        if (count + 1 < maxSpans) {
+            qint64 space = basicBlockSize;
+            if (bufferSize != 0 && basicBlockSize != 0) {
+                const QRingChunk &chunk = buffers.constLast();
+                if (!chunk.isShared() && chunk.available() > 0)
+                    space = chunk.available();
+            }
+            if (space > 0)
+                length = qMin(length, space);
+        }
+
+        spans[count].data = reserve(length);
+        spans[count].size = length;
+        ++count;
+        bytes -= length;
+    }
+
+    return count;
+}
+
 qint64 QRingBuffer::indexOf(char c, qint64 maxLength, qint64 pos) const
 {
     Q_ASSERT(maxLength >= 0 && pos >= 0);
@@ -299,6 +450,8 @@ QByteArray QRingBuffer::read()
         return QByteArray();
 
     bufferSize -= buffers.constFirst().size();
+    if (bufferSize == 0)
+        squeeze();
     return buffers.takeFirst().toByteArray();
 }
 
@@ -61,6 +61,11 @@ QT_BEGIN_NAMESPACE
 #define QRINGBUFFER_CHUNKSIZE 4096
 #endif
 
+// maximum number of released chunks that a buffer keeps for reuse
+#ifndef QRINGBUFFER_FREECHUNKS
+#define QRINGBUFFER_FREECHUNKS 4
+#endif
+
 class QRingChunk
 {
 public:
@@ -174,6 +179,20 @@ public:
         assign(QByteArray());
     }
 
+    // storage recycling
+    inline QByteArray takeStorage()
+    {
+        QByteArray storage;
+        storage.swap(chunk);
+        reset();
+        return storage;
+    }
+    inline void setStorage(QByteArray &&storage)
+    {
+        chunk = std::move(storage);
+        reset();
+    }
+
 private:
     QByteArray chunk;
     int headOffset, tailOffset;
@@ -182,6 +201,15 @@ private:
 class QRingBuffer
 {
 public:
+    struct ReadSpan {
+        const char *data;
+        qint64 size;
+    };
+    struct WriteSpan {
+        char *data;
+        qint64 size;
+    };
+
     explicit inline QRingBuffer(int growth = QRINGBUFFER_CHUNKSIZE) :
         bufferSize(0), basicBlockSize(growth) { }
 
@@ -205,6 +233,9 @@ public:
     Q_CORE_EXPORT void free(qint64 bytes);
     Q_CORE_EXPORT char *reserve(qint64 bytes);
     Q_CORE_EXPORT char *reserveFront(qint64 bytes);
+    Q_CORE_EXPORT int readSpans(ReadSpan *spans, int maxSpans, qint64 maxLength = -1,
+                                qint64 pos = 0) const;
+    Q_CORE_EXPORT int reserveSpans(WriteSpan *spans, int maxSpans, qint64 bytes);
 
     inline void truncate(qint64 pos) {
         Q_ASSERT(pos >= 0 && pos <= size());
@@ -264,8 +295,17 @@ public:
         return indexOf('\n') >= 0;
     }
 
+    // drops the spare chunks; done whenever the buffer becomes empty
+    inline void squeeze() {
+        freeChunks.clear();
+    }
+
 private:
+    QRingChunk takeChunk(int size);
+    void recycleChunk(QRingChunk &chunk);
+
     QVector<QRingChunk> buffers;
+    QVector<QByteArray> freeChunks;
     qint64 bufferSize;
     int basicBlockSize;
 };
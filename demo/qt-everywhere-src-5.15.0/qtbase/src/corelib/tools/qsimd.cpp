@@ -39,6 +39,7 @@
 ****************************************************************************/
 
 #include "qsimd_p.h"
+#include "qsimddispatch_p.h"
 #include "qalgorithms.h"
 #include <QByteArray>
 #include <stdio.h>
@@ -538,6 +539,9 @@ Q_CORE_EXPORT QBasicAtomicInteger<quint64> qt_cpu_features[1] = { Q_BASIC_ATOMIC
 Q_CORE_EXPORT QBasicAtomicInteger<unsigned> qt_cpu_features[2] = { Q_BASIC_ATOMIC_INITIALIZER(0), Q_BASIC_ATOMIC_INITIALIZER(0) };
 #endif
 
+// list of the resolved dispatchers, see qsimddispatch_p.h
+static QBasicAtomicPointer<QCpuDispatcherBase> cpuDispatchers = Q_BASIC_ATOMIC_INITIALIZER(nullptr);
+
 quint64 qDetectCpuFeatures()
 {
     quint64 f = detectProcessorFeatures();
@@ -593,6 +597,41 @@ void qDumpCPUFeatures()
         printf("\n!!! Applications will likely crash with \"Invalid Instruction\"\n!!!!!!!!!!!!!!!!!!!!");
     }
     puts("");
+
+    if (const QCpuDispatcherBase *d = cpuDispatchers.loadAcquire()) {
+        printf("Dispatched functions:");
+        for ( ; d; d = d->next) {
+            if (d->selection.loadAcquire())
+                printf(" %s[%s]", d->name, d->selectedName);
+        }
+        puts("");
+    }
+}
+
+/*!
+    \internal
+
+    Add \a dispatcher to the list of resolved dispatchers. Called once per
+    dispatcher by QCpuDispatcher::resolve().
+*/
+void qRegisterCpuDispatcher(QCpuDispatcherBase *dispatcher) noexcept
+{
+    QCpuDispatcherBase *head = cpuDispatchers.loadRelaxed();
+    do {
+        dispatcher->next = head;
+    } while (!cpuDispatchers.testAndSetRelease(head, dispatcher, head));
+}
+
+/*!
+    \internal
+
+    Make all the registered dispatchers select their implementation again
+    on their next use, for instance after the CPU features were changed.
+*/
+void qResetCpuDispatchers() noexcept
+{
+    for (QCpuDispatcherBase *d = cpuDispatchers.loadAcquire(); d; d = d->next)
+        d->selection.storeRelease(0);
 }
 
 #if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(RDRND)
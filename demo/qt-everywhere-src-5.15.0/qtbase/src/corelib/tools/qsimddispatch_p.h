@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSIMDDISPATCH_P_H
+#define QSIMDDISPATCH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qsimd_p.h>
+
+#include <utility>
+
+/*
+ * Runtime function multi-versioning.
+ *
+ * A QCpuDispatcher holds several implementations of one function, each
+ * listed with the CPU features it requires, most demanding first. The last
+ * entry must require no feature. On first use, the dispatcher picks the
+ * first implementation the processor supports and caches that choice, so
+ * later calls cost one indirect call. Combined with QT_FUNCTION_TARGET and
+ * QT_COMPILER_SUPPORTS_HERE, this lets a build targeting the baseline
+ * architecture still carry optimized versions:
+ *
+ *      static const QCpuDispatchVersion<size_t(const uchar *, size_t)> fooVersions[] = {
+ *      #if QT_COMPILER_SUPPORTS_HERE(AVX2)
+ *          { CpuFeatureAVX2, foo_avx2, "avx2" },
+ *      #endif
+ *          { 0, foo_plain, "plain" }
+ *      };
+ *      static QCpuDispatcher<size_t(const uchar *, size_t)> fooDispatcher =
+ *          Q_CPU_DISPATCHER_INITIALIZER("foo", fooVersions);
+ *
+ *      size_t foo(const uchar *ptr, size_t len)
+ *      {
+ *          return fooDispatcher(ptr, len);
+ *      }
+ *
+ * Dispatchers are aggregates, so static ones are initialized at compile
+ * time and can be used from other static initializers. On resolution they
+ * are added to a process-wide registry, which qDumpCPUFeatures() prints
+ * and qResetCpuDispatchers() clears. Only dispatchers with static storage
+ * duration in code that is never unloaded may be used.
+ */
+
+#ifdef __cplusplus
+QT_BEGIN_NAMESPACE
+
+struct QCpuDispatcherBase
+{
+    const char *name;
+    QCpuDispatcherBase *next;
+    const char *selectedName;
+    QBasicAtomicInt selection;      // index of the selected version + 1, or 0
+    QBasicAtomicInt registered;
+};
+
+Q_CORE_EXPORT void qRegisterCpuDispatcher(QCpuDispatcherBase *dispatcher) noexcept;
+Q_CORE_EXPORT void qResetCpuDispatchers() noexcept;
+
+template <typename F>
+struct QCpuDispatchVersion
+{
+    quint64 features;
+    F *function;
+    const char *name;
+};
+
+template <typename F> struct QCpuDispatcher;
+
+template <typename R, typename... Args>
+struct QCpuDispatcher<R(Args...)>
+{
+    QCpuDispatcherBase d;
+    const QCpuDispatchVersion<R(Args...)> *versions;
+    int count;
+
+    inline R operator()(Args... args)
+    {
+        int i = d.selection.loadAcquire();
+        if (Q_UNLIKELY(i == 0))
+            i = resolve();
+        return versions[i - 1].function(std::forward<Args>(args)...);
+    }
+
+    Q_NEVER_INLINE int resolve() noexcept
+    {
+        const quint64 features = qCompilerCpuFeatures | qCpuFeatures();
+        int i = 0;
+        while (i < count - 1 && (versions[i].features & features) != versions[i].features)
+            ++i;
+        Q_ASSERT(i < count - 1 || versions[i].features == 0);
+
+        d.selectedName = versions[i].name;
+        if (d.registered.testAndSetRelaxed(0, 1))
+            qRegisterCpuDispatcher(&d);
+        d.selection.storeRelease(i + 1);
+        return i + 1;
+    }
+};
+
+#define Q_CPU_DISPATCHER_INITIALIZER(name, versions) \
+    { { name, nullptr, nullptr, Q_BASIC_ATOMIC_INITIALIZER(0), Q_BASIC_ATOMIC_INITIALIZER(0) }, \
+      versions, int(sizeof(versions) / sizeof(versions[0])) }
+
+QT_END_NAMESPACE
+#endif // __cplusplus
+
+#endif // QSIMDDISPATCH_P_H
@@ -11,7 +11,9 @@ HEADERS +=  \
         tools/qcache.h \
         tools/qcontainerfwd.h \
         tools/qcontainertools_impl.h \
+        tools/qflathash.h \
         tools/qcryptographichash.h \
+        tools/qcryptographichash_p.h \
         tools/qduplicatetracker_p.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
@@ -41,6 +43,7 @@ HEADERS +=  \
         tools/qsharedpointer_impl.h \
         tools/qset.h \
         tools/qsimd_p.h \
+        tools/qsimddispatch_p.h \
         tools/qsize.h \
         tools/qstack.h \
         tools/qtools_p.h \
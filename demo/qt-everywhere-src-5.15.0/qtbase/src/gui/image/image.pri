@@ -92,6 +92,7 @@ qtConfig(png) {
 # SIMD
 !android {
     SSSE3_SOURCES += image/qimage_ssse3.cpp
+    AVX2_SOURCES += image/qimage_avx2.cpp
     NEON_SOURCES += image/qimage_neon.cpp
     MIPS_DSPR2_SOURCES += image/qimage_mips_dspr2.cpp
     MIPS_DSPR2_ASM += image/qimage_mips_dspr2_asm.S
@@ -41,6 +41,7 @@
 
 #ifndef QT_NO_IMAGEFORMAT_BMP
 
+#include <qfiledevice.h>
 #include <qimage.h>
 #include <qvariant.h>
 #include <qvector.h>
@@ -194,6 +195,50 @@ static bool read_dib_infoheader(QDataStream &s, BMP_INFOHDR &bi)
     return true;
 }
 
+// Uncompressed 24-bit BMP data is laid out as Format_BGR888, 32-bit data as
+// Format_RGB32 on little endian machines except for the undefined alpha
+// byte. When it sits in a file, map the pixel data and convert it in one pass
+// with the (SIMD) image converters instead of reading it row by row.
+static bool read_dib_mapped(QIODevice *d, int w, int h, int nbits, bool topDown, QImage &image)
+{
+    QFileDevice *file = qobject_cast<QFileDevice *>(d);
+    if (!file || file->isSequential())
+        return false;
+
+    QImage::Format format;
+    if (nbits == 24)
+        format = QImage::Format_BGR888;
+    else if (nbits == 32 && QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+        format = QImage::Format_ARGB32; // converting to RGB32 makes it opaque
+    else
+        return false;
+
+    const qint64 bpl = ((qint64(w) * nbits + 31) / 32) * 4;
+    const qint64 pos = file->pos();
+    const qint64 size = bpl * h;
+    if (bpl > INT_MAX || pos + size > file->size()) // truncated file: use the slow path
+        return false;
+
+    uchar *data = file->map(pos, size);
+    if (!data)
+        return false;
+    QImage converted;
+    {
+        const QImage mapped(data, w, h, int(bpl), format);
+        converted = mapped.convertToFormat(QImage::Format_RGB32);
+    }
+    file->unmap(data);
+    if (converted.isNull())
+        return false;
+
+    if (!topDown)
+        converted = std::move(converted).mirrored();
+    converted.setDotsPerMeterX(image.dotsPerMeterX());
+    converted.setDotsPerMeterY(image.dotsPerMeterY());
+    image = converted;
+    return file->seek(pos + size);
+}
+
 static bool read_dib_body(QDataStream &s, const BMP_INFOHDR &bi, qint64 offset, qint64 startpos, QImage &image)
 {
     QIODevice* d = s.device();
@@ -518,6 +563,11 @@ static bool read_dib_body(QDataStream &s, const BMP_INFOHDR &bi, qint64 offset,
         }
     }
 
+    else if (comp == BMP_RGB && (nbits == 24 || nbits == 32)
+             && read_dib_mapped(d, w, h, nbits, bi.biHeight < 0, image)) {
+        return true;
+    }
+
     else if (nbits == 16 || nbits == 24 || nbits == 32) { // 16,24,32 bit BMP image
         QRgb *p;
         QRgb  *end;
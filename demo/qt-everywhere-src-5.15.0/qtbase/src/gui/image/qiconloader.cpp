@@ -56,6 +56,7 @@
 #include <QtGui/QPainter>
 
 #include <private/qhexstring_p.h>
+#include <private/qstartuptrace_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -115,6 +116,8 @@ void QIconLoader::ensureInitialized()
         m_initialized = true;
 
         Q_ASSERT(qApp);
+        // Includes loading the icon engine plugins' metadata
+        QStartupTraceScope trace("gui", QStringLiteral("QIconLoader initialization"));
 
         m_systemTheme = systemThemeName();
 
@@ -204,8 +207,19 @@ QStringList QIconLoader::fallbackSearchPaths() const
 class QIconCacheGtkReader
 {
 public:
+    // The flags gtk-update-icon-cache stores with each directory of an icon
+    enum ImageFlag {
+        HasXpm = 0x1,
+        HasSvg = 0x2,
+        HasPng = 0x4
+    };
+    struct Image {
+        const char *dir;
+        quint16 flags;
+    };
+
     explicit QIconCacheGtkReader(const QString &themeDir);
-    QVector<const char *> lookup(const QStringRef &);
+    QVector<Image> lookup(const QStringRef &);
     bool isValid() const { return m_isValid; }
 private:
     QFile m_file;
@@ -275,12 +289,13 @@ static quint32 icon_name_hash(const char *p)
 
 /*! \internal
     lookup the icon name and return the list of subdirectories in which an icon
-    with this name is present. The char* are pointers to the mapped data.
+    with this name is present, with the flags telling which files are there.
+    The char* are pointers to the mapped data.
     For example, this would return { "32x32/apps", "24x24/apps" , ... }
  */
-QVector<const char *> QIconCacheGtkReader::lookup(const QStringRef &name)
+QVector<QIconCacheGtkReader::Image> QIconCacheGtkReader::lookup(const QStringRef &name)
 {
-    QVector<const char *> ret;
+    QVector<Image> ret;
     if (!isValid() || name.isEmpty())
         return ret;
 
@@ -314,12 +329,13 @@ QVector<const char *> QIconCacheGtkReader::lookup(const QStringRef &name)
             ret.reserve(listLen);
             for (uint j = 0; j < listLen && m_isValid; ++j) {
                 quint32 dirIndex = read16(listOffset + 4 + 8 * j);
+                quint16 flags = read16(listOffset + 4 + 8 * j + 2);
                 quint32 o = read32(dirListOffset + 4 + dirIndex*4);
                 if (!m_isValid || dirIndex >= dirListLen || o >= m_size) {
                     m_isValid = false;
                     return ret;
                 }
-                ret.append(reinterpret_cast<const char*>(m_data) + o);
+                ret.append({ reinterpret_cast<const char*>(m_data) + o, flags });
             }
             return ret;
         }
@@ -331,6 +347,7 @@ QVector<const char *> QIconCacheGtkReader::lookup(const QStringRef &name)
 QIconTheme::QIconTheme(const QString &themeName)
         : m_valid(false)
 {
+    QStartupTraceScope trace("gui", QLatin1String("QIconTheme ") + themeName);
     QFile themeIndex;
 
     const QStringList iconDirs = QIcon::themeSearchPaths();
@@ -441,6 +458,8 @@ QThemeIconInfo QIconLoader::findIconHelper(const QString &themeName,
         // Add all relevant files
         for (int i = 0; i < contentDirs.size(); ++i) {
             QVector<QIconDirInfo> subDirs = theme.keyList();
+            // The files the GTK+ cache says are in each of subDirs
+            QVector<quint16> subDirFlags;
 
             // Try to reduce the amount of subDirs by looking in the GTK+ cache in order to save
             // a massive amount of file stat (especially if the icon is not there)
@@ -451,13 +470,15 @@ QThemeIconInfo QIconLoader::findIconHelper(const QString &themeName,
                     const QVector<QIconDirInfo> subDirsCopy = subDirs;
                     subDirs.clear();
                     subDirs.reserve(result.count());
-                    for (const char *s : result) {
-                        QString path = QString::fromUtf8(s);
+                    subDirFlags.reserve(result.count());
+                    for (const QIconCacheGtkReader::Image &image : result) {
+                        QString path = QString::fromUtf8(image.dir);
                         auto it = std::find_if(subDirsCopy.cbegin(), subDirsCopy.cend(),
                                                [&](const QIconDirInfo &info) {
                                                    return info.path == path; } );
                         if (it != subDirsCopy.cend()) {
                             subDirs.append(*it);
+                            subDirFlags.append(image.flags);
                         }
                     }
                 }
@@ -467,8 +488,14 @@ QThemeIconInfo QIconLoader::findIconHelper(const QString &themeName,
             for (int j = 0; j < subDirs.size() ; ++j) {
                 const QIconDirInfo &dirInfo = subDirs.at(j);
                 const QString subDir = contentDir + dirInfo.path + QLatin1Char('/');
+                // The cache is only used when it is newer than all the directories, so
+                // its flags can replace the stat of the files. Without png or svg flags
+                // (an xpm only, or unknown flags), check the files as without a cache.
+                const quint16 flags = j < subDirFlags.size() ? subDirFlags.at(j) : 0;
+                const bool knownFiles = flags & (QIconCacheGtkReader::HasPng
+                                                 | QIconCacheGtkReader::HasSvg);
                 const QString pngPath = subDir + pngIconName;
-                if (QFile::exists(pngPath)) {
+                if (knownFiles ? (flags & QIconCacheGtkReader::HasPng) : QFile::exists(pngPath)) {
                     PixmapEntry *iconEntry = new PixmapEntry;
                     iconEntry->dir = dirInfo;
                     iconEntry->filename = pngPath;
@@ -477,7 +504,7 @@ QThemeIconInfo QIconLoader::findIconHelper(const QString &themeName,
                     info.entries.prepend(iconEntry);
                 } else if (m_supportsSvg) {
                     const QString svgPath = subDir + svgIconName;
-                    if (QFile::exists(svgPath)) {
+                    if (knownFiles ? (flags & QIconCacheGtkReader::HasSvg) : QFile::exists(svgPath)) {
                         ScalableEntry *iconEntry = new ScalableEntry;
                         iconEntry->dir = dirInfo;
                         iconEntry->filename = svgPath;
@@ -68,12 +68,17 @@
 
 #include <private/qimage_p.h>
 #include <private/qfont_p.h>
+#include <private/qlocking_p.h>
 
 #if QT_CONFIG(thread)
 #include "qsemaphore.h"
 #include "qthreadpool.h"
 #endif
 
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 static inline bool isLocked(QImageData *data)
@@ -103,6 +108,174 @@ static int next_qimage_serial_number()
     return 1 + serial.fetchAndAddRelaxed(1);
 }
 
+/*
+    A pool of pixel buffers, bucketed by size, for pipelines that allocate
+    images of the same size over and over. It is disabled by default; the
+    QT_IMAGE_BUFFER_POOL_SIZE environment variable (in kilobytes) or
+    qt_setImageBufferPoolLimit() set the number of bytes it may keep.
+
+    Only buffers of at least MinPooledSize bytes are pooled. Buffers of at
+    least HugePageSize bytes are rounded up to and aligned on huge pages,
+    smaller ones are rounded up to normal pages.
+*/
+namespace {
+class QImageBufferPool
+{
+public:
+    enum {
+        MinPooledSize = 64 * 1024,
+        PageSize = 4096,
+        HugePageSize = 2 * 1024 * 1024
+    };
+
+    QImageBufferPool()
+        : limit(qint64(qEnvironmentVariableIntValue("QT_IMAGE_BUFFER_POOL_SIZE")) * 1024)
+    {
+    }
+
+    ~QImageBufferPool()
+    {
+        for (auto it = buffers.cbegin(), end = buffers.cend(); it != end; ++it) {
+            for (uchar *buffer : it.value())
+                freeBuffer(buffer, it.key());
+        }
+    }
+
+    static qsizetype bucketSize(qsizetype size)
+    {
+        const qsizetype granularity = size >= HugePageSize ? HugePageSize : PageSize;
+        return (size + granularity - 1) / granularity * granularity;
+    }
+
+    uchar *allocate(qsizetype size, qsizetype *allocatedSize);
+    bool release(uchar *buffer, qsizetype size);
+
+    static uchar *allocateBuffer(qsizetype size);
+    static void freeBuffer(uchar *buffer, qsizetype size);
+
+    QMutex mutex;
+    QHash<qsizetype, QVector<uchar *>> buffers;
+    qint64 limit;
+    qint64 cachedBytes = 0;
+    int cachedBuffers = 0;
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+}
+
+Q_GLOBAL_STATIC(QImageBufferPool, imageBufferPool)
+
+uchar *QImageBufferPool::allocateBuffer(qsizetype size)
+{
+    if (size < HugePageSize)
+        return static_cast<uchar *>(malloc(size));
+    uchar *buffer = static_cast<uchar *>(qMallocAligned(size, HugePageSize));
+#if defined(Q_OS_LINUX) && defined(MADV_HUGEPAGE)
+    if (buffer)
+        madvise(buffer, size, MADV_HUGEPAGE);
+#endif
+    return buffer;
+}
+
+void QImageBufferPool::freeBuffer(uchar *buffer, qsizetype size)
+{
+    if (size < HugePageSize)
+        free(buffer);
+    else
+        qFreeAligned(buffer);
+}
+
+uchar *QImageBufferPool::allocate(qsizetype size, qsizetype *allocatedSize)
+{
+    const qsizetype bucket = bucketSize(size);
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        auto it = buffers.find(bucket);
+        if (it != buffers.end() && !it->isEmpty()) {
+            uchar *buffer = it->takeLast();
+            cachedBytes -= bucket;
+            --cachedBuffers;
+            ++hits;
+            *allocatedSize = bucket;
+            return buffer;
+        }
+        ++misses;
+    }
+    *allocatedSize = bucket;
+    return allocateBuffer(bucket);
+}
+
+// Returns false if the buffer does not fit into the pool and has to be freed
+bool QImageBufferPool::release(uchar *buffer, qsizetype size)
+{
+    const auto locker = qt_scoped_lock(mutex);
+    if (cachedBytes + size > limit)
+        return false;
+    buffers[size].append(buffer);
+    cachedBytes += size;
+    ++cachedBuffers;
+    return true;
+}
+
+static uchar *allocateImageBuffer(qsizetype size, qsizetype *pooledSize)
+{
+    *pooledSize = 0;
+    if (size >= QImageBufferPool::MinPooledSize) {
+        QImageBufferPool *pool = imageBufferPool();
+        if (pool && pool->limit > 0)
+            return pool->allocate(size, pooledSize);
+    }
+    return static_cast<uchar *>(malloc(size));
+}
+
+/*!
+    \internal
+
+    Sets the number of bytes the pixel buffer pool may keep to \a bytes,
+    freeing the cached buffers that no longer fit. A limit of 0 disables the
+    pool.
+*/
+void qt_setImageBufferPoolLimit(qint64 bytes)
+{
+    QImageBufferPool *pool = imageBufferPool();
+    if (!pool)
+        return;
+    QVector<QPair<uchar *, qsizetype>> evicted;
+    {
+        const auto locker = qt_scoped_lock(pool->mutex);
+        pool->limit = qMax<qint64>(bytes, 0);
+        for (auto it = pool->buffers.begin(); it != pool->buffers.end() && pool->cachedBytes > pool->limit; ++it) {
+            while (!it->isEmpty() && pool->cachedBytes > pool->limit) {
+                evicted.append(qMakePair(it->takeLast(), it.key()));
+                pool->cachedBytes -= it.key();
+                --pool->cachedBuffers;
+            }
+        }
+    }
+    for (const auto &buffer : qAsConst(evicted))
+        QImageBufferPool::freeBuffer(buffer.first, buffer.second);
+}
+
+/*!
+    \internal
+
+    Returns how often the pixel buffer pool could serve an allocation, how
+    often it could not, and what it currently keeps.
+*/
+QImageBufferPoolStatistics qt_imageBufferPoolStatistics()
+{
+    QImageBufferPoolStatistics statistics = {};
+    if (QImageBufferPool *pool = imageBufferPool()) {
+        const auto locker = qt_scoped_lock(pool->mutex);
+        statistics.hits = pool->hits;
+        statistics.misses = pool->misses;
+        statistics.cachedBytes = pool->cachedBytes;
+        statistics.cachedBuffers = pool->cachedBuffers;
+        statistics.limit = pool->limit;
+    }
+    return statistics;
+}
+
 QImageData::QImageData()
     : ref(0), width(0), height(0), depth(0), nbytes(0), devicePixelRatio(1.0), data(nullptr),
       format(QImage::Format_ARGB32), bytes_per_line(0),
@@ -111,7 +284,8 @@ QImageData::QImageData()
       dpmx(qt_defaultDpiX() * 100 / qreal(2.54)),
       dpmy(qt_defaultDpiY() * 100 / qreal(2.54)),
       offset(0, 0), own_data(true), ro_data(false), has_alpha_clut(false),
-      is_cached(false), is_locked(false), cleanupFunction(nullptr), cleanupInfo(nullptr),
+      is_cached(false), is_locked(false), is_pooled(false), pool_size(0),
+      cleanupFunction(nullptr), cleanupInfo(nullptr),
       paintEngine(nullptr)
 {
 }
@@ -157,10 +331,11 @@ QImageData * QImageData::create(const QSize &size, QImage::Format format)
 
     d->bytes_per_line = params.bytesPerLine;
     d->nbytes = params.totalSize;
-    d->data  = (uchar *)malloc(d->nbytes);
+    d->data = allocateImageBuffer(d->nbytes, &d->pool_size);
 
     if (!d->data)
         return nullptr;
+    d->is_pooled = d->pool_size > 0;
 
     d->ref.ref();
     return d.take();
@@ -173,8 +348,15 @@ QImageData::~QImageData()
     if (is_cached)
         QImagePixmapCleanupHooks::executeImageHooks((((qint64) ser_no) << 32) | ((qint64) detach_no));
     delete paintEngine;
-    if (data && own_data)
-        free(data);
+    if (data && own_data) {
+        if (is_pooled) {
+            QImageBufferPool *pool = imageBufferPool();
+            if (!pool || !pool->release(data, pool_size))
+                QImageBufferPool::freeBuffer(data, pool_size);
+        } else {
+            free(data);
+        }
+    }
     data = nullptr;
 }
 
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qimage.h>
+#include <private/qimage_p.h>
+#include <private/qdrawhelper_p.h>
+#include <private/qsimd_p.h>
+
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+
+QT_BEGIN_NAMESPACE
+
+// Swap the red and blue bytes of len 32-bit pixels and OR mask onto the result.
+// On little endian this is both ARGB32 to RGBA8888 and RGBA8888 to ARGB32.
+// dest may be equal to src.
+void QT_FASTCALL qt_convert_rgbswap32_avx2(quint32 *dest, const quint32 *src, int len, uint mask)
+{
+    const __m256i shuffleMask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m256i alphaMask = _mm256_set1_epi32(mask);
+
+    int i = 0;
+    for (; i < len - 7; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffleMask), alphaMask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), v);
+    }
+    SIMD_EPILOGUE(i, len, 7)
+        dest[i] = ARGB2RGBA(src[i] | mask);
+}
+
+// Copy len RGBA64 pixels setting their alpha to opaque. dest may be equal to src.
+void QT_FASTCALL qt_convert_rgba64_to_rgbx64_avx2(QRgba64 *dest, const QRgba64 *src, int len)
+{
+    const __m256i alphaMask = _mm256_set1_epi64x(qint64(Q_UINT64_C(0xffff) << 48));
+
+    int i = 0;
+    for (; i < len - 3; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), _mm256_or_si256(v, alphaMask));
+    }
+    SIMD_EPILOGUE(i, len, 3) {
+        dest[i] = src[i];
+        dest[i].setAlpha(65535);
+    }
+}
+
+// Multiplies the color channels of two pixels widened to 32-bit lanes by their alpha,
+// rounding the same way as QRgba64::premultiplied().
+static inline __m256i premultiply32_avx2(__m256i v)
+{
+    __m256i a = _mm256_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i x = _mm256_mullo_epi32(v, a);
+    // x / 65535 == (x + (x >> 16) + 0x8000) >> 16
+    x = _mm256_add_epi32(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_add_epi32(x, _mm256_set1_epi32(0x8000));
+    x = _mm256_srli_epi32(x, 16);
+    // Keep the original alpha.
+    return _mm256_blend_epi32(x, v, 0x88);
+}
+
+// Premultiply len RGBA64 pixels. dest may be equal to src.
+void QT_FASTCALL qt_convert_rgba64_to_rgba64pm_avx2(QRgba64 *dest, const QRgba64 *src, int len)
+{
+    int i = 0;
+    for (; i < len - 3; i += 4) {
+        const __m128i *s = reinterpret_cast<const __m128i *>(src + i);
+        __m256i lo = premultiply32_avx2(_mm256_cvtepu16_epi32(_mm_loadu_si128(s)));
+        __m256i hi = premultiply32_avx2(_mm256_cvtepu16_epi32(_mm_loadu_si128(s + 1)));
+        // The per-lane pack leaves the pixels in 0, 2, 1, 3 order.
+        __m256i v = _mm256_packus_epi32(lo, hi);
+        v = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), v);
+    }
+    SIMD_EPILOGUE(i, len, 3)
+        dest[i] = src[i].premultiplied();
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_COMPILER_SUPPORTS_AVX2
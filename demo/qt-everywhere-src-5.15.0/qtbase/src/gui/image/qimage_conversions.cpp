@@ -164,6 +164,34 @@ extern void QT_FASTCALL storeRGB32FromARGB32PM_neon(uchar *dest, const uint *src
                                                     const QVector<QRgb> *, QDitherInfo *);
 #endif
 
+// Calls convertSegment(yStart, yEnd) for bands of scanlines covering the whole image,
+// spreading the bands over the global thread pool when the image is large enough.
+template<typename Segment>
+static void segmentedConversion(const QImageData *data, const Segment &convertSegment)
+{
+#ifdef QT_USE_THREAD_PARALLEL_IMAGE_CONVERSIONS
+    int segments = data->nbytes / (1<<16);
+    segments = std::min(segments, data->height);
+
+    if (segments <= 1)
+        return convertSegment(0, data->height);
+
+    QSemaphore semaphore;
+    int y = 0;
+    for (int i = 0; i < segments; ++i) {
+        int yn = (data->height - y) / (segments - i);
+        QThreadPool::globalInstance()->start([&, y, yn]() {
+            convertSegment(y, y + yn);
+            semaphore.release(1);
+        });
+        y += yn;
+    }
+    semaphore.acquire(segments);
+#else
+    convertSegment(0, data->height);
+#endif
+}
+
 void convert_generic(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags flags)
 {
     // Cannot be used with indexed formats.
@@ -232,27 +260,7 @@ void convert_generic(QImageData *dest, const QImageData *src, Qt::ImageConversio
         }
     };
 
-#ifdef QT_USE_THREAD_PARALLEL_IMAGE_CONVERSIONS
-    int segments = src->nbytes / (1<<16);
-    segments = std::min(segments, src->height);
-
-    if (segments <= 1)
-        return convertSegment(0, src->height);
-
-    QSemaphore semaphore;
-    int y = 0;
-    for (int i = 0; i < segments; ++i) {
-        int yn = (src->height - y) / (segments - i);
-        QThreadPool::globalInstance()->start([&, y, yn]() {
-            convertSegment(y, y + yn);
-            semaphore.release(1);
-        });
-        y += yn;
-    }
-    semaphore.acquire(segments);
-#else
-    convertSegment(0, src->height);
-#endif
+    segmentedConversion(src, convertSegment);
 }
 
 void convert_generic_to_rgb64(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
@@ -286,27 +294,7 @@ void convert_generic_to_rgb64(QImageData *dest, const QImageData *src, Qt::Image
             destData += dest->bytes_per_line;
         }
     };
-#ifdef QT_USE_THREAD_PARALLEL_IMAGE_CONVERSIONS
-    int segments = src->nbytes / (1<<16);
-    segments = std::min(segments, src->height);
-
-    if (segments <= 1)
-        return convertSegment(0, src->height);
-
-    QSemaphore semaphore;
-    int y = 0;
-    for (int i = 0; i < segments; ++i) {
-        int yn = (src->height - y) / (segments - i);
-        QThreadPool::globalInstance()->start([&, y, yn]() {
-            convertSegment(y, y + yn);
-            semaphore.release(1);
-        });
-        y += yn;
-    }
-    semaphore.acquire(segments);
-#else
-    convertSegment(0, src->height);
-#endif
+    segmentedConversion(src, convertSegment);
 }
 
 bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::ImageConversionFlags flags)
@@ -425,7 +413,8 @@ bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::Im
         convertSegment(0, data->height);
     if (params.totalSize != data->nbytes) {
         Q_ASSERT(params.totalSize < data->nbytes);
-        void *newData = realloc(data->data, params.totalSize);
+        // A pooled buffer keeps its size so that it can be returned to the pool
+        void *newData = data->is_pooled ? data->data : realloc(data->data, params.totalSize);
         if (newData) {
             data->data = (uchar *)newData;
             data->nbytes = params.totalSize;
@@ -551,64 +540,92 @@ static void convert_RGB888_to_RGB(QImageData *dest, const QImageData *src, Qt::I
     Q_ASSERT(src->width == dest->width);
     Q_ASSERT(src->height == dest->height);
 
-    const uchar *src_data = (uchar *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
     Rgb888ToRgbConverter line_converter= rgbx ? qt_convert_rgb888_to_rgbx8888 : qt_convert_rgb888_to_rgb32;
 
-    for (int i = 0; i < src->height; ++i) {
-        line_converter(dest_data, src_data, src->width);
-        src_data += src->bytes_per_line;
-        dest_data = (quint32 *)((uchar*)dest_data + dest->bytes_per_line);
-    }
+    segmentedConversion(src, [=](int yStart, int yEnd) {
+        const uchar *src_data = src->data + src->bytes_per_line * yStart;
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            line_converter(dest_data, src_data, src->width);
+            src_data += src->bytes_per_line;
+            dest_data = (quint32 *)((uchar*)dest_data + dest->bytes_per_line);
+        }
+    });
 }
 
-static void convert_ARGB_to_RGBx(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+typedef void (QT_FASTCALL *Rgb32SwapFunc)(quint32 *dest, const quint32 *src, int len, uint mask);
+
+static void QT_FASTCALL convert_ARGB_to_RGBA_line(quint32 *dest, const quint32 *src, int len, uint mask)
+{
+    for (int i = 0; i < len; ++i)
+        dest[i] = ARGB2RGBA(src[i] | mask);
+}
+
+static void QT_FASTCALL convert_RGBA_to_ARGB_line(quint32 *dest, const quint32 *src, int len, uint mask)
+{
+    for (int i = 0; i < len; ++i)
+        dest[i] = mask | RGBA2ARGB(src[i]);
+}
+
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_AVX2)
+extern void QT_FASTCALL qt_convert_rgbswap32_avx2(quint32 *dest, const quint32 *src, int len, uint mask);
+#endif
+
+static inline Rgb32SwapFunc rgb32SwapFunc(Rgb32SwapFunc func)
+{
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_AVX2)
+    // On little endian both directions swap the red and blue bytes and leave alpha
+    // in the top byte, so they share the same vectorized kernel.
+    if (qCpuHasFeature(AVX2))
+        return qt_convert_rgbswap32_avx2;
+#endif
+    return func;
+}
+
+static void convert_rgb32_swap(QImageData *dest, const QImageData *src, Rgb32SwapFunc func, uint mask)
 {
-    Q_ASSERT(src->format == QImage::Format_ARGB32);
-    Q_ASSERT(dest->format == QImage::Format_RGBX8888);
     Q_ASSERT(src->width == dest->width);
     Q_ASSERT(src->height == dest->height);
 
-    const int src_pad = (src->bytes_per_line >> 2) - src->width;
-    const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
+    func = rgb32SwapFunc(func);
+    segmentedConversion(src, [=](int yStart, int yEnd) {
+        const uchar *src_data = src->data + src->bytes_per_line * yStart;
+        uchar *dest_data = dest->data + dest->bytes_per_line * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            func(reinterpret_cast<quint32 *>(dest_data), reinterpret_cast<const quint32 *>(src_data), src->width, mask);
+            src_data += src->bytes_per_line;
+            dest_data += dest->bytes_per_line;
+        }
+    });
+}
 
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = ARGB2RGBA(0xff000000 | *src_data);
-            ++src_data;
-            ++dest_data;
+static void convert_rgb32_swap_inplace(QImageData *data, Rgb32SwapFunc func, uint mask)
+{
+    func = rgb32SwapFunc(func);
+    segmentedConversion(data, [=](int yStart, int yEnd) {
+        uchar *line_data = data->data + data->bytes_per_line * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            quint32 *rgb_data = reinterpret_cast<quint32 *>(line_data);
+            func(rgb_data, rgb_data, data->width, mask);
+            line_data += data->bytes_per_line;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    });
+}
+
+static void convert_ARGB_to_RGBx(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_ARGB32);
+    Q_ASSERT(dest->format == QImage::Format_RGBX8888);
+
+    convert_rgb32_swap(dest, src, convert_ARGB_to_RGBA_line, 0xff000000);
 }
 
 static void convert_ARGB_to_RGBA(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
 {
     Q_ASSERT(src->format == QImage::Format_ARGB32 || src->format == QImage::Format_ARGB32_Premultiplied);
     Q_ASSERT(dest->format == QImage::Format_RGBA8888 || dest->format == QImage::Format_RGBA8888_Premultiplied);
-    Q_ASSERT(src->width == dest->width);
-    Q_ASSERT(src->height == dest->height);
-
-    const int src_pad = (src->bytes_per_line >> 2) - src->width;
-    const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
 
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = ARGB2RGBA(*src_data);
-            ++src_data;
-            ++dest_data;
-        }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    convert_rgb32_swap(dest, src, convert_ARGB_to_RGBA_line, 0);
 }
 
 template<QImage::Format DestFormat>
@@ -616,18 +633,8 @@ static bool convert_ARGB_to_RGBA_inplace(QImageData *data, Qt::ImageConversionFl
 {
     Q_ASSERT(data->format == QImage::Format_ARGB32 || data->format == QImage::Format_ARGB32_Premultiplied);
 
-    const int pad = (data->bytes_per_line >> 2) - data->width;
-    quint32 *rgb_data = (quint32 *) data->data;
     Q_CONSTEXPR uint mask = (DestFormat == QImage::Format_RGBX8888) ? 0xff000000 : 0;
-
-    for (int i = 0; i < data->height; ++i) {
-        const quint32 *end = rgb_data + data->width;
-        while (rgb_data < end) {
-            *rgb_data = ARGB2RGBA(*rgb_data | mask);
-            ++rgb_data;
-        }
-        rgb_data += pad;
-    }
+    convert_rgb32_swap_inplace(data, convert_ARGB_to_RGBA_line, mask);
 
     data->format = DestFormat;
     return true;
@@ -637,24 +644,8 @@ static void convert_RGBA_to_ARGB(QImageData *dest, const QImageData *src, Qt::Im
 {
     Q_ASSERT(src->format == QImage::Format_RGBX8888 || src->format == QImage::Format_RGBA8888 || src->format == QImage::Format_RGBA8888_Premultiplied);
     Q_ASSERT(dest->format == QImage::Format_ARGB32 || dest->format == QImage::Format_ARGB32_Premultiplied);
-    Q_ASSERT(src->width == dest->width);
-    Q_ASSERT(src->height == dest->height);
-
-    const int src_pad = (src->bytes_per_line >> 2) - src->width;
-    const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
 
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = RGBA2ARGB(*src_data);
-            ++src_data;
-            ++dest_data;
-        }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    convert_rgb32_swap(dest, src, convert_RGBA_to_ARGB_line, 0);
 }
 
 template<QImage::Format DestFormat>
@@ -662,18 +653,9 @@ static bool convert_RGBA_to_ARGB_inplace(QImageData *data, Qt::ImageConversionFl
 {
     Q_ASSERT(data->format == QImage::Format_RGBX8888 || data->format == QImage::Format_RGBA8888 || data->format == QImage::Format_RGBA8888_Premultiplied);
 
-    const int pad = (data->bytes_per_line >> 2) - data->width;
-    QRgb *rgb_data = (QRgb *) data->data;
     Q_CONSTEXPR uint mask = (DestFormat == QImage::Format_RGB32) ? 0xff000000 : 0;
+    convert_rgb32_swap_inplace(data, convert_RGBA_to_ARGB_line, mask);
 
-    for (int i = 0; i < data->height; ++i) {
-        const QRgb *end = rgb_data + data->width;
-        while (rgb_data < end) {
-            *rgb_data = mask | RGBA2ARGB(*rgb_data);
-            ++rgb_data;
-        }
-        rgb_data += pad;
-    }
     data->format = DestFormat;
     return true;
 }
@@ -688,15 +670,17 @@ static void convert_rgbswap_generic(QImageData *dest, const QImageData *src, Qt:
 
     const qsizetype sbpl = src->bytes_per_line;
     const qsizetype dbpl = dest->bytes_per_line;
-    const uchar *src_data = src->data;
-    uchar *dest_data = dest->data;
 
-    for (int i = 0; i < src->height; ++i) {
-        func(dest_data, src_data, src->width);
+    segmentedConversion(src, [=](int yStart, int yEnd) {
+        const uchar *src_data = src->data + sbpl * yStart;
+        uchar *dest_data = dest->data + dbpl * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            func(dest_data, src_data, src->width);
 
-        src_data += sbpl;
-        dest_data += dbpl;
-    }
+            src_data += sbpl;
+            dest_data += dbpl;
+        }
+    });
 }
 
 static bool convert_rgbswap_generic_inplace(QImageData *data, Qt::ImageConversionFlags)
@@ -705,12 +689,14 @@ static bool convert_rgbswap_generic_inplace(QImageData *data, Qt::ImageConversio
     Q_ASSERT(func);
 
     const qsizetype bpl = data->bytes_per_line;
-    uchar *line_data = data->data;
 
-    for (int i = 0; i < data->height; ++i) {
-        func(line_data, line_data, data->width);
-        line_data += bpl;
-    }
+    segmentedConversion(data, [=](int yStart, int yEnd) {
+        uchar *line_data = data->data + bpl * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            func(line_data, line_data, data->width);
+            line_data += bpl;
+        }
+    });
 
     switch (data->format) {
     case QImage::Format_RGB888:
@@ -1086,16 +1072,17 @@ static void convert_RGBA64_to_ARGB32(QImageData *dest, const QImageData *src, Qt
     Q_ASSERT(src->width == dest->width);
     Q_ASSERT(src->height == dest->height);
 
-    const uchar *srcData = src->data;
-    uchar *destData = dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        uint *d = reinterpret_cast<uint *>(destData);
-        const QRgba64 *s = reinterpret_cast<const QRgba64 *>(srcData);
-        qt_convertRGBA64ToARGB32<RGBA>(d, s, src->width);
-        srcData += src->bytes_per_line;
-        destData += dest->bytes_per_line;
-    }
+    segmentedConversion(src, [=](int yStart, int yEnd) {
+        const uchar *srcData = src->data + src->bytes_per_line * yStart;
+        uchar *destData = dest->data + dest->bytes_per_line * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            uint *d = reinterpret_cast<uint *>(destData);
+            const QRgba64 *s = reinterpret_cast<const QRgba64 *>(srcData);
+            qt_convertRGBA64ToARGB32<RGBA>(d, s, src->width);
+            srcData += src->bytes_per_line;
+            destData += dest->bytes_per_line;
+        }
+    });
 }
 
 template<bool RGBA>
@@ -1107,57 +1094,110 @@ static void convert_ARGB32_to_RGBA64(QImageData *dest, const QImageData *src, Qt
     Q_ASSERT(src->width == dest->width);
     Q_ASSERT(src->height == dest->height);
 
-    const uchar *src_data = src->data;
-    uchar *dest_data = dest->data;
     const FetchAndConvertPixelsFunc64 fetch = qPixelLayouts[src->format + 1].fetchToRGBA64PM;
 
-    for (int i = 0; i < src->height; ++i) {
-        fetch(reinterpret_cast<QRgba64 *>(dest_data), src_data, 0, src->width, nullptr, nullptr);
-        src_data += src->bytes_per_line;;
-        dest_data += dest->bytes_per_line;
+    segmentedConversion(src, [=](int yStart, int yEnd) {
+        const uchar *src_data = src->data + src->bytes_per_line * yStart;
+        uchar *dest_data = dest->data + dest->bytes_per_line * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            fetch(reinterpret_cast<QRgba64 *>(dest_data), src_data, 0, src->width, nullptr, nullptr);
+            src_data += src->bytes_per_line;
+            dest_data += dest->bytes_per_line;
+        }
+    });
+}
+
+typedef void (QT_FASTCALL *Rgba64LineFunc)(QRgba64 *dest, const QRgba64 *src, int len);
+
+static void QT_FASTCALL convert_RGBA64_to_RGBx64_line(QRgba64 *dest, const QRgba64 *src, int len)
+{
+    for (int i = 0; i < len; ++i) {
+        dest[i] = src[i];
+        dest[i].setAlpha(65535);
     }
 }
 
-static void convert_RGBA64_to_RGBx64(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+static void QT_FASTCALL convert_RGBA64_to_RGBA64PM_line(QRgba64 *dest, const QRgba64 *src, int len)
+{
+    for (int i = 0; i < len; ++i)
+        dest[i] = src[i].premultiplied();
+}
+
+template<bool MaskAlpha>
+static void QT_FASTCALL convert_RGBA64PM_to_RGBA64_line(QRgba64 *dest, const QRgba64 *src, int len)
+{
+    for (int i = 0; i < len; ++i) {
+        dest[i] = src[i].unpremultiplied();
+        if (MaskAlpha)
+            dest[i].setAlpha(65535);
+    }
+}
+
+static void convert_rgba64_lines(QImageData *dest, const QImageData *src, Rgba64LineFunc func)
 {
-    Q_ASSERT(src->format == QImage::Format_RGBA64);
-    Q_ASSERT(dest->format == QImage::Format_RGBX64);
     Q_ASSERT(src->width == dest->width);
     Q_ASSERT(src->height == dest->height);
 
-    const int src_pad = (src->bytes_per_line >> 3) - src->width;
-    const int dest_pad = (dest->bytes_per_line >> 3) - dest->width;
-    const QRgba64 *src_data = reinterpret_cast<const QRgba64 *>(src->data);
-    QRgba64 *dest_data = reinterpret_cast<QRgba64 *>(dest->data);
+    segmentedConversion(src, [=](int yStart, int yEnd) {
+        const uchar *src_data = src->data + src->bytes_per_line * yStart;
+        uchar *dest_data = dest->data + dest->bytes_per_line * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            func(reinterpret_cast<QRgba64 *>(dest_data), reinterpret_cast<const QRgba64 *>(src_data), src->width);
+            src_data += src->bytes_per_line;
+            dest_data += dest->bytes_per_line;
+        }
+    });
+}
 
-    for (int i = 0; i < src->height; ++i) {
-        const QRgba64 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = *src_data;
-            dest_data->setAlpha(65535);
-            ++src_data;
-            ++dest_data;
+static void convert_rgba64_lines_inplace(QImageData *data, Rgba64LineFunc func)
+{
+    segmentedConversion(data, [=](int yStart, int yEnd) {
+        uchar *line_data = data->data + data->bytes_per_line * yStart;
+        for (int i = yStart; i < yEnd; ++i) {
+            QRgba64 *rgb_data = reinterpret_cast<QRgba64 *>(line_data);
+            func(rgb_data, rgb_data, data->width);
+            line_data += data->bytes_per_line;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    });
+}
+
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_AVX2)
+extern void QT_FASTCALL qt_convert_rgba64_to_rgbx64_avx2(QRgba64 *dest, const QRgba64 *src, int len);
+extern void QT_FASTCALL qt_convert_rgba64_to_rgba64pm_avx2(QRgba64 *dest, const QRgba64 *src, int len);
+#endif
+
+static inline Rgba64LineFunc rgba64ToRgbx64Func()
+{
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_AVX2)
+    if (qCpuHasFeature(AVX2))
+        return qt_convert_rgba64_to_rgbx64_avx2;
+#endif
+    return convert_RGBA64_to_RGBx64_line;
+}
+
+static inline Rgba64LineFunc rgba64ToRgba64PMFunc()
+{
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_AVX2)
+    if (qCpuHasFeature(AVX2))
+        return qt_convert_rgba64_to_rgba64pm_avx2;
+#endif
+    return convert_RGBA64_to_RGBA64PM_line;
+}
+
+static void convert_RGBA64_to_RGBx64(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_RGBA64);
+    Q_ASSERT(dest->format == QImage::Format_RGBX64);
+
+    convert_rgba64_lines(dest, src, rgba64ToRgbx64Func());
 }
 
 static bool convert_RGBA64_to_RGBx64_inplace(QImageData *data, Qt::ImageConversionFlags)
 {
     Q_ASSERT(data->format == QImage::Format_RGBA64);
 
-    const int pad = (data->bytes_per_line >> 3) - data->width;
-    QRgba64 *rgb_data = reinterpret_cast<QRgba64 *>(data->data);
+    convert_rgba64_lines_inplace(data, rgba64ToRgbx64Func());
 
-    for (int i = 0; i < data->height; ++i) {
-        const QRgba64 *end = rgb_data + data->width;
-        while (rgb_data < end) {
-            rgb_data->setAlpha(65535);
-            ++rgb_data;
-        }
-        rgb_data += pad;
-    }
     data->format = QImage::Format_RGBX64;
     return true;
 }
@@ -1166,41 +1206,16 @@ static void convert_RGBA64_to_RGBA64PM(QImageData *dest, const QImageData *src,
 {
     Q_ASSERT(src->format == QImage::Format_RGBA64);
     Q_ASSERT(dest->format == QImage::Format_RGBA64_Premultiplied);
-    Q_ASSERT(src->width == dest->width);
-    Q_ASSERT(src->height == dest->height);
 
-    const int src_pad = (src->bytes_per_line >> 3) - src->width;
-    const int dest_pad = (dest->bytes_per_line >> 3) - dest->width;
-    const QRgba64 *src_data = reinterpret_cast<const QRgba64 *>(src->data);
-    QRgba64 *dest_data = reinterpret_cast<QRgba64 *>(dest->data);
-
-    for (int i = 0; i < src->height; ++i) {
-        const QRgba64 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = src_data->premultiplied();
-            ++src_data;
-            ++dest_data;
-        }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    convert_rgba64_lines(dest, src, rgba64ToRgba64PMFunc());
 }
 
 static bool convert_RGBA64_to_RGBA64PM_inplace(QImageData *data, Qt::ImageConversionFlags)
 {
     Q_ASSERT(data->format == QImage::Format_RGBA64);
 
-    const int pad = (data->bytes_per_line >> 3) - data->width;
-    QRgba64 *rgb_data = reinterpret_cast<QRgba64 *>(data->data);
+    convert_rgba64_lines_inplace(data, rgba64ToRgba64PMFunc());
 
-    for (int i = 0; i < data->height; ++i) {
-        const QRgba64 *end = rgb_data + data->width;
-        while (rgb_data < end) {
-            *rgb_data = rgb_data->premultiplied();
-            ++rgb_data;
-        }
-        rgb_data += pad;
-    }
     data->format = QImage::Format_RGBA64_Premultiplied;
     return true;
 }
@@ -1210,26 +1225,8 @@ static void convert_RGBA64PM_to_RGBA64(QImageData *dest, const QImageData *src,
 {
     Q_ASSERT(src->format == QImage::Format_RGBA64_Premultiplied);
     Q_ASSERT(dest->format == QImage::Format_RGBA64 || dest->format == QImage::Format_RGBX64);
-    Q_ASSERT(src->width == dest->width);
-    Q_ASSERT(src->height == dest->height);
-
-    const int src_pad = (src->bytes_per_line >> 3) - src->width;
-    const int dest_pad = (dest->bytes_per_line >> 3) - dest->width;
-    const QRgba64 *src_data = reinterpret_cast<const QRgba64 *>(src->data);
-    QRgba64 *dest_data = reinterpret_cast<QRgba64 *>(dest->data);
 
-    for (int i = 0; i < src->height; ++i) {
-        const QRgba64 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = src_data->unpremultiplied();
-            if (MaskAlpha)
-                dest_data->setAlpha(65535);
-            ++src_data;
-            ++dest_data;
-        }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    convert_rgba64_lines(dest, src, convert_RGBA64PM_to_RGBA64_line<MaskAlpha>);
 }
 
 template<bool MaskAlpha>
@@ -1237,19 +1234,8 @@ static bool convert_RGBA64PM_to_RGBA64_inplace(QImageData *data, Qt::ImageConver
 {
     Q_ASSERT(data->format == QImage::Format_RGBA64_Premultiplied);
 
-    const int pad = (data->bytes_per_line >> 3) - data->width;
-    QRgba64 *rgb_data = reinterpret_cast<QRgba64 *>(data->data);
+    convert_rgba64_lines_inplace(data, convert_RGBA64PM_to_RGBA64_line<MaskAlpha>);
 
-    for (int i = 0; i < data->height; ++i) {
-        const QRgba64 *end = rgb_data + data->width;
-        while (rgb_data < end) {
-            *rgb_data = rgb_data->unpremultiplied();
-            if (MaskAlpha)
-                rgb_data->setAlpha(65535);
-            ++rgb_data;
-        }
-        rgb_data += pad;
-    }
     data->format = MaskAlpha ? QImage::Format_RGBX64 : QImage::Format_RGBA64;
     return true;
 }
@@ -92,6 +92,9 @@ struct Q_GUI_EXPORT QImageData {        // internal image data
     uint has_alpha_clut : 1;
     uint is_cached : 1;
     uint is_locked : 1;
+    uint is_pooled : 1;
+
+    qsizetype pool_size;     // size of the pooled buffer, if is_pooled
 
     QImageCleanupFunction cleanupFunction;
     void* cleanupInfo;
@@ -118,6 +121,18 @@ struct Q_GUI_EXPORT QImageData {        // internal image data
     static ImageSizeParameters calculateImageParameters(qsizetype width, qsizetype height, qsizetype depth);
 };
 
+struct QImageBufferPoolStatistics
+{
+    qint64 hits;
+    qint64 misses;
+    qint64 cachedBytes;
+    int cachedBuffers;
+    qint64 limit;
+};
+
+Q_GUI_EXPORT void qt_setImageBufferPoolLimit(qint64 bytes);
+Q_GUI_EXPORT QImageBufferPoolStatistics qt_imageBufferPoolStatistics();
+
 inline QImageData::ImageSizeParameters
 QImageData::calculateImageParameters(qsizetype width, qsizetype height, qsizetype depth)
 {
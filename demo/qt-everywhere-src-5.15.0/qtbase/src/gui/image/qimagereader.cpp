@@ -146,6 +146,13 @@
 #include <qsize.h>
 #include <qcolor.h>
 #include <qvariant.h>
+#if QT_CONFIG(future)
+#include <qfutureinterface.h>
+#include <qhash.h>
+#include <qmutex.h>
+#include <qqueue.h>
+#include <qthreadpool.h>
+#endif
 
 // factory loader
 #include <qcoreapplication.h>
@@ -1612,4 +1619,175 @@ QList<QByteArray> QImageReader::imageFormatsForMimeType(const QByteArray &mimeTy
                                                               QImageReaderWriterHelpers::CanRead);
 }
 
+#if QT_CONFIG(future)
+// Decodes images for QImageReader::readAsync(). The decodes are run on a
+// thread pool of their own, and a decode is only started while the memory of
+// the images being decoded stays within the budget.
+class QImageDecodePool
+{
+public:
+    QFuture<QImage> decode(const QString &fileName, const QSize &scaledSize, const QByteArray &format);
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+
+private:
+    struct Job {
+        QString key;
+        QImageReader *reader;
+        qint64 cost;
+        QFutureInterface<QImage> result;
+    };
+
+    void startJobs();
+    void run(Job *job);
+    void finish(Job *job);
+
+    mutable QMutex mutex;
+    QThreadPool pool;
+    QQueue<Job *> pending;
+    QHash<QString, Job *> jobs; // pending and running, by key
+    qint64 budget = 256 * 1024 * 1024;
+    qint64 inFlight = 0;
+};
+
+Q_GLOBAL_STATIC(QImageDecodePool, imageDecodePool)
+
+QFuture<QImage> QImageDecodePool::decode(const QString &fileName, const QSize &scaledSize,
+                                         const QByteArray &format)
+{
+    const QString key = fileName + QLatin1Char('|') + QString::number(scaledSize.width())
+                      + QLatin1Char('x') + QString::number(scaledSize.height())
+                      + QLatin1Char('|') + QLatin1String(format);
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        if (Job *job = jobs.value(key))
+            return job->result.future();
+    }
+
+    // Read the header outside the lock, it's what the cost is estimated from.
+    QImageReader *reader = new QImageReader(fileName, format);
+    if (scaledSize.isValid())
+        reader->setScaledSize(scaledSize);
+    const QSize size = scaledSize.isValid() ? scaledSize : reader->size();
+    const QImage::Format imageFormat = reader->imageFormat();
+    const int depth = imageFormat == QImage::Format_Invalid ? 32 : qt_depthForFormat(imageFormat);
+    const qint64 cost = size.isValid() ? qint64(size.width()) * size.height() * depth / 8 : 0;
+
+    const auto locker = qt_scoped_lock(mutex);
+    if (Job *job = jobs.value(key)) {
+        delete reader;
+        return job->result.future();
+    }
+    Job *job = new Job{key, reader, cost, QFutureInterface<QImage>()};
+    job->result.reportStarted();
+    jobs.insert(key, job);
+    pending.enqueue(job);
+    startJobs();
+    return job->result.future();
+}
+
+void QImageDecodePool::setMemoryBudget(qint64 bytes)
+{
+    const auto locker = qt_scoped_lock(mutex);
+    budget = bytes;
+    startJobs();
+}
+
+qint64 QImageDecodePool::memoryBudget() const
+{
+    const auto locker = qt_scoped_lock(mutex);
+    return budget;
+}
+
+// Must be called with the mutex held.
+void QImageDecodePool::startJobs()
+{
+    while (!pending.isEmpty()) {
+        Job *job = pending.head();
+        if (job->result.isCanceled()) {
+            pending.dequeue();
+            finish(job);
+            continue;
+        }
+        // An image larger than the whole budget is decoded when nothing else is.
+        if (inFlight > 0 && inFlight + job->cost > budget)
+            break;
+        pending.dequeue();
+        inFlight += job->cost;
+        pool.start([this, job]() { run(job); });
+    }
+}
+
+void QImageDecodePool::run(Job *job)
+{
+    if (!job->result.isCanceled()) {
+        const QImage image = job->reader->read();
+        job->result.reportResult(image);
+    }
+
+    const auto locker = qt_scoped_lock(mutex);
+    inFlight -= job->cost;
+    finish(job);
+    startJobs();
+}
+
+// Must be called with the mutex held.
+void QImageDecodePool::finish(Job *job)
+{
+    jobs.remove(job->key);
+    job->result.reportFinished();
+    delete job->reader;
+    delete job;
+}
+
+/*!
+    \since 5.15
+
+    Decodes the image in \a fileName on a shared pool of threads, and returns
+    a future for the image. If \a scaledSize is valid, the image is decoded at
+    that size, using the decoder's own scaling when it has one. If \a format
+    is not empty, it is used in place of detecting the format.
+
+    The future yields a null image if the image could not be read.
+
+    Decodes only start while the estimated memory of all images being decoded
+    stays within asyncMemoryBudget(). Cancelling the future of a decode that
+    has not started yet drops it. Requests for the same file, scaled size and
+    format that are made while one is still pending share the same future.
+
+    \sa setAsyncMemoryBudget(), read()
+*/
+QFuture<QImage> QImageReader::readAsync(const QString &fileName, const QSize &scaledSize,
+                                        const QByteArray &format)
+{
+    return imageDecodePool()->decode(fileName, scaledSize, format);
+}
+
+/*!
+    \since 5.15
+
+    Sets the memory budget of the images being decoded by readAsync() to
+    \a bytes. The default is 256 megabytes.
+
+    \sa asyncMemoryBudget()
+*/
+void QImageReader::setAsyncMemoryBudget(qint64 bytes)
+{
+    imageDecodePool()->setMemoryBudget(bytes);
+}
+
+/*!
+    \since 5.15
+
+    Returns the memory budget of the images being decoded by readAsync().
+
+    \sa setAsyncMemoryBudget()
+*/
+qint64 QImageReader::asyncMemoryBudget()
+{
+    return imageDecodePool()->memoryBudget();
+}
+#endif // QT_CONFIG(future)
+
 QT_END_NAMESPACE
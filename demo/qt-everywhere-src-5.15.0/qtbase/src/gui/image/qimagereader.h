@@ -45,6 +45,9 @@
 #include <QtCore/qcoreapplication.h>
 #include <QtGui/qimage.h>
 #include <QtGui/qimageiohandler.h>
+#if QT_CONFIG(future)
+#include <QtCore/qfuture.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -150,6 +153,13 @@ public:
     static QList<QByteArray> supportedMimeTypes();
     static QList<QByteArray> imageFormatsForMimeType(const QByteArray &mimeType);
 
+#if QT_CONFIG(future)
+    static QFuture<QImage> readAsync(const QString &fileName, const QSize &scaledSize = QSize(),
+                                     const QByteArray &format = QByteArray());
+    static void setAsyncMemoryBudget(qint64 bytes);
+    static qint64 asyncMemoryBudget();
+#endif
+
 private:
     Q_DISABLE_COPY(QImageReader)
     QImageReaderPrivate *d;
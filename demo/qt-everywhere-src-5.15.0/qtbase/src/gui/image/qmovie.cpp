@@ -87,7 +87,9 @@
     milliseconds the current frame should be displayed.
 
     QMovie can be instructed to cache frames of an animation by calling
-    setCacheMode().
+    setCacheMode(). For large animations read from a file, setDecodeAheadFrames()
+    makes QMovie decode the coming frames on a worker thread, so that showing a
+    frame does not block the GUI thread on decoding it.
 
     Call supportedFormats() for a list of formats that QMovie supports.
 
@@ -187,7 +189,13 @@
 #include "qlist.h"
 #include "qbuffer.h"
 #include "qdir.h"
+#include "qqueue.h"
 #include "private/qobject_p.h"
+#if QT_CONFIG(thread)
+#include "qmutex.h"
+#include "qthread.h"
+#include "qwaitcondition.h"
+#endif
 
 #define QMOVIE_INVALID_DELAY -1
 
@@ -224,6 +232,148 @@ public:
 };
 Q_DECLARE_TYPEINFO(QFrameInfo, Q_MOVABLE_TYPE);
 
+#if QT_CONFIG(thread)
+/*!
+    \internal
+
+    Decodes the frames of a movie file ahead of time, on a thread and with a
+    QImageReader of its own. The decoded frames wait in a queue bounded by a
+    number of frames and of bytes, until QMovie takes them.
+*/
+class QMovieFrameDecoder : public QThread
+{
+public:
+    struct Frame
+    {
+        enum Status { Decoded, End, Error };
+        Status status = End;
+        QImage image;
+        int delay = QMOVIE_INVALID_DELAY;
+        QImageReader::ImageReaderError error = QImageReader::UnknownError;
+        QString errorString;
+    };
+
+    QMovieFrameDecoder(const QString &fileName, const QByteArray &format,
+                       const QSize &scaledSize, const QColor &backgroundColor,
+                       int firstFrame, int maxFrames, qint64 maxBytes)
+        : fileName(fileName), format(format), scaledSize(scaledSize),
+          backgroundColor(backgroundColor), firstFrame(firstFrame),
+          maxFrames(maxFrames), maxBytes(maxBytes), nextFrame(firstFrame)
+    { }
+    ~QMovieFrameDecoder() { stop(); }
+
+    // the number of the frame takeFrame() returns next
+    int nextFrameNumber() const { return nextFrame; }
+    Frame takeFrame();
+    void stop();
+
+protected:
+    void run() override;
+
+private:
+    bool push(Frame &&frame);
+
+    const QString fileName;
+    const QByteArray format;
+    const QSize scaledSize;
+    const QColor backgroundColor;
+    const int firstFrame;
+    const int maxFrames;
+    const qint64 maxBytes;
+    int nextFrame;
+
+    QMutex mutex;
+    QWaitCondition frameReady;
+    QWaitCondition spaceFree;
+    QQueue<Frame> frames;
+    qint64 queuedBytes = 0;
+    bool stopRequested = false;
+};
+
+/*! \internal
+
+    Returns the next frame, waiting for it to be decoded if needed. After a
+    frame with the End or Error status, no more frames follow.
+ */
+QMovieFrameDecoder::Frame QMovieFrameDecoder::takeFrame()
+{
+    QMutexLocker locker(&mutex);
+    while (frames.isEmpty())
+        frameReady.wait(&mutex);
+    Frame frame = frames.dequeue();
+    queuedBytes -= frame.image.sizeInBytes();
+    spaceFree.wakeOne();
+    ++nextFrame;
+    return frame;
+}
+
+void QMovieFrameDecoder::stop()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+        spaceFree.wakeAll();
+    }
+    wait();
+}
+
+bool QMovieFrameDecoder::push(Frame &&frame)
+{
+    const qint64 bytes = frame.image.sizeInBytes();
+    QMutexLocker locker(&mutex);
+    // a single frame larger than the limit is still let through
+    while (!stopRequested && !frames.isEmpty()
+           && (frames.size() >= maxFrames || queuedBytes + bytes > maxBytes)) {
+        spaceFree.wait(&mutex);
+    }
+    if (stopRequested)
+        return false;
+    queuedBytes += bytes;
+    frames.enqueue(std::move(frame));
+    frameReady.wakeOne();
+    return true;
+}
+
+void QMovieFrameDecoder::run()
+{
+    QImageReader reader(fileName, format);
+    reader.setScaledSize(scaledSize);
+    reader.setBackgroundColor(backgroundColor);
+
+    // read through to the first frame if the handler cannot jump there
+    if (firstFrame > 0 && !reader.jumpToImage(firstFrame)) {
+        for (int i = 0; i < firstFrame; ++i) {
+            if (!reader.canRead() || reader.read().isNull()) {
+                Frame frame;
+                frame.status = Frame::Error;
+                frame.error = reader.error();
+                frame.errorString = reader.errorString();
+                push(std::move(frame));
+                return;
+            }
+        }
+    }
+
+    for (;;) {
+        Frame frame;
+        if (reader.canRead()) {
+            frame.image = reader.read();
+            if (frame.image.isNull()) {
+                frame.status = Frame::Error;
+                frame.error = reader.error();
+                frame.errorString = reader.errorString();
+            } else {
+                frame.status = Frame::Decoded;
+                frame.delay = reader.nextImageDelay();
+            }
+        }
+        const bool last = frame.status != Frame::Decoded;
+        if (!push(std::move(frame)) || last)
+            return;
+    }
+}
+#endif // QT_CONFIG(thread)
+
 class QMoviePrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QMovie)
@@ -239,6 +389,13 @@ public:
     bool jumpToNextFrame();
     QFrameInfo infoForFrame(int frameNumber);
     void reset();
+    void discardDecodedFrames();
+    void rewindReader();
+    void catchUpReader();
+    QImageReader::ImageReaderError readerError() const;
+#if QT_CONFIG(thread)
+    QFrameInfo decodedFrame(int frameNumber);
+#endif
 
     inline void enterState(QMovie::MovieState newState) {
         movieState = newState;
@@ -266,6 +423,18 @@ public:
     QMap<int, QFrameInfo> frameMap;
     QString absoluteFilePath;
 
+    int decodeAheadFrames;
+    int decodeAheadLimit; // in kilobytes
+#if QT_CONFIG(thread)
+    QScopedPointer<QMovieFrameDecoder> decoder;
+#endif
+    qint64 residentBytes;
+    bool collectingFrames; // keeping the decoded frames in frameMap
+    bool residentLoop; // all frames are in frameMap
+    bool readerBehind; // frames were read by the decode-ahead thread instead
+    QImageReader::ImageReaderError decoderError;
+    QString decoderErrorString;
+
     QTimer nextImageTimer;
 };
 
@@ -275,7 +444,10 @@ QMoviePrivate::QMoviePrivate(QMovie *qq)
     : reader(nullptr), speed(100), movieState(QMovie::NotRunning),
       currentFrameNumber(-1), nextFrameNumber(0), greatestFrameNumber(-1),
       nextDelay(0), playCounter(-1),
-      cacheMode(QMovie::CacheNone), haveReadAll(false), isFirstIteration(true)
+      cacheMode(QMovie::CacheNone), haveReadAll(false), isFirstIteration(true),
+      decodeAheadFrames(0), decodeAheadLimit(32 * 1024), residentBytes(0),
+      collectingFrames(false), residentLoop(false), readerBehind(false),
+      decoderError(QImageReader::UnknownError)
 {
     q_ptr = qq;
     nextImageTimer.setSingleShot(true);
@@ -295,9 +467,37 @@ void QMoviePrivate::reset()
     playCounter = -1;
     haveReadAll = false;
     isFirstIteration = true;
+    discardDecodedFrames();
+    readerBehind = false;
     frameMap.clear();
 }
 
+/*! \internal
+
+    Stops decoding ahead and drops the frames kept from it, as they no longer
+    match the movie's settings.
+ */
+void QMoviePrivate::discardDecodedFrames()
+{
+#if QT_CONFIG(thread)
+    decoder.reset();
+#endif
+    if (collectingFrames || residentLoop)
+        frameMap.clear();
+    residentBytes = 0;
+    collectingFrames = false;
+    residentLoop = false;
+    decoderError = QImageReader::UnknownError;
+    decoderErrorString.clear();
+}
+
+/*! \internal
+ */
+QImageReader::ImageReaderError QMoviePrivate::readerError() const
+{
+    return decoderError != QImageReader::UnknownError ? decoderError : reader->error();
+}
+
 /*! \internal
  */
 bool QMoviePrivate::isDone()
@@ -318,6 +518,56 @@ int QMoviePrivate::speedAdjustedDelay(int delay) const
     return int( (qint64(delay) * qint64(100) ) / qint64(speed) );
 }
 
+/*!
+    \internal
+
+    Recreates the reader, so that it reads from the first frame again.
+*/
+void QMoviePrivate::rewindReader()
+{
+    Q_Q(QMovie);
+
+    // ### This could be implemented as QImageReader::rewind()
+    QString fileName = reader->fileName();
+    QByteArray format = reader->format();
+    QIODevice *device = reader->device();
+    QColor bgColor = reader->backgroundColor();
+    QSize scaledSize = reader->scaledSize();
+    delete reader;
+    if (fileName.isEmpty())
+        reader = new QImageReader(device, format);
+    else
+        reader = new QImageReader(absoluteFilePath, format);
+    if (!reader->canRead()) // Provoke a device->open() call
+        emit q->error(reader->error());
+    reader->device()->seek(initialDevicePos);
+    reader->setBackgroundColor(bgColor);
+    reader->setScaledSize(scaledSize);
+}
+
+/*!
+    \internal
+
+    While frames come from the decode-ahead thread, the reader stays where it
+    was. Before it is used again, this rewinds it and, unless the frames are
+    going to be cached from the start, reads through to the current frame.
+*/
+void QMoviePrivate::catchUpReader()
+{
+    if (!readerBehind)
+        return;
+    readerBehind = false;
+    rewindReader();
+    if (cacheMode == QMovie::CacheAll) {
+        frameMap.clear();
+        greatestFrameNumber = -1;
+        haveReadAll = false;
+        return;
+    }
+    for (int i = 0; i <= currentFrameNumber && reader->canRead(); ++i)
+        reader->read();
+}
+
 /*!
     \internal
 
@@ -332,8 +582,6 @@ int QMoviePrivate::speedAdjustedDelay(int delay) const
 */
 QFrameInfo QMoviePrivate::infoForFrame(int frameNumber)
 {
-    Q_Q(QMovie);
-
     if (frameNumber < 0)
         return QFrameInfo(); // Invalid
 
@@ -344,29 +592,20 @@ QFrameInfo QMoviePrivate::infoForFrame(int frameNumber)
     }
 
     if (cacheMode == QMovie::CacheNone) {
+#if QT_CONFIG(thread)
+        if (residentLoop)
+            return frameMap.value(frameNumber);
+        if (decodeAheadFrames > 0 && !reader->fileName().isEmpty())
+            return decodedFrame(frameNumber);
+#endif
         if (frameNumber != currentFrameNumber+1) {
             // Non-sequential frame access
             if (!reader->jumpToImage(frameNumber)) {
                 if (frameNumber == 0) {
                     // Special case: Attempt to "rewind" so we can loop
-                    // ### This could be implemented as QImageReader::rewind()
                     if (reader->device()->isSequential())
                         return QFrameInfo(); // Invalid
-                    QString fileName = reader->fileName();
-                    QByteArray format = reader->format();
-                    QIODevice *device = reader->device();
-                    QColor bgColor = reader->backgroundColor();
-                    QSize scaledSize = reader->scaledSize();
-                    delete reader;
-                    if (fileName.isEmpty())
-                        reader = new QImageReader(device, format);
-                    else
-                        reader = new QImageReader(absoluteFilePath, format);
-                    if (!reader->canRead()) // Provoke a device->open() call
-                        emit q->error(reader->error());
-                    reader->device()->seek(initialDevicePos);
-                    reader->setBackgroundColor(bgColor);
-                    reader->setScaledSize(scaledSize);
+                    rewindReader();
                 } else {
                     return QFrameInfo(); // Invalid
                 }
@@ -422,6 +661,70 @@ QFrameInfo QMoviePrivate::infoForFrame(int frameNumber)
     return frameMap.value(frameNumber);
 }
 
+#if QT_CONFIG(thread)
+/*!
+    \internal
+
+    Returns the QFrameInfo for \a frameNumber from the decode-ahead thread,
+    starting a new one if none is decoding from that frame on. While playing
+    from the first frame, the frames are also kept in frameMap as long as they
+    fit into the memory limit. If the whole animation fits, later loops are
+    shown from there without decoding.
+*/
+QFrameInfo QMoviePrivate::decodedFrame(int frameNumber)
+{
+    if (!decoder || decoder->nextFrameNumber() != frameNumber) {
+        decoder.reset(new QMovieFrameDecoder(absoluteFilePath, reader->format(),
+                                             reader->scaledSize(), reader->backgroundColor(),
+                                             frameNumber, decodeAheadFrames,
+                                             qint64(decodeAheadLimit) * 1024));
+        decoder->start(QThread::LowPriority);
+        if (collectingFrames)
+            frameMap.clear();
+        residentBytes = 0;
+        // a movie that did not fit the first time never will
+        collectingFrames = frameNumber == 0 && !haveReadAll;
+    }
+
+    QMovieFrameDecoder::Frame frame = decoder->takeFrame();
+    switch (frame.status) {
+    case QMovieFrameDecoder::Frame::Decoded:
+        break;
+    case QMovieFrameDecoder::Frame::End:
+        decoder.reset();
+        haveReadAll = true;
+        if (frameNumber == 0)
+            return QFrameInfo(); // No readable frames
+        if (collectingFrames) {
+            collectingFrames = false;
+            residentLoop = true;
+        }
+        return QFrameInfo::endMarker();
+    case QMovieFrameDecoder::Frame::Error:
+        decoder.reset();
+        decoderError = frame.error;
+        decoderErrorString = frame.errorString;
+        return QFrameInfo(); // Invalid
+    }
+
+    readerBehind = true;
+    if (frameNumber > greatestFrameNumber)
+        greatestFrameNumber = frameNumber;
+    const qint64 bytes = frame.image.sizeInBytes();
+    QFrameInfo info(QPixmap::fromImage(std::move(frame.image)), frame.delay);
+    if (collectingFrames) {
+        residentBytes += bytes;
+        if (residentBytes <= qint64(decodeAheadLimit) * 1024) {
+            frameMap.insert(frameNumber, info);
+        } else {
+            collectingFrames = false;
+            frameMap.clear();
+        }
+    }
+    return info;
+}
+#endif // QT_CONFIG(thread)
+
 /*!
     \internal
 
@@ -511,7 +814,7 @@ void QMoviePrivate::_q_loadNextFrame(bool starting)
     } else {
         // Could not read another frame
         if (!isDone()) {
-            emit q->error(reader->error());
+            emit q->error(readerError());
         }
 
         // Graceful finish
@@ -707,6 +1010,7 @@ QString QMovie::fileName() const
 void QMovie::setFormat(const QByteArray &format)
 {
     Q_D(QMovie);
+    d->discardDecodedFrames();
     d->reader->setFormat(format);
 }
 
@@ -731,6 +1035,7 @@ QByteArray QMovie::format() const
 void QMovie::setBackgroundColor(const QColor &color)
 {
     Q_D(QMovie);
+    d->discardDecodedFrames();
     d->reader->setBackgroundColor(color);
 }
 
@@ -811,7 +1116,7 @@ bool QMovie::isValid() const
 QImageReader::ImageReaderError QMovie::lastError() const
 {
     Q_D(const QMovie);
-    return d->reader->error();
+    return d->readerError();
 }
 
 /*!
@@ -823,6 +1128,8 @@ QImageReader::ImageReaderError QMovie::lastError() const
 QString QMovie::lastErrorString() const
 {
     Q_D(const QMovie);
+    if (d->decoderError != QImageReader::UnknownError)
+        return d->decoderErrorString;
     return d->reader->errorString();
 }
 
@@ -977,6 +1284,9 @@ void QMovie::stop()
     d->enterState(NotRunning);
     d->nextImageTimer.stop();
     d->nextFrameNumber = 0;
+#if QT_CONFIG(thread)
+    d->decoder.reset();
+#endif
 }
 
 /*!
@@ -1002,6 +1312,7 @@ QSize QMovie::scaledSize()
 void QMovie::setScaledSize(const QSize &size)
 {
     Q_D(QMovie);
+    d->discardDecodedFrames();
     d->reader->setScaledSize(size);
 }
 
@@ -1058,9 +1369,91 @@ QMovie::CacheMode QMovie::cacheMode() const
 void QMovie::setCacheMode(CacheMode cacheMode)
 {
     Q_D(QMovie);
+    if (cacheMode != d->cacheMode && d->readerBehind) {
+        d->discardDecodedFrames();
+        d->cacheMode = cacheMode;
+        d->catchUpReader();
+    }
     d->cacheMode = cacheMode;
 }
 
+/*!
+    \since 5.15
+
+    Returns the number of frames QMovie decodes ahead of time.
+
+    \sa setDecodeAheadFrames()
+*/
+int QMovie::decodeAheadFrames() const
+{
+    Q_D(const QMovie);
+    return d->decodeAheadFrames;
+}
+
+/*!
+    \since 5.15
+
+    Makes QMovie decode up to \a count frames ahead of the current one on a
+    worker thread, with a QImageReader of its own. The GUI thread then only
+    converts a frame to a pixmap when it is due, which keeps large animations
+    from blocking it. A \a count of 0, the default, decodes each frame on the
+    GUI thread when it is shown.
+
+    While the first loop plays, the decoded frames are also kept in memory as
+    long as they fit into decodeAheadMemoryLimit(). When the whole animation
+    fits, the following loops are shown without decoding any frame again.
+
+    Decoding ahead only applies to movies read from a file, and when the
+    cacheMode() is \l CacheNone. It is not available in builds without thread
+    support.
+
+    \sa setDecodeAheadMemoryLimit(), setCacheMode()
+*/
+void QMovie::setDecodeAheadFrames(int count)
+{
+    Q_D(QMovie);
+    count = qMax(0, count);
+    if (count == d->decodeAheadFrames)
+        return;
+    d->discardDecodedFrames();
+    d->decodeAheadFrames = count;
+    if (!count)
+        d->catchUpReader();
+}
+
+/*!
+    \since 5.15
+
+    Returns the memory, in kilobytes, the frames decoded ahead may use.
+
+    \sa setDecodeAheadMemoryLimit()
+*/
+int QMovie::decodeAheadMemoryLimit() const
+{
+    Q_D(const QMovie);
+    return d->decodeAheadLimit;
+}
+
+/*!
+    \since 5.15
+
+    Sets the memory the frames decoded ahead may use to \a kilobytes. It bounds
+    both the frames waiting to be shown and the frames kept for the following
+    loops. The queue still holds one frame when a single frame is larger. The
+    default is 32768 kilobytes (32 MB).
+
+    \sa setDecodeAheadFrames()
+*/
+void QMovie::setDecodeAheadMemoryLimit(int kilobytes)
+{
+    Q_D(QMovie);
+    kilobytes = qMax(0, kilobytes);
+    if (kilobytes == d->decodeAheadLimit)
+        return;
+    d->discardDecodedFrames();
+    d->decodeAheadLimit = kilobytes;
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qmovie.cpp"
@@ -122,6 +122,12 @@ public:
     CacheMode cacheMode() const;
     void setCacheMode(CacheMode mode);
 
+    int decodeAheadFrames() const;
+    void setDecodeAheadFrames(int count);
+
+    int decodeAheadMemoryLimit() const;
+    void setDecodeAheadMemoryLimit(int kilobytes);
+
 Q_SIGNALS:
     void started();
     void resized(const QSize &size);
@@ -44,6 +44,10 @@
 #include "qpixmapcache_p.h"
 #include "qthread.h"
 #include "qcoreapplication.h"
+#include <qpa/qplatformintegration.h>
+#include <private/qguiapplication_p.h>
+#include <private/qfreelist_p.h>
+#include <private/qlocking_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -60,8 +64,10 @@ QT_BEGIN_NAMESPACE
     cache.
 
     QPixmapCache contains no member data, only static functions to
-    access the global pixmap cache. It creates an internal QCache
-    object for caching the pixmaps.
+    access the global pixmap cache. Pixmaps which are found in the cache
+    again are kept longer than pixmaps which were used only once, so that
+    inserting many short-lived pixmaps doesn't flush the ones in regular
+    use.
 
     The cache associates a pixmap with a user-provided string as a key,
     or with a QPixmapCache::Key that the cache generates.
@@ -80,13 +86,22 @@ QT_BEGIN_NAMESPACE
     A pixmap takes roughly (\e{width} * \e{height} * \e{depth})/8 bytes of
     memory.
 
+    Pixmaps of different kinds, such as icons and thumbnails, can be kept
+    in separate caches with their own limits: the overloads taking a cache
+    name use a cache of that name, created on first use. statistics()
+    returns the hits, misses and evictions of a cache, to help choosing its
+    limit.
+
     The \e{Qt Quarterly} article
     \l{http://doc.qt.io/archives/qq/qq12-qpixmapcache.html}{Optimizing
     with QPixmapCache} explains how to use QPixmapCache to speed up
     applications by caching the results of painting.
 
-    \note QPixmapCache is only usable from the application's main thread.
-    Access from other threads will be ignored and return failure.
+    \note QPixmapCache is only usable from the application's main thread,
+    unless the platform supports using pixmaps in other threads, as
+    QPixmap does. Otherwise, access from other threads will be ignored and
+    return failure. Since Qt 5.15, every cache has its own lock so that
+    worker threads can, for instance, preload thumbnails.
 
     \sa QCache, QPixmap
 */
@@ -108,9 +123,52 @@ static inline bool qt_pixmapcache_thread_test()
     if (Q_LIKELY(QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread()))
         return true;
 
-    return false;
+    // Other threads may use the cache if they may use pixmaps at all
+    return QCoreApplication::instance() && QGuiApplicationPrivate::platformIntegration()
+        && QGuiApplicationPrivate::platformIntegration()->hasCapability(QPlatformIntegration::ThreadedPixmaps);
 }
 
+// Keys are allocated from one lock-free free list shared by all the caches.
+// Ids start at 1, 0 is the key of no pixmap.
+struct QPixmapCacheKeyFreeListConstants : public QFreeListDefaultConstants
+{
+    enum
+    {
+        InitialNextValue = 1,
+        BlockCount = 6
+    };
+
+    static const int Sizes[BlockCount];
+};
+
+enum {
+    Offset0 = 0x00000000,
+    Offset1 = 0x00000040,
+    Offset2 = 0x00000100,
+    Offset3 = 0x00001000,
+    Offset4 = 0x00010000,
+    Offset5 = 0x00100000,
+
+    Size0 = Offset1  - Offset0,
+    Size1 = Offset2  - Offset1,
+    Size2 = Offset3  - Offset2,
+    Size3 = Offset4  - Offset3,
+    Size4 = Offset5  - Offset4,
+    Size5 = QPixmapCacheKeyFreeListConstants::MaxIndex - Offset5
+};
+
+const int QPixmapCacheKeyFreeListConstants::Sizes[QPixmapCacheKeyFreeListConstants::BlockCount] = {
+    Size0,
+    Size1,
+    Size2,
+    Size3,
+    Size4,
+    Size5
+};
+
+typedef QFreeList<void, QPixmapCacheKeyFreeListConstants> QPixmapCacheKeyFreeList;
+Q_GLOBAL_STATIC(QPixmapCacheKeyFreeList, pm_key_free_list)
+
 /*!
     \class QPixmapCache::Key
     \brief The QPixmapCache::Key class can be used for efficient access
@@ -209,11 +267,21 @@ QPixmapCache::Key &QPixmapCache::Key::operator =(const Key &other)
     return *this;
 }
 
-class QPMCache : public QObject, public QCache<QPixmapCache::Key, QPixmapCacheEntry>
+/*
+  The cache is a segmented LRU: pixmaps start in a probation segment, and
+  move to a protected segment when found again. Pixmaps are evicted from
+  the least recently used end of the probation segment first, so that a
+  burst of pixmaps used only once (scrolling through thumbnails, say)
+  doesn't flush the pixmaps which are used over and over, such as icons.
+
+  All the members are guarded by the mutex, which the QPixmapCache
+  functions lock around every use of a cache.
+*/
+class QPMCache : public QObject
 {
     Q_OBJECT
 public:
-    QPMCache();
+    explicit QPMCache(int maxCost = cache_limit_default);
     ~QPMCache();
 
     void timerEvent(QTimerEvent *) override;
@@ -223,13 +291,18 @@ public:
     bool remove(const QString &key);
     bool remove(const QPixmapCache::Key &key);
 
-    void resizeKeyArray(int size);
     QPixmapCache::Key createKey();
     void releaseKey(const QPixmapCache::Key &key);
     void clear();
 
-    QPixmap *object(const QString &key) const;
-    QPixmap *object(const QPixmapCache::Key &key) const;
+    QPixmap *object(const QString &key);
+    QPixmap *object(const QPixmapCache::Key &key);
+
+    int maxCost() const { return mx; }
+    void setMaxCost(int m) { mx = m; trim(mx); }
+    int totalCost() const { return total; }
+    int size() const { return hash.size(); }
+    QPixmapCache::Statistics statistics() const;
 
     static inline QPixmapCache::KeyData *get(const QPixmapCache::Key &key)
     {return key.d;}
@@ -238,15 +311,49 @@ public:
 
     bool flushDetachedPixmaps(bool nt);
 
+    QMutex mutex;
+
 private:
+    struct Node {
+        Node *prev;
+        Node *next;
+        QPixmapCacheEntry *entry;
+        int cost;
+        bool isProtected;
+    };
+    // least recently used first
+    struct Segment {
+        Node *first = nullptr;
+        Node *last = nullptr;
+        int cost = 0;
+
+        void append(Node *n);
+        void unlink(Node *n);
+    };
+    typedef QHash<QPixmapCache::Key, Node> NodeHash;
+
+    bool insertEntry(const QPixmapCache::Key &key, const QPixmap &pixmap, int cost);
+    bool removeEntry(const QPixmapCache::Key &key);
+    void removeNode(NodeHash::iterator it);
+    void touch(Node *n);
+    void trim(int m);
+    void startFlushTimer();
+
     enum { soon_time = 10000, flush_time = 30000 };
-    int *keyArray;
     int theid;
     int ps;
-    int keyArraySize;
-    int freeKey;
     QHash<QString, QPixmapCache::Key> cacheKeys;
     bool t;
+
+    NodeHash hash;
+    Segment probation;
+    Segment protectedSegment;
+    int mx;
+    int total;
+    qint64 hits;
+    qint64 misses;
+    qint64 insertions;
+    qint64 evictions;
 };
 
 QT_BEGIN_INCLUDE_NAMESPACE
@@ -258,16 +365,143 @@ uint qHash(const QPixmapCache::Key &k)
     return qHash(QPMCache::get(k)->key);
 }
 
-QPMCache::QPMCache()
+QPMCache::QPMCache(int maxCost)
     : QObject(nullptr),
-      QCache<QPixmapCache::Key, QPixmapCacheEntry>(cache_limit_default),
-      keyArray(nullptr), theid(0), ps(0), keyArraySize(0), freeKey(0), t(false)
+      theid(0), ps(0), t(false),
+      mx(maxCost), total(0), hits(0), misses(0), insertions(0), evictions(0)
 {
+    // the flush timer runs in the main thread, even if a worker thread
+    // happened to use the cache first
+    if (QCoreApplication::instance())
+        moveToThread(QCoreApplication::instance()->thread());
 }
 QPMCache::~QPMCache()
 {
     clear();
-    free(keyArray);
+}
+
+void QPMCache::Segment::append(Node *n)
+{
+    n->prev = last;
+    n->next = nullptr;
+    if (last)
+        last->next = n;
+    else
+        first = n;
+    last = n;
+    cost += n->cost;
+}
+
+void QPMCache::Segment::unlink(Node *n)
+{
+    if (n->prev)
+        n->prev->next = n->next;
+    else
+        first = n->next;
+    if (n->next)
+        n->next->prev = n->prev;
+    else
+        last = n->prev;
+    cost -= n->cost;
+}
+
+/*
+  A pixmap found again is protected. The protected segment uses at most
+  3/4 of the cache, its least recently used pixmaps go back to probation.
+*/
+void QPMCache::touch(Node *n)
+{
+    if (n->isProtected) {
+        protectedSegment.unlink(n);
+        protectedSegment.append(n);
+        return;
+    }
+    probation.unlink(n);
+    n->isProtected = true;
+    protectedSegment.append(n);
+    while (protectedSegment.cost > mx / 4 * 3 && protectedSegment.first != n) {
+        Node *demoted = protectedSegment.first;
+        protectedSegment.unlink(demoted);
+        demoted->isProtected = false;
+        probation.append(demoted);
+    }
+}
+
+void QPMCache::removeNode(NodeHash::iterator it)
+{
+    Node &n = it.value();
+    (n.isProtected ? protectedSegment : probation).unlink(&n);
+    total -= n.cost;
+    QPixmapCacheEntry *entry = n.entry;
+    hash.erase(it);
+    releaseKey(entry->key);
+    delete entry;
+}
+
+void QPMCache::trim(int m)
+{
+    while (total > m) {
+        Node *n = probation.first ? probation.first : protectedSegment.first;
+        if (!n)
+            break;
+        removeNode(hash.find(n->entry->key));
+        ++evictions;
+    }
+}
+
+bool QPMCache::insertEntry(const QPixmapCache::Key &key, const QPixmap &pixmap, int cost)
+{
+    if (cost > mx) {
+        releaseKey(key);
+        return false;
+    }
+    trim(mx - cost);
+    Node n;
+    n.entry = new QPixmapCacheEntry(key, pixmap);
+    n.cost = cost;
+    n.isProtected = false;
+    probation.append(&hash.insert(key, n).value());
+    total += cost;
+    ++insertions;
+    return true;
+}
+
+bool QPMCache::removeEntry(const QPixmapCache::Key &key)
+{
+    NodeHash::iterator it = hash.find(key);
+    if (it == hash.end())
+        return false;
+    removeNode(it);
+    return true;
+}
+
+void QPMCache::startFlushTimer()
+{
+    if (theid)
+        return;
+    if (QThread::currentThread() != thread()) {
+        // timers can only be started from the thread of the cache
+        QMetaObject::invokeMethod(this, [this] {
+            const auto locker = qt_scoped_lock(mutex);
+            startFlushTimer();
+        }, Qt::QueuedConnection);
+        return;
+    }
+    theid = startTimer(flush_time);
+    t = false;
+}
+
+QPixmapCache::Statistics QPMCache::statistics() const
+{
+    QPixmapCache::Statistics s;
+    s.hits = hits;
+    s.misses = misses;
+    s.insertions = insertions;
+    s.evictions = evictions;
+    s.count = hash.size();
+    s.cost = total;
+    s.limit = mx;
+    return s;
 }
 
 /*
@@ -294,7 +528,7 @@ bool QPMCache::flushDetachedPixmaps(bool nt)
     bool any = false;
     QHash<QString, QPixmapCache::Key>::iterator it = cacheKeys.begin();
     while (it != cacheKeys.end()) {
-        if (!contains(it.value())) {
+        if (!hash.contains(it.value())) {
             releaseKey(it.value());
             it = cacheKeys.erase(it);
             any = true;
@@ -308,6 +542,7 @@ bool QPMCache::flushDetachedPixmaps(bool nt)
 
 void QPMCache::timerEvent(QTimerEvent *)
 {
+    const auto locker = qt_scoped_lock(mutex);
     bool nt = totalCost() == ps;
     if (!flushDetachedPixmaps(nt)) {
         killTimer(theid);
@@ -320,29 +555,35 @@ void QPMCache::timerEvent(QTimerEvent *)
 }
 
 
-QPixmap *QPMCache::object(const QString &key) const
+QPixmap *QPMCache::object(const QString &key)
 {
     QPixmapCache::Key cacheKey = cacheKeys.value(key);
     if (!cacheKey.d || !cacheKey.d->isValid) {
-        const_cast<QPMCache *>(this)->cacheKeys.remove(key);
+        cacheKeys.remove(key);
+        ++misses;
         return nullptr;
     }
-    QPixmap *ptr = QCache<QPixmapCache::Key, QPixmapCacheEntry>::object(cacheKey);
+    QPixmap *ptr = object(cacheKey);
      //We didn't find the pixmap in the cache, the key is not valid anymore
     if (!ptr) {
-        const_cast<QPMCache *>(this)->cacheKeys.remove(key);
+        cacheKeys.remove(key);
     }
     return ptr;
 }
 
-QPixmap *QPMCache::object(const QPixmapCache::Key &key) const
+QPixmap *QPMCache::object(const QPixmapCache::Key &key)
 {
     Q_ASSERT(key.d->isValid);
-    QPixmap *ptr = QCache<QPixmapCache::Key, QPixmapCacheEntry>::object(key);
+    NodeHash::iterator it = hash.find(key);
     //We didn't find the pixmap in the cache, the key is not valid anymore
-    if (!ptr)
-        const_cast<QPMCache *>(this)->releaseKey(key);
-    return ptr;
+    if (it == hash.end()) {
+        releaseKey(key);
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    touch(&it.value());
+    return it.value().entry;
 }
 
 bool QPMCache::insert(const QString& key, const QPixmap &pixmap, int cost)
@@ -350,17 +591,14 @@ bool QPMCache::insert(const QString& key, const QPixmap &pixmap, int cost)
     QPixmapCache::Key &cacheKey = cacheKeys[key];
     //If for the same key we add already a pixmap we should delete it
     if (cacheKey.d)
-        QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(cacheKey);
+        removeEntry(cacheKey);
 
     //we create a new key the old one has been removed
     cacheKey = createKey();
 
-    bool success = QCache<QPixmapCache::Key, QPixmapCacheEntry>::insert(cacheKey, new QPixmapCacheEntry(cacheKey, pixmap), cost);
+    bool success = insertEntry(cacheKey, pixmap, cost);
     if (success) {
-        if (!theid) {
-            theid = startTimer(flush_time);
-            t = false;
-        }
+        startFlushTimer();
     } else {
         //Insertion failed we released the new allocated key
         cacheKeys.remove(key);
@@ -371,13 +609,9 @@ bool QPMCache::insert(const QString& key, const QPixmap &pixmap, int cost)
 QPixmapCache::Key QPMCache::insert(const QPixmap &pixmap, int cost)
 {
     QPixmapCache::Key cacheKey = createKey();
-    bool success = QCache<QPixmapCache::Key, QPixmapCacheEntry>::insert(cacheKey, new QPixmapCacheEntry(cacheKey, pixmap), cost);
-    if (success) {
-        if (!theid) {
-            theid = startTimer(flush_time);
-            t = false;
-        }
-    }
+    bool success = insertEntry(cacheKey, pixmap, cost);
+    if (success)
+        startFlushTimer();
     return cacheKey;
 }
 
@@ -385,16 +619,13 @@ bool QPMCache::replace(const QPixmapCache::Key &key, const QPixmap &pixmap, int
 {
     Q_ASSERT(key.d->isValid);
     //If for the same key we had already an entry so we should delete the pixmap and use the new one
-    QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(key);
+    removeEntry(key);
 
     QPixmapCache::Key cacheKey = createKey();
 
-    bool success = QCache<QPixmapCache::Key, QPixmapCacheEntry>::insert(cacheKey, new QPixmapCacheEntry(cacheKey, pixmap), cost);
+    bool success = insertEntry(cacheKey, pixmap, cost);
     if (success) {
-        if(!theid) {
-            theid = startTimer(flush_time);
-            t = false;
-        }
+        startFlushTimer();
         const_cast<QPixmapCache::Key&>(key) = cacheKey;
     }
     return success;
@@ -406,61 +637,47 @@ bool QPMCache::remove(const QString &key)
     //The key was not in the cache
     if (cacheKey == cacheKeys.constEnd())
         return false;
-    const bool result = QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(cacheKey.value());
+    const bool result = removeEntry(cacheKey.value());
     cacheKeys.erase(cacheKey);
     return result;
 }
 
 bool QPMCache::remove(const QPixmapCache::Key &key)
 {
-    return QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(key);
-}
-
-void QPMCache::resizeKeyArray(int size)
-{
-    if (size <= keyArraySize || size == 0)
-        return;
-    keyArray = q_check_ptr(reinterpret_cast<int *>(realloc(keyArray,
-                    size * sizeof(int))));
-    for (int i = keyArraySize; i != size; ++i)
-        keyArray[i] = i + 1;
-    keyArraySize = size;
+    return removeEntry(key);
 }
 
 QPixmapCache::Key QPMCache::createKey()
 {
-    if (freeKey == keyArraySize)
-        resizeKeyArray(keyArraySize ? keyArraySize << 1 : 2);
-    int id = freeKey;
-    freeKey = keyArray[id];
     QPixmapCache::Key key;
     QPixmapCache::KeyData *d = QPMCache::getKeyData(&key);
-    d->key = ++id;
+    d->key = pm_key_free_list()->next();
     return key;
 }
 
 void QPMCache::releaseKey(const QPixmapCache::Key &key)
 {
-    if (key.d->key > keyArraySize || key.d->key <= 0)
+    if (key.d->key <= 0)
         return;
-    key.d->key--;
-    keyArray[key.d->key] = freeKey;
-    freeKey = key.d->key;
+    // this function may be called by a global destructor after
+    // pm_key_free_list() has been destructed
+    if (QPixmapCacheKeyFreeList *freeList = pm_key_free_list())
+        freeList->release(key.d->key);
     key.d->isValid = false;
     key.d->key = 0;
 }
 
 void QPMCache::clear()
 {
-    free(keyArray);
-    keyArray = nullptr;
-    freeKey = 0;
-    keyArraySize = 0;
-    //Mark all keys as invalid
-    QList<QPixmapCache::Key> keys = QCache<QPixmapCache::Key, QPixmapCacheEntry>::keys();
-    for (int i = 0; i < keys.size(); ++i)
-        keys.at(i).d->isValid = false;
-    QCache<QPixmapCache::Key, QPixmapCacheEntry>::clear();
+    //Release all keys, which marks them as invalid
+    for (NodeHash::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        releaseKey(it.key());
+        delete it.value().entry;
+    }
+    hash.clear();
+    probation = Segment();
+    protectedSegment = Segment();
+    total = 0;
 }
 
 QPixmapCache::KeyData* QPMCache::getKeyData(QPixmapCache::Key *key)
@@ -472,14 +689,34 @@ QPixmapCache::KeyData* QPMCache::getKeyData(QPixmapCache::Key *key)
 
 Q_GLOBAL_STATIC(QPMCache, pm_cache)
 
-int Q_AUTOTEST_EXPORT q_QPixmapCache_keyHashSize()
+struct QPMNamedCaches
 {
-    return pm_cache()->size();
+    ~QPMNamedCaches() { qDeleteAll(caches); }
+    QMutex mutex;
+    QHash<QString, QPMCache *> caches;
+};
+
+Q_GLOBAL_STATIC(QPMNamedCaches, pm_named_caches)
+
+// the cache of an empty name is the application-wide one
+static QPMCache *pm_named_cache(const QString &cacheName, bool create = true)
+{
+    if (cacheName.isEmpty())
+        return pm_cache();
+    QPMNamedCaches *named = pm_named_caches();
+    const auto locker = qt_scoped_lock(named->mutex);
+    QPMCache *cache = named->caches.value(cacheName);
+    if (!cache && create) {
+        cache = new QPMCache;
+        named->caches.insert(cacheName, cache);
+    }
+    return cache;
 }
 
-QPixmapCacheEntry::~QPixmapCacheEntry()
+int Q_AUTOTEST_EXPORT q_QPixmapCache_keyHashSize()
 {
-    pm_cache()->releaseKey(key);
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
+    return pm_cache()->size();
 }
 
 #if QT_DEPRECATED_SINCE(5, 13)
@@ -503,8 +740,10 @@ QPixmapCacheEntry::~QPixmapCacheEntry()
 
 QPixmap *QPixmapCache::find(const QString &key)
 {
-    if (!qt_pixmapcache_thread_test())
+    // the returned pointer is only safe to use in the main thread
+    if (!qt_pixmapcache_thread_test() || QThread::currentThread() != qApp->thread())
         return nullptr;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     return pm_cache()->object(key);
 }
 
@@ -536,6 +775,7 @@ bool QPixmapCache::find(const QString &key, QPixmap *pixmap)
 {
     if (!qt_pixmapcache_thread_test())
         return false;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     QPixmap *ptr = pm_cache()->object(key);
     if (ptr && pixmap)
         *pixmap = *ptr;
@@ -555,6 +795,7 @@ bool QPixmapCache::find(const Key &key, QPixmap *pixmap)
 {
     if (!qt_pixmapcache_thread_test())
         return false;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     //The key is not valid anymore, a flush happened before probably
     if (!key.d || !key.d->isValid)
         return false;
@@ -576,7 +817,8 @@ bool QPixmapCache::find(const Key &key, QPixmap *pixmap)
     pixmap to be inserted.
 
     The oldest pixmaps (least recently accessed in the cache) are
-    deleted when more space is needed.
+    deleted when more space is needed, starting with the pixmaps which
+    were never found in the cache since they were inserted.
 
     The function returns \c true if the object was inserted into the
     cache; otherwise it returns \c false.
@@ -588,6 +830,7 @@ bool QPixmapCache::insert(const QString &key, const QPixmap &pixmap)
 {
     if (!qt_pixmapcache_thread_test())
         return false;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     return pm_cache()->insert(key, pixmap, cost(pixmap));
 }
 
@@ -600,7 +843,8 @@ bool QPixmapCache::insert(const QString &key, const QPixmap &pixmap)
     pixmap to be inserted.
 
     The oldest pixmaps (least recently accessed in the cache) are
-    deleted when more space is needed.
+    deleted when more space is needed, starting with the pixmaps which
+    were never found in the cache since they were inserted.
 
     \sa setCacheLimit(), replace()
 
@@ -610,6 +854,7 @@ QPixmapCache::Key QPixmapCache::insert(const QPixmap &pixmap)
 {
     if (!qt_pixmapcache_thread_test())
         return QPixmapCache::Key();
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     return pm_cache()->insert(pixmap, cost(pixmap));
 }
 
@@ -626,6 +871,7 @@ bool QPixmapCache::replace(const Key &key, const QPixmap &pixmap)
 {
     if (!qt_pixmapcache_thread_test())
         return false;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     //The key is not valid anymore, a flush happened before probably
     if (!key.d || !key.d->isValid)
         return false;
@@ -642,6 +888,7 @@ bool QPixmapCache::replace(const Key &key, const QPixmap &pixmap)
 
 int QPixmapCache::cacheLimit()
 {
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     return pm_cache()->maxCost();
 }
 
@@ -657,6 +904,7 @@ void QPixmapCache::setCacheLimit(int n)
 {
     if (!qt_pixmapcache_thread_test())
         return;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     pm_cache()->setMaxCost(n);
 }
 
@@ -667,6 +915,7 @@ void QPixmapCache::remove(const QString &key)
 {
     if (!qt_pixmapcache_thread_test())
         return;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     pm_cache()->remove(key);
 }
 
@@ -680,6 +929,7 @@ void QPixmapCache::remove(const Key &key)
 {
     if (!qt_pixmapcache_thread_test())
         return;
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     //The key is not valid anymore, a flush happened before probably
     if (!key.d || !key.d->isValid)
         return;
@@ -687,7 +937,8 @@ void QPixmapCache::remove(const Key &key)
 }
 
 /*!
-    Removes all pixmaps from the cache.
+    Removes all pixmaps from the cache, and from the caches created with
+    a name.
 */
 
 void QPixmapCache::clear()
@@ -695,21 +946,183 @@ void QPixmapCache::clear()
     if (!QCoreApplication::closingDown() && !qt_pixmapcache_thread_test())
         return;
     QT_TRY {
-        if (pm_cache.exists())
+        if (pm_cache.exists()) {
+            const auto locker = qt_scoped_lock(pm_cache->mutex);
             pm_cache->clear();
+        }
+        if (pm_named_caches.exists()) {
+            const auto namedLocker = qt_scoped_lock(pm_named_caches->mutex);
+            for (QPMCache *cache : qAsConst(pm_named_caches->caches)) {
+                const auto locker = qt_scoped_lock(cache->mutex);
+                cache->clear();
+            }
+        }
     } QT_CATCH(const std::bad_alloc &) {
         // if we ran out of memory during pm_cache(), it's no leak,
         // so just ignore it.
     }
 }
 
+/*!
+    \class QPixmapCache::Statistics
+    \inmodule QtGui
+    \since 5.15
+
+    \brief The QPixmapCache::Statistics class describes the use of a pixmap
+    cache.
+
+    The counters cover the lifetime of the cache: \c hits and \c misses
+    count the lookups which found a pixmap or not, \c insertions the
+    pixmaps inserted and \c evictions the pixmaps removed to make room for
+    others or by the periodic flushing of the cache. \c count is the number
+    of pixmaps in the cache, \c cost their total cost and \c limit the
+    cache limit, both in kilobytes.
+
+    \sa statistics()
+*/
+
+/*!
+    \since 5.15
+
+    Returns the statistics of the application-wide cache.
+*/
+QPixmapCache::Statistics QPixmapCache::statistics()
+{
+    if (!qt_pixmapcache_thread_test())
+        return Statistics();
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
+    return pm_cache()->statistics();
+}
+
+/*!
+    \since 5.15
+
+    Returns the cache limit (in kilobytes) of the cache named \a cacheName.
+
+    Caches with different names are independent: each one has its own
+    limit and evicts its own pixmaps. A named cache is created on first
+    use, with the default limit of 10240 KB. An empty \a cacheName is the
+    application-wide cache.
+
+    \sa setCacheLimit()
+*/
+int QPixmapCache::cacheLimit(const QString &cacheName)
+{
+    if (!qt_pixmapcache_thread_test())
+        return 0;
+    QPMCache *cache = pm_named_cache(cacheName);
+    const auto locker = qt_scoped_lock(cache->mutex);
+    return cache->maxCost();
+}
+
+/*!
+    \since 5.15
+
+    Sets the cache limit of the cache named \a cacheName to \a n kilobytes.
+
+    \sa cacheLimit()
+*/
+void QPixmapCache::setCacheLimit(const QString &cacheName, int n)
+{
+    if (!qt_pixmapcache_thread_test())
+        return;
+    QPMCache *cache = pm_named_cache(cacheName);
+    const auto locker = qt_scoped_lock(cache->mutex);
+    cache->setMaxCost(n);
+}
+
+/*!
+    \since 5.15
+
+    Looks for a pixmap associated with the given \a key in the cache named
+    \a cacheName. If the pixmap is found, the function sets \a pixmap to
+    that pixmap and returns \c true; otherwise it leaves \a pixmap alone and
+    returns \c false.
+*/
+bool QPixmapCache::find(const QString &cacheName, const QString &key, QPixmap *pixmap)
+{
+    if (!qt_pixmapcache_thread_test())
+        return false;
+    QPMCache *cache = pm_named_cache(cacheName);
+    const auto locker = qt_scoped_lock(cache->mutex);
+    QPixmap *ptr = cache->object(key);
+    if (ptr && pixmap)
+        *pixmap = *ptr;
+    return ptr != nullptr;
+}
+
+/*!
+    \since 5.15
+
+    Inserts a copy of the pixmap \a pixmap associated with the \a key into
+    the cache named \a cacheName. Returns \c true if the pixmap was
+    inserted; otherwise returns \c false.
+*/
+bool QPixmapCache::insert(const QString &cacheName, const QString &key, const QPixmap &pixmap)
+{
+    if (!qt_pixmapcache_thread_test())
+        return false;
+    QPMCache *cache = pm_named_cache(cacheName);
+    const auto locker = qt_scoped_lock(cache->mutex);
+    return cache->insert(key, pixmap, cost(pixmap));
+}
+
+/*!
+    \since 5.15
+
+    Removes the pixmap associated with \a key from the cache named
+    \a cacheName.
+*/
+void QPixmapCache::remove(const QString &cacheName, const QString &key)
+{
+    if (!qt_pixmapcache_thread_test())
+        return;
+    if (QPMCache *cache = pm_named_cache(cacheName, false)) {
+        const auto locker = qt_scoped_lock(cache->mutex);
+        cache->remove(key);
+    }
+}
+
+/*!
+    \since 5.15
+
+    Removes all pixmaps from the cache named \a cacheName.
+*/
+void QPixmapCache::clear(const QString &cacheName)
+{
+    if (!qt_pixmapcache_thread_test())
+        return;
+    if (QPMCache *cache = pm_named_cache(cacheName, false)) {
+        const auto locker = qt_scoped_lock(cache->mutex);
+        cache->clear();
+    }
+}
+
+/*!
+    \since 5.15
+
+    Returns the statistics of the cache named \a cacheName.
+*/
+QPixmapCache::Statistics QPixmapCache::statistics(const QString &cacheName)
+{
+    if (!qt_pixmapcache_thread_test())
+        return Statistics();
+    if (QPMCache *cache = pm_named_cache(cacheName, false)) {
+        const auto locker = qt_scoped_lock(cache->mutex);
+        return cache->statistics();
+    }
+    return Statistics();
+}
+
 void QPixmapCache::flushDetachedPixmaps()
 {
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     pm_cache()->flushDetachedPixmaps(true);
 }
 
 int QPixmapCache::totalUsed()
 {
+    const auto locker = qt_scoped_lock(pm_cache()->mutex);
     return (pm_cache()->totalCost()+1023) / 1024;
 }
 
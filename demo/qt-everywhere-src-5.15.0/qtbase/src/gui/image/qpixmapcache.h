@@ -72,6 +72,17 @@ public:
         friend class QPixmapCache;
     };
 
+    struct Statistics
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 insertions = 0;
+        qint64 evictions = 0;
+        int count = 0;
+        int cost = 0;
+        int limit = 0;
+    };
+
     static int cacheLimit();
     static void setCacheLimit(int);
 #if QT_DEPRECATED_SINCE(5, 13)
@@ -88,6 +99,15 @@ public:
     static void remove(const QString &key);
     static void remove(const Key &key);
     static void clear();
+    static Statistics statistics();
+
+    static int cacheLimit(const QString &cacheName);
+    static void setCacheLimit(const QString &cacheName, int n);
+    static bool find(const QString &cacheName, const QString &key, QPixmap *pixmap);
+    static bool insert(const QString &cacheName, const QString &key, const QPixmap &pixmap);
+    static void remove(const QString &cacheName, const QString &key);
+    static void clear(const QString &cacheName);
+    static Statistics statistics(const QString &cacheName);
 
 #ifdef Q_TEST_QPIXMAPCACHE
     static void flushDetachedPixmaps();
@@ -71,7 +71,7 @@ public:
 
     bool isValid;
     int key;
-    int ref;
+    QAtomicInt ref;
 };
 
 // XXX: hw: is this a general concept we need to abstract?
@@ -91,7 +91,6 @@ public:
             }
         }
     }
-    ~QPixmapCacheEntry();
     QPixmapCache::Key key;
 };
 
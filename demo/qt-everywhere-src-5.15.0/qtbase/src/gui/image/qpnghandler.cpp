@@ -238,6 +238,22 @@ void qpiw_flush_fn(png_structp /* png_ptr */)
 
 }
 
+// The number of input pixels in [0, isz) that fall into output pixel o when scaling to osz.
+static inline quint32 scaledBinSize(quint32 o, quint32 isz, quint32 osz)
+{
+    const auto binStart = [=](quint32 bin) { return quint32((quint64(bin) * isz + osz - 1) / osz); };
+    return binStart(o + 1) - binStart(o);
+}
+
+// Interlaced images are downscaled by summing every pixel into its output pixel,
+// which works as long as one output pixel's sums fit in 32 bits.
+static bool canScalePassesInline(quint32 width, quint32 height, QSize scaledSize)
+{
+    const quint64 binArea = quint64(scaledBinSize(0, width, scaledSize.width()) + 1)
+                          * (scaledBinSize(0, height, scaledSize.height()) + 1);
+    return binArea * 255 <= 0xffffffffU;
+}
+
 static
 void setup_qt(QImage& image, png_structp png_ptr, png_infop info_ptr, QSize scaledSize, bool *doScaledRead)
 {
@@ -252,9 +268,9 @@ void setup_qt(QImage& image, png_structp png_ptr, png_infop info_ptr, QSize scal
     int num_palette;
     int interlace_method = PNG_INTERLACE_LAST;
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, &interlace_method, nullptr, nullptr);
-    png_set_interlace_handling(png_ptr);
 
     if (color_type == PNG_COLOR_TYPE_GRAY) {
+        png_set_interlace_handling(png_ptr);
         // Black & White or grayscale
         if (bit_depth == 1 && png_get_channels(png_ptr, info_ptr) == 1) {
             png_set_invert_mono(png_ptr);
@@ -339,6 +355,7 @@ void setup_qt(QImage& image, png_structp png_ptr, png_infop info_ptr, QSize scal
                && png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette)
                && num_palette <= 256)
     {
+        png_set_interlace_handling(png_ptr);
         // 1-bit and 8-bit color
         if (bit_depth != 1)
             png_set_packing(png_ptr);
@@ -380,6 +397,7 @@ void setup_qt(QImage& image, png_structp png_ptr, png_infop info_ptr, QSize scal
             png_set_bgr(png_ptr);
         }
     } else if (bit_depth == 16 && !(color_type & PNG_COLOR_MASK_PALETTE)) {
+        png_set_interlace_handling(png_ptr);
         QImage::Format format = QImage::Format_RGBA64;
         if (!(color_type & PNG_COLOR_MASK_ALPHA) && !png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
             png_set_filler(png_ptr, 0xffff, PNG_FILLER_AFTER);
@@ -416,11 +434,16 @@ void setup_qt(QImage& image, png_structp png_ptr, png_infop info_ptr, QSize scal
         }
         QSize outSize(width,height);
         if (!scaledSize.isEmpty() && quint32(scaledSize.width()) <= width &&
-            quint32(scaledSize.height()) <= height && scaledSize != outSize && interlace_method == PNG_INTERLACE_NONE) {
+            quint32(scaledSize.height()) <= height && scaledSize != outSize &&
+            (interlace_method == PNG_INTERLACE_NONE || canScalePassesInline(width, height, scaledSize))) {
             // Do inline downscaling
             outSize = scaledSize;
             if (doScaledRead)
                 *doScaledRead = true;
+        } else {
+            // Inline downscaling reads the reduced images of the interlace passes
+            // as they come, so only let libpng combine the passes for full size reads.
+            png_set_interlace_handling(png_ptr);
         }
         if (image.size() != outSize || image.format() != format) {
             image = QImage(outSize, format);
@@ -440,6 +463,49 @@ void setup_qt(QImage& image, png_structp png_ptr, png_infop info_ptr, QSize scal
     }
 }
 
+// Downscales an interlaced image from the reduced images of its Adam7 passes without
+// holding it at full size: every input pixel is summed into the output pixel it
+// falls in, and the sums are averaged once all passes have been read.
+static void read_passes_scaled(uchar *data, int bpl, png_structp png_ptr,
+                               QPngHandlerPrivate::AllocatedMemoryPointers &amp,
+                               quint32 ixsz, quint32 iysz, quint32 oxsz, quint32 oysz)
+{
+    const quint32 obw = 4*oxsz;
+    amp.accRow = new quint32[obw*oysz];
+    memset(amp.accRow, 0, obw*oysz*sizeof(quint32));
+    amp.inRow = new png_byte[4*ixsz];
+    memset(amp.inRow, 0, 4*ixsz*sizeof(png_byte));
+
+    for (int pass = 0; pass < 7; pass++) {
+        const quint32 rows = PNG_PASS_ROWS(iysz, pass);
+        const quint32 cols = PNG_PASS_COLS(ixsz, pass);
+        if (!rows || !cols)
+            continue;           // libpng skips empty passes
+        for (quint32 r=0; r < rows; r++) {
+            png_read_row(png_ptr, amp.inRow, nullptr);
+            const quint32 oy = quint32(quint64(PNG_ROW_FROM_PASS_ROW(r, pass)) * oysz / iysz);
+            quint32 *acc = amp.accRow + oy*obw;
+            const png_byte *in = amp.inRow;
+            for (quint32 c=0; c < cols; c++, in += 4) {
+                const quint32 ox = quint32(quint64(PNG_COL_FROM_PASS_COL(c, pass)) * oxsz / ixsz);
+                for (quint32 i=0; i < 4; i++)
+                    acc[4*ox+i] += in[i];
+            }
+        }
+    }
+
+    for (quint32 oy=0; oy<oysz; oy++) {
+        const quint32 ny = scaledBinSize(oy, iysz, oysz);
+        const quint32 *acc = amp.accRow + oy*obw;
+        for (quint32 ox=0; ox<oxsz; ox++) {
+            const quint32 n = ny * scaledBinSize(ox, ixsz, oxsz);
+            for (quint32 i=0; i < 4; i++)
+                data[(4*ox)+i] = uchar((acc[4*ox+i] + n/2) / n);
+        }
+        data += bpl;
+    }
+}
+
 static void read_image_scaled(QImage *outImage, png_structp png_ptr, png_infop info_ptr,
                               QPngHandlerPrivate::AllocatedMemoryPointers &amp, QSize scaledSize)
 {
@@ -451,8 +517,9 @@ static void read_image_scaled(QImage *outImage, png_structp png_ptr, png_infop i
 
     int bit_depth = 0;
     int color_type = 0;
+    int interlace_method = PNG_INTERLACE_NONE;
     int unit_type = PNG_OFFSET_PIXEL;
-    png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
+    png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, &interlace_method, nullptr, nullptr);
     png_get_oFFs(png_ptr, info_ptr, &offset_x, &offset_y, &unit_type);
     uchar *data = outImage->bits();
     int bpl = outImage->bytesPerLine();
@@ -464,50 +531,54 @@ static void read_image_scaled(QImage *outImage, png_structp png_ptr, png_infop i
     const quint32 ixsz = width;
     const quint32 oysz = scaledSize.height();
     const quint32 oxsz = scaledSize.width();
-    const quint32 ibw = 4*width;
-    amp.accRow = new quint32[ibw];
-    memset(amp.accRow, 0, ibw*sizeof(quint32));
-    amp.inRow = new png_byte[ibw];
-    memset(amp.inRow, 0, ibw*sizeof(png_byte));
-    amp.outRow = new uchar[ibw];
-    memset(amp.outRow, 0, ibw*sizeof(uchar));
-    qint32 rval = 0;
-    for (quint32 oy=0; oy<oysz; oy++) {
-        // Store the rest of the previous input row, if any
-        for (quint32 i=0; i < ibw; i++)
-            amp.accRow[i] = rval*amp.inRow[i];
-        // Accumulate the next input rows
-        for (rval = iysz-rval; rval > 0; rval-=oysz) {
-            png_read_row(png_ptr, amp.inRow, nullptr);
-            quint32 fact = qMin(oysz, quint32(rval));
+    if (interlace_method != PNG_INTERLACE_NONE) {
+        read_passes_scaled(data, bpl, png_ptr, amp, ixsz, iysz, oxsz, oysz);
+    } else {
+        const quint32 ibw = 4*width;
+        amp.accRow = new quint32[ibw];
+        memset(amp.accRow, 0, ibw*sizeof(quint32));
+        amp.inRow = new png_byte[ibw];
+        memset(amp.inRow, 0, ibw*sizeof(png_byte));
+        amp.outRow = new uchar[ibw];
+        memset(amp.outRow, 0, ibw*sizeof(uchar));
+        qint32 rval = 0;
+        for (quint32 oy=0; oy<oysz; oy++) {
+            // Store the rest of the previous input row, if any
             for (quint32 i=0; i < ibw; i++)
-                amp.accRow[i] += fact*amp.inRow[i];
-        }
-        rval *= -1;
+                amp.accRow[i] = rval*amp.inRow[i];
+            // Accumulate the next input rows
+            for (rval = iysz-rval; rval > 0; rval-=oysz) {
+                png_read_row(png_ptr, amp.inRow, nullptr);
+                quint32 fact = qMin(oysz, quint32(rval));
+                for (quint32 i=0; i < ibw; i++)
+                    amp.accRow[i] += fact*amp.inRow[i];
+            }
+            rval *= -1;
 
-        // We have a full output row, store it
-        for (quint32 i=0; i < ibw; i++)
-            amp.outRow[i] = uchar(amp.accRow[i]/iysz);
+            // We have a full output row, store it
+            for (quint32 i=0; i < ibw; i++)
+                amp.outRow[i] = uchar(amp.accRow[i]/iysz);
 
-        quint32 a[4] = {0, 0, 0, 0};
-        qint32 cval = oxsz;
-        quint32 ix = 0;
-        for (quint32 ox=0; ox<oxsz; ox++) {
-            for (quint32 i=0; i < 4; i++)
-                a[i] = cval * amp.outRow[ix+i];
-            for (cval = ixsz - cval; cval > 0; cval-=oxsz) {
-                ix += 4;
-                if (ix >= ibw)
-                    break;            // Safety belt, should not happen
-                quint32 fact = qMin(oxsz, quint32(cval));
+            quint32 a[4] = {0, 0, 0, 0};
+            qint32 cval = oxsz;
+            quint32 ix = 0;
+            for (quint32 ox=0; ox<oxsz; ox++) {
                 for (quint32 i=0; i < 4; i++)
-                    a[i] += fact * amp.outRow[ix+i];
+                    a[i] = cval * amp.outRow[ix+i];
+                for (cval = ixsz - cval; cval > 0; cval-=oxsz) {
+                    ix += 4;
+                    if (ix >= ibw)
+                        break;            // Safety belt, should not happen
+                    quint32 fact = qMin(oxsz, quint32(cval));
+                    for (quint32 i=0; i < 4; i++)
+                        a[i] += fact * amp.outRow[ix+i];
+                }
+                cval *= -1;
+                for (quint32 i=0; i < 4; i++)
+                    data[(4*ox)+i] = uchar(a[i]/ixsz);
             }
-            cval *= -1;
-            for (quint32 i=0; i < 4; i++)
-                data[(4*ox)+i] = uchar(a[i]/ixsz);
+            data += bpl;
         }
-        data += bpl;
     }
     amp.deallocate();
 
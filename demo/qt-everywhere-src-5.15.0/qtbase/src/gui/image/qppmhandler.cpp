@@ -41,6 +41,7 @@
 
 #ifndef QT_NO_IMAGEFORMAT_PPM
 
+#include <qfiledevice.h>
 #include <qimage.h>
 #include <qvariant.h>
 #include <qvector.h>
@@ -132,6 +133,37 @@ static inline QRgb scale_pbm_color(quint16 mx, quint16 rv, quint16 gv, quint16 b
     return QRgba64::fromRgba64((rv * 0xffffu) / mx, (gv * 0xffffu) / mx, (bv * 0xffffu) / mx, 0xffff).toArgb32();
 }
 
+// Raw 8-bit PPM data is laid out as Format_RGB888. When it sits in a file,
+// map the pixel data and convert it in one pass with the (SIMD) image
+// converters instead of reading and converting it row by row.
+static bool read_pbm_mapped(QIODevice *device, int w, int h, QImage *outImage)
+{
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if (!file || file->isSequential())
+        return false;
+
+    const qint64 bpl = qint64(w) * 3;
+    const qint64 pos = file->pos();
+    const qint64 size = bpl * h;
+    if (bpl > INT_MAX || pos + size > file->size()) // truncated file: use the slow path
+        return false;
+
+    uchar *data = file->map(pos, size);
+    if (!data)
+        return false;
+    QImage image;
+    {
+        const QImage mapped(data, w, h, int(bpl), QImage::Format_RGB888);
+        image = mapped.convertToFormat(QImage::Format_RGB32);
+    }
+    file->unmap(data);
+    if (image.isNull())
+        return false;
+
+    *outImage = image;
+    return file->seek(pos + size);
+}
+
 static bool read_pbm_body(QIODevice *device, char type, int w, int h, int mcc, QImage *outImage)
 {
     int nbits, y;
@@ -160,6 +192,9 @@ static bool read_pbm_body(QIODevice *device, char type, int w, int h, int mcc, Q
     }
     raw = type >= '4';
 
+    if (type == '6' && mcc == 255 && read_pbm_mapped(device, w, h, outImage))
+        return true;
+
     if (outImage->size() != QSize(w, h) || outImage->format() != format) {
         *outImage = QImage(w, h, format);
         if (outImage->isNull())
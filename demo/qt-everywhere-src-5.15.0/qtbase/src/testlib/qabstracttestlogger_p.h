@@ -52,6 +52,7 @@
 //
 
 #include <qglobal.h>
+#include <QtCore/qcontainerfwd.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -99,6 +100,8 @@ public:
     virtual void addIncident(IncidentTypes type, const char *description,
                              const char *file = nullptr, int line = 0) = 0;
     virtual void addBenchmarkResult(const QBenchmarkResult &result) = 0;
+    // every sample of a benchmark, reported before its median
+    virtual void addBenchmarkSamples(const QVector<QBenchmarkResult> &) {}
 
     virtual void addMessage(QtMsgType, const QMessageLogContext &,
                             const QString &);
@@ -46,6 +46,10 @@
 #include <QtCore/qset.h>
 #include <QtCore/qdebug.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 QBenchmarkGlobalData *QBenchmarkGlobalData::current;
@@ -101,6 +105,69 @@ int QBenchmarkGlobalData::adjustMedianIterationCount()
         ? medianIterationCount : measurer->adjustMedianCount(1);
 }
 
+static qreal quantile(const std::vector<qreal> &sorted, qreal q)
+{
+    const qreal pos = q * (sorted.size() - 1);
+    const size_t low = size_t(pos);
+    if (low + 1 >= sorted.size())
+        return sorted.back();
+    return sorted[low] + (pos - low) * (sorted[low + 1] - sorted[low]);
+}
+
+QBenchmarkStatistics QBenchmarkStatistics::compute(const QVector<QBenchmarkResult> &samples)
+{
+    QBenchmarkStatistics stats;
+    std::vector<qreal> values;
+    values.reserve(samples.size());
+    for (const QBenchmarkResult &sample : samples) {
+        if (sample.iterations > 0)
+            values.push_back(sample.value / sample.iterations);
+    }
+    if (values.empty())
+        return stats;
+    std::sort(values.begin(), values.end());
+
+    const int n = int(values.size());
+    stats.count = n;
+    stats.minimum = values.front();
+    stats.maximum = values.back();
+    stats.median = quantile(values, 0.5);
+
+    qreal sum = 0;
+    for (qreal v : values)
+        sum += v;
+    stats.mean = sum / n;
+    stats.confidenceLow = stats.confidenceHigh = stats.mean;
+    if (n < 2)
+        return stats;
+
+    qreal squares = 0;
+    for (qreal v : values)
+        squares += (v - stats.mean) * (v - stats.mean);
+    stats.standardDeviation = std::sqrt(squares / (n - 1));
+
+    // two-sided 95% quantiles of Student's t distribution, by degrees of freedom
+    static const qreal t95[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    const int degrees = n - 1;
+    const qreal t = degrees <= int(sizeof(t95) / sizeof(t95[0])) ? t95[degrees - 1] : 1.96;
+    const qreal margin = t * stats.standardDeviation / std::sqrt(qreal(n));
+    stats.confidenceLow = stats.mean - margin;
+    stats.confidenceHigh = stats.mean + margin;
+
+    const qreal q1 = quantile(values, 0.25);
+    const qreal q3 = quantile(values, 0.75);
+    const qreal fence = 1.5 * (q3 - q1);
+    for (qreal v : values) {
+        if (v < q1 - fence || v > q3 + fence)
+            ++stats.outliers;
+    }
+    return stats;
+}
+
 
 QBenchmarkTestMethodData *QBenchmarkTestMethodData::current;
 
@@ -162,6 +229,8 @@ void QBenchmarkTestMethodData::setResult(
 
     this->result = QBenchmarkResult(
         QBenchmarkGlobalData::current->context, value, iterationCount, metric, setByMacro);
+    if (setByMacro)
+        this->result.counters = QBenchmarkGlobalData::current->measurer->extraCounters();
 }
 
 /*!
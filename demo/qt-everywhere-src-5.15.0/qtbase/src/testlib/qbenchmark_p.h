@@ -63,6 +63,7 @@
 
 #include <QtTest/private/qbenchmarkmeasurement_p.h>
 #include <QtCore/QMap>
+#include <QtCore/QVector>
 #include <QtTest/qttestglobal.h>
 #if QT_CONFIG(valgrind)
 #include <QtTest/private/qbenchmarkvalgrind_p.h>
@@ -102,6 +103,7 @@ public:
     QTest::QBenchmarkMetric metric = QTest::FramesPerSecond;
     bool setByMacro = true;
     bool valid = false;
+    QVector<QBenchmarkCounter> counters;    // measured along with value
 
     QBenchmarkResult() = default;
 
@@ -120,9 +122,42 @@ public:
     {
         return (value / iterations) < (other.value / other.iterations);
     }
+
+    // Returns the total measured for \a m, or -1 if it was not measured.
+    qreal valueForMetric(QTest::QBenchmarkMetric m) const
+    {
+        if (metric == m)
+            return value;
+        for (const QBenchmarkCounter &counter : counters) {
+            if (counter.metric == m)
+                return qreal(counter.value);
+        }
+        return -1;
+    }
 };
 Q_DECLARE_TYPEINFO(QBenchmarkResult, Q_MOVABLE_TYPE);
 
+/*
+    Summary of the samples of one benchmark, one sample per median iteration,
+    with all values per accumulation iteration. Outliers are samples beyond
+    Tukey's fences, 1.5 interquartile ranges outside the quartiles; they are
+    counted, not removed.
+*/
+struct Q_TESTLIB_EXPORT QBenchmarkStatistics
+{
+    int count = 0;
+    qreal median = 0;
+    qreal mean = 0;
+    qreal standardDeviation = 0;
+    qreal confidenceLow = 0;    // 95% confidence interval of the mean
+    qreal confidenceHigh = 0;
+    qreal minimum = 0;
+    qreal maximum = 0;
+    int outliers = 0;
+
+    static QBenchmarkStatistics compute(const QVector<QBenchmarkResult> &samples);
+};
+
 /*
     The QBenchmarkGlobalData class stores global benchmark-related data.
     QBenchmarkGlobalData:current is created at the beginning of qExec()
@@ -150,6 +185,7 @@ public:
     bool verboseOutput = false;
     QString callgrindOutFileBase;
     int minimumTotal = -1;
+    int warmupCount = -1;
 private:
     Mode mode_ = WallTime;
 };
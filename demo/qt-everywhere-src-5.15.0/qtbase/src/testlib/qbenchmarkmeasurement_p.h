@@ -52,9 +52,18 @@
 //
 
 #include <QtTest/qbenchmark.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
+struct QBenchmarkCounter
+{
+    const char *name;   // static storage
+    QTest::QBenchmarkMetric metric;
+    qint64 value;
+};
+Q_DECLARE_TYPEINFO(QBenchmarkCounter, Q_PRIMITIVE_TYPE);
+
 class QBenchmarkMeasurerBase
 {
 public:
@@ -69,6 +78,8 @@ public:
     virtual bool repeatCount() { return true; }
     virtual bool needsWarmupIteration() { return false; }
     virtual QTest::QBenchmarkMetric metricType() = 0;
+    // the other counters read by the last stop(), if the measurer reads several
+    virtual QVector<QBenchmarkCounter> extraCounters() { return {}; }
 };
 
 QT_END_NAMESPACE
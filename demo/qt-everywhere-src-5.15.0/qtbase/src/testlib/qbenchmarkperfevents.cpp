@@ -83,25 +83,33 @@
 
 QT_BEGIN_NAMESPACE
 
-static perf_event_attr attr;
+// The counters opened as one group, so that they are scheduled onto the PMU
+// together and measure the same code. The first one is the group leader and
+// provides the benchmark result; the others are reported as extra counters.
+static perf_event_attr attrs[QBenchmarkPerfEventsMeasurer::MaxCounters];
+static const char *counterNames[QBenchmarkPerfEventsMeasurer::MaxCounters];
+static int counterCount = 1;
+static bool inheritCounters = true;
+static perf_event_attr &attr = attrs[0];
+
+static void initCounter(perf_event_attr &counter)
+{
+    memset(&counter, 0, sizeof counter);
+    counter.size = sizeof counter;
+    counter.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    counter.task = true; // trace fork/exits
+
+    // set a default performance counter: CPU cycles
+    counter.type = PERF_TYPE_HARDWARE;
+    counter.config = PERF_COUNT_HW_CPU_CYCLES; // default
+}
 
 static void initPerf()
 {
     static bool done;
     if (!done) {
-        memset(&attr, 0, sizeof attr);
-        attr.size = sizeof attr;
-        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
-        attr.disabled = true; // we'll enable later
-        attr.inherit = true; // let children processes inherit the monitoring
-        attr.pinned = true; // keep it running in the hardware
-        attr.inherit_stat = true; // aggregate all the info from child processes
-        attr.task = true; // trace fork/exits
-
-        // set a default performance counter: CPU cycles
-        attr.type = PERF_TYPE_HARDWARE;
-        attr.config = PERF_COUNT_HW_CPU_CYCLES; // default
-
+        initCounter(attr);
+        counterNames[0] = "cycles";
         done = true;
     }
 }
@@ -429,44 +437,47 @@ QTest::QBenchmarkMetric QBenchmarkPerfEventsMeasurer::metricForEvent(quint32 typ
     return QTest::Events;
 }
 
-void QBenchmarkPerfEventsMeasurer::setCounter(const char *name)
+// Parses one counter of a -perfcounter list, up to \a end
+static void parseCounter(const char *name, const char *end, perf_event_attr &counter,
+                         const char *&counterName)
 {
-    initPerf();
-    const char *colon = strchr(name, ':');
-    int n = colon ? colon - name : strlen(name);
+    const char *colon = static_cast<const char *>(memchr(name, ':', end - name));
+    int n = (colon ? colon : end) - name;
     const Events *ptr = eventlist;
     for ( ; ptr->type != PERF_TYPE_MAX; ++ptr) {
         int c = strncmp(name, eventlist_strings + ptr->offset, n);
         if (c == 0)
             break;
-        if (c < 0) {
-            fprintf(stderr, "ERROR: Performance counter type '%s' is unknown\n", name);
+        if (c < 0 || ptr[1].type == PERF_TYPE_MAX) {
+            fprintf(stderr, "ERROR: Performance counter type '%.*s' is unknown\n", int(end - name), name);
             exit(1);
         }
     }
 
-    attr.type = ptr->type;
-    attr.config = ptr->event_id;
+    initCounter(counter);
+    counter.type = ptr->type;
+    counter.config = ptr->event_id;
+    counterName = eventlist_strings + ptr->offset;
 
     // now parse the attributes
     if (!colon)
         return;
-    while (*++colon) {
+    while (++colon != end) {
         switch (*colon) {
         case 'u':
-            attr.exclude_user = true;
+            counter.exclude_user = true;
             break;
         case 'k':
-            attr.exclude_kernel = true;
+            counter.exclude_kernel = true;
             break;
         case 'h':
-            attr.exclude_hv = true;
+            counter.exclude_hv = true;
             break;
         case 'G':
-            attr.exclude_guest = true;
+            counter.exclude_guest = true;
             break;
         case 'H':
-            attr.exclude_host = true;
+            counter.exclude_host = true;
             break;
         default:
             fprintf(stderr, "ERROR: Unknown attribute '%c'\n", *colon);
@@ -475,6 +486,39 @@ void QBenchmarkPerfEventsMeasurer::setCounter(const char *name)
     }
 }
 
+void QBenchmarkPerfEventsMeasurer::setCounter(const char *name)
+{
+    initPerf();
+    counterCount = 0;
+    for (const char *end = name; *end; name = end + 1) {
+        end = strchr(name, ',');
+        if (!end)
+            end = name + strlen(name);
+        if (end == name) {
+            fprintf(stderr, "ERROR: Empty performance counter name\n");
+            exit(1);
+        }
+        if (counterCount == MaxCounters) {
+            fprintf(stderr, "ERROR: At most %d performance counters can be measured together\n",
+                    int(MaxCounters));
+            exit(1);
+        }
+        parseCounter(name, end, attrs[counterCount], counterNames[counterCount]);
+        ++counterCount;
+        if (!*end)
+            break;
+    }
+    if (!counterCount) {
+        fprintf(stderr, "ERROR: No performance counter given\n");
+        exit(1);
+    }
+}
+
+void QBenchmarkPerfEventsMeasurer::setInherit(bool inherit)
+{
+    inheritCounters = inherit;
+}
+
 void QBenchmarkPerfEventsMeasurer::listCounters()
 {
     if (!isAvailable()) {
@@ -497,14 +541,26 @@ void QBenchmarkPerfEventsMeasurer::listCounters()
            "  h - exclude measuring in the hypervisor\n"
            "  G - exclude measuring when running virtualized (guest VM)\n"
            "  H - exclude measuring when running non-virtualized (host system)\n"
-           "Attributes can be combined, for example: -perfcounter branch-mispredicts:kh\n");
+           "Attributes can be combined, for example: -perfcounter branch-mispredicts:kh\n"
+           "\nSeveral counters, separated by commas, are measured together as one group,\n"
+           "for example: -perfcounter cycles,instructions,cache-misses,branch-misses,cs\n"
+           "The first counter is the benchmark result, the others are reported with it.\n");
 }
 
-QBenchmarkPerfEventsMeasurer::QBenchmarkPerfEventsMeasurer() = default;
+QBenchmarkPerfEventsMeasurer::QBenchmarkPerfEventsMeasurer()
+{
+    for (int i = 0; i < MaxCounters; ++i) {
+        fds[i] = -1;
+        values[i] = 0;
+    }
+}
 
 QBenchmarkPerfEventsMeasurer::~QBenchmarkPerfEventsMeasurer()
 {
-    qt_safe_close(fd);
+    for (int i = MaxCounters - 1; i >= 0; --i) {
+        if (fds[i] != -1)
+            qt_safe_close(fds[i]);
+    }
 }
 
 void QBenchmarkPerfEventsMeasurer::init()
@@ -516,36 +572,51 @@ void QBenchmarkPerfEventsMeasurer::start()
 
     initPerf();
     if (fd == -1) {
-        // pid == 0 -> attach to the current process
-        // cpu == -1 -> monitor on all CPUs
-        // group_fd == -1 -> this is the group leader
-        // flags == 0 -> reserved, must be zero
-        fd = perf_event_open(&attr, 0, -1, -1, 0);
-        if (fd == -1) {
-            perror("QBenchmarkPerfEventsMeasurer::start: perf_event_open");
-            exit(1);
-        } else {
-            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        for (int i = 0; i < counterCount; ++i) {
+            perf_event_attr &a = attrs[i];
+            a.inherit = inheritCounters; // let children processes inherit the monitoring
+            a.inherit_stat = inheritCounters; // aggregate all the info from child processes
+            if (i == 0) {
+                a.disabled = true; // we'll enable later
+                a.pinned = true; // keep it running in the hardware
+                // the kernel can only read a whole group at once without inheritance
+                if (counterCount > 1 && !inheritCounters)
+                    a.read_format |= PERF_FORMAT_GROUP;
+            }
+
+            // pid == 0 -> attach to the current process
+            // cpu == -1 -> monitor on all CPUs
+            // group_fd == -1 -> this is the group leader, else it joins fds[0]
+            // flags == 0 -> reserved, must be zero
+            fds[i] = perf_event_open(&a, 0, -1, i ? fds[0] : -1, 0);
+            if (fds[i] == -1) {
+                fprintf(stderr, "QBenchmarkPerfEventsMeasurer::start: perf_event_open(%s): %s\n",
+                        counterNames[i], strerror(errno));
+                exit(1);
+            } else {
+                ::fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+            }
         }
+        fd = fds[0];
     }
 
-    // enable the counter
-    ::ioctl(fd, PERF_EVENT_IOC_RESET);
-    ::ioctl(fd, PERF_EVENT_IOC_ENABLE);
+    // enable the counters; the other members only count while the leader does
+    ::ioctl(fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
 }
 
 qint64 QBenchmarkPerfEventsMeasurer::checkpoint()
 {
-    ::ioctl(fd, PERF_EVENT_IOC_DISABLE);
+    ::ioctl(fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
     qint64 value = readValue();
-    ::ioctl(fd, PERF_EVENT_IOC_ENABLE);
+    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
     return value;
 }
 
 qint64 QBenchmarkPerfEventsMeasurer::stop()
 {
-    // disable the counter
-    ::ioctl(fd, PERF_EVENT_IOC_DISABLE);
+    // disable the counters
+    ::ioctl(fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
     return readValue();
 }
 
@@ -569,6 +640,56 @@ QTest::QBenchmarkMetric QBenchmarkPerfEventsMeasurer::metricType()
     return metricForEvent(attr.type, attr.config);
 }
 
+QVector<QBenchmarkCounter> QBenchmarkPerfEventsMeasurer::extraCounters()
+{
+    QVector<QBenchmarkCounter> result;
+    result.reserve(counterCount - 1);
+    for (int i = 1; i < counterCount; ++i)
+        result.append({ counterNames[i], metricForEvent(attrs[i].type, attrs[i].config), values[i] });
+    return result;
+}
+
+static void readFully(int fd, void *buffer, size_t size)
+{
+    size_t nread = 0;
+    while (nread < size) {
+        char *ptr = static_cast<char *>(buffer);
+        qint64 r = qt_safe_read(fd, ptr + nread, size - nread);
+        if (r == -1) {
+            perror("QBenchmarkPerfEventsMeasurer::readValue: reading the results");
+            exit(1);
+        }
+        nread += quint64(r);
+    }
+}
+
+static quint64 scaledValue(quint64 value, quint64 time_enabled, quint64 time_running)
+{
+    if (time_running == time_enabled)
+        return value;
+
+    // scale the results, though this shouldn't happen!
+    return value * (double(time_running) / double(time_enabled));
+}
+
+static void rawReadGroup(int fd, quint64 *values, int count)
+{
+    /* from the kernel docs:
+     * struct read_format {
+     *  { u64           nr;            } && PERF_FORMAT_GROUP
+     *  { u64           time_enabled; } && PERF_FORMAT_TOTAL_TIME_ENABLED
+     *  { u64           time_running; } && PERF_FORMAT_TOTAL_TIME_RUNNING
+     *  { u64           value;
+     *    { u64         id;           } && PERF_FORMAT_ID
+     *  }               cntr[nr];
+     * } && PERF_FORMAT_GROUP
+     */
+    quint64 results[3 + QBenchmarkPerfEventsMeasurer::MaxCounters];
+    readFully(fd, results, (3 + count) * sizeof(quint64));
+    for (int i = 0; i < count; ++i)
+        values[i] = scaledValue(results[3 + i], results[1], results[2]);
+}
+
 static quint64 rawReadValue(int fd)
 {
     /* from the kernel docs:
@@ -586,32 +707,30 @@ static quint64 rawReadValue(int fd)
         quint64 time_running;
     } results;
 
-    size_t nread = 0;
-    while (nread < sizeof results) {
-        char *ptr = reinterpret_cast<char *>(&results);
-        qint64 r = qt_safe_read(fd, ptr + nread, sizeof results - nread);
-        if (r == -1) {
-            perror("QBenchmarkPerfEventsMeasurer::readValue: reading the results");
-            exit(1);
-        }
-        nread += quint64(r);
-    }
-
-    if (results.time_running == results.time_enabled)
-        return results.value;
-
-    // scale the results, though this shouldn't happen!
-    return results.value * (double(results.time_running) / double(results.time_enabled));
+    readFully(fd, &results, sizeof results);
+    return scaledValue(results.value, results.time_enabled, results.time_running);
 }
 
 qint64 QBenchmarkPerfEventsMeasurer::readValue()
 {
-    quint64 raw = rawReadValue(fd);
-    if (metricType() == QTest::WalltimeMilliseconds) {
-        // perf returns nanoseconds
-        return raw / 1000000;
+    quint64 raw[MaxCounters];
+    if (attr.read_format & PERF_FORMAT_GROUP) {
+        rawReadGroup(fd, raw, counterCount);
+    } else {
+        // the counters are stopped together with the leader, so reading
+        // them one after the other is still consistent
+        for (int i = 0; i < counterCount; ++i)
+            raw[i] = rawReadValue(fds[i]);
+    }
+
+    for (int i = 0; i < counterCount; ++i) {
+        values[i] = raw[i];
+        if (metricForEvent(attrs[i].type, attrs[i].config) == QTest::WalltimeMilliseconds) {
+            // perf returns nanoseconds
+            values[i] = raw[i] / 1000000;
+        }
     }
-    return raw;
+    return values[0];
 }
 
 QT_END_NAMESPACE
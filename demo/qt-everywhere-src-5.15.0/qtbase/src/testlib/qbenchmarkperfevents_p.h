@@ -58,6 +58,8 @@ QT_BEGIN_NAMESPACE
 class QBenchmarkPerfEventsMeasurer : public QBenchmarkMeasurerBase
 {
 public:
+    enum { MaxCounters = 8 };
+
     QBenchmarkPerfEventsMeasurer();
     ~QBenchmarkPerfEventsMeasurer();
     void init() override;
@@ -70,13 +72,17 @@ public:
     bool repeatCount() override { return true; }
     bool needsWarmupIteration() override { return true; }
     QTest::QBenchmarkMetric metricType() override;
+    QVector<QBenchmarkCounter> extraCounters() override;
 
     static bool isAvailable();
     static QTest::QBenchmarkMetric metricForEvent(quint32 type, quint64 event_id);
     static void setCounter(const char *name);
+    static void setInherit(bool inherit);
     static void listCounters();
 private:
-    int fd = -1;
+    int fd = -1;    // the group leader, fds[0]
+    int fds[MaxCounters];
+    qint64 values[MaxCounters];
 
     qint64 readValue();
 };
@@ -0,0 +1,217 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtTest module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonbenchmarklogger_p.h"
+#include "qtestresult_p.h"
+#include "qbenchmark_p.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qnumeric.h>
+#include <QtCore/qsysinfo.h>
+#include <QtCore/qthread.h>
+
+QT_BEGIN_NAMESPACE
+
+static QByteArray jsonString(const char *str)
+{
+    QByteArray result("\"");
+    for (; *str; ++str) {
+        const uchar c = uchar(*str);
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (c < 0x20 || c == 0x7f) {
+                char buf[8];
+                qsnprintf(buf, sizeof(buf), "\\u%04x", c);
+                result += buf;
+            } else {
+                result += char(c);
+            }
+        }
+    }
+    return result + '"';
+}
+
+static QByteArray jsonString(const QString &str)
+{
+    return jsonString(str.toUtf8().constData());
+}
+
+static QByteArray jsonNumber(qreal value)
+{
+    // JSON has no representation for infinities and NaN
+    if (!qIsFinite(value))
+        return "null";
+    char buf[32];
+    qsnprintf(buf, sizeof(buf), "%.13g", value);
+    return buf;
+}
+
+/*
+    Writes one JSON document: the machine context, followed by one entry per
+    benchmark data row with every sample and their statistics.
+*/
+QJsonBenchmarkLogger::QJsonBenchmarkLogger(const char *filename)
+    : QAbstractTestLogger(filename)
+{
+}
+
+QJsonBenchmarkLogger::~QJsonBenchmarkLogger() = default;
+
+void QJsonBenchmarkLogger::startLogging()
+{
+    const QBenchmarkGlobalData *global = QBenchmarkGlobalData::current;
+    QByteArray out = "{\n  \"testCase\": " + jsonString(QTestResult::currentTestObjectName())
+            + ",\n  \"context\": {"
+            + "\n    \"qtVersion\": " + jsonString(qVersion())
+            + ",\n    \"buildAbi\": " + jsonString(QSysInfo::buildAbi())
+            + ",\n    \"cpuArchitecture\": " + jsonString(QSysInfo::currentCpuArchitecture())
+            + ",\n    \"idealThreadCount\": " + QByteArray::number(QThread::idealThreadCount())
+            + ",\n    \"kernelType\": " + jsonString(QSysInfo::kernelType())
+            + ",\n    \"kernelVersion\": " + jsonString(QSysInfo::kernelVersion())
+            + ",\n    \"productName\": " + jsonString(QSysInfo::prettyProductName())
+            + ",\n    \"hostName\": " + jsonString(QSysInfo::machineHostName())
+            + ",\n    \"startTime\": "
+            + jsonString(QDateTime::currentDateTimeUtc().toString(Qt::ISODate))
+            + ",\n    \"medianCount\": " + QByteArray::number(global ? global->medianIterationCount : -1)
+            + ",\n    \"warmupCount\": " + QByteArray::number(global ? global->warmupCount : -1)
+            + "\n  },\n  \"benchmarks\": [";
+    outputString(out.constData());
+}
+
+void QJsonBenchmarkLogger::stopLogging()
+{
+    outputString(firstResult ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+void QJsonBenchmarkLogger::enterTestFunction(const char *)
+{
+    // don't print anything
+}
+
+void QJsonBenchmarkLogger::leaveTestFunction()
+{
+    // don't print anything
+}
+
+void QJsonBenchmarkLogger::addIncident(QAbstractTestLogger::IncidentTypes, const char *, const char *, int)
+{
+    // don't print anything
+}
+
+void QJsonBenchmarkLogger::addBenchmarkResult(const QBenchmarkResult &)
+{
+    // everything is written by addBenchmarkSamples()
+}
+
+void QJsonBenchmarkLogger::addBenchmarkSamples(const QVector<QBenchmarkResult> &samples)
+{
+    if (samples.isEmpty())
+        return;
+
+    const char *fn = QTestResult::currentTestFunction() ? QTestResult::currentTestFunction()
+        : "UnknownTestFunc";
+    const char *tag = QTestResult::currentDataTag() ? QTestResult::currentDataTag() : "";
+    const char *gtag = QTestResult::currentGlobalDataTag()
+                     ? QTestResult::currentGlobalDataTag()
+                     : "";
+
+    const QBenchmarkStatistics stats = QBenchmarkStatistics::compute(samples);
+
+    QByteArray out = firstResult ? "\n    {" : ",\n    {";
+    firstResult = false;
+    out += "\n      \"function\": " + jsonString(fn)
+            + ",\n      \"tag\": " + jsonString(tag)
+            + ",\n      \"globalTag\": " + jsonString(gtag)
+            + ",\n      \"metric\": " + jsonString(QTest::benchmarkMetricName(samples.first().metric))
+            + ",\n      \"unit\": " + jsonString(QTest::benchmarkMetricUnit(samples.first().metric))
+            + ",\n      \"samples\": [";
+    for (int i = 0; i < samples.size(); ++i) {
+        const QBenchmarkResult &sample = samples.at(i);
+        out += (i ? ", " : "") + QByteArray("{ \"value\": ") + jsonNumber(sample.value)
+                + ", \"iterations\": " + QByteArray::number(sample.iterations);
+        if (!sample.counters.isEmpty()) {
+            out += ", \"counters\": {";
+            for (int j = 0; j < sample.counters.size(); ++j) {
+                const QBenchmarkCounter &counter = sample.counters.at(j);
+                out += (j ? ", " : " ") + jsonString(counter.name) + ": "
+                        + QByteArray::number(counter.value);
+            }
+            out += " }";
+        }
+        out += " }";
+    }
+    out += "],\n      \"median\": " + jsonNumber(stats.median)
+            + ",\n      \"mean\": " + jsonNumber(stats.mean)
+            + ",\n      \"standardDeviation\": " + jsonNumber(stats.standardDeviation)
+            + ",\n      \"confidenceInterval95\": [" + jsonNumber(stats.confidenceLow)
+            + ", " + jsonNumber(stats.confidenceHigh) + ']'
+            + ",\n      \"minimum\": " + jsonNumber(stats.minimum)
+            + ",\n      \"maximum\": " + jsonNumber(stats.maximum)
+            + ",\n      \"outliers\": " + QByteArray::number(stats.outliers);
+
+    // derived metrics, from the totals of all samples
+    qreal cycles = 0, instructions = 0;
+    for (const QBenchmarkResult &sample : samples) {
+        cycles += qMax<qreal>(sample.valueForMetric(QTest::CPUCycles), 0);
+        instructions += qMax<qreal>(sample.valueForMetric(QTest::Instructions), 0);
+    }
+    if (!samples.first().counters.isEmpty() && cycles > 0 && instructions > 0)
+        out += ",\n      \"instructionsPerCycle\": " + jsonNumber(instructions / cycles);
+    out += "\n    }";
+    outputString(out.constData());
+}
+
+void QJsonBenchmarkLogger::addMessage(QAbstractTestLogger::MessageTypes, const QString &, const char *, int)
+{
+    // don't print anything
+}
+
+QT_END_NAMESPACE
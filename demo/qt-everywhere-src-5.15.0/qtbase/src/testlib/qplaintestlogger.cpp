@@ -309,6 +309,21 @@ void QPlainTestLogger::printBenchmarkResult(const QBenchmarkResult &result)
 
     memcpy(buf, bmtag, strlen(bmtag));
     outputMessage(buf);
+
+    // the other counters of a group measured along with the result
+    for (const QBenchmarkCounter &counter : result.counters) {
+        const qreal perIteration = qreal(counter.value) / qreal(result.iterations);
+        QTest::formatResult(resultBuffer, 100, perIteration, QTest::countSignificantDigits(counter.value));
+        qsnprintf(buf, sizeof(buf), "%s%s %s per iteration (%s)\n", fill + 2, resultBuffer,
+                  QTest::benchmarkMetricUnit(counter.metric), counter.name);
+        outputMessage(buf);
+    }
+    const qreal cycles = result.valueForMetric(QTest::CPUCycles);
+    const qreal instructions = result.valueForMetric(QTest::Instructions);
+    if (!result.counters.isEmpty() && cycles > 0 && instructions >= 0) {
+        qsnprintf(buf, sizeof(buf), "%s%.3f instructions per cycle\n", fill + 2, instructions / cycles);
+        outputMessage(buf);
+    }
 }
 
 QPlainTestLogger::QPlainTestLogger(const char *filename)
@@ -530,6 +530,7 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
          "                       Valid formats are:\n"
          "                         txt      : Plain text\n"
          "                         csv      : CSV format (suitable for benchmarks)\n"
+         "                         json     : JSON document with every benchmark sample\n"
          "                         junitxml : XML JUnit document\n"
          "                         xml      : XML document\n"
          "                         lightxml : A stream of XML tags\n"
@@ -542,6 +543,7 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
          " -o filename         : Write the output into file\n"
          " -txt                : Output results in Plain Text\n"
          " -csv                : Output results in a CSV format (suitable for benchmarks)\n"
+         " -json               : Output benchmark samples and statistics as a JSON document\n"
          " -junitxml           : Output results as XML JUnit document\n"
          " -xml                : Output results as XML document\n"
          " -lightxml           : Output results as stream of XML tags\n"
@@ -576,7 +578,8 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
 #endif
 #ifdef QTESTLIB_USE_PERF_EVENTS
          " -perf               : Use Linux perf events to time benchmarks\n"
-         " -perfcounter name   : Use the counter named 'name'\n"
+         " -perfcounter name   : Use the counter named 'name', or a comma-separated group\n"
+         " -perfthread         : Only count events of the thread running the benchmark\n"
          " -perfcounterlist    : Lists the counters available\n"
 #endif
 #ifdef HAVE_TICK_COUNTER
@@ -587,6 +590,7 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
          " -minimumtotal n     : Sets the minimum acceptable total for repeated executions of a test function\n"
          " -iterations  n      : Sets the number of accumulation iterations.\n"
          " -median  n          : Sets the number of median iterations.\n"
+         " -warmup  n          : Sets the number of discarded warmup iterations.\n"
          " -vb                 : Print out verbose benchmarking information.\n";
 
     for (int i = 1; i < argc; ++i) {
@@ -626,6 +630,8 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
             logFormat = QTestLog::Plain;
         } else if (strcmp(argv[i], "-csv") == 0) {
             logFormat = QTestLog::CSV;
+        } else if (strcmp(argv[i], "-json") == 0) {
+            logFormat = QTestLog::JSON;
         } else if (strcmp(argv[i], "-junitxml") == 0 || strcmp(argv[i], "-xunitxml") == 0)  {
             logFormat = QTestLog::JUnitXML;
         } else if (strcmp(argv[i], "-xml") == 0) {
@@ -662,6 +668,8 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
                     logFormat = QTestLog::Plain;
                 else if (strcmp(format, "csv") == 0)
                     logFormat = QTestLog::CSV;
+                else if (strcmp(format, "json") == 0)
+                    logFormat = QTestLog::JSON;
                 else if (strcmp(format, "lightxml") == 0)
                     logFormat = QTestLog::LightXML;
                 else if (strcmp(format, "xml") == 0)
@@ -673,7 +681,7 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
                 else if (strcmp(format, "tap") == 0)
                     logFormat = QTestLog::TAP;
                 else {
-                    fprintf(stderr, "output format must be one of txt, csv, lightxml, xml, tap, teamcity or junitxml\n");
+                    fprintf(stderr, "output format must be one of txt, csv, json, lightxml, xml, tap, teamcity or junitxml\n");
                     exit(1);
                 }
                 if (strcmp(filename, "-") == 0 && QTestLog::loggerUsingStdout()) {
@@ -746,6 +754,8 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
             } else {
                 QBenchmarkPerfEventsMeasurer::setCounter(argv[++i]);
             }
+        } else if (strcmp(argv[i], "-perfthread") == 0) {
+            QBenchmarkPerfEventsMeasurer::setInherit(false);
         } else if (strcmp(argv[i], "-perfcounterlist") == 0) {
             QBenchmarkPerfEventsMeasurer::listCounters();
             exit(0);
@@ -784,6 +794,13 @@ Q_TESTLIB_EXPORT void qtest_qParseArgs(int argc, const char *const argv[], bool
             } else {
                 QBenchmarkGlobalData::current->medianIterationCount = qToInt(argv[++i]);
             }
+        } else if (strcmp(argv[i], "-warmup") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "-warmup needs an extra parameter to indicate the number of warmup iterations\n");
+                exit(1);
+            } else {
+                QBenchmarkGlobalData::current->warmupCount = qToInt(argv[++i]);
+            }
 
         } else if (strcmp(argv[i], "-vb") == 0) {
             QBenchmarkGlobalData::current->verboseOutput = true;
@@ -912,7 +929,10 @@ void TestMethods::invokeTestOnData(int index) const
     /* Benchmarking: for each median iteration*/
 
     bool isBenchmark = false;
-    int i = (QBenchmarkGlobalData::current->measurer->needsWarmupIteration()) ? -1 : 0;
+    // negative iterations are the warmup iterations
+    const int warmupCount = QBenchmarkGlobalData::current->warmupCount;
+    int i = warmupCount >= 0 ? -warmupCount
+            : (QBenchmarkGlobalData::current->measurer->needsWarmupIteration()) ? -1 : 0;
 
     QVector<QBenchmarkResult> results;
     bool minimumTotalReached = false;
@@ -964,11 +984,11 @@ void TestMethods::invokeTestOnData(int index) const
 
         QBenchmarkTestMethodData::current->endDataRun();
         if (!QTestResult::skipCurrentTest() && !QTestResult::currentTestFailed()) {
-            if (i > -1)  // iteration -1 is the warmup iteration.
+            if (i > -1)
                 results.append(QBenchmarkTestMethodData::current->result);
 
             if (isBenchmark && QBenchmarkGlobalData::current->verboseOutput) {
-                if (i == -1) {
+                if (i < 0) {
                     QTestLog::info(qPrintable(
                         QString::fromLatin1("warmup stage result      : %1")
                             .arg(QBenchmarkTestMethodData::current->result.value)), nullptr, 0);
@@ -996,8 +1016,19 @@ void TestMethods::invokeTestOnData(int index) const
         bool testPassed = !QTestResult::skipCurrentTest() && !QTestResult::currentTestFailed();
         QTestResult::finishedCurrentTestDataCleanup();
         // Only report benchmark figures if the test passed
-        if (testPassed && QBenchmarkTestMethodData::current->resultsAccepted())
+        if (testPassed && QBenchmarkTestMethodData::current->resultsAccepted()) {
+            if (QBenchmarkGlobalData::current->verboseOutput && results.size() > 1) {
+                const QBenchmarkStatistics stats = QBenchmarkStatistics::compute(results);
+                QTestLog::info(qPrintable(
+                    QString::fromLatin1("statistics of %1 samples : mean %2, standard deviation %3, "
+                                        "95% confidence interval [%4, %5], %6 outliers")
+                        .arg(stats.count).arg(stats.mean).arg(stats.standardDeviation)
+                        .arg(stats.confidenceLow).arg(stats.confidenceHigh).arg(stats.outliers)),
+                    nullptr, 0);
+            }
+            QTestLog::addBenchmarkSamples(results);
             QTestLog::addBenchmarkResult(qMedian(results));
+        }
     }
 }
 
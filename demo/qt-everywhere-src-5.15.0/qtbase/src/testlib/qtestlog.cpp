@@ -44,6 +44,7 @@
 #include <QtTest/private/qabstracttestlogger_p.h>
 #include <QtTest/private/qplaintestlogger_p.h>
 #include <QtTest/private/qcsvbenchmarklogger_p.h>
+#include <QtTest/private/qjsonbenchmarklogger_p.h>
 #include <QtTest/private/qjunittestlogger_p.h>
 #include <QtTest/private/qxmltestlogger_p.h>
 #include <QtTest/private/qteamcitylogger_p.h>
@@ -414,6 +415,12 @@ void QTestLog::addBenchmarkResult(const QBenchmarkResult &result)
         logger->addBenchmarkResult(result);
 }
 
+void QTestLog::addBenchmarkSamples(const QVector<QBenchmarkResult> &samples)
+{
+    FOREACH_TEST_LOGGER
+        logger->addBenchmarkSamples(samples);
+}
+
 void QTestLog::startLogging()
 {
     elapsedTotalTime.start();
@@ -465,6 +472,9 @@ void QTestLog::addLogger(LogMode mode, const char *filename)
     case QTestLog::TAP:
         logger = new QTapTestLogger(filename);
         break;
+    case QTestLog::JSON:
+        logger = new QJsonBenchmarkLogger(filename);
+        break;
 #if defined(QT_USE_APPLE_UNIFIED_LOGGING)
     case QTestLog::Apple:
         logger = new QAppleTestLogger;
@@ -64,6 +64,7 @@ QT_BEGIN_NAMESPACE
 class QBenchmarkResult;
 class QRegularExpression;
 class QTestData;
+template <typename T> class QVector;
 
 class Q_TESTLIB_EXPORT QTestLog
 {
@@ -74,7 +75,7 @@ public:
     Q_DISABLE_COPY_MOVE(QTestLog)
 
     enum LogMode {
-        Plain = 0, XML, LightXML, JUnitXML, CSV, TeamCity, TAP
+        Plain = 0, XML, LightXML, JUnitXML, CSV, TeamCity, TAP, JSON
 #if defined(QT_USE_APPLE_UNIFIED_LOGGING)
         , Apple
 #endif
@@ -99,6 +100,7 @@ public:
     static void addBXFail(const char *msg, const char *file, int line);
     static void addSkip(const char *msg, const char *file, int line);
     static void addBenchmarkResult(const QBenchmarkResult &result);
+    static void addBenchmarkSamples(const QVector<QBenchmarkResult> &samples);
 
     static void ignoreMessage(QtMsgType type, const char *msg);
 #ifndef QT_NO_REGULAREXPRESSION
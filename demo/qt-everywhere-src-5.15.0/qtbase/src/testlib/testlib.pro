@@ -22,6 +22,7 @@ HEADERS = \
     qbenchmarkmetric.h \
     qbenchmarkmetric_p.h \
     qcsvbenchmarklogger_p.h \
+    qjsonbenchmarklogger_p.h \
     qplaintestlogger_p.h \
     qsignaldumper_p.h \
     qsignalspy.h \
@@ -73,6 +74,7 @@ SOURCES = \
     qbenchmarkperfevents.cpp \
     qbenchmarkmetric.cpp \
     qcsvbenchmarklogger.cpp \
+    qjsonbenchmarklogger.cpp \
     qteamcitylogger.cpp \
     qtestelement.cpp \
     qtestelementattribute.cpp \
@@ -43,8 +43,15 @@
 #include <qcoreapplication.h>
 #include <qcommandlineoption.h>
 #include <qcommandlineparser.h>
+#include <qcryptographichash.h>
 #include <qscopedpointer.h>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 /*
@@ -219,13 +226,318 @@ QByteArray escapeAndEncodeDependencyPath(const QString &path)
     return QFile::encodeName(escapeDependencyPath(path));
 }
 
+// The options of a moc run that apply to each of its input files
+struct MocOptions
+{
+    bool autoInclude = true;
+    bool defaultInclude = true;
+    bool outputJson = false;
+    bool outputDepFile = false;
+    QString depFilePath;
+    QString depFileRuleName;
+    QStringList includeFiles;
+};
+
+// The input hashes of the files generated by a moc --batch run, kept in the
+// file given with --batch-cache. An output whose input still has the same hash
+// is not written again, which keeps its timestamp and saves recompiling it.
+class OutputHashCache
+{
+public:
+    void load(const QString &fileName);
+    bool save(const QString &fileName) const;
+    bool isUpToDate(const QString &output, const QByteArray &hash) const;
+    void update(const QString &output, const QByteArray &hash);
+
+private:
+    mutable std::mutex mutex;
+    QHash<QString, QByteArray> hashes;
+};
+
+// Each line holds a hex encoded hash and the output file it belongs to.
+void OutputHashCache::load(const QString &fileName)
+{
+    QFile f(fileName);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return; // no cache yet, everything is generated
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine().trimmed();
+        const int space = line.indexOf(' ');
+        if (space > 0)
+            hashes.insert(QFile::decodeName(line.mid(space + 1)), QByteArray::fromHex(line.left(space)));
+    }
+}
+
+bool OutputHashCache::save(const QString &fileName) const
+{
+    QFile f(fileName);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = hashes.cbegin(), end = hashes.cend(); it != end; ++it)
+        f.write(it.value().toHex() + ' ' + QFile::encodeName(it.key()) + '\n');
+    return f.flush();
+}
+
+bool OutputHashCache::isUpToDate(const QString &output, const QByteArray &hash) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (hashes.value(output) != hash)
+            return false;
+    }
+    return QFile::exists(output);
+}
+
+void OutputHashCache::update(const QString &output, const QByteArray &hash)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    hashes.insert(output, hash);
+}
+
+// Hashes everything the generated code depends on: the preprocessed tokens,
+// but not their line numbers, and the settings that end up in the output.
+// Returns a null QByteArray if the output also depends on the contents of
+// other files, as it does with Q_PLUGIN_METADATA.
+static QByteArray inputHash(const Moc &moc, bool outputJson)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(mocOutputRevision) + ' ' + QT_VERSION_STR + ' ');
+    hash.addData(moc.filename + '\0' + moc.includePath + '\0');
+    for (const QByteArray &includeFile : moc.includeFiles)
+        hash.addData(includeFile + '\0');
+    for (auto it = moc.metaArgs.cbegin(), end = moc.metaArgs.cend(); it != end; ++it) {
+        for (const QJsonValue &value : it.value())
+            hash.addData(it.key().toUtf8() + '=' + value.toString().toUtf8() + '\0');
+    }
+    const char flags[] = { char(moc.noInclude), char(outputJson) };
+    hash.addData(flags, sizeof flags);
+
+    for (const Symbol &symbol : moc.symbols) {
+        if (symbol.token == Q_PLUGIN_METADATA_TOKEN)
+            return QByteArray();
+        const int header[] = { symbol.token, qMax(symbol.len, 0) };
+        hash.addData(reinterpret_cast<const char *>(header), sizeof header);
+        if (symbol.len > 0)
+            hash.addData(symbol.lex.constData() + symbol.from, symbol.len);
+    }
+    return hash.result();
+}
+
+static bool writeMocOutput(const Preprocessor &pp, Moc &moc, const MocOptions &options,
+                           const QString &output)
+{
+    FILE *out = 0;
+    QScopedPointer<FILE, ScopedPointerFileCloser> jsonOutput;
+
+    if (output.size()) { // output file specified
+#if defined(_MSC_VER)
+        if (_wfopen_s(&out, reinterpret_cast<const wchar_t *>(output.utf16()), L"w") != 0)
+#else
+        out = fopen(QFile::encodeName(output).constData(), "w"); // create output file
+        if (!out)
+#endif
+        {
+            fprintf(stderr, "moc: Cannot create %s\n", QFile::encodeName(output).constData());
+            return false;
+        }
+
+        if (options.outputJson) {
+            const QString jsonOutputFileName = output + QLatin1String(".json");
+            FILE *f;
+#if defined(_MSC_VER)
+            if (_wfopen_s(&f, reinterpret_cast<const wchar_t *>(jsonOutputFileName.utf16()), L"w") != 0)
+#else
+            f = fopen(QFile::encodeName(jsonOutputFileName).constData(), "w");
+            if (!f)
+#endif
+                fprintf(stderr, "moc: Cannot create JSON output file %s. %s\n",
+                        QFile::encodeName(jsonOutputFileName).constData(),
+                        strerror(errno));
+            jsonOutput.reset(f);
+        }
+    } else { // use stdout
+        out = stdout;
+    }
+
+    if (pp.preprocessOnly) {
+        fprintf(out, "%s\n", composePreprocessorOutput(moc.symbols).constData());
+    } else {
+        if (moc.classList.isEmpty())
+            moc.note("No relevant classes found. No output generated.");
+        else
+            moc.generate(out, jsonOutput.data());
+    }
+
+    if (output.size())
+        fclose(out);
+
+    return true;
+}
+
+// Runs moc on one input file; pp and moc hold the settings from the command line
+static int runMocJob(Preprocessor pp, Moc moc, const MocOptions &options,
+                     QString filename, const QString &output, OutputHashCache *hashCache)
+{
+    QFile in;
+
+    if (options.autoInclude) {
+        int spos = filename.lastIndexOf(QDir::separator());
+        int ppos = filename.lastIndexOf(QLatin1Char('.'));
+        // spos >= -1 && ppos > spos => ppos >= 0
+        moc.noInclude = (ppos > spos && filename.at(ppos + 1).toLower() != QLatin1Char('h'));
+    }
+    if (options.defaultInclude) {
+        if (moc.includePath.isEmpty()) {
+            if (filename.size()) {
+                if (output.size())
+                    moc.includeFiles.append(combinePath(filename, output));
+                else
+                    moc.includeFiles.append(QFile::encodeName(filename));
+            }
+        } else {
+            moc.includeFiles.append(combinePath(filename, filename));
+        }
+    }
+
+    if (filename.isEmpty()) {
+        filename = QStringLiteral("standard input");
+        in.open(stdin, QIODevice::ReadOnly);
+    } else {
+        in.setFileName(filename);
+        if (!in.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "moc: %s: No such file\n", qPrintable(filename));
+            return 1;
+        }
+        moc.filename = filename.toLocal8Bit();
+    }
+
+    moc.currentFilenames.push(filename.toLocal8Bit());
+    moc.includes = pp.includes;
+
+    // 1. preprocess
+    QStringList validIncludesFiles;
+    for (const QString &includeName : options.includeFiles) {
+        QByteArray rawName = pp.resolveInclude(QFile::encodeName(includeName), moc.filename);
+        if (rawName.isEmpty()) {
+            fprintf(stderr, "Warning: Failed to resolve include \"%s\" for moc file %s\n",
+                    includeName.toLocal8Bit().constData(),
+                    moc.filename.isEmpty() ? "<standard input>" : moc.filename.constData());
+        } else {
+            QFile f(QFile::decodeName(rawName));
+            if (f.open(QIODevice::ReadOnly)) {
+                moc.symbols += Symbol(0, MOC_INCLUDE_BEGIN, rawName);
+                moc.symbols += pp.preprocessed(rawName, &f);
+                moc.symbols += Symbol(0, MOC_INCLUDE_END, rawName);
+                validIncludesFiles.append(includeName);
+            } else {
+                fprintf(stderr, "Warning: Cannot open %s included by moc file %s: %s\n",
+                        rawName.constData(),
+                        moc.filename.isEmpty() ? "<standard input>" : moc.filename.constData(),
+                        f.errorString().toLocal8Bit().constData());
+            }
+        }
+    }
+    moc.symbols += pp.preprocessed(moc.filename, &in);
+
+    QByteArray hash;
+    bool upToDate = false;
+    if (hashCache && !pp.preprocessOnly) {
+        hash = inputHash(moc, options.outputJson);
+        upToDate = !hash.isNull() && hashCache->isUpToDate(output, hash)
+                && (!options.outputJson || QFile::exists(output + QLatin1String(".json")));
+    }
+
+    if (!pp.preprocessOnly && !upToDate) {
+        // 2. parse
+        moc.parse();
+    }
+
+    // 3. and output meta object code, unless the existing output is still valid
+    if (!upToDate) {
+        if (!writeMocOutput(pp, moc, options, output))
+            return 1;
+        if (!hash.isNull())
+            hashCache->update(output, hash);
+    }
+
+    if (options.outputDepFile) {
+        // 4. write a Make-style dependency file (can also be consumed by Ninja).
+        QString depOutputFileName;
+        QString depRuleName = output;
+
+        if (!options.depFileRuleName.isEmpty())
+            depRuleName = options.depFileRuleName;
+
+        if (!options.depFilePath.isEmpty()) {
+            depOutputFileName = options.depFilePath;
+        } else if (output.size()) {
+            depOutputFileName = output + QLatin1String(".d");
+        } else {
+            fprintf(stderr, "moc: Writing to stdout, but no depfile path specified.\n");
+        }
+
+        QScopedPointer<FILE, ScopedPointerFileCloser> depFileHandle;
+        FILE *depFileHandleRaw;
+#if defined(_MSC_VER)
+        if (_wfopen_s(&depFileHandleRaw,
+                      reinterpret_cast<const wchar_t *>(depOutputFileName.utf16()), L"w") != 0)
+#else
+        depFileHandleRaw = fopen(QFile::encodeName(depOutputFileName).constData(), "w");
+        if (!depFileHandleRaw)
+#endif
+            fprintf(stderr, "moc: Cannot create dep output file '%s'. %s\n",
+                    QFile::encodeName(depOutputFileName).constData(),
+                    strerror(errno));
+        depFileHandle.reset(depFileHandleRaw);
+
+        if (!depFileHandle.isNull()) {
+            // First line is the path to the generated file.
+            fprintf(depFileHandle.data(), "%s: ",
+                    escapeAndEncodeDependencyPath(depRuleName).constData());
+
+            QByteArrayList dependencies;
+
+            // If there's an input file, it's the first dependency.
+            if (!filename.isEmpty()) {
+                dependencies.append(escapeAndEncodeDependencyPath(filename).constData());
+            }
+
+            // Additional passed-in includes are dependencies (like moc_predefs.h).
+            for (const QString &includeName : validIncludesFiles) {
+                dependencies.append(escapeAndEncodeDependencyPath(includeName).constData());
+            }
+
+            // Plugin metadata json files discovered via Q_PLUGIN_METADATA macros are also
+            // dependencies.
+            for (const QString &pluginMetadataFile : moc.parsedPluginMetadataFiles) {
+                dependencies.append(escapeAndEncodeDependencyPath(pluginMetadataFile).constData());
+            }
+
+            // All pre-processed includes are dependnecies.
+            // Sort the entries for easier human consumption.
+            auto includeList = pp.preprocessedIncludes.values();
+            std::sort(includeList.begin(), includeList.end());
+
+            for (QByteArray &includeName : includeList) {
+                dependencies.append(escapeDependencyPath(includeName));
+            }
+
+            // Join dependencies, output them, and output a final new line.
+            const auto dependenciesJoined = dependencies.join(QByteArrayLiteral(" \\\n  "));
+            fprintf(depFileHandle.data(), "%s\n", dependenciesJoined.constData());
+        }
+    }
+
+    return 0;
+}
+
 int runMoc(int argc, char **argv)
 {
     QCoreApplication app(argc, argv);
     QCoreApplication::setApplicationVersion(QString::fromLatin1(QT_VERSION_STR));
 
-    bool autoInclude = true;
-    bool defaultInclude = true;
+    MocOptions options;
     Preprocessor pp;
     Moc moc;
     pp.macros["Q_MOC_RUN"];
@@ -241,8 +553,6 @@ int runMoc(int argc, char **argv)
 
     QString filename;
     QString output;
-    QFile in;
-    FILE *out = 0;
 
     // Note that moc isn't translated.
     // If you use this code as an example for a translated app, make sure to translate the strings.
@@ -367,6 +677,21 @@ int runMoc(int argc, char **argv)
     depFileRuleNameOption.setValueName(QStringLiteral("rule name"));
     parser.addOption(depFileRuleNameOption);
 
+    QCommandLineOption batchOption(QStringLiteral("batch"));
+    batchOption.setDescription(QStringLiteral("Process all the files listed in <file>, each line holding a header file and its output file separated by a tab."));
+    batchOption.setValueName(QStringLiteral("file"));
+    parser.addOption(batchOption);
+
+    QCommandLineOption batchCacheOption(QStringLiteral("batch-cache"));
+    batchCacheOption.setDescription(QStringLiteral("With --batch, keep the hashes of the inputs in <file> and do not regenerate outputs whose input did not change."));
+    batchCacheOption.setValueName(QStringLiteral("file"));
+    parser.addOption(batchCacheOption);
+
+    QCommandLineOption jobsOption(QStringLiteral("jobs"));
+    jobsOption.setDescription(QStringLiteral("With --batch, process <n> files in parallel. The default is the number of processors."));
+    jobsOption.setValueName(QStringLiteral("n"));
+    parser.addOption(jobsOption);
+
     parser.addPositionalArgument(QStringLiteral("[header-file]"),
             QStringLiteral("Header file to read from, otherwise stdin."));
     parser.addPositionalArgument(QStringLiteral("[@option-file]"),
@@ -385,7 +710,14 @@ int runMoc(int argc, char **argv)
     if (parser.isSet(collectOption))
         return collectJson(files, output);
 
-    if (files.count() > 1) {
+    const bool batch = parser.isSet(batchOption);
+    if (batch && (!files.isEmpty() || !output.isEmpty())) {
+        error("--batch cannot be combined with input files or -o");
+        parser.showHelp(1);
+    } else if (batch && parser.isSet(depFilePathOption)) {
+        error("--batch cannot be combined with --dep-file-path");
+        parser.showHelp(1);
+    } else if (files.count() > 1) {
         error(qPrintable(QLatin1String("Too many input files specified: '") + files.join(QLatin1String("' '")) + QLatin1Char('\'')));
         parser.showHelp(1);
     } else if (!files.isEmpty()) {
@@ -396,16 +728,16 @@ int runMoc(int argc, char **argv)
     pp.preprocessOnly = parser.isSet(preprocessOption);
     if (parser.isSet(noIncludeOption)) {
         moc.noInclude = true;
-        autoInclude = false;
+        options.autoInclude = false;
     }
     if (!ignoreConflictingOptions) {
         if (parser.isSet(forceIncludeOption)) {
             moc.noInclude = false;
-            autoInclude = false;
+            options.autoInclude = false;
             const auto forceIncludes = parser.values(forceIncludeOption);
             for (const QString &include : forceIncludes) {
                 moc.includeFiles.append(QFile::encodeName(include));
-                defaultInclude = false;
+                options.defaultInclude = false;
              }
         }
         const auto prependIncludes = parser.values(prependIncludeOption);
@@ -480,37 +812,6 @@ int runMoc(int argc, char **argv)
     if (parser.isSet(noWarningsOption) || noNotesCompatValues.contains(QLatin1String("w")))
         moc.displayWarnings = moc.displayNotes = false;
 
-    if (autoInclude) {
-        int spos = filename.lastIndexOf(QDir::separator());
-        int ppos = filename.lastIndexOf(QLatin1Char('.'));
-        // spos >= -1 && ppos > spos => ppos >= 0
-        moc.noInclude = (ppos > spos && filename.at(ppos + 1).toLower() != QLatin1Char('h'));
-    }
-    if (defaultInclude) {
-        if (moc.includePath.isEmpty()) {
-            if (filename.size()) {
-                if (output.size())
-                    moc.includeFiles.append(combinePath(filename, output));
-                else
-                    moc.includeFiles.append(QFile::encodeName(filename));
-            }
-        } else {
-            moc.includeFiles.append(combinePath(filename, filename));
-        }
-    }
-
-    if (filename.isEmpty()) {
-        filename = QStringLiteral("standard input");
-        in.open(stdin, QIODevice::ReadOnly);
-    } else {
-        in.setFileName(filename);
-        if (!in.open(QIODevice::ReadOnly)) {
-            fprintf(stderr, "moc: %s: No such file\n", qPrintable(filename));
-            return 1;
-        }
-        moc.filename = filename.toLocal8Bit();
-    }
-
     const auto metadata = parser.values(metadataOption);
     for (const QString &md : metadata) {
         int split = md.indexOf(QLatin1Char('='));
@@ -530,157 +831,88 @@ int runMoc(int argc, char **argv)
         }
     }
 
-    moc.currentFilenames.push(filename.toLocal8Bit());
-    moc.includes = pp.includes;
-
-    // 1. preprocess
-    const auto includeFiles = parser.values(includeOption);
-    QStringList validIncludesFiles;
-    for (const QString &includeName : includeFiles) {
-        QByteArray rawName = pp.resolveInclude(QFile::encodeName(includeName), moc.filename);
-        if (rawName.isEmpty()) {
-            fprintf(stderr, "Warning: Failed to resolve include \"%s\" for moc file %s\n",
-                    includeName.toLocal8Bit().constData(),
-                    moc.filename.isEmpty() ? "<standard input>" : moc.filename.constData());
-        } else {
-            QFile f(QFile::decodeName(rawName));
-            if (f.open(QIODevice::ReadOnly)) {
-                moc.symbols += Symbol(0, MOC_INCLUDE_BEGIN, rawName);
-                moc.symbols += pp.preprocessed(rawName, &f);
-                moc.symbols += Symbol(0, MOC_INCLUDE_END, rawName);
-                validIncludesFiles.append(includeName);
-            } else {
-                fprintf(stderr, "Warning: Cannot open %s included by moc file %s: %s\n",
-                        rawName.constData(),
-                        moc.filename.isEmpty() ? "<standard input>" : moc.filename.constData(),
-                        f.errorString().toLocal8Bit().constData());
-            }
-        }
-    }
-    moc.symbols += pp.preprocessed(moc.filename, &in);
-
-    if (!pp.preprocessOnly) {
-        // 2. parse
-        moc.parse();
+    options.outputJson = parser.isSet(jsonOption);
+    options.outputDepFile = parser.isSet(depFileOption);
+    options.depFilePath = parser.value(depFilePathOption);
+    options.depFileRuleName = parser.value(depFileRuleNameOption);
+    options.includeFiles = parser.values(includeOption);
+
+    if (!batch)
+        return runMocJob(pp, moc, options, filename, output, nullptr);
+
+    // Batch mode: the files are preprocessed and generated on a number of
+    // threads, which share the lookup and tokenizing of the include files.
+    QVector<QPair<QString, QString>> jobs;
+    QFile batchFile(parser.value(batchOption));
+    if (!batchFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        fprintf(stderr, "moc: Cannot open batch file %s\n", qPrintable(batchFile.fileName()));
+        return 1;
     }
-
-    // 3. and output meta object code
-
-    QScopedPointer<FILE, ScopedPointerFileCloser> jsonOutput;
-
-    bool outputToFile = true;
-    if (output.size()) { // output file specified
-#if defined(_MSC_VER)
-        if (_wfopen_s(&out, reinterpret_cast<const wchar_t *>(output.utf16()), L"w") != 0)
-#else
-        out = fopen(QFile::encodeName(output).constData(), "w"); // create output file
-        if (!out)
-#endif
-        {
-            fprintf(stderr, "moc: Cannot create %s\n", QFile::encodeName(output).constData());
+    while (!batchFile.atEnd()) {
+        const QString line = QString::fromLocal8Bit(batchFile.readLine()).trimmed();
+        if (line.isEmpty())
+            continue;
+        const int tab = line.indexOf(QLatin1Char('\t'));
+        if (tab <= 0 || tab == line.size() - 1) {
+            fprintf(stderr, "moc: Invalid line in batch file %s: %s\n",
+                    qPrintable(batchFile.fileName()), qPrintable(line));
             return 1;
         }
-
-        if (parser.isSet(jsonOption)) {
-            const QString jsonOutputFileName = output + QLatin1String(".json");
-            FILE *f;
-#if defined(_MSC_VER)
-            if (_wfopen_s(&f, reinterpret_cast<const wchar_t *>(jsonOutputFileName.utf16()), L"w") != 0)
-#else
-            f = fopen(QFile::encodeName(jsonOutputFileName).constData(), "w");
-            if (!f)
-#endif
-                fprintf(stderr, "moc: Cannot create JSON output file %s. %s\n",
-                        QFile::encodeName(jsonOutputFileName).constData(),
-                        strerror(errno));
-            jsonOutput.reset(f);
-        }
-    } else { // use stdout
-        out = stdout;
-        outputToFile = false;
-    }
-
-    if (pp.preprocessOnly) {
-        fprintf(out, "%s\n", composePreprocessorOutput(moc.symbols).constData());
-    } else {
-        if (moc.classList.isEmpty())
-            moc.note("No relevant classes found. No output generated.");
-        else
-            moc.generate(out, jsonOutput.data());
+        jobs.append(qMakePair(line.left(tab), line.mid(tab + 1)));
     }
-
-    if (output.size())
-        fclose(out);
-
-    if (parser.isSet(depFileOption)) {
-        // 4. write a Make-style dependency file (can also be consumed by Ninja).
-        QString depOutputFileName;
-        QString depRuleName = output;
-
-        if (parser.isSet(depFileRuleNameOption))
-            depRuleName = parser.value(depFileRuleNameOption);
-
-        if (parser.isSet(depFilePathOption)) {
-            depOutputFileName = parser.value(depFilePathOption);
-        } else if (outputToFile) {
-            depOutputFileName = output + QLatin1String(".d");
-        } else {
-            fprintf(stderr, "moc: Writing to stdout, but no depfile path specified.\n");
+    batchFile.close();
+
+    int threadCount = int(std::thread::hardware_concurrency());
+    if (parser.isSet(jobsOption)) {
+        bool ok;
+        threadCount = parser.value(jobsOption).toInt(&ok);
+        if (!ok || threadCount < 1) {
+            error("--jobs requires a positive number");
+            parser.showHelp(1);
         }
-
-        QScopedPointer<FILE, ScopedPointerFileCloser> depFileHandle;
-        FILE *depFileHandleRaw;
-#if defined(_MSC_VER)
-        if (_wfopen_s(&depFileHandleRaw,
-                      reinterpret_cast<const wchar_t *>(depOutputFileName.utf16()), L"w") != 0)
-#else
-        depFileHandleRaw = fopen(QFile::encodeName(depOutputFileName).constData(), "w");
-        if (!depFileHandleRaw)
-#endif
-            fprintf(stderr, "moc: Cannot create dep output file '%s'. %s\n",
-                    QFile::encodeName(depOutputFileName).constData(),
-                    strerror(errno));
-        depFileHandle.reset(depFileHandleRaw);
-
-        if (!depFileHandle.isNull()) {
-            // First line is the path to the generated file.
-            fprintf(depFileHandle.data(), "%s: ",
-                    escapeAndEncodeDependencyPath(depRuleName).constData());
-
-            QByteArrayList dependencies;
-
-            // If there's an input file, it's the first dependency.
-            if (!filename.isEmpty()) {
-                dependencies.append(escapeAndEncodeDependencyPath(filename).constData());
-            }
-
-            // Additional passed-in includes are dependencies (like moc_predefs.h).
-            for (const QString &includeName : validIncludesFiles) {
-                dependencies.append(escapeAndEncodeDependencyPath(includeName).constData());
-            }
-
-            // Plugin metadata json files discovered via Q_PLUGIN_METADATA macros are also
-            // dependencies.
-            for (const QString &pluginMetadataFile : moc.parsedPluginMetadataFiles) {
-                dependencies.append(escapeAndEncodeDependencyPath(pluginMetadataFile).constData());
-            }
-
-            // All pre-processed includes are dependnecies.
-            // Sort the entries for easier human consumption.
-            auto includeList = pp.preprocessedIncludes.values();
-            std::sort(includeList.begin(), includeList.end());
-
-            for (QByteArray &includeName : includeList) {
-                dependencies.append(escapeDependencyPath(includeName));
+    }
+    threadCount = qBound(1, threadCount, qMax(jobs.size(), 1));
+
+    IncludeCache includeCache;
+    pp.includeCache = &includeCache;
+
+    const bool useHashCache = parser.isSet(batchCacheOption);
+    OutputHashCache hashCache;
+    if (useHashCache)
+        hashCache.load(parser.value(batchCacheOption));
+
+    // An error in one input must not exit() while other threads are still
+    // writing their output files; the worker reports it back instead.
+    Parser::throwOnError = true;
+    std::atomic<int> nextJob(0);
+    std::atomic<bool> failed(false);
+    const auto worker = [&]() {
+        for (int i = nextJob++; i < jobs.size(); i = nextJob++) {
+            int result;
+            try {
+                result = runMocJob(pp, moc, options, jobs.at(i).first, jobs.at(i).second,
+                                   useHashCache ? &hashCache : nullptr);
+            } catch (const ParseError &) {
+                result = 1;
             }
-
-            // Join dependencies, output them, and output a final new line.
-            const auto dependenciesJoined = dependencies.join(QByteArrayLiteral(" \\\n  "));
-            fprintf(depFileHandle.data(), "%s\n", dependenciesJoined.constData());
+            if (result != 0)
+                failed = true;
         }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    if (useHashCache && !hashCache.save(parser.value(batchCacheOption))) {
+        fprintf(stderr, "moc: Cannot write batch cache %s\n",
+                qPrintable(parser.value(batchCacheOption)));
+        return 1;
     }
-
-    return 0;
+    return failed ? 1 : 0;
 }
 
 QT_END_NAMESPACE
@@ -1,5 +1,5 @@
 option(host_build)
-CONFIG += force_bootstrap
+CONFIG += force_bootstrap thread exceptions
 
 DEFINES += \
     QT_MOC \
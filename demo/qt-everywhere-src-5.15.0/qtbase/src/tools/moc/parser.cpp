@@ -39,6 +39,8 @@ Symbol::LexemStore Symbol::lexemStore;
 
 static const char *error_msg = nullptr;
 
+bool Parser::throwOnError = false;
+
 #ifdef Q_CC_MSVC
 #define ErrorFormatString "%s(%d): "
 #else
@@ -56,6 +58,8 @@ void Parser::error(const char *msg) {
     else
         fprintf(stderr, ErrorFormatString "Parse error at \"%s\"\n",
                  currentFilenames.top().constData(), symbol().lineNum, symbol().lexem().data());
+    if (throwOnError)
+        throw ParseError();
     exit(EXIT_FAILURE);
 }
 
@@ -35,10 +35,15 @@
 
 QT_BEGIN_NAMESPACE
 
+// Thrown by Parser::error() when Parser::throwOnError is set, so that a
+// moc --batch worker only fails its current input instead of exiting
+struct ParseError {};
+
 class Parser
 {
 public:
     Parser():index(0), displayWarnings(true), displayNotes(true) {}
+    static bool throwOnError;
     Symbols symbols;
     int index;
     bool displayWarnings;
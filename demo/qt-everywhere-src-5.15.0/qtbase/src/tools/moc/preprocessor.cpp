@@ -1034,6 +1034,56 @@ static QByteArray searchIncludePaths(const QList<Parser::IncludePath> &includepa
     return fi.canonicalFilePath().toLocal8Bit();
 }
 
+// Reads and tokenizes an include file. Returns no symbols if the file
+// cannot be read or is empty.
+static Symbols tokenizeFile(const QByteArray &filename)
+{
+    QFile file(QString::fromLocal8Bit(filename.constData()));
+    if (!file.open(QFile::ReadOnly))
+        return Symbols();
+
+    QByteArray input = readOrMapFile(&file);
+    if (input.isEmpty())
+        return Symbols();
+
+    // phase 1: get rid of backslash-newlines
+    input = cleaned(input);
+
+    // phase 2: tokenize for the preprocessor
+    return Preprocessor::tokenize(input);
+}
+
+QByteArray IncludeCache::resolve(const QByteArray &include,
+                                 const QList<Parser::IncludePath> &includepaths)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = resolved.constFind(include);
+        if (it != resolved.constEnd())
+            return it.value();
+    }
+    // search outside of the lock; another thread finding the same
+    // file at the same time only does the work twice
+    const QByteArray path = searchIncludePaths(includepaths, include);
+    std::lock_guard<std::mutex> lock(mutex);
+    resolved.insert(include, path);
+    return path;
+}
+
+Symbols IncludeCache::tokenized(const QByteArray &filename)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = files.constFind(filename);
+        if (it != files.constEnd())
+            return it.value();
+    }
+    const Symbols symbols = tokenizeFile(filename);
+    std::lock_guard<std::mutex> lock(mutex);
+    files.insert(filename, symbols);
+    return symbols;
+}
+
 QByteArray Preprocessor::resolveInclude(const QByteArray &include, const QByteArray &relativeTo)
 {
     if (!relativeTo.isEmpty()) {
@@ -1043,6 +1093,9 @@ QByteArray Preprocessor::resolveInclude(const QByteArray &include, const QByteAr
             return fi.canonicalFilePath().toLocal8Bit();
     }
 
+    if (includeCache)
+        return includeCache->resolve(include, includes);
+
     auto it = nonlocalIncludePathResolutionCache.find(include);
     if (it == nonlocalIncludePathResolutionCache.end())
        it = nonlocalIncludePathResolutionCache.insert(include, searchIncludePaths(includes, include));
@@ -1077,26 +1130,15 @@ void Preprocessor::preprocess(const QByteArray &filename, Symbols &preprocessed)
                 continue;
             Preprocessor::preprocessedIncludes.insert(include);
 
-            QFile file(QString::fromLocal8Bit(include.constData()));
-            if (!file.open(QFile::ReadOnly))
-                continue;
-
-            QByteArray input = readOrMapFile(&file);
-
-            file.close();
-            if (input.isEmpty())
+            Symbols includedSymbols = includeCache ? includeCache->tokenized(include)
+                                                   : tokenizeFile(include);
+            if (includedSymbols.isEmpty())
                 continue;
 
             Symbols saveSymbols = symbols;
             int saveIndex = index;
 
-            // phase 1: get rid of backslash-newlines
-            input = cleaned(input);
-
-            // phase 2: tokenize for the preprocessor
-            symbols = tokenize(input);
-            input.clear();
-
+            symbols = std::move(includedSymbols);
             index = 0;
 
             // phase 3: preprocess conditions and substitute macros
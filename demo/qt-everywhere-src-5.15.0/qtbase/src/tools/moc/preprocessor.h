@@ -34,6 +34,8 @@
 #include <qset.h>
 #include <stdio.h>
 
+#include <mutex>
+
 QT_BEGIN_NAMESPACE
 
 struct Macro
@@ -54,11 +56,28 @@ typedef QHash<MacroName, Macro> Macros;
 
 class QFile;
 
+// The include lookups and tokenized include files of a moc --batch run.
+// All the files of a batch are processed with the same include paths, so
+// what one preprocessor found can be reused by the others. It is shared
+// between the threads of the run.
+class IncludeCache
+{
+public:
+    QByteArray resolve(const QByteArray &include, const QList<Parser::IncludePath> &includepaths);
+    Symbols tokenized(const QByteArray &filename);
+
+private:
+    std::mutex mutex;
+    QHash<QByteArray, QByteArray> resolved;
+    QHash<QByteArray, Symbols> files;
+};
+
 class Preprocessor : public Parser
 {
 public:
     Preprocessor(){}
     static bool preprocessOnly;
+    IncludeCache *includeCache = nullptr;
     QList<QByteArray> frameworks;
     QSet<QByteArray> preprocessedIncludes;
     QHash<QByteArray, QByteArray> nonlocalIncludePathResolutionCache;
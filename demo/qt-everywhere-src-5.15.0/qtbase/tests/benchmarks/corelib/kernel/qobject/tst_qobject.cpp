@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QObject>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+class Sender : public QObject
+{
+    Q_OBJECT
+signals:
+    void signal();
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public slots:
+    void slot() { }
+};
+
+// Measures emitting the signal of one object living in the main thread from
+// several threads at once, each emission reaching several receivers.
+class tst_QObject : public QObject
+{
+    Q_OBJECT
+public:
+    static QSemaphore started, go, finished;
+
+private slots:
+    void emitFromThreads_data();
+    void emitFromThreads();
+};
+
+QSemaphore tst_QObject::started;
+QSemaphore tst_QObject::go;
+QSemaphore tst_QObject::finished;
+
+class EmitThread : public QThread
+{
+    Sender *sender;
+    int iterations;
+public:
+    bool done = false;
+    EmitThread(Sender *sender, int iterations)
+        : sender(sender), iterations(iterations)
+    { }
+    void run() override
+    {
+        forever {
+            tst_QObject::started.release();
+            tst_QObject::go.acquire();
+            if (done)
+                break;
+            for (int i = 0; i < iterations; ++i)
+                emit sender->signal();
+            tst_QObject::finished.release();
+        }
+    }
+};
+
+void tst_QObject::emitFromThreads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("receiverCount");
+
+    QVector<int> threadCounts = { 1, 2, 4 };
+    if (QThread::idealThreadCount() > 4)
+        threadCounts << QThread::idealThreadCount();
+
+    for (int receivers : { 1, 10 }) {
+        for (int threads : threadCounts)
+            QTest::addRow("%d threads, %d receivers", threads, receivers) << threads << receivers;
+    }
+}
+
+void tst_QObject::emitFromThreads()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, receiverCount);
+    const int iterations = 10000;
+
+    Sender sender;
+    QVector<Receiver *> receivers(receiverCount);
+    for (Receiver *&r : receivers) {
+        r = new Receiver;
+        connect(&sender, &Sender::signal, r, &Receiver::slot, Qt::DirectConnection);
+    }
+
+    QVector<EmitThread *> threads(threadCount);
+    for (EmitThread *&t : threads) {
+        t = new EmitThread(&sender, iterations);
+        t->start();
+    }
+
+    QBENCHMARK {
+        started.acquire(threadCount);
+        go.release(threadCount);
+        finished.acquire(threadCount);
+    }
+
+    for (EmitThread *t : threads)
+        t->done = true;
+    started.acquire(threadCount);
+    go.release(threadCount);
+    for (EmitThread *t : threads) {
+        t->wait();
+        delete t;
+    }
+    qDeleteAll(receivers);
+}
+
+QTEST_MAIN(tst_QObject)
+
+#include "tst_qobject.moc"
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QStringMatcher>
+#include <QtTest/QtTest>
+
+// Filters a list of rows the way a filter-as-you-type view does: a
+// case-insensitive contains() on every row, for each needle
+class tst_QStringMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void containsCaseInsensitive_data();
+    void containsCaseInsensitive();
+    void matcherCaseInsensitive_data() { containsCaseInsensitive_data(); }
+    void matcherCaseInsensitive();
+    void indexOfCharCaseInsensitive_data();
+    void indexOfCharCaseInsensitive();
+};
+
+static QStringList rows(bool latin1)
+{
+    static const char *const words[] = {
+        "Alpha", "bravo", "Charlie", "delta", "ECHO", "foxtrot", "Golf", "hotel",
+        "India", "juliett", "Kilo", "lima", "MIKE", "november", "Oscar", "papa"
+    };
+    QStringList result;
+    result.reserve(200000);
+    for (int i = 0; i < 200000; ++i) {
+        QString row;
+        for (int j = 0; j < 5; ++j) {
+            row += QLatin1String(words[(i * 7 + j * 3) % 16]);
+            row += QLatin1Char(' ');
+        }
+        if (!latin1)
+            row += QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87\xe6\xa0\x87\xe9\xa2\x98 ");   // CJK text
+        row += QString::number(i);
+        result.append(row);
+    }
+    return result;
+}
+
+void tst_QStringMatcher::containsCaseInsensitive_data()
+{
+    QTest::addColumn<bool>("latin1");
+    QTest::addColumn<QString>("needle");
+
+    for (bool latin1 : { true, false }) {
+        const QByteArray tag = latin1 ? "latin1:" : "mixed:";
+        QTest::newRow(tag + "1 char") << latin1 << QStringLiteral("k");
+        QTest::newRow(tag + "3 chars") << latin1 << QStringLiteral("OSC");
+        QTest::newRow(tag + "8 chars") << latin1 << QStringLiteral("november");
+        QTest::newRow(tag + "miss") << latin1 << QStringLiteral("zulu");
+    }
+}
+
+void tst_QStringMatcher::containsCaseInsensitive()
+{
+    QFETCH(bool, latin1);
+    QFETCH(QString, needle);
+
+    const QStringList haystacks = rows(latin1);
+    int count = 0;
+    QBENCHMARK {
+        for (const QString &row : haystacks)
+            count += row.contains(needle, Qt::CaseInsensitive);
+    }
+    QVERIFY(count >= 0);
+}
+
+void tst_QStringMatcher::matcherCaseInsensitive()
+{
+    QFETCH(bool, latin1);
+    QFETCH(QString, needle);
+
+    const QStringList haystacks = rows(latin1);
+    const QStringMatcher matcher(needle, Qt::CaseInsensitive);
+    int count = 0;
+    QBENCHMARK {
+        for (const QString &row : haystacks)
+            count += matcher.indexIn(row) != -1;
+    }
+    QVERIFY(count >= 0);
+}
+
+void tst_QStringMatcher::indexOfCharCaseInsensitive_data()
+{
+    QTest::addColumn<bool>("latin1");
+    QTest::addColumn<QChar>("needle");
+
+    QTest::newRow("latin1:hit") << true << QChar('K');
+    QTest::newRow("latin1:miss") << true << QChar('z');
+    QTest::newRow("mixed:hit") << false << QChar('K');
+    QTest::newRow("mixed:miss") << false << QChar('z');
+}
+
+void tst_QStringMatcher::indexOfCharCaseInsensitive()
+{
+    QFETCH(bool, latin1);
+    QFETCH(QChar, needle);
+
+    const QStringList haystacks = rows(latin1);
+    qsizetype sum = 0;
+    QBENCHMARK {
+        for (const QString &row : haystacks)
+            sum += row.indexOf(needle, 0, Qt::CaseInsensitive);
+    }
+    QVERIFY(sum != 0);
+}
+
+QTEST_MAIN(tst_QStringMatcher)
+#include "tst_qstringmatcher.moc"
@@ -0,0 +1,278 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QFlatHash>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+// Compares QFlatHash against QHash. Each benchmark runs once per container,
+// selected by the "flat" column.
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertInt_data() { data(); }
+    void insertInt();
+    void insertReservedInt_data() { data(); }
+    void insertReservedInt();
+    void lookupHitInt_data() { data(); }
+    void lookupHitInt();
+    void lookupMissInt_data() { data(); }
+    void lookupMissInt();
+    void iterateInt_data() { data(); }
+    void iterateInt();
+    void eraseInt_data() { data(); }
+    void eraseInt();
+
+    void insertString_data() { data(); }
+    void insertString();
+    void lookupHitString_data() { data(); }
+    void lookupHitString();
+    void lookupMissString_data() { data(); }
+    void lookupMissString();
+
+private:
+    void data();
+};
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<bool>("flat");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 100, 10000, 1000000 }) {
+        const QByteArray n = QByteArray::number(size);
+        QTest::newRow("QHash:" + n) << false << size;
+        QTest::newRow("QFlatHash:" + n) << true << size;
+    }
+}
+
+// Spreads the keys over the whole int range, without collisions
+static int intKey(int i)
+{
+    return int(uint(i) * 2654435761u);
+}
+
+static QVector<QString> stringKeys(int size, const QString &prefix)
+{
+    QVector<QString> keys;
+    keys.reserve(size);
+    for (int i = 0; i < size; ++i)
+        keys.append(prefix + QString::number(intKey(i), 16));
+    return keys;
+}
+
+template <typename Hash>
+static Hash intHash(int size)
+{
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(intKey(i), i);
+    return hash;
+}
+
+template <typename Hash>
+static void insertInt(int size, bool reserve)
+{
+    QBENCHMARK {
+        Hash hash;
+        if (reserve)
+            hash.reserve(size);
+        for (int i = 0; i < size; ++i)
+            hash.insert(intKey(i), i);
+    }
+}
+
+void tst_QFlatHash::insertInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        ::insertInt<QFlatHash<int, int> >(size, false);
+    else
+        ::insertInt<QHash<int, int> >(size, false);
+}
+
+void tst_QFlatHash::insertReservedInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        ::insertInt<QFlatHash<int, int> >(size, true);
+    else
+        ::insertInt<QHash<int, int> >(size, true);
+}
+
+template <typename Hash>
+static void lookupInt(int size, int offset)
+{
+    const Hash hash = intHash<Hash>(size);
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < size; ++i)
+            found += hash.contains(intKey(i + offset));
+    }
+    QCOMPARE(found > 0, offset == 0);
+}
+
+void tst_QFlatHash::lookupHitInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        lookupInt<QFlatHash<int, int> >(size, 0);
+    else
+        lookupInt<QHash<int, int> >(size, 0);
+}
+
+void tst_QFlatHash::lookupMissInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        lookupInt<QFlatHash<int, int> >(size, size);
+    else
+        lookupInt<QHash<int, int> >(size, size);
+}
+
+template <typename Hash>
+static void iterateInt(int size)
+{
+    const Hash hash = intHash<Hash>(size);
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (typename Hash::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum > 0 || size < 2);
+}
+
+void tst_QFlatHash::iterateInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        ::iterateInt<QFlatHash<int, int> >(size);
+    else
+        ::iterateInt<QHash<int, int> >(size);
+}
+
+template <typename Hash>
+static void eraseInt(int size)
+{
+    const Hash original = intHash<Hash>(size);
+    QBENCHMARK {
+        Hash hash = original;
+        for (int i = 0; i < size; i += 2)
+            hash.remove(intKey(i));
+    }
+}
+
+void tst_QFlatHash::eraseInt()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        ::eraseInt<QFlatHash<int, int> >(size);
+    else
+        ::eraseInt<QHash<int, int> >(size);
+}
+
+template <typename Hash>
+static void insertString(int size)
+{
+    const QVector<QString> keys = stringKeys(size, QStringLiteral("key"));
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < size; ++i)
+            hash.insert(keys.at(i), i);
+    }
+}
+
+void tst_QFlatHash::insertString()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        ::insertString<QFlatHash<QString, int> >(size);
+    else
+        ::insertString<QHash<QString, int> >(size);
+}
+
+template <typename Hash>
+static void lookupString(int size, bool hit)
+{
+    const QVector<QString> keys = stringKeys(size, QStringLiteral("key"));
+    const QVector<QString> lookups = hit ? keys : stringKeys(size, QStringLiteral("other"));
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(keys.at(i), i);
+
+    int found = 0;
+    QBENCHMARK {
+        for (const QString &key : lookups)
+            found += hash.contains(key);
+    }
+    QCOMPARE(found > 0, hit);
+}
+
+void tst_QFlatHash::lookupHitString()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        lookupString<QFlatHash<QString, int> >(size, true);
+    else
+        lookupString<QHash<QString, int> >(size, true);
+}
+
+void tst_QFlatHash::lookupMissString()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    if (flat)
+        lookupString<QFlatHash<QString, int> >(size, false);
+    else
+        lookupString<QHash<QString, int> >(size, false);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
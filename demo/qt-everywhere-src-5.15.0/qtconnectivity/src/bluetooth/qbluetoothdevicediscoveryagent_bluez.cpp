@@ -135,6 +135,7 @@ void QBluetoothDeviceDiscoveryAgentPrivate::start(QBluetoothDeviceDiscoveryAgent
     }
 
     discoveredDevices.clear();
+    discoveredDeviceIndex.clear();
     devicesProperties.clear();
 
     if (managerBluez5) {
@@ -395,22 +396,21 @@ void QBluetoothDeviceDiscoveryAgentPrivate::_q_deviceFound(const QString &addres
         device.setCoreConfigurations(QBluetoothDeviceInfo::LowEnergyCoreConfiguration);
     else
         device.setCoreConfigurations(QBluetoothDeviceInfo::BaseRateCoreConfiguration);
-    for (int i = 0; i < discoveredDevices.size(); i++) {
-        if (discoveredDevices[i].address() == device.address()) {
-            if (discoveredDevices[i] == device) {
-                qCDebug(QT_BT_BLUEZ) << "Duplicate: " << address;
-                return;
-            }
-            discoveredDevices.replace(i, device);
-            Q_Q(QBluetoothDeviceDiscoveryAgent);
-            qCDebug(QT_BT_BLUEZ) << "Updated: " << address;
-
-            emit q->deviceDiscovered(device);
-            return; // this works if the list doesn't contain duplicates. Don't let it.
+    const int i = indexOfDiscoveredDevice(device.address());
+    if (i != -1) {
+        if (discoveredDevices[i] == device) {
+            qCDebug(QT_BT_BLUEZ) << "Duplicate: " << address;
+            return;
         }
+        discoveredDevices.replace(i, device);
+        Q_Q(QBluetoothDeviceDiscoveryAgent);
+        qCDebug(QT_BT_BLUEZ) << "Updated: " << address;
+
+        emit q->deviceDiscovered(device);
+        return;
     }
     qCDebug(QT_BT_BLUEZ) << "Emit: " << address;
-    discoveredDevices.append(device);
+    appendDiscoveredDevice(device);
     Q_Q(QBluetoothDeviceDiscoveryAgent);
     emit q->deviceDiscovered(device);
 }
@@ -490,23 +490,39 @@ void QBluetoothDeviceDiscoveryAgentPrivate::deviceFoundBluez5(const QString &dev
     // Cache the properties so we do not have to access dbus every time to get a value
     devicesProperties[devicePath] = properties;
 
-    for (int i = 0; i < discoveredDevices.size(); i++) {
-        if (discoveredDevices[i].address() == deviceInfo.address()) {
-            if (lowEnergySearchTimeout > 0 && discoveredDevices[i] == deviceInfo) {
-                qCDebug(QT_BT_BLUEZ) << "Duplicate: " << deviceInfo.address();
-                return;
-            }
-            discoveredDevices.replace(i, deviceInfo);
-
-            emit q->deviceDiscovered(deviceInfo);
-            return; // this works if the list doesn't contain duplicates. Don't let it.
+    const int i = indexOfDiscoveredDevice(deviceInfo.address());
+    if (i != -1) {
+        if (lowEnergySearchTimeout > 0 && discoveredDevices[i] == deviceInfo) {
+            qCDebug(QT_BT_BLUEZ) << "Duplicate: " << deviceInfo.address();
+            return;
         }
+        discoveredDevices.replace(i, deviceInfo);
+
+        emit q->deviceDiscovered(deviceInfo);
+        return;
     }
 
-    discoveredDevices.append(deviceInfo);
+    appendDiscoveredDevice(deviceInfo);
     emit q->deviceDiscovered(deviceInfo);
 }
 
+/*
+ * discoveredDevices never contains the same address twice. The index
+ * avoids scanning the whole list for every advertisement, which matters
+ * when many devices are around.
+ */
+int QBluetoothDeviceDiscoveryAgentPrivate::indexOfDiscoveredDevice(
+        const QBluetoothAddress &address) const
+{
+    return discoveredDeviceIndex.value(address.toUInt64(), -1);
+}
+
+void QBluetoothDeviceDiscoveryAgentPrivate::appendDiscoveredDevice(const QBluetoothDeviceInfo &info)
+{
+    discoveredDeviceIndex.insert(info.address().toUInt64(), discoveredDevices.size());
+    discoveredDevices.append(info);
+}
+
 void QBluetoothDeviceDiscoveryAgentPrivate::_q_propertyChanged(const QString &name,
                                                                const QDBusVariant &value)
 {
@@ -663,63 +679,62 @@ void QBluetoothDeviceDiscoveryAgentPrivate::_q_PropertiesChanged(const QString &
     for (const QString & property : invalidated_properties)
         properties.remove(property);
 
-    const auto info = createDeviceInfoFromBluez5Device(properties);
-    if (!info.isValid())
-        return;
-
     if (changed_properties.contains(QStringLiteral("RSSI"))
         || changed_properties.contains(QStringLiteral("ManufacturerData"))) {
 
-        for (int i = 0; i < discoveredDevices.size(); i++) {
-            if (discoveredDevices[i].address() == info.address()) {
-                QBluetoothDeviceInfo::Fields updatedFields = QBluetoothDeviceInfo::Field::None;
-                if (changed_properties.contains(QStringLiteral("RSSI"))) {
-                    qCDebug(QT_BT_BLUEZ) << "Updating RSSI for" << info.address()
-                                         << changed_properties.value(QStringLiteral("RSSI"));
-                    discoveredDevices[i].setRssi(
-                                changed_properties.value(QStringLiteral("RSSI")).toInt());
-                    updatedFields.setFlag(QBluetoothDeviceInfo::Field::RSSI);
-                }
-                if (changed_properties.contains(QStringLiteral("ManufacturerData"))) {
-                    qCDebug(QT_BT_BLUEZ) << "Updating ManufacturerData for" << info.address();
-                    ManufacturerDataList changedManufacturerData =
-                            qdbus_cast< ManufacturerDataList >(changed_properties.value(QStringLiteral("ManufacturerData")));
-
-                    const QList<quint16> keys = changedManufacturerData.keys();
-                    bool wasNewValue = false;
-                    for (quint16 key : keys) {
-                        bool added = discoveredDevices[i].setManufacturerData(key, changedManufacturerData.value(key).variant().toByteArray());
-                        wasNewValue = (wasNewValue || added);
-                    }
-
-                    if (wasNewValue)
-                        updatedFields.setFlag(QBluetoothDeviceInfo::Field::ManufacturerData);
-                }
+        const auto info = createDeviceInfoFromBluez5Device(properties);
+        if (!info.isValid())
+            return;
 
-                if (lowEnergySearchTimeout > 0) {
-                    if (discoveredDevices[i] != info) { // field other than manufacturer or rssi changed
-                        if (discoveredDevices.at(i).name() == info.name()) {
-                            qCDebug(QT_BT_BLUEZ) << "Almost Duplicate " << info.address()
-                                                   << info.name() << "- replacing in place";
-                            discoveredDevices.replace(i, info);
-                            emit q->deviceDiscovered(info);
-                        }
-                    } else {
-                        if (!updatedFields.testFlag(QBluetoothDeviceInfo::Field::None))
-                            emit q->deviceUpdated(discoveredDevices[i], updatedFields);
-                    }
+        const int i = indexOfDiscoveredDevice(info.address());
+        if (i == -1)
+            return;
 
-                    return;
-                }
+        QBluetoothDeviceInfo::Fields updatedFields = QBluetoothDeviceInfo::Field::None;
+        if (changed_properties.contains(QStringLiteral("RSSI"))) {
+            qCDebug(QT_BT_BLUEZ) << "Updating RSSI for" << info.address()
+                                 << changed_properties.value(QStringLiteral("RSSI"));
+            discoveredDevices[i].setRssi(
+                        changed_properties.value(QStringLiteral("RSSI")).toInt());
+            updatedFields.setFlag(QBluetoothDeviceInfo::Field::RSSI);
+        }
+        if (changed_properties.contains(QStringLiteral("ManufacturerData"))) {
+            qCDebug(QT_BT_BLUEZ) << "Updating ManufacturerData for" << info.address();
+            ManufacturerDataList changedManufacturerData =
+                    qdbus_cast< ManufacturerDataList >(changed_properties.value(QStringLiteral("ManufacturerData")));
+
+            const QList<quint16> keys = changedManufacturerData.keys();
+            bool wasNewValue = false;
+            for (quint16 key : keys) {
+                bool added = discoveredDevices[i].setManufacturerData(key, changedManufacturerData.value(key).variant().toByteArray());
+                wasNewValue = (wasNewValue || added);
+            }
 
-                discoveredDevices.replace(i, info);
-                emit q_ptr->deviceDiscovered(discoveredDevices[i]);
+            if (wasNewValue)
+                updatedFields.setFlag(QBluetoothDeviceInfo::Field::ManufacturerData);
+        }
 
+        if (lowEnergySearchTimeout > 0) {
+            if (discoveredDevices[i] != info) { // field other than manufacturer or rssi changed
+                if (discoveredDevices.at(i).name() == info.name()) {
+                    qCDebug(QT_BT_BLUEZ) << "Almost Duplicate " << info.address()
+                                           << info.name() << "- replacing in place";
+                    discoveredDevices.replace(i, info);
+                    emit q->deviceDiscovered(info);
+                }
+            } else {
                 if (!updatedFields.testFlag(QBluetoothDeviceInfo::Field::None))
                     emit q->deviceUpdated(discoveredDevices[i], updatedFields);
-                return;
             }
+
+            return;
         }
+
+        discoveredDevices.replace(i, info);
+        emit q_ptr->deviceDiscovered(discoveredDevices[i]);
+
+        if (!updatedFields.testFlag(QBluetoothDeviceInfo::Field::None))
+            emit q->deviceUpdated(discoveredDevices[i], updatedFields);
     }
 }
 QT_END_NAMESPACE
@@ -70,6 +70,7 @@
 #include <QtBluetooth/QBluetoothLocalDevice>
 
 #if QT_CONFIG(bluez)
+#include <QtCore/QHash>
 #include "bluez/bluez5_helper_p.h"
 
 class OrgBluezManagerInterface;
@@ -187,9 +188,14 @@ private:
     void deviceFoundBluez5(const QString &devicePath, const QVariantMap &properties);
     void startBluez5(QBluetoothDeviceDiscoveryAgent::DiscoveryMethods methods);
 
+    int indexOfDiscoveredDevice(const QBluetoothAddress &address) const;
+    void appendDiscoveredDevice(const QBluetoothDeviceInfo &info);
+
     bool useExtendedDiscovery;
     QTimer extendedDiscoveryTimer;
     QMap<QString, QVariantMap> devicesProperties;
+    // position of each device in discoveredDevices, keyed by address
+    QHash<quint64, int> discoveredDeviceIndex;
 #endif
 
 #ifdef QT_WIN_BLUETOOTH
@@ -58,6 +58,7 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QSettings>
+#include <QtCore/QSocketNotifier>
 #include <QtCore/QTimer>
 #include <QtBluetooth/QBluetoothLocalDevice>
 #include <QtBluetooth/QBluetoothSocket>
@@ -533,6 +534,7 @@ void QLowEnergyControllerPrivateBluez::connectToDevice()
     }
 
     setState(QLowEnergyController::ConnectingState);
+    discardUnsentPackets();
     if (l2cpSocket) {
         delete l2cpSocket;
         l2cpSocket = nullptr;
@@ -807,6 +809,7 @@ void QLowEnergyControllerPrivateBluez::resetController()
     mtuSize = ATT_DEFAULT_LE_MTU;
     securityLevelValue = -1;
     connectionHandle = 0;
+    discardUnsentPackets();
 
     if (role == QLowEnergyController::PeripheralRole) {
         // public API behavior requires stop of advertisement
@@ -976,22 +979,68 @@ void QLowEnergyControllerPrivateBluez::encryptionChangedEvent(
 }
 
 void QLowEnergyControllerPrivateBluez::sendPacket(const QByteArray &packet)
+{
+    // Packets must leave in order, therefore anything sent while older
+    // packets are still waiting for the socket is queued behind them
+    if (unsentPackets.isEmpty() && writePacket(packet) != 0)
+        return;
+
+    // The send buffer is full (EAGAIN). This typically happens when write
+    // commands are issued faster than the link can carry them. Rather than
+    // dropping the packet, hold it back until the socket is writable again.
+    unsentPackets.enqueue(packet);
+    if (!writeNotifier) {
+        writeNotifier = new QSocketNotifier(l2cpSocket->socketDescriptor(),
+                                            QSocketNotifier::Write, this);
+        connect(writeNotifier, &QSocketNotifier::activated, this,
+                &QLowEnergyControllerPrivateBluez::sendUnsentPackets);
+    }
+    writeNotifier->setEnabled(true);
+}
+
+/*!
+ * Writes \a packet to the socket and returns the result of the write.
+ * 0 means the socket could not take the packet right now.
+ */
+qint64 QLowEnergyControllerPrivateBluez::writePacket(const QByteArray &packet)
 {
     qint64 result = l2cpSocket->write(packet.constData(),
                                       packet.size());
-    // We ignore result == 0 which is likely to be caused by EAGAIN.
-    // This packet is effectively discarded but the controller can still recover
 
     if (result == -1) {
         qCDebug(QT_BT_BLUEZ) << "Cannot write L2CP packet:" << hex
                              << packet.toHex()
                              << l2cpSocket->errorString();
         setError(QLowEnergyController::NetworkError);
-    } else if (result < packet.size()) {
+    } else if (result > 0 && result < packet.size()) {
         qCWarning(QT_BT_BLUEZ) << "L2CP write request incomplete:"
                                << result << "of" << packet.size();
     }
 
+    return result;
+}
+
+void QLowEnergyControllerPrivateBluez::sendUnsentPackets()
+{
+    while (!unsentPackets.isEmpty()) {
+        const qint64 result = writePacket(unsentPackets.head());
+        if (result == 0)
+            return; // still full, wait for the next notification
+        if (result < 0) {
+            discardUnsentPackets();
+            return;
+        }
+        unsentPackets.dequeue();
+    }
+
+    writeNotifier->setEnabled(false);
+}
+
+void QLowEnergyControllerPrivateBluez::discardUnsentPackets()
+{
+    unsentPackets.clear();
+    delete writeNotifier;
+    writeNotifier = nullptr;
 }
 
 void QLowEnergyControllerPrivateBluez::sendNextPendingRequest()
@@ -3115,6 +3164,7 @@ void QLowEnergyControllerPrivateBluez::handleConnectionRequest()
     if (connectionHandle == 0)
         qCWarning(QT_BT_BLUEZ) << "Received client connection, but no connection complete event";
 
+    discardUnsentPackets();
     if (l2cpSocket) {
         disconnect(l2cpSocket);
         if (l2cpSocket->isOpen())
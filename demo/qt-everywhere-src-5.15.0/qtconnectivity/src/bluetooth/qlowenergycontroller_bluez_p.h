@@ -145,6 +145,11 @@ private:
     };
     QQueue<Request> openRequests;
 
+    // Packets which could not be written yet because the socket's send
+    // buffer was full. They are flushed in order once it becomes writable.
+    QQueue<QByteArray> unsentPackets;
+    QSocketNotifier *writeNotifier = nullptr;
+
     struct WriteRequest {
         WriteRequest() {}
         WriteRequest(quint16 h, quint16 o, const QByteArray &v)
@@ -236,6 +241,8 @@ private:
     QString keySettingsFilePath() const;
 
     void sendPacket(const QByteArray &packet);
+    qint64 writePacket(const QByteArray &packet);
+    void discardUnsentPackets();
     void sendNextPendingRequest();
     void processReply(const Request &request, const QByteArray &reply);
 
@@ -345,6 +352,7 @@ private slots:
     void l2cpDisconnected();
     void l2cpErrorChanged(QBluetoothSocket::SocketError);
     void l2cpReadyRead();
+    void sendUnsentPackets();
     void encryptionChangedEvent(const QBluetoothAddress&, bool);
     void handleGattRequestTimeout();
     void activeConnectionTerminationDone();
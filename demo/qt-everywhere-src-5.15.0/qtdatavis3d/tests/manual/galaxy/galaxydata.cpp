@@ -51,11 +51,10 @@
 
 using namespace QtDataVisualization;
 
-static const int numOfStars = 70000;
-static const int numOfDust = numOfStars / 2;
 static const int numOfH2 = 200;
 
 GalaxyData::GalaxyData(Q3DScatter *scatter,
+                       int numOfStars,
                        qreal rad,
                        qreal radCore,
                        qreal deltaAng,
@@ -65,6 +64,8 @@ GalaxyData::GalaxyData(Q3DScatter *scatter,
       m_pStars(0),
       m_pDust(0),
       m_pH2(0),
+      m_numOfStars(qMax(numOfStars, 3)),
+      m_numOfDust(m_numOfStars / 2),
       m_radGalaxy(rad),
       m_radCore(radCore),
       m_angleOffset(deltaAng),
@@ -111,11 +112,11 @@ void GalaxyData::createGalaxy()
 {
     if (m_pStars)
         delete [] m_pStars;
-    m_pStars = new Star[numOfStars];
+    m_pStars = new Star[m_numOfStars];
 
     if (m_pDust)
         delete [] m_pDust;
-    m_pDust = new Star[numOfDust];
+    m_pDust = new Star[m_numOfDust];
 
     if (m_pH2)
         delete [] m_pH2;
@@ -162,7 +163,7 @@ void GalaxyData::createGalaxy()
                       m_radFarField,   // ende der intensitätskurve
                       1000.0);           // Anzahl der stützstellen
 
-    for (int i = 3; i < numOfStars; ++i) {
+    for (int i = 3; i < m_numOfStars; ++i) {
         qreal rad = cd.valFromProp(QRandomGenerator::global()->generateDouble());
 
         m_pStars[i].m_a = rad;
@@ -177,7 +178,7 @@ void GalaxyData::createGalaxy()
 
     // Initialize Dust
     qreal x, y, rad;
-    for (int i = 0; i < numOfDust; ++i)
+    for (int i = 0; i < m_numOfDust; ++i)
     {
         x = 2.0 * m_radGalaxy * QRandomGenerator::global()->generateDouble() - m_radGalaxy;
         y = 2.0 * m_radGalaxy * QRandomGenerator::global()->generateDouble() - m_radGalaxy;
@@ -257,10 +258,10 @@ void GalaxyData::createSeries()
 void GalaxyData::createNormalDataView()
 {
     QScatterDataArray *dataArray = new QScatterDataArray;
-    dataArray->resize(numOfStars);
+    dataArray->resize(m_numOfStars);
     QScatterDataItem *ptrToDataArray = &dataArray->first();
 
-    for (uint i = 0; i < numOfStars; i++) {
+    for (int i = 0; i < m_numOfStars; i++) {
         ptrToDataArray->setPosition(QVector3D(m_pStars[i].m_pos.x(),
                                               0.0f,
                                               m_pStars[i].m_pos.y()));
@@ -272,10 +273,10 @@ void GalaxyData::createNormalDataView()
     m_normalSeries->setBaseColor(Qt::white);
 
     dataArray = new QScatterDataArray;
-    dataArray->resize(numOfDust);
+    dataArray->resize(m_numOfDust);
     ptrToDataArray = &dataArray->first();
 
-    for (uint i = 0; i < numOfDust; i++) {
+    for (int i = 0; i < m_numOfDust; i++) {
         ptrToDataArray->setPosition(QVector3D(m_pDust[i].m_pos.x(),
                                               0.0f,
                                               m_pDust[i].m_pos.y()));
@@ -286,11 +287,11 @@ void GalaxyData::createNormalDataView()
     m_dustSeries->setMesh(QAbstract3DSeries::MeshPoint);
     m_dustSeries->setBaseColor(QColor(131, 111, 255));
 
+    uint H2Count = numOfH2 * 2;
     dataArray = new QScatterDataArray;
-    dataArray->resize(numOfDust);
+    dataArray->resize(H2Count);
     ptrToDataArray = &dataArray->first();
 
-    uint H2Count = numOfH2 * 2;
     for (uint i = 0; i < H2Count; i++) {
         ptrToDataArray->setPosition(QVector3D(m_pH2[i].m_pos.x(),
                                               0.0f,
@@ -313,7 +314,7 @@ void GalaxyData::createFilteredView()
     qreal add = qreal(m_range);
     int max = 0;
 
-    for (uint i = 0; i < numOfStars; i++) {
+    for (int i = 0; i < m_numOfStars; i++) {
         int x = int(m_pStars[i].m_pos.x() + add) / 1000;
         int y = int(m_pStars[i].m_pos.y() + add) / 1000;
         table[y * steps + x] = table[y * steps + x] + 1;
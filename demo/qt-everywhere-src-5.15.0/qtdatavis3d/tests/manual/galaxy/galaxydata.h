@@ -45,6 +45,7 @@ class GalaxyData : public QObject
     Q_OBJECT
 public:
     explicit GalaxyData(Q3DScatter *scatter,
+                        int numOfStars = 70000,
                         qreal rad = 13000,
                         qreal radCore = 4000.0,
                         qreal deltaAng = 0.0004,
@@ -97,6 +98,8 @@ private:
     Star *m_pStars;
     Star *m_pDust;
     Star *m_pH2;
+    int m_numOfStars;
+    int m_numOfDust;
 
     qreal m_elEx1;          // Excentricity of the innermost ellipse
     qreal m_elEx2;          // Excentricity of the outermost ellipse
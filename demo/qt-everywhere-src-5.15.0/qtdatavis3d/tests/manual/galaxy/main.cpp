@@ -137,7 +137,13 @@ int main(int argc, char **argv)
     vLayout->addWidget(filteredCheckBox);
     vLayout->addWidget(fpsLabel);
 
-    GalaxyData *modifier = new GalaxyData(graph);
+    // The number of stars can be given on the command line, to use this as
+    // a benchmark for large scatter series.
+    int numOfStars = 70000;
+    if (argc > 1)
+        numOfStars = qMax(QByteArray(argv[1]).toInt(), 3);
+
+    GalaxyData *modifier = new GalaxyData(graph, numOfStars);
 
     QObject::connect(radiusGalaxySlider, &QSlider::valueChanged,
                      modifier, &GalaxyData::radiusGalaxyChanged);
@@ -197,29 +197,47 @@ void QQuickParticleAffector::affectSystem(qreal dt)
     updateOffsets();//### Needed if an ancestor is transformed.
     if (m_onceOff)
         dt = 1.0;
-    foreach (QQuickParticleGroupData* gd, m_system->groupData) {
-        if (activeGroup(gd->index)) {
-            foreach (QQuickParticleData* d, gd->data) {
-                if (shouldAffect(d)) {
-                    bool affected = false;
-                    qreal myDt = dt;
-                    if (!m_ignoresTime && myDt < simulationCutoff) {
-                        int realTime = m_system->timeInt;
-                        m_system->timeInt -= myDt * 1000.0;
-                        while (myDt > simulationDelta) {
-                            m_system->timeInt += simulationDelta * 1000.0;
-                            if (d->alive(m_system))//Only affect during the parts it was alive for
-                                affected = affectParticle(d, simulationDelta) || affected;
-                            myDt -= simulationDelta;
-                        }
-                        m_system->timeInt = realTime;
-                    }
-                    if (myDt > 0.0)
-                        affected = affectParticle(d, myDt) || affected;
-                    if (affected)
-                        postAffect(d);
+
+    //Same checks as shouldAffect(), but with the per frame parts done once instead of per particle
+    const bool checkArea = width() != 0 && height() != 0;
+    const QRectF area(m_offset.x(), m_offset.y(), width(), height());
+    const bool checkCollisions = !m_whenCollidingWith.isEmpty();
+
+    //Copies, since affecting can move particles between groups
+    const auto groups = m_system->groupData;
+    for (QQuickParticleGroupData *gd : groups) {
+        if (!activeGroup(gd->index))
+            continue;
+        const QVector<QQuickParticleData*> data = gd->data;
+        for (QQuickParticleData *d : data) {
+            if (!d || !d->stillAlive(m_system))
+                continue;
+            if (d->groupId != gd->index && !activeGroup(d->groupId))
+                continue;
+            if (m_onceOff && m_onceOffed.contains(qMakePair(d->groupId, d->index)))
+                continue;
+            if (checkArea && !m_shape->contains(area, QPointF(d->curX(m_system), d->curY(m_system))))
+                continue;
+            if (checkCollisions && !isColliding(d))
+                continue;
+
+            bool affected = false;
+            qreal myDt = dt;
+            if (!m_ignoresTime && myDt < simulationCutoff) {
+                int realTime = m_system->timeInt;
+                m_system->timeInt -= myDt * 1000.0;
+                while (myDt > simulationDelta) {
+                    m_system->timeInt += simulationDelta * 1000.0;
+                    if (d->alive(m_system))//Only affect during the parts it was alive for
+                        affected = affectParticle(d, simulationDelta) || affected;
+                    myDt -= simulationDelta;
                 }
+                m_system->timeInt = realTime;
             }
+            if (myDt > 0.0)
+                affected = affectParticle(d, myDt) || affected;
+            if (affected)
+                postAffect(d);
         }
     }
 }
@@ -62,7 +62,8 @@ SOURCES += \
     $$PWD/qv4value.cpp \
     $$PWD/qv4compilationunitmapper.cpp \
     $$PWD/qv4executablecompilationunit.cpp \
-    $$PWD/qv4executableallocator.cpp
+    $$PWD/qv4executableallocator.cpp \
+    $$PWD/qv4sampler.cpp
 
 qtConfig(qml-debug): SOURCES += $$PWD/qv4profiling.cpp
 
@@ -123,6 +124,7 @@ HEADERS += \
     $$PWD/qv4include_p.h \
     $$PWD/qv4qobjectwrapper_p.h \
     $$PWD/qv4profiling_p.h \
+    $$PWD/qv4sampler_p.h \
     $$PWD/qv4arraybuffer_p.h \
     $$PWD/qv4typedarray_p.h \
     $$PWD/qv4dataview_p.h \
@@ -52,6 +52,7 @@
 //
 
 #include <private/qv4global_p.h>
+#include <private/qv4executablecompilationunit_p.h>
 #include <QFile>
 
 QT_BEGIN_NAMESPACE
@@ -68,7 +69,8 @@ public:
     CompilationUnitMapper();
     ~CompilationUnitMapper();
 
-    CompiledData::Unit *open(const QString &cacheFilePath, const QDateTime &sourceTimeStamp, QString *errorString);
+    CompiledData::Unit *open(const QString &cacheFilePath, const QDateTime &sourceTimeStamp, QString *errorString,
+                             ExecutableCompilationUnit::SourceCheck check = ExecutableCompilationUnit::SourceCheck::TimeStamp);
     void close();
 
 private:
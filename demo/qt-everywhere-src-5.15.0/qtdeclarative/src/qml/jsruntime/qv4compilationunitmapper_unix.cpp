@@ -51,7 +51,8 @@ QT_BEGIN_NAMESPACE
 
 using namespace QV4;
 
-CompiledData::Unit *CompilationUnitMapper::open(const QString &cacheFileName, const QDateTime &sourceTimeStamp, QString *errorString)
+CompiledData::Unit *CompilationUnitMapper::open(const QString &cacheFileName, const QDateTime &sourceTimeStamp, QString *errorString,
+                                                ExecutableCompilationUnit::SourceCheck check)
 {
     close();
 
@@ -73,7 +74,7 @@ CompiledData::Unit *CompilationUnitMapper::open(const QString &cacheFileName, co
         return nullptr;
     }
 
-    if (!ExecutableCompilationUnit::verifyHeader(&header, sourceTimeStamp, errorString))
+    if (!ExecutableCompilationUnit::verifyHeader(&header, sourceTimeStamp, errorString, check))
         return nullptr;
 
     // Data structure and qt version matched, so now we can access the rest of the file safely.
@@ -83,6 +83,7 @@
 #include <qv4identifiertable_p.h>
 #include "qv4debugging_p.h"
 #include "qv4profiling_p.h"
+#include "qv4sampler_p.h"
 #include "qv4executableallocator_p.h"
 #include "qv4iterator_p.h"
 #include "qv4stringiterator_p.h"
@@ -346,6 +347,8 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
             jitCallCountThreshold = std::numeric_limits<int>::max();
     }
 
+    m_sampler.reset(Profiling::Sampler::createFromEnvironment());
+
     exceptionValue = jsAlloca(1);
     *exceptionValue = Encode::undefined();
     globalObject = static_cast<Object *>(jsAlloca(1));
@@ -810,6 +813,8 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
 
 ExecutionEngine::~ExecutionEngine()
 {
+    // reports the samples, which needs the functions' compilation units
+    m_sampler.reset();
     modules.clear();
     qDeleteAll(m_extensionData);
     delete m_multiplyWrappedQObjects;
@@ -854,6 +859,11 @@ void ExecutionEngine::setProfiler(Profiling::Profiler *profiler)
 }
 #endif // QT_CONFIG(qml_debug)
 
+void ExecutionEngine::setSampler(Profiling::Sampler *sampler)
+{
+    m_sampler.reset(sampler);
+}
+
 void ExecutionEngine::initRootContext()
 {
     Scope scope(this);
@@ -1273,6 +1283,9 @@ void ExecutionEngine::markObjects(MarkStack *markStack)
 
     identifierTable->markObjects(markStack);
 
+    if (regExpCache)
+        regExpCache->markObjects(markStack);
+
     for (auto compilationUnit: compilationUnits)
         compilationUnit->markObjects(markStack);
 }
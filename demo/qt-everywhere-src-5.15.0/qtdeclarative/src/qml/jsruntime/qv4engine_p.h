@@ -151,6 +151,7 @@ class Debugger;
 } // namespace Debugging
 namespace Profiling {
 class Profiler;
+class Sampler;
 } // namespace Profiling
 namespace CompiledData {
 struct CompilationUnit;
@@ -530,6 +531,12 @@ public:
 
     quintptr protoIdCount = 1;
 
+    // Incremented whenever C++ code may have run that changes QObject
+    // properties behind the engine's back. Wrappers that keep a copy of a
+    // property, like sequence references, reload it once this has changed.
+    quint32 referenceGeneration = 0;
+    void invalidateCachedReferences() { ++referenceGeneration; }
+
     ExecutionEngine(QJSEngine *jsEngine = nullptr);
     ~ExecutionEngine();
 
@@ -547,6 +554,10 @@ public:
     void setProfiler(Profiling::Profiler *profiler);
 #endif // QT_CONFIG(qml_debug)
 
+    // Available in all builds, see QV4::Profiling::Sampler
+    QV4::Profiling::Sampler *sampler() const { return m_sampler.data(); }
+    void setSampler(Profiling::Sampler *sampler);
+
     ExecutionContext *currentContext() const;
 
     // ensure we always get odd prototype IDs. This helps make marking in QV4::Lookup fast
@@ -727,6 +738,7 @@ private:
     QScopedPointer<QV4::Debugging::Debugger> m_debugger;
     QScopedPointer<QV4::Profiling::Profiler> m_profiler;
 #endif
+    QScopedPointer<QV4::Profiling::Sampler> m_sampler;
     QSet<QString> m_illegalNames;
     int jitCallCountThreshold;
 
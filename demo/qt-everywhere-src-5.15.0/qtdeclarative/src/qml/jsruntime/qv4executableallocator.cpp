@@ -43,8 +43,36 @@
 #include <wtf/StdLibExtras.h>
 #include <wtf/PageAllocation.h>
 
+#include <QtCore/qdebug.h>
+
 using namespace QV4;
 
+// Chunks are reserved at least this large, so that small functions share
+// pages instead of getting a mapping each.
+static size_t minimumChunkSize()
+{
+    static const size_t size = [] {
+        bool ok;
+        const int kb = qEnvironmentVariableIntValue("QV4_EXECUTABLE_CHUNK_SIZE", &ok);
+        return (ok && kb > 0) ? size_t(kb) * 1024 : size_t(64 * 1024);
+    }();
+    return size;
+}
+
+// Small code blobs are rounded up to a few size classes. A freed block then
+// fits the next blob of the same class exactly, instead of leaving a sliver
+// behind when it is split again.
+static size_t sizeClassFor(size_t size)
+{
+    enum { LargestSizeClass = 4096 };
+    if (size > LargestSizeClass)
+        return size;
+    size_t step = 16;
+    while (step * 16 < size)
+        step *= 2;
+    return WTF::roundUpToMultipleOf(step, size);
+}
+
 void *ExecutableAllocator::Allocation::exceptionHandler() const
 {
     return reinterpret_cast<void*>(addr);
@@ -151,6 +179,9 @@ ExecutableAllocator::ExecutableAllocator()
 
 ExecutableAllocator::~ExecutableAllocator()
 {
+    if (qEnvironmentVariableIsSet("QV4_EXECUTABLE_ALLOCATOR_STATS"))
+        dumpStatistics();
+
     for (ChunkOfPages *chunk : qAsConst(chunks)) {
         for (Allocation *allocation = chunk->firstAllocation; allocation; allocation = allocation->next)
             if (!allocation->free)
@@ -166,7 +197,7 @@ ExecutableAllocator::Allocation *ExecutableAllocator::allocate(size_t size)
     Allocation *allocation = nullptr;
 
     // Code is best aligned to 16-byte boundaries.
-    size = WTF::roundUpToMultipleOf(16, size + exceptionHandlerSize());
+    size = sizeClassFor(WTF::roundUpToMultipleOf(16, size + exceptionHandlerSize()));
 
     QMultiMap<size_t, Allocation*>::Iterator it = freeAllocations.lowerBound(size);
     if (it != freeAllocations.end()) {
@@ -176,7 +207,7 @@ ExecutableAllocator::Allocation *ExecutableAllocator::allocate(size_t size)
 
     if (!allocation) {
         ChunkOfPages *chunk = new ChunkOfPages;
-        size_t allocSize = WTF::roundUpToMultipleOf(WTF::pageSize(), size);
+        size_t allocSize = WTF::roundUpToMultipleOf(WTF::pageSize(), qMax(size, minimumChunkSize()));
         chunk->pages = new WTF::PageAllocation(WTF::PageAllocation::allocate(allocSize, OSAllocator::JSJITCodePages));
         chunks.insert(reinterpret_cast<quintptr>(chunk->pages->base()) - 1, chunk);
         allocation = new Allocation;
@@ -243,3 +274,45 @@ ExecutableAllocator::ChunkOfPages *ExecutableAllocator::chunkForAllocation(Alloc
     return *it;
 }
 
+QVector<ExecutableAllocator::ChunkStatistics> ExecutableAllocator::chunkStatistics() const
+{
+    QMutexLocker locker(&mutex);
+
+    QVector<ChunkStatistics> result;
+    result.reserve(chunks.count());
+    for (const ChunkOfPages *chunk : chunks) {
+        ChunkStatistics stats;
+        stats.base = chunk->firstAllocation->addr;
+        for (const Allocation *allocation = chunk->firstAllocation; allocation; allocation = allocation->next) {
+            stats.size += allocation->size;
+            if (allocation->free) {
+                stats.freeBytes += allocation->size;
+                stats.largestFreeBlock = qMax(stats.largestFreeBlock, size_t(allocation->size));
+                ++stats.freeBlocks;
+            } else {
+                stats.usedBytes += allocation->size;
+                ++stats.usedBlocks;
+            }
+        }
+        result.append(stats);
+    }
+    return result;
+}
+
+void ExecutableAllocator::dumpStatistics() const
+{
+    const QVector<ChunkStatistics> stats = chunkStatistics();
+    size_t used = 0;
+    size_t free = 0;
+    for (const ChunkStatistics &chunk : stats) {
+        used += chunk.usedBytes;
+        free += chunk.freeBytes;
+        const double fragmentation = chunk.freeBytes
+                ? 1. - double(chunk.largestFreeBlock) / chunk.freeBytes : 0.;
+        qDebug("chunk %p: %zu bytes, %zu used in %d blocks, %zu free in %d blocks, fragmentation %.2f",
+               reinterpret_cast<void *>(chunk.base), chunk.size, chunk.usedBytes, chunk.usedBlocks,
+               chunk.freeBytes, chunk.freeBlocks, fragmentation);
+    }
+    qDebug("executable memory: %d chunks, %zu bytes used, %zu bytes free",
+           stats.count(), used, free);
+}
@@ -112,6 +112,20 @@ public:
     int freeAllocationCount() const { return freeAllocations.count(); }
     int chunkCount() const { return chunks.count(); }
 
+    // Fragmentation of a chunk is 1 - largestFreeBlock / freeBytes.
+    struct ChunkStatistics
+    {
+        quintptr base = 0;
+        size_t size = 0;
+        size_t usedBytes = 0;
+        size_t freeBytes = 0;
+        size_t largestFreeBlock = 0;
+        int usedBlocks = 0;
+        int freeBlocks = 0;
+    };
+    QVector<ChunkStatistics> chunkStatistics() const;
+    void dumpStatistics() const;
+
     struct ChunkOfPages
     {
         ChunkOfPages()
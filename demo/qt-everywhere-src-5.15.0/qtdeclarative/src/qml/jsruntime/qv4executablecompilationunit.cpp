@@ -52,6 +52,7 @@
 #include <private/qv4module_p.h>
 #include <private/qv4compilationunitmapper_p.h>
 #include <private/qml_compile_hash_p.h>
+#include <private/qstartuptrace_p.h>
 #include <private/qqmltypewrapper_p.h>
 #include <private/inlinecomponentutils_p.h>
 
@@ -60,6 +61,7 @@
 
 #include <QtCore/qdir.h>
 #include <QtCore/qstandardpaths.h>
+#include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qscopeguard.h>
 #include <QtCore/qcryptographichash.h>
@@ -109,6 +111,36 @@ QString ExecutableCompilationUnit::localCacheFilePath(const QUrl &url)
     return directory + QString::fromUtf8(fileNameHash.result().toHex()) + QLatin1Char('.') + cacheFileSuffix;
 }
 
+/*
+    Returns the path of the cache file for \a url in the system-wide cache
+    directory given by QML_SHARED_DISK_CACHE_PATH, or an empty string if
+    there is none.
+
+    The directory is filled at deployment time and only read at run time:
+    a compilation unit of a source file is stored there under the SHA-1 hash
+    of the source file's content, with the same suffix as a cache file next
+    to the source (".qmlc", ".jsc" or ".mjsc"). All processes map the same
+    files, so they share the pages, and the hash in the name replaces the
+    time stamp check.
+*/
+QString ExecutableCompilationUnit::sharedCacheFilePath(const QUrl &url)
+{
+    static const QString sharedCachePath = qEnvironmentVariable("QML_SHARED_DISK_CACHE_PATH");
+    if (sharedCachePath.isEmpty())
+        return QString();
+
+    const QString localSourcePath = QQmlFile::urlToLocalFileOrQrc(url);
+    QFile source(localSourcePath);
+    if (!source.open(QIODevice::ReadOnly))
+        return QString();
+    QCryptographicHash contentHash(QCryptographicHash::Sha1);
+    if (!contentHash.addData(&source))
+        return QString();
+    const QString cacheFileSuffix = QFileInfo(localSourcePath + QLatin1Char('c')).completeSuffix();
+    return sharedCachePath + QLatin1Char('/') + QString::fromUtf8(contentHash.result().toHex())
+            + QLatin1Char('.') + cacheFileSuffix;
+}
+
 static QString toString(QV4::ReturnedValue v)
 {
     Value val = Value::fromReturnedValue(v);
@@ -296,8 +328,20 @@ void ExecutableCompilationUnit::unlink()
     propertyCaches.clear();
 
     if (runtimeLookups) {
+        static const bool showLookupStatistics = qEnvironmentVariableIsSet("QV4_SHOW_LOOKUP_STATISTICS");
         for (uint i = 0; i < data->lookupTableSize; ++i) {
             QV4::Lookup &l = runtimeLookups[i];
+            if (l.isPolymorphic()) {
+                if (showLookupStatistics) {
+                    const QV4::PolymorphicLookupCache *cache = l.polymorphicLookup.cache;
+                    qDebug().nospace() << "Polymorphic " << (l.getter == QV4::Lookup::getterPolymorphic ? "getter" : "setter")
+                                       << " of " << stringAt(l.nameIndex) << " in " << finalUrlString()
+                                       << ": " << cache->count << " classes, " << cache->hits << " hits, "
+                                       << cache->misses << " misses";
+                }
+                l.releasePolymorphicCache();
+                continue;
+            }
             if (l.getter == QV4::QObjectWrapper::lookupGetter
                     || l.getter == QQmlTypeWrapper::lookupSingletonProperty) {
                 if (QQmlPropertyCache *pc = l.qobjectLookup.propertyCache)
@@ -747,11 +791,22 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
     }
 
     const QString sourcePath = QQmlFile::urlToLocalFileOrQrc(url);
+    QStartupTraceScope trace("qml", sourcePath);
     QScopedPointer<CompilationUnitMapper> cacheFile(new CompilationUnitMapper());
 
-    const QStringList cachePaths = { sourcePath + QLatin1Char('c'), localCacheFilePath(url) };
-    for (const QString &cachePath : cachePaths) {
-        CompiledData::Unit *mappedUnit = cacheFile->open(cachePath, sourceTimeStamp, errorString);
+    struct CachePath {
+        QString path;
+        SourceCheck check;
+    };
+    QVector<CachePath> cachePaths;
+    const QString sharedCachePath = sharedCacheFilePath(url);
+    if (!sharedCachePath.isEmpty())
+        cachePaths.append({ sharedCachePath, SourceCheck::ContentHash });
+    cachePaths.append({ sourcePath + QLatin1Char('c'), SourceCheck::TimeStamp });
+    cachePaths.append({ localCacheFilePath(url), SourceCheck::TimeStamp });
+    for (const CachePath &cachePath : qAsConst(cachePaths)) {
+        CompiledData::Unit *mappedUnit = cacheFile->open(cachePath.path, sourceTimeStamp, errorString,
+                                                         cachePath.check);
         if (!mappedUnit)
             continue;
 
@@ -762,9 +817,17 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
         auto dataPtrRevert = qScopeGuard([this, oldData](){
             setUnitData(oldData);
         });
-        setUnitData(mappedUnit);
+        if (cachePath.check == SourceCheck::ContentHash) {
+            // A unit in the shared cache may be used for any file of the same content, so the
+            // file name and final URL stored in it may be those of another file: use ours, for
+            // error messages and for resolving relative URLs and imports.
+            const QString urlString = url.toString();
+            setUnitData(mappedUnit, nullptr, urlString, urlString);
+        } else {
+            setUnitData(mappedUnit);
+        }
 
-        if (data->sourceFileIndex != 0
+        if (cachePath.check == SourceCheck::TimeStamp && data->sourceFileIndex != 0
             && sourcePath != QQmlFile::urlToLocalFileOrQrc(stringAt(data->sourceFileIndex))) {
             *errorString = QStringLiteral("QML source file has moved to a different location.");
             continue;
@@ -928,7 +991,8 @@ QString ExecutableCompilationUnit::bindingValueAsScriptString(
 }
 
 bool ExecutableCompilationUnit::verifyHeader(
-        const CompiledData::Unit *unit, QDateTime expectedSourceTimeStamp, QString *errorString)
+        const CompiledData::Unit *unit, QDateTime expectedSourceTimeStamp, QString *errorString,
+        SourceCheck check)
 {
     if (strncmp(unit->magic, CompiledData::magic_str, sizeof(unit->magic))) {
         *errorString = QStringLiteral("Magic bytes in the header do not match");
@@ -947,7 +1011,7 @@ bool ExecutableCompilationUnit::verifyHeader(
         return false;
     }
 
-    if (unit->sourceTimeStamp) {
+    if (unit->sourceTimeStamp && check == SourceCheck::TimeStamp) {
         // Files from the resource system do not have any time stamps, so fall back to the application
         // executable.
         if (!expectedSourceTimeStamp.isValid())
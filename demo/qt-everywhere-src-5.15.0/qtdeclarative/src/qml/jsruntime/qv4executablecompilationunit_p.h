@@ -276,6 +276,7 @@ public:
     bool loadFromDisk(const QUrl &url, const QDateTime &sourceTimeStamp, QString *errorString);
 
     static QString localCacheFilePath(const QUrl &url);
+    static QString sharedCacheFilePath(const QUrl &url);
     bool saveToDisk(const QUrl &unitUrl, QString *errorString);
 
     QString bindingValueAsString(const CompiledData::Binding *binding) const;
@@ -287,8 +288,12 @@ public:
         return constants[binding->value.constantValueIndex].doubleValue();
     }
 
+    // How a cache file is known to belong to its source: by the source's time
+    // stamp, or by the hash of the source's content in the file name
+    enum class SourceCheck { TimeStamp, ContentHash };
+
     static bool verifyHeader(const CompiledData::Unit *unit, QDateTime expectedSourceTimeStamp,
-                             QString *errorString);
+                             QString *errorString, SourceCheck check = SourceCheck::TimeStamp);
 
 protected:
     quint32 totalStringCount() const
@@ -39,17 +39,39 @@
 #include "qv4identifiertable_p.h"
 #include "qv4symbol_p.h"
 #include <private/qprimefornumbits_p.h>
+#include <QtCore/qatomic.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+// The largest number of identifiers any engine in this process has held. Every
+// engine interns the same runtime strings and usually the same set of QML
+// identifiers, so later engines (e.g. one per WorkerScript) start out with a
+// table of that size instead of rehashing their way up to it.
+static QBasicAtomicInteger<uint> identifierTableHighWater = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static int numBitsForSize(uint n)
+{
+    // addEntry() grows the table once it is half full
+    int bits = 1;
+    while (bits < 30 && (1u << bits) <= n * 2)
+        ++bits;
+    return bits;
+}
+
+uint IdentifierTable::sizeHint()
+{
+    static const uint envHint = qEnvironmentVariableIntValue("QV4_IDENTIFIER_TABLE_SIZE");
+    return qMax(envHint, identifierTableHighWater.loadAcquire());
+}
+
 IdentifierTable::IdentifierTable(ExecutionEngine *engine, int numBits)
     : engine(engine)
     , size(0)
-    , numBits(numBits)
+    , numBits(qMax(numBits, numBitsForSize(sizeHint())))
 {
-    alloc = qPrimeForNumBits(numBits);
+    alloc = qPrimeForNumBits(this->numBits);
     entriesByHash = (Heap::StringOrSymbol **)malloc(alloc*sizeof(Heap::StringOrSymbol *));
     entriesById = (Heap::StringOrSymbol **)malloc(alloc*sizeof(Heap::StringOrSymbol *));
     memset(entriesByHash, 0, alloc*sizeof(Heap::String *));
@@ -58,6 +80,9 @@ IdentifierTable::IdentifierTable(ExecutionEngine *engine, int numBits)
 
 IdentifierTable::~IdentifierTable()
 {
+    uint highWater = identifierTableHighWater.loadAcquire();
+    while (highWater < size && !identifierTableHighWater.testAndSetOrdered(highWater, size, highWater))
+        ;
     free(entriesByHash);
     free(entriesById);
     for (const auto &h : qAsConst(idHashes))
@@ -75,43 +100,8 @@ void IdentifierTable::addEntry(Heap::StringOrSymbol *str)
 
     bool grow = (alloc <= size*2);
 
-    if (grow) {
-        ++numBits;
-        int newAlloc = qPrimeForNumBits(numBits);
-        Heap::StringOrSymbol **newEntries = (Heap::StringOrSymbol **)malloc(newAlloc*sizeof(Heap::String *));
-        memset(newEntries, 0, newAlloc*sizeof(Heap::StringOrSymbol *));
-        for (uint i = 0; i < alloc; ++i) {
-            Heap::StringOrSymbol *e = entriesByHash[i];
-            if (!e)
-                continue;
-            uint idx = e->stringHash % newAlloc;
-            while (newEntries[idx]) {
-                ++idx;
-                idx %= newAlloc;
-            }
-            newEntries[idx] = e;
-        }
-        free(entriesByHash);
-        entriesByHash = newEntries;
-
-        newEntries = (Heap::StringOrSymbol **)malloc(newAlloc*sizeof(Heap::String *));
-        memset(newEntries, 0, newAlloc*sizeof(Heap::StringOrSymbol *));
-        for (uint i = 0; i < alloc; ++i) {
-            Heap::StringOrSymbol *e = entriesById[i];
-            if (!e)
-                continue;
-            uint idx = e->identifier.id() % newAlloc;
-            while (newEntries[idx]) {
-                ++idx;
-                idx %= newAlloc;
-            }
-            newEntries[idx] = e;
-        }
-        free(entriesById);
-        entriesById = newEntries;
-
-        alloc = newAlloc;
-    }
+    if (grow)
+        resize(numBits + 1);
 
     uint idx = hash % alloc;
     while (entriesByHash[idx]) {
@@ -130,6 +120,52 @@ void IdentifierTable::addEntry(Heap::StringOrSymbol *str)
     ++size;
 }
 
+void IdentifierTable::reserve(uint n)
+{
+    int newNumBits = numBitsForSize(n);
+    if (newNumBits > numBits)
+        resize(newNumBits);
+}
+
+void IdentifierTable::resize(int newNumBits)
+{
+    numBits = newNumBits;
+    int newAlloc = qPrimeForNumBits(numBits);
+    Heap::StringOrSymbol **newEntries = (Heap::StringOrSymbol **)malloc(newAlloc*sizeof(Heap::String *));
+    memset(newEntries, 0, newAlloc*sizeof(Heap::StringOrSymbol *));
+    for (uint i = 0; i < alloc; ++i) {
+        Heap::StringOrSymbol *e = entriesByHash[i];
+        if (!e)
+            continue;
+        uint idx = e->stringHash % newAlloc;
+        while (newEntries[idx]) {
+            ++idx;
+            idx %= newAlloc;
+        }
+        newEntries[idx] = e;
+    }
+    free(entriesByHash);
+    entriesByHash = newEntries;
+
+    newEntries = (Heap::StringOrSymbol **)malloc(newAlloc*sizeof(Heap::String *));
+    memset(newEntries, 0, newAlloc*sizeof(Heap::StringOrSymbol *));
+    for (uint i = 0; i < alloc; ++i) {
+        Heap::StringOrSymbol *e = entriesById[i];
+        if (!e)
+            continue;
+        uint idx = e->identifier.id() % newAlloc;
+        while (newEntries[idx]) {
+            ++idx;
+            idx %= newAlloc;
+        }
+        newEntries[idx] = e;
+    }
+    free(entriesById);
+    entriesById = newEntries;
+
+    alloc = newAlloc;
+}
+
 
 
 Heap::String *IdentifierTable::insertString(const QString &s)
@@ -73,12 +73,16 @@ struct Q_QML_PRIVATE_EXPORT IdentifierTable
     QSet<IdentifierHashData *> idHashes;
 
     void addEntry(Heap::StringOrSymbol *str);
+    void resize(int newNumBits);
 
 public:
 
     IdentifierTable(ExecutionEngine *engine, int numBits = 8);
     ~IdentifierTable();
 
+    void reserve(uint n);
+    static uint sizeHint();
+
     Heap::String *insertString(const QString &s);
     Heap::Symbol *insertSymbol(const QString &s);
 
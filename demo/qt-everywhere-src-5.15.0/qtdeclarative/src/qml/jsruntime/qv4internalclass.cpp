@@ -270,6 +270,7 @@ void InternalClass::init(ExecutionEngine *engine)
     new (&nameMap) SharedInternalClassData<PropertyKey>(engine);
     new (&propertyData) SharedInternalClassData<PropertyAttributes>(engine);
     new (&transitions) std::vector<Transition>();
+    transitionIndex = nullptr;
 
     this->engine = engine;
     vtable = QV4::InternalClass::staticVTable();
@@ -294,6 +295,7 @@ void InternalClass::init(Heap::InternalClass *other)
     new (&nameMap) SharedInternalClassData<PropertyKey>(other->nameMap);
     new (&propertyData) SharedInternalClassData<PropertyAttributes>(other->propertyData);
     new (&transitions) std::vector<Transition>();
+    transitionIndex = nullptr;
 
     engine = other->engine;
     vtable = other->vtable;
@@ -327,6 +329,8 @@ void InternalClass::destroy()
     nameMap.~SharedInternalClassData<PropertyKey>();
     propertyData.~SharedInternalClassData<PropertyAttributes>();
     transitions.~vector<Transition>();
+    delete transitionIndex;
+    transitionIndex = nullptr;
     engine = nullptr;
     Base::destroy();
 }
@@ -347,13 +351,29 @@ void InternalClass::changeMember(QV4::Object *object, PropertyKey id, PropertyAt
 
 InternalClassTransition &InternalClass::lookupOrInsertTransition(const InternalClassTransition &t)
 {
+    // Classes many others derive from, such as the empty class of the objects
+    // built property by property, would pay for inserting into the sorted vector
+    if (transitionIndex) {
+        const auto index = transitionIndex->constFind(t);
+        if (index != transitionIndex->constEnd())
+            return transitions[*index];
+        transitionIndex->insert(t, uint(transitions.size()));
+        transitions.push_back(t);
+        return transitions.back();
+    }
+
     std::vector<Transition>::iterator it = std::lower_bound(transitions.begin(), transitions.end(), t);
-    if (it != transitions.end() && *it == t) {
-        return *it;
-    } else {
-        it = transitions.insert(it, t);
+    if (it != transitions.end() && *it == t)
         return *it;
+
+    it = transitions.insert(it, t);
+    if (transitions.size() >= TransitionHashThreshold) {
+        transitionIndex = new QHash<Transition, uint>;
+        transitionIndex->reserve(int(transitions.size()) * 2);
+        for (uint i = 0; i < transitions.size(); ++i)
+            transitionIndex->insert(transitions[i], i);
     }
+    return *it;
 }
 
 static void addDummyEntry(InternalClass *newClass, PropertyHash::Entry e)
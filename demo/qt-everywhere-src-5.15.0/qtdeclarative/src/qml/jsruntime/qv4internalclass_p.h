@@ -305,6 +305,11 @@ struct InternalClassTransition
     { return id < other.id || (id == other.id && flags < other.flags); }
 };
 
+inline uint qHash(const InternalClassTransition &t, uint seed = 0)
+{
+    return qHash(t.id.id(), seed) ^ uint(t.flags);
+}
+
 namespace Heap {
 
 struct InternalClass : Base {
@@ -319,7 +324,11 @@ struct InternalClass : Base {
     SharedInternalClassData<PropertyAttributes> propertyData;
 
     typedef InternalClassTransition Transition;
+    // Sorted, until there are TransitionHashThreshold transitions: from then
+    // on, new ones are appended and transitionIndex maps them to their index.
+    enum { TransitionHashThreshold = 16 };
     std::vector<Transition> transitions;
+    QHash<Transition, uint> *transitionIndex;
     InternalClassTransition &lookupOrInsertTransition(const InternalClassTransition &t);
 
     uint size;
@@ -76,6 +76,7 @@ static const int nestingLimit = 1024;
 
 JsonParser::JsonParser(ExecutionEngine *engine, const QChar *json, int length)
     : engine(engine), head(json), json(json), nestingLevel(0), lastError(QJsonParseError::NoError)
+    , memberCacheClasses(nullptr)
 {
     end = json + length;
 }
@@ -172,6 +173,7 @@ ReturnedValue JsonParser::parse(QJsonParseError *error)
     eatSpace();
 
     Scope scope(engine);
+    memberCacheClasses = scope.alloc(2 * MemberCacheSize);
     ScopedValue v(scope);
     if (!parseValue(v)) {
 #ifdef PARSER_DEBUG
@@ -249,8 +251,18 @@ bool JsonParser::parseMember(Object *o)
     BEGIN << "parseMember";
     Scope scope(engine);
 
+    // keys without escape sequences can be matched against the member cache
+    // by their raw text
+    const QChar *keyBegin = json;
+    const QChar *keyEnd = json;
+    while (keyEnd < end && *keyEnd != Quote && *keyEnd != QLatin1Char('\\') && keyEnd->unicode() > 0x1f)
+        ++keyEnd;
+    const bool plainKey = keyEnd < end && *keyEnd == Quote;
+
     QString key;
-    if (!parseString(&key))
+    if (plainKey)
+        json = keyEnd + 1;
+    else if (!parseString(&key))
         return false;
     QChar token = nextToken();
     if (token != NameSeparator) {
@@ -261,6 +273,21 @@ bool JsonParser::parseMember(Object *o)
     if (!parseValue(val))
         return false;
 
+    Heap::InternalClass *ic = o->internalClass();
+    uint cacheIndex = 0;
+    if (plainKey) {
+        QStringView keyText(keyBegin, keyEnd - keyBegin);
+        cacheIndex = memberCacheIndex(ic, keyText);
+        const MemberCacheEntry &entry = memberCache[cacheIndex];
+        if (memberCacheClasses[2 * cacheIndex].heapObject() == ic && QStringView(entry.key) == keyText) {
+            o->setInternalClass(static_cast<Heap::InternalClass *>(memberCacheClasses[2 * cacheIndex + 1].heapObject()));
+            o->setProperty(entry.index, val);
+            END;
+            return true;
+        }
+        key = keyText.toString();
+    }
+
     ScopedString s(scope, engine->newString(key));
     PropertyKey skey = s->toPropertyKey();
     if (skey.isArrayIndex()) {
@@ -268,6 +295,13 @@ bool JsonParser::parseMember(Object *o)
     } else {
         // avoid trouble with properties named __proto__
         o->insertMember(s, val);
+        if (plainKey) {
+            MemberCacheEntry &entry = memberCache[cacheIndex];
+            entry.key = key;
+            entry.index = o->internalClass()->find(skey).index;
+            memberCacheClasses[2 * cacheIndex] = Value::fromHeapObject(ic);
+            memberCacheClasses[2 * cacheIndex + 1] = Value::fromHeapObject(o->internalClass());
+        }
     }
 
     END;
@@ -585,6 +619,15 @@ bool JsonParser::parseString(QString *string)
     BEGIN << "parse string stringPos=" << json;
 
     while (json < end) {
+        // append runs of characters that need no unescaping in one go
+        const QChar *run = json;
+        while (json < end && *json != '"' && *json != '\\' && json->unicode() > 0x1f)
+            ++json;
+        if (json != run)
+            string->append(run, int(json - run));
+        if (json == end)
+            break;
+
         if (*json == '"')
             break;
         else if (*json == '\\') {
@@ -625,10 +668,14 @@ struct Stringify
     FunctionObject *replacerFunction;
     QV4::String *propertyList;
     int propertyListSize;
+    QV4::String *toJSONName;
     QString gap;
     QString indent;
     QStack<Object *> stack;
 
+    // All of the output is appended to this one string
+    QString result;
+
     bool stackContains(Object *o) {
         for (int i = 0; i < stack.size(); ++i)
             if (stack.at(i)->d() == o->d())
@@ -636,75 +683,80 @@ struct Stringify
         return false;
     }
 
-    Stringify(ExecutionEngine *e) : v4(e), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0) {}
+    Stringify(ExecutionEngine *e) : v4(e), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0), toJSONName(nullptr) {}
 
-    QString Str(const QString &key, const Value &v);
-    QString JA(Object *a);
-    QString JO(Object *o);
+    // Appends the serialization of v to result. Returns false and leaves
+    // result alone if v has no JSON representation.
+    bool Str(const Value &key, const Value &v);
+    void JA(Object *a);
+    void JO(Object *o);
 
-    QString makeMember(const QString &key, const Value &v);
+    void quote(const QString &str);
+    void beginMember(bool first);
+    bool makeMember(const Value &key, const Value &v, bool first);
 };
 
-static QString quote(const QString &str)
+void Stringify::quote(const QString &str)
 {
-    QString product;
     const int length = str.length();
-    product.reserve(length + 2);
-    product += QLatin1Char('"');
+    const QChar *data = str.constData();
+    result.reserve(result.length() + length + 2);
+    result += QLatin1Char('"');
+    int runStart = 0;
     for (int i = 0; i < length; ++i) {
-        QChar c = str.at(i);
-        switch (c.unicode()) {
+        const ushort c = data[i].unicode();
+        if (c > 0x1f && c != '"' && c != '\\')
+            continue;
+        // append the run of characters that need no escaping in one go
+        result.append(data + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
         case '"':
-            product += QLatin1String("\\\"");
+            result += QLatin1String("\\\"");
             break;
         case '\\':
-            product += QLatin1String("\\\\");
+            result += QLatin1String("\\\\");
             break;
         case '\b':
-            product += QLatin1String("\\b");
+            result += QLatin1String("\\b");
             break;
         case '\f':
-            product += QLatin1String("\\f");
+            result += QLatin1String("\\f");
             break;
         case '\n':
-            product += QLatin1String("\\n");
+            result += QLatin1String("\\n");
             break;
         case '\r':
-            product += QLatin1String("\\r");
+            result += QLatin1String("\\r");
             break;
         case '\t':
-            product += QLatin1String("\\t");
+            result += QLatin1String("\\t");
             break;
         default:
-            if (c.unicode() <= 0x1f) {
-                product += QLatin1String("\\u00");
-                product += (c.unicode() > 0xf ? QLatin1Char('1') : QLatin1Char('0')) +
-                        QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
-            } else {
-                product += c;
-            }
+            result += QLatin1String("\\u00");
+            result += (c > 0xf ? QLatin1Char('1') : QLatin1Char('0'));
+            result += QLatin1Char("0123456789abcdef"[c & 0xf]);
         }
     }
-    product += QLatin1Char('"');
-    return product;
+    result.append(data + runStart, length - runStart);
+    result += QLatin1Char('"');
 }
 
-QString Stringify::Str(const QString &key, const Value &v)
+bool Stringify::Str(const Value &key, const Value &v)
 {
     Scope scope(v4);
 
     ScopedValue value(scope, v);
     ScopedObject o(scope, value);
     if (o) {
-        ScopedString s(scope, v4->newString(QStringLiteral("toJSON")));
-        ScopedFunctionObject toJSON(scope, o->get(s));
+        ScopedFunctionObject toJSON(scope, o->get(toJSONName));
         if (!!toJSON) {
             JSCallData jsCallData(scope, 1);
             *jsCallData->thisObject = value;
-            jsCallData->args[0] = v4->newString(key);
+            jsCallData->args[0] = key.toString(v4);
             value = toJSON->call(jsCallData);
             if (v4->hasException)
-                return QString();
+                return false;
         }
     }
 
@@ -712,12 +764,12 @@ QString Stringify::Str(const QString &key, const Value &v)
         ScopedObject holder(scope, v4->newObject());
         holder->put(scope.engine->id_empty(), value);
         JSCallData jsCallData(scope, 2);
-        jsCallData->args[0] = v4->newString(key);
+        jsCallData->args[0] = key.toString(v4);
         jsCallData->args[1] = value;
         *jsCallData->thisObject = holder;
         value = replacerFunction->call(jsCallData);
         if (v4->hasException)
-            return QString();
+            return false;
     }
 
     o = value->asReturnedValue();
@@ -730,64 +782,84 @@ QString Stringify::Str(const QString &key, const Value &v)
             value = Encode(b->value());
     }
 
-    if (value->isNull())
-        return QStringLiteral("null");
-    if (value->isBoolean())
-        return value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
-    if (value->isString())
-        return quote(value->stringValue()->toQString());
+    if (value->isNull()) {
+        result += QLatin1String("null");
+        return true;
+    }
+    if (value->isBoolean()) {
+        result += value->booleanValue() ? QLatin1String("true") : QLatin1String("false");
+        return true;
+    }
+    if (value->isString()) {
+        quote(value->stringValue()->toQString());
+        return true;
+    }
 
     if (value->isNumber()) {
         double d = value->toNumber();
-        return std::isfinite(d) ? value->toQString() : QStringLiteral("null");
+        result += std::isfinite(d) ? value->toQString() : QStringLiteral("null");
+        return true;
     }
 
     if (const QV4::VariantObject *v = value->as<QV4::VariantObject>()) {
-        return quote(v->d()->data().toString());
+        quote(v->d()->data().toString());
+        return true;
     }
 
     o = value->asReturnedValue();
     if (o) {
         if (!o->as<FunctionObject>()) {
             if (o->isArrayLike()) {
-                return JA(o.getPointer());
+                JA(o.getPointer());
             } else {
-                return JO(o);
+                JO(o);
             }
+            return true;
         }
     }
 
-    return QString();
+    return false;
 }
 
-QString Stringify::makeMember(const QString &key, const Value &v)
+void Stringify::beginMember(bool first)
 {
-    QString strP = Str(key, v);
-    if (!strP.isEmpty()) {
-        QString member = quote(key) + QLatin1Char(':');
-        if (!gap.isEmpty())
-            member += QLatin1Char(' ');
-        member += strP;
-        return member;
+    if (!first)
+        result += QLatin1Char(',');
+    if (!gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += indent;
     }
-    return QString();
 }
 
-QString Stringify::JO(Object *o)
+bool Stringify::makeMember(const Value &key, const Value &v, bool first)
+{
+    const int mark = result.length();
+    beginMember(first);
+    quote(key.toQString());
+    result += QLatin1Char(':');
+    if (!gap.isEmpty())
+        result += QLatin1Char(' ');
+    if (Str(key, v))
+        return true;
+    result.truncate(mark);
+    return false;
+}
+
+void Stringify::JO(Object *o)
 {
     if (stackContains(o)) {
         v4->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(v4);
 
-    QString result;
     stack.push(o);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += QLatin1Char('{');
+    bool empty = true;
     if (!propertyListSize) {
         ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
         ScopedValue name(scope);
@@ -797,10 +869,8 @@ QString Stringify::JO(Object *o)
             name = it.nextPropertyNameAsString(val);
             if (name->isNull())
                 break;
-            QString key = name->toQString();
-            QString member = makeMember(key, val);
-            if (!member.isEmpty())
-                partial += member;
+            if (makeMember(name, val, empty))
+                empty = false;
         }
     } else {
         ScopedValue v(scope);
@@ -812,70 +882,53 @@ QString Stringify::JO(Object *o)
             v = o->get(s, &exists);
             if (!exists)
                 continue;
-            QString member = makeMember(s->toQString(), v);
-            if (!member.isEmpty())
-                partial += member;
+            if (makeMember(*s, v, empty))
+                empty = false;
         }
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("{}");
-    } else if (gap.isEmpty()) {
-        result = QLatin1Char('{') + partial.join(QLatin1Char(',')) + QLatin1Char('}');
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("{\n") + indent + partial.join(separator) + QLatin1Char('\n')
-                 + stepback + QLatin1Char('}');
+    if (!empty && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char('}');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
-QString Stringify::JA(Object *a)
+void Stringify::JA(Object *a)
 {
     if (stackContains(a)) {
         v4->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(a->engine());
 
-    QString result;
     stack.push(a);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += QLatin1Char('[');
     uint len = a->getLength();
     ScopedValue v(scope);
     for (uint i = 0; i < len; ++i) {
+        beginMember(i == 0);
         bool exists;
         v = a->get(i, &exists);
-        if (!exists) {
-            partial += QStringLiteral("null");
-            continue;
-        }
-        QString strP = Str(QString::number(i), v);
-        if (!strP.isEmpty())
-            partial += strP;
-        else
-            partial += QStringLiteral("null");
+        if (!exists || !Str(Value::fromUInt32(i), v))
+            result += QLatin1String("null");
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("[]");
-    } else if (gap.isEmpty()) {
-        result = QLatin1Char('[') + partial.join(QLatin1Char(',')) + QLatin1Char(']');
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("[\n") + indent + partial.join(separator) + QLatin1Char('\n') + stepback + QLatin1Char(']');
+    if (len && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char(']');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
 
@@ -954,11 +1007,13 @@ ReturnedValue JsonObject::method_stringify(const FunctionObject *b, const Value
     }
 
 
+    ScopedString toJSONName(scope, scope.engine->newString(QStringLiteral("toJSON")));
+    stringify.toJSONName = toJSONName;
+
     ScopedValue arg0(scope, argc ? argv[0] : Value::undefinedValue());
-    QString result = stringify.Str(QString(), arg0);
-    if (result.isEmpty() || scope.engine->hasException)
+    if (!stringify.Str(*scope.engine->id_empty(), arg0) || scope.engine->hasException)
         RETURN_UNDEFINED();
-    return Encode(scope.engine->newString(result));
+    return Encode(scope.engine->newString(stringify.result));
 }
 
 
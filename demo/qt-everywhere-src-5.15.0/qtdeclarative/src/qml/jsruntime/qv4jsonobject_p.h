@@ -127,6 +127,18 @@ private:
     bool parseValue(Value *val);
     bool parseNumber(Value *val);
 
+    // Objects parsed from arrays of records all take the same path through
+    // the internal class tree. The parser remembers, by class and raw key
+    // text, which class adding a member leads to and where the member is
+    // stored, so repeated keys need neither a string nor a class lookup.
+    enum { MemberCacheSize = 64 };
+    struct MemberCacheEntry {
+        QString key;
+        uint index;
+    };
+    static uint memberCacheIndex(const Heap::InternalClass *ic, QStringView key)
+    { return qHash(key, uint(quintptr(ic) >> 4)) % MemberCacheSize; }
+
     ExecutionEngine *engine;
     const QChar *head;
     const QChar *json;
@@ -134,6 +146,11 @@ private:
 
     int nestingLevel;
     QJsonParseError::ParseError lastError;
+
+    // The classes before and after each cached member was added, kept on the
+    // JS stack so that they stay alive until the parse is done
+    Value *memberCacheClasses;
+    MemberCacheEntry memberCache[MemberCacheSize];
 };
 
 }
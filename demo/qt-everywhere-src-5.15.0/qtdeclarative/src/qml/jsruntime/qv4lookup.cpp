@@ -248,8 +248,7 @@ ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *eng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->inlinePropertyDataWithOffset(l->objectLookupTwoClasses.offset2)->asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterToPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -263,8 +262,7 @@ ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterToPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -278,8 +276,7 @@ ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterToPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -374,6 +371,73 @@ ReturnedValue Lookup::getterIndexed(Lookup *l, ExecutionEngine *engine, const Va
 
 }
 
+/*
+    A data getter for two classes met a third one. Keep all of them in a
+    polymorphic cache, unless the property is no data property of the new
+    object itself.
+*/
+ReturnedValue Lookup::getterToPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    const Object *o = object.as<Object>();
+    if (!o) {
+        l->getter = getterFallback;
+        return getterFallback(l, engine, object);
+    }
+
+    Lookup resolved = *l;
+    const ReturnedValue result = resolved.resolveGetter(engine, o);
+    if (resolved.getter != getter0Inline && resolved.getter != getter0MemberData) {
+        l->getter = getterFallback;
+        return result;
+    }
+
+    PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+    cache->append(l->objectLookupTwoClasses.ic, l->objectLookupTwoClasses.offset,
+                  l->getter != getter0MemberDatagetter0MemberData);
+    cache->append(l->objectLookupTwoClasses.ic2, l->objectLookupTwoClasses.offset2,
+                  l->getter == getter0Inlinegetter0Inline);
+    cache->append(resolved.objectLookup.ic, resolved.objectLookup.offset,
+                  resolved.getter == getter0Inline);
+    l->clear();
+    l->polymorphicLookup.cache = cache;
+    l->getter = getterPolymorphic;
+    return result;
+}
+
+ReturnedValue Lookup::getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    PolymorphicLookupCache *cache = l->polymorphicLookup.cache;
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // the internal class won't match
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        for (int i = 0; i < cache->count; ++i) {
+            const PolymorphicLookupCache::Entry &entry = cache->entries[i];
+            if (entry.ic == o->internalClass) {
+                ++cache->hits;
+                if (entry.inlineProperty)
+                    return o->inlinePropertyDataWithOffset(entry.offset)->asReturnedValue();
+                return o->memberData->values.data()[entry.offset].asReturnedValue();
+            }
+        }
+    }
+    ++cache->misses;
+
+    if (cache->count < PolymorphicLookupCache::Size) {
+        if (const Object *obj = object.as<Object>()) {
+            Lookup resolved = *l;
+            const ReturnedValue result = resolved.resolveGetter(engine, obj);
+            if (resolved.getter == getter0Inline || resolved.getter == getter0MemberData) {
+                cache->append(resolved.objectLookup.ic, resolved.objectLookup.offset,
+                              resolved.getter == getter0Inline);
+            }
+            return result;
+        }
+    }
+    // The site is megamorphic: keep the cached classes, and look up others by name
+    return getterFallback(l, engine, object);
+}
+
 ReturnedValue Lookup::primitiveGetterProto(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     if (object.type() == l->primitiveLookup.type && !object.isObject()) {
@@ -464,7 +528,6 @@ bool Lookup::setterGeneric(Lookup *l, ExecutionEngine *engine, Value &object, co
 bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
 {
     Lookup first = *l;
-    Lookup second = *l;
 
     if (object.isObject()) {
         if (!l->resolveSetter(engine, static_cast<Object *>(&object), value)) {
@@ -473,13 +536,19 @@ bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object,
         }
 
         if (l->setter == Lookup::setter0MemberData || l->setter == Lookup::setter0Inline) {
+            // l now holds the lookup of the second class
+            Heap::InternalClass *ic2 = l->objectLookup.ic;
+            const uint index2 = l->objectLookup.index;
             l->objectLookupTwoClasses.ic = first.objectLookup.ic;
-            l->objectLookupTwoClasses.ic2 = second.objectLookup.ic;
+            l->objectLookupTwoClasses.ic2 = ic2;
             l->objectLookupTwoClasses.offset = first.objectLookup.index;
-            l->objectLookupTwoClasses.offset2 = second.objectLookup.index;
+            l->objectLookupTwoClasses.offset2 = index2;
             l->setter = setter0setter0;
             return true;
         }
+        // the value has been set already
+        l->setter = setterFallback;
+        return true;
     }
 
     l->setter = setterFallback;
@@ -533,7 +602,67 @@ bool Lookup::setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, c
         }
     }
 
-    l->setter = setterFallback;
+    return setterToPolymorphic(l, engine, object, value);
+}
+
+/*
+    A setter for two classes met a third one. Keep all of them in a
+    polymorphic cache, unless the property is no writable data property of
+    the new object itself.
+*/
+bool Lookup::setterToPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    if (!object.isObject()) {
+        l->setter = setterFallback;
+        return setterFallback(l, engine, object, value);
+    }
+
+    Lookup resolved = *l;
+    if (!resolved.resolveSetter(engine, static_cast<Object *>(&object), value)) {
+        l->setter = setterFallback;
+        return false;
+    }
+    // the value has been set already
+    if (resolved.setter != setter0MemberData && resolved.setter != setter0Inline) {
+        l->setter = setterFallback;
+        return true;
+    }
+
+    PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+    cache->append(l->objectLookupTwoClasses.ic, l->objectLookupTwoClasses.offset, false);
+    cache->append(l->objectLookupTwoClasses.ic2, l->objectLookupTwoClasses.offset2, false);
+    cache->append(resolved.objectLookup.ic, resolved.objectLookup.index, false);
+    l->clear();
+    l->polymorphicLookup.cache = cache;
+    l->setter = setterPolymorphic;
+    return true;
+}
+
+bool Lookup::setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    PolymorphicLookupCache *cache = l->polymorphicLookup.cache;
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        for (int i = 0; i < cache->count; ++i) {
+            const PolymorphicLookupCache::Entry &entry = cache->entries[i];
+            if (entry.ic == o->internalClass) {
+                ++cache->hits;
+                o->setProperty(engine, entry.offset, value);
+                return true;
+            }
+        }
+    }
+    ++cache->misses;
+
+    if (cache->count < PolymorphicLookupCache::Size && object.isObject()) {
+        Lookup resolved = *l;
+        if (!resolved.resolveSetter(engine, static_cast<Object *>(&object), value))
+            return false;
+        if (resolved.setter == setter0MemberData || resolved.setter == setter0Inline)
+            cache->append(resolved.objectLookup.ic, resolved.objectLookup.index, false);
+        return true;
+    }
+    // The site is megamorphic: keep the cached classes, and set others by name
     return setterFallback(l, engine, object, value);
 }
 
@@ -61,6 +61,39 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+/*
+    The classes seen by a getter or setter site that was hit with more than two
+    classes, holding data properties of the objects themselves. For getters,
+    offset is the offset of the inline property or the index into the member
+    data; for setters it is the property index.
+*/
+struct PolymorphicLookupCache
+{
+    enum { Size = 4 };
+    struct Entry {
+        Heap::InternalClass *ic;
+        uint offset;
+        bool inlineProperty;
+    };
+
+    Entry entries[Size];
+    int count = 0;
+    quint64 hits = 0;
+    quint64 misses = 0;
+
+    void append(Heap::InternalClass *ic, uint offset, bool inlineProperty)
+    {
+        Q_ASSERT(count < Size);
+        entries[count++] = { ic, offset, inlineProperty };
+    }
+
+    void markObjects(MarkStack *stack)
+    {
+        for (int i = 0; i < count; ++i)
+            entries[i].ic->mark(stack);
+    }
+};
+
 struct Q_QML_PRIVATE_EXPORT Lookup {
     union {
         ReturnedValue (*getter)(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -112,6 +145,12 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             uint offset;
             uint unused;
         } insertionLookup;
+        struct {
+            // the classes are marked through the cache
+            quintptr unused1;
+            quintptr unused2;
+            PolymorphicLookupCache *cache;
+        } polymorphicLookup;
         struct {
             quintptr _unused;
             quintptr _unused2;
@@ -187,6 +226,8 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static ReturnedValue getterProtoAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoAccessorTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterIndexed(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterToPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
 
     static ReturnedValue primitiveGetterProto(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue primitiveGetterAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -203,14 +244,24 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static bool setter0MemberData(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setter0Inline(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static bool setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static bool setterToPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool arrayLengthSetter(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
 
+    bool isPolymorphic() const { return getter == getterPolymorphic || setter == setterPolymorphic; }
+    void releasePolymorphicCache() {
+        delete polymorphicLookup.cache;
+        polymorphicLookup.cache = nullptr;
+    }
+
     void markObjects(MarkStack *stack) {
         if (markDef.h1 && !(reinterpret_cast<quintptr>(markDef.h1) & 1))
             markDef.h1->mark(stack);
         if (markDef.h2 && !(reinterpret_cast<quintptr>(markDef.h2) & 1))
             markDef.h2->mark(stack);
+        if (isPolymorphic())
+            polymorphicLookup.cache->markObjects(stack);
     }
 
     void clear() {
@@ -218,16 +218,86 @@ QQmlPropertyData *QObjectWrapper::findProperty(ExecutionEngine *engine, QQmlCont
     return findProperty(engine, o, qmlContext, name, revisionMode, local);
 }
 
+namespace {
+
+// Objects with a dynamic meta object (for example the ones created by language
+// bindings) never get a property cache, so every lookup on them would scan the
+// meta object by name. Remember the resolved properties and methods per meta
+// object and name instead.
+struct DynamicMetaObjectLookupKey
+{
+    const QMetaObject *metaObject;
+    QString name;
+    uint hash;
+
+    bool operator==(const DynamicMetaObjectLookupKey &other) const
+    { return metaObject == other.metaObject && hash == other.hash && name == other.name; }
+};
+
+inline uint qHash(const DynamicMetaObjectLookupKey &key, uint seed = 0)
+{
+    return key.hash ^ ::qHash(key.metaObject, seed);
+}
+
+struct DynamicMetaObjectLookupCache : public ExecutionEngine::Deletable
+{
+    enum { MaxEntries = 1024 };
+
+    DynamicMetaObjectLookupCache(ExecutionEngine *) {}
+
+    QHash<DynamicMetaObjectLookupKey, QQmlPropertyData> entries;
+};
+
+V4_DEFINE_EXTENSION(DynamicMetaObjectLookupCache, dynamicMetaObjectLookupCache)
+
+// Dynamic meta objects can change, so check that the cached index still
+// refers to a member of the same name before using it.
+bool isStillValid(const QMetaObject *mo, const QQmlPropertyData &data, const QString &name)
+{
+    const int index = data.coreIndex();
+    if (index < 0)
+        return false;
+    if (data.isFunction()) {
+        if (index >= mo->methodCount())
+            return false;
+        return QLatin1String(mo->method(index).name()) == name;
+    }
+    if (index >= mo->propertyCount())
+        return false;
+    return QLatin1String(mo->property(index).name()) == name;
+}
+
+} // namespace
+
 QQmlPropertyData *QObjectWrapper::findProperty(ExecutionEngine *engine, QObject *o, QQmlContextData *qmlContext, String *name, RevisionMode revisionMode, QQmlPropertyData *local)
 {
     Q_UNUSED(revisionMode);
 
     QQmlData *ddata = QQmlData::get(o, false);
-    QQmlPropertyData *result = nullptr;
     if (ddata && ddata->propertyCache)
-        result = ddata->propertyCache->property(name, o, qmlContext);
-    else
-        result = QQmlPropertyCache::property(engine->jsEngine(), o, name, qmlContext, *local);
+        return ddata->propertyCache->property(name, o, qmlContext);
+
+    DynamicMetaObjectLookupCache *cache = dynamicMetaObjectLookupCache(engine);
+    const DynamicMetaObjectLookupKey key = { o->metaObject(), name->toQString(), name->hashValue() };
+    const auto it = cache->entries.constFind(key);
+    if (it != cache->entries.constEnd()) {
+        if (isStillValid(key.metaObject, *it, key.name)) {
+            *local = *it;
+            return local;
+        }
+        cache->entries.erase(it);
+    }
+
+    QQmlPropertyData *result = QQmlPropertyCache::property(engine->jsEngine(), o, name, qmlContext, *local);
+
+    // Only results computed straight from the meta object are remembered; if
+    // the lookup created a property cache, the next one goes through it anyway.
+    ddata = QQmlData::get(o, false);
+    if (result == local && !(ddata && ddata->propertyCache)) {
+        if (cache->entries.size() >= DynamicMetaObjectLookupCache::MaxEntries)
+            cache->entries.clear();
+        cache->entries.insert(key, *local);
+    }
     return result;
 }
 
@@ -438,6 +508,7 @@ bool QObjectWrapper::setQmlProperty(ExecutionEngine *engine, QQmlContextData *qm
 
 void QObjectWrapper::setProperty(ExecutionEngine *engine, QObject *object, QQmlPropertyData *property, const Value &value)
 {
+    engine->invalidateCachedReferences();
     if (!property->isWritable() && !property->isQList()) {
         QString error = QLatin1String("Cannot assign to read-only property \"") +
                         property->name(object) + QLatin1Char('\"');
@@ -2068,6 +2139,7 @@ ReturnedValue QObjectMethod::virtualCall(const FunctionObject *m, const Value *t
 ReturnedValue QObjectMethod::callInternal(const Value *thisObject, const Value *argv, int argc) const
 {
     ExecutionEngine *v4 = engine();
+    v4->invalidateCachedReferences();
     if (d()->index == DestroyMethod)
         return method_destroy(v4, argv, argc);
     else if (d()->index == ToStringMethod)
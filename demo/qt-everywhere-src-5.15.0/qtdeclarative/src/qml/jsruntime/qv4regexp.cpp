@@ -69,6 +69,14 @@ RegExpCache::~RegExpCache()
     }
 }
 
+void RegExpCache::markObjects(MarkStack *markStack)
+{
+    for (Heap::RegExp *re : recent) {
+        if (re)
+            re->mark(markStack);
+    }
+}
+
 DEFINE_MANAGED_VTABLE(RegExp);
 
 uint RegExp::match(const QString &string, int start, uint *matchOffsets)
@@ -200,6 +208,7 @@ Heap::RegExp *RegExp::create(ExecutionEngine* engine, const QString& pattern, ui
 
     result->d()->cache = cache;
     cachedValue.set(engine, result);
+    cache->retain(result->d());
 
     return result->d();
 }
@@ -171,6 +171,22 @@ class RegExpCache : public QHash<RegExpCacheKey, WeakValue>
 {
 public:
     ~RegExpCache();
+
+    // The entries are weak, so that patterns which are no longer used get
+    // collected. The most recently compiled ones are additionally kept
+    // alive, so that patterns built at run time, e.g. by new RegExp() in a
+    // function called over and over, are not compiled again after every gc.
+    void retain(Heap::RegExp *re)
+    {
+        recent[nextRecent] = re;
+        nextRecent = (nextRecent + 1) % RecentSize;
+    }
+    void markObjects(MarkStack *markStack);
+
+private:
+    enum { RecentSize = 32 };
+    Heap::RegExp *recent[RecentSize] = {};
+    uint nextRecent = 0;
 };
 
 
@@ -0,0 +1,208 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qv4sampler_p.h"
+#include "qv4engine_p.h"
+#include "qv4function_p.h"
+#include "qv4stackframe_p.h"
+#include <private/qv4executablecompilationunit_p.h>
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtextstream.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+namespace Profiling {
+
+class SamplerThread : public QThread
+{
+public:
+    SamplerThread(Sampler *sampler) : m_sampler(sampler) {}
+
+    void stop()
+    {
+        m_stopped.storeRelease(1);
+        wait();
+    }
+
+protected:
+    void run() override
+    {
+        while (!m_stopped.loadAcquire()) {
+            QThread::usleep(ulong(m_sampler->m_interval));
+            m_sampler->m_pending.storeRelaxed(1);
+        }
+    }
+
+private:
+    Sampler *m_sampler;
+    QAtomicInt m_stopped;
+};
+
+Sampler::Sampler(int intervalUsecs)
+    : m_interval(qMax(intervalUsecs, 100))
+    , m_thread(new SamplerThread(this))
+{
+    m_thread->setObjectName(QStringLiteral("QV4 sampler"));
+    m_thread->start(QThread::LowPriority);
+}
+
+Sampler::~Sampler()
+{
+    m_thread->stop();
+
+    if (m_writeOnExit) {
+        const QString fileName = qEnvironmentVariable("QV4_SAMPLING_PROFILER_FILE");
+        if (fileName.isEmpty() || !writeResults(fileName)) {
+            for (const FunctionSamples &samples : results()) {
+                qDebug("%6d %6d  %s (%s:%d:%d)", samples.selfSamples, samples.totalSamples,
+                       qPrintable(samples.name), qPrintable(samples.file),
+                       samples.line, samples.column);
+            }
+        }
+    }
+
+    clear();
+}
+
+Sampler *Sampler::createFromEnvironment()
+{
+    bool ok;
+    const int interval = qEnvironmentVariableIntValue("QV4_SAMPLING_PROFILER", &ok);
+    if (!ok || interval <= 0)
+        return nullptr;
+    Sampler *sampler = new Sampler(interval);
+    sampler->m_writeOnExit = true;
+    return sampler;
+}
+
+void Sampler::retain(Function *function)
+{
+    // Keep the function, and thereby its location, around until the results
+    // have been reported
+    function->executableCompilationUnit()->addref();
+}
+
+void Sampler::takeSample(ExecutionEngine *engine)
+{
+    m_pending.storeRelaxed(0);
+
+    CppStackFrame *frame = engine->currentStackFrame;
+    if (!frame)
+        return;
+    ++m_sampleCount;
+
+    // Recursive functions are only counted once per sample in their total
+    QVarLengthArray<Function *, 32> seen;
+    bool innermost = true;
+    for (; frame; frame = frame->parent) {
+        Function *function = frame->v4Function;
+        if (!function)
+            continue;
+        auto it = m_counts.find(function);
+        if (it == m_counts.end()) {
+            retain(function);
+            it = m_counts.insert(function, Counts());
+        }
+        if (innermost) {
+            ++it->self;
+            innermost = false;
+        }
+        if (!seen.contains(function)) {
+            seen.append(function);
+            ++it->total;
+        }
+    }
+}
+
+QVector<Sampler::FunctionSamples> Sampler::results() const
+{
+    QVector<FunctionSamples> result;
+    result.reserve(m_counts.size());
+    for (auto it = m_counts.cbegin(), end = m_counts.cend(); it != end; ++it) {
+        Function *function = it.key();
+        result.append({ function->name()->toQString(),
+                        function->executableCompilationUnit()->fileName(),
+                        int(function->compiledFunction->location.line),
+                        int(function->compiledFunction->location.column),
+                        it->self, it->total });
+    }
+    std::sort(result.begin(), result.end(), [](const FunctionSamples &a, const FunctionSamples &b) {
+        return a.selfSamples > b.selfSamples
+                || (a.selfSamples == b.selfSamples && a.totalSamples > b.totalSamples);
+    });
+    return result;
+}
+
+bool Sampler::writeResults(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    QTextStream stream(&file);
+    stream << "# interval " << m_interval << "us, " << m_sampleCount << " samples\n"
+           << "# self\ttotal\tfunction\tlocation\n";
+    for (const FunctionSamples &samples : results()) {
+        stream << samples.selfSamples << '\t' << samples.totalSamples << '\t'
+               << samples.name << '\t'
+               << samples.file << ':' << samples.line << ':' << samples.column << '\n';
+    }
+    stream.flush();
+    return file.error() == QFile::NoError;
+}
+
+void Sampler::clear()
+{
+    for (auto it = m_counts.cbegin(), end = m_counts.cend(); it != end; ++it)
+        it.key()->executableCompilationUnit()->release();
+    m_counts.clear();
+    m_sampleCount = 0;
+}
+
+} // namespace Profiling
+} // namespace QV4
+
+QT_END_NAMESPACE
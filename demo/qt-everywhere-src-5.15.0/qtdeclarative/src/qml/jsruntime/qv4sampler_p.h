@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QV4SAMPLER_P_H
+#define QV4SAMPLER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qv4global_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+struct ExecutionEngine;
+struct Function;
+
+namespace Profiling {
+
+class SamplerThread;
+
+// A statistical profiler that is cheap enough to leave enabled. A helper
+// thread only raises a flag at the sampling interval; the engine's own thread
+// notices the flag on its next function entry and records which functions
+// are on the JS stack at that point. Samples are aggregated per function, so
+// memory use does not grow with the run time.
+class Q_QML_PRIVATE_EXPORT Sampler
+{
+    Q_DISABLE_COPY(Sampler)
+public:
+    struct FunctionSamples {
+        QString name;
+        QString file;
+        int line;
+        int column;
+        int selfSamples;    // the function was the innermost frame
+        int totalSamples;   // the function was anywhere on the stack
+    };
+
+    explicit Sampler(int intervalUsecs);
+    ~Sampler();
+
+    int interval() const { return m_interval; }
+    int sampleCount() const { return m_sampleCount; }
+
+    void checkForSample(ExecutionEngine *engine)
+    {
+        if (Q_UNLIKELY(m_pending.loadRelaxed()))
+            takeSample(engine);
+    }
+
+    // Sorted by self samples, most first.
+    QVector<FunctionSamples> results() const;
+    bool writeResults(const QString &fileName) const;
+    void clear();
+
+    // Creates a sampler if QV4_SAMPLING_PROFILER is set to an interval in
+    // microseconds. The results are written to QV4_SAMPLING_PROFILER_FILE,
+    // or to the debug output, when the sampler is destroyed.
+    static Sampler *createFromEnvironment();
+
+private:
+    friend class SamplerThread;
+
+    struct Counts {
+        int self = 0;
+        int total = 0;
+    };
+
+    void takeSample(ExecutionEngine *engine);
+    void retain(Function *function);
+
+    int m_interval;
+    int m_sampleCount = 0;
+    bool m_writeOnExit = false;
+    QAtomicInt m_pending;
+    QHash<Function *, Counts> m_counts;
+    QScopedPointer<SamplerThread> m_thread;
+};
+
+} // namespace Profiling
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QV4SAMPLER_P_H
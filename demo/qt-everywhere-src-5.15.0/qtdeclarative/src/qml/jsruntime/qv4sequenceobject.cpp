@@ -252,8 +252,11 @@ struct QQmlSequence : Object {
     mutable Container *container;
     QQmlQPointer<QObject> object;
     int propertyIndex;
+    // the engine's referenceGeneration when a reference was last loaded
+    mutable quint32 loadedGeneration;
     bool isReference : 1;
     bool isReadOnly : 1;
+    mutable bool isLoaded : 1;
 };
 
 }
@@ -588,12 +591,21 @@ public:
     void* getRawContainerPtr() const
     { return d()->container; }
 
+    // Reading the property copies the whole container, and for std::vector
+    // that is a deep copy. As long as no C++ code can have run since the last
+    // read, the copy we have is still current, which makes indexed reads in
+    // a loop O(1) instead of O(n).
     void loadReference() const
     {
         Q_ASSERT(d()->object);
         Q_ASSERT(d()->isReference);
+        const quint32 generation = engine()->referenceGeneration;
+        if (d()->isLoaded && d()->loadedGeneration == generation)
+            return;
         void *a[] = { d()->container, nullptr };
         QMetaObject::metacall(d()->object, QMetaObject::ReadProperty, d()->propertyIndex, a);
+        d()->loadedGeneration = generation;
+        d()->isLoaded = true;
     }
 
     void storeReference()
@@ -604,6 +616,8 @@ public:
         QQmlPropertyData::WriteFlags flags = QQmlPropertyData::DontRemoveBinding;
         void *a[] = { d()->container, nullptr, &status, &flags };
         QMetaObject::metacall(d()->object, QMetaObject::WriteProperty, d()->propertyIndex, a);
+        // the setter is free to store something else than what we passed
+        engine()->invalidateCachedReferences();
     }
 
     static QV4::ReturnedValue virtualGet(const QV4::Managed *that, PropertyKey id, const Value *receiver, bool *hasProperty)
@@ -642,8 +656,10 @@ void Heap::QQmlSequence<Container>::init(const Container &container)
     Object::init();
     this->container = new Container(container);
     propertyIndex = -1;
+    loadedGeneration = 0;
     isReference = false;
     isReadOnly = false;
+    isLoaded = false;
     object.init();
 
     QV4::Scope scope(internalClass->engine);
@@ -658,8 +674,10 @@ void Heap::QQmlSequence<Container>::init(QObject *object, int propertyIndex, boo
     Object::init();
     this->container = new Container;
     this->propertyIndex = propertyIndex;
+    loadedGeneration = 0;
     isReference = true;
     this->isReadOnly = readOnly;
+    isLoaded = false;
     this->object.init(object);
     QV4::Scope scope(internalClass->engine);
     QV4::Scoped<QV4::QQmlSequence<Container> > o(scope, this);
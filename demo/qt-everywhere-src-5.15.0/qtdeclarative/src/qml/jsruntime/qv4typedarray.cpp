@@ -47,6 +47,7 @@
 #include <QtCore/qatomic.h>
 
 #include <cmath>
+#include <type_traits>
 
 using namespace QV4;
 
@@ -135,6 +136,70 @@ double valueToType(Value value)
     return toDouble(value);
 }
 
+// Converts one element the way write<Dest>(read<Src>()) would, without going
+// through a Value. The integer and floating point cases reduce to plain casts,
+// which lets the compiler vectorize the loop in convertElements().
+template <typename Dest, typename Src, typename = void>
+struct ElementConversion
+{
+    static Dest convert(Src s) { return valueToType<Dest>(Value::fromReturnedValue(typeToValue(s))); }
+};
+
+template <typename Dest, typename Src>
+struct ElementConversion<Dest, Src, typename std::enable_if<std::is_integral<Dest>::value && std::is_integral<Src>::value>::type>
+{
+    static Dest convert(Src s) { return static_cast<Dest>(static_cast<qint32>(s)); }
+};
+
+template <typename Dest, typename Src>
+struct ElementConversion<Dest, Src, typename std::enable_if<std::is_floating_point<Dest>::value && std::is_arithmetic<Src>::value>::type>
+{
+    static Dest convert(Src s) { return static_cast<Dest>(s); }
+};
+
+template <typename Dest, typename Src>
+static void convertElements(char *dest, const char *src, uint count)
+{
+    Dest *d = reinterpret_cast<Dest *>(dest);
+    const Src *s = reinterpret_cast<const Src *>(src);
+    for (uint i = 0; i < count; ++i)
+        d[i] = ElementConversion<Dest, Src>::convert(s[i]);
+}
+
+typedef void (*ConvertElements)(char *dest, const char *src, uint count);
+
+template <typename Dest>
+struct ConversionsTo
+{
+    static constexpr ConvertElements from[NTypedArrayTypes] = {
+        convertElements<Dest, qint8>,
+        convertElements<Dest, quint8>,
+        convertElements<Dest, qint16>,
+        convertElements<Dest, quint16>,
+        convertElements<Dest, qint32>,
+        convertElements<Dest, quint32>,
+        convertElements<Dest, ClampedUInt8>,
+        convertElements<Dest, float>,
+        convertElements<Dest, double>
+    };
+};
+
+template <typename Dest>
+constexpr ConvertElements ConversionsTo<Dest>::from[NTypedArrayTypes];
+
+// Indexed by destination type, then by source type
+static const ConvertElements *const conversions[NTypedArrayTypes] = {
+    ConversionsTo<qint8>::from,
+    ConversionsTo<quint8>::from,
+    ConversionsTo<qint16>::from,
+    ConversionsTo<quint16>::from,
+    ConversionsTo<qint32>::from,
+    ConversionsTo<quint32>::from,
+    ConversionsTo<ClampedUInt8>::from,
+    ConversionsTo<float>::from,
+    ConversionsTo<double>::from
+};
+
 template <typename T>
 ReturnedValue read(const char *data) {
     return typeToValue(*reinterpret_cast<const T *>(data));
@@ -273,6 +338,16 @@ const TypedArrayOperations operations[NTypedArrayTypes] = {
     TypedArrayOperations::create<double>("Float64Array")
 };
 
+// Copies count elements of type srcType to dest, converting them to destType.
+// The two ranges must not overlap.
+static void copyElements(char *dest, uint destType, const char *src, uint srcType, uint count)
+{
+    if (destType == srcType)
+        memcpy(dest, src, size_t(count) * operations[destType].bytesPerElement);
+    else
+        conversions[destType][srcType](dest, src, count);
+}
+
 
 void Heap::TypedArrayCtor::init(QV4::ExecutionContext *scope, TypedArray::Type t)
 {
@@ -341,20 +416,8 @@ ReturnedValue TypedArrayCtor::virtualCallAsConstructor(const FunctionObject *f,
         const char *src = buffer->d()->data->data() + typedArray->d()->byteOffset;
         char *dest = newBuffer->d()->data->data();
 
-        // check if src and new type have the same size. In that case we can simply memcpy the data
-        if (srcElementSize == destElementSize) {
-            memcpy(dest, src, byteLength);
-        } else {
-            // not same size, we need to loop
-            uint l = typedArray->length();
-            TypedArrayOperations::Read read = typedArray->d()->type->read;
-            TypedArrayOperations::Write write =array->d()->type->write;
-            for (uint i = 0; i < l; ++i) {
-                Value val;
-                val.setRawValue(read(src + i*srcElementSize));
-                write(dest + i*destElementSize, val);
-            }
-        }
+        // the elements only need converting if the types differ, not just their sizes
+        copyElements(dest, that->d()->type, src, typedArray->d()->arrayType, typedArray->length());
 
         updateProto(scope, array);
         return array.asReturnedValue();
@@ -457,6 +520,19 @@ Heap::TypedArray *TypedArray::create(ExecutionEngine *e, Heap::TypedArray::Type
     return e->memoryManager->allocObject<TypedArray>(ic->d(), t);
 }
 
+QByteArray TypedArray::asByteArray() const
+{
+    if (d()->buffer->isDetachedBuffer())
+        return QByteArray();
+    // A view on the whole buffer shares the buffer's data
+    if (d()->byteOffset == 0 && d()->byteLength == d()->buffer->byteLength()) {
+        QByteArrayDataPtr ba = { d()->buffer->data };
+        ba.ptr->ref.ref();
+        return QByteArray(ba);
+    }
+    return QByteArray(constData(), int(d()->byteLength));
+}
+
 ReturnedValue TypedArray::virtualGet(const Managed *m, PropertyKey id, const Value *receiver, bool *hasProperty)
 {
     const bool isArrayIndex = id.isArrayIndex();
@@ -803,13 +879,25 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_fill(const FunctionObject *b,
     if (scope.hasException() || v->d()->buffer->isDetachedBuffer())
         return scope.engine->throwTypeError();
 
-    char *data = v->d()->buffer->data->data();
-    uint bytesPerElement = v->d()->type->bytesPerElement;
-    uint byteOffset = v->d()->byteOffset;
+    if (k >= fin)
+        return v.asReturnedValue();
 
-    while (k < fin) {
-        v->d()->type->write(data + byteOffset + k * bytesPerElement, value);
-        k++;
+    uint bytesPerElement = v->d()->type->bytesPerElement;
+    char *data = v->d()->buffer->data->data() + v->d()->byteOffset + k * bytesPerElement;
+    size_t byteCount = size_t(fin - k) * bytesPerElement;
+
+    // Convert the value once, then replicate its bytes, doubling the filled
+    // range each time
+    v->d()->type->write(data, value);
+    if (bytesPerElement == 1) {
+        memset(data + 1, *data, byteCount - 1);
+    } else {
+        size_t filled = bytesPerElement;
+        while (filled < byteCount) {
+            size_t n = qMin(filled, byteCount - filled);
+            memcpy(data + filled, data, n);
+            filled += n;
+        }
     }
 
     return v.asReturnedValue();
@@ -1467,15 +1555,8 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_set(const FunctionObject *b,
         src = srcCopy;
     }
 
-    // typed arrays of different kind, need to manually loop
-    uint srcElementSize = srcTypedArray->d()->type->bytesPerElement;
-    TypedArrayOperations::Read read = srcTypedArray->d()->type->read;
-    TypedArrayOperations::Write write = a->d()->type->write;
-    for (uint i = 0; i < l; ++i) {
-        Value val;
-        val.setRawValue(read(src + i*srcElementSize));
-        write(dest + i*elementSize, val);
-    }
+    // typed arrays of different kind, convert the elements in one go
+    copyElements(dest, a->d()->arrayType, src, srcTypedArray->d()->arrayType, l);
 
     if (srcCopy)
         delete [] srcCopy;
@@ -1516,6 +1597,25 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_slice(const FunctionObject *b
     if (!a)
         return Encode::undefined();
 
+    if (!count)
+        return a->asReturnedValue();
+    if (instance->d()->buffer->isDetachedBuffer() || a->d()->buffer->isDetachedBuffer())
+        return scope.engine->throwTypeError();
+
+    uint elementSize = instance->d()->type->bytesPerElement;
+    const char *src = instance->d()->buffer->data->data() + instance->d()->byteOffset + start * elementSize;
+    char *dest = a->d()->buffer->data->data() + a->d()->byteOffset;
+    if (a->d()->arrayType == instance->d()->arrayType) {
+        // ECMA 6 22.2.3.23, step 15: copy the bytes. The species constructor
+        // may have handed us a view on the same buffer, so use memmove.
+        memmove(dest, src, size_t(count) * elementSize);
+        return a->asReturnedValue();
+    }
+    if (a->d()->buffer->data != instance->d()->buffer->data) {
+        copyElements(dest, a->d()->arrayType, src, instance->d()->arrayType, count);
+        return a->asReturnedValue();
+    }
+
     ScopedValue v(scope);
     uint n = 0;
     for (uint i = start; i < end; ++i) {
@@ -163,6 +163,15 @@ struct Q_QML_PRIVATE_EXPORT TypedArray : Object
     Heap::TypedArray::Type arrayType() const {
         return static_cast<Heap::TypedArray::Type>(d()->arrayType);
     }
+
+    // The elements of the array, for handing them to C++ without copying.
+    // Only valid while the buffer is alive and not detached.
+    const char *constData() const {
+        Q_ASSERT(!d()->buffer->isDetachedBuffer());
+        return d()->buffer->data->data() + d()->byteOffset;
+    }
+    QByteArray asByteArray() const;
+
     using Object::get;
 
     static ReturnedValue virtualGet(const Managed *m, PropertyKey id, const Value *receiver, bool *hasProperty);
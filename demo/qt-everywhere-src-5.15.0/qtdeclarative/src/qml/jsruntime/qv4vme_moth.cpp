@@ -41,6 +41,8 @@
 
 #include <QtCore/qjsondocument.h>
 #include <QtCore/qjsonobject.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qloggingcategory.h>
 
 #include <private/qv4instr_moth_p.h>
 #include <private/qv4value_p.h>
@@ -54,14 +56,19 @@
 #include <private/qv4regexpobject_p.h>
 #include <private/qv4string_p.h>
 #include <private/qv4profiling_p.h>
+#include <private/qv4sampler_p.h>
 #include <private/qv4jscall_p.h>
 #include <private/qv4generatorobject_p.h>
 #include <private/qv4alloca_p.h>
 #include <private/qqmljavascriptexpression_p.h>
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 #if QT_CONFIG(qml_jit)
 #include <private/qv4baselinejit_p.h>
+
+Q_LOGGING_CATEGORY(lcJitStats, "qt.qml.jit.stats", QtWarningMsg)
 #endif
 
 #include <qtqml_tracepoints_p.h>
@@ -300,11 +307,17 @@ using namespace QV4;
 using namespace QV4::Moth;
 
 #ifdef COUNT_INSTRUCTIONS
+// Besides the instructions, the pairs of consecutive instructions are
+// counted: the most frequent ones are the candidates for superinstructions.
 static struct InstrCount {
+    enum { NumInstructions = MOTH_NUM_INSTRUCTIONS(), NumHotPairs = 32 };
+
     InstrCount() {
         fprintf(stderr, "Counting instructions...\n");
-        for (int i = 0; i < MOTH_NUM_INSTRUCTIONS(); ++i)
+        for (int i = 0; i < NumInstructions; ++i)
             hits[i] = 0;
+        for (int i = 0; i < NumInstructions * NumInstructions; ++i)
+            pairHits[i] = 0;
     }
     ~InstrCount() {
         fprintf(stderr, "Instruction count:\n");
@@ -312,9 +325,39 @@ static struct InstrCount {
         fprintf(stderr, "%llu : %s\n", hits[int(Instr::Type::I)], #I);
         FOR_EACH_MOTH_INSTR(BLAH)
         #undef BLAH
+
+        const char *names[NumInstructions] = {};
+#define BLAH(I) \
+        names[int(Instr::Type::I)] = #I;
+        FOR_EACH_MOTH_INSTR(BLAH)
+        #undef BLAH
+
+        std::vector<int> pairs;
+        for (int i = 0; i < NumInstructions * NumInstructions; ++i) {
+            if (pairHits[i])
+                pairs.push_back(i);
+        }
+        const size_t hotPairs = std::min<size_t>(pairs.size(), NumHotPairs);
+        std::partial_sort(pairs.begin(), pairs.begin() + hotPairs, pairs.end(), [this](int a, int b) {
+            return pairHits[a] > pairHits[b];
+        });
+        fprintf(stderr, "Hottest instruction pairs:\n");
+        for (size_t i = 0; i < hotPairs; ++i) {
+            const int first = pairs[i] / NumInstructions;
+            const int second = pairs[i] % NumInstructions;
+            fprintf(stderr, "%llu : %s + %s\n", pairHits[pairs[i]],
+                    names[first] ? names[first] : "?", names[second] ? names[second] : "?");
+        }
+    }
+    quint64 hits[NumInstructions];
+    quint64 pairHits[NumInstructions * NumInstructions];
+    int previous = -1;
+    void hit(Instr::Type i) {
+        hits[int(i)]++;
+        if (previous >= 0)
+            pairHits[previous * NumInstructions + int(i)]++;
+        previous = int(i);
     }
-    quint64 hits[MOTH_NUM_INSTRUCTIONS()];
-    void hit(Instr::Type i) { hits[int(i)]++; }
 } instrCount;
 #endif // COUNT_INSTRUCTIONS
 
@@ -427,8 +470,35 @@ static bool compareEqualInt(QV4::Value &accumulator, QV4::Value lhs, int rhs)
         } \
     } while (false)
 
+#if QT_CONFIG(qml_jit)
+// Compile a function that crossed the call count threshold. With
+// qt.qml.jit.stats.debug enabled this reports how hot the function was
+// and how long the baseline JIT took, which is what QV4_JIT_CALL_THRESHOLD
+// tuning needs.
+static void jitCompile(Function *function)
+{
+    if (!lcJitStats().isDebugEnabled()) {
+        QV4::JIT::BaselineJIT(function).generate();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QV4::JIT::BaselineJIT(function).generate();
+    const qint64 elapsed = timer.nsecsElapsed();
+    qCDebug(lcJitStats).nospace()
+            << "compiled " << function->name()->toQString()
+            << " (" << function->sourceFile() << ':' << function->compiledFunction->location.line
+            << ") after " << function->interpreterCallCount << " interpreted calls in "
+            << elapsed / 1000 << "us";
+}
+#endif // QT_CONFIG(qml_jit)
+
 ReturnedValue VME::exec(CppStackFrame *frame, ExecutionEngine *engine)
 {
+    // Entered from C++, which may have changed anything since JS last ran
+    if (!frame->parent)
+        engine->invalidateCachedReferences();
     qt_v4ResolvePendingBreakpointsHook();
     CHECK_STACK_LIMITS(engine);
 
@@ -438,13 +508,15 @@ ReturnedValue VME::exec(CppStackFrame *frame, ExecutionEngine *engine)
                   function->compiledFunction->location.line,
                   function->compiledFunction->location.column);
     Profiling::FunctionCallProfiler profiler(engine, function); // start execution profiling
+    if (Profiling::Sampler *sampler = engine->sampler())
+        sampler->checkForSample(engine);
     QV4::Debugging::Debugger *debugger = engine->debugger();
 
 #if QT_CONFIG(qml_jit)
     if (debugger == nullptr) {
         if (function->jittedCode == nullptr) {
             if (engine->canJIT(function))
-                QV4::JIT::BaselineJIT(function).generate();
+                jitCompile(function);
             else
                 ++function->interpreterCallCount;
         }
@@ -55,6 +55,7 @@ HEADERS += \
     $$PWD/qquickmultipointtoucharea_p.h \
     $$PWD/qquickscreen_p.h \
     $$PWD/qquickwindowattached_p.h \
+    $$PWD/qquickframestatistics_p.h \
     $$PWD/qquickwindowmodule_p.h \
     $$PWD/qquickrendercontrol.h \
     $$PWD/qquickrendercontrol_p.h \
@@ -97,6 +98,7 @@ SOURCES += \
     $$PWD/qquickwindowmodule.cpp \
     $$PWD/qquickscreen.cpp \
     $$PWD/qquickwindowattached.cpp \
+    $$PWD/qquickframestatistics.cpp \
     $$PWD/qquickrendercontrol.cpp \
     $$PWD/qquickgraphicsinfo.cpp \
     $$PWD/qquickitemgrabresult.cpp
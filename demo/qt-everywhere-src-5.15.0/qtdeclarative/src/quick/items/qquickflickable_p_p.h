@@ -174,6 +174,16 @@ public:
 
     bool flickX(qreal velocity);
     bool flickY(qreal velocity);
+
+    // The distance the content still travels before the current flick comes
+    // to rest, signed like smoothVelocity; 0 when not flicking.
+    qreal predictedFlickDistance(const AxisData &data) const {
+        if (!data.flicking || deceleration <= 0)
+            return 0;
+        const qreal v = data.smoothVelocity.value();
+        return v * qAbs(v) / (2 * deceleration);
+    }
+
     virtual bool flick(AxisData &data, qreal minExtent, qreal maxExtent, qreal vSize,
                         QQuickTimeLineCallback::Callback fixupCallback, qreal velocity);
     void flickingStarted(bool flickingH, bool flickingV);
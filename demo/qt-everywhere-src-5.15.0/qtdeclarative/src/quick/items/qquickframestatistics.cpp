@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickframestatistics_p.h"
+#include "qquickwindow.h"
+
+#include <QtGui/qscreen.h>
+
+QT_BEGIN_NAMESPACE
+
+// Gaps between frames longer than this many vsync intervals mean the window
+// was idle, not that frames were dropped.
+static const int idleFrameGap = 10;
+
+QQuickFrameStatistics::QQuickFrameStatistics(QQuickWindow *window, int capacity, int reportInterval)
+    : QObject(window)
+    , m_window(window)
+    , m_capacity(qMax(1, capacity))
+    , m_reportInterval(qMax(1, reportInterval))
+{
+    m_frames.reserve(m_capacity);
+    connect(window, &QQuickWindow::frameSwapped, this, &QQuickFrameStatistics::frameSwapped,
+            Qt::DirectConnection);
+}
+
+QVector<QQuickFrameStatistics::Frame> QQuickFrameStatistics::frames() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_frames.count() < m_capacity)
+        return m_frames;
+    QVector<Frame> result;
+    result.reserve(m_capacity);
+    for (int i = 0; i < m_capacity; ++i)
+        result.append(m_frames.at((m_next + i) % m_capacity));
+    return result;
+}
+
+quint64 QQuickFrameStatistics::frameCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_frameCount;
+}
+
+quint64 QQuickFrameStatistics::missedVSyncCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_missedVSyncCount;
+}
+
+void QQuickFrameStatistics::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_frames.clear();
+    m_next = 0;
+    m_frameCount = 0;
+    m_missedVSyncCount = 0;
+    m_awaitingSwap = false;
+}
+
+void QQuickFrameStatistics::beginPolish()
+{
+    m_polishTimer.start();
+}
+
+void QQuickFrameStatistics::endPolish()
+{
+    m_pendingPolishTime += m_polishTimer.nsecsElapsed();
+    const QScreen *screen = m_window->screen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 0;
+    m_pendingVSyncInterval = refreshRate > 0 ? qint64(1000000000 / refreshRate) : 0;
+}
+
+void QQuickFrameStatistics::beginSync()
+{
+    // The gui thread is blocked during sync, so its data can be picked up here.
+    m_current = Frame();
+    m_current.polishTime = m_pendingPolishTime;
+    m_pendingPolishTime = 0;
+    m_vsyncInterval = m_pendingVSyncInterval;
+    m_phaseTimer.start();
+}
+
+void QQuickFrameStatistics::endSync()
+{
+    m_current.syncTime = m_phaseTimer.nsecsElapsed();
+}
+
+void QQuickFrameStatistics::beginRender()
+{
+    if (m_frameTimer.isValid()) {
+        m_current.interval = m_frameTimer.nsecsElapsed();
+        if (m_vsyncInterval > 0 && m_current.interval <= idleFrameGap * m_vsyncInterval)
+            m_current.missedVSyncs = qMax(0, qRound(double(m_current.interval) / m_vsyncInterval) - 1);
+    }
+    m_frameTimer.start();
+    m_phaseTimer.start();
+}
+
+void QQuickFrameStatistics::endAnimations()
+{
+    m_current.animationTime = m_phaseTimer.nsecsElapsed();
+}
+
+void QQuickFrameStatistics::endRender()
+{
+    m_current.renderTime = m_phaseTimer.nsecsElapsed() - m_current.animationTime;
+    bool report;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_frames.count() < m_capacity)
+            m_frames.append(m_current);
+        else
+            m_frames[m_next] = m_current;
+        m_next = (m_next + 1) % m_capacity;
+        ++m_frameCount;
+        m_missedVSyncCount += m_current.missedVSyncs;
+        m_awaitingSwap = true;
+        report = m_frameCount % m_reportInterval == 0;
+    }
+    // Render thread animations can render frames without a sync.
+    m_current = Frame();
+    m_swapTimer.start();
+    if (report)
+        emit framesRecorded();
+}
+
+void QQuickFrameStatistics::frameSwapped()
+{
+    // Not every render loop swaps (QQuickRenderControl does not), so the
+    // swap time is filled into the frame that has already been recorded.
+    QMutexLocker locker(&m_mutex);
+    if (!m_awaitingSwap || m_frames.isEmpty())
+        return;
+    m_awaitingSwap = false;
+    m_frames[(m_next + m_capacity - 1) % m_capacity].swapTime = m_swapTimer.nsecsElapsed();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qquickframestatistics_p.cpp"
@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKFRAMESTATISTICS_P_H
+#define QQUICKFRAMESTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtquickglobal_p.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickWindow;
+
+// Records how long the phases of each frame of a window took. Enabled with
+// QQuickWindowPrivate::enableFrameStatistics(). Polishing happens on the gui
+// thread, synchronizing, rendering and swapping on the render thread; the
+// accessors can be used from any thread.
+class Q_QUICK_PRIVATE_EXPORT QQuickFrameStatistics : public QObject
+{
+    Q_OBJECT
+public:
+    // All times are in nanoseconds.
+    struct Frame
+    {
+        qint64 polishTime = 0;
+        qint64 syncTime = 0;
+        qint64 animationTime = 0;
+        qint64 renderTime = 0;
+        qint64 swapTime = 0;
+        qint64 interval = 0; // since the start of the previous frame's rendering
+        int missedVSyncs = 0;
+    };
+
+    QQuickFrameStatistics(QQuickWindow *window, int capacity, int reportInterval);
+
+    int capacity() const { return m_capacity; }
+    int reportInterval() const { return m_reportInterval; }
+
+    // The last capacity() frames, oldest first.
+    QVector<Frame> frames() const;
+    quint64 frameCount() const;
+    quint64 missedVSyncCount() const;
+    void clear();
+
+Q_SIGNALS:
+    // Emitted on the render thread after every reportInterval() frames.
+    void framesRecorded();
+
+private:
+    friend class QQuickWindowPrivate;
+
+    void beginPolish();
+    void endPolish();
+    void beginSync();
+    void endSync();
+    void beginRender();
+    void endAnimations();
+    void endRender();
+    void frameSwapped();
+
+    QQuickWindow *m_window;
+    const int m_capacity;
+    const int m_reportInterval;
+
+    // gui thread
+    QElapsedTimer m_polishTimer;
+    qint64 m_pendingPolishTime = 0;
+    qint64 m_pendingVSyncInterval = 0;
+
+    // render thread, or gui thread while it is blocked in sync
+    QElapsedTimer m_phaseTimer;
+    QElapsedTimer m_frameTimer;
+    QElapsedTimer m_swapTimer;
+    qint64 m_vsyncInterval = 0;
+    Frame m_current;
+
+    mutable QMutex m_mutex;
+    QVector<Frame> m_frames;
+    int m_next = 0;
+    quint64 m_frameCount = 0;
+    quint64 m_missedVSyncCount = 0;
+    bool m_awaitingSwap = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKFRAMESTATISTICS_P_H
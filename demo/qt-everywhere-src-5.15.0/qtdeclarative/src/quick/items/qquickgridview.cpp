@@ -576,7 +576,7 @@ void QQuickGridViewPrivate::removeItem(FxViewItem *item)
         item->releaseAfterTransition = true;
         releasePendingTransition.append(item);
     } else {
-        releaseItem(item, QQmlDelegateModel::NotReusable);
+        releaseItem(item, reusableFlag);
     }
 }
 
@@ -1239,6 +1239,23 @@ bool QQuickGridViewPrivate::flick(AxisData &data, qreal minExtent, qreal maxExte
             \image gridview-layout-toptobottom-rtl-btt.png
     \endtable
 
+    \section1 Reusing items
+
+    Like ListView, GridView can be configured to recycle items instead of
+    instantiating from the \l delegate whenever new items are flicked into view.
+    Reusing items is off by default, but can be switched on by setting the
+    \l reuseItems property to \c true.
+
+    When an item is flicked out, it moves to the \e{reuse pool}, and the
+    \l ListView::pooled signal is emitted to inform the item about it.
+    Likewise, when the item is moved back from the pool, the
+    \l ListView::reused signal is emitted. Any item properties that come
+    from the model, such as \c index and the model roles, are updated when
+    the item is reused.
+
+    \note Avoid storing any state inside a delegate. If you do, reset it
+    manually on receiving the \c reused signal.
+
     \sa {QML Data Models}, ListView, PathView, {Qt Quick Examples - Views}
 */
 
@@ -1379,6 +1396,20 @@ void QQuickGridView::setHighlightFollowsCurrentItem(bool autoHighlight)
   This property holds the number of items in the view.
 */
 
+/*!
+    \qmlproperty bool QtQuick::GridView::reuseItems
+
+    This property enables you to reuse items that are instantiated
+    from the \l delegate. If set to \c false, any currently
+    pooled items are destroyed.
+
+    This property is \c false by default.
+
+    \since 5.15
+
+    \sa {Reusing items}
+*/
+
 
 /*!
   \qmlproperty Component QtQuick::GridView::highlight
@@ -2156,6 +2187,13 @@ void QQuickGridView::keyPressEvent(QKeyEvent *event)
 void QQuickGridView::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
 {
     Q_D(QQuickGridView);
+
+    if (d->model) {
+        // When the view changes size, the number of columns may change too,
+        // so release all pooled items rather than keeping a stale pool.
+        d->model->drainReusableItemsPool(0);
+    }
+
     d->resetColumns();
 
     if (newGeometry.width() != oldGeometry.width()
@@ -1795,12 +1795,24 @@ void QQuickItemViewPrivate::refill(qreal from, qreal to)
         itemCount = model->count();
         qreal bufferFrom = from - buffer;
         qreal bufferTo = to + buffer;
+        if (buffer && bufferMode != NoBuffer) {
+            // Grow the buffer in the direction of a flick by the distance it
+            // will still travel, up to one view size, so delegates are
+            // created before they are needed.
+            const qreal ahead = predictedFlickDistance(layoutOrientation() == Qt::Vertical ? vData : hData);
+            const qreal extension = qMin(qAbs(ahead), qreal(size()));
+            if ((ahead > 0) != isContentFlowReversed())
+                bufferTo += extension;
+            else
+                bufferFrom -= extension;
+        }
         qreal fillFrom = from;
         qreal fillTo = to;
 
         bool added = addVisibleItems(fillFrom, fillTo, bufferFrom, bufferTo, false);
         bool removed = removeNonVisibleItems(bufferFrom, bufferTo);
 
+        cancelOutOfViewRequest();
         if (requestedIndex == -1 && buffer && bufferMode != NoBuffer) {
             if (added) {
                 // We've already created a new delegate this frame.
@@ -2324,6 +2336,26 @@ void QQuickItemViewPrivate::viewItemTransitionFinished(QQuickItemViewTransitiona
     }
 }
 
+/*
+  During a fast flick the delegate being incubated for the cache buffer can
+  scroll out of view before it is ready. Waiting for it would hold back the
+  delegates now needed in the direction of the flick, so cancel it instead.
+*/
+void QQuickItemViewPrivate::cancelOutOfViewRequest()
+{
+    if (requestedIndex == -1 || requestedIndex == currentIndex || visibleItems.isEmpty())
+        return;
+    const int lastIndex = findLastVisibleIndex();
+    if (lastIndex == -1)
+        return;
+    if (requestedIndex >= visibleIndex - 1 && requestedIndex <= lastIndex + 1)
+        return;
+
+    qCDebug(lcItemViewDelegateLifecycle) << "refill: cancel out of view item" << requestedIndex;
+    model->cancel(requestedIndex);
+    requestedIndex = -1;
+}
+
 /*
   This may return 0 if the item is being created asynchronously.
   When the item becomes available, refill() will be called and the item
@@ -182,6 +182,7 @@ public:
     void updateCurrent(int modelIndex);
     void updateTrackedItem();
     void updateUnrequestedIndexes();
+    void cancelOutOfViewRequest();
     void updateUnrequestedPositions();
     void updateVisibleIndex();
     void positionViewAtIndex(int index, int mode);
@@ -1464,19 +1464,21 @@ QQuickGrid::QQuickGrid(QQuickItem *parent)
 
 void QQuickGrid::setColumns(const int columns)
 {
+    Q_D(QQuickGrid);
     if (columns == m_columns)
         return;
     m_columns = columns;
-    prePositioning();
+    d->setPositioningDirty();
     emit columnsChanged();
 }
 
 void QQuickGrid::setRows(const int rows)
 {
+    Q_D(QQuickGrid);
     if (rows == m_rows)
         return;
     m_rows = rows;
-    prePositioning();
+    d->setPositioningDirty();
     emit rowsChanged();
 }
 
@@ -1500,9 +1502,10 @@ QQuickGrid::Flow QQuickGrid::flow() const
 
 void QQuickGrid::setFlow(Flow flow)
 {
+    Q_D(QQuickGrid);
     if (m_flow != flow) {
         m_flow = flow;
-        prePositioning();
+        d->setPositioningDirty();
         emit flowChanged();
     }
 }
@@ -1521,11 +1524,12 @@ void QQuickGrid::setFlow(Flow flow)
 */
 void QQuickGrid::setRowSpacing(const qreal rowSpacing)
 {
+    Q_D(QQuickGrid);
     if (rowSpacing == m_rowSpacing)
         return;
     m_rowSpacing = rowSpacing;
     m_useRowSpacing = true;
-    prePositioning();
+    d->setPositioningDirty();
     emit rowSpacingChanged();
 }
 
@@ -1543,11 +1547,12 @@ void QQuickGrid::setRowSpacing(const qreal rowSpacing)
 */
 void QQuickGrid::setColumnSpacing(const qreal columnSpacing)
 {
+    Q_D(QQuickGrid);
     if (columnSpacing == m_columnSpacing)
         return;
     m_columnSpacing = columnSpacing;
     m_useColumnSpacing = true;
-    prePositioning();
+    d->setPositioningDirty();
     emit columnSpacingChanged();
 }
 
@@ -1651,9 +1656,10 @@ QQuickGrid::HAlignment QQuickGrid::hItemAlign() const
 }
 void QQuickGrid::setHItemAlign(HAlignment align)
 {
+    Q_D(QQuickGrid);
     if (m_hItemAlign != align) {
         m_hItemAlign = align;
-        prePositioning();
+        d->setPositioningDirty();
         emit horizontalAlignmentChanged(align);
         emit effectiveHorizontalAlignmentChanged(effectiveHAlign());
     }
@@ -1684,9 +1690,10 @@ QQuickGrid::VAlignment QQuickGrid::vItemAlign() const
 }
 void QQuickGrid::setVItemAlign(VAlignment align)
 {
+    Q_D(QQuickGrid);
     if (m_vItemAlign != align) {
         m_vItemAlign = align;
-        prePositioning();
+        d->setPositioningDirty();
         emit verticalAlignmentChanged(align);
     }
 }
@@ -2042,7 +2049,7 @@ void QQuickFlow::setFlow(Flow flow)
     Q_D(QQuickFlow);
     if (d->flow != flow) {
         d->flow = flow;
-        prePositioning();
+        d->setPositioningDirty();
         emit flowChanged();
     }
 }
@@ -48,6 +48,8 @@
 #include <QtGui/qopengl.h>
 #include <QOpenGLFunctions>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*
@@ -522,6 +524,10 @@ void QQuickStochasticEngine::setCount(int c)
     m_goals.resize(c);
     m_duration.resize(c);
     m_startTimes.resize(c);
+    const int oldCount = m_updateTimes.count();
+    m_updateTimes.resize(c);
+    for (int i = oldCount; i < c; ++i)
+        m_updateTimes[i] = uint(-1);
 }
 
 void QQuickStochasticEngine::start(int index, int state)
@@ -545,8 +551,7 @@ void QQuickStochasticEngine::stop(int index)
     if (index >= m_things.count())
         return;
     //Will never change until start is called again with a new state (or manually advanced) - this is not a 'pause'
-    for (int i=0; i<m_stateUpdates.count(); i++)
-        m_stateUpdates[i].second.removeAll(index);
+    removeFromUpdateList(index);
 }
 
 void QQuickStochasticEngine::restart(int index)
@@ -558,8 +563,7 @@ void QQuickStochasticEngine::restart(int index)
     if (randomStart)
         m_startTimes[index] -= QRandomGenerator::global()->bounded(m_duration.at(index));
     int time = m_duration.at(index) + m_startTimes.at(index);
-    for (int i=0; i<m_stateUpdates.count(); i++)
-        m_stateUpdates[i].second.removeAll(index);
+    removeFromUpdateList(index);
     if (m_duration.at(index) >= 0)
         addToUpdateList(time, index);
 }
@@ -584,8 +588,7 @@ void QQuickSpriteEngine::restart(int index) //Reimplemented to recognize and han
                 time += spriteDuration(index);
         }
 
-        for (int i=0; i<m_stateUpdates.count(); i++)
-            m_stateUpdates[i].second.removeAll(index);
+        removeFromUpdateList(index);
         addToUpdateList(time, index);
     }
 }
@@ -767,22 +770,39 @@ int QQuickStochasticEngine::goalSeek(int curIdx, int spriteIdx, int dist)
     return -1;
 }
 
+static inline bool updateTimeLessThan(const QPair<uint, QVector<int> > &update, uint t)
+{
+    return update.first < t;
+}
+
 void QQuickStochasticEngine::addToUpdateList(uint t, int idx)
 {
-    for (int i=0; i<m_stateUpdates.count(); i++){
-        if (m_stateUpdates.at(i).first == t){
-            m_stateUpdates[i].second << idx;
-            return;
-        } else if (m_stateUpdates.at(i).first > t) {
-            QVector<int> tmpList;
-            tmpList << idx;
-            m_stateUpdates.insert(i, qMakePair(t, tmpList));
-            return;
-        }
+    //A thing is only ever queued once, so drop any earlier entry for it
+    removeFromUpdateList(idx);
+    if (idx < m_updateTimes.count())
+        m_updateTimes[idx] = t;
+
+    auto it = std::lower_bound(m_stateUpdates.begin(), m_stateUpdates.end(), t, updateTimeLessThan);
+    if (it != m_stateUpdates.end() && it->first == t) {
+        it->second << idx;
+        return;
     }
     QVector<int> tmpList;
     tmpList << idx;
-    m_stateUpdates << qMakePair(t, tmpList);
+    m_stateUpdates.insert(it, qMakePair(t, tmpList));
+}
+
+void QQuickStochasticEngine::removeFromUpdateList(int idx)
+{
+    if (idx >= m_updateTimes.count() || m_updateTimes.at(idx) == uint(-1))
+        return;
+    const uint t = m_updateTimes.at(idx);
+    m_updateTimes[idx] = uint(-1);
+
+    //Empty entries are left in place, updateSprites() may be iterating over them
+    auto it = std::lower_bound(m_stateUpdates.begin(), m_stateUpdates.end(), t, updateTimeLessThan);
+    if (it != m_stateUpdates.end() && it->first == t)
+        it->second.removeOne(idx);
 }
 
 QT_END_NAMESPACE
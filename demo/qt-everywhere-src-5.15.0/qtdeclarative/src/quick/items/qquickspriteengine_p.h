@@ -244,6 +244,7 @@ public Q_SLOTS:
 protected:
     friend class QQuickParticleSystem;
     void addToUpdateList(uint t, int idx);
+    void removeFromUpdateList(int idx);
     int nextState(int curState, int idx=0);
     int goalSeek(int curState, int idx, int dist=-1);
     QList<QQuickStochasticState*> m_states;
@@ -252,7 +253,8 @@ protected:
     QVector<int> m_goals;
     QVector<int> m_duration;
     QVector<int> m_startTimes;
-    QVector<QPair<uint, QVector<int> > > m_stateUpdates;//### This could be done faster - priority queue?
+    QVector<QPair<uint, QVector<int> > > m_stateUpdates;//Sorted by time, one entry per time
+    QVector<uint> m_updateTimes;//Time each thing is queued for in m_stateUpdates, or uint(-1)
 
     QElapsedTimer m_advanceTimer;
     uint m_timeOffset;
@@ -1783,7 +1783,10 @@ void QQuickText::setColor(const QColor &color)
 
     d->color = rgb;
     if (isComponentComplete())  {
-        d->updateType = QQuickTextPrivate::UpdatePaintNode;
+        // Only the color of the glyphs changes, so the existing nodes can be
+        // kept if nothing else asked for a rebuild.
+        if (d->updateType != QQuickTextPrivate::UpdatePaintNode)
+            d->updateType = QQuickTextPrivate::UpdateColor;
         update();
     }
     emit colorChanged();
@@ -2458,7 +2461,15 @@ QSGNode *QQuickText::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data
         return nullptr;
     }
 
-    if (d->updateType != QQuickTextPrivate::UpdatePaintNode && oldNode != nullptr) {
+    if (d->updateType == QQuickTextPrivate::UpdateColor && oldNode != nullptr
+            && d->canUpdateGlyphColor()) {
+        d->updateType = QQuickTextPrivate::UpdateNone;
+        static_cast<QQuickTextNode *>(oldNode)->setGlyphColor(QColor::fromRgba(d->color));
+        return oldNode;
+    }
+
+    if (d->updateType != QQuickTextPrivate::UpdatePaintNode
+            && d->updateType != QQuickTextPrivate::UpdateColor && oldNode != nullptr) {
         // Update done in preprocess() in the nodes
         d->updateType = QQuickTextPrivate::UpdateNone;
         return oldNode;
@@ -2518,6 +2529,21 @@ QSGNode *QQuickText::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data
     return node;
 }
 
+/*
+  Plain text without decorations is drawn entirely by glyph nodes in the text
+  color, so a color change can be applied to the existing nodes.
+*/
+bool QQuickTextPrivate::canUpdateGlyphColor() const
+{
+    if (richText || styledText || style != QQuickText::Normal)
+        return false;
+    if (font.underline() || font.overline() || font.strikeOut())
+        return false;
+    if (extra.isAllocated() && !extra->visibleImgTags.isEmpty())
+        return false;
+    return true;
+}
+
 void QQuickText::updatePolish()
 {
     Q_D(QQuickText);
@@ -81,6 +81,7 @@ public:
     bool setHAlign(QQuickText::HAlignment, bool forceAlign = false);
     void mirrorChange() override;
     bool isLineLaidOutConnected();
+    bool canUpdateGlyphColor() const;
     void setLineGeometry(QTextLine &line, qreal lineWidth, qreal &height);
 
     int lineHeightOffset() const;
@@ -143,6 +144,7 @@ public:
     enum UpdateType {
         UpdateNone,
         UpdatePreprocess,
+        UpdateColor,
         UpdatePaintNode
     };
 
@@ -128,10 +128,22 @@ QSGGlyphNode *QQuickTextNode::addGlyphs(const QPointF &position, const QGlyphRun
     if (parentNode == nullptr)
         parentNode = this;
     parentNode->appendChildNode(node);
+    m_glyphNodes.append(node);
 
     return node;
 }
 
+/*!
+  Changes the color of all the glyph nodes added since the last call to
+  deleteContent(), without recreating them. Only useful when all the glyphs
+  were added in the same color.
+*/
+void QQuickTextNode::setGlyphColor(const QColor &color)
+{
+    for (QSGGlyphNode *node : qAsConst(m_glyphNodes))
+        node->setColor(color);
+}
+
 void QQuickTextNode::setCursor(const QRectF &rect, const QColor &color)
 {
     if (m_cursorNode != nullptr)
@@ -276,6 +288,7 @@ void QQuickTextNode::deleteContent()
     while (firstChild() != nullptr)
         delete firstChild();
     m_cursorNode = nullptr;
+    m_glyphNodes.clear();
     qDeleteAll(m_textures);
     m_textures.clear();
 }
@@ -104,6 +104,7 @@ public:
                             QSGNode *parentNode = 0);
     void addImage(const QRectF &rect, const QImage &image);
     void addRectangleNode(const QRectF &rect, const QColor &color);
+    void setGlyphColor(const QColor &color);
 
     bool useNativeRenderer() const { return m_useNativeRenderer; }
     void setUseNativeRenderer(bool on) { m_useNativeRenderer = on; }
@@ -111,6 +112,7 @@ public:
 private:
     QSGInternalRectangleNode *m_cursorNode;
     QList<QSGTexture *> m_textures;
+    QVarLengthArray<QSGGlyphNode *, 8> m_glyphNodes;
     QQuickItem *m_ownerElement;
     bool m_useNativeRenderer;
 
@@ -57,6 +57,7 @@
 #include <private/qquickrendercontrol_p.h>
 #include <private/qquickanimatorcontroller_p.h>
 #include <private/qquickprofiler_p.h>
+#include <private/qquickframestatistics_p.h>
 
 #include <private/qguiapplication_p.h>
 #include <QtGui/QInputMethod>
@@ -307,6 +308,8 @@ void QQuickWindowPrivate::polishItems()
     // In the case where polish is called from updatePolish() either directly
     // or indirectly, we use a recursionSafeguard to print a warning to
     // the user.
+    if (frameStatistics)
+        frameStatistics->beginPolish();
     int recursionSafeguard = INT_MAX;
     while (!itemsToPolish.isEmpty() && --recursionSafeguard > 0) {
         QQuickItem *item = itemsToPolish.takeLast();
@@ -319,6 +322,9 @@ void QQuickWindowPrivate::polishItems()
     if (recursionSafeguard == 0)
         qWarning("QQuickWindow: possible QQuickItem::polish() loop");
 
+    if (frameStatistics)
+        frameStatistics->endPolish();
+
 #if QT_CONFIG(im)
     if (QQuickItem *focusItem = q_func()->activeFocusItem()) {
         // If the current focus item, or any of its anchestors, has changed location
@@ -425,6 +431,9 @@ void QQuickWindowPrivate::syncSceneGraph()
 {
     Q_Q(QQuickWindow);
 
+    if (frameStatistics)
+        frameStatistics->beginSync();
+
     // Calculate the dpr the same way renderSceneGraph() will.
     qreal devicePixelRatio = q->effectiveDevicePixelRatio();
     if (renderTargetId && !QQuickRenderControl::renderWindowFor(q))
@@ -460,6 +469,9 @@ void QQuickWindowPrivate::syncSceneGraph()
 
     emit q->afterSynchronizing();
     runAndClearJobs(&afterSynchronizingJobs);
+
+    if (frameStatistics)
+        frameStatistics->endSync();
 }
 
 void QQuickWindowPrivate::emitBeforeRenderPassRecording(void *ud)
@@ -480,6 +492,9 @@ void QQuickWindowPrivate::renderSceneGraph(const QSize &size, const QSize &surfa
     if (!renderer)
         return;
 
+    if (frameStatistics)
+        frameStatistics->beginRender();
+
     if (rhi) {
         // ### no offscreen ("renderTargetId") support yet
         context->beginNextRhiFrame(renderer,
@@ -497,6 +512,8 @@ void QQuickWindowPrivate::renderSceneGraph(const QSize &size, const QSize &surfa
     }
 
     animationController->advance();
+    if (frameStatistics)
+        frameStatistics->endAnimations();
     emit q->beforeRendering();
     runAndClearJobs(&beforeRenderingJobs);
     if (!customRenderStage || !customRenderStage->render()) {
@@ -548,6 +565,9 @@ void QQuickWindowPrivate::renderSceneGraph(const QSize &size, const QSize &surfa
     else
         context->endNextFrame(renderer);
 
+    if (frameStatistics)
+        frameStatistics->endRender();
+
     if (renderer && renderer->hasCustomRenderModeWithContinuousUpdate()) {
         // For the overdraw visualizer. This update is not urgent so avoid a
         // direct update() call, this is only here to keep the overdraw
@@ -556,6 +576,22 @@ void QQuickWindowPrivate::renderSceneGraph(const QSize &size, const QSize &surfa
     }
 }
 
+/*!
+    \internal
+
+    Starts recording the timings of the window's frames, keeping the last
+    \a capacity frames and emitting QQuickFrameStatistics::framesRecorded()
+    every \a reportInterval frames. Must be called on the gui thread before
+    the window is exposed; later calls return the existing statistics.
+*/
+QQuickFrameStatistics *QQuickWindowPrivate::enableFrameStatistics(int capacity, int reportInterval)
+{
+    Q_Q(QQuickWindow);
+    if (!frameStatistics)
+        frameStatistics = new QQuickFrameStatistics(q, capacity, reportInterval);
+    return frameStatistics;
+}
+
 QQuickWindowPrivate::QQuickWindowPrivate()
     : contentItem(nullptr)
     , activeFocusItem(nullptr)
@@ -2516,22 +2552,44 @@ void QQuickWindowPrivate::deliverPointerEvent(QQuickPointerEvent *event)
 QVector<QQuickItem *> QQuickWindowPrivate::pointerTargets(QQuickItem *item, QQuickEventPoint *point, bool checkMouseButtons, bool checkAcceptsTouch) const
 {
     QVector<QQuickItem *> targets;
+    collectPointerTargets(item, item->mapFromScene(point->scenePosition()), point, checkMouseButtons, checkAcceptsTouch, &targets);
+    return targets;
+}
+
+/*
+    Most items are only translated relative to their parent, so the point can
+    be mapped from the parent's coordinates instead of going through the
+    item's full transform from the window, which walks up to the root item
+    for every item that is tested.
+*/
+static inline QPointF mapFromParentItem(QQuickItem *child, const QPointF &parentPos, const QPointF &scenePos)
+{
+    QQuickItemPrivate *childPrivate = QQuickItemPrivate::get(child);
+    if (childPrivate->transforms.isEmpty() && childPrivate->scale() == 1. && childPrivate->rotation() == 0.)
+        return QPointF(parentPos.x() - childPrivate->x, parentPos.y() - childPrivate->y);
+    return child->mapFromScene(scenePos);
+}
+
+void QQuickWindowPrivate::collectPointerTargets(QQuickItem *item, const QPointF &itemPos, QQuickEventPoint *point, bool checkMouseButtons,
+                                                bool checkAcceptsTouch, QVector<QQuickItem *> *targets) const
+{
     auto itemPrivate = QQuickItemPrivate::get(item);
-    QPointF itemPos = item->mapFromScene(point->scenePosition());
     // if the item clips, we can potentially return early
     if (itemPrivate->flags & QQuickItem::ItemClipsChildrenToShape) {
         if (!item->contains(itemPos))
-            return targets;
+            return;
     }
 
     // recurse for children
+    const QPointF scenePos = point->scenePosition();
     QList<QQuickItem *> children = itemPrivate->paintOrderChildItems();
     for (int ii = children.count() - 1; ii >= 0; --ii) {
         QQuickItem *child = children.at(ii);
         auto childPrivate = QQuickItemPrivate::get(child);
         if (!child->isVisible() || !child->isEnabled() || childPrivate->culled)
             continue;
-        targets << pointerTargets(child, point, checkMouseButtons, checkAcceptsTouch);
+        collectPointerTargets(child, mapFromParentItem(child, itemPos, scenePos), point,
+                              checkMouseButtons, checkAcceptsTouch, targets);
     }
 
     bool relevant = item->contains(itemPos);
@@ -2546,8 +2604,7 @@ QVector<QQuickItem *> QQuickWindowPrivate::pointerTargets(QQuickItem *item, QQui
             relevant = false;
     }
     if (relevant)
-        targets << item; // add this item last: children take precedence
-    return targets;
+        targets->append(item); // add this item last: children take precedence
 }
 
 // return the joined lists
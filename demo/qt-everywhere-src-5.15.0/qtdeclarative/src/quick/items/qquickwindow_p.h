@@ -74,6 +74,7 @@ QT_BEGIN_NAMESPACE
 class QOpenGLVertexArrayObjectHelper;
 class QQuickAnimatorController;
 class QQuickDragGrabber;
+class QQuickFrameStatistics;
 class QQuickItemPrivate;
 class QQuickPointerDevice;
 class QQuickRenderControl;
@@ -184,6 +185,8 @@ public:
     void deliverMatchingPointsToItem(QQuickItem *item, QQuickPointerEvent *pointerEvent, bool handlersOnly = false);
 
     QVector<QQuickItem *> pointerTargets(QQuickItem *, QQuickEventPoint *point, bool checkMouseButtons, bool checkAcceptsTouch) const;
+    void collectPointerTargets(QQuickItem *item, const QPointF &itemPos, QQuickEventPoint *point, bool checkMouseButtons,
+                               bool checkAcceptsTouch, QVector<QQuickItem *> *targets) const;
     QVector<QQuickItem *> mergePointerTargets(const QVector<QQuickItem *> &list1, const QVector<QQuickItem *> &list2) const;
 
     // hover delivery
@@ -330,6 +333,9 @@ public:
     uint hasRenderableSwapchain : 1;
     uint swapchainJustBecameRenderable : 1;
 
+    QQuickFrameStatistics *enableFrameStatistics(int capacity = 240, int reportInterval = 60);
+    QQuickFrameStatistics *frameStatistics = nullptr;
+
 private:
     static void cleanupNodesOnShutdown(QQuickItem *);
 };
@@ -0,0 +1,6 @@
+TEMPLATE = app
+CONFIG += benchmark
+QT = core qml testlib
+
+TARGET = tst_bench_internalclass
+SOURCES += tst_internalclass.cpp
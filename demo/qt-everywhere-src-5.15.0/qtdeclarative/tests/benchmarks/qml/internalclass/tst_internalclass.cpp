@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtQml/QJSEngine>
+#include <QtQml/QJSValue>
+#include <QtTest/QtTest>
+
+// Object construction workloads which create many internal classes and
+// transitions: model rows built property by property, rows of differing
+// shapes and rows parsed from JSON.
+class tst_InternalClass : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sameShapeRows_data() { data(); }
+    void sameShapeRows();
+    void distinctShapeRows_data() { data(); }
+    void distinctShapeRows();
+    void jsonRows_data() { data(); }
+    void jsonRows();
+
+private:
+    void data();
+    void run(const QString &program);
+};
+
+void tst_InternalClass::data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("properties");
+
+    for (int properties : { 8, 32, 128 })
+        QTest::newRow(QByteArray::number(properties) + " properties") << 1000 << properties;
+}
+
+void tst_InternalClass::run(const QString &program)
+{
+    QJSEngine engine;
+    QJSValue function = engine.evaluate(program);
+    QVERIFY(function.isCallable());
+
+    QFETCH(int, rows);
+    QFETCH(int, properties);
+    QBENCHMARK {
+        QJSValue result = function.call({ rows, properties });
+        QVERIFY(!result.isError());
+    }
+}
+
+// All the rows have the same properties: one class chain, followed again and again
+void tst_InternalClass::sameShapeRows()
+{
+    run(QStringLiteral(
+        "(function(rows, properties) {"
+        "    var model = [];"
+        "    for (var i = 0; i < rows; ++i) {"
+        "        var row = {};"
+        "        for (var j = 0; j < properties; ++j)"
+        "            row['role' + j] = i + j;"
+        "        model.push(row);"
+        "    }"
+        "    return model.length;"
+        "})"));
+}
+
+// Every row starts with a different property: the empty class gets a
+// transition per row
+void tst_InternalClass::distinctShapeRows()
+{
+    run(QStringLiteral(
+        "(function(rows, properties) {"
+        "    var model = [];"
+        "    for (var i = 0; i < rows; ++i) {"
+        "        var row = {};"
+        "        row['id' + i] = i;"
+        "        for (var j = 0; j < properties; ++j)"
+        "            row['role' + j] = i + j;"
+        "        model.push(row);"
+        "    }"
+        "    return model.length;"
+        "})"));
+}
+
+void tst_InternalClass::jsonRows()
+{
+    run(QStringLiteral(
+        "(function(rows, properties) {"
+        "    var row = {};"
+        "    for (var j = 0; j < properties; ++j)"
+        "        row['role' + j] = j;"
+        "    var json = JSON.stringify(new Array(rows).fill(row));"
+        "    return JSON.parse(json).length;"
+        "})"));
+}
+
+QTEST_MAIN(tst_InternalClass)
+
+#include "tst_internalclass.moc"
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <list>
 #include <unordered_set>
 #include <unordered_map>
@@ -91,7 +92,7 @@ public:
         } else {
             auto it = pendingRequestsMap.find(request);
             if (it != pendingRequestsMap.end()) {
-                pendingRequestsList.erase(it->second);
+                erasePendingRequest(it->second);
                 pendingRequestsMap.erase(it);
             }
         }
@@ -111,11 +112,25 @@ public:
     }
 
     void queueRequest(OnlineFileRequest* request) {
-        auto it = pendingRequestsList.insert(pendingRequestsList.end(), request);
+        // Other resources (style, sources, sprites, glyphs) are served first, in
+        // FIFO order. Tiles come after them, newest first: when zooming or panning
+        // quickly, the latest tile requests are the ones for the current viewport,
+        // and the older ones are cancelled anyway once their tiles get dropped.
+        auto it = pendingRequestsList.insert(firstPendingTileRequest, request);
+        if (request->resource.kind == Resource::Kind::Tile) {
+            firstPendingTileRequest = it;
+        }
         pendingRequestsMap.emplace(request, std::move(it));
         assert(pendingRequestsMap.size() == pendingRequestsList.size());
     }
 
+    void erasePendingRequest(std::list<OnlineFileRequest*>::iterator it) {
+        if (it == firstPendingTileRequest) {
+            firstPendingTileRequest = std::next(it);
+        }
+        pendingRequestsList.erase(it);
+    }
+
     void activateRequest(OnlineFileRequest* request) {
         auto callback = [=](Response response) {
             activeRequests.erase(request);
@@ -144,7 +159,7 @@ public:
         }
 
         OnlineFileRequest* request = pendingRequestsList.front();
-        pendingRequestsList.pop_front();
+        erasePendingRequest(pendingRequestsList.begin());
 
         pendingRequestsMap.erase(request);
 
@@ -192,6 +207,8 @@ private:
     std::unordered_set<OnlineFileRequest*> allRequests;
     std::list<OnlineFileRequest*> pendingRequestsList;
     std::unordered_map<OnlineFileRequest*, std::list<OnlineFileRequest*>::iterator> pendingRequestsMap;
+    // Tile requests are queued from this position to the end of pendingRequestsList
+    std::list<OnlineFileRequest*>::iterator firstPendingTileRequest = pendingRequestsList.end();
     std::unordered_set<OnlineFileRequest*> activeRequests;
 
     bool online = true;
@@ -292,41 +292,52 @@ void QGeoMapPolygonGeometry::updateScreenPoints(const QGeoMap &map, qreal stroke
     ppi.closeSubpath();
     screenOutline_ = ppi;
 
-    using Coord = double;
-    using N = uint32_t;
-    using Point = std::array<Coord, 2>;
+    if (ppi == tessellatedOutline_) {
+        // The outline is unchanged relative to its bounding box, e.g. when
+        // the map is panned, so there is no need to run earcut again
+        screenVertices_ = tessellatedVertices_;
+        screenIndices_ = tessellatedIndices_;
+    } else {
+        using Coord = double;
+        using N = uint32_t;
+        using Point = std::array<Coord, 2>;
+
+        std::vector<std::vector<Point>> polygon;
+        polygon.push_back(std::vector<Point>());
+        std::vector<Point> &poly = polygon.front();
+        // ... fill polygon structure with actual data
+
+        for (int i = 0; i < ppi.elementCount(); ++i) {
+            const QPainterPath::Element e = ppi.elementAt(i);
+            if (e.isMoveTo() || i == ppi.elementCount() - 1
+                    || (qAbs(e.x - poly.front()[0]) < 0.1
+                        && qAbs(e.y - poly.front()[1]) < 0.1)) {
+                Point p = {{ e.x, e.y }};
+                poly.push_back( p );
+            } else if (e.isLineTo()) {
+                Point p = {{ e.x, e.y }};
+                poly.push_back( p );
+            } else {
+                qWarning("Unhandled element type in polygon painterpath");
+            }
+        }
 
-    std::vector<std::vector<Point>> polygon;
-    polygon.push_back(std::vector<Point>());
-    std::vector<Point> &poly = polygon.front();
-    // ... fill polygon structure with actual data
-
-    for (int i = 0; i < ppi.elementCount(); ++i) {
-        const QPainterPath::Element e = ppi.elementAt(i);
-        if (e.isMoveTo() || i == ppi.elementCount() - 1
-                || (qAbs(e.x - poly.front()[0]) < 0.1
-                    && qAbs(e.y - poly.front()[1]) < 0.1)) {
-            Point p = {{ e.x, e.y }};
-            poly.push_back( p );
-        } else if (e.isLineTo()) {
-            Point p = {{ e.x, e.y }};
-            poly.push_back( p );
-        } else {
-            qWarning("Unhandled element type in polygon painterpath");
+        if (poly.size() > 2) {
+            // Run tessellation
+            // Returns array of indices that refer to the vertices of the input polygon.
+            // Three subsequent indices form a triangle.
+            screenVertices_.clear();
+            screenIndices_.clear();
+            for (const auto &p : poly)
+                screenVertices_ << QPointF(p[0], p[1]);
+            std::vector<N> indices = qt_mapbox::earcut<N>(polygon);
+            for (const auto &i: indices)
+                screenIndices_ << quint32(i);
         }
-    }
 
-    if (poly.size() > 2) {
-        // Run tessellation
-        // Returns array of indices that refer to the vertices of the input polygon.
-        // Three subsequent indices form a triangle.
-        screenVertices_.clear();
-        screenIndices_.clear();
-        for (const auto &p : poly)
-            screenVertices_ << QPointF(p[0], p[1]);
-        std::vector<N> indices = qt_mapbox::earcut<N>(polygon);
-        for (const auto &i: indices)
-            screenIndices_ << quint32(i);
+        tessellatedOutline_ = ppi;
+        tessellatedVertices_ = screenVertices_;
+        tessellatedIndices_ = screenIndices_;
     }
 
     screenBounds_ = ppi.boundingRect();
@@ -339,10 +350,7 @@ QGeoMapPolygonGeometryOpenGL::QGeoMapPolygonGeometryOpenGL(){
 
 void QGeoMapPolygonGeometryOpenGL::updateSourcePoints(const QGeoMap &map, const QList<QDoubleVector2D> &path)
 {
-    QList<QGeoCoordinate> geopath;
-    for (const auto &c: path)
-        geopath.append(QWebMercator::mercatorToCoord(c));
-    updateSourcePoints(map, geopath);
+    updateSourcePoints(map, QWebMercator::mercatorToCoord(path));
 }
 
 // wrapPath always preserves the geometry
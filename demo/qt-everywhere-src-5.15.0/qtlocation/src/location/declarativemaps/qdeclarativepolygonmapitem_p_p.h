@@ -87,6 +87,12 @@ public:
 protected:
     QPainterPath srcPath_;
     bool assumeSimple_;
+
+    // Last tessellated outline and its triangles, reused when only the
+    // position of the polygon on the screen changes
+    QPainterPath tessellatedOutline_;
+    QVector<QPointF> tessellatedVertices_;
+    QVector<quint32> tessellatedIndices_;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoMapPolygonGeometryOpenGL : public QGeoMapItemGeometry
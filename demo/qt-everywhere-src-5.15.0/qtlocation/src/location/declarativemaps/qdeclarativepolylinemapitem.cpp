@@ -1938,6 +1938,22 @@ QVector<QDeclarativeGeoMapItemUtils::vec2> QGeoMapItemLODGeometry::getSimplified
     return simple;
 }
 
+QVector<QDeclarativeGeoMapItemUtils::vec2> QGeoMapItemLODGeometry::getSimplified(
+       const QVector<QDeclarativeGeoMapItemUtils::vec2> &wrappedPath,
+                                                  const QVector<double> &importance,
+                                                  unsigned int zoom)
+{
+    // Same result as the overload above, filtering the precomputed importance
+    Q_ASSERT(importance.size() == wrappedPath.size());
+    const double scale = double(1u << zoom);
+    QVector<QDeclarativeGeoMapItemUtils::vec2> simple;
+    for (int i = 0; i < wrappedPath.size(); ++i) {
+        if (importance.at(i) * scale > 1.0)
+            simple << wrappedPath.at(i);
+    }
+    return simple;
+}
+
 
 bool QGeoMapItemLODGeometry::isLODActive(unsigned int lod) const
 {
@@ -1949,6 +1965,7 @@ class PolylineSimplifyTask : public QRunnable
 public:
     PolylineSimplifyTask(const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &input, // reference as it gets copied in the nested call
                          const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &output,
+                         const QSharedPointer<QGeoMapItemLODImportance> &importance,
                          double leftBound,
                          unsigned int zoom,
                          QSharedPointer<unsigned int> &working)
@@ -1956,10 +1973,12 @@ public:
         , m_leftBound(leftBound)
         , m_input(input)
         , m_output(output)
+        , m_importance(importance)
         , m_working(working)
     {
         Q_ASSERT(!input.isNull());
         Q_ASSERT(!output.isNull());
+        Q_ASSERT(!importance.isNull());
     }
 
     ~PolylineSimplifyTask() override;
@@ -1969,9 +1988,21 @@ public:
         // Skip sending notifications for now. Updated data will be picked up eventually.
         // ToDo: figure out how to connect a signal from here to a slot in the item.
         *m_working = QGeoMapPolylineGeometryOpenGL::zoomToLOD(m_zoom);
+        {
+            // The input of the tasks sharing m_importance does not change, so
+            // the table is only computed once, every other LOD filters it.
+            QMutexLocker locker(&m_importance->mutex);
+            if (m_importance->importance.size() != m_input->size()) {
+                QVector<QDoubleVector2D> data;
+                data.reserve(m_input->size());
+                for (const auto &e: qAsConst(*m_input))
+                    data << e.toDoubleVector2D();
+                m_importance->importance = QGeoSimplify::geoSimplifyZLImportance(data, m_leftBound);
+            }
+        }
         const QVector<QDeclarativeGeoMapItemUtils::vec2> res =
                 QGeoMapPolylineGeometryOpenGL::getSimplified( *m_input,
-                                   m_leftBound,
+                                   m_importance->importance,
                                    QGeoMapPolylineGeometryOpenGL::zoomForLOD(m_zoom));
         *m_output = res;
         *m_working = 0;
@@ -1980,11 +2011,13 @@ public:
     unsigned int m_zoom;
     double m_leftBound;
     QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > m_input, m_output;
+    QSharedPointer<QGeoMapItemLODImportance> m_importance;
     QSharedPointer<unsigned int> m_working;
 };
 
 void QGeoMapItemLODGeometry::enqueueSimplificationTask(const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &input,
                                                   const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &output,
+                                                  const QSharedPointer<QGeoMapItemLODImportance> &importance,
                                                   double leftBound,
                                                   unsigned int zoom,
                                                   QSharedPointer<unsigned int> &working)
@@ -1993,6 +2026,7 @@ void QGeoMapItemLODGeometry::enqueueSimplificationTask(const QSharedPointer<QVec
     Q_ASSERT(!output.isNull());
     PolylineSimplifyTask *task = new PolylineSimplifyTask(input,
                                                           output,
+                                                          importance,
                                                           leftBound,
                                                           zoom,
                                                           working);
@@ -2031,6 +2065,7 @@ void QGeoMapItemLODGeometry::selectLOD(unsigned int zoom, double leftBound, bool
 
         enqueueSimplificationTask(  m_verticesLOD.at(0),
                                     m_verticesLOD[requestedLod],
+                                    m_importance,
                                     leftBound,
                                     zoom,
                                     m_working);
@@ -2056,6 +2091,7 @@ void QGeoMapItemLODGeometry::selectLODOnDataChanged(unsigned int zoom, double le
                                     new QVector<QDeclarativeGeoMapItemUtils::vec2>);
         enqueueSimplificationTask(  m_verticesLOD.at(0),
                                     m_verticesLOD[lod],
+                                    m_importance,
                 leftBound,
                 zoom,
                 m_working);
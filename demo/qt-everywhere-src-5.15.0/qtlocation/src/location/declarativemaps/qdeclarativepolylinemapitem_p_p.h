@@ -63,6 +63,7 @@
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtCore/QScopedValueRollback>
 #include <QSharedPointer>
+#include <QMutex>
 #include <array>
 
 QT_BEGIN_NAMESPACE
@@ -213,6 +214,14 @@ protected:
     QSGGeometry geometry_;
 };
 
+// Importance of the LOD 0 vertices, see QGeoSimplify::geoSimplifyZLImportance().
+// Computed by the first simplification task, and shared by the following ones.
+struct QGeoMapItemLODImportance
+{
+    QMutex mutex;
+    QVector<double> importance;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoMapItemLODGeometry
 {
 public:
@@ -220,6 +229,7 @@ public:
                                                                              // do not allow simplifications beyond ZL 20. This could actually be limited even further
     mutable QVector<QDeclarativeGeoMapItemUtils::vec2> *m_screenVertices;
     mutable QSharedPointer<unsigned int> m_working;
+    mutable QSharedPointer<QGeoMapItemLODImportance> m_importance;
 
     QGeoMapItemLODGeometry()
     {
@@ -233,6 +243,7 @@ public:
                             new QVector<QDeclarativeGeoMapItemUtils::vec2>);
         for (unsigned int i = 1; i < m_verticesLOD.size(); ++i)
             m_verticesLOD[i] = nullptr; // allocate on first use
+        m_importance = QSharedPointer<QGeoMapItemLODImportance>(new QGeoMapItemLODImportance);
         m_screenVertices = m_verticesLOD.front().data(); // resetting pointer to data to be LOD 0
     }
 
@@ -249,8 +260,14 @@ public:
                               double leftBoundWrapped,
                               unsigned int zoom);
 
+    static QVector<QDeclarativeGeoMapItemUtils::vec2> getSimplified (
+            const QVector<QDeclarativeGeoMapItemUtils::vec2> &wrappedPath,
+                              const QVector<double> &importance,
+                              unsigned int zoom);
+
     static void enqueueSimplificationTask(const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &input, // reference as it gets copied in the nested call
                               const QSharedPointer<QVector<QDeclarativeGeoMapItemUtils::vec2> > &output,
+                              const QSharedPointer<QGeoMapItemLODImportance> &importance,
                               double leftBound,
                               unsigned int zoom,
                               QSharedPointer<unsigned int> &working);
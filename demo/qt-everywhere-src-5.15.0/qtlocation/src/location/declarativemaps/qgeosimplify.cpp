@@ -41,6 +41,7 @@
 
 #include "qgeosimplify_p.h"
 #include <QtPositioning/private/qlocationutils_p.h>
+#include <QtCore/qnumeric.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -244,6 +245,58 @@ void QGeoSimplify::simplifyDPStepZL(const QList<QDoubleVector2D> &points,
     }
 }
 
+QVector<double> QGeoSimplify::geoSimplifyZLImportance(const QVector<QDoubleVector2D> &points,
+                                                      const double &leftBound)
+{
+    // Runs the recursion of simplifyDPStepZL() down to a tolerance of 0, recording
+    // for each split point its distance relative to the zoom level 0 tolerance,
+    // bounded by the one of its parent split, as it is only kept if the parent is.
+    struct Range {
+        int first;
+        int last;
+        double importance;
+    };
+
+    QVector<double> importance(points.size(), 0.0);
+    if (points.isEmpty())
+        return importance;
+    const int last = points.size() - 1;
+    importance[0] = importance[last] = qInf();
+
+    QVector<Range> ranges;
+    ranges.append({ 0, last, qInf() });
+    while (!ranges.isEmpty()) {
+        const Range range = ranges.takeLast();
+        const QGeoCoordinate firstC = unwrappedToGeo(points.at(range.first), leftBound);
+        const QGeoCoordinate lastC = unwrappedToGeo(points.at(range.last), leftBound);
+        const double tolerance = (pixelDistanceAtZoomAndLatitude(0, firstC.latitude())
+                            + pixelDistanceAtZoomAndLatitude(0, lastC.latitude())) * 0.5;
+        double maxDistanceFound = 0;
+        int index = 0;
+
+        for (int i = range.first + 1; i < range.last; i++) {
+            const double distance = getSegDist(points.at(i),
+                                               points.at(range.first),
+                                               points.at(range.last),
+                                               leftBound);
+
+            if (distance > maxDistanceFound) {
+                index = i;
+                maxDistanceFound = distance;
+            }
+        }
+
+        if (index > 0) {
+            importance[index] = qMin(maxDistanceFound / tolerance, range.importance);
+            if (index - range.first > 1)
+                ranges.append({ range.first, index, importance.at(index) });
+            if (range.last - index > 1)
+                ranges.append({ index, range.last, importance.at(index) });
+        }
+    }
+    return importance;
+}
+
 QList<QGeoCoordinate> QGeoSimplify::simplifyDouglasPeucker(const QList<QGeoCoordinate> &points,
                                                            const double &leftBound,
                                                            double offsetTolerance) {
@@ -140,6 +140,12 @@ public:
     static QList<QDoubleVector2D> geoSimplifyZL(const QList<QDoubleVector2D> &points,
                                    const double &leftBound,
                                    int zoomLevel); // in meters
+
+    // Importance of each point for geoSimplifyZL(): the simplification at
+    // zoomLevel keeps exactly the points with importance * 2^zoomLevel > 1,
+    // so once computed, every zoom level is a filter over the table.
+    static QVector<double> geoSimplifyZLImportance(const QVector<QDoubleVector2D> &points,
+                                   const double &leftBound);
 };
 
 QT_END_NAMESPACE
@@ -640,12 +640,10 @@ void QGeoPolygonPrivate::updateClipperPath()
         computeBoundingBox();
     m_clipperDirty = false;
 
-    QList<QDoubleVector2D> preservedPath;
-    for (const QGeoCoordinate &c : m_path) {
-        QDoubleVector2D crd = QWebMercator::coordToMercator(c);
+    QList<QDoubleVector2D> preservedPath = QWebMercator::coordToMercator(m_path);
+    for (QDoubleVector2D &crd : preservedPath) {
         if (crd.x() < m_leftBoundWrapped)
             crd.setX(crd.x() + 1.0);
-        preservedPath << crd;
     }
     m_clipperPath = QClipperUtils::qListToPath(preservedPath);
 }
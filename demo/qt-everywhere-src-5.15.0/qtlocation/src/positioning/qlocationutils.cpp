@@ -45,6 +45,7 @@
 #include <QTime>
 #include <QList>
 #include <QByteArray>
+#include <QVarLengthArray>
 #include <QDebug>
 
 #include <math.h>
@@ -59,11 +60,29 @@ static double qlocationutils_nmeaDegreesToDecimal(double nmeaDegrees)
     return deg + (min / 60.0);
 }
 
+// The fields of an NMEA sentence, referring to the sentence data
+typedef QVarLengthArray<QByteArray, 24> QLocationUtilsNmeaFields;
+
+// Splits the sentence at commas in a single pass. Unlike QByteArray::split(),
+// this copies neither the sentence nor the fields, which are raw data
+// pointing into data.
+static void qlocationutils_splitNmea(const char *data, int size, QLocationUtilsNmeaFields &parts)
+{
+    int start = 0;
+    for (int i = 0; i < size; ++i) {
+        if (data[i] == ',') {
+            parts.append(QByteArray::fromRawData(data + start, i - start));
+            start = i + 1;
+        }
+    }
+    parts.append(QByteArray::fromRawData(data + start, size - start));
+}
+
 static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo *info, double uere,
                                    bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
     QGeoCoordinate coord;
 
     if (hasFix && parts.count() > 6 && parts[6].count() > 0)
@@ -105,7 +124,8 @@ static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo
 static void qlocationutils_readGsa(const char *data, int size, QGeoPositionInfo *info, double uere,
                                    bool *hasFix)
 {
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
 
     if (hasFix && parts.count() > 2 && !parts[2].isEmpty())
         *hasFix = parts[2].toInt() > 0;
@@ -129,7 +149,8 @@ static void qlocationutils_readGsa(const char *data,
                                               int size,
                                               QList<int> &pnrsInUse)
 {
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
     pnrsInUse.clear();
     if (parts.count() <= 2)
         return;
@@ -146,8 +167,8 @@ static void qlocationutils_readGsa(const char *data,
 
 static void qlocationutils_readGll(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
     QGeoCoordinate coord;
 
     if (hasFix && parts.count() > 6 && parts[6].count() > 0)
@@ -174,8 +195,8 @@ static void qlocationutils_readGll(const char *data, int size, QGeoPositionInfo
 
 static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
     QGeoCoordinate coord;
     QDate date;
     QTime time;
@@ -236,8 +257,8 @@ static void qlocationutils_readVtg(const char *data, int size, QGeoPositionInfo
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
 
     bool parsed = false;
     double value = 0.0;
@@ -258,8 +279,8 @@ static void qlocationutils_readZda(const char *data, int size, QGeoPositionInfo
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
     QDate date;
     QTime time;
 
@@ -361,7 +382,8 @@ QLocationUtils::GSVParseStatus QLocationUtils::getSatInfoFromNmea(const char *da
     if (nmeaType != NmeaSentenceGSV)
         return GSVNotParsed;
 
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
+    QLocationUtilsNmeaFields parts;
+    qlocationutils_splitNmea(data, size, parts);
 
     if (parts.count() <= 3) {
         infos.clear();
@@ -455,10 +477,21 @@ bool QLocationUtils::hasValidNmeaChecksum(const char *data, int size)
         return ::strncmp(calc, &data[asteriskIndex+1], 2) == 0;
         */
 
-    QByteArray checkSumBytes(&data[asteriskIndex + 1], 2);
-    bool ok = false;
-    int checksum = checkSumBytes.toInt(&ok,16);
-    return ok && checksum == result;
+    int checksum = 0;
+    for (int i = asteriskIndex + 1; i <= asteriskIndex + CSUM_LEN; ++i) {
+        const char c = data[i];
+        int digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            return false;
+        checksum = checksum * 16 + digit;
+    }
+    return checksum == result;
 }
 
 bool QLocationUtils::getNmeaTime(const QByteArray &bytes, QTime *time)
@@ -467,7 +500,7 @@ bool QLocationUtils::getNmeaTime(const QByteArray &bytes, QTime *time)
     QTime tempTime;
 
     if (dotIndex < 0) {
-        tempTime = QTime::fromString(QString::fromLatin1(bytes.constData()),
+        tempTime = QTime::fromString(QString::fromLatin1(bytes),
                                      QStringLiteral("hhmmss"));
     } else {
         tempTime = QTime::fromString(QString::fromLatin1(bytes.mid(0, dotIndex)),
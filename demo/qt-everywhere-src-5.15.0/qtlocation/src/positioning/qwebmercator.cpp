@@ -50,15 +50,30 @@ QT_BEGIN_NAMESPACE
 
 QDoubleVector2D QWebMercator::coordToMercator(const QGeoCoordinate &coord)
 {
-    const double pi = M_PI;
+    return QDoubleVector2D(coord.longitude() / 360.0 + 0.5,
+                           latitudeToMercatorY(coord.latitude()));
+}
 
-    double lon = coord.longitude() / 360.0 + 0.5;
+QList<QDoubleVector2D> QWebMercator::coordToMercator(const QList<QGeoCoordinate> &path)
+{
+    QList<QDoubleVector2D> mercator;
+    mercator.reserve(path.size());
+    for (const QGeoCoordinate &coord : path)
+        mercator.append(QDoubleVector2D(coord.longitude() / 360.0 + 0.5,
+                                        latitudeToMercatorY(coord.latitude())));
+    return mercator;
+}
 
-    double lat = coord.latitude();
-    lat = 0.5 - (std::log(std::tan((pi / 4.0) + (pi / 2.0) * lat / 180.0)) / pi) / 2.0;
-    lat = qBound(0.0, lat, 1.0);
+double QWebMercator::latitudeToMercatorY(double latitude)
+{
+    const double pi = M_PI;
 
-    return QDoubleVector2D(lon, lat);
+    // ln(tan(pi / 4 + lat / 2)) is computed as atanh(sin(lat)), which needs
+    // one trigonometric function instead of tan() and an extra division.
+    // At the poles this gives +/-inf, which is bounded like the tan() result.
+    const double s = std::sin(latitude * (pi / 180.0));
+    const double y = 0.5 - std::log((1.0 + s) / (1.0 - s)) / (4.0 * pi);
+    return qBound(0.0, y, 1.0);
 }
 
 double QWebMercator::realmod(const double a, const double b)
@@ -67,27 +82,19 @@ double QWebMercator::realmod(const double a, const double b)
     return a - static_cast<double>(div) * b;
 }
 
-QGeoCoordinate QWebMercator::mercatorToCoord(const QDoubleVector2D &mercator)
+double QWebMercator::mercatorYToLatitude(double fy)
 {
     const double pi = M_PI;
 
-    double fx = mercator.x();
-    double fy = mercator.y();
-
-    if (fy < 0.0)
-        fy = 0.0;
-    else if (fy > 1.0)
-        fy = 1.0;
-
-    double lat;
-
-    if (fy == 0.0)
-        lat = 90.0;
-    else if (fy == 1.0)
-        lat = -90.0;
-    else
-        lat = (180.0 / pi) * (2.0 * std::atan(std::exp(pi * (1.0 - 2.0 * fy))) - (pi / 2.0));
+    if (fy <= 0.0)
+        return 90.0;
+    else if (fy >= 1.0)
+        return -90.0;
+    return (180.0 / pi) * (2.0 * std::atan(std::exp(pi * (1.0 - 2.0 * fy))) - (pi / 2.0));
+}
 
+double QWebMercator::mercatorXToLongitude(double fx)
+{
     double lng;
     if (fx >= 0) {
         lng = realmod(fx, 1.0);
@@ -95,9 +102,23 @@ QGeoCoordinate QWebMercator::mercatorToCoord(const QDoubleVector2D &mercator)
         lng = realmod(1.0 - realmod(-1.0 * fx, 1.0), 1.0);
     }
 
-    lng = lng * 360.0 - 180.0;
+    return lng * 360.0 - 180.0;
+}
 
-    return QGeoCoordinate(lat, lng, 0.0);
+QGeoCoordinate QWebMercator::mercatorToCoord(const QDoubleVector2D &mercator)
+{
+    return QGeoCoordinate(mercatorYToLatitude(mercator.y()),
+                          mercatorXToLongitude(mercator.x()), 0.0);
+}
+
+QList<QGeoCoordinate> QWebMercator::mercatorToCoord(const QList<QDoubleVector2D> &path)
+{
+    QList<QGeoCoordinate> coords;
+    coords.reserve(path.size());
+    for (const QDoubleVector2D &mercator : path)
+        coords.append(QGeoCoordinate(mercatorYToLatitude(mercator.y()),
+                                     mercatorXToLongitude(mercator.x()), 0.0));
+    return coords;
 }
 
 QGeoCoordinate QWebMercator::coordinateInterpolation(const QGeoCoordinate &from, const QGeoCoordinate &to, qreal progress)
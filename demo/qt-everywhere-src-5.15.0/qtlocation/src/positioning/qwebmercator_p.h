@@ -66,8 +66,15 @@ public:
     static QGeoCoordinate mercatorToCoord(const QDoubleVector2D &mercator);
     static QGeoCoordinate coordinateInterpolation(const QGeoCoordinate &from, const QGeoCoordinate &to, qreal progress);
 
+    // Path versions of the conversions above
+    static QList<QDoubleVector2D> coordToMercator(const QList<QGeoCoordinate> &path);
+    static QList<QGeoCoordinate> mercatorToCoord(const QList<QDoubleVector2D> &path);
+
 private:
     static double realmod(const double a, const double b);
+    static double latitudeToMercatorY(double latitude);
+    static double mercatorYToLatitude(double y);
+    static double mercatorXToLongitude(double x);
 };
 
 QT_END_NAMESPACE
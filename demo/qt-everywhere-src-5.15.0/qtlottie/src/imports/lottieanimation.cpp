@@ -114,6 +114,11 @@ Q_LOGGING_CATEGORY(lcLottieQtBodymovinParser, "qt.lottieqt.bodymovin.parser");
     can control the memory usage by setting the QLOTTIE_RENDER_CACHE_SIZE
     environment variable (default value is 2).
 
+    When several animations are running, their frames are prepared in
+    parallel. The number of rendering threads can be set with the
+    QLOTTIE_RENDER_THREADS environment variable (by default, the number of
+    processor cores).
+
     You can monitor the rendering performance by turning on two logging categories:
 
     \list
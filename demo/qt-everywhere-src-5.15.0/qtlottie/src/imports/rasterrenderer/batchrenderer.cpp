@@ -35,6 +35,7 @@
 #include <QMutexLocker>
 #include <QLoggingCategory>
 #include <QThread>
+#include <QVector>
 
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -61,6 +62,16 @@ BatchRenderer::BatchRenderer()
         qCDebug(lcLottieQtBodymovinRenderThread) << "Setting frame cache size to" << cacheSize;
         m_cacheSize = cacheSize;
     }
+
+    // The render thread itself prerenders one of the animations, the pool
+    // provides the remaining threads
+    const QByteArray threadsStr = qgetenv("QLOTTIE_RENDER_THREADS");
+    int threadCount = threadsStr.toInt();
+    if (threadCount > 0)
+        qCDebug(lcLottieQtBodymovinRenderThread) << "Setting render thread count to" << threadCount;
+    else
+        threadCount = QThread::idealThreadCount();
+    m_renderPool.setMaxThreadCount(threadCount - 1);
 }
 
 BatchRenderer::~BatchRenderer()
@@ -217,8 +228,27 @@ void BatchRenderer::run()
     while (!isInterruptionRequested()) {
         QMutexLocker mlocker(&m_mutex);
 
-        for (Entry *e : qAsConst(m_animData))
-            prerender(e);
+        QVector<Entry *> pending;
+        for (Entry *e : qAsConst(m_animData)) {
+            if (e->frameCache.count() < m_cacheSize)
+                pending.append(e);
+        }
+
+        if (pending.size() > 1 && m_renderPool.maxThreadCount() > 0) {
+            // Every entry only touches its own frame cache and blueprint, so
+            // the animations can be prerendered in parallel. The mutex stays
+            // locked until all of them are done, which keeps the entries
+            // from being changed or deleted meanwhile.
+            for (int i = 1; i < pending.size(); ++i) {
+                Entry *e = pending.at(i);
+                m_renderPool.start(QRunnable::create([this, e]() { prerender(e); }));
+            }
+            prerender(pending.first());
+            m_renderPool.waitForDone();
+        } else {
+            for (Entry *e : qAsConst(pending))
+                prerender(e);
+        }
 
         m_waitCondition.wait(&m_mutex);
     }
@@ -33,6 +33,7 @@
 #include <QHash>
 #include <QThread>
 #include <QMutex>
+#include <QThreadPool>
 #include <QWaitCondition>
 
 QT_BEGIN_NAMESPACE
@@ -98,6 +99,7 @@ private:
 
     int m_cacheSize = 2;
     QHash<LottieAnimation *, Entry *> m_animData;
+    QThreadPool m_renderPool;
 };
 
 QT_END_NAMESPACE
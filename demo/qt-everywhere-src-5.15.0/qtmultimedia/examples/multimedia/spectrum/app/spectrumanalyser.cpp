@@ -68,6 +68,7 @@ SpectrumAnalyserThread::SpectrumAnalyserThread(QObject *parent)
     ,   m_input(SpectrumLengthSamples, 0.0)
     ,   m_output(SpectrumLengthSamples, 0.0)
     ,   m_spectrum(SpectrumLengthSamples)
+    ,   m_inputFrequency(0)
 #ifdef SPECTRUM_ANALYSER_SEPARATE_THREAD
     ,   m_thread(new QThread(this))
 #endif
@@ -96,6 +97,10 @@ void SpectrumAnalyserThread::setWindowFunction(WindowFunction type)
 
 void SpectrumAnalyserThread::calculateWindow()
 {
+    // Fold the scaling of PCM samples to [-1.0, 1.0] into the window, so
+    // that calculateSpectrum() needs a single multiply per sample
+    const DataType pcmScale = pcmToReal(1);
+
     for (int i=0; i<m_numSamples; ++i) {
         DataType x = 0.0;
 
@@ -110,10 +115,17 @@ void SpectrumAnalyserThread::calculateWindow()
             Q_ASSERT(false);
         }
 
-        m_window[i] = x;
+        m_window[i] = x * pcmScale;
     }
 }
 
+void SpectrumAnalyserThread::calculateFrequencies(int inputFrequency)
+{
+    for (int i=2; i<=m_numSamples/2; ++i)
+        m_spectrum[i].frequency = qreal(i * inputFrequency) / (m_numSamples);
+    m_inputFrequency = inputFrequency;
+}
+
 void SpectrumAnalyserThread::calculateSpectrum(const QByteArray &buffer,
                                                 int inputFrequency,
                                                 int bytesPerSample)
@@ -121,32 +133,35 @@ void SpectrumAnalyserThread::calculateSpectrum(const QByteArray &buffer,
 #ifndef DISABLE_FFT
     Q_ASSERT(buffer.size() == m_numSamples * bytesPerSample);
 
-    // Initialize data array
+    // Initialize data array. The window includes the scaling of the
+    // samples to [-1.0, 1.0].
     const char *ptr = buffer.constData();
+    const DataType *window = m_window.constData();
+    DataType *input = m_input.data();
     for (int i=0; i<m_numSamples; ++i) {
         const qint16 pcmSample = *reinterpret_cast<const qint16*>(ptr);
-        // Scale down to range [-1.0, 1.0]
-        const DataType realSample = pcmToReal(pcmSample);
-        const DataType windowedSample = realSample * m_window[i];
-        m_input[i] = windowedSample;
+        input[i] = pcmSample * window[i];
         ptr += bytesPerSample;
     }
 
     // Calculate the FFT
     m_fft->calculateFFT(m_output.data(), m_input.data());
 
+    // The frequency of each complex sample only depends on the input rate
+    if (inputFrequency != m_inputFrequency)
+        calculateFrequencies(inputFrequency);
+
     // Analyze output to obtain amplitude and phase for each frequency
+    const DataType *output = m_output.constData();
     for (int i=2; i<=m_numSamples/2; ++i) {
-        // Calculate frequency of this complex sample
-        m_spectrum[i].frequency = qreal(i * inputFrequency) / (m_numSamples);
-
-        const qreal real = m_output[i];
+        const qreal real = output[i];
         qreal imag = 0.0;
         if (i>0 && i<m_numSamples/2)
-            imag = m_output[m_numSamples/2 + i];
+            imag = output[m_numSamples/2 + i];
 
-        const qreal magnitude = qSqrt(real*real + imag*imag);
-        qreal amplitude = SpectrumAnalyserMultiplier * qLn(magnitude);
+        // ln(sqrt(x)) == ln(x) / 2, which saves the square root
+        const qreal power = real*real + imag*imag;
+        qreal amplitude = SpectrumAnalyserMultiplier * 0.5 * qLn(power);
 
         // Bound amplitude to [0.0, 1.0]
         m_spectrum[i].clipped = (amplitude > 1.0);
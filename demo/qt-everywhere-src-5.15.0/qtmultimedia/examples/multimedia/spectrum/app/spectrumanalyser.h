@@ -98,6 +98,7 @@ signals:
 
 private:
     void calculateWindow();
+    void calculateFrequencies(int inputFrequency);
 
 private:
 #ifndef DISABLE_FFT
@@ -119,6 +120,7 @@ private:
     QVector<DataType>                           m_output;
 
     FrequencySpectrum                           m_spectrum;
+    int                                         m_inputFrequency;
 
 #ifdef SPECTRUM_ANALYSER_SEPARATE_THREAD
     QThread*                                    m_thread;
@@ -107,10 +107,52 @@ void QGstreamerVideoEncode::setVideoSettings(const QVideoEncoderSettings &settin
     m_videoSettings = settings;
 }
 
+// Returns the highest ranked hardware encoder producing \a codec, or 0 if there is none
+static GstElementFactory *findHardwareEncoder(const QString &codec)
+{
+#if GST_CHECK_VERSION(1,16,0)
+    GList *factories = gst_element_factory_list_get_elements(
+                GST_ELEMENT_FACTORY_TYPE_ENCODER | GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO
+                | GST_ELEMENT_FACTORY_TYPE_HARDWARE,
+                GST_RANK_MARGINAL);
+    GstCaps *caps = gst_caps_from_string(codec.toUtf8().constData());
+    GList *encoders = gst_element_factory_list_filter(factories, caps, GST_PAD_SRC, FALSE);
+    gst_caps_unref(caps);
+    gst_plugin_feature_list_free(factories);
+
+    encoders = g_list_sort(encoders, gst_plugin_feature_rank_compare_func);
+    GstElementFactory *factory = encoders ? GST_ELEMENT_FACTORY(gst_object_ref(encoders->data)) : 0;
+    gst_plugin_feature_list_free(encoders);
+    return factory;
+#else
+    Q_UNUSED(codec);
+    return 0;
+#endif
+}
+
+static bool hasProperty(GstElement *element, const char *name)
+{
+    return g_object_class_find_property(G_OBJECT_GET_CLASS(element), name) != 0;
+}
+
 GstElement *QGstreamerVideoEncode::createEncoder()
 {
     QString codec = m_videoSettings.codec();
-    GstElement *encoderElement = gst_element_factory_make(m_codecs.codecElement(codec).constData(), "video-encoder");
+    QByteArray elementName = m_codecs.codecElement(codec);
+
+    // Prefer a hardware encoder, unless options meant for the default element were set
+    if (m_options.value(codec).isEmpty()) {
+        if (GstElementFactory *factory = findHardwareEncoder(codec)) {
+            elementName = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+            gst_object_unref(factory);
+        }
+    }
+
+    GstElement *encoderElement = gst_element_factory_make(elementName.constData(), "video-encoder");
+    if (!encoderElement && elementName != m_codecs.codecElement(codec)) {
+        elementName = m_codecs.codecElement(codec);
+        encoderElement = gst_element_factory_make(elementName.constData(), "video-encoder");
+    }
     if (!encoderElement)
         return 0;
 
@@ -139,7 +181,7 @@ GstElement *QGstreamerVideoEncode::createEncoder()
         if (m_videoSettings.encodingMode() == QMultimedia::ConstantQualityEncoding) {
             QMultimedia::EncodingQuality qualityValue = m_videoSettings.quality();
 
-            if (codec == QLatin1String("video/x-h264")) {
+            if (elementName == "x264enc") {
                 //constant quantizer mode
                 g_object_set(G_OBJECT(encoderElement), "pass", 4, NULL);
                 int qualityTable[] = {
@@ -150,7 +192,7 @@ GstElement *QGstreamerVideoEncode::createEncoder()
                     8 //VeryHigh
                 };
                 g_object_set(G_OBJECT(encoderElement), "quantizer", qualityTable[qualityValue], NULL);
-            } else if (codec == QLatin1String("video/x-xvid")) {
+            } else if (elementName == "xvidenc") {
                 //constant quantizer mode
                 g_object_set(G_OBJECT(encoderElement), "pass", 3, NULL);
                 int qualityTable[] = {
@@ -162,7 +204,7 @@ GstElement *QGstreamerVideoEncode::createEncoder()
                 };
                 int quant = qualityTable[qualityValue];
                 g_object_set(G_OBJECT(encoderElement), "quantizer", quant, NULL);
-            } else if (codec.startsWith(QLatin1String("video/mpeg"))) {
+            } else if (codec.startsWith(QLatin1String("video/mpeg")) && hasProperty(encoderElement, "quantizer")) {
                 //constant quantizer mode
                 g_object_set(G_OBJECT(encoderElement), "pass", 2, NULL);
                 //quant from 1 to 30, default ~3
@@ -175,7 +217,7 @@ GstElement *QGstreamerVideoEncode::createEncoder()
                 };
                 double quant = qualityTable[qualityValue];
                 g_object_set(G_OBJECT(encoderElement), "quantizer", quant, NULL);
-            } else if (codec == QLatin1String("video/x-theora")) {
+            } else if (codec == QLatin1String("video/x-theora") && hasProperty(encoderElement, "quality")) {
                 int qualityTable[] = {
                     8, //VeryLow
                     16, //Low
@@ -189,7 +231,7 @@ GstElement *QGstreamerVideoEncode::createEncoder()
             }
         } else {
             int bitrate = m_videoSettings.bitRate();
-            if (bitrate > 0) {
+            if (bitrate > 0 && hasProperty(encoderElement, "bitrate")) {
                 g_object_set(G_OBJECT(encoderElement), "bitrate", bitrate, NULL);
             }
         }
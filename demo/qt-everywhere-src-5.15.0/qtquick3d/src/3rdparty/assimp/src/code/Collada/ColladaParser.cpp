@@ -2470,6 +2470,51 @@ void ColladaParser::ReadInputChannel(std::vector<InputChannel>& poChannels)
     SkipElement();
 }
 
+// ------------------------------------------------------------------------------------------------
+// Makes room for pCount more elements without giving up geometric growth, as a mesh
+// can consist of many small primitive groups
+template <typename T>
+static void ReserveMore(std::vector<T>& pData, size_t pCount)
+{
+    if (pData.capacity() - pData.size() < pCount)
+        pData.reserve(std::max(pData.size() + pCount, 2 * pData.capacity()));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Reserves room for pCount more elements in the mesh data array the given channel fills
+static void ReserveChannelData(const InputChannel& pInput, size_t pCount, Mesh* pMesh)
+{
+    switch (pInput.mType)
+    {
+    case IT_Position:
+        if (pInput.mIndex == 0)
+            ReserveMore(pMesh->mPositions, pCount);
+        break;
+    case IT_Normal:
+        if (pInput.mIndex == 0)
+            ReserveMore(pMesh->mNormals, pCount);
+        break;
+    case IT_Tangent:
+        if (pInput.mIndex == 0)
+            ReserveMore(pMesh->mTangents, pCount);
+        break;
+    case IT_Bitangent:
+        if (pInput.mIndex == 0)
+            ReserveMore(pMesh->mBitangents, pCount);
+        break;
+    case IT_Texcoord:
+        if (pInput.mIndex < AI_MAX_NUMBER_OF_TEXTURECOORDS)
+            ReserveMore(pMesh->mTexCoords[pInput.mIndex], pCount);
+        break;
+    case IT_Color:
+        if (pInput.mIndex < AI_MAX_NUMBER_OF_COLOR_SETS)
+            ReserveMore(pMesh->mColors[pInput.mIndex], pCount);
+        break;
+    default:
+        break;
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Reads a <p> primitive index list and assembles the mesh data into the given mesh
 size_t ColladaParser::ReadPrimitives(Mesh* pMesh, std::vector<InputChannel>& pPerIndexChannels,
@@ -2595,6 +2640,31 @@ size_t ColladaParser::ReadPrimitives(Mesh* pMesh, std::vector<InputChannel>& pPe
     pMesh->mFaceSize.reserve(numPrimitives);
     pMesh->mFacePosIndices.reserve(indices.size() / numOffsets);
 
+    // every vertex copied below appends one element to the array of each channel,
+    // so make room for all of them up front where their number is known
+    size_t numVertices = 0;
+    switch (pPrimType)
+    {
+    case Prim_Lines:
+    case Prim_Triangles:
+    case Prim_Polylist:
+        numVertices = indices.size() / numOffsets;
+        break;
+    case Prim_TriStrips:
+        if (numPrimitives < indices.size() / numOffsets)
+            numVertices = numPrimitives * 3;
+        break;
+    default:
+        break;
+    }
+    if (numVertices > 0)
+    {
+        for (const InputChannel& channel : pMesh->mPerVertexData)
+            ReserveChannelData(channel, numVertices, pMesh);
+        for (const InputChannel& channel : pPerIndexChannels)
+            ReserveChannelData(channel, numVertices, pMesh);
+    }
+
     size_t polylistStartVertex = 0;
     for (size_t currentPrimitive = 0; currentPrimitive < numPrimitives; currentPrimitive++)
     {
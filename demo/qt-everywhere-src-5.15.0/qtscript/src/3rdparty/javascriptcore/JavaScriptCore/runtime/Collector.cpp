@@ -385,6 +385,14 @@ allocate:
         Block* block = reinterpret_cast<Block*>(m_heap.blocks[m_heap.nextBlock]);
         do {
             ASSERT(m_heap.nextCell < HeapConstants::cellsPerBlock);
+            // Step over 32 live cells at a time. Blocks full of long-lived
+            // objects would otherwise be walked one cell at a time after
+            // every collection. Bits past the last cell are never set, so a
+            // full word never reaches beyond the end of the block.
+            if (!(m_heap.nextCell & 0x1F) && block->marked.bits[m_heap.nextCell >> 5] == 0xFFFFFFFF) {
+                m_heap.nextCell += 31; // the loop increment adds the last one
+                continue;
+            }
             if (!block->marked.get(m_heap.nextCell)) { // Always false for the last cell in the block
                 Cell* cell = block->cells + m_heap.nextCell;
 
@@ -56,6 +56,18 @@ QtSensorGestureSensorHandler* QtSensorGestureSensorHandler::instance()
     return instance;
 }
 
+/*
+    Let backends with a hardware FIFO deliver readings in batches, so that the
+    device wakes up once per batch rather than for every reading. The readings
+    themselves still reach the recognizers one by one, through the same signal.
+ */
+void QtSensorGestureSensorHandler::enableBuffering(QSensor *sensor)
+{
+    if (sensor->isFeatureSupported(QSensor::Buffering)
+            && sensor->efficientBufferSize() > 1)
+        sensor->setBufferSize(sensor->efficientBufferSize());
+}
+
 void QtSensorGestureSensorHandler::accelChanged()
 {
     Q_EMIT accelReadingChanged(accel->reading());
@@ -91,6 +103,7 @@ bool QtSensorGestureSensorHandler::startSensor(SensorGestureSensors sensor)
             accel = new QAccelerometer(this);
             ok = accel->connectToBackend();
             accel->setDataRate(100);
+            enableBuffering(accel);
             qoutputrangelist outputranges = accel->outputRanges();
 
             if (outputranges.count() > 0)
@@ -108,6 +121,7 @@ bool QtSensorGestureSensorHandler::startSensor(SensorGestureSensors sensor)
             orientation = new QOrientationSensor(this);
             ok = orientation->connectToBackend();
             orientation->setDataRate(50);
+            enableBuffering(orientation);
             connect(orientation,SIGNAL(readingChanged()),this,SLOT(orientationChanged()));
         }
         if (ok && !orientation->isActive())
@@ -85,6 +85,8 @@ Q_SIGNALS:
     void dTabReadingChanged(QTapReading *reading);
 
 private:
+    void enableBuffering(QSensor *sensor);
+
     QAccelerometer *accel;
     QOrientationSensor *orientation;
     QProximitySensor *proximity;
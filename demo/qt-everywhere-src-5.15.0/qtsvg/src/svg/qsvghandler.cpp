@@ -93,7 +93,7 @@ static QByteArray prefixMessage(const QByteArray &msg, const QXmlStreamReader *r
     return result;
 }
 
-static inline QByteArray msgProblemParsing(const QString &localName, const QXmlStreamReader *r)
+static inline QByteArray msgProblemParsing(const QStringRef &localName, const QXmlStreamReader *r)
 {
     return prefixMessage(QByteArrayLiteral("Problem parsing ") + localName.toLocal8Bit(), r);
 }
@@ -3419,12 +3419,12 @@ static QSvgNode *createVideoNode(QSvgNode *parent,
 
 typedef QSvgNode *(*FactoryMethod)(QSvgNode *, const QXmlStreamAttributes &, QSvgHandler *);
 
-static FactoryMethod findGroupFactory(const QString &name)
+static FactoryMethod findGroupFactory(const QStringRef &name)
 {
     if (name.isEmpty())
         return 0;
 
-    QStringRef ref(&name, 1, name.length() - 1);
+    const QStringRef ref = name.mid(1);
     switch (name.at(0).unicode()) {
     case 'd':
         if (ref == QLatin1String("efs")) return createDefsNode;
@@ -3442,12 +3442,12 @@ static FactoryMethod findGroupFactory(const QString &name)
     return 0;
 }
 
-static FactoryMethod findGraphicsFactory(const QString &name)
+static FactoryMethod findGraphicsFactory(const QStringRef &name)
 {
     if (name.isEmpty())
         return 0;
 
-    QStringRef ref(&name, 1, name.length() - 1);
+    const QStringRef ref = name.mid(1);
     switch (name.at(0).unicode()) {
     case 'a':
         if (ref == QLatin1String("nimation")) return createAnimationNode;
@@ -3491,12 +3491,12 @@ static FactoryMethod findGraphicsFactory(const QString &name)
 
 typedef bool (*ParseMethod)(QSvgNode *, const QXmlStreamAttributes &, QSvgHandler *);
 
-static ParseMethod findUtilFactory(const QString &name)
+static ParseMethod findUtilFactory(const QStringRef &name)
 {
     if (name.isEmpty())
         return 0;
 
-    QStringRef ref(&name, 1, name.length() - 1);
+    const QStringRef ref = name.mid(1);
     switch (name.at(0).unicode()) {
     case 'a':
         if (ref.isEmpty()) return parseAnchorNode;
@@ -3543,12 +3543,12 @@ typedef QSvgStyleProperty *(*StyleFactoryMethod)(QSvgNode *,
                                                  const QXmlStreamAttributes &,
                                                  QSvgHandler *);
 
-static StyleFactoryMethod findStyleFactoryMethod(const QString &name)
+static StyleFactoryMethod findStyleFactoryMethod(const QStringRef &name)
 {
     if (name.isEmpty())
         return 0;
 
-    QStringRef ref(&name, 1, name.length() - 1);
+    const QStringRef ref = name.mid(1);
     switch (name.at(0).unicode()) {
     case 'f':
         if (ref == QLatin1String("ont")) return createFontNode;
@@ -3572,12 +3572,12 @@ typedef bool (*StyleParseMethod)(QSvgStyleProperty *,
                                  const QXmlStreamAttributes &,
                                  QSvgHandler *);
 
-static StyleParseMethod findStyleUtilFactoryMethod(const QString &name)
+static StyleParseMethod findStyleUtilFactoryMethod(const QStringRef &name)
 {
     if (name.isEmpty())
         return 0;
 
-    QStringRef ref(&name, 1, name.length() - 1);
+    const QStringRef ref = name.mid(1);
     switch (name.at(0).unicode()) {
     case 'f':
         if (ref == QLatin1String("ont-face")) return parseFontFaceNode;
@@ -3648,7 +3648,7 @@ void QSvgHandler::parse()
             // namespaceUri is empty. The only possible strategy at
             // this point is to do what everyone else seems to do and
             // ignore the reported namespaceUri completely.
-            if (!startElement(xml->name().toString(), xml->attributes())) {
+            if (!startElement(xml->name(), xml->attributes())) {
                 delete m_doc;
                 m_doc = 0;
                 return;
@@ -3674,7 +3674,7 @@ void QSvgHandler::parse()
     resolveNodes();
 }
 
-bool QSvgHandler::startElement(const QString &localName,
+bool QSvgHandler::startElement(const QStringRef &localName,
                                const QXmlStreamAttributes &attributes)
 {
     QSvgNode *node = 0;
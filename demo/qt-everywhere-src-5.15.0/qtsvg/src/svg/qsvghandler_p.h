@@ -135,7 +135,7 @@ public:
     { return m_defaultPen; }
 
 public:
-    bool startElement(const QString &localName, const QXmlStreamAttributes &attributes);
+    bool startElement(const QStringRef &localName, const QXmlStreamAttributes &attributes);
     bool endElement(const QStringRef &localName);
     bool characters(const QStringRef &str);
     bool processingInstruction(const QString &target, const QString &data);
@@ -44,6 +44,8 @@
 #include "qsvgtinydocument_p.h"
 
 #include "qbytearray.h"
+#include "qimage.h"
+#include "qpaintengine.h"
 #include "qtimer.h"
 #include "qtransform.h"
 #include "qdebug.h"
@@ -108,7 +110,7 @@ public:
     explicit QSvgRendererPrivate()
         : QObjectPrivate(),
           render(0), timer(0),
-          fps(30)
+          fps(30), rasterCacheDpr(0)
     {}
     ~QSvgRendererPrivate()
     {
@@ -117,11 +119,85 @@ public:
 
     static void callRepaintNeeded(QSvgRenderer *const q);
 
+    void draw(QPainter *painter, const QRectF &bounds);
+    void invalidateRasterCache()
+    {
+        rasterCache = QImage();
+        rasterCacheBounds = QRectF();
+        rasterCacheDpr = 0;
+    }
+
     QSvgTinyDocument *render;
     QTimer *timer;
     int fps;
+
+    // The last rasterization of a static document, and the target it was
+    // made for. rasterCacheDpr is set but rasterCache left null until the
+    // same target is requested a second time.
+    QImage rasterCache;
+    QRectF rasterCacheBounds;
+    qreal rasterCacheDpr;
 };
 
+/*!
+    \internal
+
+    Draws the document like QSvgTinyDocument::draw(), but reuses a
+    rasterization of it when a static document is repeatedly painted onto
+    the same raster target. This only happens when blitting the image gives
+    the same pixels as drawing the nodes: an unscaled, whole-pixel offset,
+    source-over painter with full opacity and an integral device pixel ratio.
+*/
+void QSvgRendererPrivate::draw(QPainter *painter, const QRectF &bounds)
+{
+    QPaintEngine *engine = painter->paintEngine();
+    QPaintDevice *device = painter->device();
+    const QTransform &transform = painter->worldTransform();
+    const qreal dpr = device->devicePixelRatioF();
+    if (render->animated() || !engine || engine->type() != QPaintEngine::Raster
+        || transform.type() > QTransform::TxTranslate
+        || transform.dx() != qRound(transform.dx()) || transform.dy() != qRound(transform.dy())
+        || dpr != qRound(dpr)
+        || painter->compositionMode() != QPainter::CompositionMode_SourceOver
+        || painter->opacity() != 1) {
+        render->draw(painter, bounds);
+        return;
+    }
+
+    QRectF target = bounds;
+    if (target.isNull())
+        target = QRectF(0, 0, device->width(), device->height());
+    if (target.isEmpty()) {
+        render->draw(painter, bounds);
+        return;
+    }
+
+    const QRect pixelRect = target.toAlignedRect();
+    if (target != rasterCacheBounds || dpr != rasterCacheDpr) {
+        // First time for this target: remember it, but don't pay for an
+        // offscreen rendering that may never be reused.
+        rasterCache = QImage();
+        rasterCacheBounds = target;
+        rasterCacheDpr = dpr;
+        render->draw(painter, bounds);
+        return;
+    }
+
+    if (rasterCache.isNull()) {
+        rasterCache = QImage(pixelRect.size() * qRound(dpr), QImage::Format_ARGB32_Premultiplied);
+        if (rasterCache.isNull()) {
+            render->draw(painter, bounds);
+            return;
+        }
+        rasterCache.setDevicePixelRatio(dpr);
+        rasterCache.fill(Qt::transparent);
+        QPainter p(&rasterCache);
+        p.translate(-pixelRect.topLeft());
+        render->draw(&p, target);
+    }
+    painter->drawImage(pixelRect.topLeft(), rasterCache);
+}
+
 /*!
     Constructs a new renderer with the given \a parent.
 */
@@ -213,8 +289,10 @@ QRect QSvgRenderer::viewBox() const
 void QSvgRenderer::setViewBox(const QRect &viewbox)
 {
     Q_D(QSvgRenderer);
-    if (d->render)
+    if (d->render) {
         d->render->setViewBox(viewbox);
+        d->invalidateRasterCache();
+    }
 }
 
 /*!
@@ -288,6 +366,7 @@ void QSvgRenderer::setAspectRatioMode(Qt::AspectRatioMode mode)
             d->render->setPreserveAspectRatio(true);
         else if (mode == Qt::IgnoreAspectRatio)
             d->render->setPreserveAspectRatio(false);
+        d->invalidateRasterCache();
     }
 }
 
@@ -349,6 +428,7 @@ static bool loadDocument(QSvgRenderer *const q,
                          const TInputType &in)
 {
     delete d->render;
+    d->invalidateRasterCache();
     d->render = QSvgTinyDocument::load(in);
     if (d->render && d->render->animated() && d->fps > 0) {
         if (!d->timer)
@@ -411,7 +491,7 @@ void QSvgRenderer::render(QPainter *painter)
 {
     Q_D(QSvgRenderer);
     if (d->render) {
-        d->render->draw(painter);
+        d->draw(painter, QRectF());
     }
 }
 
@@ -446,7 +526,7 @@ void QSvgRenderer::render(QPainter *painter, const QRectF &bounds)
 {
     Q_D(QSvgRenderer);
     if (d->render) {
-        d->render->draw(painter, bounds);
+        d->draw(painter, bounds);
     }
 }
 
@@ -462,8 +542,10 @@ QRectF QSvgRenderer::viewBoxF() const
 void QSvgRenderer::setViewBox(const QRectF &viewbox)
 {
     Q_D(QSvgRenderer);
-    if (d->render)
+    if (d->render) {
         d->render->setViewBox(viewbox);
+        d->invalidateRasterCache();
+    }
 }
 
 /*!
@@ -35,6 +35,9 @@ namespace {
 
 const size_t kMaxBatchReadCapacity = 256 * 1024;
 
+// The maximum number of queued messages gathered into a single writev().
+const size_t kMaxBatchWriteMessages = 16;
+
 // A view over a Channel::Message object. The write queue uses these since
 // large messages may need to be sent in chunks.
 class MessageView {
@@ -78,6 +81,10 @@ class MessageView {
 
   size_t num_handles_sent() { return num_handles_sent_; }
 
+  // Whether any handles remain to be sent with this message. Such messages
+  // must go through sendmsg() on their own.
+  bool has_handles() const { return handles_.size() > num_handles_sent_; }
+
   void set_num_handles_sent(size_t num_handles_sent) {
     num_handles_sent_ = num_handles_sent;
   }
@@ -196,7 +203,7 @@ class ChannelPosix : public Channel,
           socket_.get(), true /* persistent */,
           base::MessagePumpForIO::WATCH_READ, read_watcher_.get(), this);
       base::AutoLock lock(write_lock_);
-      FlushOutgoingMessagesNoLock();
+      FlushOutgoingMessagesWritevNoLock();
     }
   }
 
@@ -323,7 +330,7 @@ class ChannelPosix : public Channel,
     {
       base::AutoLock lock(write_lock_);
       pending_write_ = false;
-      if (!FlushOutgoingMessagesNoLock())
+      if (!FlushOutgoingMessagesWritevNoLock())
         reject_writes_ = write_error = true;
     }
     if (write_error)
@@ -456,6 +463,58 @@ class ChannelPosix : public Channel,
     return true;
   }
 
+  // Equivalent to FlushOutgoingMessagesNoLock(), but gathers runs of queued
+  // messages without handles into a single writev() call instead of issuing
+  // one write per message. The queue only builds up while the socket is not
+  // writable, so this is the path that drains bursts of messages.
+  bool FlushOutgoingMessagesWritevNoLock() {
+    while (!outgoing_messages_.empty()) {
+      iovec iov[kMaxBatchWriteMessages];
+      size_t num_iovs = 0;
+      size_t num_bytes = 0;
+      for (auto it = outgoing_messages_.begin();
+           it != outgoing_messages_.end() &&
+           num_iovs < kMaxBatchWriteMessages && !it->has_handles();
+           ++it) {
+        iov[num_iovs].iov_base = const_cast<void*>(it->data());
+        iov[num_iovs].iov_len = it->data_num_bytes();
+        num_bytes += it->data_num_bytes();
+        ++num_iovs;
+      }
+
+      // Nothing to gather: the next message carries handles or is alone.
+      if (num_iovs < 2)
+        return FlushOutgoingMessagesNoLock();
+
+      ssize_t result = SocketWritev(socket_.get(), iov, num_iovs);
+      if (result < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+          return false;
+        WaitForWriteOnIOThreadNoLock();
+        return true;
+      }
+
+      size_t bytes_written = static_cast<size_t>(result);
+      while (bytes_written > 0) {
+        MessageView& message_view = outgoing_messages_.front();
+        if (bytes_written < message_view.data_num_bytes()) {
+          message_view.advance_data_offset(bytes_written);
+          break;
+        }
+        bytes_written -= message_view.data_num_bytes();
+        outgoing_messages_.pop_front();
+      }
+
+      if (static_cast<size_t>(result) < num_bytes) {
+        // The socket buffer is full, wait until it drains.
+        WaitForWriteOnIOThreadNoLock();
+        return true;
+      }
+    }
+
+    return true;
+  }
+
 #if defined(OS_IOS)
   bool OnControlMessage(Message::MessageType message_type,
                         const void* payload,